@@ -13,11 +13,29 @@ layout( std140, binding = 0 ) uniform constantBuffer
 	float g_elapsedSecondCount_total;
 };
 
+// These come from the material's parameter block
+layout( std140, binding = 1 ) uniform materialConstants
+{
+	vec4 g_color;
+};
+
+// Textures
+//=========
+
+#if TEXTURED
+// The renderer binds the texture that the mesh was submitted with here
+layout( binding = 0 ) uniform sampler2D g_texture;
+#endif
+
 // Input
 //======
 
-// None; the only data that the vertex shader output was gl_Position,
-// and that is used by the GPU
+#if TEXTURED
+layout( location = 0 ) in vec2 i_textureCoordinates;
+#endif
+#if VERTEX_COLOR
+layout( location = 1 ) in vec4 i_color;
+#endif
 
 // Output
 //=======
@@ -36,7 +54,22 @@ void main()
 	// If you are curious you should experiment with changing the values of the first three numbers
 	// to something in the range [0,1] and observing the results
 	// (although when you submit your Assignment 01 the color output must be white).
+	// ANIMATE_COLOR, TINT_WITH_MATERIAL, TEXTURED, and VERTEX_COLOR are permutation axes that are declared in fragmentShader.shader
+#if ANIMATE_COLOR
 	o_color = vec4( 0.5 + 0.5 * sin( 2 * g_elapsedSecondCount_total ), 0.5 + 0.5 * cos( 2 * g_elapsedSecondCount_total ), 0.5 + 0.5 * sin( 2 * g_elapsedSecondCount_total + 4 ), 1.0 );
+#else
+	o_color = vec4( 1.0, 1.0, 1.0, 1.0 );
+#endif
+#if TINT_WITH_MATERIAL
+	// Tint the color by the material's color
+	o_color *= g_color;
+#endif
+#if TEXTURED
+	o_color *= texture( g_texture, i_textureCoordinates );
+#endif
+#if VERTEX_COLOR
+	o_color *= i_color;
+#endif
 
 	// EAE6320_TODO: Change the color based on time!
 	// The value g_elapsedSecondCount_total should change every second, and so by doing something like
@@ -10,6 +10,21 @@ cbuffer constantBuffer : register( b0 )
 	float g_elapsedSecondCount_total;
 }
 
+// These come from the material's parameter block
+cbuffer materialConstants : register( b1 )
+{
+	float4 g_color;
+}
+
+// Textures
+//=========
+
+#if TEXTURED
+// The renderer binds the texture that the mesh was submitted with here
+Texture2D g_texture : register( t0 );
+SamplerState g_sampler : register( s0 );
+#endif
+
 // Entry Point
 //============
 
@@ -21,6 +36,10 @@ void main(
 	// The GPU provides us with position
 
 	in float4 i_position : SV_POSITION,
+	in float2 i_textureCoordinates : TEXCOORD0,
+#if VERTEX_COLOR
+	in float4 i_color : COLOR0,
+#endif
 
 	// Output
 	//=======
@@ -35,7 +54,22 @@ void main(
 	// (where color is represented by 4 floats representing "RGBA" == "Red/Green/Blue/Alpha").
 	// Try experimenting with changing the values of the first three numbers
 	// to something in the range [0,1] and observe the results.
+	// ANIMATE_COLOR, TINT_WITH_MATERIAL, TEXTURED, and VERTEX_COLOR are permutation axes that are declared in fragmentShader.shader
+#if ANIMATE_COLOR
 	o_color = float4( 0.5 + 0.5 * sin( 2 * g_elapsedSecondCount_total ), 0.5 + 0.5 * cos( 2 * g_elapsedSecondCount_total ), 0.5 + 0.5 * sin( 2 * g_elapsedSecondCount_total + 4 ), 1.0 );
+#else
+	o_color = float4( 1.0, 1.0, 1.0, 1.0 );
+#endif
+#if TINT_WITH_MATERIAL
+	// Tint the color by the material's color
+	o_color *= g_color;
+#endif
+#if TEXTURED
+	o_color *= g_texture.Sample( g_sampler, i_textureCoordinates );
+#endif
+#if VERTEX_COLOR
+	o_color *= i_color;
+#endif
 
 	// EAE6320_TODO: Change the color based on time!
 	// The value g_elapsedSecondCount_total should change every second, and so by doing something like
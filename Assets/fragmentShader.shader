@@ -0,0 +1,23 @@
+--[[
+	This is the fragment shader that meshes and particles are drawn with
+
+	Each axis is a #define that the source code can check,
+	and every combination of values is compiled into the built shader library
+]]
+
+return
+{
+	type = "fragment",
+	axes =
+	{
+		-- Whether the color changes with the elapsed time (otherwise it is white)
+		{ name = "ANIMATE_COLOR" },
+		-- Whether the color is multiplied by the material's color
+		{ name = "TINT_WITH_MATERIAL" },
+		-- Whether the color is multiplied by the texture that the mesh was submitted with
+		{ name = "TEXTURED" },
+		-- Whether the color is multiplied by the vertex color
+		-- (the vertex shader must have the same VERTEX_COLOR value)
+		{ name = "VERTEX_COLOR" },
+	},
+}
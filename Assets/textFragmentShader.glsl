@@ -0,0 +1,47 @@
+/*
+	This fragment shader draws glyphs from a font texture
+	or sprites from an atlas texture
+*/
+
+// The version of GLSL to use must come first
+#version 420
+
+// Textures
+//=========
+
+// The overlay pass binds the batch's font or atlas texture here
+layout( binding = 0 ) uniform sampler2D g_font;
+
+// Input
+//======
+
+layout( location = 0 ) in vec2 i_textureCoordinates;
+layout( location = 1 ) in vec4 i_color;
+
+// Output
+//=======
+
+out vec4 o_color;
+
+// Entry Point
+//============
+
+void main()
+{
+	// SPRITE is a permutation axis that is declared in textFragmentShader.shader
+#if SPRITE
+	// A sprite's texture has its own colors, which the vertex color tints
+	o_color = texture( g_font, i_textureCoordinates ) * i_color;
+#else
+	float value = texture( g_font, i_textureCoordinates ).r;
+	// DISTANCE_FIELD is a permutation axis that is declared in textFragmentShader.shader
+#if DISTANCE_FIELD
+	// The edge is at 0.5, and it is smoothed over about a pixel at whatever size the text is drawn
+	float smoothing = 0.5 * fwidth( value );
+	float coverage = smoothstep( 0.5 - smoothing, 0.5 + smoothing, value );
+#else
+	float coverage = value;
+#endif
+	o_color = vec4( i_color.rgb, i_color.a * coverage );
+#endif
+}
@@ -0,0 +1,48 @@
+/*
+	This fragment shader draws glyphs from a font texture
+	or sprites from an atlas texture
+*/
+
+// Textures
+//=========
+
+// The overlay pass binds the batch's font or atlas texture here
+Texture2D g_font : register( t0 );
+SamplerState g_sampler : register( s0 );
+
+// Entry Point
+//============
+
+void main(
+
+	// Input
+	//======
+
+	in float4 i_position : SV_POSITION,
+	in float2 i_textureCoordinates : TEXCOORD0,
+	in float4 i_color : COLOR,
+
+	// Output
+	//=======
+
+	out float4 o_color : SV_TARGET
+
+	)
+{
+	// SPRITE is a permutation axis that is declared in textFragmentShader.shader
+#if SPRITE
+	// A sprite's texture has its own colors, which the vertex color tints
+	o_color = g_font.Sample( g_sampler, i_textureCoordinates ) * i_color;
+#else
+	const float value = g_font.Sample( g_sampler, i_textureCoordinates ).r;
+	// DISTANCE_FIELD is a permutation axis that is declared in textFragmentShader.shader
+#if DISTANCE_FIELD
+	// The edge is at 0.5, and it is smoothed over about a pixel at whatever size the text is drawn
+	const float smoothing = 0.5 * fwidth( value );
+	const float coverage = smoothstep( 0.5 - smoothing, 0.5 + smoothing, value );
+#else
+	const float coverage = value;
+#endif
+	o_color = float4( i_color.rgb, i_color.a * coverage );
+#endif
+}
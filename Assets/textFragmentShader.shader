@@ -0,0 +1,15 @@
+--[[
+	This is the fragment shader that text batches are drawn with
+]]
+
+return
+{
+	type = "fragment",
+	axes =
+	{
+		-- Whether the font texture is a distance field (otherwise it is coverage)
+		{ name = "DISTANCE_FIELD" },
+		-- Whether the texture is an atlas of sprites (otherwise it is a font)
+		{ name = "SPRITE" },
+	},
+}
@@ -0,0 +1,32 @@
+/*
+	This vertex shader passes text batch vertices through
+	(the batch has already converted them to clip space)
+*/
+
+// The version of GLSL to use must come first
+#version 420
+
+// Input
+//======
+
+// The locations must match the C calls to glVertexAttribPointer() in TextBatch.gl.cpp
+layout( location = 0 ) in vec2 i_position;
+layout( location = 1 ) in vec2 i_textureCoordinates;
+layout( location = 2 ) in vec4 i_color;
+
+// Output
+//=======
+
+layout( location = 0 ) out vec2 o_textureCoordinates;
+layout( location = 1 ) out vec4 o_color;
+
+// Entry Point
+//============
+
+void main()
+{
+	gl_Position = vec4( i_position, 0.0, 1.0 );
+	// A loaded texture's first row is at V=0 on both platforms, and so unlike the upscale shader nothing is flipped
+	o_textureCoordinates = i_textureCoordinates;
+	o_color = i_color;
+}
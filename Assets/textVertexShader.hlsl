@@ -0,0 +1,30 @@
+/*
+	This vertex shader passes text batch vertices through
+	(the batch has already converted them to clip space)
+*/
+
+// Entry Point
+//============
+
+void main(
+
+	// Input
+	//======
+
+	in const float2 i_position : POSITION,
+	in const float2 i_textureCoordinates : TEXCOORD0,
+	in const float4 i_color : COLOR,
+
+	// Output
+	//=======
+
+	out float4 o_position : SV_POSITION,
+	out float2 o_textureCoordinates : TEXCOORD0,
+	out float4 o_color : COLOR
+
+	)
+{
+	o_position = float4( i_position, 0.0, 1.0 );
+	o_textureCoordinates = i_textureCoordinates;
+	o_color = i_color;
+}
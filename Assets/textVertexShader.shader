@@ -0,0 +1,8 @@
+--[[
+	This is the vertex shader that text batches are drawn with
+]]
+
+return
+{
+	type = "vertex",
+}
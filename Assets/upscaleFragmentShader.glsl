@@ -0,0 +1,47 @@
+/*
+	This fragment shader samples the scene when it is upscaled
+*/
+
+// The version of GLSL to use must come first
+#version 420
+
+// Constants
+//==========
+
+layout( std140, binding = 0 ) uniform constantBuffer
+{
+	float g_elapsedSecondCount_total;
+	float g_padding;
+	// The fraction of the scene's target that the scene was rendered to
+	vec2 g_sceneTextureCoordinateScale;
+};
+
+// Textures
+//=========
+
+// The render graph binds the scene's target here
+// (the target filters linearly and clamps at the edges)
+layout( binding = 0 ) uniform sampler2D g_scene;
+
+// Input
+//======
+
+layout( location = 0 ) in vec2 i_textureCoordinates;
+
+// Output
+//=======
+
+out vec4 o_color;
+
+// Entry Point
+//============
+
+void main()
+{
+	// The rest of the target isn't part of the scene,
+	// and so the coordinates are clamped to the centers of the last texels that were rendered
+	// to keep bilinear filtering from blending it in
+	vec2 sceneSize = vec2( textureSize( g_scene, 0 ) );
+	vec2 maxTextureCoordinates = g_sceneTextureCoordinateScale - ( 0.5 / sceneSize );
+	o_color = texture( g_scene, min( i_textureCoordinates, maxTextureCoordinates ) );
+}
@@ -0,0 +1,50 @@
+/*
+	This fragment shader samples the scene when it is upscaled
+*/
+
+// Constants
+//==========
+
+cbuffer constantBuffer : register( b0 )
+{
+	float g_elapsedSecondCount_total;
+	float g_padding;
+	// The fraction of the scene's target that the scene was rendered to
+	float2 g_sceneTextureCoordinateScale;
+}
+
+// Textures
+//=========
+
+// The render graph binds the scene's target here
+Texture2D g_scene : register( t0 );
+// No sampler is bound, and so the default one is used
+// (which filters linearly and clamps at the edges)
+SamplerState g_sampler : register( s0 );
+
+// Entry Point
+//============
+
+void main(
+
+	// Input
+	//======
+
+	in float4 i_position : SV_POSITION,
+	in float2 i_textureCoordinates : TEXCOORD0,
+
+	// Output
+	//=======
+
+	out float4 o_color : SV_TARGET
+
+	)
+{
+	// The rest of the target isn't part of the scene,
+	// and so the coordinates are clamped to the centers of the last texels that were rendered
+	// to keep bilinear filtering from blending it in
+	float2 sceneSize;
+	g_scene.GetDimensions( sceneSize.x, sceneSize.y );
+	const float2 maxTextureCoordinates = g_sceneTextureCoordinateScale - ( 0.5 / sceneSize );
+	o_color = g_scene.Sample( g_sampler, min( i_textureCoordinates, maxTextureCoordinates ) );
+}
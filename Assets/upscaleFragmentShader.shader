@@ -0,0 +1,9 @@
+--[[
+	This is the fragment shader that samples the scene
+	when it is upscaled
+]]
+
+return
+{
+	type = "fragment",
+}
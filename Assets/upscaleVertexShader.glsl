@@ -0,0 +1,39 @@
+/*
+	This vertex shader stretches a quad over the whole render target
+*/
+
+// The version of GLSL to use must come first
+#version 420
+
+// Constants
+//==========
+
+layout( std140, binding = 0 ) uniform constantBuffer
+{
+	float g_elapsedSecondCount_total;
+	float g_padding;
+	// The fraction of the scene's target that the scene was rendered to
+	vec2 g_sceneTextureCoordinateScale;
+};
+
+// Input
+//======
+
+// The quad's positions are in [0,1]
+layout( location = 0 ) in vec2 i_position;
+
+// Output
+//=======
+
+layout( location = 0 ) out vec2 o_textureCoordinates;
+
+// Entry Point
+//============
+
+void main()
+{
+	gl_Position = vec4( ( i_position * 2.0 ) - 1.0, 0.0, 1.0 );
+	// OpenGL textures start at the bottom, just like the quad
+	// (the scene was rendered to the bottom-left corner of its target)
+	o_textureCoordinates = i_position * g_sceneTextureCoordinateScale;
+}
@@ -0,0 +1,39 @@
+/*
+	This vertex shader stretches a quad over the whole render target
+*/
+
+// Constants
+//==========
+
+cbuffer constantBuffer : register( b0 )
+{
+	float g_elapsedSecondCount_total;
+	float g_padding;
+	// The fraction of the scene's target that the scene was rendered to
+	float2 g_sceneTextureCoordinateScale;
+}
+
+// Entry Point
+//============
+
+void main(
+
+	// Input
+	//======
+
+	// The quad's positions are in [0,1]
+	in const float2 i_position : POSITION,
+
+	// Output
+	//=======
+
+	out float4 o_position : SV_POSITION,
+	out float2 o_textureCoordinates : TEXCOORD0
+
+	)
+{
+	o_position = float4( ( i_position * 2.0 ) - 1.0, 0.0, 1.0 );
+	// Direct3D textures start at the top, and so V is flipped
+	// (the scene was rendered to the top-left corner of its target)
+	o_textureCoordinates = float2( i_position.x, 1.0 - i_position.y ) * g_sceneTextureCoordinateScale;
+}
@@ -0,0 +1,9 @@
+--[[
+	This is the vertex shader that stretches a quad over the whole render target
+	so that the scene can be upscaled
+]]
+
+return
+{
+	type = "vertex",
+}
@@ -21,14 +21,25 @@ layout( std140, binding = 0 ) uniform constantBuffer
 
 // This value comes from one of the sVertex that we filled the vertex buffer with in C code
 layout( location = 0 ) in vec2 i_position;
+#if VERTEX_COLOR
+// This value comes from the COLOR of one of the sParticleVertex
+layout( location = 1 ) in vec4 i_color;
+#endif
 
 // Output
 //=======
 
-// None; the vertex shader must always output a position value,
+// The vertex shader must always output a position value,
 // but unlike HLSL where the value is explicit
 // GLSL has an implicit required variable called "gl_Position"
 
+// The mesh's positions are in [0,1], and so they double as texture coordinates
+// (fragment shaders that don't sample a texture ignore them)
+layout( location = 0 ) out vec2 o_textureCoordinates;
+#if VERTEX_COLOR
+layout( location = 1 ) out vec4 o_color;
+#endif
+
 // Entry Point
 //============
 
@@ -39,7 +50,17 @@ void main()
 		// When we move to 3D graphics the screen position that the vertex shader outputs
 		// will be different than the position that is input to it from C code,
 		// but for now the "out" position is set directly from the "in" position:
+		// ANIMATE_POSITION is a permutation axis that is declared in vertexShader.shader
+#if ANIMATE_POSITION
 		gl_Position = vec4( i_position.x - 0.5 * sin(g_elapsedSecondCount_total) - 0.5, i_position.y - 0.5 * cos(g_elapsedSecondCount_total) - 0.5, 0.0, 1.0 );
+#else
+		gl_Position = vec4( i_position.x - 0.5, i_position.y - 0.5, 0.0, 1.0 );
+#endif
+		// OpenGL textures start at the bottom, just like the mesh
+		o_textureCoordinates = i_position;
+#if VERTEX_COLOR
+		o_color = i_color;
+#endif
 		// Or, equivalently:
 		//gl_Position = vec4( i_position.xy, 0.0, 1.0 );
 		//gl_Position = vec4( i_position, 0.0, 1.0 );
@@ -23,13 +23,25 @@ void main(
 
 	// This value comes from one of the sVertex that we filled the vertex buffer with in C code
 	in const float2 i_position : POSITION,
+#if VERTEX_COLOR
+	// This value comes from the COLOR of one of the sParticleVertex
+	in const float4 i_color : COLOR,
+#endif
 
 	// Output
 	//=======
 
 	// An SV_POSITION value must always be output from every vertex shader
 	// so that the GPU can figure out which fragments need to be shaded
-	out float4 o_position : SV_POSITION
+	out float4 o_position : SV_POSITION,
+	// The mesh's positions are in [0,1], and so they double as texture coordinates
+	// (fragment shaders that don't sample a texture ignore them)
+	out float2 o_textureCoordinates : TEXCOORD0
+#if VERTEX_COLOR
+	// This comes after the texture coordinates
+	// so that fragment shaders without VERTEX_COLOR still match this output signature
+	, out float4 o_color : COLOR0
+#endif
 
 	)
 {
@@ -38,7 +50,17 @@ void main(
 		// When we move to 3D graphics the screen position that the vertex shader outputs
 		// will be different than the position that is input to it from C code,
 		// but for now the "out" position is set directly from the "in" position:
+		// ANIMATE_POSITION is a permutation axis that is declared in vertexShader.shader
+#if ANIMATE_POSITION
 		o_position = float4( i_position.x - 0.5 * sin(g_elapsedSecondCount_total) - 0.5, i_position.y - 0.5 * cos(g_elapsedSecondCount_total) - 0.5, 0.0, 1.0 );
+#else
+		o_position = float4( i_position.x - 0.5, i_position.y - 0.5, 0.0, 1.0 );
+#endif
+		// Direct3D textures start at the top, and so V is flipped
+		o_textureCoordinates = float2( i_position.x, 1.0 - i_position.y );
+#if VERTEX_COLOR
+		o_color = i_color;
+#endif
 		// Or, equivalently:
 		//o_position = float4( i_position.xy, 0.0, 1.0 );
 		//o_position = float4( i_position, 0.0, 1.0 );
@@ -0,0 +1,19 @@
+--[[
+	This is the vertex shader that meshes and particles are drawn with
+
+	Each axis is a #define that the source code can check,
+	and every combination of values is compiled into the built shader library
+]]
+
+return
+{
+	type = "vertex",
+	axes =
+	{
+		-- Whether the position is offset by the elapsed time
+		{ name = "ANIMATE_POSITION" },
+		-- Whether every vertex has a color that is passed to the fragment shader
+		-- (only the "particle" vertex format has one)
+		{ name = "VERTEX_COLOR" },
+	},
+}
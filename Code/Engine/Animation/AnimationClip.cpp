@@ -0,0 +1,286 @@
+// Header Files
+//=============
+
+#include "AnimationClip.h"
+
+#include <cmath>
+#include <string>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// A track's values are aligned to 2 bytes after its key frames
+	const uint8_t* AlignTrackValues( const uint8_t* const i_address );
+	// Returns the index of the key at or before the time
+	// and sets o_t to how far the time is towards the next key
+	unsigned int FindKey( const uint8_t* const i_keyFrames, const unsigned int i_keyCount, const float i_blockTime, float& o_t );
+}
+
+// Interface
+//==========
+
+// Sample
+//-------
+
+void eae6320::Animation::AnimationClip::Sample( const float i_secondCount, sTransform* const o_pose ) const
+{
+	EAE6320_ASSERT( ( m_keyCount > 0 ) && o_pose );
+
+	float keyTime = std::fmod( i_secondCount * m_keysPerSecond, static_cast<float>( m_keyCount ) );
+	if ( keyTime < 0.0f )
+	{
+		keyTime += static_cast<float>( m_keyCount );
+	}
+	if ( m_blocks )
+	{
+		SampleBuilt( keyTime, o_pose );
+		return;
+	}
+	unsigned int keyIndex_a = static_cast<unsigned int>( keyTime );
+	// Rounding can put the time right at the end
+	if ( keyIndex_a >= m_keyCount )
+	{
+		keyIndex_a = m_keyCount - 1;
+	}
+	const unsigned int keyIndex_b = ( ( keyIndex_a + 1 ) < m_keyCount ) ? ( keyIndex_a + 1 ) : 0;
+	const float t = keyTime - static_cast<float>( keyIndex_a );
+
+	const sTransform* const pose_a = &m_keys[keyIndex_a * m_boneCount];
+	const sTransform* const pose_b = &m_keys[keyIndex_b * m_boneCount];
+	for ( unsigned int i = 0; i < m_boneCount; ++i )
+	{
+		Blend( pose_a[i], pose_b[i], t, o_pose[i] );
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Animation::AnimationClip::Initialize( const sTransform* const i_keys, const unsigned int i_boneCount, const unsigned int i_keyCount,
+	const float i_keysPerSecond )
+{
+	EAE6320_ASSERT( i_keys );
+	EAE6320_ASSERTF( m_keyCount == 0, "An animation clip can only be initialized once" );
+	if ( ( i_boneCount == 0 ) || ( i_keyCount == 0 ) || !( i_keysPerSecond > 0.0f ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "An animation clip needs at least one bone and key and a positive key rate"
+			" (%u bones, %u keys, %f keys per second)", i_boneCount, i_keyCount, i_keysPerSecond );
+		return false;
+	}
+
+	m_keys.assign( i_keys, i_keys + ( i_boneCount * i_keyCount ) );
+	m_boneCount = i_boneCount;
+	m_keyCount = i_keyCount;
+	m_keysPerSecond = i_keysPerSecond;
+	m_secondsPerKey = 1.0f / i_keysPerSecond;
+
+	return true;
+}
+
+bool eae6320::Animation::AnimationClip::Load( const char* const i_path )
+{
+	bool wereThereErrors = false;
+
+	// A clip can only be loaded once
+	EAE6320_ASSERT( m_keyCount == 0 );
+
+	{
+		std::string errorMessage;
+		if ( !Platform::MapBinaryFile( i_path, m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to map the animation clip %s: %s", i_path, errorMessage.c_str() );
+			goto OnExit;
+		}
+	}
+	// Validate the file
+	{
+		const uint8_t* const fileData = reinterpret_cast<const uint8_t*>( m_file.data );
+		const AnimationFormats::sHeader* const header = reinterpret_cast<const AnimationFormats::sHeader*>( fileData );
+		if ( ( m_file.size < sizeof( AnimationFormats::sHeader ) )
+			|| ( header->fourCc != AnimationFormats::s_fourCc ) || ( header->version != AnimationFormats::s_version ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Invalid animation clip file" );
+			Logging::OutputError( "The animation clip %s isn't a built clip (or was built by a different version of the AnimationBuilder)", i_path );
+			goto OnExit;
+		}
+		if ( ( header->boneCount == 0 ) || ( header->keyCount == 0 ) || ( header->blockKeyCount == 0 )
+			|| ( header->blockCount != ( ( header->keyCount + header->blockKeyCount - 1 ) / header->blockKeyCount ) )
+			|| !( header->keysPerSecond > 0.0f ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Invalid animation clip header" );
+			Logging::OutputError( "The animation clip %s has an invalid header", i_path );
+			goto OnExit;
+		}
+		const size_t offset_bones = sizeof( AnimationFormats::sHeader );
+		const size_t offset_blockOffsets = offset_bones + ( header->boneCount * sizeof( AnimationFormats::sBone ) );
+		const size_t offset_blocks = offset_blockOffsets + ( header->blockCount * sizeof( uint32_t ) );
+		if ( m_file.size <= offset_blocks )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Truncated animation clip file" );
+			Logging::OutputError( "The animation clip %s is shorter than its header says it should be", i_path );
+			goto OnExit;
+		}
+		m_bones = reinterpret_cast<const AnimationFormats::sBone*>( fileData + offset_bones );
+		m_blockOffsets = reinterpret_cast<const uint32_t*>( fileData + offset_blockOffsets );
+		for ( unsigned int i = 0; i < header->blockCount; ++i )
+		{
+			if ( m_blockOffsets[i] >= ( m_file.size - offset_blocks ) )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, "Truncated animation clip file" );
+				Logging::OutputError( "Block %u of the animation clip %s is past the end of the file", i, i_path );
+				goto OnExit;
+			}
+		}
+		m_blocks = fileData + offset_blocks;
+		m_blockKeyCount = header->blockKeyCount;
+		m_blockCount = header->blockCount;
+		m_boneCount = header->boneCount;
+		m_keyCount = header->keyCount;
+		m_keysPerSecond = header->keysPerSecond;
+		m_secondsPerKey = 1.0f / header->keysPerSecond;
+	}
+
+OnExit:
+
+	if ( wereThereErrors )
+	{
+		CleanUp();
+	}
+
+	return !wereThereErrors;
+}
+
+void eae6320::Animation::AnimationClip::CleanUp()
+{
+	m_keys.clear();
+	if ( m_file.data )
+	{
+		std::string errorMessage;
+		if ( !Platform::UnmapBinaryFile( m_file, &errorMessage ) )
+		{
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to unmap an animation clip: %s", errorMessage.c_str() );
+		}
+	}
+	m_bones = NULL;
+	m_blockOffsets = NULL;
+	m_blocks = NULL;
+	m_blockKeyCount = 0;
+	m_blockCount = 0;
+	m_boneCount = 0;
+	m_keyCount = 0;
+	m_keysPerSecond = 0.0f;
+	m_secondsPerKey = 0.0f;
+}
+
+eae6320::Animation::AnimationClip::~AnimationClip()
+{
+	CleanUp();
+}
+
+// Implementation
+//===============
+
+void eae6320::Animation::AnimationClip::SampleBuilt( const float i_keyTime, sTransform* const o_pose ) const
+{
+	// Only the block that the time is in is read
+	unsigned int blockIndex = static_cast<unsigned int>( i_keyTime ) / m_blockKeyCount;
+	if ( blockIndex >= m_blockCount )
+	{
+		blockIndex = m_blockCount - 1;
+	}
+	const float blockTime = i_keyTime - static_cast<float>( blockIndex * m_blockKeyCount );
+	const uint8_t* track = m_blocks + m_blockOffsets[blockIndex];
+
+	for ( unsigned int i = 0; i < m_boneCount; ++i )
+	{
+		const AnimationFormats::sBone& bone = m_bones[i];
+		sTransform& o_transform = o_pose[i];
+		// Rotation
+		if ( ( bone.flags & AnimationFormats::eBoneFlag::IsRotationConstant ) == 0 )
+		{
+			const unsigned int keyCount = track[0];
+			const uint8_t* const keyFrames = track + 1;
+			const AnimationFormats::sQuantizedRotation* const values =
+				reinterpret_cast<const AnimationFormats::sQuantizedRotation*>( AlignTrackValues( keyFrames + keyCount ) );
+			float t;
+			const unsigned int keyIndex = FindKey( keyFrames, keyCount, blockTime, t );
+			float rotation_a[4], rotation_b[4];
+			AnimationFormats::DequantizeRotation( values[keyIndex], rotation_a );
+			AnimationFormats::DequantizeRotation( values[keyIndex + 1], rotation_b );
+			BlendRotations( rotation_a, rotation_b, t, o_transform.rotation );
+			track = reinterpret_cast<const uint8_t*>( values + keyCount );
+		}
+		else
+		{
+			for ( unsigned int j = 0; j < 4; ++j )
+			{
+				o_transform.rotation[j] = bone.rotation[j];
+			}
+		}
+		// Translation
+		if ( ( bone.flags & AnimationFormats::eBoneFlag::IsTranslationConstant ) == 0 )
+		{
+			const unsigned int keyCount = track[0];
+			const uint8_t* const keyFrames = track + 1;
+			const AnimationFormats::sQuantizedTranslation* const values =
+				reinterpret_cast<const AnimationFormats::sQuantizedTranslation*>( AlignTrackValues( keyFrames + keyCount ) );
+			float t;
+			const unsigned int keyIndex = FindKey( keyFrames, keyCount, blockTime, t );
+			float translation_a[3], translation_b[3];
+			AnimationFormats::DequantizeTranslation( values[keyIndex], bone, translation_a );
+			AnimationFormats::DequantizeTranslation( values[keyIndex + 1], bone, translation_b );
+			for ( unsigned int j = 0; j < 3; ++j )
+			{
+				o_transform.translation[j] = translation_a[j] + ( ( translation_b[j] - translation_a[j] ) * t );
+			}
+			track = reinterpret_cast<const uint8_t*>( values + keyCount );
+		}
+		else
+		{
+			for ( unsigned int j = 0; j < 3; ++j )
+			{
+				o_transform.translation[j] = bone.translationMin[j];
+			}
+		}
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	const uint8_t* AlignTrackValues( const uint8_t* const i_address )
+	{
+		return reinterpret_cast<const uint8_t*>( ( reinterpret_cast<uintptr_t>( i_address ) + 1 ) & ~static_cast<uintptr_t>( 1 ) );
+	}
+
+	unsigned int FindKey( const uint8_t* const i_keyFrames, const unsigned int i_keyCount, const float i_blockTime, float& o_t )
+	{
+		// Every track has a key at the start and end of the block,
+		// and a block has few enough keys that a linear search is faster than a binary one
+		EAE6320_ASSERT( i_keyCount >= 2 );
+		unsigned int keyIndex = 0;
+		while ( ( ( keyIndex + 2 ) < i_keyCount ) && ( static_cast<float>( i_keyFrames[keyIndex + 1] ) <= i_blockTime ) )
+		{
+			++keyIndex;
+		}
+		const float frame_a = static_cast<float>( i_keyFrames[keyIndex] );
+		const float frame_b = static_cast<float>( i_keyFrames[keyIndex + 1] );
+		const float t = ( i_blockTime - frame_a ) / ( frame_b - frame_a );
+		o_t = ( t < 0.0f ) ? 0.0f : ( ( t > 1.0f ) ? 1.0f : t );
+		return keyIndex;
+	}
+}
@@ -0,0 +1,95 @@
+/*
+	An animation clip stores a local pose for every bone at evenly spaced key times
+
+	Sampling a clip interpolates between the two keys on either side of the time
+	(and the clip loops, so the last key blends back into the first).
+	A clip can either be initialized with raw keys
+	(which are stored one pose after another so that sampling reads two contiguous poses)
+	or loaded from a file built by the AnimationBuilder
+	(which is much smaller; see AnimationFormats.h).
+	Sampling a built clip only reads the block of keys that the time is in,
+	and so it costs the same no matter how long the clip is.
+*/
+
+#ifndef EAE6320_ANIMATION_ANIMATIONCLIP_H
+#define EAE6320_ANIMATION_ANIMATIONCLIP_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "AnimationFormats.h"
+#include "Transform.h"
+#include "../Platform/Platform.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Animation
+	{
+		class AnimationClip
+		{
+		public:
+
+			// Sample
+			//-------
+
+			// Times past the end of the clip (or before its start) wrap around.
+			// o_pose must have room for every bone.
+			void Sample( const float i_secondCount, sTransform* const o_pose ) const;
+
+			// Access
+			//-------
+
+			unsigned int GetBoneCount() const { return m_boneCount; }
+			unsigned int GetKeyCount() const { return m_keyCount; }
+			// The duration includes blending from the last key back to the first
+			float GetDuration() const { return m_keyCount * m_secondsPerKey; }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The keys are i_keyCount poses of i_boneCount bones each
+			bool Initialize( const sTransform* const i_keys, const unsigned int i_boneCount, const unsigned int i_keyCount,
+				const float i_keysPerSecond );
+			// The file is mapped rather than copied, and it stays mapped until the clip is cleaned up
+			bool Load( const char* const i_path );
+			void CleanUp();
+
+			~AnimationClip();
+
+			// Implementation
+			//===============
+
+		private:
+
+			void SampleBuilt( const float i_keyTime, sTransform* const o_pose ) const;
+
+			// Data
+			//=====
+
+		private:
+
+			// Raw keys
+			std::vector<sTransform> m_keys;
+			// Built keys
+			Platform::sMappedFile m_file;
+			const AnimationFormats::sBone* m_bones = NULL;
+			const uint32_t* m_blockOffsets = NULL;
+			const uint8_t* m_blocks = NULL;
+			unsigned int m_blockKeyCount = 0;
+			unsigned int m_blockCount = 0;
+
+			unsigned int m_boneCount = 0;
+			unsigned int m_keyCount = 0;
+			float m_secondsPerKey = 0.0f;
+			float m_keysPerSecond = 0.0f;
+		};
+	}
+}
+
+#endif	// EAE6320_ANIMATION_ANIMATIONCLIP_H
@@ -0,0 +1,178 @@
+/*
+	This file describes the layout of a built animation clip
+
+	It is shared between the AnimationBuilder (which writes the file)
+	and the runtime AnimationClip (which reads it).
+
+	Every bone has a rotation track and a translation track.
+	A track that doesn't change enough to matter is stored once in the bone table,
+	and every other track only keeps the keys that are needed to stay within the clip's error tolerance.
+	Rotations are quantized with the "smallest three" scheme
+	(the largest component is dropped and rebuilt from the other three, which are 15 bits each)
+	and translations are quantized to 16 bits per component within the range of the bone's track.
+
+	The clip's frames are split into blocks of blockKeyCount frames,
+	and each block stores every animated track's keys for its frames,
+	including a key at each end of the block
+	(so that a time can be sampled from its block without looking at any other).
+	The clip loops, and so the last block ends with a copy of the first frame.
+
+	A built animation clip is:
+		* An sHeader
+		* An sBone for every bone
+		* A uint32_t for every block, which is the offset of the block from the start of the first one
+		* The blocks
+	A block stores the animated tracks in bone order (a bone's rotation before its translation),
+	and a track is:
+		* A uint8_t with the number of keys
+		* A uint8_t for every key with the key's frame relative to the start of the block
+		* A byte of padding if necessary to align the values to 2 bytes
+		* An sQuantizedRotation or sQuantizedTranslation for every key
+*/
+
+#ifndef EAE6320_ANIMATION_ANIMATIONFORMATS_H
+#define EAE6320_ANIMATION_ANIMATIONFORMATS_H
+
+// Header Files
+//=============
+
+#include <cmath>
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Animation
+	{
+		namespace AnimationFormats
+		{
+			// "EANM" read as a little-endian uint32_t
+			const uint32_t s_fourCc = 0x4d4e4145;
+			const uint16_t s_version = 1;
+
+			// A track's key count and each key's frame within its block are stored in bytes,
+			// and a block can have a key at every frame including the one at its end
+			const unsigned int s_maxBlockKeyCount = 254;
+
+			namespace eBoneFlag
+			{
+				enum eBoneFlag
+				{
+					// The track has no keys in the blocks
+					IsRotationConstant = 1 << 0,
+					IsTranslationConstant = 1 << 1,
+				};
+			}
+
+			struct sHeader
+			{
+				uint32_t fourCc;
+				uint16_t version;
+				uint16_t boneCount;
+				// The number of frames in the loop
+				// (the copy of the first frame at the end isn't counted)
+				uint16_t keyCount;
+				uint16_t blockKeyCount;
+				uint16_t blockCount;
+				uint16_t padding;
+				float keysPerSecond;
+			};
+
+			struct sBone
+			{
+				// This is only used if the rotation is constant
+				float rotation[4];
+				// A translation is min + ( extent * quantized / 65535 ),
+				// and so a constant translation is just the min (with no extent)
+				float translationMin[3];
+				float translationExtent[3];
+				// A combination of eBoneFlag flags
+				uint8_t flags;
+				uint8_t padding[3];
+			};
+
+			// The top bit of the first two values stores which component was dropped
+			struct sQuantizedRotation
+			{
+				uint16_t values[3];
+			};
+			struct sQuantizedTranslation
+			{
+				uint16_t values[3];
+			};
+
+			// Quantization
+			//-------------
+
+			// The dropped component is the largest one, and so the others can't be bigger than 1/sqrt(2)
+			const float s_maxSmallestThree = 0.70710678f;
+			const float s_maxQuantizedSmallestThree = 32767.0f;
+
+			// The quaternion is (x,y,z,w) and must be normalized
+			inline void QuantizeRotation( const float i_rotation[4], sQuantizedRotation& o_rotation )
+			{
+				unsigned int largestIndex = 0;
+				for ( unsigned int i = 1; i < 4; ++i )
+				{
+					if ( std::fabs( i_rotation[i] ) > std::fabs( i_rotation[largestIndex] ) )
+					{
+						largestIndex = i;
+					}
+				}
+				// q and -q are the same rotation, and so the dropped component is made positive
+				const float sign = ( i_rotation[largestIndex] < 0.0f ) ? -1.0f : 1.0f;
+				for ( unsigned int i = 0, j = 0; i < 4; ++i )
+				{
+					if ( i != largestIndex )
+					{
+						float value = ( ( sign * i_rotation[i] / s_maxSmallestThree ) * 0.5f ) + 0.5f;
+						value = ( value < 0.0f ) ? 0.0f : ( ( value > 1.0f ) ? 1.0f : value );
+						o_rotation.values[j++] = static_cast<uint16_t>( ( value * s_maxQuantizedSmallestThree ) + 0.5f );
+					}
+				}
+				o_rotation.values[0] |= static_cast<uint16_t>( ( largestIndex & 1 ) << 15 );
+				o_rotation.values[1] |= static_cast<uint16_t>( ( largestIndex >> 1 ) << 15 );
+			}
+			inline void DequantizeRotation( const sQuantizedRotation& i_rotation, float o_rotation[4] )
+			{
+				const float scale = ( 2.0f * s_maxSmallestThree ) / s_maxQuantizedSmallestThree;
+				const float a = ( static_cast<float>( i_rotation.values[0] & 0x7fff ) * scale ) - s_maxSmallestThree;
+				const float b = ( static_cast<float>( i_rotation.values[1] & 0x7fff ) * scale ) - s_maxSmallestThree;
+				const float c = ( static_cast<float>( i_rotation.values[2] & 0x7fff ) * scale ) - s_maxSmallestThree;
+				const float sumOfSquares = ( a * a ) + ( b * b ) + ( c * c );
+				const float largest = ( sumOfSquares < 1.0f ) ? std::sqrt( 1.0f - sumOfSquares ) : 0.0f;
+				// This is called for every key that is sampled, and so it doesn't loop
+				switch ( ( i_rotation.values[0] >> 15 ) | ( ( i_rotation.values[1] >> 15 ) << 1 ) )
+				{
+				case 0: o_rotation[0] = largest; o_rotation[1] = a; o_rotation[2] = b; o_rotation[3] = c; break;
+				case 1: o_rotation[0] = a; o_rotation[1] = largest; o_rotation[2] = b; o_rotation[3] = c; break;
+				case 2: o_rotation[0] = a; o_rotation[1] = b; o_rotation[2] = largest; o_rotation[3] = c; break;
+				default: o_rotation[0] = a; o_rotation[1] = b; o_rotation[2] = c; o_rotation[3] = largest; break;
+				}
+			}
+
+			inline void QuantizeTranslation( const float i_translation[3], const sBone& i_bone, sQuantizedTranslation& o_translation )
+			{
+				for ( unsigned int i = 0; i < 3; ++i )
+				{
+					float value = ( i_bone.translationExtent[i] > 0.0f )
+						? ( ( i_translation[i] - i_bone.translationMin[i] ) / i_bone.translationExtent[i] ) : 0.0f;
+					value = ( value < 0.0f ) ? 0.0f : ( ( value > 1.0f ) ? 1.0f : value );
+					o_translation.values[i] = static_cast<uint16_t>( ( value * 65535.0f ) + 0.5f );
+				}
+			}
+			inline void DequantizeTranslation( const sQuantizedTranslation& i_translation, const sBone& i_bone, float o_translation[3] )
+			{
+				for ( unsigned int i = 0; i < 3; ++i )
+				{
+					o_translation[i] = i_bone.translationMin[i]
+						+ ( i_bone.translationExtent[i] * ( static_cast<float>( i_translation.values[i] ) / 65535.0f ) );
+				}
+			}
+		}
+	}
+}
+
+#endif	// EAE6320_ANIMATION_ANIMATIONFORMATS_H
@@ -0,0 +1,187 @@
+// Header Files
+//=============
+
+#include "Animator.h"
+
+#include "AnimationClip.h"
+#include "Skeleton.h"
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// A character with a typical skeleton takes a few microseconds to update,
+	// and so a batch has enough characters to be worth handing to another thread
+	const unsigned int s_animatorBatchSize = 8;
+
+	struct sUpdateAllData
+	{
+		eae6320::Animation::Animator* const* animators;
+		float secondCountToIntegrate;
+	};
+}
+
+// Interface
+//==========
+
+// Update
+//-------
+
+void eae6320::Animation::Animator::Update( const float i_secondCountToIntegrate )
+{
+	EAE6320_ASSERT( m_skeleton );
+	const unsigned int boneCount = m_skeleton->GetBoneCount();
+	const float secondCountToAdvance = i_secondCountToIntegrate * m_playbackRate;
+
+	// Sample and blend the clips
+	{
+		for ( unsigned int i = 0; i < 2; ++i )
+		{
+			m_secondCounts[i] += secondCountToAdvance;
+		}
+		// A clip that wouldn't contribute to the blend isn't sampled
+		const bool isClipAUsed = m_blendWeight < 1.0f;
+		const bool isClipBUsed = m_blendWeight > 0.0f;
+		sTransform* const localPose = &m_localPose[0];
+		if ( isClipAUsed )
+		{
+			if ( m_clips[0] )
+			{
+				m_clips[0]->Sample( m_secondCounts[0], localPose );
+			}
+			else
+			{
+				const sTransform* const bindPose = m_skeleton->GetBindPose();
+				for ( unsigned int i = 0; i < boneCount; ++i )
+				{
+					localPose[i] = bindPose[i];
+				}
+			}
+		}
+		if ( isClipBUsed )
+		{
+			// If only clip B is used it is sampled straight into the final pose
+			sTransform* const localPose_b = isClipAUsed ? &m_localPose_b[0] : localPose;
+			if ( m_clips[1] )
+			{
+				m_clips[1]->Sample( m_secondCounts[1], localPose_b );
+			}
+			else
+			{
+				const sTransform* const bindPose = m_skeleton->GetBindPose();
+				for ( unsigned int i = 0; i < boneCount; ++i )
+				{
+					localPose_b[i] = bindPose[i];
+				}
+			}
+			if ( isClipAUsed )
+			{
+				for ( unsigned int i = 0; i < boneCount; ++i )
+				{
+					sTransform blended;
+					Blend( localPose[i], localPose_b[i], m_blendWeight, blended );
+					localPose[i] = blended;
+				}
+			}
+		}
+	}
+	// Convert the pose to the model's space
+	{
+		const uint16_t* const parentIndices = m_skeleton->GetParentIndices();
+		for ( unsigned int i = 0; i < boneCount; ++i )
+		{
+			const uint16_t parentIndex = parentIndices[i];
+			if ( parentIndex == Skeleton::s_noParent )
+			{
+				m_modelPose[i] = m_localPose[i];
+			}
+			else
+			{
+				// Parents come before their children, and so the parent's model transform is already known
+				Multiply( m_modelPose[parentIndex], m_localPose[i], m_modelPose[i] );
+			}
+		}
+	}
+	// Calculate the skinning matrices
+	{
+		const sTransform* const inverseBindPose = m_skeleton->GetInverseBindPose();
+		for ( unsigned int i = 0; i < boneCount; ++i )
+		{
+			sTransform skinningTransform;
+			Multiply( m_modelPose[i], inverseBindPose[i], skinningTransform );
+			CalculateMatrix( skinningTransform, &m_skinningMatrices[i * s_matrixFloatCount] );
+		}
+	}
+}
+
+void eae6320::Animation::Animator::UpdateAll( Animator* const* const i_animators, const unsigned int i_animatorCount, const float i_secondCountToIntegrate )
+{
+	sUpdateAllData updateAllData = { i_animators, i_secondCountToIntegrate };
+	Jobs::ParallelFor( i_animatorCount, s_animatorBatchSize, UpdateBatch, &updateAllData );
+}
+
+// Access
+//-------
+
+void eae6320::Animation::Animator::SetClips( const AnimationClip* const i_clipA, const AnimationClip* const i_clipB )
+{
+	EAE6320_ASSERT( m_skeleton );
+	EAE6320_ASSERTF( ( !i_clipA || ( i_clipA->GetBoneCount() == m_skeleton->GetBoneCount() ) )
+		&& ( !i_clipB || ( i_clipB->GetBoneCount() == m_skeleton->GetBoneCount() ) ),
+		"An animator's clips must have the same number of bones as its skeleton" );
+	m_clips[0] = i_clipA;
+	m_clips[1] = i_clipB;
+	m_secondCounts[0] = m_secondCounts[1] = 0.0f;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Animation::Animator::Initialize( const Skeleton& i_skeleton )
+{
+	const unsigned int boneCount = i_skeleton.GetBoneCount();
+	if ( boneCount == 0 )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "An animator can't be initialized with a skeleton that has no bones" );
+		return false;
+	}
+	m_skeleton = &i_skeleton;
+	m_clips[0] = m_clips[1] = NULL;
+	m_secondCounts[0] = m_secondCounts[1] = 0.0f;
+
+	m_localPose.assign( i_skeleton.GetBindPose(), i_skeleton.GetBindPose() + boneCount );
+	m_localPose_b.resize( boneCount );
+	m_modelPose.resize( boneCount );
+	m_skinningMatrices.resize( boneCount * s_matrixFloatCount );
+	// The skinning matrices start out in the bind pose
+	Update( 0.0f );
+
+	return true;
+}
+
+void eae6320::Animation::Animator::CleanUp()
+{
+	m_skeleton = NULL;
+	m_clips[0] = m_clips[1] = NULL;
+	m_localPose.clear();
+	m_localPose_b.clear();
+	m_modelPose.clear();
+	m_skinningMatrices.clear();
+}
+
+// Implementation
+//===============
+
+void eae6320::Animation::Animator::UpdateBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+{
+	const sUpdateAllData& updateAllData = *reinterpret_cast<const sUpdateAllData*>( io_userData );
+	for ( unsigned int i = i_begin; i < i_end; ++i )
+	{
+		updateAllData.animators[i]->Update( updateAllData.secondCountToIntegrate );
+	}
+}
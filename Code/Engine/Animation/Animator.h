@@ -0,0 +1,104 @@
+/*
+	An animator poses one character's skeleton every frame
+
+	It plays two clips at the same time and blends between them
+	(e.g. a walk and a run, with the weight set from the character's speed).
+	Updating an animator samples both clips, blends the poses,
+	converts the pose from each bone's parent's space to the model's space,
+	and then calculates the skinning matrices that a skinned mesh needs.
+
+	Characters don't depend on each other,
+	and so many animators can be updated in parallel with UpdateAll().
+*/
+
+#ifndef EAE6320_ANIMATION_ANIMATOR_H
+#define EAE6320_ANIMATION_ANIMATOR_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <vector>
+#include "Transform.h"
+
+// Forward Declarations
+//=====================
+
+namespace eae6320
+{
+	namespace Animation
+	{
+		class AnimationClip;
+		class Skeleton;
+	}
+}
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Animation
+	{
+		class Animator
+		{
+		public:
+
+			// Update
+			//-------
+
+			void Update( const float i_secondCountToIntegrate );
+			// The animators are split into batches that are updated on the worker threads
+			static void UpdateAll( Animator* const* const i_animators, const unsigned int i_animatorCount, const float i_secondCountToIntegrate );
+
+			// Access
+			//-------
+
+			// Either clip can be NULL, in which case that clip's pose is the skeleton's bind pose.
+			// The clips must have the same number of bones as the skeleton.
+			void SetClips( const AnimationClip* const i_clipA, const AnimationClip* const i_clipB );
+			// 0 is only clip A and 1 is only clip B
+			void SetBlendWeight( const float i_blendWeight ) { m_blendWeight = i_blendWeight; }
+			void SetPlaybackRate( const float i_playbackRate ) { m_playbackRate = i_playbackRate; }
+
+			const Skeleton* GetSkeleton() const { return m_skeleton; }
+			// Every bone has a 3x4 matrix (see CalculateMatrix() in Transform.h)
+			// that is valid after the animator has been updated
+			const float* GetSkinningMatrices() const { return m_skinningMatrices.empty() ? NULL : &m_skinningMatrices[0]; }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The skeleton must stay valid for as long as the animator is used
+			bool Initialize( const Skeleton& i_skeleton );
+			void CleanUp();
+
+			// Implementation
+			//===============
+
+		private:
+
+			static void UpdateBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+
+			// Data
+			//=====
+
+		private:
+
+			const Skeleton* m_skeleton = NULL;
+			const AnimationClip* m_clips[2] = { NULL, NULL };
+			// Each clip keeps its own time so that clips of different lengths loop independently
+			float m_secondCounts[2] = { 0.0f, 0.0f };
+			float m_blendWeight = 0.0f;
+			float m_playbackRate = 1.0f;
+
+			// These are kept from frame to frame so that updating never allocates
+			std::vector<sTransform> m_localPose;
+			std::vector<sTransform> m_localPose_b;
+			std::vector<sTransform> m_modelPose;
+			std::vector<float> m_skinningMatrices;
+		};
+	}
+}
+
+#endif	// EAE6320_ANIMATION_ANIMATOR_H
@@ -0,0 +1,64 @@
+// Header Files
+//=============
+
+#include "Skeleton.h"
+
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Interface
+//==========
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Animation::Skeleton::Initialize( const uint16_t* const i_parentIndices, const sTransform* const i_bindPose, const unsigned int i_boneCount )
+{
+	EAE6320_ASSERT( i_parentIndices && i_bindPose );
+	if ( ( i_boneCount == 0 ) || ( i_boneCount > s_maxBoneCount ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "A skeleton can't have %u bones (it must have between 1 and %u)", i_boneCount, s_maxBoneCount );
+		return false;
+	}
+	for ( unsigned int i = 0; i < i_boneCount; ++i )
+	{
+		const uint16_t parentIndex = i_parentIndices[i];
+		if ( ( parentIndex != s_noParent ) && ( parentIndex >= i ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Bone %u's parent (%u) doesn't come before it in the skeleton", i, parentIndex );
+			return false;
+		}
+	}
+
+	m_parentIndices.assign( i_parentIndices, i_parentIndices + i_boneCount );
+	m_bindPose.assign( i_bindPose, i_bindPose + i_boneCount );
+	// The inverse bind pose is calculated from the bind pose in the model's space
+	m_inverseBindPose.resize( i_boneCount );
+	{
+		std::vector<sTransform> bindPose_model( i_boneCount );
+		for ( unsigned int i = 0; i < i_boneCount; ++i )
+		{
+			const uint16_t parentIndex = i_parentIndices[i];
+			if ( parentIndex == s_noParent )
+			{
+				bindPose_model[i] = i_bindPose[i];
+			}
+			else
+			{
+				Multiply( bindPose_model[parentIndex], i_bindPose[i], bindPose_model[i] );
+			}
+			Invert( bindPose_model[i], m_inverseBindPose[i] );
+		}
+	}
+
+	return true;
+}
+
+void eae6320::Animation::Skeleton::CleanUp()
+{
+	m_parentIndices.clear();
+	m_bindPose.clear();
+	m_inverseBindPose.clear();
+}
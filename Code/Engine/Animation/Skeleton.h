@@ -0,0 +1,65 @@
+/*
+	A skeleton is a hierarchy of bones and the pose that a skinned mesh was built in
+
+	Every bone's parent comes before it,
+	and so a pose can be converted from each bone's parent's space to the model's space
+	in a single pass from the first bone to the last.
+*/
+
+#ifndef EAE6320_ANIMATION_SKELETON_H
+#define EAE6320_ANIMATION_SKELETON_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Transform.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Animation
+	{
+		class Skeleton
+		{
+		public:
+
+			// A skinned vertex stores its bone indices in a byte each
+			static const unsigned int s_maxBoneCount = 256;
+			// The root bone (or bones) use this as their parent index
+			static const uint16_t s_noParent = 0xffff;
+
+			// Access
+			//-------
+
+			unsigned int GetBoneCount() const { return static_cast<unsigned int>( m_parentIndices.size() ); }
+			const uint16_t* GetParentIndices() const { return m_parentIndices.empty() ? NULL : &m_parentIndices[0]; }
+			// Each bone is relative to its parent
+			const sTransform* GetBindPose() const { return m_bindPose.empty() ? NULL : &m_bindPose[0]; }
+			// Each bone's inverse bind transform takes a vertex from the model's space to the bone's space
+			const sTransform* GetInverseBindPose() const { return m_inverseBindPose.empty() ? NULL : &m_inverseBindPose[0]; }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The bind pose is the pose (relative to each bone's parent) that the mesh's vertices were built in
+			bool Initialize( const uint16_t* const i_parentIndices, const sTransform* const i_bindPose, const unsigned int i_boneCount );
+			void CleanUp();
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<uint16_t> m_parentIndices;
+			std::vector<sTransform> m_bindPose;
+			std::vector<sTransform> m_inverseBindPose;
+		};
+	}
+}
+
+#endif	// EAE6320_ANIMATION_SKELETON_H
@@ -0,0 +1,250 @@
+// Header Files
+//=============
+
+#include "SkinnedVertices.h"
+
+#include <cstring>
+#include <xmmintrin.h>
+#include "Transform.h"
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	template<typename tElement>
+	tElement* AllocateAlignedArray( const unsigned int i_count );
+	template<typename tElement>
+	void FreeAlignedArray( tElement*& io_array );
+
+	float* GetPosition( void* const io_positions, const unsigned int i_index, const size_t i_stride );
+}
+
+// Interface
+//==========
+
+// Skin
+//-------
+
+void eae6320::Animation::SkinnedVertices::Skin( const float* const i_skinningMatrices, const unsigned int i_begin, const unsigned int i_end,
+	void* const o_positions, const size_t i_stride, const unsigned int i_componentCount ) const
+{
+	EAE6320_ASSERT( ( i_begin % s_vertexCountPerIteration ) == 0 );
+	EAE6320_ASSERT( ( i_end <= m_vertexCount ) && ( ( i_componentCount == 2 ) || ( i_componentCount == 3 ) ) );
+
+	for ( unsigned int i = i_begin; i < i_end; i += 4 )
+	{
+		// Blend each vertex's matrix
+		// (the rows are stored as rows[row][vertex])
+		__m128 rows[3][4];
+		for ( unsigned int v = 0; v < 4; ++v )
+		{
+			const uint8_t* const boneIndices = m_boneIndices + ( ( i + v ) * 4 );
+			const __m128 weights = _mm_load_ps( m_boneWeights + ( ( i + v ) * 4 ) );
+			const __m128 weight0 = _mm_shuffle_ps( weights, weights, _MM_SHUFFLE( 0, 0, 0, 0 ) );
+			const __m128 weight1 = _mm_shuffle_ps( weights, weights, _MM_SHUFFLE( 1, 1, 1, 1 ) );
+			const __m128 weight2 = _mm_shuffle_ps( weights, weights, _MM_SHUFFLE( 2, 2, 2, 2 ) );
+			const __m128 weight3 = _mm_shuffle_ps( weights, weights, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+			const float* const matrix0 = i_skinningMatrices + ( boneIndices[0] * s_matrixFloatCount );
+			const float* const matrix1 = i_skinningMatrices + ( boneIndices[1] * s_matrixFloatCount );
+			const float* const matrix2 = i_skinningMatrices + ( boneIndices[2] * s_matrixFloatCount );
+			const float* const matrix3 = i_skinningMatrices + ( boneIndices[3] * s_matrixFloatCount );
+			for ( unsigned int r = 0; r < 3; ++r )
+			{
+				// The caller's matrices don't have to be aligned
+				__m128 row = _mm_mul_ps( _mm_loadu_ps( matrix0 + ( r * 4 ) ), weight0 );
+				row = _mm_add_ps( row, _mm_mul_ps( _mm_loadu_ps( matrix1 + ( r * 4 ) ), weight1 ) );
+				row = _mm_add_ps( row, _mm_mul_ps( _mm_loadu_ps( matrix2 + ( r * 4 ) ), weight2 ) );
+				row = _mm_add_ps( row, _mm_mul_ps( _mm_loadu_ps( matrix3 + ( r * 4 ) ), weight3 ) );
+				rows[r][v] = row;
+			}
+		}
+		// Transform the 4 positions together
+		const __m128 positionX = _mm_load_ps( m_positionX + i );
+		const __m128 positionY = _mm_load_ps( m_positionY + i );
+		const __m128 positionZ = _mm_load_ps( m_positionZ + i );
+		__m128 skinned[3];
+		for ( unsigned int r = 0; r < 3; ++r )
+		{
+			// After transposing, each register has one column of the row for all 4 vertices
+			__m128 column0 = rows[r][0], column1 = rows[r][1], column2 = rows[r][2], column3 = rows[r][3];
+			_MM_TRANSPOSE4_PS( column0, column1, column2, column3 );
+			__m128 result = _mm_add_ps( _mm_mul_ps( column0, positionX ), column3 );
+			result = _mm_add_ps( result, _mm_mul_ps( column1, positionY ) );
+			result = _mm_add_ps( result, _mm_mul_ps( column2, positionZ ) );
+			skinned[r] = result;
+		}
+		// Write the vertices that are in the range
+		// (the output's layout is up to the caller, and so the components are written one at a time)
+		{
+			float components[3][4];
+			_mm_storeu_ps( components[0], skinned[0] );
+			_mm_storeu_ps( components[1], skinned[1] );
+			_mm_storeu_ps( components[2], skinned[2] );
+			const unsigned int vertexCount = ( ( i_end - i ) < 4 ) ? ( i_end - i ) : 4;
+			for ( unsigned int v = 0; v < vertexCount; ++v )
+			{
+				float* const position = GetPosition( o_positions, i + v, i_stride );
+				for ( unsigned int c = 0; c < i_componentCount; ++c )
+				{
+					position[c] = components[c][v];
+				}
+			}
+		}
+	}
+}
+
+void eae6320::Animation::SkinnedVertices::Skin_scalar( const float* const i_skinningMatrices, const unsigned int i_begin, const unsigned int i_end,
+	void* const o_positions, const size_t i_stride, const unsigned int i_componentCount ) const
+{
+	EAE6320_ASSERT( ( i_end <= m_vertexCount ) && ( ( i_componentCount == 2 ) || ( i_componentCount == 3 ) ) );
+
+	for ( unsigned int i = i_begin; i < i_end; ++i )
+	{
+		float matrix[s_matrixFloatCount] = { 0.0f };
+		for ( unsigned int b = 0; b < 4; ++b )
+		{
+			const float* const boneMatrix = i_skinningMatrices + ( m_boneIndices[( i * 4 ) + b] * s_matrixFloatCount );
+			const float weight = m_boneWeights[( i * 4 ) + b];
+			for ( unsigned int j = 0; j < s_matrixFloatCount; ++j )
+			{
+				matrix[j] += boneMatrix[j] * weight;
+			}
+		}
+		float* const position = GetPosition( o_positions, i, i_stride );
+		for ( unsigned int c = 0; c < i_componentCount; ++c )
+		{
+			const float* const row = matrix + ( c * 4 );
+			position[c] = ( row[0] * m_positionX[i] ) + ( row[1] * m_positionY[i] ) + ( row[2] * m_positionZ[i] ) + row[3];
+		}
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Animation::SkinnedVertices::Initialize( const sSkinnedVertex* const i_vertices, const unsigned int i_vertexCount,
+	const unsigned int i_boneCount )
+{
+	EAE6320_ASSERTF( m_positionX == NULL, "Skinned vertices can't be initialized twice" );
+	EAE6320_ASSERT( i_vertices || ( i_vertexCount == 0 ) );
+
+	// The capacity is rounded up so that the SIMD kernel never needs a scalar remainder loop
+	const unsigned int paddedCount = ( i_vertexCount + 3 ) & ~3u;
+	m_positionX = AllocateAlignedArray<float>( paddedCount );
+	m_positionY = AllocateAlignedArray<float>( paddedCount );
+	m_positionZ = AllocateAlignedArray<float>( paddedCount );
+	m_boneIndices = AllocateAlignedArray<uint8_t>( paddedCount * 4 );
+	m_boneWeights = AllocateAlignedArray<float>( paddedCount * 4 );
+	if ( !m_positionX || !m_positionY || !m_positionZ || !m_boneIndices || !m_boneWeights )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Failed to allocate memory for %u skinned vertices", i_vertexCount );
+		CleanUp();
+		return false;
+	}
+	m_vertexCount = i_vertexCount;
+
+	for ( unsigned int i = 0; i < i_vertexCount; ++i )
+	{
+		const sSkinnedVertex& vertex = i_vertices[i];
+		m_positionX[i] = vertex.x;
+		m_positionY[i] = vertex.y;
+		m_positionZ[i] = vertex.z;
+		float weightSum = 0.0f;
+		for ( unsigned int b = 0; b < 4; ++b )
+		{
+			if ( vertex.boneIndices[b] >= i_boneCount )
+			{
+				EAE6320_ASSERT( false );
+				Logging::OutputError( "Skinned vertex %u uses bone %u but the skeleton only has %u bones",
+					i, vertex.boneIndices[b], i_boneCount );
+				CleanUp();
+				return false;
+			}
+			m_boneIndices[( i * 4 ) + b] = vertex.boneIndices[b];
+			const float weight = ( vertex.boneWeights[b] > 0.0f ) ? vertex.boneWeights[b] : 0.0f;
+			m_boneWeights[( i * 4 ) + b] = weight;
+			weightSum += weight;
+		}
+		// A vertex without any weight follows its first bone
+		if ( weightSum > 0.0f )
+		{
+			const float inverseWeightSum = 1.0f / weightSum;
+			for ( unsigned int b = 0; b < 4; ++b )
+			{
+				m_boneWeights[( i * 4 ) + b] *= inverseWeightSum;
+			}
+		}
+		else
+		{
+			m_boneWeights[i * 4] = 1.0f;
+		}
+	}
+	for ( unsigned int i = i_vertexCount; i < paddedCount; ++i )
+	{
+		m_boneWeights[i * 4] = 1.0f;
+	}
+
+	return true;
+}
+
+void eae6320::Animation::SkinnedVertices::CleanUp()
+{
+	FreeAlignedArray( m_positionX );
+	FreeAlignedArray( m_positionY );
+	FreeAlignedArray( m_positionZ );
+	FreeAlignedArray( m_boneIndices );
+	FreeAlignedArray( m_boneWeights );
+	m_vertexCount = 0;
+}
+
+eae6320::Animation::SkinnedVertices::SkinnedVertices()
+	:
+	m_positionX( NULL ), m_positionY( NULL ), m_positionZ( NULL ), m_boneIndices( NULL ), m_boneWeights( NULL ),
+	m_vertexCount( 0 )
+{
+
+}
+
+eae6320::Animation::SkinnedVertices::~SkinnedVertices()
+{
+	EAE6320_ASSERTF( m_positionX == NULL, "Skinned vertices were destroyed without being cleaned up" );
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	template<typename tElement>
+	tElement* AllocateAlignedArray( const unsigned int i_count )
+	{
+		const size_t alignment = 16;
+		const size_t size = sizeof( tElement ) * i_count;
+		tElement* const newArray = reinterpret_cast<tElement*>( _mm_malloc( size, alignment ) );
+		if ( newArray )
+		{
+			// The padding vertices get skinned, and so they shouldn't contain garbage
+			memset( newArray, 0, size );
+		}
+		return newArray;
+	}
+
+	template<typename tElement>
+	void FreeAlignedArray( tElement*& io_array )
+	{
+		if ( io_array )
+		{
+			_mm_free( io_array );
+			io_array = NULL;
+		}
+	}
+
+	float* GetPosition( void* const io_positions, const unsigned int i_index, const size_t i_stride )
+	{
+		return reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( io_positions ) + ( i_index * i_stride ) );
+	}
+}
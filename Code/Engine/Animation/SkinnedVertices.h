@@ -0,0 +1,99 @@
+/*
+	Skinned vertices are positions that follow up to 4 bones each
+
+	A skinned position is the weighted sum of the position transformed by each of its bones' skinning matrices
+	(the bone's current transform in the model's space times its inverse bind transform),
+	which is the same as transforming the position by the weighted sum of the matrices.
+
+	The positions are stored as a structure of arrays so that they are skinned 4 at a time with SSE:
+	each vertex's blended matrix is built from its 4 bones,
+	the 4 matrices are transposed so that each column is in a single register,
+	and then the 4 positions are transformed together.
+	The skinned positions are written to wherever the caller wants (usually a mapped vertex buffer),
+	and ranges of vertices can be skinned on different threads at the same time.
+*/
+
+#ifndef EAE6320_ANIMATION_SKINNEDVERTICES_H
+#define EAE6320_ANIMATION_SKINNEDVERTICES_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Animation
+	{
+		// This is how skinned vertices are provided
+		// (in the model's space in the skeleton's bind pose)
+		struct sSkinnedVertex
+		{
+			float x, y, z;
+			uint8_t boneIndices[4];
+			// The weights are normalized when the vertices are initialized,
+			// and a bone that doesn't influence the vertex should have a weight of 0
+			float boneWeights[4];
+		};
+
+		class SkinnedVertices
+		{
+		public:
+
+			// A range that is skinned must start at a multiple of this
+			static const unsigned int s_vertexCountPerIteration = 4;
+
+			// Skin
+			//-------
+
+			// The skinning matrices are 3x4 matrices (see CalculateMatrix() in Transform.h) for every bone.
+			// The skinned positions in [i_begin, i_end) are written to o_positions
+			// with i_stride bytes from the start of one vertex to the next,
+			// and only the first i_componentCount (2 or 3) components of each position are written.
+			// o_positions is the start of the output for vertex 0 (and not for vertex i_begin).
+			void Skin( const float* const i_skinningMatrices, const unsigned int i_begin, const unsigned int i_end,
+				void* const o_positions, const size_t i_stride, const unsigned int i_componentCount ) const;
+			// This skins one vertex at a time without SSE (and is used to check and measure Skin())
+			void Skin_scalar( const float* const i_skinningMatrices, const unsigned int i_begin, const unsigned int i_end,
+				void* const o_positions, const size_t i_stride, const unsigned int i_componentCount ) const;
+
+			// Access
+			//-------
+
+			unsigned int GetVertexCount() const { return m_vertexCount; }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// Every bone index must be less than i_boneCount
+			bool Initialize( const sSkinnedVertex* const i_vertices, const unsigned int i_vertexCount, const unsigned int i_boneCount );
+			void CleanUp();
+
+			SkinnedVertices();
+			~SkinnedVertices();
+
+			// Data
+			//=====
+
+		private:
+
+			// Structure of arrays
+			// (every array is 16-byte aligned and has room for a multiple of 4 vertices,
+			// and the padding vertices are at the origin and fully weighted to bone 0)
+			float* m_positionX;
+			float* m_positionY;
+			float* m_positionZ;
+			// These are 4 per vertex
+			uint8_t* m_boneIndices;
+			float* m_boneWeights;
+
+			unsigned int m_vertexCount;
+		};
+	}
+}
+
+#endif	// EAE6320_ANIMATION_SKINNEDVERTICES_H
@@ -0,0 +1,143 @@
+// Header Files
+//=============
+
+#include "Transform.h"
+
+#include <cmath>
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// o_vector can be the same as i_vector
+	void Rotate( const float i_rotation[4], const float i_vector[3], float o_vector[3] );
+}
+
+// Interface
+//==========
+
+void eae6320::Animation::SetIdentity( sTransform& o_transform )
+{
+	o_transform.rotation[0] = o_transform.rotation[1] = o_transform.rotation[2] = 0.0f;
+	o_transform.rotation[3] = 1.0f;
+	o_transform.translation[0] = o_transform.translation[1] = o_transform.translation[2] = 0.0f;
+}
+
+void eae6320::Animation::SetRotationZ( const float i_radians, const float i_translationX, const float i_translationY, sTransform& o_transform )
+{
+	const float halfAngle = i_radians * 0.5f;
+	o_transform.rotation[0] = o_transform.rotation[1] = 0.0f;
+	o_transform.rotation[2] = std::sin( halfAngle );
+	o_transform.rotation[3] = std::cos( halfAngle );
+	o_transform.translation[0] = i_translationX;
+	o_transform.translation[1] = i_translationY;
+	o_transform.translation[2] = 0.0f;
+}
+
+void eae6320::Animation::Multiply( const sTransform& i_parent, const sTransform& i_child, sTransform& o_transform )
+{
+	const float* const a = i_parent.rotation;
+	const float* const b = i_child.rotation;
+	o_transform.rotation[0] = ( a[3] * b[0] ) + ( a[0] * b[3] ) + ( a[1] * b[2] ) - ( a[2] * b[1] );
+	o_transform.rotation[1] = ( a[3] * b[1] ) - ( a[0] * b[2] ) + ( a[1] * b[3] ) + ( a[2] * b[0] );
+	o_transform.rotation[2] = ( a[3] * b[2] ) + ( a[0] * b[1] ) - ( a[1] * b[0] ) + ( a[2] * b[3] );
+	o_transform.rotation[3] = ( a[3] * b[3] ) - ( a[0] * b[0] ) - ( a[1] * b[1] ) - ( a[2] * b[2] );
+	Rotate( i_parent.rotation, i_child.translation, o_transform.translation );
+	for ( unsigned int i = 0; i < 3; ++i )
+	{
+		o_transform.translation[i] += i_parent.translation[i];
+	}
+}
+
+void eae6320::Animation::Invert( const sTransform& i_transform, sTransform& o_transform )
+{
+	// The inverse of a unit quaternion is its conjugate
+	o_transform.rotation[0] = -i_transform.rotation[0];
+	o_transform.rotation[1] = -i_transform.rotation[1];
+	o_transform.rotation[2] = -i_transform.rotation[2];
+	o_transform.rotation[3] = i_transform.rotation[3];
+	Rotate( o_transform.rotation, i_transform.translation, o_transform.translation );
+	for ( unsigned int i = 0; i < 3; ++i )
+	{
+		o_transform.translation[i] = -o_transform.translation[i];
+	}
+}
+
+void eae6320::Animation::Blend( const sTransform& i_a, const sTransform& i_b, const float i_t, sTransform& o_transform )
+{
+	BlendRotations( i_a.rotation, i_b.rotation, i_t, o_transform.rotation );
+	for ( unsigned int i = 0; i < 3; ++i )
+	{
+		o_transform.translation[i] = i_a.translation[i] + ( ( i_b.translation[i] - i_a.translation[i] ) * i_t );
+	}
+}
+
+void eae6320::Animation::BlendRotations( const float i_a[4], const float i_b[4], const float i_t, float o_rotation[4] )
+{
+	// q and -q are the same rotation,
+	// and so b is negated if that makes it closer to a (otherwise the blend would take the long way around)
+	float dot = 0.0f;
+	for ( unsigned int i = 0; i < 4; ++i )
+	{
+		dot += i_a[i] * i_b[i];
+	}
+	const float weightB = ( dot < 0.0f ) ? -i_t : i_t;
+	const float weightA = 1.0f - i_t;
+	float lengthSquared = 0.0f;
+	for ( unsigned int i = 0; i < 4; ++i )
+	{
+		const float component = ( i_a[i] * weightA ) + ( i_b[i] * weightB );
+		o_rotation[i] = component;
+		lengthSquared += component * component;
+	}
+	{
+		const float inverseLength = ( lengthSquared > 0.0f ) ? ( 1.0f / std::sqrt( lengthSquared ) ) : 0.0f;
+		for ( unsigned int i = 0; i < 4; ++i )
+		{
+			o_rotation[i] *= inverseLength;
+		}
+	}
+}
+
+void eae6320::Animation::CalculateMatrix( const sTransform& i_transform, float o_matrix[s_matrixFloatCount] )
+{
+	const float x = i_transform.rotation[0], y = i_transform.rotation[1], z = i_transform.rotation[2], w = i_transform.rotation[3];
+	const float xx = x * x, yy = y * y, zz = z * z;
+	const float xy = x * y, xz = x * z, yz = y * z;
+	const float wx = w * x, wy = w * y, wz = w * z;
+
+	o_matrix[0] = 1.0f - ( 2.0f * ( yy + zz ) );
+	o_matrix[1] = 2.0f * ( xy - wz );
+	o_matrix[2] = 2.0f * ( xz + wy );
+	o_matrix[3] = i_transform.translation[0];
+
+	o_matrix[4] = 2.0f * ( xy + wz );
+	o_matrix[5] = 1.0f - ( 2.0f * ( xx + zz ) );
+	o_matrix[6] = 2.0f * ( yz - wx );
+	o_matrix[7] = i_transform.translation[1];
+
+	o_matrix[8] = 2.0f * ( xz - wy );
+	o_matrix[9] = 2.0f * ( yz + wx );
+	o_matrix[10] = 1.0f - ( 2.0f * ( xx + yy ) );
+	o_matrix[11] = i_transform.translation[2];
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void Rotate( const float i_rotation[4], const float i_vector[3], float o_vector[3] )
+	{
+		// v' = v + 2w( q x v ) + 2( q x ( q x v ) ), where q is the vector part of the rotation
+		const float qx = i_rotation[0], qy = i_rotation[1], qz = i_rotation[2], w = i_rotation[3];
+		const float vx = i_vector[0], vy = i_vector[1], vz = i_vector[2];
+		const float tx = 2.0f * ( ( qy * vz ) - ( qz * vy ) );
+		const float ty = 2.0f * ( ( qz * vx ) - ( qx * vz ) );
+		const float tz = 2.0f * ( ( qx * vy ) - ( qy * vx ) );
+		o_vector[0] = vx + ( w * tx ) + ( ( qy * tz ) - ( qz * ty ) );
+		o_vector[1] = vy + ( w * ty ) + ( ( qz * tx ) - ( qx * tz ) );
+		o_vector[2] = vz + ( w * tz ) + ( ( qx * ty ) - ( qy * tx ) );
+	}
+}
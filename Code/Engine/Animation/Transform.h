@@ -0,0 +1,52 @@
+/*
+	A transform is a rotation followed by a translation
+
+	Bones don't have scale, and so a transform is always rigid
+	(which means that inverting one is cheap).
+	Rotations are unit quaternions stored as (x, y, z, w).
+*/
+
+#ifndef EAE6320_ANIMATION_TRANSFORM_H
+#define EAE6320_ANIMATION_TRANSFORM_H
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Animation
+	{
+		struct sTransform
+		{
+			float rotation[4];
+			float translation[3];
+		};
+
+		// A 3x4 matrix has the rotation in its first three columns and the translation in its last column,
+		// and so a point p is transformed by dot( row, ( p.x, p.y, p.z, 1 ) ) for each row.
+		// The rows are stored one after another (12 floats).
+		const unsigned int s_matrixFloatCount = 12;
+
+		// This is a transform that doesn't do anything
+		void SetIdentity( sTransform& o_transform );
+		// This returns a transform that rotates around the z axis
+		// (which is the only axis that the 2D renderer can show)
+		void SetRotationZ( const float i_radians, const float i_translationX, const float i_translationY, sTransform& o_transform );
+
+		// o_transform = i_parent * i_child (the child is applied first).
+		// o_transform can't be either of the inputs.
+		void Multiply( const sTransform& i_parent, const sTransform& i_child, sTransform& o_transform );
+		void Invert( const sTransform& i_transform, sTransform& o_transform );
+
+		// The rotations are normalized after they are interpolated linearly (nlerp),
+		// which is cheaper than a spherical interpolation and close enough for neighboring keys and pose blends.
+		// i_t of 0 returns i_a and 1 returns i_b.
+		void Blend( const sTransform& i_a, const sTransform& i_b, const float i_t, sTransform& o_transform );
+		// This blends only the rotations (for tracks whose rotations and translations are keyed separately)
+		void BlendRotations( const float i_a[4], const float i_b[4], const float i_t, float o_rotation[4] );
+
+		void CalculateMatrix( const sTransform& i_transform, float o_matrix[s_matrixFloatCount] );
+	}
+}
+
+#endif	// EAE6320_ANIMATION_TRANSFORM_H
@@ -0,0 +1,162 @@
+// Header Files
+//=============
+
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// These are the same names that the user settings use
+	const char* const s_presentModeNames[eae6320::Graphics::ePresentMode::Count] =
+	{
+		"uncapped",
+		"vsync",
+		"targetFrameRate",
+		"lowLatency",
+	};
+}
+
+// Interface
+//==========
+
+// Run
+//----
+
+void eae6320::Application::FramePacer::WaitForNextFrame()
+{
+	if ( m_presentMode == Graphics::ePresentMode::TargetFrameRate )
+	{
+		Time::WaitUntil( m_tickCount_nextFrame );
+		// The next frame is scheduled from when this one should have started so that small delays don't accumulate,
+		// but if this one started more than a whole frame late the schedule starts over
+		const uint64_t tickCount_current = Time::GetCurrentSystemTimeTickCount();
+		m_tickCount_nextFrame = ( ( tickCount_current - m_tickCount_nextFrame ) < m_tickCountPerFrame_target )
+			? ( m_tickCount_nextFrame + m_tickCountPerFrame_target )
+			: ( tickCount_current + m_tickCountPerFrame_target );
+	}
+	m_tickCount_frameStart = Time::GetCurrentSystemTimeTickCount();
+}
+
+void eae6320::Application::FramePacer::OnFramePresented()
+{
+	const uint64_t tickCount_presented = Time::GetCurrentSystemTimeTickCount();
+	// The first frame doesn't have a previous frame to measure from
+	if ( m_tickCount_previousFrameStart != 0 )
+	{
+		const double frameTime = Time::ConvertTicksToSeconds( m_tickCount_frameStart - m_tickCount_previousFrameStart );
+		m_frameTimeSum += frameTime;
+		m_frameTimeSquaredSum += frameTime * frameTime;
+		m_presentTimeSum += Time::ConvertTicksToSeconds( tickCount_presented - m_tickCount_frameStart );
+		++m_frameCount;
+		if ( m_frameCount >= s_framesPerLog )
+		{
+			LogStatistics();
+			ResetStatistics();
+		}
+	}
+	m_tickCount_previousFrameStart = m_tickCount_frameStart;
+}
+
+// Settings
+//---------
+
+bool eae6320::Application::FramePacer::SetPresentMode( const Graphics::ePresentMode::ePresentMode i_presentMode )
+{
+	if ( !Graphics::SetPresentMode( i_presentMode ) )
+	{
+		return false;
+	}
+	m_presentMode = i_presentMode;
+	m_tickCount_nextFrame = Time::GetCurrentSystemTimeTickCount();
+	ResetStatistics();
+	// The frame that is in progress was started in the previous mode
+	m_tickCount_previousFrameStart = 0;
+	Logging::OutputMessage( "Frames will be paced with the \"%s\" present mode", GetPresentModeName( m_presentMode ) );
+	return true;
+}
+
+void eae6320::Application::FramePacer::SetTargetFrameRate( const unsigned int i_targetFrameRate )
+{
+	EAE6320_ASSERT( i_targetFrameRate > 0 );
+	m_tickCountPerFrame_target = Time::ConvertSecondsToTicks( 1.0 / static_cast<double>( i_targetFrameRate ) );
+}
+
+const char* eae6320::Application::FramePacer::GetPresentModeName( const Graphics::ePresentMode::ePresentMode i_presentMode )
+{
+	EAE6320_ASSERT( i_presentMode < Graphics::ePresentMode::Count );
+	return s_presentModeNames[i_presentMode];
+}
+
+bool eae6320::Application::FramePacer::GetPresentModeFromName( const char* const i_name,
+	Graphics::ePresentMode::ePresentMode& o_presentMode )
+{
+	for ( unsigned int i = 0; i < Graphics::ePresentMode::Count; ++i )
+	{
+		if ( std::strcmp( i_name, s_presentModeNames[i] ) == 0 )
+		{
+			o_presentMode = static_cast<Graphics::ePresentMode::ePresentMode>( i );
+			return true;
+		}
+	}
+	return false;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+void eae6320::Application::FramePacer::Initialize( const Graphics::ePresentMode::ePresentMode i_presentMode,
+	const unsigned int i_targetFrameRate )
+{
+	m_presentMode = i_presentMode;
+	SetTargetFrameRate( i_targetFrameRate );
+	m_tickCount_nextFrame = Time::GetCurrentSystemTimeTickCount();
+	m_tickCount_previousFrameStart = 0;
+	ResetStatistics();
+	Logging::OutputMessage( "Frames will be paced with the \"%s\" present mode", GetPresentModeName( m_presentMode ) );
+}
+
+eae6320::Application::FramePacer::FramePacer()
+	:
+	m_presentMode( Graphics::ePresentMode::VSync ),
+	m_tickCountPerFrame_target( 0 ),
+	m_tickCount_nextFrame( 0 ), m_tickCount_frameStart( 0 ),
+	m_tickCount_previousFrameStart( 0 ),
+	m_frameTimeSum( 0.0 ), m_frameTimeSquaredSum( 0.0 ), m_presentTimeSum( 0.0 ),
+	m_frameCount( 0 )
+{
+
+}
+
+// Implementation
+//===============
+
+void eae6320::Application::FramePacer::ResetStatistics()
+{
+	m_frameTimeSum = m_frameTimeSquaredSum = m_presentTimeSum = 0.0;
+	m_frameCount = 0;
+}
+
+void eae6320::Application::FramePacer::LogStatistics() const
+{
+	const double frameCount = static_cast<double>( m_frameCount );
+	const double frameTime_mean = m_frameTimeSum / frameCount;
+	// Rounding can make a tiny variance negative
+	const double frameTime_variance = std::max( ( m_frameTimeSquaredSum / frameCount ) - ( frameTime_mean * frameTime_mean ), 0.0 );
+	const double presentTime_mean = m_presentTimeSum / frameCount;
+	const bool isVSynced = ( m_presentMode == Graphics::ePresentMode::VSync ) || ( m_presentMode == Graphics::ePresentMode::LowLatency );
+	const unsigned int queuedFrameCount = isVSynced ? Graphics::GetMaxQueuedFrameCount() : 1;
+	const double latency_estimated = presentTime_mean + ( static_cast<double>( queuedFrameCount ) * frameTime_mean );
+	Logging::OutputMessage( "Frame pacing (\"%s\"): %u frames took %.2f ms on average"
+		" with a variance of %.4f ms^2 (a standard deviation of %.2f ms), and the estimated latency is %.1f ms",
+		GetPresentModeName( m_presentMode ), m_frameCount, frameTime_mean * 1000.0,
+		frameTime_variance * 1000.0 * 1000.0, std::sqrt( frameTime_variance ) * 1000.0, latency_estimated * 1000.0 );
+}
@@ -0,0 +1,97 @@
+/*
+	The frame pacer decides when the application starts each frame
+	and measures how evenly the frames are paced
+
+	The graphics system's present mode decides whether presenting waits for the display
+	and how many frames can be queued;
+	the frame pacer additionally waits before each frame in the target frame rate mode
+	(by sleeping for most of the wait and spinning for the rest so that frames start on time).
+
+	Every few hundred frames it logs the mean and variance of the frame time
+	and an estimate of the input-to-photon latency:
+	The time from the start of a frame (when input would be read) until it has been presented,
+	plus a frame for every frame that can be queued ahead of it
+	(with vsync the GPU is the bottleneck and the queue fills up, and otherwise the GPU is usually only a single frame behind).
+*/
+
+#ifndef EAE6320_APPLICATION_FRAMEPACER_H
+#define EAE6320_APPLICATION_FRAMEPACER_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+#include "../Graphics/Graphics.h"
+
+// Class Declaration
+//==================
+
+namespace eae6320
+{
+	namespace Application
+	{
+		class FramePacer
+		{
+			// Interface
+			//==========
+
+		public:
+
+			// Run
+			//----
+
+			// This is called before a new frame starts
+			void WaitForNextFrame();
+			// This is called after the frame has been presented
+			void OnFramePresented();
+
+			// Settings
+			//---------
+
+			// This changes the graphics system's present mode and restarts the statistics
+			bool SetPresentMode( const Graphics::ePresentMode::ePresentMode i_presentMode );
+			void SetTargetFrameRate( const unsigned int i_targetFrameRate );
+
+			static const char* GetPresentModeName( const Graphics::ePresentMode::ePresentMode i_presentMode );
+			// This returns false if the name isn't a present mode
+			static bool GetPresentModeFromName( const char* const i_name, Graphics::ePresentMode::ePresentMode& o_presentMode );
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The graphics system must have already been initialized with the same present mode
+			void Initialize( const Graphics::ePresentMode::ePresentMode i_presentMode, const unsigned int i_targetFrameRate );
+
+			FramePacer();
+
+			// Implementation
+			//===============
+
+		private:
+
+			void ResetStatistics();
+			void LogStatistics() const;
+
+			// Data
+			//=====
+
+		private:
+
+			Graphics::ePresentMode::ePresentMode m_presentMode;
+			uint64_t m_tickCountPerFrame_target;
+			// When the limiter will let the next frame start
+			uint64_t m_tickCount_nextFrame;
+			uint64_t m_tickCount_frameStart;
+
+			// Statistics
+			uint64_t m_tickCount_previousFrameStart;
+			double m_frameTimeSum;
+			double m_frameTimeSquaredSum;
+			double m_presentTimeSum;
+			unsigned int m_frameCount;
+			static const unsigned int s_framesPerLog = 300;
+		};
+	}
+}
+
+#endif	// EAE6320_APPLICATION_FRAMEPACER_H
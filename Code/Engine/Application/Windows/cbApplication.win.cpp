@@ -317,6 +317,17 @@ bool eae6320::Application::cbApplication::PopulateGraphicsInitializationParamete
 #elif defined( EAE6320_PLATFORM_GL )
 	o_initializationParameters.thisInstanceOfTheApplication = m_thisInstanceOfTheApplication;
 #endif
+	o_initializationParameters.textureStreamerSettings.budgetInBytes =
+		static_cast<size_t>( UserSettings::GetTextureBudgetInMegabytes() ) * 1024 * 1024;
+	o_initializationParameters.dynamicResolutionSettings.targetFrameTime = 1.0f / static_cast<float>( UserSettings::GetTargetFrameRate() );
+	o_initializationParameters.dynamicResolutionSettings.minScale = UserSettings::GetMinResolutionScale();
+	if ( !FramePacer::GetPresentModeFromName( UserSettings::GetPresentMode(), o_initializationParameters.presentMode ) )
+	{
+		o_initializationParameters.presentMode = Graphics::ePresentMode::VSync;
+		Logging::OutputError( "\"%s\" isn't a present mode. Using \"%s\" instead",
+			UserSettings::GetPresentMode(), FramePacer::GetPresentModeName( o_initializationParameters.presentMode ) );
+	}
+	o_initializationParameters.statisticsLogPeriodInFrames = UserSettings::GetStatisticsLogPeriodInFrames();
 	return true;
 }
 
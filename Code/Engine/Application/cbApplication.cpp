@@ -6,9 +6,16 @@
 #include <cstdlib>
 #include "../Asserts/Asserts.h"
 #include "../Graphics/Graphics.h"
+#include "../Jobs/Jobs.h"
 #include "../Logging/Logging.h"
+#include "../Math/Batch.h"
+#include "../Math/Configuration.h"
+#include "../Scene/BoundingVolumeHierarchy.h"
+#include "../Scene/Configuration.h"
+#include "../Scene/TransformHierarchy.h"
 #include "../Time/Time.h"
 #include "../UserOutput/UserOutput.h"
+#include "../UserSettings/UserSettings.h"
 
 // Interface
 //==========
@@ -115,6 +122,21 @@ bool eae6320::Application::cbApplication::Initialize_engine()
 		EAE6320_ASSERT( false );
 		return false;
 	}
+	// Jobs
+	if ( !Jobs::Initialize() )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+#ifdef EAE6320_MATH_SHOULDSIMDBEMEASURED
+	Math::LogBatchCost();
+#endif
+#ifdef EAE6320_SCENE_SHOULDTRANSFORMUPDATESBEMEASURED
+	Scene::TransformHierarchy::LogUpdateCost();
+#endif
+#ifdef EAE6320_SCENE_SHOULDBVHQUERIESBEMEASURED
+	Scene::BoundingVolumeHierarchy::LogQueryCost();
+#endif
 	// Graphics
 	{
 		Graphics::sInitializationParameters initializationParameters;
@@ -125,6 +147,7 @@ bool eae6320::Application::cbApplication::Initialize_engine()
 				EAE6320_ASSERT( false );
 				return false;
 			}
+			m_framePacer.Initialize( initializationParameters.presentMode, UserSettings::GetTargetFrameRate() );
 		}
 		else
 		{
@@ -178,6 +201,12 @@ bool eae6320::Application::cbApplication::CleanUp_engine()
 		wereThereErrors = true;
 		EAE6320_ASSERT( false );
 	}
+	// Jobs
+	if ( !Jobs::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
 	// Time
 	if ( !Time::CleanUp() )
 	{
@@ -207,7 +236,9 @@ eae6320::Application::cbApplication::~cbApplication()
 
 void eae6320::Application::cbApplication::OnNewFrame()
 {
+	m_framePacer.WaitForNextFrame();
 	Time::OnNewFrame();
 	Update();
 	Graphics::RenderFrame();
+	m_framePacer.OnFramePresented();
 }
@@ -11,6 +11,8 @@
 // Header Files
 //=============
 
+#include "FramePacer.h"
+
 #if defined( EAE6320_PLATFORM_WINDOWS )
 	#include "../Windows/Includes.h"
 #endif
@@ -96,6 +98,11 @@ namespace eae6320
 
 			bool GetResolution( unsigned int& o_width, unsigned int& o_height ) const;
 
+			// Frame Pacing
+			//-------------
+
+			FramePacer& GetFramePacer() { return m_framePacer; }
+
 			// Initialization / Clean Up
 			//--------------------------
 
@@ -148,6 +155,13 @@ namespace eae6320
 				bool CleanUp_base();	// This cleans up just this base class
 				bool CleanUp_engine();	// This cleans up all of the engine systems
 
+			// Data
+			//=====
+
+		private:
+
+			FramePacer m_framePacer;
+
 			// #include the platform-specific class declarations
 #if defined( EAE6320_PLATFORM_WINDOWS )
 			#include "Windows/cbApplication.win.h"
@@ -0,0 +1,271 @@
+// Header Files
+//=============
+
+#include "AssetLoader.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Texture.h"
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+#include "../Windows/Includes.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	struct sLoadRequest
+	{
+		eae6320::Graphics::Texture* texture;
+		std::string path;
+		// Errors can't be output on the I/O thread,
+		// and so they are output when the render thread completes the request
+		std::string errorMessage;
+		uint64_t tickCount_requested;
+		bool shouldBeStreamed;
+		bool wasReadSuccessful;
+		// This is set by the I/O thread once the file has been read
+		volatile LONG isReadComplete;
+	};
+
+	eae6320::Graphics::AssetLoader::sSettings s_settings;
+	eae6320::Graphics::AssetLoader::sStats s_stats = { 0 };
+	// These are in the order that they were requested
+	std::vector<sLoadRequest*> s_requests;
+	eae6320::Graphics::Texture* s_placeholderTexture = NULL;
+	double s_totalLatencyInSeconds = 0.0;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void CompleteRequest( sLoadRequest& io_request );
+	void ReadFile( void* const io_request );
+	void WaitForReadRequest( sLoadRequest& io_request );
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::AssetLoader::Update()
+{
+	const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+	const uint64_t tickCount_budget = Time::ConvertSecondsToTicks( s_settings.budgetPerFrameInSeconds );
+	uint64_t tickCount_current = tickCount_start;
+	s_stats.createdCount = 0;
+
+	// Create the GPU resources of requests whose files have been read
+	// (the I/O threads can finish reads in any order, and so a request that is still being read is skipped)
+	bool hasBudgetBeenUsed = false;
+	for ( std::vector<sLoadRequest*>::iterator i = s_requests.begin(); i != s_requests.end(); )
+	{
+		sLoadRequest* const request = *i;
+		if ( request->isReadComplete == 0 )
+		{
+			++i;
+			continue;
+		}
+		// At least one request is completed every frame
+		if ( hasBudgetBeenUsed && ( ( tickCount_current - tickCount_start ) >= tickCount_budget ) )
+		{
+			break;
+		}
+		CompleteRequest( *request );
+		hasBudgetBeenUsed = true;
+		tickCount_current = Time::GetCurrentSystemTimeTickCount();
+		delete request;
+		i = s_requests.erase( i );
+	}
+
+	// Update the stats
+	{
+		s_stats.secondCountCreating = Time::ConvertTicksToSeconds( tickCount_current - tickCount_start );
+		s_stats.budgetInSeconds = s_settings.budgetPerFrameInSeconds;
+		s_stats.readingCount = s_stats.waitingCount = 0;
+		for ( std::vector<sLoadRequest*>::const_iterator i = s_requests.begin(); i != s_requests.end(); ++i )
+		{
+			if ( ( *i )->isReadComplete != 0 )
+			{
+				++s_stats.waitingCount;
+			}
+			else
+			{
+				++s_stats.readingCount;
+			}
+		}
+	}
+}
+
+// Access
+//-------
+
+const eae6320::Graphics::AssetLoader::sSettings& eae6320::Graphics::AssetLoader::GetSettings()
+{
+	return s_settings;
+}
+
+const eae6320::Graphics::AssetLoader::sStats& eae6320::Graphics::AssetLoader::GetStats()
+{
+	return s_stats;
+}
+
+const eae6320::Graphics::Texture& eae6320::Graphics::AssetLoader::GetPlaceholderTexture()
+{
+	EAE6320_ASSERTF( s_placeholderTexture, "The asset loader hasn't been initialized" );
+	return *s_placeholderTexture;
+}
+
+// Textures
+//---------
+
+void eae6320::Graphics::AssetLoader::LoadTexture( Texture& io_texture, const char* const i_path, const bool i_shouldBeStreamed )
+{
+	EAE6320_ASSERT( i_path != NULL );
+	EAE6320_ASSERTF( !io_texture.IsLoaded(), "A texture can only be loaded once" );
+
+	sLoadRequest* const request = new sLoadRequest;
+	{
+		request->texture = &io_texture;
+		request->path = i_path;
+		request->tickCount_requested = Time::GetCurrentSystemTimeTickCount();
+		request->shouldBeStreamed = i_shouldBeStreamed;
+		request->wasReadSuccessful = false;
+		request->isReadComplete = 0;
+	}
+	s_requests.push_back( request );
+	Jobs::SubmitIoJob( ReadFile, request );
+}
+
+bool eae6320::Graphics::AssetLoader::CancelLoad( Texture& io_texture )
+{
+	for ( std::vector<sLoadRequest*>::iterator i = s_requests.begin(); i != s_requests.end(); ++i )
+	{
+		sLoadRequest* const request = *i;
+		if ( request->texture == &io_texture )
+		{
+			// The texture's file is mapped while it is being read,
+			// and so the read must finish before the texture can unmap it
+			WaitForReadRequest( *request );
+			delete request;
+			s_requests.erase( i );
+			return true;
+		}
+	}
+	return false;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::AssetLoader::Initialize( const sSettings& i_settings )
+{
+	s_settings = i_settings;
+	memset( &s_stats, 0, sizeof( s_stats ) );
+	s_stats.budgetInSeconds = s_settings.budgetPerFrameInSeconds;
+	s_totalLatencyInSeconds = 0.0;
+
+	// The placeholders are loaded synchronously since everything else depends on them
+	s_placeholderTexture = new Texture();
+	if ( !s_placeholderTexture->Load( "data/placeholder.texture" ) )
+	{
+		delete s_placeholderTexture;
+		s_placeholderTexture = NULL;
+		return false;
+	}
+
+	Logging::OutputMessage( "Initialized the asset loader with a budget of %.2f ms per frame",
+		s_settings.budgetPerFrameInSeconds * 1000.0 );
+	return true;
+}
+
+bool eae6320::Graphics::AssetLoader::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	// Every texture that was loaded asynchronously should have been cleaned up before the loader
+	EAE6320_ASSERTF( s_requests.empty(), "%u asynchronous loads weren't cleaned up", static_cast<unsigned int>( s_requests.size() ) );
+	while ( !s_requests.empty() )
+	{
+		// Cleaning the texture up cancels its load
+		if ( !s_requests.back()->texture->CleanUp() )
+		{
+			wereThereErrors = true;
+		}
+	}
+	if ( s_placeholderTexture )
+	{
+		if ( !s_placeholderTexture->CleanUp() )
+		{
+			wereThereErrors = true;
+		}
+		delete s_placeholderTexture;
+		s_placeholderTexture = NULL;
+	}
+
+	Logging::OutputMessage( "The asset loader loaded %u assets asynchronously (%u failed)"
+		" with an average latency of %.3f ms and a maximum latency of %.3f ms",
+		s_stats.loadedCount, s_stats.failedCount,
+		s_stats.averageLatencyInSeconds * 1000.0, s_stats.maxLatencyInSeconds * 1000.0 );
+
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void CompleteRequest( sLoadRequest& io_request )
+	{
+		if ( !io_request.wasReadSuccessful )
+		{
+			EAE6320_ASSERTF( false, io_request.errorMessage.c_str() );
+			eae6320::Logging::OutputError( "%s", io_request.errorMessage.c_str() );
+			++s_stats.failedCount;
+			return;
+		}
+		if ( !io_request.texture->CreateGpuTextureFromFile( io_request.path.c_str() ) )
+		{
+			++s_stats.failedCount;
+			return;
+		}
+
+		const double latency = eae6320::Time::ConvertTicksToSeconds(
+			eae6320::Time::GetCurrentSystemTimeTickCount() - io_request.tickCount_requested );
+		io_request.texture->SetSecondCountToLoad( latency );
+		++s_stats.createdCount;
+		++s_stats.loadedCount;
+		s_totalLatencyInSeconds += latency;
+		s_stats.averageLatencyInSeconds = s_totalLatencyInSeconds / static_cast<double>( s_stats.loadedCount );
+		s_stats.maxLatencyInSeconds = ( latency > s_stats.maxLatencyInSeconds ) ? latency : s_stats.maxLatencyInSeconds;
+		const eae6320::Graphics::Texture& texture = *io_request.texture;
+		eae6320::Logging::OutputMessage( "Loaded the texture %s asynchronously (%ux%u, %u mips, %u resident) %.3f ms after it was requested",
+			io_request.path.c_str(), texture.GetWidth(), texture.GetHeight(), texture.GetMipCount(),
+			texture.GetMipCount() - texture.GetFirstResidentMip(), latency * 1000.0 );
+	}
+
+	void ReadFile( void* const io_request )
+	{
+		sLoadRequest& request = *reinterpret_cast<sLoadRequest*>( io_request );
+		request.wasReadSuccessful = request.texture->ReadFile( request.path.c_str(), request.shouldBeStreamed, request.errorMessage );
+		// The exchange is a full memory barrier, and so the results will be visible to the render thread
+		InterlockedExchange( &request.isReadComplete, 1 );
+	}
+
+	void WaitForReadRequest( sLoadRequest& io_request )
+	{
+		while ( io_request.isReadComplete == 0 )
+		{
+			SwitchToThread();
+		}
+	}
+}
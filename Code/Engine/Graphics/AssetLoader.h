@@ -0,0 +1,99 @@
+/*
+	The asset loader reads files on the I/O threads and creates their GPU resources on the render thread
+
+	Loading an asset asynchronously returns immediately and the asset can be used straight away;
+	until it has finished loading a placeholder is used in its place.
+	Every frame the render thread creates the GPU resources of the assets whose files have been read
+	(in the order that they were requested) until the frame's time budget has been used up,
+	and so a burst of loads is spread across several frames instead of causing a hitch.
+	At least one asset is created every frame
+	so that an asset that takes longer than the whole budget can't block the ones behind it.
+
+	Textures are the only assets that can be loaded this way so far.
+*/
+
+#ifndef EAE6320_GRAPHICS_ASSETLOADER_H
+#define EAE6320_GRAPHICS_ASSETLOADER_H
+
+// Forward Declarations
+//=====================
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Texture;
+	}
+}
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace AssetLoader
+		{
+			struct sSettings
+			{
+				// How long the render thread may spend creating GPU resources every frame
+				double budgetPerFrameInSeconds;
+
+				sSettings() : budgetPerFrameInSeconds( 2.0e-3 ) {}
+			};
+
+			// These describe the loader after the most recent call to Update()
+			struct sStats
+			{
+				// Loads whose files are being read (or are waiting for an I/O thread)
+				unsigned int readingCount;
+				// Loads whose files have been read and that are waiting for the render thread
+				unsigned int waitingCount;
+
+				// These only count what happened during the most recent call to Update()
+				unsigned int createdCount;
+				double secondCountCreating;
+				double budgetInSeconds;
+
+				// These count every load that has finished.
+				// The latency of a load is from when it was requested until its GPU resource was created.
+				unsigned int loadedCount;
+				unsigned int failedCount;
+				double averageLatencyInSeconds;
+				double maxLatencyInSeconds;
+			};
+
+			// Render
+			//-------
+
+			// This must be called once every frame from the render thread
+			void Update();
+
+			// Access
+			//-------
+
+			const sSettings& GetSettings();
+			const sStats& GetStats();
+			// This is bound in place of any texture that hasn't finished loading
+			const Texture& GetPlaceholderTexture();
+
+			// Textures
+			//---------
+
+			// These are called by Texture
+			void LoadTexture( Texture& io_texture, const char* const i_path, const bool i_shouldBeStreamed );
+			// If the texture's file is still being read this waits for it to finish.
+			// This returns true if the texture was still being loaded.
+			bool CancelLoad( Texture& io_texture );
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Initialize( const sSettings& i_settings );
+			bool CleanUp();
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_ASSETLOADER_H
@@ -0,0 +1,165 @@
+// Header Files
+//=============
+
+#include "Atlas.h"
+
+#include <string>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Interface
+//==========
+
+// Access
+//-------
+
+const eae6320::Graphics::AtlasFormats::sEntry* eae6320::Graphics::Atlas::Find( const char* const i_name ) const
+{
+	return Find( AtlasFormats::CalculateNameHash( i_name ) );
+}
+
+const eae6320::Graphics::AtlasFormats::sEntry* eae6320::Graphics::Atlas::Find( const uint32_t i_nameHash ) const
+{
+	// The entries were sorted by hash when the atlas was built
+	unsigned int begin = 0, end = m_entryCount;
+	while ( begin < end )
+	{
+		const unsigned int middle = begin + ( ( end - begin ) / 2 );
+		const uint32_t nameHash = m_entries[middle].nameHash;
+		if ( nameHash < i_nameHash )
+		{
+			begin = middle + 1;
+		}
+		else if ( nameHash > i_nameHash )
+		{
+			end = middle;
+		}
+		else
+		{
+			return m_entries + middle;
+		}
+	}
+	return NULL;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::Atlas::Load( const char* const i_path )
+{
+	bool wereThereErrors = false;
+
+	// An atlas can only be loaded once
+	EAE6320_ASSERT( m_entries == NULL );
+
+	{
+		std::string errorMessage;
+		if ( !Platform::MapBinaryFile( i_path, m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to map the atlas %s: %s", i_path, errorMessage.c_str() );
+			goto OnExit;
+		}
+	}
+	// Validate the file
+	{
+		const uint8_t* const fileData = reinterpret_cast<const uint8_t*>( m_file.data );
+		const AtlasFormats::sHeader* const header = reinterpret_cast<const AtlasFormats::sHeader*>( fileData );
+		if ( ( m_file.size < sizeof( AtlasFormats::sHeader ) )
+			|| ( header->fourCc != AtlasFormats::s_fourCc ) || ( header->version != AtlasFormats::s_version ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Invalid atlas file" );
+			Logging::OutputError( "The atlas %s isn't a built atlas (or was built by a different version of the TextureBuilder)", i_path );
+			goto OnExit;
+		}
+		if ( m_file.size < ( sizeof( AtlasFormats::sHeader ) + ( static_cast<size_t>( header->entryCount ) * sizeof( AtlasFormats::sEntry ) ) ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Truncated atlas file" );
+			Logging::OutputError( "The atlas %s is shorter than its header says it should be", i_path );
+			goto OnExit;
+		}
+		m_entries = reinterpret_cast<const AtlasFormats::sEntry*>( fileData + sizeof( AtlasFormats::sHeader ) );
+		m_entryCount = header->entryCount;
+	}
+	// Load the texture
+	{
+		std::string path_texture( i_path );
+		{
+			const size_t extension = path_texture.find_last_of( '.' );
+			const size_t slash = path_texture.find_last_of( "/\\" );
+			if ( ( extension != std::string::npos ) && ( ( slash == std::string::npos ) || ( extension > slash ) ) )
+			{
+				path_texture.resize( extension );
+			}
+			path_texture += ".texture";
+		}
+		if ( !m_texture.Load( path_texture.c_str() ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		EAE6320_ASSERTF( ( m_texture.GetWidth() == reinterpret_cast<const AtlasFormats::sHeader*>( m_file.data )->width )
+			&& ( m_texture.GetHeight() == reinterpret_cast<const AtlasFormats::sHeader*>( m_file.data )->height ),
+			"The atlas %s doesn't match its texture", i_path );
+	}
+
+OnExit:
+
+	if ( !wereThereErrors )
+	{
+		const AtlasFormats::sHeader* const header = reinterpret_cast<const AtlasFormats::sHeader*>( m_file.data );
+		size_t imageArea = 0;
+		for ( unsigned int i = 0; i < m_entryCount; ++i )
+		{
+			imageArea += static_cast<size_t>( m_entries[i].width ) * m_entries[i].height;
+		}
+		const float occupancy = 100.0f * static_cast<float>( imageArea ) / static_cast<float>( header->width * header->height );
+		Logging::OutputMessage( "Loaded the atlas %s (%u images in %ux%u, %.1f%% occupied)",
+			i_path, m_entryCount, header->width, header->height, occupancy );
+	}
+	else
+	{
+		CleanUp();
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::Atlas::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	if ( !m_texture.CleanUp() )
+	{
+		wereThereErrors = true;
+	}
+	if ( m_file.data )
+	{
+		std::string errorMessage;
+		if ( !Platform::UnmapBinaryFile( m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to unmap an atlas: %s", errorMessage.c_str() );
+		}
+	}
+	m_entries = NULL;
+	m_entryCount = 0;
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::Atlas::Atlas()
+	:
+	m_entries( NULL ), m_entryCount( 0 )
+{
+
+}
+
+eae6320::Graphics::Atlas::~Atlas()
+{
+	CleanUp();
+}
@@ -0,0 +1,67 @@
+/*
+	An atlas is a single texture that many smaller images have been packed into
+	by the TextureBuilder
+
+	Every image in an atlas can be drawn without changing which texture is bound,
+	and so sprites that would otherwise each need their own draw call can be batched together.
+	The built lookup table is mapped and used as-is (there is no parsing when it's loaded),
+	and images are found by a binary search for the hash of their name.
+*/
+
+#ifndef EAE6320_GRAPHICS_ATLAS_H
+#define EAE6320_GRAPHICS_ATLAS_H
+
+// Header Files
+//=============
+
+#include "AtlasFormats.h"
+#include "Texture.h"
+#include "../Platform/Platform.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Atlas
+		{
+		public:
+
+			// Access
+			//-------
+
+			// These return NULL if the atlas doesn't have an image with the name
+			const AtlasFormats::sEntry* Find( const char* const i_name ) const;
+			const AtlasFormats::sEntry* Find( const uint32_t i_nameHash ) const;
+
+			unsigned int GetImageCount() const { return m_entryCount; }
+			const Texture& GetTexture() const { return m_texture; }
+			Texture& GetTexture() { return m_texture; }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The atlas's texture is loaded from the same path with a ".texture" extension
+			bool Load( const char* const i_path );
+			bool CleanUp();
+
+			Atlas();
+			~Atlas();
+
+			// Data
+			//=====
+
+		private:
+
+			Platform::sMappedFile m_file;
+			Texture m_texture;
+			// These point into the mapped file
+			const AtlasFormats::sEntry* m_entries;
+			unsigned int m_entryCount;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_ATLAS_H
@@ -0,0 +1,76 @@
+/*
+	This file describes the layout of a built atlas file
+
+	It is shared between the TextureBuilder (which writes the file)
+	and the runtime Atlas (which reads it),
+	and so it must not depend on any graphics platform.
+
+	An atlas is built from a list of named images
+	which are packed into a single texture (written next to the atlas file with a ".texture" extension).
+	A built atlas is:
+		* An sHeader
+		* An sEntry for every image, sorted by name hash
+	The runtime uses the file exactly as it is on disk,
+	and finds an image by doing a binary search for the hash of its name.
+*/
+
+#ifndef EAE6320_GRAPHICS_ATLASFORMATS_H
+#define EAE6320_GRAPHICS_ATLASFORMATS_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace AtlasFormats
+		{
+			// "EATL" read as a little-endian uint32_t
+			const uint32_t s_fourCc = 0x4c544145;
+			const uint16_t s_version = 1;
+
+			struct sHeader
+			{
+				uint32_t fourCc;
+				uint16_t version;
+				uint16_t padding;
+				uint32_t entryCount;
+				// The size of the atlas texture
+				uint16_t width, height;
+			};
+
+			struct sEntry
+			{
+				uint32_t nameHash;
+				// The texture coordinates of the image's corners
+				// (0,0 is the top left of the texture and 1,1 is the bottom right)
+				float u0, v0, u1, v1;
+				// The size of the image in pixels
+				uint16_t width, height;
+			};
+
+			// Helper Functions
+			//-----------------
+
+			// 32-bit FNV-1a
+			inline uint32_t CalculateNameHash( const char* const i_name )
+			{
+				uint32_t hash = 2166136261u;
+				for ( const char* i = i_name; *i != '\0'; ++i )
+				{
+					hash ^= static_cast<uint8_t>( *i );
+					hash *= 16777619u;
+				}
+				return hash;
+			}
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_ATLASFORMATS_H
@@ -0,0 +1,802 @@
+// Header Files
+//=============
+
+#include "ClusteredLights.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+#include "../Math/Simd.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	const unsigned int s_lightsPerBatch = 256;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	float Dot( const float i_a[3], const float i_b[3] );
+	void Cross( const float i_a[3], const float i_b[3], float o_result[3] );
+	void Normalize( float io_vector[3] );
+	// The distance from a value to a range (or 0 if the value is inside of it)
+	float GetDistanceToRange( const float i_value, const float i_minimum, const float i_maximum );
+	// This calculates the squared distances from a value to a padded array of ranges
+	// and returns a bit for every range whose distance isn't more than the remainder of the radius
+	uint64_t CalculateDistancesSquared( const float i_value, const float* const i_minimums, const float* const i_maximums,
+		const unsigned int i_paddedCount, const float i_radiusSquaredRemainder, float* const o_distancesSquared );
+	// This is the test that a light's depth must pass to reach a slice
+	bool CanReachRange( const float i_value, const float i_radiusSquared, const float i_minimum, const float i_maximum );
+	uint32_t GetNextRandomNumber( uint32_t& io_state );
+	float GetRandomFloat( uint32_t& io_state, const float i_min, const float i_max );
+}
+
+// Interface
+//==========
+
+// Assign
+//-------
+
+void eae6320::Graphics::ClusteredLights::CalculateView( const float i_cameraPosition[3], const float i_targetPosition[3], const float i_up[3],
+	const float i_verticalFieldOfView, const float i_aspectRatio, const float i_zNear, const float i_zFar,
+	sView& o_view )
+{
+	for ( unsigned int j = 0; j < 3; ++j )
+	{
+		o_view.cameraPosition[j] = i_cameraPosition[j];
+		o_view.forward[j] = i_targetPosition[j] - i_cameraPosition[j];
+	}
+	Normalize( o_view.forward );
+	Cross( o_view.forward, i_up, o_view.right );
+	Normalize( o_view.right );
+	Cross( o_view.right, o_view.forward, o_view.up );
+	o_view.tangent_vertical = std::tan( i_verticalFieldOfView * 0.5f );
+	o_view.tangent_horizontal = o_view.tangent_vertical * i_aspectRatio;
+	o_view.zNear = i_zNear;
+	o_view.zFar = i_zFar;
+}
+
+void eae6320::Graphics::ClusteredLights::AssignLights( const sView& i_view, const sLight* const i_lights, const unsigned int i_lightCount )
+{
+	EAE6320_ASSERTF( !m_sliceHits.empty(), "Lights can't be assigned before the clusters are initialized" );
+	EAE6320_ASSERT( ( i_lights != NULL ) || ( i_lightCount == 0 ) );
+	EAE6320_ASSERT( ( i_view.zNear > 0.0f ) && ( i_view.zFar > i_view.zNear ) );
+	const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+
+	// The boxes only have to be recalculated when the shape of the frustum changes
+	if ( ( i_view.tangent_horizontal != m_tangent_horizontal ) || ( i_view.tangent_vertical != m_tangent_vertical )
+		|| ( i_view.zNear != m_zNear ) || ( i_view.zFar != m_zFar ) )
+	{
+		CalculateClusterBoxes( i_view );
+	}
+	m_view = i_view;
+	{
+		const float* const rows[3] = { i_view.right, i_view.up, i_view.forward };
+		for ( unsigned int i = 0; i < 3; ++i )
+		{
+			for ( unsigned int j = 0; j < 3; ++j )
+			{
+				m_constants.worldToView[i][j] = rows[i][j];
+			}
+			m_constants.worldToView[i][3] = -Dot( rows[i], i_view.cameraPosition );
+		}
+	}
+
+	const unsigned int lightCount = std::min( i_lightCount, m_settings.maxLightCount );
+	EAE6320_ASSERTF( lightCount == i_lightCount, "Only %u of the %u lights will be assigned", lightCount, i_lightCount );
+	m_lights.assign( i_lights, i_lights + lightCount );
+	m_viewLights.resize( lightCount );
+	m_constants.lightCount = lightCount;
+	if ( lightCount > 0 )
+	{
+		Jobs::ParallelFor( lightCount, s_lightsPerBatch, MoveLightsToViewBatch, this );
+	}
+	// Each slice gets a list of the lights that might reach it
+	// (in the order that they were submitted)
+	for ( unsigned int i = 0; i < m_settings.clusterCountZ; ++i )
+	{
+		m_sliceLights[i].clear();
+	}
+	for ( unsigned int i = 0; i < lightCount; ++i )
+	{
+		const sViewLight& light = m_viewLights[i];
+		for ( unsigned int j = light.sliceBegin; j < light.sliceEnd; ++j )
+		{
+			m_sliceLights[j].push_back( static_cast<uint16_t>( i ) );
+		}
+	}
+	// Each slice only writes to its own clusters
+	{
+		const unsigned int slicesPerBatch = 1;
+		Jobs::ParallelFor( m_settings.clusterCountZ, slicesPerBatch, AssignSlicesBatch, this );
+	}
+
+	// Compact the slices' lists
+	{
+		const unsigned int clusterCountPerSlice = m_settings.clusterCountX * m_settings.clusterCountY;
+		m_lightIndices.clear();
+		m_stats.nonEmptyClusterCount = 0;
+		m_stats.maxLightCountInCluster = 0;
+		m_stats.droppedLightIndexCount = 0;
+		for ( unsigned int i = 0; i < m_settings.clusterCountZ; ++i )
+		{
+			const uint32_t firstLightIndex = static_cast<uint32_t>( m_lightIndices.size() );
+			uint32_t* const clusterRanges = &m_clusterRanges[i * clusterCountPerSlice * 2];
+			for ( unsigned int j = 0; j < clusterCountPerSlice; ++j )
+			{
+				clusterRanges[( j * 2 ) + 0] += firstLightIndex;
+				const uint32_t count = clusterRanges[( j * 2 ) + 1];
+				if ( count > 0 )
+				{
+					++m_stats.nonEmptyClusterCount;
+					m_stats.maxLightCountInCluster = std::max( m_stats.maxLightCountInCluster, static_cast<unsigned int>( count ) );
+				}
+			}
+			m_lightIndices.insert( m_lightIndices.end(), m_sliceLightIndices[i].begin(), m_sliceLightIndices[i].end() );
+			m_stats.droppedLightIndexCount += m_droppedLightIndexCounts[i];
+		}
+		m_stats.lightIndexCount = static_cast<unsigned int>( m_lightIndices.size() );
+	}
+	// A light is visible if it is in any cluster
+	{
+		std::vector<uint8_t> isLightVisible( lightCount, 0 );
+		for ( std::vector<uint16_t>::const_iterator i = m_lightIndices.begin(); i != m_lightIndices.end(); ++i )
+		{
+			isLightVisible[*i] = 1;
+		}
+		m_stats.visibleLightCount = static_cast<unsigned int>( std::count( isLightVisible.begin(), isLightVisible.end(), 1 ) );
+	}
+
+	m_stats.secondCountAssigning = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+}
+
+// Render
+//-------
+
+bool eae6320::Graphics::ClusteredLights::Bind()
+{
+	EAE6320_ASSERTF( m_areBuffersCreated, "Clustered lights can't be bound unless their buffers were created" );
+	if ( m_areBuffersCreated )
+	{
+		return UploadAndBindBuffers();
+	}
+	else
+	{
+		return false;
+	}
+}
+
+// Benchmark
+//----------
+
+void eae6320::Graphics::ClusteredLights::LogAssignmentCost()
+{
+	sSettings settings;
+	settings.maxLightCount = 4 * 1024;
+	ClusteredLights clusteredLights;
+	if ( !clusteredLights.Initialize( settings, false ) )
+	{
+		return;
+	}
+
+	// The lights are scattered through a box around the origin and bob up and down,
+	// and the camera circles the box while looking at its center
+	uint32_t randomState = 0x2545f491;
+	std::vector<sLight> lights( settings.maxLightCount );
+	std::vector<float> phases( settings.maxLightCount );
+	const float pi = 3.14159265f;
+	for ( unsigned int i = 0; i < settings.maxLightCount; ++i )
+	{
+		sLight& light = lights[i];
+		light.position[0] = GetRandomFloat( randomState, -40.0f, 40.0f );
+		light.position[1] = GetRandomFloat( randomState, 0.0f, 10.0f );
+		light.position[2] = GetRandomFloat( randomState, -40.0f, 40.0f );
+		light.radius = GetRandomFloat( randomState, 1.0f, 4.0f );
+		light.color[0] = GetRandomFloat( randomState, 0.0f, 1.0f );
+		light.color[1] = GetRandomFloat( randomState, 0.0f, 1.0f );
+		light.color[2] = GetRandomFloat( randomState, 0.0f, 1.0f );
+		light.intensity = 1.0f;
+		phases[i] = GetRandomFloat( randomState, 0.0f, 2.0f * pi );
+	}
+	std::vector<sLight> movedLights( settings.maxLightCount );
+	std::vector<uint32_t> clusterRanges_bruteForce;
+	std::vector<uint16_t> lightIndices_bruteForce;
+
+	const unsigned int lightCounts[] = { 1024, 2048, 4096 };
+	const unsigned int frameCount = 120;
+	// Testing every light against every cluster is slow, and so it is only done for some of the frames
+	const unsigned int bruteForceFramePeriod = 10;
+	const float up[3] = { 0.0f, 1.0f, 0.0f };
+	const float target[3] = { 0.0f, 2.0f, 0.0f };
+	for ( unsigned int i = 0; i < ( sizeof( lightCounts ) / sizeof( lightCounts[0] ) ); ++i )
+	{
+		const unsigned int lightCount = lightCounts[i];
+		double secondCountAssigning = 0.0, secondCountAssigning_bruteForce = 0.0;
+		uint64_t lightIndexCount = 0, nonEmptyClusterCount = 0, visibleLightCount = 0;
+		unsigned int maxLightCountInCluster = 0, droppedLightIndexCount = 0;
+		unsigned int checkedFrameCount = 0, mismatchedFrameCount = 0;
+		for ( unsigned int frame = 0; frame < frameCount; ++frame )
+		{
+			const float angle = ( 2.0f * pi * frame ) / frameCount;
+			for ( unsigned int j = 0; j < lightCount; ++j )
+			{
+				movedLights[j] = lights[j];
+				movedLights[j].position[1] += std::sin( angle + phases[j] );
+			}
+			const float cameraPosition[3] = { 30.0f * std::cos( angle ), 8.0f, 30.0f * std::sin( angle ) };
+			sView view;
+			CalculateView( cameraPosition, target, up, pi / 3.0f, 16.0f / 9.0f, 0.1f, 100.0f, view );
+
+			clusteredLights.AssignLights( view, &movedLights[0], lightCount );
+			const sStats& stats = clusteredLights.GetStats();
+			secondCountAssigning += stats.secondCountAssigning;
+			lightIndexCount += stats.lightIndexCount;
+			nonEmptyClusterCount += stats.nonEmptyClusterCount;
+			visibleLightCount += stats.visibleLightCount;
+			maxLightCountInCluster = std::max( maxLightCountInCluster, stats.maxLightCountInCluster );
+			droppedLightIndexCount += stats.droppedLightIndexCount;
+			if ( ( frame % bruteForceFramePeriod ) == 0 )
+			{
+				const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+				clusteredLights.AssignLights_bruteForce( view, &movedLights[0], lightCount, clusterRanges_bruteForce, lightIndices_bruteForce );
+				secondCountAssigning_bruteForce += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+				++checkedFrameCount;
+				// Lights that were dropped from full clusters would be in the brute force lists
+				if ( ( stats.droppedLightIndexCount == 0 )
+					&& ( ( clusterRanges_bruteForce != clusteredLights.GetClusterRanges() )
+						|| ( lightIndices_bruteForce != clusteredLights.GetLightIndices() ) ) )
+				{
+					++mismatchedFrameCount;
+				}
+			}
+		}
+		EAE6320_ASSERTF( mismatchedFrameCount == 0, "The clustered and brute force light assignments disagree" );
+
+		Logging::OutputMessage( "Assigning %u lights (%.0f visible) to %u clusters took %.3f ms per frame:"
+			" %.1f lights per non-empty cluster (at most %u), %.0f light indices per frame, and %u dropped from full clusters",
+			lightCount, static_cast<double>( visibleLightCount ) / frameCount, clusteredLights.GetClusterCount(),
+			secondCountAssigning * 1000.0 / frameCount,
+			( nonEmptyClusterCount > 0 ) ? ( static_cast<double>( lightIndexCount ) / nonEmptyClusterCount ) : 0.0,
+			maxLightCountInCluster, static_cast<double>( lightIndexCount ) / frameCount, droppedLightIndexCount );
+		Logging::OutputMessage( "Testing every light against every cluster took %.3f ms per frame"
+			" (the results differed in %u of %u frames)",
+			secondCountAssigning_bruteForce * 1000.0 / checkedFrameCount, mismatchedFrameCount, checkedFrameCount );
+	}
+
+	clusteredLights.CleanUp();
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::ClusteredLights::Initialize( const sSettings& i_settings, const bool i_shouldBuffersBeCreated )
+{
+	EAE6320_ASSERT( ( i_settings.clusterCountX > 0 ) && ( i_settings.clusterCountY > 0 ) && ( i_settings.clusterCountZ > 0 ) );
+	EAE6320_ASSERTF( i_settings.maxLightCount <= 0x10000, "Light indices are 16 bits" );
+	EAE6320_ASSERT( i_settings.maxLightCountPerCluster > 0 );
+	EAE6320_ASSERTF( ( i_settings.clusterCountX <= 64 ) && ( i_settings.clusterCountY <= 64 ),
+		"The columns and rows that a light reaches are stored as 64 bits" );
+	m_settings = i_settings;
+	m_paddedClusterCountX = ( m_settings.clusterCountX + 3 ) & ~3u;
+	m_paddedClusterCountY = ( m_settings.clusterCountY + 3 ) & ~3u;
+
+	const unsigned int clusterCount = GetClusterCount();
+	m_sliceLights.resize( m_settings.clusterCountZ );
+	m_sliceHits.resize( m_settings.clusterCountZ );
+	m_sliceLightIndices.resize( m_settings.clusterCountZ );
+	m_droppedLightIndexCounts.assign( m_settings.clusterCountZ, 0 );
+	m_columnDistancesSquared.resize( m_settings.clusterCountZ * m_paddedClusterCountX );
+	m_rowDistancesSquared.resize( m_settings.clusterCountZ * m_paddedClusterCountY );
+	m_clusterRanges.assign( clusterCount * 2, 0 );
+	m_lightIndices.clear();
+	// The boxes are calculated when lights are first assigned
+	m_tangent_horizontal = m_tangent_vertical = m_zNear = m_zFar = 0.0f;
+	memset( &m_constants, 0, sizeof( m_constants ) );
+	m_constants.clusterCountX = m_settings.clusterCountX;
+	m_constants.clusterCountY = m_settings.clusterCountY;
+	m_constants.clusterCountZ = m_settings.clusterCountZ;
+	memset( &m_stats, 0, sizeof( m_stats ) );
+
+	if ( i_shouldBuffersBeCreated )
+	{
+		if ( !CreateBuffers() )
+		{
+			DestroyBuffers();
+			return false;
+		}
+		m_areBuffersCreated = true;
+	}
+	return true;
+}
+
+bool eae6320::Graphics::ClusteredLights::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	if ( m_areBuffersCreated )
+	{
+		if ( !DestroyBuffers() )
+		{
+			wereThereErrors = true;
+		}
+		m_areBuffersCreated = false;
+	}
+	m_columnMinimum.clear();
+	m_columnMaximum.clear();
+	m_rowMinimum.clear();
+	m_rowMaximum.clear();
+	m_sliceDepths.clear();
+	m_lights.clear();
+	m_viewLights.clear();
+	m_columnDistancesSquared.clear();
+	m_rowDistancesSquared.clear();
+	m_sliceLights.clear();
+	m_sliceHits.clear();
+	m_sliceLightIndices.clear();
+	m_droppedLightIndexCounts.clear();
+	m_clusterRanges.clear();
+	m_lightIndices.clear();
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::ClusteredLights::sSettings::sSettings()
+	:
+	clusterCountX( 16 ), clusterCountY( 9 ), clusterCountZ( 24 ),
+	maxLightCount( 1024 ),
+	maxLightCountPerCluster( 256 )
+{
+
+}
+
+eae6320::Graphics::ClusteredLights::ClusteredLights()
+{
+	memset( &m_view, 0, sizeof( m_view ) );
+	memset( &m_constants, 0, sizeof( m_constants ) );
+	memset( &m_stats, 0, sizeof( m_stats ) );
+	for ( unsigned int i = 0; i < BufferCount; ++i )
+	{
+#if defined( EAE6320_PLATFORM_D3D )
+		m_buffers[i] = NULL;
+		m_shaderResourceViews[i] = NULL;
+#elif defined( EAE6320_PLATFORM_GL )
+		m_bufferIds[i] = 0;
+		m_textureIds[i] = 0;
+#endif
+	}
+}
+
+eae6320::Graphics::ClusteredLights::~ClusteredLights()
+{
+	CleanUp();
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::ClusteredLights::CalculateClusterBoxes( const sView& i_view )
+{
+	m_tangent_horizontal = i_view.tangent_horizontal;
+	m_tangent_vertical = i_view.tangent_vertical;
+	m_zNear = i_view.zNear;
+	m_zFar = i_view.zFar;
+
+	const unsigned int countX = m_settings.clusterCountX, countY = m_settings.clusterCountY, countZ = m_settings.clusterCountZ;
+	// Each slice is the same ratio deeper than the one before it
+	{
+		m_sliceDepths.resize( countZ + 1 );
+		const float depthRatio = m_zFar / m_zNear;
+		for ( unsigned int i = 0; i < countZ; ++i )
+		{
+			m_sliceDepths[i] = m_zNear * std::pow( depthRatio, static_cast<float>( i ) / countZ );
+		}
+		m_sliceDepths[countZ] = m_zFar;
+		const float logarithm = std::log( depthRatio );
+		m_constants.sliceScale = countZ / logarithm;
+		m_constants.sliceBias = -( countZ * std::log( m_zNear ) ) / logarithm;
+	}
+	// The tiles divide the range of (x / z) and (y / z) that is inside of the frustum evenly,
+	// and each cluster's box is the smallest one that contains the tile between the slice's near and far depths
+	m_columnMinimum.resize( countZ * m_paddedClusterCountX );
+	m_columnMaximum.resize( countZ * m_paddedClusterCountX );
+	m_rowMinimum.resize( countZ * m_paddedClusterCountY );
+	m_rowMaximum.resize( countZ * m_paddedClusterCountY );
+	for ( unsigned int z = 0; z < countZ; ++z )
+	{
+		const float depth_near = m_sliceDepths[z], depth_far = m_sliceDepths[z + 1];
+		for ( unsigned int x = 0; x < m_paddedClusterCountX; ++x )
+		{
+			const unsigned int index = ( z * m_paddedClusterCountX ) + x;
+			if ( x < countX )
+			{
+				const float slope_left = m_tangent_horizontal * ( ( ( 2.0f * x ) / countX ) - 1.0f );
+				const float slope_right = m_tangent_horizontal * ( ( ( 2.0f * ( x + 1 ) ) / countX ) - 1.0f );
+				m_columnMinimum[index] = std::min( slope_left * depth_near, slope_left * depth_far );
+				m_columnMaximum[index] = std::max( slope_right * depth_near, slope_right * depth_far );
+			}
+			else
+			{
+				// Nothing is close enough to reach the padding
+				m_columnMinimum[index] = m_columnMaximum[index] = FLT_MAX;
+			}
+		}
+		for ( unsigned int y = 0; y < m_paddedClusterCountY; ++y )
+		{
+			const unsigned int index = ( z * m_paddedClusterCountY ) + y;
+			if ( y < countY )
+			{
+				const float slope_bottom = m_tangent_vertical * ( ( ( 2.0f * y ) / countY ) - 1.0f );
+				const float slope_top = m_tangent_vertical * ( ( ( 2.0f * ( y + 1 ) ) / countY ) - 1.0f );
+				m_rowMinimum[index] = std::min( slope_bottom * depth_near, slope_bottom * depth_far );
+				m_rowMaximum[index] = std::max( slope_top * depth_near, slope_top * depth_far );
+			}
+			else
+			{
+				m_rowMinimum[index] = m_rowMaximum[index] = FLT_MAX;
+			}
+		}
+	}
+	m_constants.tileScale[0] = countX / ( 2.0f * m_tangent_horizontal );
+	m_constants.tileScale[1] = countY / ( 2.0f * m_tangent_vertical );
+	m_constants.tileBias[0] = countX * 0.5f;
+	m_constants.tileBias[1] = countY * 0.5f;
+}
+
+unsigned int eae6320::Graphics::ClusteredLights::GetSlice( const float i_depth ) const
+{
+	const unsigned int lastSlice = m_settings.clusterCountZ - 1;
+	if ( i_depth <= m_zNear )
+	{
+		return 0;
+	}
+	const float slice = ( std::log( i_depth ) * m_constants.sliceScale ) + m_constants.sliceBias;
+	unsigned int index = ( slice < static_cast<float>( lastSlice ) ) ? static_cast<unsigned int>( slice ) : lastSlice;
+	// The logarithm can be rounded into a neighboring slice
+	while ( ( index > 0 ) && ( i_depth < m_sliceDepths[index] ) )
+	{
+		--index;
+	}
+	while ( ( index < lastSlice ) && ( i_depth >= m_sliceDepths[index + 1] ) )
+	{
+		++index;
+	}
+	return index;
+}
+
+void eae6320::Graphics::ClusteredLights::AssignLights_bruteForce( const sView& i_view, const sLight* const i_lights, const unsigned int i_lightCount,
+	std::vector<uint32_t>& o_clusterRanges, std::vector<uint16_t>& o_lightIndices ) const
+{
+	const unsigned int countX = m_settings.clusterCountX, countY = m_settings.clusterCountY, countZ = m_settings.clusterCountZ;
+	o_clusterRanges.resize( GetClusterCount() * 2 );
+	o_lightIndices.clear();
+	// The lights are moved into view space with the same operations as MoveLightsToViewBatch()
+	// so that the results are identical
+	std::vector<sViewLight> viewLights( i_lightCount );
+	for ( unsigned int i = 0; i < i_lightCount; ++i )
+	{
+		float offset[3];
+		for ( unsigned int j = 0; j < 3; ++j )
+		{
+			offset[j] = i_lights[i].position[j] - i_view.cameraPosition[j];
+		}
+		viewLights[i].x = ( ( offset[0] * i_view.right[0] ) + ( offset[1] * i_view.right[1] ) ) + ( offset[2] * i_view.right[2] );
+		viewLights[i].y = ( ( offset[0] * i_view.up[0] ) + ( offset[1] * i_view.up[1] ) ) + ( offset[2] * i_view.up[2] );
+		viewLights[i].z = ( ( offset[0] * i_view.forward[0] ) + ( offset[1] * i_view.forward[1] ) ) + ( offset[2] * i_view.forward[2] );
+		viewLights[i].radiusSquared = i_lights[i].radius * i_lights[i].radius;
+	}
+	for ( unsigned int z = 0; z < countZ; ++z )
+	{
+		for ( unsigned int y = 0; y < countY; ++y )
+		{
+			for ( unsigned int x = 0; x < countX; ++x )
+			{
+				const unsigned int cluster = ( ( ( z * countY ) + y ) * countX ) + x;
+				const unsigned int column = ( z * m_paddedClusterCountX ) + x;
+				const unsigned int row = ( z * m_paddedClusterCountY ) + y;
+				o_clusterRanges[( cluster * 2 ) + 0] = static_cast<uint32_t>( o_lightIndices.size() );
+				for ( unsigned int i = 0; i < i_lightCount; ++i )
+				{
+					const sViewLight& light = viewLights[i];
+					const float distance_z = GetDistanceToRange( light.z, m_sliceDepths[z], m_sliceDepths[z + 1] );
+					const float distance_y = GetDistanceToRange( light.y, m_rowMinimum[row], m_rowMaximum[row] );
+					const float distance_x = GetDistanceToRange( light.x, m_columnMinimum[column], m_columnMaximum[column] );
+					const float limit = ( light.radiusSquared - ( distance_z * distance_z ) ) - ( distance_y * distance_y );
+					if ( ( distance_x * distance_x ) <= limit )
+					{
+						o_lightIndices.push_back( static_cast<uint16_t>( i ) );
+					}
+				}
+				o_clusterRanges[( cluster * 2 ) + 1] = static_cast<uint32_t>( o_lightIndices.size() ) - o_clusterRanges[( cluster * 2 ) + 0];
+			}
+		}
+	}
+}
+
+void eae6320::Graphics::ClusteredLights::MoveLightsToViewBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+{
+	ClusteredLights& clusteredLights = *static_cast<ClusteredLights*>( io_userData );
+	const sView& view = clusteredLights.m_view;
+	const sLight* const lights = &clusteredLights.m_lights[0];
+	const std::vector<float>& sliceDepths = clusteredLights.m_sliceDepths;
+	const unsigned int sliceCount = clusteredLights.m_settings.clusterCountZ;
+
+	const Math::Simd::tFloat4 cameraX = Math::Simd::Splat( view.cameraPosition[0] );
+	const Math::Simd::tFloat4 cameraY = Math::Simd::Splat( view.cameraPosition[1] );
+	const Math::Simd::tFloat4 cameraZ = Math::Simd::Splat( view.cameraPosition[2] );
+	// 4 lights are moved at a time
+	// (if there are fewer left the last one is repeated)
+	for ( unsigned int i = i_begin; i < i_end; i += 4 )
+	{
+		unsigned int indices[4];
+		for ( unsigned int j = 0; j < 4; ++j )
+		{
+			indices[j] = std::min( i + j, i_end - 1 );
+		}
+		const sLight& light0 = lights[indices[0]];
+		const sLight& light1 = lights[indices[1]];
+		const sLight& light2 = lights[indices[2]];
+		const sLight& light3 = lights[indices[3]];
+		const Math::Simd::tFloat4 offsetX = Math::Simd::Subtract(
+			Math::Simd::Set( light0.position[0], light1.position[0], light2.position[0], light3.position[0] ), cameraX );
+		const Math::Simd::tFloat4 offsetY = Math::Simd::Subtract(
+			Math::Simd::Set( light0.position[1], light1.position[1], light2.position[1], light3.position[1] ), cameraY );
+		const Math::Simd::tFloat4 offsetZ = Math::Simd::Subtract(
+			Math::Simd::Set( light0.position[2], light1.position[2], light2.position[2], light3.position[2] ), cameraZ );
+		const Math::Simd::tFloat4 radius = Math::Simd::Set( light0.radius, light1.radius, light2.radius, light3.radius );
+		float positions_view[3][4];
+		{
+			const float* const axes[3] = { view.right, view.up, view.forward };
+			for ( unsigned int j = 0; j < 3; ++j )
+			{
+				Math::Simd::tFloat4 position = Math::Simd::Multiply( offsetX, Math::Simd::Splat( axes[j][0] ) );
+				position = Math::Simd::MultiplyAdd( offsetY, Math::Simd::Splat( axes[j][1] ), position );
+				position = Math::Simd::MultiplyAdd( offsetZ, Math::Simd::Splat( axes[j][2] ), position );
+				Math::Simd::Store( position, positions_view[j] );
+			}
+		}
+		float radii[4], radiiSquared[4];
+		Math::Simd::Store( radius, radii );
+		Math::Simd::Store( Math::Simd::Multiply( radius, radius ), radiiSquared );
+		const unsigned int count = std::min( i_end - i, 4u );
+		for ( unsigned int j = 0; j < count; ++j )
+		{
+			sViewLight& viewLight = clusteredLights.m_viewLights[i + j];
+			viewLight.x = positions_view[0][j];
+			viewLight.y = positions_view[1][j];
+			viewLight.z = positions_view[2][j];
+			viewLight.radiusSquared = radiiSquared[j];
+			// The slices that the ends of the sphere's depth range are in are calculated the same way that a shader would,
+			// and then the slice on each side is checked with the same test that AssignSlicesBatch() uses
+			// in case rounding put the ends of the range on the wrong side of a boundary
+			const float depth_near = viewLight.z - radii[j];
+			const float depth_far = viewLight.z + radii[j];
+			unsigned int sliceBegin = clusteredLights.GetSlice( depth_near );
+			unsigned int sliceEnd = ( depth_far >= sliceDepths[0] ) ? ( clusteredLights.GetSlice( depth_far ) + 1 ) : 0;
+			if ( ( sliceBegin > 0 ) && CanReachRange( viewLight.z, viewLight.radiusSquared, sliceDepths[sliceBegin - 1], sliceDepths[sliceBegin] ) )
+			{
+				--sliceBegin;
+			}
+			if ( ( sliceEnd < sliceCount ) && CanReachRange( viewLight.z, viewLight.radiusSquared, sliceDepths[sliceEnd], sliceDepths[sliceEnd + 1] ) )
+			{
+				++sliceEnd;
+			}
+			viewLight.sliceBegin = sliceBegin;
+			viewLight.sliceEnd = std::max( sliceBegin, sliceEnd );
+		}
+	}
+}
+
+void eae6320::Graphics::ClusteredLights::AssignSlicesBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+{
+	ClusteredLights& clusteredLights = *static_cast<ClusteredLights*>( io_userData );
+	const unsigned int countX = clusteredLights.m_settings.clusterCountX;
+	const unsigned int countY = clusteredLights.m_settings.clusterCountY;
+	const unsigned int paddedCountX = clusteredLights.m_paddedClusterCountX;
+	const unsigned int paddedCountY = clusteredLights.m_paddedClusterCountY;
+	const unsigned int maxLightCountPerCluster = clusteredLights.m_settings.maxLightCountPerCluster;
+
+	for ( unsigned int z = i_begin; z < i_end; ++z )
+	{
+		const float depth_near = clusteredLights.m_sliceDepths[z], depth_far = clusteredLights.m_sliceDepths[z + 1];
+		const float* const columnMinimum = &clusteredLights.m_columnMinimum[z * paddedCountX];
+		const float* const columnMaximum = &clusteredLights.m_columnMaximum[z * paddedCountX];
+		const float* const rowMinimum = &clusteredLights.m_rowMinimum[z * paddedCountY];
+		const float* const rowMaximum = &clusteredLights.m_rowMaximum[z * paddedCountY];
+		float* const columnDistancesSquared = &clusteredLights.m_columnDistancesSquared[z * paddedCountX];
+		float* const rowDistancesSquared = &clusteredLights.m_rowDistancesSquared[z * paddedCountY];
+		// Every light that reaches a cluster is appended to the slice's list of hits
+		// (the cluster is in the upper 16 bits and the light in the lower 16 bits),
+		// and then the hits are sorted into each cluster's list
+		// (the array is grown before each light so that it has room for the light to reach every cluster in the slice)
+		std::vector<uint32_t>& hits = clusteredLights.m_sliceHits[z];
+		unsigned int hitCount = 0;
+		const unsigned int clusterCount = countY * countX;
+
+		const std::vector<uint16_t>& sliceLights = clusteredLights.m_sliceLights[z];
+		for ( std::vector<uint16_t>::const_iterator i = sliceLights.begin(); i != sliceLights.end(); ++i )
+		{
+			const uint32_t lightIndex = *i;
+			const sViewLight& light = clusteredLights.m_viewLights[lightIndex];
+			// The distance to a box is the length of the distances to its ranges in x, y, and z,
+			// and so the light is compared against what is left of its radius after each axis
+			const float distance_z = GetDistanceToRange( light.z, depth_near, depth_far );
+			const float remainder_z = light.radiusSquared - ( distance_z * distance_z );
+			if ( remainder_z < 0.0f )
+			{
+				continue;
+			}
+			// The distances to the columns are the same for every row (and the distances to the rows for every column),
+			// and so they are calculated once along with which ones the light could reach
+			const uint64_t reachedColumns = CalculateDistancesSquared( light.x, columnMinimum, columnMaximum, paddedCountX, remainder_z,
+				columnDistancesSquared );
+			if ( reachedColumns == 0 )
+			{
+				continue;
+			}
+			uint64_t reachedRows = CalculateDistancesSquared( light.y, rowMinimum, rowMaximum, paddedCountY, remainder_z,
+				rowDistancesSquared );
+			if ( hits.size() < ( hitCount + clusterCount + 4 ) )
+			{
+				hits.resize( ( hits.size() * 2 ) + clusterCount + 4 );
+			}
+			uint32_t* const lightHits = &hits[hitCount];
+			unsigned int lightHitCount = 0;
+			for ( unsigned int y = 0; reachedRows != 0; ++y, reachedRows >>= 1 )
+			{
+				if ( ( reachedRows & 1 ) == 0 )
+				{
+					continue;
+				}
+				const Math::Simd::tFloat4 limit = Math::Simd::Splat( remainder_z - rowDistancesSquared[y] );
+				for ( unsigned int j = 0; j < paddedCountX; j += 4 )
+				{
+					if ( ( ( reachedColumns >> j ) & 0xf ) == 0 )
+					{
+						continue;
+					}
+					// Every column in the group is written but only the ones the light reached are kept
+					// (which avoids a branch that is hard to predict,
+					// and the padding is never reached)
+					const unsigned int bits = Math::Simd::GetBits( Math::Simd::IsLessOrEqual( Math::Simd::Load( columnDistancesSquared + j ), limit ) );
+					const uint32_t hit = ( ( ( y * countX ) + j ) << 16 ) | lightIndex;
+					lightHits[lightHitCount] = hit;
+					lightHitCount += bits & 1;
+					lightHits[lightHitCount] = hit + ( 1 << 16 );
+					lightHitCount += ( bits >> 1 ) & 1;
+					lightHits[lightHitCount] = hit + ( 2 << 16 );
+					lightHitCount += ( bits >> 2 ) & 1;
+					lightHits[lightHitCount] = hit + ( 3 << 16 );
+					lightHitCount += ( bits >> 3 ) & 1;
+				}
+			}
+			hitCount += lightHitCount;
+		}
+
+		// Each cluster's range is relative to the start of the slice's light indices
+		// until all of the slices are compacted together
+		uint32_t* const clusterRanges = &clusteredLights.m_clusterRanges[z * clusterCount * 2];
+		for ( unsigned int i = 0; i < clusterCount; ++i )
+		{
+			clusterRanges[( i * 2 ) + 1] = 0;
+		}
+		for ( unsigned int i = 0; i < hitCount; ++i )
+		{
+			++clusterRanges[( ( hits[i] >> 16 ) * 2 ) + 1];
+		}
+		unsigned int lightIndexCount = 0, droppedLightIndexCount = 0;
+		for ( unsigned int i = 0; i < clusterCount; ++i )
+		{
+			const uint32_t count = clusterRanges[( i * 2 ) + 1];
+			clusterRanges[( i * 2 ) + 0] = lightIndexCount;
+			clusterRanges[( i * 2 ) + 1] = 0;
+			if ( count <= maxLightCountPerCluster )
+			{
+				lightIndexCount += count;
+			}
+			else
+			{
+				lightIndexCount += maxLightCountPerCluster;
+				droppedLightIndexCount += count - maxLightCountPerCluster;
+			}
+		}
+		// The hits are in the order of the lights,
+		// and so each cluster keeps the first lights that were submitted if it is full
+		std::vector<uint16_t>& lightIndices = clusteredLights.m_sliceLightIndices[z];
+		lightIndices.resize( lightIndexCount );
+		for ( unsigned int i = 0; i < hitCount; ++i )
+		{
+			uint32_t* const clusterRange = &clusterRanges[( hits[i] >> 16 ) * 2];
+			if ( clusterRange[1] < maxLightCountPerCluster )
+			{
+				lightIndices[clusterRange[0] + clusterRange[1]] = static_cast<uint16_t>( hits[i] & 0xffff );
+				++clusterRange[1];
+			}
+		}
+		clusteredLights.m_droppedLightIndexCounts[z] = droppedLightIndexCount;
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	float Dot( const float i_a[3], const float i_b[3] )
+	{
+		return ( i_a[0] * i_b[0] ) + ( i_a[1] * i_b[1] ) + ( i_a[2] * i_b[2] );
+	}
+
+	void Cross( const float i_a[3], const float i_b[3], float o_result[3] )
+	{
+		o_result[0] = ( i_a[1] * i_b[2] ) - ( i_a[2] * i_b[1] );
+		o_result[1] = ( i_a[2] * i_b[0] ) - ( i_a[0] * i_b[2] );
+		o_result[2] = ( i_a[0] * i_b[1] ) - ( i_a[1] * i_b[0] );
+	}
+
+	void Normalize( float io_vector[3] )
+	{
+		const float length = std::sqrt( Dot( io_vector, io_vector ) );
+		if ( length > 0.0f )
+		{
+			const float lengthInverse = 1.0f / length;
+			io_vector[0] *= lengthInverse;
+			io_vector[1] *= lengthInverse;
+			io_vector[2] *= lengthInverse;
+		}
+	}
+
+	float GetDistanceToRange( const float i_value, const float i_minimum, const float i_maximum )
+	{
+		return std::max( std::max( i_minimum - i_value, i_value - i_maximum ), 0.0f );
+	}
+
+	uint64_t CalculateDistancesSquared( const float i_value, const float* const i_minimums, const float* const i_maximums,
+		const unsigned int i_paddedCount, const float i_radiusSquaredRemainder, float* const o_distancesSquared )
+	{
+		const eae6320::Math::Simd::tFloat4 value = eae6320::Math::Simd::Splat( i_value );
+		const eae6320::Math::Simd::tFloat4 limit = eae6320::Math::Simd::Splat( i_radiusSquaredRemainder );
+		const eae6320::Math::Simd::tFloat4 zero = eae6320::Math::Simd::Splat( 0.0f );
+		uint64_t reachedRanges = 0;
+		for ( unsigned int i = 0; i < i_paddedCount; i += 4 )
+		{
+			const eae6320::Math::Simd::tFloat4 distance = eae6320::Math::Simd::Maximum( eae6320::Math::Simd::Maximum(
+				eae6320::Math::Simd::Subtract( eae6320::Math::Simd::Load( i_minimums + i ), value ),
+				eae6320::Math::Simd::Subtract( value, eae6320::Math::Simd::Load( i_maximums + i ) ) ), zero );
+			const eae6320::Math::Simd::tFloat4 distanceSquared = eae6320::Math::Simd::Multiply( distance, distance );
+			eae6320::Math::Simd::Store( distanceSquared, o_distancesSquared + i );
+			reachedRanges |= static_cast<uint64_t>( eae6320::Math::Simd::GetBits( eae6320::Math::Simd::IsLessOrEqual( distanceSquared, limit ) ) ) << i;
+		}
+		return reachedRanges;
+	}
+
+	bool CanReachRange( const float i_value, const float i_radiusSquared, const float i_minimum, const float i_maximum )
+	{
+		const float distance = GetDistanceToRange( i_value, i_minimum, i_maximum );
+		return ( i_radiusSquared - ( distance * distance ) ) >= 0.0f;
+	}
+
+	uint32_t GetNextRandomNumber( uint32_t& io_state )
+	{
+		// xorshift32
+		io_state ^= io_state << 13;
+		io_state ^= io_state >> 17;
+		io_state ^= io_state << 5;
+		return io_state;
+	}
+
+	float GetRandomFloat( uint32_t& io_state, const float i_min, const float i_max )
+	{
+		const float unit = static_cast<float>( GetNextRandomNumber( io_state ) & 0x00ffffff ) / static_cast<float>( 0x01000000 );
+		return i_min + ( ( i_max - i_min ) * unit );
+	}
+}
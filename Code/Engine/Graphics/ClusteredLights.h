@@ -0,0 +1,262 @@
+/*
+	Clustered lights divide the view frustum into a grid of clusters
+	and find which lights can reach each cluster
+	so that shading a pixel only has to loop over the few lights in its cluster
+	instead of every light in the scene
+
+	The clusters are tiles of the screen (X and Y) that are split into slices of view depth (Z).
+	The slices get exponentially thicker further from the camera
+	so that every cluster is about as deep as it is wide.
+	Every frame the lights are moved into view space and each one is tested against the clusters
+	in the slices that its sphere overlaps.
+	Each slice is assigned by a different job,
+	and the box around every cluster is separable (X only depends on the column, Y on the row, and Z on the slice)
+	so that the distance from a light to 4 columns of clusters is calculated at once with SIMD instructions.
+
+	The result is a compact list of light indices with an (offset, count) range for every cluster,
+	which is uploaded along with the lights and the grid's constants by Bind().
+*/
+
+#ifndef EAE6320_GRAPHICS_CLUSTEREDLIGHTS_H
+#define EAE6320_GRAPHICS_CLUSTEREDLIGHTS_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class ClusteredLights
+		{
+		public:
+
+			// Shaders read the lights from these registers
+			// (a cbuffer and three Buffer<>s in HLSL, and a uniform block and three texture buffers in GLSL):
+			//	* The constants are an sConstants
+			//	* Every cluster is a uint2 (the offset of its first light index and the count)
+			//		and the cluster in column x, row y, and slice z is at ( ( ( z * countY ) + y ) * countX ) + x
+			//	* Every light index is a uint (16 bits in the buffer, and so there can't be more than 65536 lights)
+			//	* Every light is two float4s (position and radius, and color and intensity) in the layout of sLight
+			static const unsigned int s_constantBufferRegister = 2;
+			static const unsigned int s_clusterTextureUnit = 13;
+			static const unsigned int s_lightIndexTextureUnit = 14;
+			static const unsigned int s_lightTextureUnit = 15;
+
+			struct sLight
+			{
+				// The position is in world space,
+				// and the light doesn't reach anything further than the radius
+				float position[3];
+				float radius;
+				float color[3];
+				float intensity;
+			};
+
+			struct sView
+			{
+				// The camera's position and its orthonormal right, up, and forward directions in world space
+				float cameraPosition[3];
+				float right[3], up[3], forward[3];
+				// The tangents of half of the horizontal and vertical fields of view
+				float tangent_horizontal, tangent_vertical;
+				float zNear, zFar;
+			};
+
+			struct sSettings
+			{
+				unsigned int clusterCountX, clusterCountY, clusterCountZ;
+				unsigned int maxLightCount;
+				// When more lights than this reach a cluster the ones that were submitted last are ignored
+				unsigned int maxLightCountPerCluster;
+
+				sSettings();
+			};
+
+			// This determines the layout of the constant data that the CPU sends to the GPU.
+			// A world position is moved into view space with the rows of the matrix,
+			// and then the cluster it is in is:
+			//	x = floor( ( ( position_view.x / position_view.z ) * tileScale.x ) + tileBias.x )
+			//	y = floor( ( ( position_view.y / position_view.z ) * tileScale.y ) + tileBias.y )
+			//	z = floor( ( log( position_view.z ) * sliceScale ) + sliceBias )
+			struct sConstants
+			{
+				float worldToView[3][4];
+				float tileScale[2], tileBias[2];
+				float sliceScale, sliceBias;
+				uint32_t clusterCountX, clusterCountY;
+				uint32_t clusterCountZ, lightCount;
+				uint32_t padding[2];
+			};
+
+			// These can be used to profile the assignment
+			struct sStats
+			{
+				// The lights that reached at least one cluster
+				unsigned int visibleLightCount;
+				unsigned int lightIndexCount;
+				unsigned int nonEmptyClusterCount;
+				unsigned int maxLightCountInCluster;
+				// Lights that were ignored because their cluster was full
+				unsigned int droppedLightIndexCount;
+				double secondCountAssigning;
+			};
+
+			// Assign
+			//-------
+
+			// This calculates the view of a perspective camera at i_cameraPosition looking at i_targetPosition
+			// (the vertical field of view is in radians)
+			static void CalculateView( const float i_cameraPosition[3], const float i_targetPosition[3], const float i_up[3],
+				const float i_verticalFieldOfView, const float i_aspectRatio, const float i_zNear, const float i_zFar,
+				sView& o_view );
+
+			// This replaces the previous assignment
+			// (lights after the maximum count are ignored)
+			void AssignLights( const sView& i_view, const sLight* const i_lights, const unsigned int i_lightCount );
+
+			// Render
+			//-------
+
+			// This must be called from the render thread.
+			// It uploads the most recent assignment and binds it to the registers that shaders read it from.
+			bool Bind();
+
+			// Access
+			//-------
+
+			unsigned int GetClusterCount() const { return m_settings.clusterCountX * m_settings.clusterCountY * m_settings.clusterCountZ; }
+			// Each cluster has two values: the offset of its first light index and its light count
+			const std::vector<uint32_t>& GetClusterRanges() const { return m_clusterRanges; }
+			const std::vector<uint16_t>& GetLightIndices() const { return m_lightIndices; }
+			const sConstants& GetConstants() const { return m_constants; }
+			const sSettings& GetSettings() const { return m_settings; }
+			const sStats& GetStats() const { return m_stats; }
+
+			// Benchmark
+			//----------
+
+			// This assigns different numbers of moving lights to the clusters for a number of frames,
+			// checks the result against testing every light against every cluster,
+			// and logs how long assigning took per frame
+			static void LogAssignmentCost();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The GPU buffers are only created if i_shouldBuffersBeCreated is true
+			// (lights can be assigned without a device, but then they can't be bound)
+			bool Initialize( const sSettings& i_settings, const bool i_shouldBuffersBeCreated = true );
+			bool CleanUp();
+
+			ClusteredLights();
+			~ClusteredLights();
+
+			// Implementation
+			//===============
+
+		private:
+
+			enum eBuffer
+			{
+				ClusterBuffer,
+				LightIndexBuffer,
+				LightBuffer,
+
+				BufferCount
+			};
+
+			// This is the data needed to cull a light
+			// (the position is in view space)
+			struct sViewLight
+			{
+				float x, y, z;
+				float radiusSquared;
+				uint32_t sliceBegin, sliceEnd;
+			};
+
+			// This calculates the boxes around the clusters and the shader constants that don't depend on the camera
+			void CalculateClusterBoxes( const sView& i_view );
+			// This returns the slice that a view depth is in
+			// (depths in front of the first slice are in it and depths behind the last slice are in it)
+			unsigned int GetSlice( const float i_depth ) const;
+			// This tests every light against every cluster one at a time (and is only used to check and measure AssignLights())
+			void AssignLights_bruteForce( const sView& i_view, const sLight* const i_lights, const unsigned int i_lightCount,
+				std::vector<uint32_t>& o_clusterRanges, std::vector<uint16_t>& o_lightIndices ) const;
+
+			static void MoveLightsToViewBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+			static void AssignSlicesBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+
+			// Platform-specific
+			bool CreateBuffers();
+			bool DestroyBuffers();
+			bool UploadAndBindBuffers();
+
+			// Data
+			//=====
+
+		private:
+
+			sSettings m_settings;
+			sStats m_stats;
+			sConstants m_constants;
+
+			// The clusters' boxes in view space
+			// (the columns and rows are padded to a multiple of 4 with boxes that nothing can reach,
+			// and the boxes of each slice's columns and rows are stored one slice after another)
+			std::vector<float> m_columnMinimum, m_columnMaximum;
+			std::vector<float> m_rowMinimum, m_rowMaximum;
+			// These are the view depths where each slice starts (with one more for where the last slice ends)
+			std::vector<float> m_sliceDepths;
+			unsigned int m_paddedClusterCountX = 0, m_paddedClusterCountY = 0;
+			// The frustum the boxes were calculated for
+			float m_tangent_horizontal = 0.0f, m_tangent_vertical = 0.0f, m_zNear = 0.0f, m_zFar = 0.0f;
+
+			// The lights are copied so that they can be uploaded after the caller's array has changed
+			std::vector<sLight> m_lights;
+			// The view is stored so that the job batches can read it
+			sView m_view;
+			std::vector<sViewLight> m_viewLights;
+			// Each slice's distances from the current light to its columns and rows
+			std::vector<float> m_columnDistancesSquared, m_rowDistancesSquared;
+			// Every slice has its own list of the lights that might reach it, the clusters that each one did reach,
+			// its own light indices, and counts how many light indices it had to drop
+			std::vector<std::vector<uint16_t> > m_sliceLights;
+			std::vector<std::vector<uint32_t> > m_sliceHits;
+			std::vector<std::vector<uint16_t> > m_sliceLightIndices;
+			std::vector<unsigned int> m_droppedLightIndexCounts;
+
+			// The compacted result
+			std::vector<uint32_t> m_clusterRanges;
+			std::vector<uint16_t> m_lightIndices;
+
+			bool m_areBuffersCreated = false;
+			// This is only used for statistics
+			size_t m_bufferSize = 0;
+#if defined( EAE6320_PLATFORM_D3D )
+			ID3D11Buffer* m_constantBuffer = NULL;
+			ID3D11Buffer* m_buffers[BufferCount];
+			ID3D11ShaderResourceView* m_shaderResourceViews[BufferCount];
+#elif defined( EAE6320_PLATFORM_GL )
+			GLuint m_constantBufferId = 0;
+			GLuint m_bufferIds[BufferCount];
+			GLuint m_textureIds[BufferCount];
+#endif
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_CLUSTEREDLIGHTS_H
@@ -0,0 +1,185 @@
+// Header Files
+//=============
+
+#include "CommandList.h"
+
+#include "Mesh.h"
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	struct sBenchmarkJob
+	{
+		eae6320::Graphics::CommandList* commandLists;
+		eae6320::Graphics::Mesh* mesh;
+		unsigned int batchSize;
+	};
+	void RecordBenchmarkCommands( eae6320::Graphics::CommandList& io_commandList, eae6320::Graphics::Mesh& i_mesh,
+		const unsigned int i_commandCount );
+	void RecordBenchmarkCommands( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+}
+
+// Interface
+//==========
+
+// Record
+//-------
+
+void eae6320::Graphics::CommandList::BindEffect( const Material& i_material )
+{
+	sCommand command;
+	command.type = sCommand::BindEffect;
+	command.material = &i_material;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::CommandList::BindParameterBlock( const Material& i_material )
+{
+	sCommand command;
+	command.type = sCommand::BindParameterBlock;
+	command.material = &i_material;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::CommandList::BindTexture( const Texture& i_texture, const unsigned int i_textureUnit )
+{
+	EAE6320_ASSERT( i_textureUnit <= 0xff );
+	sCommand command;
+	command.type = sCommand::BindTexture;
+	command.textureUnit = static_cast<uint8_t>( i_textureUnit );
+	command.texture = &i_texture;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::CommandList::SetConstants( const eConstantBuffer::eConstantBuffer i_constantBuffer,
+	const void* const i_data, const uint32_t i_size )
+{
+	EAE6320_ASSERT( i_size <= s_maxConstantDataSize );
+	sCommand command;
+	command.type = sCommand::SetConstants;
+	command.constantBuffer = static_cast<uint8_t>( i_constantBuffer );
+	command.constantDataSize = static_cast<uint16_t>( i_size );
+	command.constantDataOffset = static_cast<uint32_t>( m_constantData.size() );
+	const uint8_t* const data = static_cast<const uint8_t*>( i_data );
+	m_constantData.insert( m_constantData.end(), data, data + i_size );
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::CommandList::DrawMesh( Mesh& i_mesh )
+{
+	sCommand command;
+	command.type = sCommand::DrawMesh;
+	command.mesh = &i_mesh;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::CommandList::DrawSkinnedMesh( SkinnedMesh& i_skinnedMesh )
+{
+	sCommand command;
+	command.type = sCommand::DrawSkinnedMesh;
+	command.skinnedMesh = &i_skinnedMesh;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::CommandList::DrawParticles( ParticleEmitter& i_emitter )
+{
+	sCommand command;
+	command.type = sCommand::DrawParticles;
+	command.emitter = &i_emitter;
+	m_commands.push_back( command );
+}
+
+void eae6320::Graphics::CommandList::DrawTerrain( Terrain& i_terrain )
+{
+	sCommand command;
+	command.type = sCommand::DrawTerrain;
+	command.terrain = &i_terrain;
+	m_commands.push_back( command );
+}
+
+// Benchmark
+//----------
+
+void eae6320::Graphics::CommandList::LogRecordingCost()
+{
+	// A typical draw sets some constants and then draws
+	const unsigned int commandCount = 1 << 20;
+	// The mesh is never drawn, and so it doesn't need to be initialized
+	Mesh mesh;
+
+	// One thread
+	double nanosecondsPerCommand_oneThread;
+	{
+		CommandList commandList;
+		// The first recording grows the list to its final size
+		// so that the second one measures what recording costs every frame
+		RecordBenchmarkCommands( commandList, mesh, commandCount );
+		commandList.Reset();
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		RecordBenchmarkCommands( commandList, mesh, commandCount );
+		const uint64_t tickCount_end = Time::GetCurrentSystemTimeTickCount();
+		nanosecondsPerCommand_oneThread = Time::ConvertTicksToSeconds( tickCount_end - tickCount_start ) * 1.0e9 / commandCount;
+	}
+	// Every thread (each recording its own list)
+	double nanosecondsPerCommand_everyThread;
+	const unsigned int threadCount = Jobs::GetWorkerThreadCount() + 1;
+	{
+		std::vector<CommandList> commandLists( threadCount );
+		sBenchmarkJob job;
+		job.commandLists = &commandLists[0];
+		job.mesh = &mesh;
+		job.batchSize = ( commandCount + threadCount - 1 ) / threadCount;
+		Jobs::ParallelFor( commandCount, job.batchSize, RecordBenchmarkCommands, &job );
+		for ( unsigned int i = 0; i < threadCount; ++i )
+		{
+			commandLists[i].Reset();
+		}
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		Jobs::ParallelFor( commandCount, job.batchSize, RecordBenchmarkCommands, &job );
+		const uint64_t tickCount_end = Time::GetCurrentSystemTimeTickCount();
+		nanosecondsPerCommand_everyThread = Time::ConvertTicksToSeconds( tickCount_end - tickCount_start ) * 1.0e9 / commandCount;
+	}
+
+	Logging::OutputMessage( "Recording %u commands took %.2f ns per command on one thread"
+		" and %.2f ns per command (%.2f ns per command per thread) on %u threads",
+		commandCount, nanosecondsPerCommand_oneThread,
+		nanosecondsPerCommand_everyThread, nanosecondsPerCommand_everyThread * threadCount, threadCount );
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+void eae6320::Graphics::CommandList::Reset()
+{
+	m_commands.clear();
+	m_constantData.clear();
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void RecordBenchmarkCommands( eae6320::Graphics::CommandList& io_commandList, eae6320::Graphics::Mesh& i_mesh,
+		const unsigned int i_commandCount )
+	{
+		const float constants[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for ( unsigned int i = 0; i < i_commandCount; i += 2 )
+		{
+			io_commandList.SetConstants( eae6320::Graphics::eConstantBuffer::Frame, constants, sizeof( constants ) );
+			io_commandList.DrawMesh( i_mesh );
+		}
+	}
+
+	void RecordBenchmarkCommands( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+	{
+		sBenchmarkJob& job = *static_cast<sBenchmarkJob*>( io_userData );
+		RecordBenchmarkCommands( job.commandLists[i_begin / job.batchSize], *job.mesh, i_end - i_begin );
+	}
+}
@@ -0,0 +1,150 @@
+/*
+	A command list records rendering commands so that they can be executed later
+
+	Commands are small POD structs that only refer to engine objects (materials, textures, meshes, skinned meshes, particle emitters)
+	and to constant data that is copied into the list,
+	and so recording a command doesn't touch the graphics API
+	and any thread can record its own list in parallel with the others.
+	The lists are then executed in order on the thread that owns the device,
+	where the platform-specific Execute() translates each command into API calls.
+
+	Reset() keeps the list's memory, and so once a list has grown to the size of a frame
+	recording a command is just a few stores.
+*/
+
+#ifndef EAE6320_GRAPHICS_COMMANDLIST_H
+#define EAE6320_GRAPHICS_COMMANDLIST_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Material;
+		class Mesh;
+		class ParticleEmitter;
+		class SkinnedMesh;
+		class Terrain;
+		class Texture;
+
+		// Each constant buffer is bound to the register (or binding point) with its value
+		namespace eConstantBuffer
+		{
+			enum eConstantBuffer
+			{
+				Frame,
+
+				Count
+			};
+		}
+
+		class CommandList
+		{
+		public:
+
+			// SetConstants() can't copy more than this
+			static const uint32_t s_maxConstantDataSize = 256;
+
+			// Record
+			//-------
+
+			void BindEffect( const Material& i_material );
+			void BindParameterBlock( const Material& i_material );
+			void BindTexture( const Texture& i_texture, const unsigned int i_textureUnit );
+			// The data is copied into the list, and so it doesn't need to stay valid
+			void SetConstants( const eConstantBuffer::eConstantBuffer i_constantBuffer, const void* const i_data, const uint32_t i_size );
+			void DrawMesh( Mesh& i_mesh );
+			void DrawSkinnedMesh( SkinnedMesh& i_skinnedMesh );
+			void DrawParticles( ParticleEmitter& i_emitter );
+			void DrawTerrain( Terrain& i_terrain );
+
+			// Execute
+			//--------
+
+			// This must be called on the thread that owns the device
+			void Execute() const;
+
+			// Access
+			//-------
+
+			size_t GetCommandCount() const { return m_commands.size(); }
+
+			// Benchmark
+			//----------
+
+			// This records commands (without executing them) on one thread and then on every worker thread
+			// and logs how long a command takes to record
+			static void LogRecordingCost();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// This forgets the commands but keeps the memory for the next time the list is recorded
+			void Reset();
+
+			// These create and destroy the constant buffers that SetConstants() writes to
+			static bool Initialize();
+			static bool CleanUp();
+
+			// Implementation
+			//===============
+
+		private:
+
+			// This is 16 bytes on x64 (and 12 on Win32)
+			struct sCommand
+			{
+				enum eType
+				{
+					BindEffect,
+					BindParameterBlock,
+					BindTexture,
+					SetConstants,
+					DrawMesh,
+					DrawSkinnedMesh,
+					DrawParticles,
+					DrawTerrain,
+				};
+				// This is an eType
+				uint8_t type;
+				// These are only used by SetConstants (and BindTexture uses the first byte for its texture unit);
+				// the constant buffer is an eConstantBuffer and the data is in m_constantData
+				union
+				{
+					uint8_t constantBuffer;
+					uint8_t textureUnit;
+				};
+				uint16_t constantDataSize;
+				uint32_t constantDataOffset;
+				union
+				{
+					const Material* material;
+					const Texture* texture;
+					Mesh* mesh;
+					SkinnedMesh* skinnedMesh;
+					ParticleEmitter* emitter;
+					Terrain* terrain;
+				};
+			};
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<sCommand> m_commands;
+			std::vector<uint8_t> m_constantData;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_COMMANDLIST_H
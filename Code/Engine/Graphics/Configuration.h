@@ -11,5 +11,46 @@
 	#define EAE6320_GRAPHICS_ISDEVICEDEBUGINFOENABLED
 #endif
 
+// When this is defined more than a million particles are simulated at initialization
+// and the cost of a frame with the SSE and the scalar simulation kernels is logged
+// (it is only meaningful in an optimized build)
+//#define EAE6320_GRAPHICS_SHOULDPARTICLESIMULATIONBEMEASURED
+
+// When this is defined the cost of recording command lists is measured and logged at initialization
+// (it is only meaningful in an optimized build)
+//#define EAE6320_GRAPHICS_SHOULDCOMMANDLISTRECORDINGBEMEASURED
+
+// When this is defined a screen full of text is laid out with the HUD's font at initialization
+// and the cost of laying it out and writing its vertices is logged
+//#define EAE6320_GRAPHICS_SHOULDTEXTLAYOUTBEMEASURED
+
+// When this is defined a mesh is split into clusters and culled from a moving camera at initialization,
+// and the triangles rejected per frame and the cost of culling are logged
+//#define EAE6320_GRAPHICS_SHOULDMESHCLUSTERCULLINGBEMEASURED
+
+// When this is defined many characters are animated and skinned at initialization
+// for skeletons of different sizes, and how many characters can be updated per millisecond is logged
+//#define EAE6320_GRAPHICS_SHOULDSKINNINGBEMEASURED
+
+// When this is defined thousands of moving lights are assigned to clusters at initialization,
+// checked against a brute-force assignment, and the cost of assigning per frame is logged
+//#define EAE6320_GRAPHICS_SHOULDCLUSTEREDLIGHTASSIGNMENTBEMEASURED
+
+// When this is defined OpenGL per-frame code calls glGetError() after GL calls
+// (which stalls on many drivers);
+// otherwise errors are only reported asynchronously by the driver's debug output
+// (see OpenGL/DebugOutput.h)
+//#define EAE6320_GRAPHICS_AREGLERRORSCHECKEDSYNCHRONOUSLY
+
+// When this is defined the CPU cost of a draw call with each kind of OpenGL error checking is measured and logged at initialization
+//#define EAE6320_GRAPHICS_SHOULDGLERRORCHECKINGBEMEASURED
+
+// Statistics about GPU memory and what the device does every frame (see Statistics.h)
+// are usually only tracked on debug builds
+// (this can be defined on every build to track them while profiling an optimized one)
+#ifdef _DEBUG
+	#define EAE6320_GRAPHICS_ARESTATISTICSTRACKED
+#endif
+
 #endif	// EAE6320_GRAPHICS_CONFIGURATION_H
 
@@ -0,0 +1,207 @@
+// Header Files
+//=============
+
+#include "../ClusteredLights.h"
+
+#include <cstring>
+#include "../Includes.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool CreateDynamicBuffer( const unsigned int i_byteCount, const D3D11_BIND_FLAG i_bindFlag, ID3D11Buffer*& o_buffer );
+	bool UploadToDynamicBuffer( ID3D11Buffer* const i_buffer, const void* const i_data, const size_t i_byteCount );
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::ClusteredLights::CreateBuffers()
+{
+	bool wereThereErrors = false;
+
+	// Every buffer is big enough for the most data that an assignment can have
+	const unsigned int clusterCount = GetClusterCount();
+	const unsigned int byteCounts[BufferCount] =
+	{
+		static_cast<unsigned int>( clusterCount * 2 * sizeof( uint32_t ) ),
+		static_cast<unsigned int>( clusterCount * m_settings.maxLightCountPerCluster * sizeof( uint16_t ) ),
+		static_cast<unsigned int>( m_settings.maxLightCount * sizeof( sLight ) ),
+	};
+	const DXGI_FORMAT formats[BufferCount] = { DXGI_FORMAT_R32G32_UINT, DXGI_FORMAT_R16_UINT, DXGI_FORMAT_R32G32B32A32_FLOAT };
+	const unsigned int elementCounts[BufferCount] = { clusterCount, clusterCount * m_settings.maxLightCountPerCluster, m_settings.maxLightCount * 2 };
+	const char* const bufferNames[BufferCount] = { "cluster", "light index", "light" };
+
+	if ( !CreateDynamicBuffer( sizeof( sConstants ), D3D11_BIND_CONSTANT_BUFFER, m_constantBuffer ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::ConstantBuffer, sizeof( sConstants ) ) );
+	for ( unsigned int i = 0; i < BufferCount; ++i )
+	{
+		if ( !CreateDynamicBuffer( byteCounts[i], D3D11_BIND_SHADER_RESOURCE, m_buffers[i] ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		m_bufferSize += byteCounts[i];
+		EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::ShaderResourceBuffer, byteCounts[i] ) );
+		// Shaders read the buffer as an array of typed elements (e.g. Buffer<uint2>)
+		D3D11_SHADER_RESOURCE_VIEW_DESC viewDescription;
+		{
+			memset( &viewDescription, 0, sizeof( viewDescription ) );
+			viewDescription.Format = formats[i];
+			viewDescription.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+			viewDescription.Buffer.FirstElement = 0;
+			viewDescription.Buffer.NumElements = elementCounts[i];
+		}
+		const HRESULT result = GetContext().direct3dDevice->CreateShaderResourceView( m_buffers[i], &viewDescription, &m_shaderResourceViews[i] );
+		if ( FAILED( result ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create the clustered %s buffer's shader resource view with HRESULT %#010x",
+				bufferNames[i], result );
+			goto OnExit;
+		}
+	}
+
+OnExit:
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::ClusteredLights::DestroyBuffers()
+{
+	for ( unsigned int i = 0; i < BufferCount; ++i )
+	{
+		if ( m_shaderResourceViews[i] )
+		{
+			m_shaderResourceViews[i]->Release();
+			m_shaderResourceViews[i] = NULL;
+		}
+		if ( m_buffers[i] )
+		{
+			m_buffers[i]->Release();
+			m_buffers[i] = NULL;
+		}
+	}
+	if ( m_bufferSize > 0 )
+	{
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::ShaderResourceBuffer, m_bufferSize ) );
+		m_bufferSize = 0;
+	}
+	if ( m_constantBuffer )
+	{
+		m_constantBuffer->Release();
+		m_constantBuffer = NULL;
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::ConstantBuffer, sizeof( sConstants ) ) );
+	}
+	return true;
+}
+
+bool eae6320::Graphics::ClusteredLights::UploadAndBindBuffers()
+{
+	// Only as much as the current assignment uses is written
+	const void* const data[BufferCount] =
+	{
+		m_clusterRanges.empty() ? NULL : &m_clusterRanges[0],
+		m_lightIndices.empty() ? NULL : &m_lightIndices[0],
+		m_lights.empty() ? NULL : &m_lights[0],
+	};
+	const size_t byteCounts[BufferCount] =
+	{
+		m_clusterRanges.size() * sizeof( uint32_t ),
+		m_lightIndices.size() * sizeof( uint16_t ),
+		m_lights.size() * sizeof( sLight ),
+	};
+	if ( !UploadToDynamicBuffer( m_constantBuffer, &m_constants, sizeof( m_constants ) ) )
+	{
+		return false;
+	}
+	for ( unsigned int i = 0; i < BufferCount; ++i )
+	{
+		if ( !UploadToDynamicBuffer( m_buffers[i], data[i], byteCounts[i] ) )
+		{
+			return false;
+		}
+	}
+
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	{
+		const unsigned int bufferCount = 1;
+		direct3dImmediateContext->VSSetConstantBuffers( s_constantBufferRegister, bufferCount, &m_constantBuffer );
+		direct3dImmediateContext->PSSetConstantBuffers( s_constantBufferRegister, bufferCount, &m_constantBuffer );
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( bufferCount * 2 ) );
+	}
+	// The registers are consecutive
+	{
+		EAE6320_ASSERT( ( s_lightIndexTextureUnit == ( s_clusterTextureUnit + 1 ) ) && ( s_lightTextureUnit == ( s_clusterTextureUnit + 2 ) ) );
+		direct3dImmediateContext->VSSetShaderResources( s_clusterTextureUnit, BufferCount, m_shaderResourceViews );
+		direct3dImmediateContext->PSSetShaderResources( s_clusterTextureUnit, BufferCount, m_shaderResourceViews );
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( BufferCount * 2 ) );
+	}
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool CreateDynamicBuffer( const unsigned int i_byteCount, const D3D11_BIND_FLAG i_bindFlag, ID3D11Buffer*& o_buffer )
+	{
+		D3D11_BUFFER_DESC bufferDescription = { 0 };
+		{
+			bufferDescription.ByteWidth = i_byteCount;
+			bufferDescription.Usage = D3D11_USAGE_DYNAMIC;	// The CPU writes the assignment every frame
+			bufferDescription.BindFlags = i_bindFlag;
+			bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			bufferDescription.MiscFlags = 0;
+			bufferDescription.StructureByteStride = 0;	// Not used
+		}
+		const D3D11_SUBRESOURCE_DATA* const noInitialData = NULL;
+		const HRESULT result = eae6320::Graphics::GetContext().direct3dDevice->CreateBuffer( &bufferDescription, noInitialData, &o_buffer );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			eae6320::Logging::OutputError( "Direct3D failed to create a clustered light buffer with HRESULT %#010x", result );
+			return false;
+		}
+		return true;
+	}
+
+	bool UploadToDynamicBuffer( ID3D11Buffer* const i_buffer, const void* const i_data, const size_t i_byteCount )
+	{
+		// Discarding lets the driver hand back fresh memory
+		// instead of waiting for the GPU to finish reading last frame's lights
+		ID3D11DeviceContext* const direct3dImmediateContext = eae6320::Graphics::GetContext().direct3dImmediateContext;
+		D3D11_MAPPED_SUBRESOURCE mappedSubResource;
+		const unsigned int noSubResources = 0;
+		const D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD;
+		const unsigned int noFlags = 0;
+		const HRESULT result = direct3dImmediateContext->Map( i_buffer, noSubResources, mapType, noFlags, &mappedSubResource );
+		if ( SUCCEEDED( result ) )
+		{
+			if ( i_byteCount > 0 )
+			{
+				memcpy( mappedSubResource.pData, i_data, i_byteCount );
+			}
+			direct3dImmediateContext->Unmap( i_buffer, noSubResources );
+			EAE6320_GRAPHICS_STATISTICS( CountUpload( i_byteCount ) );
+			return true;
+		}
+		else
+		{
+			EAE6320_ASSERT( false );
+			eae6320::Logging::OutputError( "Direct3D failed to map a clustered light buffer with HRESULT %#010x", result );
+			return false;
+		}
+	}
+}
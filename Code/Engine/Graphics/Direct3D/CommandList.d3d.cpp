@@ -0,0 +1,137 @@
+// Header Files
+//=============
+
+#include "../CommandList.h"
+
+#include <cstring>
+#include "../Includes.h"
+#include "../Material.h"
+#include "../Mesh.h"
+#include "../ParticleEmitter.h"
+#include "../SkinnedMesh.h"
+#include "../Terrain.h"
+#include "../Texture.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// SetConstants() writes to these
+	ID3D11Buffer* s_constantBuffers[eae6320::Graphics::eConstantBuffer::Count] = { NULL };
+}
+
+// Interface
+//==========
+
+// Execute
+//--------
+
+void eae6320::Graphics::CommandList::Execute() const
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	for ( std::vector<sCommand>::const_iterator i = m_commands.begin(); i != m_commands.end(); ++i )
+	{
+		switch ( i->type )
+		{
+		case sCommand::BindEffect:
+			i->material->BindEffect();
+			break;
+		case sCommand::BindParameterBlock:
+			i->material->BindParameterBlock();
+			break;
+		case sCommand::BindTexture:
+			i->texture->Bind( i->textureUnit );
+			break;
+		case sCommand::SetConstants:
+			{
+				ID3D11Buffer* const constantBuffer = s_constantBuffers[i->constantBuffer];
+				// Discard previous contents when writing
+				D3D11_MAPPED_SUBRESOURCE mappedSubResource;
+				const unsigned int noSubResources = 0;
+				const D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD;
+				const unsigned int noFlags = 0;
+				const HRESULT result = direct3dImmediateContext->Map( constantBuffer, noSubResources, mapType, noFlags, &mappedSubResource );
+				if ( SUCCEEDED( result ) )
+				{
+					memcpy( mappedSubResource.pData, &m_constantData[i->constantDataOffset], i->constantDataSize );
+					direct3dImmediateContext->Unmap( constantBuffer, noSubResources );
+					EAE6320_GRAPHICS_STATISTICS( CountUpload( i->constantDataSize ) );
+				}
+				else
+				{
+					EAE6320_ASSERT( false );
+				}
+				// Each constant buffer's register is its eConstantBuffer value
+				const unsigned int registerAssignedInShader = i->constantBuffer;
+				const unsigned int bufferCount = 1;
+				direct3dImmediateContext->VSSetConstantBuffers( registerAssignedInShader, bufferCount, &constantBuffer );
+				direct3dImmediateContext->PSSetConstantBuffers( registerAssignedInShader, bufferCount, &constantBuffer );
+				EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( bufferCount * 2 ) );
+			}
+			break;
+		case sCommand::DrawMesh:
+			i->mesh->Draw();
+			break;
+		case sCommand::DrawSkinnedMesh:
+			i->skinnedMesh->Draw();
+			break;
+		case sCommand::DrawParticles:
+			i->emitter->Draw();
+			break;
+		case sCommand::DrawTerrain:
+			i->terrain->Draw();
+			break;
+		default:
+			EAE6320_ASSERTF( false, "Invalid command type" );
+		}
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::CommandList::Initialize()
+{
+	for ( unsigned int i = 0; i < eConstantBuffer::Count; ++i )
+	{
+		D3D11_BUFFER_DESC bufferDescription = { 0 };
+		{
+			// The byte width must be a multiple of 16,
+			// and every constant buffer is big enough for any SetConstants()
+			bufferDescription.ByteWidth = s_maxConstantDataSize;
+			bufferDescription.Usage = D3D11_USAGE_DYNAMIC;	// The CPU must be able to update the buffer
+			bufferDescription.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+			bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;	// The CPU must write, but doesn't read
+			bufferDescription.MiscFlags = 0;
+			bufferDescription.StructureByteStride = 0;	// Not used
+		}
+		const D3D11_SUBRESOURCE_DATA* const noInitialData = NULL;
+		const HRESULT result = GetContext().direct3dDevice->CreateBuffer( &bufferDescription, noInitialData, &s_constantBuffers[i] );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a constant buffer with HRESULT %#010x", result );
+			return false;
+		}
+		EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::ConstantBuffer, s_maxConstantDataSize ) );
+	}
+	return true;
+}
+
+bool eae6320::Graphics::CommandList::CleanUp()
+{
+	for ( unsigned int i = 0; i < eConstantBuffer::Count; ++i )
+	{
+		if ( s_constantBuffers[i] )
+		{
+			s_constantBuffers[i]->Release();
+			s_constantBuffers[i] = NULL;
+			EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::ConstantBuffer, s_maxConstantDataSize ) );
+		}
+	}
+	return true;
+}
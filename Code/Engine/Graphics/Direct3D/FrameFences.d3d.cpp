@@ -0,0 +1,110 @@
+// Header Files
+//=============
+
+#include "../FrameFences.h"
+
+#include "../Includes.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// An event query is "ended" after a frame is presented
+	// and its data becomes available when the GPU has processed every command before it
+	ID3D11Query* s_fences[eae6320::Graphics::FrameFences::s_maxFrameCountInFlight] = { NULL };
+}
+
+// Interface
+//==========
+
+// Deferred Deletion
+//------------------
+
+void eae6320::Graphics::FrameFences::DeferRelease( IUnknown* const i_resource )
+{
+	if ( i_resource )
+	{
+		sResource resource;
+		resource.resource = i_resource;
+		Defer( resource );
+	}
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::FrameFences::CreateFences()
+{
+	D3D11_QUERY_DESC queryDescription;
+	{
+		queryDescription.Query = D3D11_QUERY_EVENT;
+		queryDescription.MiscFlags = 0;
+	}
+	for ( unsigned int i = 0; i < s_maxFrameCountInFlight; ++i )
+	{
+		const HRESULT result = GetContext().direct3dDevice->CreateQuery( &queryDescription, &s_fences[i] );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a frame fence query with HRESULT %#010x", result );
+			DestroyFences();
+			return false;
+		}
+	}
+	return true;
+}
+
+void eae6320::Graphics::FrameFences::DestroyFences()
+{
+	for ( unsigned int i = 0; i < s_maxFrameCountInFlight; ++i )
+	{
+		if ( s_fences[i] )
+		{
+			s_fences[i]->Release();
+			s_fences[i] = NULL;
+		}
+	}
+}
+
+bool eae6320::Graphics::FrameFences::InsertFence( const unsigned int i_fenceIndex )
+{
+	EAE6320_ASSERT( s_fences[i_fenceIndex] );
+	GetContext().direct3dImmediateContext->End( s_fences[i_fenceIndex] );
+	return true;
+}
+
+bool eae6320::Graphics::FrameFences::IsFenceSignaled( const unsigned int i_fenceIndex )
+{
+	// The fence is only polled, and so the command buffer isn't flushed
+	// (the next Present() will flush it)
+	const HRESULT result = GetContext().direct3dImmediateContext->GetData( s_fences[i_fenceIndex], NULL, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH );
+	// If getting the data fails the fence would never be signaled,
+	// and so it is treated as if it were rather than leaking everything that is deferred after it
+	EAE6320_ASSERT( SUCCEEDED( result ) );
+	return result != S_FALSE;
+}
+
+void eae6320::Graphics::FrameFences::WaitForFence( const unsigned int i_fenceIndex )
+{
+	// Direct3D 11 can't block on a query, and so it is polled until the GPU catches up
+	const unsigned int flushIfNecessary = 0;
+	HRESULT result;
+	do
+	{
+		result = GetContext().direct3dImmediateContext->GetData( s_fences[i_fenceIndex], NULL, 0, flushIfNecessary );
+	} while ( result == S_FALSE );
+	EAE6320_ASSERT( SUCCEEDED( result ) );
+}
+
+void eae6320::Graphics::FrameFences::ReleaseFence( const unsigned int )
+{
+	// Queries are reused, and so there is nothing to release
+}
+
+void eae6320::Graphics::FrameFences::DeleteResource( const sResource& i_resource )
+{
+	i_resource.resource->Release();
+}
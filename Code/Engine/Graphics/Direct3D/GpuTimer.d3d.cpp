@@ -0,0 +1,140 @@
+// Header Files
+//=============
+
+#include "../GpuTimer.h"
+
+#include "../Includes.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Direct3D 11 timestamps are only meaningful inside of a "disjoint" query,
+	// which also provides the frequency that they are in
+	struct sQuery
+	{
+		ID3D11Query* disjoint;
+		ID3D11Query* timestamp_begin;
+		ID3D11Query* timestamp_end;
+	};
+	sQuery s_queries[eae6320::Graphics::GpuTimer::s_queryCount] = { 0 };
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::GpuTimer::CreateQueries()
+{
+	ID3D11Device* const direct3dDevice = GetContext().direct3dDevice;
+	D3D11_QUERY_DESC disjointDescription;
+	{
+		disjointDescription.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+		disjointDescription.MiscFlags = 0;
+	}
+	D3D11_QUERY_DESC timestampDescription;
+	{
+		timestampDescription.Query = D3D11_QUERY_TIMESTAMP;
+		timestampDescription.MiscFlags = 0;
+	}
+	for ( unsigned int i = 0; i < s_queryCount; ++i )
+	{
+		sQuery& query = s_queries[i];
+		HRESULT result = direct3dDevice->CreateQuery( &disjointDescription, &query.disjoint );
+		if ( SUCCEEDED( result ) )
+		{
+			result = direct3dDevice->CreateQuery( &timestampDescription, &query.timestamp_begin );
+		}
+		if ( SUCCEEDED( result ) )
+		{
+			result = direct3dDevice->CreateQuery( &timestampDescription, &query.timestamp_end );
+		}
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a GPU timer query with HRESULT %#010x", result );
+			DestroyQueries();
+			return false;
+		}
+	}
+	return true;
+}
+
+void eae6320::Graphics::GpuTimer::DestroyQueries()
+{
+	for ( unsigned int i = 0; i < s_queryCount; ++i )
+	{
+		sQuery& query = s_queries[i];
+		if ( query.disjoint )
+		{
+			query.disjoint->Release();
+			query.disjoint = NULL;
+		}
+		if ( query.timestamp_begin )
+		{
+			query.timestamp_begin->Release();
+			query.timestamp_begin = NULL;
+		}
+		if ( query.timestamp_end )
+		{
+			query.timestamp_end->Release();
+			query.timestamp_end = NULL;
+		}
+	}
+}
+
+void eae6320::Graphics::GpuTimer::BeginQuery( const unsigned int i_queryIndex )
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	const sQuery& query = s_queries[i_queryIndex];
+	direct3dImmediateContext->Begin( query.disjoint );
+	// A timestamp query only has an end
+	direct3dImmediateContext->End( query.timestamp_begin );
+}
+
+void eae6320::Graphics::GpuTimer::EndQuery( const unsigned int i_queryIndex )
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	const sQuery& query = s_queries[i_queryIndex];
+	direct3dImmediateContext->End( query.timestamp_end );
+	direct3dImmediateContext->End( query.disjoint );
+}
+
+bool eae6320::Graphics::GpuTimer::GetQueryResult( const unsigned int i_queryIndex, bool& o_isValid, double& o_secondCount )
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	const sQuery& query = s_queries[i_queryIndex];
+	// The queries are only polled, and so the command buffer isn't flushed
+	// (the next Present() will flush it)
+	const unsigned int dontFlush = D3D11_ASYNC_GETDATA_DONOTFLUSH;
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData;
+	HRESULT result = direct3dImmediateContext->GetData( query.disjoint, &disjointData, sizeof( disjointData ), dontFlush );
+	if ( result == S_FALSE )
+	{
+		return false;
+	}
+	// If getting the data fails the queries would never be available,
+	// and so they are treated as if they were but can't be used
+	o_isValid = SUCCEEDED( result ) && !disjointData.Disjoint && ( disjointData.Frequency > 0 );
+	o_secondCount = 0.0;
+	if ( o_isValid )
+	{
+		// The timestamps were written before the disjoint query ended,
+		// and so they are available too
+		UINT64 timestamp_begin = 0, timestamp_end = 0;
+		result = direct3dImmediateContext->GetData( query.timestamp_begin, &timestamp_begin, sizeof( timestamp_begin ), dontFlush );
+		if ( result == S_OK )
+		{
+			result = direct3dImmediateContext->GetData( query.timestamp_end, &timestamp_end, sizeof( timestamp_end ), dontFlush );
+		}
+		o_isValid = ( result == S_OK ) && ( timestamp_end >= timestamp_begin );
+		if ( o_isValid )
+		{
+			o_secondCount = static_cast<double>( timestamp_end - timestamp_begin ) / static_cast<double>( disjointData.Frequency );
+		}
+	}
+	EAE6320_ASSERT( SUCCEEDED( result ) );
+	return true;
+}
@@ -10,10 +10,11 @@
 #include <D3DX11core.h>
 #include <DXGI.h>
 #include <vector>
+#include "../CommandList.h"
 #include "../Includes.h"
+#include "../MeshClusters.h"
 #include "../../Asserts/Asserts.h"
 #include "../../Logging/Logging.h"
-#include "../../Time/Time.h"
 
 // Static Data Initialization
 //===========================
@@ -27,46 +28,15 @@ namespace
 	IDXGISwapChain* s_swapChain = NULL;
 	ID3D11DeviceContext* s_direct3dImmediateContext = NULL;
 	ID3D11RenderTargetView* s_renderTargetView = NULL;
+	unsigned int s_resolutionWidth = 0, s_resolutionHeight = 0;
 
-	//The list of renderables to be drawn
-	std::vector <eae6320::Graphics::Mesh *> s_listOfRenderables;
-	
-	// D3D has an "input layout" object that associates the layout of the struct above
-	// with the input from a vertex shader
-	ID3D11InputLayout* s_vertexLayout = NULL;
+	eae6320::Graphics::ePresentMode::ePresentMode s_presentMode = eae6320::Graphics::ePresentMode::VSync;
+	// This is DXGI's default maximum frame latency
+	const unsigned int s_maxQueuedFrameCount_default = 3;
+	const unsigned int s_maxQueuedFrameCount_lowLatency = 1;
 
 	// The vertex buffer holds the data for each vertex
 	//ID3D11Buffer* s_vertexBuffer = NULL;
-
-	// The vertex shader is a program that operates on vertices.
-	// Its input comes from a C/C++ "draw call" and is:
-	//	* Position
-	//	* Any other data we want
-	// Its output is:
-	//	* Position
-	//		(So that the graphics hardware knows which pixels to fill in for the triangle)
-	//	* Any other data we want
-	ID3D11VertexShader* s_vertexShader = NULL;
-	// The fragment shader is a program that operates on fragments
-	// (or potential pixels).
-	// Its input is:
-	//	* The data that was output from the vertex shader,
-	//		interpolated based on how close the fragment is
-	//		to each vertex in the triangle.
-	// Its output is:
-	//	* The final color that the pixel should be
-	ID3D11PixelShader* s_fragmentShader = NULL;
-
-	// This struct determines the layout of the constant data that the CPU will send to the GPU
-	struct
-	{
-		union
-		{
-			float g_elapsedSecondCount_total;
-			float register0[4];	// You won't have to worry about why I do this until a later assignment
-		};
-	} s_constantBufferData;
-	ID3D11Buffer* s_constantBuffer = NULL;
 }
 
 // Helper Function Declarations
@@ -74,142 +44,105 @@ namespace
 
 namespace
 {
-	bool CreateConstantBuffer();
 	bool CreateDevice( const unsigned int i_resolutionWidth, const unsigned int i_resolutionHeight );
-	bool CreateVertexBufferLayout( ID3D10Blob& i_compiledShader );
 	bool CreateView( const unsigned int i_resolutionWidth, const unsigned int i_resolutionHeight );
-	bool LoadFragmentShader();
-	bool LoadVertexShader( ID3D10Blob*& o_compiledShader );
 }
 
 // Interface
 //==========
 
-// Submit to Draw
-//-------
-
-void eae6320::Graphics::SubmitObject(eae6320::Graphics::Mesh * object)
-{
-	s_listOfRenderables.push_back(object);
-}
-
 // Render
 //-------
 
 void eae6320::Graphics::RenderFrame()
 {
-	// Every frame an entirely new image will be created.
-	// Before drawing anything, then, the previous image will be erased
-	// by "clearing" the image buffer (filling it with a solid color)
+	BeginFrameWork();
+
+	// Create the GPU resources of assets that have finished loading asynchronously
+	// (before the texture streamer so that streamed textures are registered with it this frame)
+	AssetLoader::Update();
+	// Submit the copies of everything that was written to staging memory since the previous frame
+	// (before the texture streamer changes which mips of the new textures are resident)
+	UploadManager::Flush();
+	// Upload any texture mips that have been streamed in
+	// and decide which mips to stream in or evict based on what was needed last frame
+	TextureStreamer::Update();
+
+	// Specify what kind of data the vertex buffer holds
+	// (the layout, which defines how to interpret a single vertex, is set by each material)
 	{
-		// Black is usually used
-		float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
-		s_direct3dImmediateContext->ClearRenderTargetView( s_renderTargetView, clearColor );
+		// Set the topology (which defines how to interpret multiple vertices as a single "primitive";
+		// we have defined the vertex buffer as a triangle list
+		// (meaning that every primitive is a triangle and will be defined by three vertices)
+		s_direct3dImmediateContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
 	}
 
-	// Update the constant buffer
+	// Clear the back buffer and draw the geometry
 	{
-		// Update the struct (i.e. the memory that we own)
-		s_constantBufferData.g_elapsedSecondCount_total = Time::GetElapsedSecondCount_total();
-		// Get a pointer from Direct3D that can be written to
-		void* memoryToWriteTo = NULL;
-		{
-			D3D11_MAPPED_SUBRESOURCE mappedSubResource;
-			{
-				// Discard previous contents when writing
-				const unsigned int noSubResources = 0;
-				const D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD;
-				const unsigned int noFlags = 0;
-				const HRESULT result = s_direct3dImmediateContext->Map( s_constantBuffer, noSubResources, mapType, noFlags, &mappedSubResource );
-				if ( SUCCEEDED( result ) )
-				{
-					memoryToWriteTo = mappedSubResource.pData;
-				}
-				else
-				{
-					EAE6320_ASSERT( false );
-				}
-			}
-		}
-		if ( memoryToWriteTo )
-		{
-			// Copy the new data to the memory that Direct3D has provided
-			memcpy( memoryToWriteTo, &s_constantBufferData, sizeof( s_constantBufferData ) );
-			// Let Direct3D know that the memory contains the data
-			// (the pointer will be invalid after this call)
-			const unsigned int noSubResources = 0;
-			s_direct3dImmediateContext->Unmap( s_constantBuffer, noSubResources );
-			memoryToWriteTo = NULL;
-		}
-		// Bind the constant buffer to the shader
-		{
-			const unsigned int registerAssignedInShader = 0;
-			const unsigned int bufferCount = 1;
-			s_direct3dImmediateContext->VSSetConstantBuffers( registerAssignedInShader, bufferCount, &s_constantBuffer );
-			s_direct3dImmediateContext->PSSetConstantBuffers( registerAssignedInShader, bufferCount, &s_constantBuffer );
-		}
+		sTargetDescription backBufferDescription;
+		backBufferDescription.width = static_cast<uint16_t>( s_resolutionWidth );
+		backBufferDescription.height = static_cast<uint16_t>( s_resolutionHeight );
+		backBufferDescription.format = eTargetFormat::R8G8B8A8;
+		const bool wasGraphExecuted = ExecuteRenderGraph( backBufferDescription );
+		EAE6320_ASSERT( wasGraphExecuted );
 	}
+	EndFrameWork();
 
-	// Draw the geometry
-	{
-		// Set the vertex and fragment shaders
-		{
-			ID3D11ClassInstance** const noInterfaces = NULL;
-			const unsigned int interfaceCount = 0;
-			s_direct3dImmediateContext->VSSetShader( s_vertexShader, noInterfaces, interfaceCount );
-			s_direct3dImmediateContext->PSSetShader( s_fragmentShader, noInterfaces, interfaceCount );
-		}
-/*
-		// Bind a specific vertex buffer to the device as a data source
-		{
-			const unsigned int startingSlot = 0;
-			const unsigned int vertexBufferCount = 1;
-			// The "stride" defines how large a single vertex is in the stream of data
-			const unsigned int bufferStride = sizeof( sVertex );
-			// It's possible to start streaming data in the middle of a vertex buffer
-			const unsigned int bufferOffset = 0;
-			s_direct3dImmediateContext->IASetVertexBuffers( startingSlot, vertexBufferCount, &s_vertexBuffer, &bufferStride, &bufferOffset );
-		}
-*/
-
-		
-
-		// Specify what kind of data the vertex buffer holds
-		{
-			// Set the layout (which defines how to interpret a single vertex)
-			s_direct3dImmediateContext->IASetInputLayout( s_vertexLayout );
-			// Set the topology (which defines how to interpret multiple vertices as a single "primitive";
-			// we have defined the vertex buffer as a triangle list
-			// (meaning that every primitive is a triangle and will be defined by three vertices)
-			s_direct3dImmediateContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-		}
-/*		// Render triangles from the currently-bound vertex buffer
-		{
-			// As of this comment we are only drawing a single triangle
-			// (you will have to update this code in future assignments!)
-			const unsigned int triangleCount = 2;
-			const unsigned int vertexCountPerTriangle = 3;
-			const unsigned int vertexCountToRender = triangleCount * vertexCountPerTriangle;
-			// It's possible to start rendering primitives in the middle of the stream
-			const unsigned int indexOfFirstVertexToRender = 0;
-			s_direct3dImmediateContext->Draw( vertexCountToRender, indexOfFirstVertexToRender );
-		}
-*/
-		for (std::vector<Mesh *>::iterator i = s_listOfRenderables.begin(); i != s_listOfRenderables.end(); ++i)
-		{
-			(*i)->Draw();
-		}
-		s_listOfRenderables.clear();
-	}
 	// Everything has been drawn to the "back buffer", which is just an image in memory.
 	// In order to display it the contents of the back buffer must be "presented"
 	// (to the front buffer)
 	{
+		const bool shouldWaitForVerticalBlank = ( s_presentMode == ePresentMode::VSync ) || ( s_presentMode == ePresentMode::LowLatency );
 		const unsigned int swapImmediately = 0;
+		const unsigned int swapOnVerticalBlank = 1;
+		const unsigned int syncInterval = shouldWaitForVerticalBlank ? swapOnVerticalBlank : swapImmediately;
 		const unsigned int presentNextFrame = 0;
-		const HRESULT result = s_swapChain->Present( swapImmediately, presentNextFrame );
+		const HRESULT result = s_swapChain->Present( syncInterval, presentNextFrame );
 		EAE6320_ASSERT( SUCCEEDED( result ) );
 	}
+	// Resources that were deferred during frames that the GPU has finished are released
+	FrameFences::EndFrame();
+	EAE6320_GRAPHICS_STATISTICS( EndFrame() );
+}
+
+// Presentation
+//-------------
+
+bool eae6320::Graphics::SetPresentMode( const ePresentMode::ePresentMode i_presentMode )
+{
+	EAE6320_ASSERT( i_presentMode < ePresentMode::Count );
+	s_presentMode = i_presentMode;
+
+	// Present() waits when the CPU gets too far ahead of the GPU
+	IDXGIDevice1* dxgiDevice = NULL;
+	{
+		const HRESULT result = s_direct3dDevice->QueryInterface( __uuidof( IDXGIDevice1 ), reinterpret_cast<void**>( &dxgiDevice ) );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to get the DXGI device with HRESULT %#010x", result );
+			return false;
+		}
+	}
+	const HRESULT result = dxgiDevice->SetMaximumFrameLatency( GetMaxQueuedFrameCount() );
+	dxgiDevice->Release();
+	if ( FAILED( result ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "DXGI failed to set the maximum frame latency with HRESULT %#010x", result );
+		return false;
+	}
+	return true;
+}
+
+eae6320::Graphics::ePresentMode::ePresentMode eae6320::Graphics::GetPresentMode()
+{
+	return s_presentMode;
+}
+
+unsigned int eae6320::Graphics::GetMaxQueuedFrameCount()
+{
+	return ( s_presentMode == ePresentMode::LowLatency ) ? s_maxQueuedFrameCount_lowLatency : s_maxQueuedFrameCount_default;
 }
 
 // Initialization / Clean Up
@@ -220,7 +153,8 @@ bool eae6320::Graphics::Initialize( const sInitializationParameters& i_initializ
 	bool wereThereErrors = false;
 
 	s_renderingWindow = i_initializationParameters.mainWindow;
-	ID3D10Blob* compiledVertexShader = NULL;
+	s_resolutionWidth = i_initializationParameters.resolutionWidth;
+	s_resolutionHeight = i_initializationParameters.resolutionHeight;
 
 	// Create an interface to a Direct3D device
 	if ( !CreateDevice( i_initializationParameters.resolutionWidth, i_initializationParameters.resolutionHeight ) )
@@ -236,44 +170,66 @@ bool eae6320::Graphics::Initialize( const sInitializationParameters& i_initializ
 		goto OnExit;
 	}
 
+	GraphicsContext context;
+	context.direct3dDevice = s_direct3dDevice;
+	context.direct3dImmediateContext = s_direct3dImmediateContext;
+	context.backBufferView = s_renderTargetView;
+	CreateNewGraphicsContext(context);
+	EAE6320_GRAPHICS_STATISTICS( Initialize( i_initializationParameters.statisticsLogPeriodInFrames ) );
+	if ( !FrameFences::Initialize() )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
 	// Initialize the graphics objects
-	if ( !LoadVertexShader( compiledVertexShader ) )
+	if ( !CommandList::Initialize() )
 	{
 		wereThereErrors = true;
 		goto OnExit;
 	}
-	if ( !CreateVertexBufferLayout( *compiledVertexShader ) )
+#ifdef EAE6320_GRAPHICS_SHOULDPARTICLESIMULATIONBEMEASURED
+	ParticleEmitter::LogSimulationCost();
+#endif
+#ifdef EAE6320_GRAPHICS_SHOULDCOMMANDLISTRECORDINGBEMEASURED
+	CommandList::LogRecordingCost();
+#endif
+#ifdef EAE6320_GRAPHICS_SHOULDMESHCLUSTERCULLINGBEMEASURED
+	MeshClusters::LogCullingCost();
+#endif
+#ifdef EAE6320_GRAPHICS_SHOULDSKINNINGBEMEASURED
+	SkinnedMesh::LogSkinningCost();
+#endif
+#ifdef EAE6320_GRAPHICS_SHOULDCLUSTEREDLIGHTASSIGNMENTBEMEASURED
+	ClusteredLights::LogAssignmentCost();
+#endif
+	if ( !UploadManager::Initialize( i_initializationParameters.uploadManagerSettings ) )
 	{
 		wereThereErrors = true;
 		goto OnExit;
 	}
-	if ( !LoadFragmentShader() )
+	if ( !TextureStreamer::Initialize( i_initializationParameters.textureStreamerSettings ) )
 	{
 		wereThereErrors = true;
 		goto OnExit;
 	}
-	if ( !CreateConstantBuffer() )
+	if ( !AssetLoader::Initialize( i_initializationParameters.assetLoaderSettings ) )
 	{
 		wereThereErrors = true;
 		goto OnExit;
 	}
-	GraphicsContext context;
-	context.direct3dDevice = s_direct3dDevice;
-	context.direct3dImmediateContext = s_direct3dImmediateContext;
-	CreateNewGraphicsContext(context);
-
-OnExit:
-
-	// A vertex shader object is used to render the triangle.
-	// The compiled vertex shader is the actual compiled code,
-	// and once it has been used to create the vertex input layout
-	// it can be freed.
-	if ( compiledVertexShader )
+	if ( !InitializeRenderGraph( i_initializationParameters.dynamicResolutionSettings ) )
 	{
-		compiledVertexShader->Release();
-		compiledVertexShader = NULL;
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	if ( !SetPresentMode( i_initializationParameters.presentMode ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
 	}
 
+OnExit:
+
 	return !wereThereErrors;
 }
 
@@ -281,36 +237,49 @@ bool eae6320::Graphics::CleanUp()
 {
 	bool wereThereErrors = false;
 
+	if ( !AssetLoader::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	if ( !TextureStreamer::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	if ( !CleanUpRenderGraph() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	if ( !CommandList::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	if ( !UploadManager::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	// This waits for the GPU to finish,
+	// and so anything that is still queued for deletion can be released
+	if ( !FrameFences::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	// Every graphics object should have been cleaned up by now
+	EAE6320_GRAPHICS_STATISTICS( CleanUp() );
+
 	if ( s_direct3dDevice )
 	{
-		if ( s_vertexLayout )
-		{
-			s_vertexLayout->Release();
-			s_vertexLayout = NULL;
-		}
 		/*if ( s_vertexBuffer )
 		{
 			s_vertexBuffer->Release();
 			s_vertexBuffer = NULL;
 		}*/
 
-		if ( s_vertexShader )
-		{
-			s_vertexShader->Release();
-			s_vertexShader = NULL;
-		}
-		if ( s_fragmentShader )
-		{
-			s_fragmentShader->Release();
-			s_fragmentShader = NULL;
-		}
-
-		if ( s_constantBuffer )
-		{
-			s_constantBuffer->Release();
-			s_constantBuffer = NULL;
-		}
-
 		if ( s_renderTargetView )
 		{
 			s_renderTargetView->Release();
@@ -341,39 +310,6 @@ bool eae6320::Graphics::CleanUp()
 
 namespace
 {
-	bool CreateConstantBuffer()
-	{
-		D3D11_BUFFER_DESC bufferDescription = { 0 };
-		{
-			// The byte width must be rounded up to a multiple of 16
-			bufferDescription.ByteWidth = sizeof( s_constantBufferData );
-			bufferDescription.Usage = D3D11_USAGE_DYNAMIC;	// The CPU must be able to update the buffer
-			bufferDescription.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-			bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;	// The CPU must write, but doesn't read
-			bufferDescription.MiscFlags = 0;
-			bufferDescription.StructureByteStride = 0;	// Not used
-		}
-		D3D11_SUBRESOURCE_DATA initialData = { 0 };
-		{
-			// Fill in the constant buffer
-			s_constantBufferData.g_elapsedSecondCount_total = eae6320::Time::GetElapsedSecondCount_total();
-			initialData.pSysMem = &s_constantBufferData;
-			// (The other data members are ignored for non-texture buffers)
-		}
-
-		const HRESULT result = s_direct3dDevice->CreateBuffer( &bufferDescription, &initialData, &s_constantBuffer );
-		if ( SUCCEEDED( result ) )
-		{
-			return true;
-		}
-		else
-		{
-			EAE6320_ASSERT( false );
-			eae6320::Logging::OutputError( "Direct3D failed to create a constant buffer with HRESULT %#010x", result );
-			return false;
-		}
-	}
-
 	bool CreateDevice( const unsigned int i_resolutionWidth, const unsigned int i_resolutionHeight )
 	{
 		IDXGIAdapter* const useDefaultAdapter = NULL;
@@ -434,102 +370,6 @@ namespace
 		}
 	}
 
-	bool CreateVertexBufferLayout( ID3D10Blob& i_compiledShader )
-	{
-		// Create the vertex layout
-		{
-			// These elements must match the VertexFormat::sVertex layout struct exactly.
-			// They instruct Direct3D how to match the binary data in the vertex buffer
-			// to the input elements in a vertex shader
-			// (by using so-called "semantic" names so that, for example,
-			// "POSITION" here matches with "POSITION" in shader code).
-			// Note that OpenGL uses arbitrarily assignable number IDs to do the same thing.
-			const unsigned int vertexElementCount = 1;
-			D3D11_INPUT_ELEMENT_DESC layoutDescription[vertexElementCount] = { 0 };
-			{
-				// Slot 0
-
-				// POSITION
-				// 2 floats == 8 bytes
-				// Offset = 0
-				{
-					D3D11_INPUT_ELEMENT_DESC& positionElement = layoutDescription[0];
-
-					positionElement.SemanticName = "POSITION";
-					positionElement.SemanticIndex = 0;	// (Semantics without modifying indices at the end can always use zero)
-					positionElement.Format = DXGI_FORMAT_R32G32_FLOAT;
-					positionElement.InputSlot = 0;
-					positionElement.AlignedByteOffset = offsetof(eae6320::Graphics::sVertex, x);
-					positionElement.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-					positionElement.InstanceDataStepRate = 0;	// (Must be zero for per-vertex data)
-				}
-			}
-
-			const HRESULT result = s_direct3dDevice->CreateInputLayout( layoutDescription, vertexElementCount,
-				i_compiledShader.GetBufferPointer(), i_compiledShader.GetBufferSize(), &s_vertexLayout );
-			if ( FAILED( result ) )
-			{
-				EAE6320_ASSERT( false );
-				eae6320::Logging::OutputError( "Direct3D failed to create a vertex input layout with HRESULT %#010x", result );
-				return false;
-			}
-		}
-
-		// Eventually the vertex data should come from a file but for now it is hard-coded here.
-		// You will have to update this in a future assignment
-		// (one of the most common mistakes in the class is to leave hard-coded values here).
-
-		//const unsigned int triangleCount = 2;
-		//const unsigned int vertexCountPerTriangle = 3;
-		//const unsigned int vertexCount = triangleCount * vertexCountPerTriangle;
-		//const unsigned int bufferSize = vertexCount * sizeof(eae6320::Graphics::sVertex );
-		//eae6320::Graphics::sVertex vertexData[vertexCount];
-		//{
-		//	vertexData[0].x = 0.0f;
-		//	vertexData[0].y = 0.0f;
-
-		//	vertexData[1].x = 1.0f;
-		//	vertexData[1].y = 1.0f;
-
-		//	vertexData[2].x = 1.0f;
-		//	vertexData[2].y = 0.0f;
-
-		//	vertexData[3].x = 0.0f;
-		//	vertexData[3].y = 0.0f;
-
-		//	vertexData[4].x = 0.0f;
-		//	vertexData[4].y = 1.0f;
-
-		//	vertexData[5].x = 1.0f;
-		//	vertexData[5].y = 1.0f;
-		//}
-
-		//D3D11_BUFFER_DESC bufferDescription = { 0 };
-		//{
-		//	bufferDescription.ByteWidth = bufferSize;
-		//	bufferDescription.Usage = D3D11_USAGE_IMMUTABLE;	// In our class the buffer will never change after it's been created
-		//	bufferDescription.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-		//	bufferDescription.CPUAccessFlags = 0;	// No CPU access is necessary
-		//	bufferDescription.MiscFlags = 0;
-		//	bufferDescription.StructureByteStride = 0;	// Not used
-		//}
-		//D3D11_SUBRESOURCE_DATA initialData = { 0 };
-		//{
-		//	initialData.pSysMem = vertexData;
-		//	// (The other data members are ignored for non-texture buffers)
-		//}
-
-		//const HRESULT result = s_direct3dDevice->CreateBuffer( &bufferDescription, &initialData, &s_vertexBuffer );
-		//if ( FAILED( result ) )
-		//{
-		//	EAE6320_ASSERT( false );
-		//	eae6320::Logging::OutputError( "Direct3D failed to create the vertex buffer with HRESULT %#010x", result );
-		//	return false;
-		//}
-
-		return true;
-	}
-
 	bool CreateView( const unsigned int i_resolutionWidth, const unsigned int i_resolutionHeight )
 	{
 		bool wereThereErrors = false;
@@ -591,118 +431,4 @@ namespace
 
 		return !wereThereErrors;
 	}
-
-	bool LoadFragmentShader()
-	{
-		// Load the source code and compile it
-		ID3D10Blob* compiledShader = NULL;
-		{
-			const char* const sourceCodeFileName = "data/fragmentShader.hlsl";
-			D3D10_SHADER_MACRO* const noMacros = NULL;
-			ID3DInclude* const noIncludes = NULL;
-			const char* const entryPoint = "main";
-			const char* const profile = "ps_4_0";
-			const unsigned int noFlags = 0;
-			ID3DX11ThreadPump* const blockUntilLoaded = NULL;
-			ID3D10Blob* errorMessages = NULL;
-			HRESULT result;
-			result = D3DX11CompileFromFile( sourceCodeFileName, noMacros, noIncludes, entryPoint, profile,
-				noFlags, noFlags, blockUntilLoaded, &compiledShader, &errorMessages, &result );
-			if ( SUCCEEDED( result ) )
-			{
-				if ( errorMessages )
-				{
-					errorMessages->Release();
-				}
-			}
-			else
-			{
-				if ( errorMessages )
-				{
-					EAE6320_ASSERTF( false, reinterpret_cast<char*>( errorMessages->GetBufferPointer() ) );
-					eae6320::Logging::OutputError( "Direct3D failed to compile the fragment shader from the file %s: %s",
-						sourceCodeFileName, reinterpret_cast<char*>( errorMessages->GetBufferPointer() ) );
-					errorMessages->Release();
-				}
-				else
-				{
-					EAE6320_ASSERT( false );
-					eae6320::Logging::OutputError( "Direct3D failed to compile the fragment shader from the file %s",
-						sourceCodeFileName );
-				}
-				return false;
-			}
-		}
-		// Create the fragment shader object
-		bool wereThereErrors = false;
-		{
-			ID3D11ClassLinkage* const noInterfaces = NULL;
-			const HRESULT result = s_direct3dDevice->CreatePixelShader( compiledShader->GetBufferPointer(), compiledShader->GetBufferSize(),
-				noInterfaces, &s_fragmentShader );
-			if ( FAILED( result ) )
-			{
-				EAE6320_ASSERT( false );
-				eae6320::Logging::OutputError( "Direct3D failed to create the fragment shader with HRESULT %#010x", result );
-				wereThereErrors = true;
-			}
-			compiledShader->Release();
-		}
-		return !wereThereErrors;
-	}
-
-	bool LoadVertexShader( ID3D10Blob*& o_compiledShader )
-	{
-		// Load the source code and compile it
-		{
-			const char* const sourceCodeFileName = "data/vertexShader.hlsl";
-			D3D10_SHADER_MACRO* const noMacros = NULL;
-			ID3DInclude* const noIncludes = NULL;
-			const char* const entryPoint = "main";
-			const char* const profile = "vs_4_0";
-			const unsigned int noFlags = 0;
-			ID3DX11ThreadPump* const blockUntilLoaded = NULL;
-			ID3D10Blob* errorMessages = NULL;
-			HRESULT result;
-			result = D3DX11CompileFromFile( sourceCodeFileName, noMacros, noIncludes, entryPoint, profile,
-				noFlags, noFlags, blockUntilLoaded, &o_compiledShader, &errorMessages, &result );
-			if ( SUCCEEDED( result ) )
-			{
-				if ( errorMessages )
-				{
-					errorMessages->Release();
-				}
-			}
-			else
-			{
-				if ( errorMessages )
-				{
-					EAE6320_ASSERTF( false, reinterpret_cast<char*>( errorMessages->GetBufferPointer() ) );
-					eae6320::Logging::OutputError( "Direct3D failed to compile the vertex shader from the file %s: %s",
-						sourceCodeFileName, reinterpret_cast<char*>( errorMessages->GetBufferPointer() ) );
-					errorMessages->Release();
-				}
-				else
-				{
-					EAE6320_ASSERT( false );
-					eae6320::Logging::OutputError( "Direct3D failed to compile the vertex shader from the file %s",
-						sourceCodeFileName );
-				}
-				return false;
-			}
-		}
-		// Create the vertex shader object
-		bool wereThereErrors = false;
-		{
-			ID3D11ClassLinkage* const noInterfaces = NULL;
-			const HRESULT result = s_direct3dDevice->CreateVertexShader( o_compiledShader->GetBufferPointer(), o_compiledShader->GetBufferSize(),
-				noInterfaces, &s_vertexShader );
-			if ( FAILED( result ) )
-			{
-				EAE6320_ASSERT( false );
-				eae6320::Logging::OutputError( "Direct3D failed to create the vertex shader with HRESULT %#010x", result );
-				wereThereErrors = true;
-			}
-		}
-		return !wereThereErrors;
-	}
-}
+}
\ No newline at end of file
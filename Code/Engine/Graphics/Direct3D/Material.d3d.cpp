@@ -0,0 +1,401 @@
+// Header Files
+//=============
+
+#include "../Material.h"
+
+#include <cstddef>
+#include "../Includes.h"
+#include "../ParticleEmitter.h"
+#include "../Statistics.h"
+#include "../TextBatch.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool CreateVertexBufferLayout( const void* const i_compiledShader, const size_t i_compiledShaderSize,
+		const uint8_t i_vertexFormat, ID3D11InputLayout*& o_vertexLayout );
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::Material::BindEffect() const
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	// Set the vertex and fragment shaders
+	{
+		ID3D11ClassInstance** const noInterfaces = NULL;
+		const unsigned int interfaceCount = 0;
+		direct3dImmediateContext->VSSetShader( m_effect->vertexShader, noInterfaces, interfaceCount );
+		direct3dImmediateContext->PSSetShader( m_effect->fragmentShader, noInterfaces, interfaceCount );
+		EAE6320_GRAPHICS_STATISTICS( CountProgramSwitch() );
+	}
+	// Set the layout (which defines how to interpret a single vertex)
+	direct3dImmediateContext->IASetInputLayout( m_effect->vertexLayout );
+	// Set the render states
+	{
+		const float* const noBlendFactor = NULL;
+		const unsigned int sampleMask = 0xffffffff;
+		direct3dImmediateContext->OMSetBlendState( m_effect->blendState, noBlendFactor, sampleMask );
+		const unsigned int unusedStencilReference = 0;
+		direct3dImmediateContext->OMSetDepthStencilState( m_effect->depthStencilState, unusedStencilReference );
+		direct3dImmediateContext->RSSetState( m_effect->rasterizerState );
+	}
+}
+
+void eae6320::Graphics::Material::BindParameterBlock() const
+{
+	const unsigned int registerAssignedInShader = 1;
+	const unsigned int bufferCount = 1;
+	GetContext().direct3dImmediateContext->PSSetConstantBuffers( registerAssignedInShader, bufferCount, &m_parameterBuffer->constantBuffer );
+	EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( bufferCount ) );
+}
+
+// Implementation
+//===============
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::Material::CreateEffect( const sShaderVariant& i_vertexShader, const sShaderVariant& i_fragmentShader,
+	const uint8_t i_renderStates, const uint8_t i_vertexFormat, sEffect& o_effect )
+{
+	bool wereThereErrors = false;
+
+	ID3D11Device* const direct3dDevice = GetContext().direct3dDevice;
+
+	// Create the vertex shader
+	// (the shaders were already compiled by the ShaderBuilder)
+	{
+		ID3D11ClassLinkage* const noInterfaces = NULL;
+		const HRESULT result = direct3dDevice->CreateVertexShader( i_vertexShader.data, i_vertexShader.size,
+			noInterfaces, &o_effect.vertexShader );
+		if ( FAILED( result ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create the vertex shader from %s with HRESULT %#010x", i_vertexShader.path, result );
+			goto OnExit;
+		}
+		// The compiled vertex shader is also needed to create the vertex input layout
+		if ( !CreateVertexBufferLayout( i_vertexShader.data, i_vertexShader.size, i_vertexFormat, o_effect.vertexLayout ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+	}
+	// Create the fragment shader
+	{
+		ID3D11ClassLinkage* const noInterfaces = NULL;
+		const HRESULT result = direct3dDevice->CreatePixelShader( i_fragmentShader.data, i_fragmentShader.size,
+			noInterfaces, &o_effect.fragmentShader );
+		if ( FAILED( result ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create the fragment shader from %s with HRESULT %#010x", i_fragmentShader.path, result );
+			goto OnExit;
+		}
+	}
+	// Create the render states
+	{
+		D3D11_BLEND_DESC blendDescription = { 0 };
+		{
+			D3D11_RENDER_TARGET_BLEND_DESC& renderTargetBlendDescription = blendDescription.RenderTarget[0];
+			if ( i_renderStates & MaterialFormats::eRenderState::AlphaTransparency )
+			{
+				// result = ( source * source.a ) + ( destination * ( 1 - source.a ) )
+				renderTargetBlendDescription.BlendEnable = TRUE;
+				renderTargetBlendDescription.SrcBlend = D3D11_BLEND_SRC_ALPHA;
+				renderTargetBlendDescription.DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+				renderTargetBlendDescription.BlendOp = D3D11_BLEND_OP_ADD;
+				renderTargetBlendDescription.SrcBlendAlpha = D3D11_BLEND_ONE;
+				renderTargetBlendDescription.DestBlendAlpha = D3D11_BLEND_ZERO;
+				renderTargetBlendDescription.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+			}
+			else
+			{
+				renderTargetBlendDescription.BlendEnable = FALSE;
+			}
+			renderTargetBlendDescription.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+		}
+		HRESULT result = direct3dDevice->CreateBlendState( &blendDescription, &o_effect.blendState );
+		if ( FAILED( result ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a blend state with HRESULT %#010x", result );
+			goto OnExit;
+		}
+
+		D3D11_DEPTH_STENCIL_DESC depthStencilDescription = { 0 };
+		{
+			depthStencilDescription.DepthEnable = ( i_renderStates & MaterialFormats::eRenderState::DepthTesting ) ? TRUE : FALSE;
+			depthStencilDescription.DepthWriteMask = ( i_renderStates & MaterialFormats::eRenderState::DepthWriting ) ?
+				D3D11_DEPTH_WRITE_MASK_ALL : D3D11_DEPTH_WRITE_MASK_ZERO;
+			depthStencilDescription.DepthFunc = D3D11_COMPARISON_LESS_EQUAL;
+			depthStencilDescription.StencilEnable = FALSE;
+		}
+		result = direct3dDevice->CreateDepthStencilState( &depthStencilDescription, &o_effect.depthStencilState );
+		if ( FAILED( result ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a depth/stencil state with HRESULT %#010x", result );
+			goto OnExit;
+		}
+
+		D3D11_RASTERIZER_DESC rasterizerDescription = { D3D11_FILL_SOLID };
+		{
+			rasterizerDescription.CullMode = ( i_renderStates & MaterialFormats::eRenderState::DrawBothTriangleSides ) ?
+				D3D11_CULL_NONE : D3D11_CULL_BACK;
+			rasterizerDescription.FrontCounterClockwise = FALSE;
+			rasterizerDescription.DepthClipEnable = TRUE;
+		}
+		result = direct3dDevice->CreateRasterizerState( &rasterizerDescription, &o_effect.rasterizerState );
+		if ( FAILED( result ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a rasterizer state with HRESULT %#010x", result );
+			goto OnExit;
+		}
+	}
+
+OnExit:
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::Material::CleanUpEffect( sEffect& io_effect )
+{
+	if ( io_effect.vertexShader )
+	{
+		io_effect.vertexShader->Release();
+		io_effect.vertexShader = NULL;
+	}
+	if ( io_effect.fragmentShader )
+	{
+		io_effect.fragmentShader->Release();
+		io_effect.fragmentShader = NULL;
+	}
+	if ( io_effect.vertexLayout )
+	{
+		io_effect.vertexLayout->Release();
+		io_effect.vertexLayout = NULL;
+	}
+	if ( io_effect.blendState )
+	{
+		io_effect.blendState->Release();
+		io_effect.blendState = NULL;
+	}
+	if ( io_effect.depthStencilState )
+	{
+		io_effect.depthStencilState->Release();
+		io_effect.depthStencilState = NULL;
+	}
+	if ( io_effect.rasterizerState )
+	{
+		io_effect.rasterizerState->Release();
+		io_effect.rasterizerState = NULL;
+	}
+	return true;
+}
+
+bool eae6320::Graphics::Material::CreateParameterBuffer( const MaterialFormats::sParameterBlock& i_parameterBlock, sParameterBuffer& o_parameterBuffer )
+{
+	D3D11_BUFFER_DESC bufferDescription = { 0 };
+	{
+		// The byte width must be rounded up to a multiple of 16
+		bufferDescription.ByteWidth = ( sizeof( i_parameterBlock ) + 15 ) & ~15;
+		bufferDescription.Usage = D3D11_USAGE_IMMUTABLE;	// A material's constants never change after it's been loaded
+		bufferDescription.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+		bufferDescription.CPUAccessFlags = 0;
+		bufferDescription.MiscFlags = 0;
+		bufferDescription.StructureByteStride = 0;	// Not used
+	}
+	D3D11_SUBRESOURCE_DATA initialData = { 0 };
+	{
+		initialData.pSysMem = &i_parameterBlock;
+		// (The other data members are ignored for non-texture buffers)
+	}
+
+	const HRESULT result = GetContext().direct3dDevice->CreateBuffer( &bufferDescription, &initialData, &o_parameterBuffer.constantBuffer );
+	if ( SUCCEEDED( result ) )
+	{
+		return true;
+	}
+	else
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to create a material constant buffer with HRESULT %#010x", result );
+		return false;
+	}
+}
+
+bool eae6320::Graphics::Material::CleanUpParameterBuffer( sParameterBuffer& io_parameterBuffer )
+{
+	if ( io_parameterBuffer.constantBuffer )
+	{
+		io_parameterBuffer.constantBuffer->Release();
+		io_parameterBuffer.constantBuffer = NULL;
+	}
+	return true;
+}
+
+eae6320::Graphics::Material::sEffect::sEffect()
+	:
+	vertexShader( NULL ), fragmentShader( NULL ), vertexLayout( NULL ),
+	blendState( NULL ), depthStencilState( NULL ), rasterizerState( NULL ),
+	vertexShaderLibrary( NULL ), fragmentShaderLibrary( NULL ),
+	hash( MaterialFormats::s_emptyHash ), referenceCount( 0 )
+{
+
+}
+
+eae6320::Graphics::Material::sParameterBuffer::sParameterBuffer()
+	:
+	constantBuffer( NULL ), hash( MaterialFormats::s_emptyHash ), referenceCount( 0 )
+{
+
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool CreateVertexBufferLayout( const void* const i_compiledShader, const size_t i_compiledShaderSize,
+		const uint8_t i_vertexFormat, ID3D11InputLayout*& o_vertexLayout )
+	{
+		// These elements must match the layout struct of the vertex format (sVertex, sTextVertex, or sParticleVertex) exactly.
+		// They instruct Direct3D how to match the binary data in the vertex buffer
+		// to the input elements in a vertex shader
+		// (by using so-called "semantic" names so that, for example,
+		// "POSITION" here matches with "POSITION" in shader code).
+		// Note that OpenGL uses arbitrarily assignable number IDs to do the same thing.
+		const unsigned int maxVertexElementCount = 3;
+		D3D11_INPUT_ELEMENT_DESC layoutDescription[maxVertexElementCount] = { 0 };
+		unsigned int vertexElementCount = 1;
+		if ( i_vertexFormat == eae6320::Graphics::MaterialFormats::eVertexFormat::Text )
+		{
+			// Slot 0
+
+			// POSITION
+			// 2 floats == 8 bytes
+			// Offset = 0
+			{
+				D3D11_INPUT_ELEMENT_DESC& positionElement = layoutDescription[0];
+
+				positionElement.SemanticName = "POSITION";
+				positionElement.SemanticIndex = 0;
+				positionElement.Format = DXGI_FORMAT_R32G32_FLOAT;
+				positionElement.InputSlot = 0;
+				positionElement.AlignedByteOffset = offsetof( eae6320::Graphics::sTextVertex, x );
+				positionElement.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+				positionElement.InstanceDataStepRate = 0;
+			}
+			// TEXCOORD
+			// 2 floats == 8 bytes
+			// Offset = 8
+			{
+				D3D11_INPUT_ELEMENT_DESC& textureCoordinatesElement = layoutDescription[1];
+
+				textureCoordinatesElement.SemanticName = "TEXCOORD";
+				textureCoordinatesElement.SemanticIndex = 0;
+				textureCoordinatesElement.Format = DXGI_FORMAT_R32G32_FLOAT;
+				textureCoordinatesElement.InputSlot = 0;
+				textureCoordinatesElement.AlignedByteOffset = offsetof( eae6320::Graphics::sTextVertex, u );
+				textureCoordinatesElement.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+				textureCoordinatesElement.InstanceDataStepRate = 0;
+			}
+			// COLOR
+			// 4 uint8_ts == 4 bytes
+			// Offset = 16
+			{
+				D3D11_INPUT_ELEMENT_DESC& colorElement = layoutDescription[2];
+
+				colorElement.SemanticName = "COLOR";
+				colorElement.SemanticIndex = 0;
+				// The [0,255] values become [0,1] floats in the shader
+				colorElement.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+				colorElement.InputSlot = 0;
+				colorElement.AlignedByteOffset = offsetof( eae6320::Graphics::sTextVertex, r );
+				colorElement.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+				colorElement.InstanceDataStepRate = 0;
+			}
+			vertexElementCount = 3;
+		}
+		else if ( i_vertexFormat == eae6320::Graphics::MaterialFormats::eVertexFormat::Particle )
+		{
+			// Slot 0
+
+			// POSITION
+			// 2 floats == 8 bytes
+			// Offset = 0
+			{
+				D3D11_INPUT_ELEMENT_DESC& positionElement = layoutDescription[0];
+
+				positionElement.SemanticName = "POSITION";
+				positionElement.SemanticIndex = 0;
+				positionElement.Format = DXGI_FORMAT_R32G32_FLOAT;
+				positionElement.InputSlot = 0;
+				positionElement.AlignedByteOffset = offsetof( eae6320::Graphics::sParticleVertex, x );
+				positionElement.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+				positionElement.InstanceDataStepRate = 0;
+			}
+			// COLOR
+			// 4 uint8_ts == 4 bytes
+			// Offset = 8
+			{
+				D3D11_INPUT_ELEMENT_DESC& colorElement = layoutDescription[1];
+
+				colorElement.SemanticName = "COLOR";
+				colorElement.SemanticIndex = 0;
+				// The [0,255] values become [0,1] floats in the shader
+				colorElement.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+				colorElement.InputSlot = 0;
+				colorElement.AlignedByteOffset = offsetof( eae6320::Graphics::sParticleVertex, r );
+				colorElement.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+				colorElement.InstanceDataStepRate = 0;
+			}
+			vertexElementCount = 2;
+		}
+		else
+		{
+			// Slot 0
+
+			// POSITION
+			// 2 floats == 8 bytes
+			// Offset = 0
+			{
+				D3D11_INPUT_ELEMENT_DESC& positionElement = layoutDescription[0];
+
+				positionElement.SemanticName = "POSITION";
+				positionElement.SemanticIndex = 0;	// (Semantics without modifying indices at the end can always use zero)
+				positionElement.Format = DXGI_FORMAT_R32G32_FLOAT;
+				positionElement.InputSlot = 0;
+				positionElement.AlignedByteOffset = offsetof( eae6320::Graphics::sVertex, x );
+				positionElement.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+				positionElement.InstanceDataStepRate = 0;	// (Must be zero for per-vertex data)
+			}
+		}
+
+		const HRESULT result = eae6320::Graphics::GetContext().direct3dDevice->CreateInputLayout( layoutDescription, vertexElementCount,
+			i_compiledShader, i_compiledShaderSize, &o_vertexLayout );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			eae6320::Logging::OutputError( "Direct3D failed to create a vertex input layout with HRESULT %#010x", result );
+			return false;
+		}
+		return true;
+	}
+}
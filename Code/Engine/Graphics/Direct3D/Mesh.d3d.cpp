@@ -1,5 +1,8 @@
 #include "../Mesh.h"
 #include "../Includes.h"
+#include "../FrameFences.h"
+#include "../Statistics.h"
+#include "../UploadManager.h"
 #include "../../Logging/Logging.h"
 #include "../../Asserts/Asserts.h"
 
@@ -13,7 +16,12 @@ namespace eae6320
 			const unsigned int vertexCountPerTriangle = 3;
 			const unsigned int vertexCount = triangleCount * vertexCountPerTriangle;
 			const unsigned int bufferSize = vertexCount * sizeof(sVertex);
-			sVertex vertexData[vertexCount];
+			// The vertices are written straight into staging memory and copied into the buffer when the frame is flushed
+			// (if there isn't room they are given to the driver when the buffer is created instead)
+			sVertex unstagedVertexData[vertexCount];
+			UploadManager::sAllocation stagingMemory;
+			const bool isStaged = UploadManager::Allocate(bufferSize, stagingMemory);
+			sVertex* const vertexData = isStaged ? reinterpret_cast<sVertex*>(stagingMemory.data) : unstagedVertexData;
 			{
 				vertexData[0].x = 0.0f;
 				vertexData[0].y = 0.0f;
@@ -37,7 +45,9 @@ namespace eae6320
 			D3D11_BUFFER_DESC bufferDescription = { 0 };
 			{
 				bufferDescription.ByteWidth = bufferSize;
-				bufferDescription.Usage = D3D11_USAGE_IMMUTABLE;	// In our class the buffer will never change after it's been created
+				// In our class the buffer will never change after it's been created,
+				// but an immutable buffer can't be copied into
+				bufferDescription.Usage = isStaged ? D3D11_USAGE_DEFAULT : D3D11_USAGE_IMMUTABLE;
 				bufferDescription.BindFlags = D3D11_BIND_VERTEX_BUFFER;
 				bufferDescription.CPUAccessFlags = 0;	// No CPU access is necessary
 				bufferDescription.MiscFlags = 0;
@@ -49,22 +59,33 @@ namespace eae6320
 				// (The other data members are ignored for non-texture buffers)
 			}
 
-			const HRESULT result = GetContext().direct3dDevice->CreateBuffer(&bufferDescription, &initialData, &m_vertexBuffer);
+			const HRESULT result = GetContext().direct3dDevice->CreateBuffer(&bufferDescription, isStaged ? NULL : &initialData, &m_vertexBuffer);
 			if (FAILED(result))
 			{
 				EAE6320_ASSERT(false);
 				eae6320::Logging::OutputError("Direct3D failed to create the vertex buffer with HRESULT %#010x", result);
 				return false;
 			}
+			if (isStaged)
+			{
+				UploadManager::CopyToBuffer(stagingMemory, m_vertexBuffer);
+			}
+			m_vertexBufferSize = bufferSize;
+			EAE6320_GRAPHICS_STATISTICS(CountAllocation(Statistics::eResourceType::VertexBuffer, m_vertexBufferSize));
+			EAE6320_GRAPHICS_STATISTICS(CountUpload(m_vertexBufferSize));
 			return true;
 		}
 
 		bool Mesh::CleanUp()
 		{
-			if (m_vertexBuffer)
+			// A frame that the GPU hasn't finished yet might still draw the mesh,
+			// and so the buffer is released once the current frame has retired
+			FrameFences::DeferRelease(m_vertexBuffer);
+			m_vertexBuffer = NULL;
+			if (m_vertexBufferSize != 0)
 			{
-				m_vertexBuffer->Release();
-				m_vertexBuffer = NULL;
+				EAE6320_GRAPHICS_STATISTICS(CountFree(Statistics::eResourceType::VertexBuffer, m_vertexBufferSize));
+				m_vertexBufferSize = 0;
 			}
 			return true;
 		}
@@ -80,6 +101,7 @@ namespace eae6320
 				// It's possible to start streaming data in the middle of a vertex buffer
 				const unsigned int bufferOffset = 0;
 				GetContext().direct3dImmediateContext->IASetVertexBuffers(startingSlot, vertexBufferCount, &m_vertexBuffer, &bufferStride, &bufferOffset);
+				EAE6320_GRAPHICS_STATISTICS(CountBufferBinds(vertexBufferCount));
 			}
 			// Render triangles from the currently-bound vertex buffer
 			{
@@ -91,6 +113,7 @@ namespace eae6320
 				// It's possible to start rendering primitives in the middle of the stream
 				const unsigned int indexOfFirstVertexToRender = 0;
 				GetContext().direct3dImmediateContext->Draw(vertexCountToRender, indexOfFirstVertexToRender);
+				EAE6320_GRAPHICS_STATISTICS(CountDraw(triangleCount));
 			}
 			return true;
 		}
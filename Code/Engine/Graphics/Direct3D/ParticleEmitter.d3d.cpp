@@ -0,0 +1,95 @@
+// Header Files
+//=============
+
+#include "../ParticleEmitter.h"
+
+#include "../Includes.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::ParticleEmitter::CreateVertexBuffer()
+{
+	D3D11_BUFFER_DESC bufferDescription = { 0 };
+	{
+		bufferDescription.ByteWidth = m_maxParticleCount * sizeof( sParticleVertex );
+		bufferDescription.Usage = D3D11_USAGE_DYNAMIC;	// The CPU writes the particles every frame
+		bufferDescription.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		bufferDescription.MiscFlags = 0;
+		bufferDescription.StructureByteStride = 0;	// Not used
+	}
+	const D3D11_SUBRESOURCE_DATA* const noInitialData = NULL;
+	const HRESULT result = GetContext().direct3dDevice->CreateBuffer( &bufferDescription, noInitialData, &m_vertexBuffer );
+	if ( FAILED( result ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to create the particle vertex buffer with HRESULT %#010x", result );
+		return false;
+	}
+	return true;
+}
+
+bool eae6320::Graphics::ParticleEmitter::DestroyVertexBuffer()
+{
+	if ( m_vertexBuffer )
+	{
+		m_vertexBuffer->Release();
+		m_vertexBuffer = NULL;
+	}
+	return true;
+}
+
+eae6320::Graphics::sParticleVertex* eae6320::Graphics::ParticleEmitter::MapVertexBuffer()
+{
+	// Discarding lets the driver hand back fresh memory
+	// instead of waiting for the GPU to finish drawing last frame's particles
+	D3D11_MAPPED_SUBRESOURCE mappedSubResource;
+	const unsigned int noSubResources = 0;
+	const D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD;
+	const unsigned int noFlags = 0;
+	const HRESULT result = GetContext().direct3dImmediateContext->Map( m_vertexBuffer, noSubResources, mapType, noFlags, &mappedSubResource );
+	if ( SUCCEEDED( result ) )
+	{
+		return reinterpret_cast<sParticleVertex*>( mappedSubResource.pData );
+	}
+	else
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to map the particle vertex buffer with HRESULT %#010x", result );
+		return NULL;
+	}
+}
+
+void eae6320::Graphics::ParticleEmitter::UnmapVertexBuffer()
+{
+	const unsigned int noSubResources = 0;
+	GetContext().direct3dImmediateContext->Unmap( m_vertexBuffer, noSubResources );
+}
+
+void eae6320::Graphics::ParticleEmitter::DrawVertexBuffer( const unsigned int i_vertexCount )
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	// Bind the particle vertex buffer
+	// (the particle material's input layout reads the POSITION and COLOR of each sParticleVertex)
+	{
+		const unsigned int startingSlot = 0;
+		const unsigned int vertexBufferCount = 1;
+		const unsigned int bufferStride = sizeof( sParticleVertex );
+		const unsigned int bufferOffset = 0;
+		direct3dImmediateContext->IASetVertexBuffers( startingSlot, vertexBufferCount, &m_vertexBuffer, &bufferStride, &bufferOffset );
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( vertexBufferCount ) );
+	}
+	// Every particle is drawn as a single point
+	direct3dImmediateContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_POINTLIST );
+	{
+		const unsigned int indexOfFirstVertexToRender = 0;
+		direct3dImmediateContext->Draw( i_vertexCount, indexOfFirstVertexToRender );
+		EAE6320_GRAPHICS_STATISTICS( CountDraw( i_vertexCount ) );
+	}
+	// Meshes expect triangle lists
+	direct3dImmediateContext->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+}
@@ -0,0 +1,182 @@
+// Header Files
+//=============
+
+#include "../RenderGraph.h"
+
+#include "../Includes.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	DXGI_FORMAT GetDxgiFormat( const eae6320::Graphics::eTargetFormat::eTargetFormat i_format );
+}
+
+// Interface
+//==========
+
+// Execute
+//--------
+
+void eae6320::Graphics::RenderGraph::BindTexture( const unsigned int i_resourceIndex, const unsigned int i_textureUnit ) const
+{
+	EAE6320_ASSERT( ( i_resourceIndex < m_resources.size() ) && ( m_resources[i_resourceIndex].physicalTargetIndex != s_invalidIndex ) );
+	const unsigned int viewCount = 1;
+	GetContext().direct3dImmediateContext->PSSetShaderResources( i_textureUnit, viewCount,
+		&m_physicalTargets[m_resources[i_resourceIndex].physicalTargetIndex].shaderResourceView );
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::RenderGraph::CreatePhysicalTarget( sPhysicalTarget& io_target )
+{
+	ID3D11Device* const direct3dDevice = GetContext().direct3dDevice;
+	io_target.texture = NULL;
+	io_target.renderTargetView = NULL;
+	io_target.shaderResourceView = NULL;
+
+	D3D11_TEXTURE2D_DESC textureDescription = { 0 };
+	{
+		textureDescription.Width = io_target.description.width;
+		textureDescription.Height = io_target.description.height;
+		textureDescription.MipLevels = 1;
+		textureDescription.ArraySize = 1;
+		textureDescription.Format = GetDxgiFormat( io_target.description.format );
+		{
+			DXGI_SAMPLE_DESC& sampleDescription = textureDescription.SampleDesc;
+			sampleDescription.Count = 1;
+			sampleDescription.Quality = 0;	// Anti-aliasing is disabled
+		}
+		textureDescription.Usage = D3D11_USAGE_DEFAULT;
+		// The target is rendered to by the passes that write it and sampled by the passes that read it
+		textureDescription.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+		textureDescription.CPUAccessFlags = 0;
+		textureDescription.MiscFlags = 0;
+	}
+	const D3D11_SUBRESOURCE_DATA* const noInitialData = NULL;
+	HRESULT result = direct3dDevice->CreateTexture2D( &textureDescription, noInitialData, &io_target.texture );
+	if ( FAILED( result ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to create a %ux%u render target texture with HRESULT %#010x",
+			io_target.description.width, io_target.description.height, result );
+		goto OnExit;
+	}
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::Texture, CalculateMemorySize( io_target.description ) ) );
+	{
+		const D3D11_RENDER_TARGET_VIEW_DESC* const accessAllSubResources = NULL;
+		result = direct3dDevice->CreateRenderTargetView( io_target.texture, accessAllSubResources, &io_target.renderTargetView );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a render target view with HRESULT %#010x", result );
+			goto OnExit;
+		}
+	}
+	{
+		const D3D11_SHADER_RESOURCE_VIEW_DESC* const accessAllSubResources = NULL;
+		result = direct3dDevice->CreateShaderResourceView( io_target.texture, accessAllSubResources, &io_target.shaderResourceView );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a render target's shader resource view with HRESULT %#010x", result );
+			goto OnExit;
+		}
+	}
+
+OnExit:
+
+	if ( FAILED( result ) )
+	{
+		DestroyPhysicalTarget( io_target );
+		return false;
+	}
+	return true;
+}
+
+bool eae6320::Graphics::RenderGraph::DestroyPhysicalTarget( sPhysicalTarget& io_target )
+{
+	if ( io_target.shaderResourceView )
+	{
+		io_target.shaderResourceView->Release();
+		io_target.shaderResourceView = NULL;
+	}
+	if ( io_target.renderTargetView )
+	{
+		io_target.renderTargetView->Release();
+		io_target.renderTargetView = NULL;
+	}
+	if ( io_target.texture )
+	{
+		io_target.texture->Release();
+		io_target.texture = NULL;
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::Texture, CalculateMemorySize( io_target.description ) ) );
+	}
+	return true;
+}
+
+void eae6320::Graphics::RenderGraph::BindTargets( const sPass& i_pass ) const
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+
+	// A target that an earlier pass read may still be bound as a texture,
+	// and Direct3D won't bind a resource for reading and writing at the same time
+	// (no shader in the game uses more texture units than this)
+	{
+		ID3D11ShaderResourceView* const noViews[16] = { NULL };
+		const unsigned int startingSlot = 0;
+		const unsigned int viewCount = sizeof( noViews ) / sizeof( noViews[0] );
+		direct3dImmediateContext->PSSetShaderResources( startingSlot, viewCount, noViews );
+	}
+
+	ID3D11RenderTargetView* renderTargetViews[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = { NULL };
+	const unsigned int renderTargetCount = static_cast<unsigned int>( i_pass.writes.size() );
+	EAE6320_ASSERT( renderTargetCount <= D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT );
+	for ( unsigned int i = 0; i < renderTargetCount; ++i )
+	{
+		const sWrite& write = i_pass.writes[i];
+		const sResource& resource = m_resources[write.resourceIndex];
+		renderTargetViews[i] = resource.isImported ? GetContext().backBufferView
+			: m_physicalTargets[resource.physicalTargetIndex].renderTargetView;
+		if ( write.shouldBeCleared )
+		{
+			direct3dImmediateContext->ClearRenderTargetView( renderTargetViews[i], write.clearColor );
+		}
+	}
+	ID3D11DepthStencilView* const noDepthStencilState = NULL;
+	direct3dImmediateContext->OMSetRenderTargets( renderTargetCount, renderTargetViews, noDepthStencilState );
+
+	if ( renderTargetCount > 0 )
+	{
+		uint16_t width, height;
+		GetViewportSize( i_pass, width, height );
+		D3D11_VIEWPORT viewPort = { 0 };
+		viewPort.TopLeftX = viewPort.TopLeftY = 0.0f;
+		viewPort.Width = static_cast<float>( width );
+		viewPort.Height = static_cast<float>( height );
+		viewPort.MinDepth = 0.0f;
+		viewPort.MaxDepth = 1.0f;
+		const unsigned int viewPortCount = 1;
+		direct3dImmediateContext->RSSetViewports( viewPortCount, &viewPort );
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	DXGI_FORMAT GetDxgiFormat( const eae6320::Graphics::eTargetFormat::eTargetFormat i_format )
+	{
+		switch ( i_format )
+		{
+		case eae6320::Graphics::eTargetFormat::R16G16B16A16_FLOAT: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+		default: return DXGI_FORMAT_R8G8B8A8_UNORM;
+		}
+	}
+}
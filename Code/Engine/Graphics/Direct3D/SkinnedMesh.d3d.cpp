@@ -0,0 +1,93 @@
+// Header Files
+//=============
+
+#include "../SkinnedMesh.h"
+
+#include "../Includes.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::SkinnedMesh::CreateVertexBuffer()
+{
+	D3D11_BUFFER_DESC bufferDescription = { 0 };
+	{
+		bufferDescription.ByteWidth = m_vertices.GetVertexCount() * sizeof( sVertex );
+		bufferDescription.Usage = D3D11_USAGE_DYNAMIC;	// The CPU skins the vertices every frame
+		bufferDescription.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		bufferDescription.MiscFlags = 0;
+		bufferDescription.StructureByteStride = 0;	// Not used
+	}
+	const D3D11_SUBRESOURCE_DATA* const noInitialData = NULL;
+	const HRESULT result = GetContext().direct3dDevice->CreateBuffer( &bufferDescription, noInitialData, &m_vertexBuffer );
+	if ( FAILED( result ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to create the skinned vertex buffer with HRESULT %#010x", result );
+		return false;
+	}
+	return true;
+}
+
+bool eae6320::Graphics::SkinnedMesh::DestroyVertexBuffer()
+{
+	if ( m_vertexBuffer )
+	{
+		m_vertexBuffer->Release();
+		m_vertexBuffer = NULL;
+	}
+	return true;
+}
+
+eae6320::Graphics::sVertex* eae6320::Graphics::SkinnedMesh::MapVertexBuffer()
+{
+	// Discarding lets the driver hand back fresh memory
+	// instead of waiting for the GPU to finish drawing last frame's pose
+	D3D11_MAPPED_SUBRESOURCE mappedSubResource;
+	const unsigned int noSubResources = 0;
+	const D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD;
+	const unsigned int noFlags = 0;
+	const HRESULT result = GetContext().direct3dImmediateContext->Map( m_vertexBuffer, noSubResources, mapType, noFlags, &mappedSubResource );
+	if ( SUCCEEDED( result ) )
+	{
+		return reinterpret_cast<sVertex*>( mappedSubResource.pData );
+	}
+	else
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to map the skinned vertex buffer with HRESULT %#010x", result );
+		return NULL;
+	}
+}
+
+void eae6320::Graphics::SkinnedMesh::UnmapVertexBuffer()
+{
+	const unsigned int noSubResources = 0;
+	GetContext().direct3dImmediateContext->Unmap( m_vertexBuffer, noSubResources );
+}
+
+void eae6320::Graphics::SkinnedMesh::DrawVertexBuffer()
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	// Bind the skinned vertex buffer
+	{
+		const unsigned int startingSlot = 0;
+		const unsigned int vertexBufferCount = 1;
+		const unsigned int bufferStride = sizeof( sVertex );
+		const unsigned int bufferOffset = 0;
+		direct3dImmediateContext->IASetVertexBuffers( startingSlot, vertexBufferCount, &m_vertexBuffer, &bufferStride, &bufferOffset );
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( vertexBufferCount ) );
+	}
+	// The vertices are a list of triangles
+	// (which is the topology that meshes leave bound)
+	{
+		const unsigned int vertexCountToRender = m_vertices.GetVertexCount();
+		const unsigned int indexOfFirstVertexToRender = 0;
+		direct3dImmediateContext->Draw( vertexCountToRender, indexOfFirstVertexToRender );
+		EAE6320_GRAPHICS_STATISTICS( CountDraw( vertexCountToRender / 3 ) );
+	}
+}
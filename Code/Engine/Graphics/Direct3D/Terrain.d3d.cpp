@@ -0,0 +1,124 @@
+// Header Files
+//=============
+
+#include "../Terrain.h"
+
+#include "../FrameFences.h"
+#include "../Includes.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::Terrain::CreateIndexBuffer( const std::vector<uint16_t>& i_indices )
+{
+	// The index buffer never changes
+	D3D11_BUFFER_DESC bufferDescription = { 0 };
+	{
+		bufferDescription.ByteWidth = static_cast<unsigned int>( i_indices.size() * sizeof( uint16_t ) );
+		bufferDescription.Usage = D3D11_USAGE_IMMUTABLE;
+		bufferDescription.BindFlags = D3D11_BIND_INDEX_BUFFER;
+		bufferDescription.CPUAccessFlags = 0;	// No CPU access is necessary
+		bufferDescription.MiscFlags = 0;
+		bufferDescription.StructureByteStride = 0;	// Not used
+	}
+	D3D11_SUBRESOURCE_DATA initialData = { 0 };
+	{
+		initialData.pSysMem = &i_indices[0];
+		// (The other data members are ignored for non-texture buffers)
+	}
+	const HRESULT result = GetContext().direct3dDevice->CreateBuffer( &bufferDescription, &initialData, &m_indexBuffer );
+	if ( FAILED( result ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to create the terrain index buffer with HRESULT %#010x", result );
+		return false;
+	}
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::IndexBuffer, bufferDescription.ByteWidth ) );
+	EAE6320_GRAPHICS_STATISTICS( CountUpload( bufferDescription.ByteWidth ) );
+	return true;
+}
+
+void eae6320::Graphics::Terrain::DestroyIndexBuffer()
+{
+	if ( m_indexBuffer )
+	{
+		// A frame that the GPU hasn't finished yet might still draw the terrain,
+		// and so the buffer is released once the current frame has retired
+		FrameFences::DeferRelease( m_indexBuffer );
+		m_indexBuffer = NULL;
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::IndexBuffer, m_indexBufferSize ) );
+	}
+}
+
+bool eae6320::Graphics::Terrain::CreateVertexBuffer( sTile& io_tile, const sTerrainVertex* const i_vertices )
+{
+	// A tile's vertices never change while it is resident
+	D3D11_BUFFER_DESC bufferDescription = { 0 };
+	{
+		bufferDescription.ByteWidth = static_cast<unsigned int>( m_vertexBufferSize );
+		bufferDescription.Usage = D3D11_USAGE_IMMUTABLE;
+		bufferDescription.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		bufferDescription.CPUAccessFlags = 0;	// No CPU access is necessary
+		bufferDescription.MiscFlags = 0;
+		bufferDescription.StructureByteStride = 0;	// Not used
+	}
+	D3D11_SUBRESOURCE_DATA initialData = { 0 };
+	{
+		initialData.pSysMem = i_vertices;
+		// (The other data members are ignored for non-texture buffers)
+	}
+	const HRESULT result = GetContext().direct3dDevice->CreateBuffer( &bufferDescription, &initialData, &io_tile.vertexBuffer );
+	if ( FAILED( result ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to create a terrain tile's vertex buffer with HRESULT %#010x", result );
+		io_tile.vertexBuffer = NULL;
+		return false;
+	}
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+	EAE6320_GRAPHICS_STATISTICS( CountUpload( m_vertexBufferSize ) );
+	return true;
+}
+
+void eae6320::Graphics::Terrain::DestroyVertexBuffer( sTile& io_tile )
+{
+	if ( io_tile.vertexBuffer )
+	{
+		// An evicted tile might have been drawn during a frame that the GPU hasn't finished yet
+		FrameFences::DeferRelease( io_tile.vertexBuffer );
+		io_tile.vertexBuffer = NULL;
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+	}
+}
+
+void eae6320::Graphics::Terrain::DrawTiles()
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	// Every tile uses the same index buffer
+	{
+		const unsigned int offset = 0;
+		direct3dImmediateContext->IASetIndexBuffer( m_indexBuffer, DXGI_FORMAT_R16_UINT, offset );
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+	}
+	for ( std::vector<uint32_t>::const_iterator i = m_drawnTiles.begin(); i != m_drawnTiles.end(); ++i )
+	{
+		const sTile& tile = m_tiles[*i];
+		{
+			const unsigned int startingSlot = 0;
+			const unsigned int vertexBufferCount = 1;
+			const unsigned int bufferStride = sizeof( sTerrainVertex );
+			const unsigned int bufferOffset = 0;
+			direct3dImmediateContext->IASetVertexBuffers( startingSlot, vertexBufferCount, &tile.vertexBuffer, &bufferStride, &bufferOffset );
+			EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( vertexBufferCount ) );
+		}
+		{
+			const MeshClusters::sIndexRange& indexRange = GetIndexRange( tile.lod, tile.stitchedEdges );
+			const int offsetToAddToEachIndex = 0;
+			direct3dImmediateContext->DrawIndexed( indexRange.indexCount, indexRange.firstIndex, offsetToAddToEachIndex );
+			EAE6320_GRAPHICS_STATISTICS( CountDraw( indexRange.indexCount / 3 ) );
+		}
+	}
+}
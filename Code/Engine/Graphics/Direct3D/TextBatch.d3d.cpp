@@ -0,0 +1,134 @@
+// Header Files
+//=============
+
+#include "../TextBatch.h"
+
+#include "../Includes.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::TextBatch::CreateBuffers()
+{
+	ID3D11Device* const direct3dDevice = GetContext().direct3dDevice;
+
+	// The vertex buffer has room for every glyph
+	// (the contents are written every frame)
+	{
+		D3D11_BUFFER_DESC bufferDescription = { 0 };
+		{
+			bufferDescription.ByteWidth = m_maxGlyphCount * 4 * sizeof( sTextVertex );
+			bufferDescription.Usage = D3D11_USAGE_DYNAMIC;	// The CPU writes the text every frame
+			bufferDescription.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+			bufferDescription.MiscFlags = 0;
+			bufferDescription.StructureByteStride = 0;	// Not used
+		}
+		const D3D11_SUBRESOURCE_DATA* const noInitialData = NULL;
+		const HRESULT result = direct3dDevice->CreateBuffer( &bufferDescription, noInitialData, &m_vertexBuffer );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create the text vertex buffer with HRESULT %#010x", result );
+			return false;
+		}
+	}
+	// The index buffer never changes
+	{
+		std::vector<uint32_t> indices;
+		GenerateIndices( m_maxGlyphCount, indices );
+		D3D11_BUFFER_DESC bufferDescription = { 0 };
+		{
+			bufferDescription.ByteWidth = static_cast<unsigned int>( indices.size() * sizeof( uint32_t ) );
+			bufferDescription.Usage = D3D11_USAGE_IMMUTABLE;
+			bufferDescription.BindFlags = D3D11_BIND_INDEX_BUFFER;
+			bufferDescription.CPUAccessFlags = 0;	// No CPU access is necessary
+			bufferDescription.MiscFlags = 0;
+			bufferDescription.StructureByteStride = 0;	// Not used
+		}
+		D3D11_SUBRESOURCE_DATA initialData = { 0 };
+		{
+			initialData.pSysMem = &indices[0];
+			// (The other data members are ignored for non-texture buffers)
+		}
+		const HRESULT result = direct3dDevice->CreateBuffer( &bufferDescription, &initialData, &m_indexBuffer );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create the text index buffer with HRESULT %#010x", result );
+			return false;
+		}
+	}
+	return true;
+}
+
+bool eae6320::Graphics::TextBatch::DestroyBuffers()
+{
+	if ( m_vertexBuffer )
+	{
+		m_vertexBuffer->Release();
+		m_vertexBuffer = NULL;
+	}
+	if ( m_indexBuffer )
+	{
+		m_indexBuffer->Release();
+		m_indexBuffer = NULL;
+	}
+	return true;
+}
+
+eae6320::Graphics::sTextVertex* eae6320::Graphics::TextBatch::MapVertexBuffer()
+{
+	// Discarding lets the driver hand back fresh memory
+	// instead of waiting for the GPU to finish drawing last frame's text
+	D3D11_MAPPED_SUBRESOURCE mappedSubResource;
+	const unsigned int noSubResources = 0;
+	const D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD;
+	const unsigned int noFlags = 0;
+	const HRESULT result = GetContext().direct3dImmediateContext->Map( m_vertexBuffer, noSubResources, mapType, noFlags, &mappedSubResource );
+	if ( SUCCEEDED( result ) )
+	{
+		return reinterpret_cast<sTextVertex*>( mappedSubResource.pData );
+	}
+	else
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to map the text vertex buffer with HRESULT %#010x", result );
+		return NULL;
+	}
+}
+
+void eae6320::Graphics::TextBatch::UnmapVertexBuffer()
+{
+	const unsigned int noSubResources = 0;
+	GetContext().direct3dImmediateContext->Unmap( m_vertexBuffer, noSubResources );
+}
+
+void eae6320::Graphics::TextBatch::DrawBuffers()
+{
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	// Bind the text vertex and index buffers
+	{
+		const unsigned int startingSlot = 0;
+		const unsigned int vertexBufferCount = 1;
+		const unsigned int bufferStride = sizeof( sTextVertex );
+		const unsigned int bufferOffset = 0;
+		direct3dImmediateContext->IASetVertexBuffers( startingSlot, vertexBufferCount, &m_vertexBuffer, &bufferStride, &bufferOffset );
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( vertexBufferCount ) );
+	}
+	{
+		const unsigned int offset = 0;
+		direct3dImmediateContext->IASetIndexBuffer( m_indexBuffer, DXGI_FORMAT_R32_UINT, offset );
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+	}
+	// Every glyph is two triangles
+	{
+		const unsigned int indexOfFirstIndexToUse = 0;
+		const int offsetToAddToEachIndex = 0;
+		direct3dImmediateContext->DrawIndexed( m_glyphCount * 6, indexOfFirstIndexToUse, offsetToAddToEachIndex );
+		EAE6320_GRAPHICS_STATISTICS( CountDraw( m_glyphCount * 2 ) );
+	}
+}
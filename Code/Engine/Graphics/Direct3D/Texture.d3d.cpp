@@ -0,0 +1,221 @@
+// Header Files
+//=============
+
+#include "../Texture.h"
+
+#include "../AssetLoader.h"
+#include "../Includes.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	DXGI_FORMAT GetDxgiFormat( const uint8_t i_format, const bool i_isSrgb );
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::Texture::Bind( const unsigned int i_textureUnit ) const
+{
+	// A texture that hasn't finished loading uses the placeholder instead
+	ID3D11ShaderResourceView* const shaderResourceView = m_shaderResourceView
+		? m_shaderResourceView : AssetLoader::GetPlaceholderTexture().m_shaderResourceView;
+	const unsigned int viewCount = 1;
+	GetContext().direct3dImmediateContext->PSSetShaderResources( i_textureUnit, viewCount, &shaderResourceView );
+}
+
+// Access
+//-------
+
+bool eae6320::Graphics::Texture::IsLoaded() const
+{
+	return m_shaderResourceView != NULL;
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::Texture::CreateGpuTexture( const uint8_t* const i_fileData, const char* const i_path )
+{
+	// Every resident mip is uploaded straight from the file
+	D3D11_SUBRESOURCE_DATA initialData[TextureFormats::s_maxMipCount];
+	for ( unsigned int i = m_firstResidentMip; i < m_mipCount; ++i )
+	{
+		D3D11_SUBRESOURCE_DATA& mipData = initialData[i - m_firstResidentMip];
+		mipData.pSysMem = i_fileData + m_mips[i].offset;
+		mipData.SysMemPitch = m_mips[i].rowPitch;
+		mipData.SysMemSlicePitch = 0;	// Not used for 2D textures
+	}
+	// A streamed texture is recreated whenever its resident mips change,
+	// and the mips that are still resident get copied from the old texture
+	const D3D11_USAGE usage = m_isStreamed ? D3D11_USAGE_DEFAULT : D3D11_USAGE_IMMUTABLE;
+	if ( CreateTextureAndView( m_firstResidentMip, usage, initialData, m_shaderResourceView ) )
+	{
+		return true;
+	}
+	else
+	{
+		Logging::OutputError( "Direct3D failed to create the texture %s", i_path );
+		return false;
+	}
+}
+
+bool eae6320::Graphics::Texture::ChangeFirstResidentMip( const unsigned int i_firstResidentMip, const uint8_t* const i_mipData )
+{
+	bool wereThereErrors = false;
+	ID3D11ShaderResourceView* newShaderResourceView = NULL;
+	ID3D11Resource* oldTexture = NULL;
+	ID3D11Resource* newTexture = NULL;
+
+	// Direct3D can't add mips to or remove mips from an existing texture,
+	// and so a new one is created with just the mips that should be resident
+	{
+		const D3D11_SUBRESOURCE_DATA* const noInitialData = NULL;
+		if ( !CreateTextureAndView( i_firstResidentMip, D3D11_USAGE_DEFAULT, noInitialData, newShaderResourceView ) )
+		{
+			wereThereErrors = true;
+			Logging::OutputError( "Direct3D failed to create a texture with %u resident mips", m_mipCount - i_firstResidentMip );
+			goto OnExit;
+		}
+	}
+	m_shaderResourceView->GetResource( &oldTexture );
+	newShaderResourceView->GetResource( &newTexture );
+	// The mips that are in both textures are copied on the GPU
+	{
+		ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+		const unsigned int firstCommonMip = ( i_firstResidentMip > m_firstResidentMip ) ? i_firstResidentMip : m_firstResidentMip;
+		const unsigned int destinationX = 0, destinationY = 0, destinationZ = 0;
+		const D3D11_BOX* const copyTheEntireMip = NULL;
+		for ( unsigned int i = firstCommonMip; i < m_mipCount; ++i )
+		{
+			direct3dImmediateContext->CopySubresourceRegion( newTexture, i - i_firstResidentMip, destinationX, destinationY, destinationZ,
+				oldTexture, i - m_firstResidentMip, copyTheEntireMip );
+		}
+		// A new mip is uploaded from the data that was streamed in
+		if ( i_firstResidentMip < m_firstResidentMip )
+		{
+			EAE6320_ASSERT( ( ( i_firstResidentMip + 1 ) == m_firstResidentMip ) && ( i_mipData != NULL ) );
+			const unsigned int largestMip = 0;
+			const D3D11_BOX* const updateTheEntireMip = NULL;
+			const unsigned int noSlicePitch = 0;
+			direct3dImmediateContext->UpdateSubresource( newTexture, largestMip, updateTheEntireMip,
+				i_mipData, m_mips[i_firstResidentMip].rowPitch, noSlicePitch );
+		}
+	}
+	// Swap the new texture in
+	m_shaderResourceView->Release();
+	m_shaderResourceView = newShaderResourceView;
+	newShaderResourceView = NULL;
+
+OnExit:
+
+	if ( newTexture )
+	{
+		newTexture->Release();
+		newTexture = NULL;
+	}
+	if ( oldTexture )
+	{
+		oldTexture->Release();
+		oldTexture = NULL;
+	}
+	if ( newShaderResourceView )
+	{
+		newShaderResourceView->Release();
+		newShaderResourceView = NULL;
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::Texture::DestroyGpuTexture()
+{
+	if ( m_shaderResourceView )
+	{
+		m_shaderResourceView->Release();
+		m_shaderResourceView = NULL;
+	}
+	return true;
+}
+
+bool eae6320::Graphics::Texture::CreateTextureAndView( const unsigned int i_firstMip, const D3D11_USAGE i_usage,
+	const D3D11_SUBRESOURCE_DATA* const i_initialData, ID3D11ShaderResourceView*& o_shaderResourceView ) const
+{
+	bool wereThereErrors = false;
+	ID3D11Texture2D* texture = NULL;
+
+	D3D11_TEXTURE2D_DESC textureDescription = { 0 };
+	{
+		textureDescription.Width = m_mips[i_firstMip].width;
+		textureDescription.Height = m_mips[i_firstMip].height;
+		textureDescription.MipLevels = m_mipCount - i_firstMip;
+		textureDescription.ArraySize = 1;
+		textureDescription.Format = GetDxgiFormat( m_format, ( m_flags & TextureFormats::eFlag::IsSrgb ) != 0 );
+		textureDescription.SampleDesc.Count = 1;
+		textureDescription.SampleDesc.Quality = 0;
+		textureDescription.Usage = i_usage;
+		textureDescription.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		textureDescription.CPUAccessFlags = 0;
+		textureDescription.MiscFlags = 0;
+	}
+	{
+		const HRESULT result = GetContext().direct3dDevice->CreateTexture2D( &textureDescription, i_initialData, &texture );
+		if ( FAILED( result ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a texture with HRESULT %#010x", result );
+			goto OnExit;
+		}
+	}
+	{
+		const D3D11_SHADER_RESOURCE_VIEW_DESC* const useTheTextureDescription = NULL;
+		const HRESULT result = GetContext().direct3dDevice->CreateShaderResourceView( texture, useTheTextureDescription, &o_shaderResourceView );
+		if ( FAILED( result ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a shader resource view with HRESULT %#010x", result );
+			goto OnExit;
+		}
+	}
+
+OnExit:
+
+	// The shader resource view holds its own reference to the texture
+	if ( texture )
+	{
+		texture->Release();
+		texture = NULL;
+	}
+
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	DXGI_FORMAT GetDxgiFormat( const uint8_t i_format, const bool i_isSrgb )
+	{
+		namespace eFormat = eae6320::Graphics::TextureFormats::eFormat;
+		switch ( i_format )
+		{
+		case eFormat::BC1: return i_isSrgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+		case eFormat::BC3: return i_isSrgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+		// There are no sRGB versions of the 1 and 2 channel formats
+		case eFormat::BC4: return DXGI_FORMAT_BC4_UNORM;
+		case eFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+		case eFormat::BC7: return i_isSrgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+		}
+		return i_isSrgb ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+	}
+}
@@ -0,0 +1,159 @@
+// Header Files
+//=============
+
+#include "../UploadManager.h"
+
+#include <vector>
+#include "../Includes.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	struct sBufferCopy
+	{
+		ID3D11Buffer* destination;
+		unsigned int destinationOffset;
+		unsigned int sourceOffset;
+		unsigned int size;
+	};
+
+	// Direct3D 11 can't copy from a resource while it is mapped,
+	// and so every batch needs its own staging buffer
+	ID3D11Buffer* s_stagingBuffers[eae6320::Graphics::UploadManager::s_batchCount] = { NULL };
+	// Copies can only be queued from the current batch
+	std::vector<sBufferCopy> s_bufferCopies;
+	unsigned int s_queuedBatchIndex = 0;
+}
+
+// Interface
+//==========
+
+// Staging
+//--------
+
+void eae6320::Graphics::UploadManager::CopyToBuffer( const sAllocation& i_source, ID3D11Buffer* const io_destination,
+	const unsigned int i_destinationOffset )
+{
+	EAE6320_ASSERT( io_destination != NULL );
+	EAE6320_ASSERTF( s_bufferCopies.empty() || ( i_source.batchIndex == s_queuedBatchIndex ),
+		"A copy was queued from staging memory that has already been submitted" );
+
+	sBufferCopy copy;
+	{
+		copy.destination = io_destination;
+		copy.destinationOffset = i_destinationOffset;
+		copy.sourceOffset = static_cast<unsigned int>( i_source.offset );
+		copy.size = static_cast<unsigned int>( i_source.size );
+	}
+	// The buffer could be released before the copy is submitted
+	io_destination->AddRef();
+	s_bufferCopies.push_back( copy );
+	s_queuedBatchIndex = i_source.batchIndex;
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::UploadManager::CreateStagingBuffers( const size_t i_batchByteCount )
+{
+	D3D11_BUFFER_DESC bufferDescription = { 0 };
+	{
+		bufferDescription.ByteWidth = static_cast<unsigned int>( i_batchByteCount );
+		bufferDescription.Usage = D3D11_USAGE_STAGING;
+		bufferDescription.BindFlags = 0;	// Staging resources can't be bound to the pipeline
+		bufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		bufferDescription.MiscFlags = 0;
+		bufferDescription.StructureByteStride = 0;	// Not used
+	}
+	for ( unsigned int i = 0; i < s_batchCount; ++i )
+	{
+		const D3D11_SUBRESOURCE_DATA* const noInitialData = NULL;
+		const HRESULT result = GetContext().direct3dDevice->CreateBuffer( &bufferDescription, noInitialData, &s_stagingBuffers[i] );
+		if ( FAILED( result ) )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "Direct3D failed to create a staging buffer with HRESULT %#010x", result );
+			DestroyStagingBuffers();
+			return false;
+		}
+	}
+	return true;
+}
+
+void eae6320::Graphics::UploadManager::DestroyStagingBuffers()
+{
+	for ( unsigned int i = 0; i < s_batchCount; ++i )
+	{
+		// The GPU might still be copying from the buffer
+		FrameFences::DeferRelease( s_stagingBuffers[i] );
+		s_stagingBuffers[i] = NULL;
+	}
+}
+
+uint8_t* eae6320::Graphics::UploadManager::MapBatch( const unsigned int i_batchIndex )
+{
+	EAE6320_ASSERT( s_stagingBuffers[i_batchIndex] );
+	// The batch's frame has retired,
+	// and so the driver doesn't need to wait for the GPU
+	D3D11_MAPPED_SUBRESOURCE mappedSubResource;
+	const unsigned int noSubResources = 0;
+	const D3D11_MAP mapType = D3D11_MAP_WRITE;
+	const unsigned int noFlags = 0;
+	const HRESULT result = GetContext().direct3dImmediateContext->Map( s_stagingBuffers[i_batchIndex], noSubResources, mapType, noFlags,
+		&mappedSubResource );
+	if ( SUCCEEDED( result ) )
+	{
+		return reinterpret_cast<uint8_t*>( mappedSubResource.pData );
+	}
+	else
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Direct3D failed to map staging batch %u with HRESULT %#010x", i_batchIndex, result );
+		return NULL;
+	}
+}
+
+void eae6320::Graphics::UploadManager::UnmapBatch( const unsigned int i_batchIndex )
+{
+	const unsigned int noSubResources = 0;
+	GetContext().direct3dImmediateContext->Unmap( s_stagingBuffers[i_batchIndex], noSubResources );
+}
+
+unsigned int eae6320::Graphics::UploadManager::SubmitCopies( const unsigned int i_batchIndex )
+{
+	EAE6320_ASSERT( s_bufferCopies.empty() || ( s_queuedBatchIndex == i_batchIndex ) );
+
+	ID3D11DeviceContext* const direct3dImmediateContext = GetContext().direct3dImmediateContext;
+	const unsigned int noSubResources = 0;
+	const unsigned int destinationY = 0, destinationZ = 0;
+	for ( std::vector<sBufferCopy>::const_iterator i = s_bufferCopies.begin(); i != s_bufferCopies.end(); ++i )
+	{
+		D3D11_BOX sourceBox;
+		{
+			sourceBox.left = i->sourceOffset;
+			sourceBox.right = i->sourceOffset + i->size;
+			sourceBox.top = 0;
+			sourceBox.bottom = 1;
+			sourceBox.front = 0;
+			sourceBox.back = 1;
+		}
+		direct3dImmediateContext->CopySubresourceRegion( i->destination, noSubResources, i->destinationOffset, destinationY, destinationZ,
+			s_stagingBuffers[i_batchIndex], noSubResources, &sourceBox );
+	}
+	const unsigned int copyCount = static_cast<unsigned int>( s_bufferCopies.size() );
+	DiscardCopies();
+	return copyCount;
+}
+
+void eae6320::Graphics::UploadManager::DiscardCopies()
+{
+	for ( std::vector<sBufferCopy>::iterator i = s_bufferCopies.begin(); i != s_bufferCopies.end(); ++i )
+	{
+		i->destination->Release();
+	}
+	s_bufferCopies.clear();
+}
@@ -0,0 +1,148 @@
+// Header Files
+//=============
+
+#include "DynamicResolution.h"
+
+#include <cmath>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	float Clamp( const float i_value, const float i_min, const float i_max );
+}
+
+// Interface
+//==========
+
+// Update
+//-------
+
+void eae6320::Graphics::DynamicResolution::Update( const float i_frameTime )
+{
+	// Frame times are noisy, and so the controller uses a moving average
+	m_smoothedFrameTime += ( i_frameTime - m_smoothedFrameTime ) * m_settings.frameTimeSmoothing;
+	// The error is how far over the target the frame time is as a fraction of the target.
+	// A single long frame (e.g. while something is loading) shouldn't collapse the scale,
+	// and so it can't be more than a whole target over.
+	float error = Clamp( ( m_smoothedFrameTime - m_settings.targetFrameTime ) / m_settings.targetFrameTime, -1.0f, 1.0f );
+	if ( std::abs( error ) < m_settings.deadBand )
+	{
+		error = 0.0f;
+	}
+	const float errorDerivative = error - m_previousError;
+	m_previousError = error;
+
+	// The controller's output is how far below the maximum the scale should be
+	{
+		const float errorIntegral = m_errorIntegral + error;
+		const float desiredScale = m_settings.maxScale - ( ( m_settings.proportionalGain * error )
+			+ ( m_settings.integralGain * errorIntegral ) + ( m_settings.derivativeGain * errorDerivative ) );
+		// The error isn't accumulated while it would only push the output further past a limit
+		// (otherwise after a long time at a limit it would take just as long to come back)
+		const bool isSaturated = ( ( desiredScale < m_settings.minScale ) && ( error > 0.0f ) )
+			|| ( ( desiredScale > m_settings.maxScale ) && ( error < 0.0f ) );
+		if ( !isSaturated )
+		{
+			m_errorIntegral = errorIntegral;
+		}
+		m_desiredScale = Clamp( desiredScale, m_settings.minScale, m_settings.maxScale );
+	}
+
+	// The scale only changes when the output has moved a whole step away from it
+	if ( std::abs( m_desiredScale - m_scale ) >= m_settings.scaleStep )
+	{
+		const float previousScale = m_scale;
+		m_scale = Clamp( std::floor( ( m_desiredScale / m_settings.scaleStep ) + 0.5f ) * m_settings.scaleStep,
+			m_settings.minScale, m_settings.maxScale );
+		Logging::OutputMessage( "The dynamic resolution scale changed from %.2f to %.2f (the previous frame's work took %.2f ms)",
+			previousScale, m_scale, i_frameTime * 1000.0f );
+	}
+
+	// Record the frame
+	{
+		sHistoryEntry& entry = m_history[m_nextHistoryIndex];
+		entry.frameTime = i_frameTime;
+		entry.scale = m_scale;
+		m_nextHistoryIndex = ( m_nextHistoryIndex + 1 ) % s_historyLength;
+		if ( m_historyCount < s_historyLength )
+		{
+			++m_historyCount;
+		}
+	}
+}
+
+// Access
+//-------
+
+void eae6320::Graphics::DynamicResolution::SetSettings( const sSettings& i_settings )
+{
+	EAE6320_ASSERT( i_settings.targetFrameTime > 0.0f );
+	EAE6320_ASSERT( ( i_settings.minScale > 0.0f ) && ( i_settings.minScale <= i_settings.maxScale ) );
+	EAE6320_ASSERT( ( i_settings.frameTimeSmoothing > 0.0f ) && ( i_settings.frameTimeSmoothing <= 1.0f ) );
+	EAE6320_ASSERT( i_settings.scaleStep > 0.0f );
+	m_settings = i_settings;
+	Reset();
+}
+
+unsigned int eae6320::Graphics::DynamicResolution::GetHistory( sHistoryEntry* const o_history, const unsigned int i_maxEntryCount ) const
+{
+	const unsigned int entryCount = ( i_maxEntryCount < m_historyCount ) ? i_maxEntryCount : m_historyCount;
+	// The oldest entry that will be copied
+	unsigned int historyIndex = ( m_nextHistoryIndex + s_historyLength - entryCount ) % s_historyLength;
+	for ( unsigned int i = 0; i < entryCount; ++i )
+	{
+		o_history[i] = m_history[historyIndex];
+		historyIndex = ( historyIndex + 1 ) % s_historyLength;
+	}
+	return entryCount;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+eae6320::Graphics::DynamicResolution::sSettings::sSettings()
+	:
+	targetFrameTime( 1.0f / 60.0f ),
+	minScale( 0.5f ), maxScale( 1.0f ),
+	proportionalGain( 0.1f ),
+	integralGain( 0.01f ),
+	derivativeGain( 0.02f ),
+	frameTimeSmoothing( 0.1f ),
+	deadBand( 0.05f ),
+	scaleStep( 0.05f )
+{
+
+}
+
+eae6320::Graphics::DynamicResolution::DynamicResolution()
+{
+	Reset();
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::DynamicResolution::Reset()
+{
+	m_desiredScale = m_scale = m_settings.maxScale;
+	m_smoothedFrameTime = m_settings.targetFrameTime;
+	m_errorIntegral = 0.0f;
+	m_previousError = 0.0f;
+	m_historyCount = 0;
+	m_nextHistoryIndex = 0;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	float Clamp( const float i_value, const float i_min, const float i_max )
+	{
+		return ( i_value < i_min ) ? i_min : ( ( i_value > i_max ) ? i_max : i_value );
+	}
+}
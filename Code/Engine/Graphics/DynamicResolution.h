@@ -0,0 +1,119 @@
+/*
+	Dynamic resolution scales the resolution that the scene is rendered at
+	so that the frame time stays under a target budget
+
+	Every frame the measured frame time is fed to a PID controller
+	whose output is the fraction of the back buffer's width and height that the scene should be rendered at;
+	the scene is rendered to that corner of a full-size target and then upscaled to the back buffer.
+	The frame time is how long the frame's work took (the longer of the CPU's time before presenting and the GPU's time)
+	rather than the time between frames, which never drops below the frame pacer's or the vertical blank's interval.
+
+	Changing the scale doesn't create anything, but a resolution that changes every frame is distracting,
+	and so the controller has hysteresis:
+		* The frame times are averaged, and averages that are close enough to the target
+			are treated as if they were exactly on it
+		* The scale that is used only changes when the controller's output has moved at least a whole step away from it
+*/
+
+#ifndef EAE6320_GRAPHICS_DYNAMICRESOLUTION_H
+#define EAE6320_GRAPHICS_DYNAMICRESOLUTION_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class DynamicResolution
+		{
+		public:
+
+			struct sSettings
+			{
+				// The frame time that the controller tries to stay under
+				float targetFrameTime;
+				// The scale is always clamped to this range
+				// (the controller is effectively disabled if they are the same)
+				float minScale, maxScale;
+				// The error that these are multiplied by is how far over the target the frame time is
+				// as a fraction of the target (e.g. 0.1 if a frame takes 10% too long)
+				float proportionalGain;
+				float integralGain;
+				float derivativeGain;
+				// How much each new frame time moves the average that the error is calculated from, in (0,1]
+				float frameTimeSmoothing;
+				// Frame times within this fraction of the target don't count as errors
+				float deadBand;
+				// The scale that is used is always a multiple of this
+				float scaleStep;
+
+				sSettings();
+			};
+
+			struct sHistoryEntry
+			{
+				float frameTime;
+				// The scale that was chosen after the frame time was measured
+				float scale;
+			};
+			static const unsigned int s_historyLength = 256;
+
+			// Update
+			//-------
+
+			// This should be called once per frame with how long the previous frame's work took
+			void Update( const float i_frameTime );
+
+			// Access
+			//-------
+
+			// The fraction of the back buffer's width and height that the scene should be rendered at
+			float GetScale() const { return m_scale; }
+			const sSettings& GetSettings() const { return m_settings; }
+			// The controller's state is reset when the settings change
+			void SetSettings( const sSettings& i_settings );
+
+			// This copies up to s_historyLength of the most recent frames, oldest first,
+			// and returns how many were copied
+			unsigned int GetHistory( sHistoryEntry* const o_history, const unsigned int i_maxEntryCount ) const;
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			DynamicResolution();
+
+			// Implementation
+			//===============
+
+		private:
+
+			void Reset();
+
+			// Data
+			//=====
+
+		private:
+
+			sSettings m_settings;
+			// The controller's output before it is quantized
+			float m_desiredScale;
+			float m_scale;
+			float m_smoothedFrameTime;
+			float m_errorIntegral;
+			float m_previousError;
+
+			// This is a ring buffer
+			sHistoryEntry m_history[s_historyLength];
+			unsigned int m_historyCount;
+			unsigned int m_nextHistoryIndex;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_DYNAMICRESOLUTION_H
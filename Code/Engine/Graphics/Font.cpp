@@ -0,0 +1,130 @@
+// Header Files
+//=============
+
+#include "Font.h"
+
+#include <string>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Interface
+//==========
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::Font::Load( const char* const i_path )
+{
+	bool wereThereErrors = false;
+
+	// A font can only be loaded once
+	EAE6320_ASSERT( m_header == NULL );
+
+	{
+		std::string errorMessage;
+		if ( !Platform::MapBinaryFile( i_path, m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to map the font %s: %s", i_path, errorMessage.c_str() );
+			goto OnExit;
+		}
+	}
+	// Validate the file
+	{
+		const uint8_t* const fileData = reinterpret_cast<const uint8_t*>( m_file.data );
+		const FontFormats::sHeader* const header = reinterpret_cast<const FontFormats::sHeader*>( fileData );
+		if ( ( m_file.size < sizeof( FontFormats::sHeader ) )
+			|| ( header->fourCc != FontFormats::s_fourCc ) || ( header->version != FontFormats::s_version ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Invalid font file" );
+			Logging::OutputError( "The font %s isn't a built font (or was built by a different version of the FontBuilder)", i_path );
+			goto OnExit;
+		}
+		if ( m_file.size < ( sizeof( FontFormats::sHeader ) + ( static_cast<size_t>( header->glyphCount ) * sizeof( FontFormats::sGlyph ) ) ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Truncated font file" );
+			Logging::OutputError( "The font %s is shorter than its header says it should be", i_path );
+			goto OnExit;
+		}
+		m_header = header;
+		m_glyphs = reinterpret_cast<const FontFormats::sGlyph*>( fileData + sizeof( FontFormats::sHeader ) );
+		m_firstCharacter = header->firstCharacter;
+		m_glyphCount = header->glyphCount;
+	}
+	// Load the texture
+	{
+		std::string path_texture( i_path );
+		{
+			const size_t extension = path_texture.find_last_of( '.' );
+			const size_t slash = path_texture.find_last_of( "/\\" );
+			if ( ( extension != std::string::npos ) && ( ( slash == std::string::npos ) || ( extension > slash ) ) )
+			{
+				path_texture.resize( extension );
+			}
+			path_texture += ".texture";
+		}
+		if ( !m_texture.Load( path_texture.c_str() ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		EAE6320_ASSERTF( ( m_texture.GetWidth() == m_header->width ) && ( m_texture.GetHeight() == m_header->height ),
+			"The font %s doesn't match its texture", i_path );
+	}
+
+OnExit:
+
+	if ( !wereThereErrors )
+	{
+		Logging::OutputMessage( "Loaded the font %s (%u glyphs at %.0f pixels in %ux%u%s)",
+			i_path, m_glyphCount, m_header->size, m_header->width, m_header->height,
+			IsDistanceField() ? " as a distance field" : "" );
+	}
+	else
+	{
+		CleanUp();
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::Font::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	if ( !m_texture.CleanUp() )
+	{
+		wereThereErrors = true;
+	}
+	if ( m_file.data )
+	{
+		std::string errorMessage;
+		if ( !Platform::UnmapBinaryFile( m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to unmap a font: %s", errorMessage.c_str() );
+		}
+	}
+	m_header = NULL;
+	m_glyphs = NULL;
+	m_firstCharacter = 0;
+	m_glyphCount = 0;
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::Font::Font()
+	:
+	m_header( NULL ), m_glyphs( NULL ), m_firstCharacter( 0 ), m_glyphCount( 0 )
+{
+
+}
+
+eae6320::Graphics::Font::~Font()
+{
+	CleanUp();
+}
@@ -0,0 +1,75 @@
+/*
+	A font is a texture of glyphs that has been built by the FontBuilder
+	and a table of how to lay out each glyph
+
+	Like an atlas, the built table is mapped and used as-is.
+	Text is drawn with a TextBatch.
+*/
+
+#ifndef EAE6320_GRAPHICS_FONT_H
+#define EAE6320_GRAPHICS_FONT_H
+
+// Header Files
+//=============
+
+#include "FontFormats.h"
+#include "Texture.h"
+#include "../Platform/Platform.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Font
+		{
+		public:
+
+			// Access
+			//-------
+
+			// This returns NULL if the character isn't in the font
+			const FontFormats::sGlyph* GetGlyph( const uint32_t i_character ) const
+			{
+				const uint32_t glyphIndex = i_character - m_firstCharacter;
+				// Characters before the first one wrap around to large indices
+				return ( glyphIndex < m_glyphCount ) ? ( m_glyphs + glyphIndex ) : NULL;
+			}
+
+			// These are in pixels at the size that the font was built at
+			float GetSize() const { return m_header->size; }
+			float GetLineHeight() const { return m_header->lineHeight; }
+			float GetAscent() const { return m_header->ascent; }
+
+			bool IsDistanceField() const { return ( m_header->flags & FontFormats::eFlag::IsDistanceField ) != 0; }
+			const Texture& GetTexture() const { return m_texture; }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The font's texture is loaded from the same path with a ".texture" extension
+			bool Load( const char* const i_path );
+			bool CleanUp();
+
+			Font();
+			~Font();
+
+			// Data
+			//=====
+
+		private:
+
+			Platform::sMappedFile m_file;
+			Texture m_texture;
+			// These point into the mapped file
+			const FontFormats::sHeader* m_header;
+			const FontFormats::sGlyph* m_glyphs;
+			uint32_t m_firstCharacter;
+			uint32_t m_glyphCount;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_FONT_H
@@ -0,0 +1,85 @@
+/*
+	This file describes the layout of a built font file
+
+	It is shared between the FontBuilder (which writes the file)
+	and the runtime Font (which reads it),
+	and so it must not depend on any graphics platform.
+
+	A font is built from a contiguous range of characters
+	whose glyphs are rasterized and packed into a single texture (written next to the font file with a ".texture" extension).
+	A built font is:
+		* An sHeader
+		* An sGlyph for every character in the range, in order
+	A character's glyph is found by indexing the table with the character minus the first character,
+	and so laying out text never has to search.
+*/
+
+#ifndef EAE6320_GRAPHICS_FONTFORMATS_H
+#define EAE6320_GRAPHICS_FONTFORMATS_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace FontFormats
+		{
+			// "EFNT" read as a little-endian uint32_t
+			const uint32_t s_fourCc = 0x544e4645;
+			const uint16_t s_version = 1;
+
+			namespace eFlag
+			{
+				enum eFlag
+				{
+					// The texture stores the distance to the edge of each glyph rather than how much of a texel it covers
+					// (0.5 is the edge, and the distance is scaled so that [0,1] covers distanceFieldRange texels)
+					IsDistanceField = 1 << 0,
+				};
+			}
+
+			struct sHeader
+			{
+				uint32_t fourCc;
+				uint16_t version;
+				// A combination of eFlag flags
+				uint8_t flags;
+				uint8_t padding;
+				uint32_t firstCharacter;
+				uint32_t glyphCount;
+				// The size of the font texture
+				uint16_t width, height;
+				// These are in pixels at the size that the glyphs were rasterized at
+				float size;
+				float lineHeight;
+				// The distance from the top of a line to its baseline
+				float ascent;
+				float distanceFieldRange;
+			};
+
+			struct sGlyph
+			{
+				// The texture coordinates of the glyph's corners
+				// (0,0 is the top left of the texture and 1,1 is the bottom right)
+				float u0, v0, u1, v1;
+				// These are in pixels at the size that the glyphs were rasterized at.
+				// The offset is from the pen position on the baseline to the top left of the glyph's quad
+				// (and so Y is usually negative).
+				// Characters without anything to draw (like a space) have an empty quad.
+				float offsetX, offsetY;
+				float width, height;
+				// How far the pen moves to the right after the glyph
+				float advance;
+			};
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_FONTFORMATS_H
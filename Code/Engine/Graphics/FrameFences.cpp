@@ -0,0 +1,275 @@
+// Header Files
+//=============
+
+#include "FrameFences.h"
+
+#include <deque>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	struct sDeferredResource
+	{
+		eae6320::Graphics::FrameFences::sResource resource;
+		// The resource can be deleted once this frame has retired
+		uint64_t frame;
+	};
+
+	// Frame 0 is never recorded, and so it means that there is no frame
+	const uint64_t s_noFrame = 0;
+
+	// The frame that each fence was inserted after (or s_noFrame if the fence isn't in flight);
+	// the fence of a frame is always the one at ( frame % s_maxFrameCountInFlight )
+	uint64_t s_fenceFrames[eae6320::Graphics::FrameFences::s_maxFrameCountInFlight] = { 0 };
+	uint64_t s_currentFrame = 1;
+	uint64_t s_lastRetiredFrame = s_noFrame;
+	// Resources are always deferred during the current frame,
+	// and so the queue is sorted by frame
+	std::deque<sDeferredResource> s_deferredResources;
+	eae6320::Graphics::FrameFences::sStats s_stats = { 0 };
+	bool s_isInitialized = false;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void DeleteRetiredResources();
+	void RetireFrame( const unsigned int i_fenceIndex );
+	// Retires frames in order until one is found that the GPU hasn't finished
+	void RetireSignaledFrames();
+	void UpdateStats();
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::FrameFences::EndFrame()
+{
+	EAE6320_ASSERT( s_isInitialized );
+
+	RetireSignaledFrames();
+	// If the current frame's fence is still in flight then the CPU is too far ahead of the GPU
+	// and must wait for the oldest frame to finish before the fence can be reused
+	const unsigned int fenceIndex = static_cast<unsigned int>( s_currentFrame % s_maxFrameCountInFlight );
+	if ( s_fenceFrames[fenceIndex] != s_noFrame )
+	{
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		WaitForFence( fenceIndex );
+		s_stats.secondCountStalled += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+		++s_stats.stallCount;
+		RetireFrame( fenceIndex );
+	}
+	// If a fence can't be inserted then the frame will retire when a later frame does
+	// (the GPU finishes frames in order)
+	if ( InsertFence( fenceIndex ) )
+	{
+		s_fenceFrames[fenceIndex] = s_currentFrame;
+	}
+	++s_currentFrame;
+
+	DeleteRetiredResources();
+	UpdateStats();
+}
+
+void eae6320::Graphics::FrameFences::WaitForIdle()
+{
+	if ( !s_isInitialized )
+	{
+		return;
+	}
+	for ( uint64_t frame = s_lastRetiredFrame + 1; frame < s_currentFrame; ++frame )
+	{
+		const unsigned int fenceIndex = static_cast<unsigned int>( frame % s_maxFrameCountInFlight );
+		if ( s_fenceFrames[fenceIndex] == frame )
+		{
+			WaitForFence( fenceIndex );
+			RetireFrame( fenceIndex );
+		}
+	}
+	// Nothing that has been submitted can still be in use
+	s_lastRetiredFrame = s_currentFrame;
+	DeleteRetiredResources();
+	UpdateStats();
+}
+
+bool eae6320::Graphics::FrameFences::WaitForFrame( const uint64_t i_frame )
+{
+	EAE6320_ASSERT( s_isInitialized );
+	EAE6320_ASSERTF( i_frame < s_currentFrame, "Frame %llu can't be waited for because it hasn't ended", i_frame );
+
+	RetireSignaledFrames();
+	if ( s_lastRetiredFrame >= i_frame )
+	{
+		return false;
+	}
+	bool hasWaited = false;
+	for ( uint64_t frame = s_lastRetiredFrame + 1; ( frame < s_currentFrame ) && ( s_lastRetiredFrame < i_frame ); ++frame )
+	{
+		const unsigned int fenceIndex = static_cast<unsigned int>( frame % s_maxFrameCountInFlight );
+		if ( s_fenceFrames[fenceIndex] == frame )
+		{
+			WaitForFence( fenceIndex );
+			RetireFrame( fenceIndex );
+			hasWaited = true;
+		}
+	}
+	// If the frame and every frame after it don't have fences then (like in WaitForIdle())
+	// there is nothing else that can be waited for
+	if ( s_lastRetiredFrame < i_frame )
+	{
+		s_lastRetiredFrame = i_frame;
+	}
+	DeleteRetiredResources();
+	UpdateStats();
+	return hasWaited;
+}
+
+// Access
+//-------
+
+uint64_t eae6320::Graphics::FrameFences::GetCurrentFrame()
+{
+	return s_currentFrame;
+}
+
+uint64_t eae6320::Graphics::FrameFences::GetLastRetiredFrame()
+{
+	return s_lastRetiredFrame;
+}
+
+const eae6320::Graphics::FrameFences::sStats& eae6320::Graphics::FrameFences::GetStats()
+{
+	return s_stats;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::FrameFences::Initialize()
+{
+	EAE6320_ASSERT( !s_isInitialized );
+	if ( !CreateFences() )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+	for ( unsigned int i = 0; i < s_maxFrameCountInFlight; ++i )
+	{
+		s_fenceFrames[i] = s_noFrame;
+	}
+	s_currentFrame = 1;
+	s_lastRetiredFrame = s_noFrame;
+	{
+		const sStats noStats = { 0 };
+		s_stats = noStats;
+	}
+	s_isInitialized = true;
+	UpdateStats();
+	return true;
+}
+
+bool eae6320::Graphics::FrameFences::CleanUp()
+{
+	if ( !s_isInitialized )
+	{
+		return true;
+	}
+
+	WaitForIdle();
+	EAE6320_ASSERT( s_deferredResources.empty() );
+	DestroyFences();
+	s_isInitialized = false;
+
+	Logging::OutputMessage( "Frame fences: %llu resources had their deletion deferred (at most %u at once),"
+		" and the CPU stalled waiting for the GPU %u times in %llu frames (for %.3f ms in total)",
+		s_stats.deletedCount, s_stats.maxQueuedDeletionCount,
+		s_stats.stallCount, s_currentFrame - 1, s_stats.secondCountStalled * 1000.0 );
+	return true;
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::FrameFences::Defer( const sResource& i_resource )
+{
+	if ( s_isInitialized )
+	{
+		sDeferredResource deferredResource;
+		deferredResource.resource = i_resource;
+		deferredResource.frame = s_currentFrame;
+		s_deferredResources.push_back( deferredResource );
+		UpdateStats();
+	}
+	else
+	{
+		// Without fences there can't be any frames in flight
+		DeleteResource( i_resource );
+		++s_stats.deletedCount;
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void DeleteRetiredResources()
+	{
+		while ( !s_deferredResources.empty() && ( s_deferredResources.front().frame <= s_lastRetiredFrame ) )
+		{
+			eae6320::Graphics::FrameFences::DeleteResource( s_deferredResources.front().resource );
+			s_deferredResources.pop_front();
+			++s_stats.deletedCount;
+		}
+	}
+
+	void RetireFrame( const unsigned int i_fenceIndex )
+	{
+		const uint64_t frame = s_fenceFrames[i_fenceIndex];
+		EAE6320_ASSERT( ( frame != s_noFrame ) && ( frame > s_lastRetiredFrame ) );
+		eae6320::Graphics::FrameFences::ReleaseFence( i_fenceIndex );
+		s_fenceFrames[i_fenceIndex] = s_noFrame;
+		s_lastRetiredFrame = frame;
+	}
+
+	void RetireSignaledFrames()
+	{
+		for ( uint64_t frame = s_lastRetiredFrame + 1; frame < s_currentFrame; ++frame )
+		{
+			const unsigned int fenceIndex = static_cast<unsigned int>( frame % eae6320::Graphics::FrameFences::s_maxFrameCountInFlight );
+			// A frame without a fence retires with the next frame that has one
+			if ( s_fenceFrames[fenceIndex] == frame )
+			{
+				if ( eae6320::Graphics::FrameFences::IsFenceSignaled( fenceIndex ) )
+				{
+					RetireFrame( fenceIndex );
+				}
+				else
+				{
+					break;
+				}
+			}
+		}
+	}
+
+	void UpdateStats()
+	{
+		s_stats.currentFrame = s_currentFrame;
+		s_stats.lastRetiredFrame = s_lastRetiredFrame;
+		s_stats.queuedDeletionCount = static_cast<unsigned int>( s_deferredResources.size() );
+		if ( s_stats.queuedDeletionCount > s_stats.maxQueuedDeletionCount )
+		{
+			s_stats.maxQueuedDeletionCount = s_stats.queuedDeletionCount;
+		}
+	}
+}
@@ -0,0 +1,143 @@
+/*
+	Frame fences track which frames the GPU has finished,
+	and GPU resources that a frame in flight might still use are only deleted after that frame has retired
+
+	A fence (a GL sync object or a D3D event query) is inserted after every frame is presented,
+	and there can be up to s_maxFrameCountInFlight frames in flight at once.
+	The fences are polled without waiting;
+	the CPU only waits (which is counted as a stall) when it needs the fence of a frame that still hasn't finished.
+
+	A resource that is deferred is tagged with the frame that is currently being recorded
+	(which is the last frame that could have used it)
+	and is deleted by the first EndFrame() after that frame's fence has been signaled.
+	Resources that are deferred when the fences aren't initialized
+	(before the device is created or after it has been cleaned up) are deleted immediately.
+*/
+
+#ifndef EAE6320_GRAPHICS_FRAMEFENCES_H
+#define EAE6320_GRAPHICS_FRAMEFENCES_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace FrameFences
+		{
+			// This is how many frames DXGI and most GL drivers queue by default
+			const unsigned int s_maxFrameCountInFlight = 3;
+
+			struct sStats
+			{
+				// The frame that is being recorded
+				uint64_t currentFrame;
+				// The most recent frame that the GPU has finished
+				uint64_t lastRetiredFrame;
+				unsigned int queuedDeletionCount;
+				unsigned int maxQueuedDeletionCount;
+				// These are counted since the fences were initialized
+				uint64_t deletedCount;
+				// Times that EndFrame() had to wait for a fence to be reused
+				// (waits in WaitForFrame() are counted by its callers)
+				unsigned int stallCount;
+				double secondCountStalled;
+			};
+
+#if defined( EAE6320_PLATFORM_GL )
+			namespace eResourceType
+			{
+				enum eResourceType
+				{
+					Buffer,
+					VertexArray,
+					Texture,
+
+					Count
+				};
+			}
+#endif
+
+			// Render
+			//-------
+
+			// This must be called from the render thread after every frame is presented.
+			// It inserts the frame's fence, retires any frames that the GPU has finished,
+			// and deletes the resources that were deferred during them.
+			void EndFrame();
+			// This waits for every frame in flight to finish and then deletes every deferred resource
+			void WaitForIdle();
+			// This waits for the given frame (which must have already ended) to finish
+			// and then deletes the resources that were deferred up to it.
+			// It returns true if the CPU had to wait
+			// (this isn't counted in the stats, and so the caller can count it as its own stall).
+			bool WaitForFrame( const uint64_t i_frame );
+
+			// Deferred Deletion
+			//------------------
+
+			// These must be called from the render thread
+#if defined( EAE6320_PLATFORM_D3D )
+			// The caller's reference is released
+			void DeferRelease( IUnknown* const i_resource );
+#elif defined( EAE6320_PLATFORM_GL )
+			void DeferDelete( const eResourceType::eResourceType i_type, const GLuint i_id );
+#endif
+
+			// Access
+			//-------
+
+			uint64_t GetCurrentFrame();
+			uint64_t GetLastRetiredFrame();
+			const sStats& GetStats();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Initialize();
+			// This waits for the GPU to finish and deletes everything that is still queued
+			bool CleanUp();
+
+			// Implementation
+			//===============
+
+			// A deferred resource is one of these
+			struct sResource
+			{
+#if defined( EAE6320_PLATFORM_D3D )
+				IUnknown* resource;
+#elif defined( EAE6320_PLATFORM_GL )
+				GLuint id;
+				// This is an eResourceType
+				uint8_t type;
+#endif
+			};
+
+			// These are platform-specific and are only called by FrameFences.cpp
+			// (every fence has an index from 0 to s_maxFrameCountInFlight - 1)
+			bool CreateFences();
+			void DestroyFences();
+			bool InsertFence( const unsigned int i_fenceIndex );
+			bool IsFenceSignaled( const unsigned int i_fenceIndex );
+			void WaitForFence( const unsigned int i_fenceIndex );
+			void ReleaseFence( const unsigned int i_fenceIndex );
+			void DeleteResource( const sResource& i_resource );
+			// This is called by the platform-specific DeferRelease() or DeferDelete()
+			void Defer( const sResource& i_resource );
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_FRAMEFENCES_H
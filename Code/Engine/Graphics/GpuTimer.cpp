@@ -0,0 +1,141 @@
+// Header Files
+//=============
+
+#include "GpuTimer.h"
+
+#include "../Asserts/Asserts.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Frame 0 is never measured, and so it means that there is no frame
+	const uint64_t s_noFrame = 0;
+
+	// The frame that each query was ended in (or s_noFrame if the query isn't in flight);
+	// the query of a frame is always the one at ( frame % s_queryCount )
+	uint64_t s_queryFrames[eae6320::Graphics::GpuTimer::s_queryCount] = { 0 };
+	uint64_t s_currentFrame = 1;
+	bool s_isCurrentFrameBeingMeasured = false;
+
+	uint64_t s_latestMeasuredFrame = s_noFrame;
+	float s_elapsedSecondCount_latestFrame = 0.0f;
+	bool s_isInitialized = false;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void ReadWrittenQueries();
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::GpuTimer::BeginFrame()
+{
+	EAE6320_ASSERT( s_isInitialized );
+	EAE6320_ASSERT( !s_isCurrentFrameBeingMeasured );
+
+	ReadWrittenQueries();
+	const unsigned int queryIndex = static_cast<unsigned int>( s_currentFrame % s_queryCount );
+	s_isCurrentFrameBeingMeasured = s_queryFrames[queryIndex] == s_noFrame;
+	if ( s_isCurrentFrameBeingMeasured )
+	{
+		BeginQuery( queryIndex );
+	}
+}
+
+void eae6320::Graphics::GpuTimer::EndFrame()
+{
+	EAE6320_ASSERT( s_isInitialized );
+
+	if ( s_isCurrentFrameBeingMeasured )
+	{
+		const unsigned int queryIndex = static_cast<unsigned int>( s_currentFrame % s_queryCount );
+		EndQuery( queryIndex );
+		s_queryFrames[queryIndex] = s_currentFrame;
+		s_isCurrentFrameBeingMeasured = false;
+	}
+	++s_currentFrame;
+}
+
+// Access
+//-------
+
+float eae6320::Graphics::GpuTimer::GetElapsedSecondCount_latestFrame()
+{
+	return s_elapsedSecondCount_latestFrame;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::GpuTimer::Initialize()
+{
+	EAE6320_ASSERT( !s_isInitialized );
+	if ( !CreateQueries() )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+	for ( unsigned int i = 0; i < s_queryCount; ++i )
+	{
+		s_queryFrames[i] = s_noFrame;
+	}
+	s_currentFrame = 1;
+	s_isCurrentFrameBeingMeasured = false;
+	s_latestMeasuredFrame = s_noFrame;
+	s_elapsedSecondCount_latestFrame = 0.0f;
+	s_isInitialized = true;
+	return true;
+}
+
+bool eae6320::Graphics::GpuTimer::CleanUp()
+{
+	if ( !s_isInitialized )
+	{
+		return true;
+	}
+
+	// Queries that are still in flight are simply abandoned
+	DestroyQueries();
+	s_isInitialized = false;
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void ReadWrittenQueries()
+	{
+		for ( unsigned int i = 0; i < eae6320::Graphics::GpuTimer::s_queryCount; ++i )
+		{
+			const uint64_t frame = s_queryFrames[i];
+			if ( frame != s_noFrame )
+			{
+				bool isValid;
+				double secondCount;
+				if ( eae6320::Graphics::GpuTimer::GetQueryResult( i, isValid, secondCount ) )
+				{
+					// The queries are read in index order rather than frame order,
+					// and so an older frame mustn't replace a newer one
+					if ( isValid && ( frame > s_latestMeasuredFrame ) )
+					{
+						s_latestMeasuredFrame = frame;
+						s_elapsedSecondCount_latestFrame = static_cast<float>( secondCount );
+					}
+					s_queryFrames[i] = s_noFrame;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,72 @@
+/*
+	The GPU timer measures how long the GPU spends on each frame
+
+	A timestamp is written before anything in the frame is submitted and another one after everything has been drawn
+	(before the frame is presented, so that waiting for the vertical blank isn't measured).
+	The timestamps of up to s_queryCount frames can be in flight at once,
+	and they are read without waiting:
+	the time that is reported is from the most recent frame whose timestamps the GPU has written,
+	which is usually a few frames old.
+	If a frame's queries are still in flight when they would be reused that frame isn't measured.
+*/
+
+#ifndef EAE6320_GRAPHICS_GPUTIMER_H
+#define EAE6320_GRAPHICS_GPUTIMER_H
+
+// Header Files
+//=============
+
+#include "FrameFences.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace GpuTimer
+		{
+			// One more than the frames that can be in flight
+			// so that a frame's queries have usually been written by the time they are reused
+			const unsigned int s_queryCount = FrameFences::s_maxFrameCountInFlight + 1;
+
+			// Render
+			//-------
+
+			// These must be called from the render thread:
+			// BeginFrame() before anything in the frame is submitted,
+			// and EndFrame() after everything has been drawn but before the frame is presented
+			void BeginFrame();
+			void EndFrame();
+
+			// Access
+			//-------
+
+			// This is zero until the first frame has been measured
+			float GetElapsedSecondCount_latestFrame();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Initialize();
+			bool CleanUp();
+
+			// Implementation
+			//===============
+
+			// These are platform-specific and are only called by GpuTimer.cpp
+			// (every frame's queries have an index from 0 to s_queryCount - 1)
+			bool CreateQueries();
+			void DestroyQueries();
+			void BeginQuery( const unsigned int i_queryIndex );
+			void EndQuery( const unsigned int i_queryIndex );
+			// This returns false if the GPU hasn't written the timestamps yet.
+			// If it has but they can't be used (e.g. because the GPU's clock changed during the frame)
+			// o_isValid is false.
+			bool GetQueryResult( const unsigned int i_queryIndex, bool& o_isValid, double& o_secondCount );
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_GPUTIMER_H
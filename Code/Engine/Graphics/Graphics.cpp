@@ -2,3 +2,540 @@
 //=============
 
 #include "Graphics.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "CommandList.h"
+#include "Font.h"
+#include "GpuTimer.h"
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	struct sDrawRequest
+	{
+		eae6320::Graphics::Mesh* mesh;
+		const eae6320::Graphics::Material* material;
+		// This is NULL if the material doesn't sample a texture
+		const eae6320::Graphics::Texture* texture;
+	};
+	struct sSkinnedMeshDrawRequest
+	{
+		eae6320::Graphics::SkinnedMesh* skinnedMesh;
+		const eae6320::Graphics::Material* material;
+	};
+	struct sTerrainDrawRequest
+	{
+		eae6320::Graphics::Terrain* terrain;
+		const eae6320::Graphics::Material* material;
+	};
+	struct sParticleDrawRequest
+	{
+		eae6320::Graphics::ParticleEmitter* emitter;
+		const eae6320::Graphics::Material* material;
+	};
+	struct sTextDrawRequest
+	{
+		eae6320::Graphics::TextBatch* textBatch;
+		const eae6320::Graphics::Material* material;
+	};
+
+	// The list of renderables to be drawn
+	std::vector<sDrawRequest> s_listOfRenderables;
+	// The list of terrains to be drawn after the renderables
+	std::vector<sTerrainDrawRequest> s_listOfTerrains;
+	// The list of skinned meshes to be drawn after the terrains
+	std::vector<sSkinnedMeshDrawRequest> s_listOfSkinnedMeshes;
+	// The list of particle emitters to be drawn after the skinned meshes
+	std::vector<sParticleDrawRequest> s_listOfParticleEmitters;
+	// The list of text batches to be drawn over the scene
+	std::vector<sTextDrawRequest> s_listOfTextBatches;
+	// The lights that the scene is shaded with
+	eae6320::Graphics::ClusteredLights* s_clusteredLights = NULL;
+
+	eae6320::Graphics::sRenderStats s_renderStats = { 0 };
+
+	// This struct determines the layout of the constant data that the CPU will send to the GPU every frame
+	struct sFrameConstants
+	{
+		float g_elapsedSecondCount_total;
+		float padding;
+		// The fraction of the scene's target that the scene was rendered to
+		// (the upscale pass only samples that part)
+		float g_sceneTextureCoordinateScale[2];
+	};
+
+	// The renderables are recorded in batches, each into its own command list, in parallel.
+	// The first list sets the frame constants and the last one draws the terrains, the skinned meshes, and the particles.
+	// The lists (and the memory they have grown to) are kept from frame to frame.
+	std::vector<eae6320::Graphics::CommandList> s_commandLists;
+	// Each list counts its own state changes so that recording doesn't need to be synchronized
+	std::vector<eae6320::Graphics::sRenderStats> s_commandListStats;
+	const unsigned int s_renderablesPerCommandList = 256;
+
+	// The graph is rebuilt every frame but keeps its render targets
+	eae6320::Graphics::RenderGraph s_renderGraph;
+
+	// When the scene is rendered at less than the back buffer's resolution
+	// it is rendered to the corner of a full-size target (so that the target is never recreated when the scale changes)
+	// and then upscaled by drawing a quad that covers the back buffer
+	eae6320::Graphics::DynamicResolution s_dynamicResolution;
+	float s_resolutionScale = 1.0f;
+	float s_sceneTextureCoordinateScale[2] = { 1.0f, 1.0f };
+	// This is the longer of how long the CPU worked on the previous frame (from the start of the frame until it was presented)
+	// and how long the GPU worked on the latest frame that it has finished
+	float s_workSecondCount_previousFrame = 0.0f;
+	eae6320::Graphics::Material* s_upscaleMaterial = NULL;
+	eae6320::Graphics::Mesh s_upscaleQuad;
+
+	// The overlay pass lays text out in the back buffer's pixels
+	eae6320::Graphics::sTargetDescription s_backBufferDescription;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// Records binding whatever parts of the material are different from the currently bound material
+	void BindMaterial( const eae6320::Graphics::Material& i_material, const eae6320::Graphics::Material*& io_boundMaterial,
+		eae6320::Graphics::CommandList& io_commandList, eae6320::Graphics::sRenderStats& io_stats );
+	bool IsDrawnBefore( const sDrawRequest& i_lhs, const sDrawRequest& i_rhs );
+	// This is a Jobs::fJob that records a batch of renderables
+	void RecordRenderables( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+
+	// Render Passes
+	void ExecuteScenePass( const eae6320::Graphics::RenderGraph& i_graph, void* const io_userData );
+	// The user data is the index of the scene's target
+	void ExecuteUpscalePass( const eae6320::Graphics::RenderGraph& i_graph, void* const io_userData );
+	void ExecuteOverlayPass( const eae6320::Graphics::RenderGraph& i_graph, void* const io_userData );
+	void ClearSubmittedTextBatches();
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::DrawSubmittedObjects()
+{
+	// Sorting by effect first means that the most expensive state changes happen the fewest times.
+	// The sort is stable so that objects with the same material are drawn in the order they were submitted.
+	std::stable_sort( s_listOfRenderables.begin(), s_listOfRenderables.end(), IsDrawnBefore );
+
+	const unsigned int renderableCount = static_cast<unsigned int>( s_listOfRenderables.size() );
+	const unsigned int batchCount = ( renderableCount + s_renderablesPerCommandList - 1 ) / s_renderablesPerCommandList;
+	const unsigned int commandListCount = batchCount + 2;
+	if ( s_commandLists.size() < commandListCount )
+	{
+		s_commandLists.resize( commandListCount );
+		s_commandListStats.resize( commandListCount );
+	}
+	for ( unsigned int i = 0; i < commandListCount; ++i )
+	{
+		s_commandLists[i].Reset();
+		const sRenderStats noStats = { 0 };
+		s_commandListStats[i] = noStats;
+	}
+
+	// Record
+	{
+		// The frame constants
+		{
+			sFrameConstants frameConstants;
+			frameConstants.g_elapsedSecondCount_total = Time::GetElapsedSecondCount_total();
+			frameConstants.padding = 0.0f;
+			frameConstants.g_sceneTextureCoordinateScale[0] = s_sceneTextureCoordinateScale[0];
+			frameConstants.g_sceneTextureCoordinateScale[1] = s_sceneTextureCoordinateScale[1];
+			s_commandLists[0].SetConstants( eConstantBuffer::Frame, &frameConstants, sizeof( frameConstants ) );
+		}
+		// The renderables
+		if ( renderableCount > 0 )
+		{
+			Jobs::ParallelFor( renderableCount, s_renderablesPerCommandList, RecordRenderables, NULL );
+		}
+		// Skinned meshes skin their vertices across the worker threads when they are drawn,
+		// and so they are recorded on this thread into the last list.
+		// Particles are blended with what is behind them and so can't be reordered.
+		{
+			CommandList& commandList = s_commandLists[commandListCount - 1];
+			sRenderStats& stats = s_commandListStats[commandListCount - 1];
+			const Material* boundMaterial = ( renderableCount > 0 ) ? s_listOfRenderables.back().material : NULL;
+			for ( std::vector<sTerrainDrawRequest>::iterator i = s_listOfTerrains.begin(); i != s_listOfTerrains.end(); ++i )
+			{
+				BindMaterial( *i->material, boundMaterial, commandList, stats );
+				commandList.DrawTerrain( *i->terrain );
+				stats.drawCallCount += i->terrain->GetStats().drawnTileCount;
+			}
+			for ( std::vector<sSkinnedMeshDrawRequest>::iterator i = s_listOfSkinnedMeshes.begin(); i != s_listOfSkinnedMeshes.end(); ++i )
+			{
+				BindMaterial( *i->material, boundMaterial, commandList, stats );
+				commandList.DrawSkinnedMesh( *i->skinnedMesh );
+				++stats.drawCallCount;
+			}
+			for ( std::vector<sParticleDrawRequest>::iterator i = s_listOfParticleEmitters.begin(); i != s_listOfParticleEmitters.end(); ++i )
+			{
+				BindMaterial( *i->material, boundMaterial, commandList, stats );
+				commandList.DrawParticles( *i->emitter );
+				++stats.drawCallCount;
+			}
+		}
+	}
+	// Execute
+	{
+		if ( s_clusteredLights )
+		{
+			s_clusteredLights->Bind();
+		}
+		sRenderStats stats = { 0 };
+		for ( unsigned int i = 0; i < commandListCount; ++i )
+		{
+			s_commandLists[i].Execute();
+			stats.drawCallCount += s_commandListStats[i].drawCallCount;
+			stats.materialSwitchCount += s_commandListStats[i].materialSwitchCount;
+			stats.effectSwitchCount += s_commandListStats[i].effectSwitchCount;
+			stats.parameterBlockSwitchCount += s_commandListStats[i].parameterBlockSwitchCount;
+		}
+		s_renderStats = stats;
+	}
+
+	s_listOfRenderables.clear();
+	s_listOfTerrains.clear();
+	s_listOfSkinnedMeshes.clear();
+	s_listOfParticleEmitters.clear();
+	s_clusteredLights = NULL;
+}
+
+bool eae6320::Graphics::ExecuteRenderGraph( const sTargetDescription& i_backBufferDescription )
+{
+	s_renderGraph.Reset();
+	const unsigned int backBuffer = s_renderGraph.ImportBackBuffer( i_backBufferDescription );
+	s_backBufferDescription = i_backBufferDescription;
+
+	// The resolution that the scene is rendered at depends on how long the previous frame's work took
+	// (nothing has been measured before the first frame)
+	if ( s_workSecondCount_previousFrame > 0.0f )
+	{
+		s_dynamicResolution.Update( s_workSecondCount_previousFrame );
+	}
+	s_resolutionScale = s_dynamicResolution.GetScale();
+	uint16_t sceneWidth, sceneHeight;
+	{
+		const float width = static_cast<float>( i_backBufferDescription.width ) * s_resolutionScale;
+		const float height = static_cast<float>( i_backBufferDescription.height ) * s_resolutionScale;
+		sceneWidth = std::min( static_cast<uint16_t>( std::max( width + 0.5f, 1.0f ) ), i_backBufferDescription.width );
+		sceneHeight = std::min( static_cast<uint16_t>( std::max( height + 0.5f, 1.0f ) ), i_backBufferDescription.height );
+	}
+	// At full resolution the scene is rendered straight to the back buffer
+	const bool shouldSceneBeUpscaled = ( sceneWidth != i_backBufferDescription.width )
+		|| ( sceneHeight != i_backBufferDescription.height );
+	unsigned int scene = backBuffer;
+	if ( shouldSceneBeUpscaled )
+	{
+		// The target always has the back buffer's description
+		// so that the same physical target is reused no matter what the scale is
+		scene = s_renderGraph.CreateTransientTarget( "Scene", i_backBufferDescription );
+	}
+	s_sceneTextureCoordinateScale[0] = static_cast<float>( sceneWidth ) / static_cast<float>( i_backBufferDescription.width );
+	s_sceneTextureCoordinateScale[1] = static_cast<float>( sceneHeight ) / static_cast<float>( i_backBufferDescription.height );
+
+	// Every frame an entirely new image will be created.
+	// Before drawing anything, then, the previous image will be erased
+	// by "clearing" the image buffer (filling it with a solid color)
+	{
+		const unsigned int scenePass = s_renderGraph.AddPass( "Scene", ExecuteScenePass, NULL );
+		// Black is usually used
+		const float clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		s_renderGraph.Write( scenePass, scene, clearColor );
+		s_renderGraph.SetViewport( scenePass, sceneWidth, sceneHeight );
+	}
+	// The upscaled scene covers the entire back buffer, and so it doesn't need to be cleared
+	if ( shouldSceneBeUpscaled )
+	{
+		const unsigned int upscalePass = s_renderGraph.AddPass( "Upscale", ExecuteUpscalePass, &scene );
+		s_renderGraph.Read( upscalePass, scene );
+		s_renderGraph.Write( upscalePass, backBuffer );
+	}
+	// Text is drawn after the scene (and after it has been upscaled) so that it is always sharp
+	if ( !s_listOfTextBatches.empty() )
+	{
+		const unsigned int overlayPass = s_renderGraph.AddPass( "Overlay", ExecuteOverlayPass, NULL );
+		s_renderGraph.Write( overlayPass, backBuffer );
+	}
+
+	if ( s_renderGraph.Compile() && s_renderGraph.Execute() )
+	{
+		return true;
+	}
+	else
+	{
+		// Nothing was drawn, but the objects that were submitted still shouldn't be drawn next frame
+		s_listOfRenderables.clear();
+		s_listOfTerrains.clear();
+		s_listOfSkinnedMeshes.clear();
+		s_listOfParticleEmitters.clear();
+		s_clusteredLights = NULL;
+		ClearSubmittedTextBatches();
+		return false;
+	}
+}
+
+void eae6320::Graphics::BeginFrameWork()
+{
+	GpuTimer::BeginFrame();
+}
+
+void eae6320::Graphics::EndFrameWork()
+{
+	GpuTimer::EndFrame();
+	// The CPU's work started when the application started the frame
+	// (after the frame pacer had finished waiting)
+	const float secondCount_cpu = static_cast<float>(
+		Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - Time::GetFrameStartSystemTimeTickCount() ) );
+	// The GPU's timestamps are read without waiting, and so its time is usually from a few frames ago
+	const float secondCount_gpu = GpuTimer::GetElapsedSecondCount_latestFrame();
+	s_workSecondCount_previousFrame = std::max( secondCount_cpu, secondCount_gpu );
+}
+
+// Submit for Drawing
+//-------
+
+void eae6320::Graphics::SubmitObject( Mesh* i_mesh, const Material* i_material, const Texture* i_texture )
+{
+	EAE6320_ASSERT( i_mesh && i_material );
+	const sDrawRequest drawRequest = { i_mesh, i_material, i_texture };
+	s_listOfRenderables.push_back( drawRequest );
+}
+
+void eae6320::Graphics::SubmitSkinnedMesh( SkinnedMesh* i_skinnedMesh, const Material* i_material )
+{
+	EAE6320_ASSERT( i_skinnedMesh && i_material );
+	const sSkinnedMeshDrawRequest drawRequest = { i_skinnedMesh, i_material };
+	s_listOfSkinnedMeshes.push_back( drawRequest );
+}
+
+void eae6320::Graphics::SubmitTerrain( Terrain* i_terrain, const Material* i_material )
+{
+	EAE6320_ASSERT( i_terrain && i_material );
+	const sTerrainDrawRequest drawRequest = { i_terrain, i_material };
+	s_listOfTerrains.push_back( drawRequest );
+}
+
+void eae6320::Graphics::SubmitParticleEmitter( ParticleEmitter* i_emitter, const Material* i_material )
+{
+	EAE6320_ASSERT( i_emitter && i_material );
+	const sParticleDrawRequest drawRequest = { i_emitter, i_material };
+	s_listOfParticleEmitters.push_back( drawRequest );
+}
+
+void eae6320::Graphics::SubmitTextBatch( TextBatch* i_textBatch, const Material* i_material )
+{
+	EAE6320_ASSERT( i_textBatch && i_material );
+	const sTextDrawRequest drawRequest = { i_textBatch, i_material };
+	s_listOfTextBatches.push_back( drawRequest );
+}
+
+void eae6320::Graphics::SubmitLights( ClusteredLights* i_clusteredLights )
+{
+	EAE6320_ASSERT( i_clusteredLights );
+	s_clusteredLights = i_clusteredLights;
+}
+
+// Statistics
+//-----------
+
+const eae6320::Graphics::sRenderStats& eae6320::Graphics::GetRenderStats()
+{
+	return s_renderStats;
+}
+
+const eae6320::Graphics::RenderGraph::sStats& eae6320::Graphics::GetRenderGraphStats()
+{
+	return s_renderGraph.GetStats();
+}
+
+// Dynamic Resolution
+//-------------------
+
+float eae6320::Graphics::GetResolutionScale()
+{
+	return s_resolutionScale;
+}
+
+eae6320::Graphics::DynamicResolution& eae6320::Graphics::GetDynamicResolution()
+{
+	return s_dynamicResolution;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::InitializeRenderGraph( const DynamicResolution::sSettings& i_dynamicResolutionSettings )
+{
+	s_dynamicResolution.SetSettings( i_dynamicResolutionSettings );
+	s_workSecondCount_previousFrame = 0.0f;
+	if ( !GpuTimer::Initialize() )
+	{
+		return false;
+	}
+	s_upscaleMaterial = Material::Load( "data/upscale.material" );
+	if ( !s_upscaleMaterial )
+	{
+		return false;
+	}
+	return s_upscaleQuad.Initialize();
+}
+
+bool eae6320::Graphics::CleanUpRenderGraph()
+{
+	bool wereThereErrors = false;
+
+	if ( !s_renderGraph.CleanUp() )
+	{
+		wereThereErrors = true;
+	}
+	if ( !s_upscaleQuad.CleanUp() )
+	{
+		wereThereErrors = true;
+	}
+	if ( s_upscaleMaterial )
+	{
+		s_upscaleMaterial->Release();
+		s_upscaleMaterial = NULL;
+	}
+	if ( !GpuTimer::CleanUp() )
+	{
+		wereThereErrors = true;
+	}
+
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void BindMaterial( const eae6320::Graphics::Material& i_material, const eae6320::Graphics::Material*& io_boundMaterial,
+		eae6320::Graphics::CommandList& io_commandList, eae6320::Graphics::sRenderStats& io_stats )
+	{
+		// Identical materials are shared when they are loaded,
+		// and so if the address is the same there is nothing to do
+		if ( &i_material == io_boundMaterial )
+		{
+			return;
+		}
+		++io_stats.materialSwitchCount;
+		if ( !io_boundMaterial || ( i_material.GetEffectHash() != io_boundMaterial->GetEffectHash() ) )
+		{
+			io_commandList.BindEffect( i_material );
+			++io_stats.effectSwitchCount;
+		}
+		if ( !io_boundMaterial || ( i_material.GetParameterBlockHash() != io_boundMaterial->GetParameterBlockHash() ) )
+		{
+			io_commandList.BindParameterBlock( i_material );
+			++io_stats.parameterBlockSwitchCount;
+		}
+		io_boundMaterial = &i_material;
+	}
+
+	bool IsDrawnBefore( const sDrawRequest& i_lhs, const sDrawRequest& i_rhs )
+	{
+		const uint64_t effectHash_lhs = i_lhs.material->GetEffectHash();
+		const uint64_t effectHash_rhs = i_rhs.material->GetEffectHash();
+		if ( effectHash_lhs != effectHash_rhs )
+		{
+			return effectHash_lhs < effectHash_rhs;
+		}
+		const uint64_t parameterBlockHash_lhs = i_lhs.material->GetParameterBlockHash();
+		const uint64_t parameterBlockHash_rhs = i_rhs.material->GetParameterBlockHash();
+		if ( parameterBlockHash_lhs != parameterBlockHash_rhs )
+		{
+			return parameterBlockHash_lhs < parameterBlockHash_rhs;
+		}
+		else
+		{
+			return std::less<const eae6320::Graphics::Texture*>()( i_lhs.texture, i_rhs.texture );
+		}
+	}
+
+	void RecordRenderables( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+	{
+		// The first list is the frame constants
+		const unsigned int commandListIndex = 1 + ( i_begin / s_renderablesPerCommandList );
+		eae6320::Graphics::CommandList& commandList = s_commandLists[commandListIndex];
+		eae6320::Graphics::sRenderStats& stats = s_commandListStats[commandListIndex];
+		// The lists are executed in order,
+		// and so whatever the previous batch ended with will still be bound when this one starts
+		// (and nothing is assumed to be bound when the first batch starts)
+		const eae6320::Graphics::Material* boundMaterial = ( i_begin > 0 ) ? s_listOfRenderables[i_begin - 1].material : NULL;
+		const eae6320::Graphics::Texture* boundTexture = ( i_begin > 0 ) ? s_listOfRenderables[i_begin - 1].texture : NULL;
+		for ( unsigned int i = i_begin; i < i_end; ++i )
+		{
+			const sDrawRequest& drawRequest = s_listOfRenderables[i];
+			BindMaterial( *drawRequest.material, boundMaterial, commandList, stats );
+			if ( drawRequest.texture && ( drawRequest.texture != boundTexture ) )
+			{
+				const unsigned int textureUnit = 0;
+				commandList.BindTexture( *drawRequest.texture, textureUnit );
+				boundTexture = drawRequest.texture;
+			}
+			commandList.DrawMesh( *drawRequest.mesh );
+			++stats.drawCallCount;
+		}
+	}
+
+	// Render Passes
+
+	void ExecuteScenePass( const eae6320::Graphics::RenderGraph& i_graph, void* const io_userData )
+	{
+		// Bind each material and draw the objects that use it
+		eae6320::Graphics::DrawSubmittedObjects();
+	}
+
+	void ExecuteUpscalePass( const eae6320::Graphics::RenderGraph& i_graph, void* const io_userData )
+	{
+		const unsigned int scene = *static_cast<const unsigned int*>( io_userData );
+		const unsigned int textureUnit = 0;
+		i_graph.BindTexture( scene, textureUnit );
+		s_upscaleMaterial->BindEffect();
+		s_upscaleMaterial->BindParameterBlock();
+		// The quad's vertices are in [0,1], and the upscale vertex shader stretches it to cover the target
+		s_upscaleQuad.Draw();
+	}
+
+	void ExecuteOverlayPass( const eae6320::Graphics::RenderGraph& i_graph, void* const io_userData )
+	{
+		const eae6320::Graphics::Material* boundMaterial = NULL;
+		const unsigned int textureUnit = 0;
+		for ( std::vector<sTextDrawRequest>::iterator i = s_listOfTextBatches.begin(); i != s_listOfTextBatches.end(); ++i )
+		{
+			if ( i->material != boundMaterial )
+			{
+				i->material->BindEffect();
+				i->material->BindParameterBlock();
+				boundMaterial = i->material;
+			}
+			i->textBatch->GetTexture().Bind( textureUnit );
+			i->textBatch->Draw( s_backBufferDescription.width, s_backBufferDescription.height );
+			++s_renderStats.drawCallCount;
+		}
+		s_listOfTextBatches.clear();
+	}
+
+	void ClearSubmittedTextBatches()
+	{
+		for ( std::vector<sTextDrawRequest>::iterator i = s_listOfTextBatches.begin(); i != s_listOfTextBatches.end(); ++i )
+		{
+			i->textBatch->Clear();
+		}
+		s_listOfTextBatches.clear();
+	}
+}
@@ -8,8 +8,21 @@
 // Header Files
 //=============
 
+#include "AssetLoader.h"
+#include "ClusteredLights.h"
 #include "Configuration.h"
+#include "DynamicResolution.h"
+#include "FrameFences.h"
+#include "Material.h"
 #include "Mesh.h"
+#include "ParticleEmitter.h"
+#include "RenderGraph.h"
+#include "SkinnedMesh.h"
+#include "Statistics.h"
+#include "Terrain.h"
+#include "TextBatch.h"
+#include "TextureStreamer.h"
+#include "UploadManager.h"
 #if defined( EAE6320_PLATFORM_WINDOWS )
 	#include "../Windows/Includes.h"
 #endif
@@ -21,15 +34,102 @@ namespace eae6320
 {
 	namespace Graphics
 	{
+		namespace ePresentMode
+		{
+			enum ePresentMode
+			{
+				// Frames are presented as soon as they are rendered
+				Uncapped,
+				// Frames are presented at the display's refresh rate,
+				// and the driver can queue as many frames as it usually does
+				VSync,
+				// Frames are presented as soon as they are rendered,
+				// but the application waits so that they aren't rendered faster than a target frame rate
+				TargetFrameRate,
+				// Frames are presented at the display's refresh rate,
+				// but the CPU can't get more than a single frame ahead of the GPU
+				LowLatency,
+
+				Count
+			};
+		}
+
 		// Render
 		//-------
 
 		void RenderFrame();
+		// This is called by the scene pass
+		// to draw everything that was submitted since the previous frame
+		// (the draws are recorded into command lists in parallel and then executed on this thread)
+		void DrawSubmittedObjects();
+		// This is called by the platform-specific RenderFrame()
+		// to build the frame's render graph and execute it
+		// (the passes that draw the scene call DrawSubmittedObjects())
+		bool ExecuteRenderGraph( const sTargetDescription& i_backBufferDescription );
+		// These are called by the platform-specific RenderFrame()
+		// before anything in the frame is submitted and after everything has been drawn but before it is presented.
+		// Dynamic resolution is driven by how long the CPU and the GPU worked on the frame,
+		// not by how long the frame took once it was paced or waited for the vertical blank.
+		void BeginFrameWork();
+		void EndFrameWork();
 
 		// Submit for Drawing
 		//-------
 
-		void SubmitObject(Mesh * object);
+		// Meshes are sorted by material before they are drawn,
+		// terrains and then skinned meshes are drawn after all of the meshes,
+		// and particle emitters are drawn after everything else (both in the order they were submitted).
+		// A skinned mesh's animator must have been updated before the mesh is submitted.
+		// If a texture is provided it is bound to unit 0 before the mesh is drawn
+		// (meshes with the same material are then sorted by texture)
+		void SubmitObject( Mesh* i_mesh, const Material* i_material, const Texture* i_texture = NULL );
+		void SubmitSkinnedMesh( SkinnedMesh* i_skinnedMesh, const Material* i_material );
+		void SubmitParticleEmitter( ParticleEmitter* i_emitter, const Material* i_material );
+		// A terrain must have been updated before it is submitted
+		void SubmitTerrain( Terrain* i_terrain, const Material* i_material );
+		// Text is drawn over the scene at the back buffer's resolution (in the order it was submitted)
+		// with the batch's font or atlas texture bound to unit 0,
+		// and the batch is cleared after it is drawn
+		void SubmitTextBatch( TextBatch* i_textBatch, const Material* i_material );
+		// The lights must have been assigned before they are submitted,
+		// and they are bound before anything in the scene is drawn
+		// (only the most recently submitted lights are used)
+		void SubmitLights( ClusteredLights* i_clusteredLights );
+
+		// Statistics
+		//-----------
+
+		// These are counted while drawing the previous frame
+		struct sRenderStats
+		{
+			unsigned int drawCallCount;
+			// A material switch is any change to the bound material,
+			// which will bind the effect, the parameter block, or both
+			unsigned int materialSwitchCount;
+			unsigned int effectSwitchCount;
+			unsigned int parameterBlockSwitchCount;
+		};
+		const sRenderStats& GetRenderStats();
+		// These are calculated when the previous frame's render graph was compiled
+		const RenderGraph::sStats& GetRenderGraphStats();
+
+		// Presentation
+		//-------------
+
+		// This is platform-specific
+		bool SetPresentMode( const ePresentMode::ePresentMode i_presentMode );
+		ePresentMode::ePresentMode GetPresentMode();
+		// How many frames the CPU can get ahead of the GPU in the current mode
+		// (this is platform-specific)
+		unsigned int GetMaxQueuedFrameCount();
+
+		// Dynamic Resolution
+		//-------------------
+
+		// The fraction of the back buffer's width and height that the scene was last rendered at
+		float GetResolutionScale();
+		// This can be used to change the settings or to get the history of frame times and scales
+		DynamicResolution& GetDynamicResolution();
 
 		// Initialization / Clean Up
 		//--------------------------
@@ -44,10 +144,22 @@ namespace eae6320
 			HINSTANCE thisInstanceOfTheApplication;
 	#endif
 #endif
+			TextureStreamer::sSettings textureStreamerSettings;
+			AssetLoader::sSettings assetLoaderSettings;
+			UploadManager::sSettings uploadManagerSettings;
+			DynamicResolution::sSettings dynamicResolutionSettings;
+			ePresentMode::ePresentMode presentMode;
+			// If statistics are tracked they are logged this often (or never if it is 0)
+			unsigned int statisticsLogPeriodInFrames;
 		};
 
 		bool Initialize( const sInitializationParameters& i_initializationParameters );
 		bool CleanUp();
+		// This is called by the platform-specific Initialize() after the device is created
+		// to load what the render graph's passes use
+		bool InitializeRenderGraph( const DynamicResolution::sSettings& i_dynamicResolutionSettings );
+		// This is called by the platform-specific CleanUp() before the device is destroyed
+		bool CleanUpRenderGraph();
 	}
 }
 
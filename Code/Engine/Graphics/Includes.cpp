@@ -14,6 +14,7 @@ namespace eae6320
 		{
 			context.direct3dDevice = i_context.direct3dDevice;
 			context.direct3dImmediateContext = i_context.direct3dImmediateContext;
+			context.backBufferView = i_context.backBufferView;
 		}
 	}
 }
\ No newline at end of file
@@ -23,6 +23,8 @@ namespace eae6320
 #if defined (EAE6320_PLATFORM_D3D)
 			ID3D11Device* direct3dDevice;
 			ID3D11DeviceContext* direct3dImmediateContext;
+			// The render graph binds this when a pass writes the back buffer
+			ID3D11RenderTargetView* backBufferView;
 #elif defined (EAE6320_PLATFORM_GL)
 
 #endif
@@ -0,0 +1,260 @@
+// Header Files
+//=============
+
+#include "Material.h"
+
+#include <cstring>
+#include <string>
+#include "Statistics.h"
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+#include "../Platform/Platform.h"
+
+// Static Data Initialization
+//===========================
+
+std::map<uint64_t, eae6320::Graphics::Material*> eae6320::Graphics::Material::s_materials;
+std::map<uint64_t, eae6320::Graphics::Material::sEffect*> eae6320::Graphics::Material::s_effects;
+std::map<uint64_t, eae6320::Graphics::Material::sParameterBuffer*> eae6320::Graphics::Material::s_parameterBuffers;
+
+// Interface
+//==========
+
+// Access
+//-------
+
+uint64_t eae6320::Graphics::Material::GetEffectHash() const
+{
+	return m_effect->hash;
+}
+
+uint64_t eae6320::Graphics::Material::GetParameterBlockHash() const
+{
+	return m_parameterBuffer->hash;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+eae6320::Graphics::Material* eae6320::Graphics::Material::Load( const char* const i_path )
+{
+	bool wereThereErrors = false;
+
+	Material* material = NULL;
+	Platform::sDataFromFile dataFromFile;
+	const MaterialFormats::sHeader* header = NULL;
+
+	// Load the file
+	{
+		std::string errorMessage;
+		if ( !Platform::LoadBinaryFile( i_path, dataFromFile, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to load the material %s: %s", i_path, errorMessage.c_str() );
+			goto OnExit;
+		}
+	}
+	// Validate it
+	{
+		header = reinterpret_cast<const MaterialFormats::sHeader*>( dataFromFile.data );
+		if ( ( dataFromFile.size < sizeof( MaterialFormats::sHeader ) )
+			|| ( header->fourCc != MaterialFormats::s_fourCc ) || ( header->version != MaterialFormats::s_version ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Invalid material file" );
+			Logging::OutputError( "The material %s isn't a built material (or was built by a different version of the MaterialBuilder)", i_path );
+			goto OnExit;
+		}
+		if ( ( header->vertexShaderPathOffset >= dataFromFile.size ) || ( header->fragmentShaderPathOffset >= dataFromFile.size )
+			|| ( reinterpret_cast<const char*>( dataFromFile.data )[dataFromFile.size - 1] != '\0' ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Truncated material file" );
+			Logging::OutputError( "The material %s is shorter than its header says it should be", i_path );
+			goto OnExit;
+		}
+	}
+	// If an identical material has already been loaded it can be used instead
+	{
+		const std::map<uint64_t, Material*>::iterator loadedMaterial = s_materials.find( header->contentHash );
+		if ( loadedMaterial != s_materials.end() )
+		{
+			material = loadedMaterial->second;
+			++material->m_referenceCount;
+			goto OnExit;
+		}
+	}
+	material = new Material;
+	material->m_contentHash = header->contentHash;
+	// Find or create the effect
+	{
+		const std::map<uint64_t, sEffect*>::iterator loadedEffect = s_effects.find( header->effectHash );
+		if ( loadedEffect != s_effects.end() )
+		{
+			material->m_effect = loadedEffect->second;
+			++material->m_effect->referenceCount;
+		}
+		else
+		{
+			// The shader library paths are relative to the material
+			std::string path_directory( i_path );
+			{
+				const size_t slash = path_directory.find_last_of( "/\\" );
+				path_directory.resize( ( slash != std::string::npos ) ? ( slash + 1 ) : 0 );
+			}
+			const char* const fileData = reinterpret_cast<const char*>( dataFromFile.data );
+
+			sEffect* const effect = new sEffect;
+			sShaderVariant vertexShader, fragmentShader;
+			if ( !FindShaderVariant( path_directory + ( fileData + header->vertexShaderPathOffset ), header->vertexShaderKey,
+					ShaderLibraryFormats::eShaderType::Vertex, effect->vertexShaderLibrary, vertexShader )
+				|| !FindShaderVariant( path_directory + ( fileData + header->fragmentShaderPathOffset ), header->fragmentShaderKey,
+					ShaderLibraryFormats::eShaderType::Fragment, effect->fragmentShaderLibrary, fragmentShader )
+				|| !CreateEffect( vertexShader, fragmentShader, header->renderStates, header->vertexFormat, *effect ) )
+			{
+				wereThereErrors = true;
+				DestroyEffect( effect );
+				goto OnExit;
+			}
+			effect->hash = header->effectHash;
+			effect->referenceCount = 1;
+			s_effects.insert( std::make_pair( effect->hash, effect ) );
+			material->m_effect = effect;
+		}
+	}
+	// Find or create the parameter block
+	{
+		const std::map<uint64_t, sParameterBuffer*>::iterator loadedParameterBuffer = s_parameterBuffers.find( header->parameterBlockHash );
+		if ( loadedParameterBuffer != s_parameterBuffers.end() )
+		{
+			material->m_parameterBuffer = loadedParameterBuffer->second;
+			++material->m_parameterBuffer->referenceCount;
+		}
+		else
+		{
+			sParameterBuffer* const parameterBuffer = new sParameterBuffer;
+			if ( !CreateParameterBuffer( header->parameterBlock, *parameterBuffer ) )
+			{
+				wereThereErrors = true;
+				CleanUpParameterBuffer( *parameterBuffer );
+				delete parameterBuffer;
+				goto OnExit;
+			}
+			EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::ConstantBuffer, sizeof( header->parameterBlock ) ) );
+			EAE6320_GRAPHICS_STATISTICS( CountUpload( sizeof( header->parameterBlock ) ) );
+			parameterBuffer->hash = header->parameterBlockHash;
+			parameterBuffer->referenceCount = 1;
+			s_parameterBuffers.insert( std::make_pair( parameterBuffer->hash, parameterBuffer ) );
+			material->m_parameterBuffer = parameterBuffer;
+		}
+	}
+	material->m_referenceCount = 1;
+	s_materials.insert( std::make_pair( material->m_contentHash, material ) );
+
+OnExit:
+
+	dataFromFile.Free();
+
+	if ( wereThereErrors && material )
+	{
+		// Release() can't be used because the material was never added to s_materials
+		delete material;
+		material = NULL;
+	}
+
+	return material;
+}
+
+void eae6320::Graphics::Material::Release()
+{
+	EAE6320_ASSERT( m_referenceCount > 0 );
+	if ( --m_referenceCount == 0 )
+	{
+		s_materials.erase( m_contentHash );
+		delete this;
+	}
+}
+
+// Implementation
+//===============
+
+// Initialization / Clean Up
+//--------------------------
+
+eae6320::Graphics::Material::Material()
+	:
+	m_effect( NULL ), m_parameterBuffer( NULL ), m_contentHash( MaterialFormats::s_emptyHash ), m_referenceCount( 0 )
+{
+
+}
+
+eae6320::Graphics::Material::~Material()
+{
+	if ( m_effect )
+	{
+		EAE6320_ASSERT( m_effect->referenceCount > 0 );
+		if ( --m_effect->referenceCount == 0 )
+		{
+			s_effects.erase( m_effect->hash );
+			CleanUpEffect( *m_effect );
+			delete m_effect;
+		}
+		m_effect = NULL;
+	}
+	if ( m_parameterBuffer )
+	{
+		EAE6320_ASSERT( m_parameterBuffer->referenceCount > 0 );
+		if ( --m_parameterBuffer->referenceCount == 0 )
+		{
+			s_parameterBuffers.erase( m_parameterBuffer->hash );
+			CleanUpParameterBuffer( *m_parameterBuffer );
+			EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::ConstantBuffer, sizeof( MaterialFormats::sParameterBlock ) ) );
+			delete m_parameterBuffer;
+		}
+		m_parameterBuffer = NULL;
+	}
+}
+
+bool eae6320::Graphics::Material::FindShaderVariant( const std::string& i_path, const uint64_t i_key,
+	const ShaderLibraryFormats::eShaderType::eShaderType i_shaderType,
+	ShaderLibrary*& o_library, sShaderVariant& o_variant )
+{
+	o_library = ShaderLibrary::Load( i_path.c_str() );
+	if ( !o_library )
+	{
+		return false;
+	}
+	if ( o_library->GetShaderType() != i_shaderType )
+	{
+		EAE6320_ASSERTF( false, "Wrong shader type" );
+		Logging::OutputError( "The shader library %s is a %s shader", i_path.c_str(),
+			( i_shaderType == ShaderLibraryFormats::eShaderType::Vertex ) ? "fragment" : "vertex" );
+		return false;
+	}
+	if ( !o_library->Find( i_key, o_variant.data, o_variant.size ) )
+	{
+		EAE6320_ASSERTF( false, "Missing shader permutation" );
+		Logging::OutputError( "The shader library %s doesn't have the permutation with key 0x%016llx", i_path.c_str(),
+			static_cast<unsigned long long>( i_key ) );
+		return false;
+	}
+	o_variant.path = o_library->GetPath();
+	return true;
+}
+
+void eae6320::Graphics::Material::DestroyEffect( sEffect* const io_effect )
+{
+	CleanUpEffect( *io_effect );
+	if ( io_effect->vertexShaderLibrary )
+	{
+		io_effect->vertexShaderLibrary->Release();
+		io_effect->vertexShaderLibrary = NULL;
+	}
+	if ( io_effect->fragmentShaderLibrary )
+	{
+		io_effect->fragmentShaderLibrary->Release();
+		io_effect->fragmentShaderLibrary = NULL;
+	}
+	delete io_effect;
+}
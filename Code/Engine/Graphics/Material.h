@@ -0,0 +1,159 @@
+/*
+	A material is everything about how a mesh is drawn other than its geometry:
+		* An effect (the vertex and fragment shaders and the render states)
+			(each shader is one permutation from a shader library that the ShaderBuilder built)
+		* A parameter block (the constants that the shaders read)
+
+	Materials are built by the MaterialBuilder,
+	which calculates hashes so that identical things can be shared at run-time without comparing them:
+		* Loading a material that has already been loaded returns the same material
+		* Materials that use the same shaders and render states share a single effect
+		* Materials that use the same constants share a single parameter block
+	Since shared things have the same address the renderer can sort by them
+	and skip binding anything that is already bound.
+*/
+
+#ifndef EAE6320_GRAPHICS_MATERIAL_H
+#define EAE6320_GRAPHICS_MATERIAL_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include "MaterialFormats.h"
+#include "ShaderLibrary.h"
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Material
+		{
+		public:
+
+			// Render
+			//-------
+
+			// These should only be called when the previously bound effect or parameter block was different
+			void BindEffect() const;
+			void BindParameterBlock() const;
+
+			// Access
+			//-------
+
+			uint64_t GetContentHash() const { return m_contentHash; }
+			// Materials with the same effect hash share an effect
+			uint64_t GetEffectHash() const;
+			// Materials with the same parameter block hash share a parameter block
+			uint64_t GetParameterBlockHash() const;
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// If an identical material has already been loaded it is returned (with another reference) instead.
+			// Every successful Load() must be matched by a Release().
+			static Material* Load( const char* const i_path );
+			void Release();
+
+			// Implementation
+			//===============
+
+		private:
+
+			struct sEffect
+			{
+#if defined( EAE6320_PLATFORM_D3D )
+				ID3D11VertexShader* vertexShader;
+				ID3D11PixelShader* fragmentShader;
+				// D3D has an "input layout" object that associates the layout of sVertex
+				// with the input from a vertex shader
+				ID3D11InputLayout* vertexLayout;
+				ID3D11BlendState* blendState;
+				ID3D11DepthStencilState* depthStencilState;
+				ID3D11RasterizerState* rasterizerState;
+#elif defined( EAE6320_PLATFORM_GL )
+				// OpenGL encapsulates a matching vertex shader and fragment shader into what it calls a "program"
+				GLuint programId;
+				uint8_t renderStates;
+#endif
+				// The libraries are kept loaded so that they know which permutations were used
+				ShaderLibrary* vertexShaderLibrary;
+				ShaderLibrary* fragmentShaderLibrary;
+				uint64_t hash;
+				unsigned int referenceCount;
+
+				sEffect();
+			};
+
+			// A single permutation that was found in a shader library
+			// (this is compiled bytecode on Direct3D and source code on OpenGL)
+			struct sShaderVariant
+			{
+				const void* data;
+				size_t size;
+				// This is only used for error messages
+				const char* path;
+			};
+
+			struct sParameterBuffer
+			{
+#if defined( EAE6320_PLATFORM_D3D )
+				ID3D11Buffer* constantBuffer;
+#elif defined( EAE6320_PLATFORM_GL )
+				GLuint constantBufferId;
+#endif
+				uint64_t hash;
+				unsigned int referenceCount;
+
+				sParameterBuffer();
+			};
+
+			Material();
+			~Material();
+
+			// This finds the permutation in the library (and loads the library if necessary)
+			static bool FindShaderVariant( const std::string& i_path, const uint64_t i_key,
+				const ShaderLibraryFormats::eShaderType::eShaderType i_shaderType,
+				ShaderLibrary*& o_library, sShaderVariant& o_variant );
+			// This cleans up the effect, releases its shader libraries, and deletes it
+			static void DestroyEffect( sEffect* const io_effect );
+
+			// These are platform-specific
+			static bool CreateEffect( const sShaderVariant& i_vertexShader, const sShaderVariant& i_fragmentShader,
+				const uint8_t i_renderStates, const uint8_t i_vertexFormat, sEffect& o_effect );
+			static bool CleanUpEffect( sEffect& io_effect );
+			static bool CreateParameterBuffer( const MaterialFormats::sParameterBlock& i_parameterBlock, sParameterBuffer& o_parameterBuffer );
+			static bool CleanUpParameterBuffer( sParameterBuffer& io_parameterBuffer );
+
+			// Data
+			//=====
+
+		private:
+
+			// These are shared with any other materials that have the same hashes
+			sEffect* m_effect;
+			sParameterBuffer* m_parameterBuffer;
+			uint64_t m_contentHash;
+			unsigned int m_referenceCount;
+
+			// Everything that is currently loaded, keyed by hash
+			static std::map<uint64_t, Material*> s_materials;
+			static std::map<uint64_t, sEffect*> s_effects;
+			static std::map<uint64_t, sParameterBuffer*> s_parameterBuffers;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_MATERIAL_H
@@ -0,0 +1,118 @@
+/*
+	This file describes the layout of a built material file
+
+	It is shared between the MaterialBuilder (which writes the file)
+	and the runtime Material (which reads it),
+	and so it must not depend on any graphics platform.
+
+	A built material is:
+		* An sHeader
+		* The paths of the vertex and fragment shader libraries as NULL-terminated strings
+			(relative to the material file)
+	The header has the key of the permutation that the material uses from each library.
+	The hashes are calculated when the material is built
+	so that the runtime can find materials (and parts of materials) that are identical without comparing them.
+*/
+
+#ifndef EAE6320_GRAPHICS_MATERIALFORMATS_H
+#define EAE6320_GRAPHICS_MATERIALFORMATS_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace MaterialFormats
+		{
+			// "EMAT" read as a little-endian uint32_t
+			const uint32_t s_fourCc = 0x54414d45;
+			const uint16_t s_version = 3;
+
+			namespace eRenderState
+			{
+				enum eRenderState
+				{
+					AlphaTransparency = 1 << 0,
+					DepthTesting = 1 << 1,
+					DepthWriting = 1 << 2,
+					DrawBothTriangleSides = 1 << 3,
+				};
+			}
+
+			// The layout of the vertices that the material's vertex shader reads
+			// (Direct3D needs to know this when the effect is created)
+			namespace eVertexFormat
+			{
+				enum eVertexFormat
+				{
+					// sVertex (meshes)
+					Mesh,
+					// sTextVertex
+					Text,
+					// sParticleVertex
+					Particle,
+
+					Count
+				};
+			}
+
+			// This must match the materialConstants constant buffer in the shaders
+			struct sParameterBlock
+			{
+				float color[4];
+			};
+
+			struct sHeader
+			{
+				uint32_t fourCc;
+				uint16_t version;
+				// A combination of eRenderState flags
+				uint8_t renderStates;
+				// This is an eVertexFormat
+				uint8_t vertexFormat;
+				// Materials with the same content hash are identical
+				uint64_t contentHash;
+				// The effect is the shaders and render states
+				uint64_t effectHash;
+				uint64_t parameterBlockHash;
+				sParameterBlock parameterBlock;
+				// These identify the permutations in the shader libraries
+				uint64_t vertexShaderKey;
+				uint64_t fragmentShaderKey;
+				// These are offsets from the start of the file
+				uint16_t vertexShaderPathOffset;
+				uint16_t fragmentShaderPathOffset;
+				uint32_t padding1;
+			};
+
+			// Helper Functions
+			//-----------------
+
+			const uint64_t s_emptyHash = 14695981039346656037ull;
+
+			// 64-bit FNV-1a
+			// (a hash can be extended with more data by passing it back in)
+			inline uint64_t CalculateHash( const void* const i_data, const size_t i_size, const uint64_t i_hash = s_emptyHash )
+			{
+				uint64_t hash = i_hash;
+				const uint8_t* const data = reinterpret_cast<const uint8_t*>( i_data );
+				for ( size_t i = 0; i < i_size; ++i )
+				{
+					hash ^= data[i];
+					hash *= 1099511628211ull;
+				}
+				return hash;
+			}
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_MATERIALFORMATS_H
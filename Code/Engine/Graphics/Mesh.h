@@ -25,6 +25,8 @@ namespace eae6320
 			GLuint m_vertexArrayId = 0;
 			GLuint m_vertexBufferId = 0;
 #endif
+			// This is only used for statistics
+			unsigned int m_vertexBufferSize = 0;
 		};
 	}
 }
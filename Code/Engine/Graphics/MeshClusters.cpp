@@ -0,0 +1,658 @@
+// Header Files
+//=============
+
+#include "MeshClusters.h"
+
+#include <cfloat>
+#include <cmath>
+#include <xmmintrin.h>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// A triangle whose normal is further than this from the cluster's average normal isn't added to it
+	// (wider cones face away from fewer camera positions)
+	const float s_minNormalDotWithCluster = 0.5f;
+	// If any normal in a cluster is further than this from the cone's axis
+	// the cone is so wide that testing it isn't worth it
+	const float s_minNormalDotWithCone = 0.1f;
+
+	const unsigned int s_noCluster = ~0u;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	float Dot( const float i_lhs[3], const float i_rhs[3] );
+	void Cross( const float i_lhs[3], const float i_rhs[3], float o_result[3] );
+	void Subtract( const float i_lhs[3], const float i_rhs[3], float o_result[3] );
+	// This returns the original length (and leaves a zero vector unchanged)
+	float Normalize( float io_vector[3] );
+
+	void CalculateBounds( const float* const i_positions, const std::vector<uint32_t>& i_vertices,
+		eae6320::Graphics::MeshClusters::sCluster& io_cluster );
+	void CalculateCone( const std::vector<float>& i_triangleNormals, const uint32_t* const i_triangles, const unsigned int i_triangleCount,
+		const float i_normalSum[3], eae6320::Graphics::MeshClusters::sCluster& io_cluster );
+
+	void CreateBenchmarkSphere( const unsigned int i_stackCount, const unsigned int i_sliceCount,
+		std::vector<float>& o_positions, std::vector<uint32_t>& o_indices );
+}
+
+// Interface
+//==========
+
+// Build
+//------
+
+bool eae6320::Graphics::MeshClusters::Build( const float* const i_positions, const uint32_t i_vertexCount,
+	std::vector<uint32_t>& io_indices, const unsigned int i_maxTriangleCount, const unsigned int i_maxVertexCount )
+{
+	EAE6320_ASSERT( ( i_maxTriangleCount > 0 ) && ( i_maxVertexCount >= 3 ) );
+
+	m_clusters.clear();
+	m_triangleCount = 0;
+	if ( ( io_indices.size() % 3 ) != 0 )
+	{
+		EAE6320_ASSERTF( false, "Clusters can only be built from a triangle list" );
+		Logging::OutputError( "Mesh clusters can't be built from %u indices because it isn't a multiple of 3",
+			static_cast<unsigned int>( io_indices.size() ) );
+		return false;
+	}
+	for ( std::vector<uint32_t>::const_iterator i = io_indices.begin(); i != io_indices.end(); ++i )
+	{
+		if ( *i >= i_vertexCount )
+		{
+			EAE6320_ASSERTF( false, "Invalid index" );
+			Logging::OutputError( "Mesh clusters can't be built because the index %u refers to one of only %u vertices", *i, i_vertexCount );
+			return false;
+		}
+	}
+	const unsigned int triangleCount = static_cast<unsigned int>( io_indices.size() / 3 );
+
+	// Calculate every triangle's normal
+	// (a degenerate triangle's normal is zero and is ignored when calculating cones)
+	std::vector<float> triangleNormals( triangleCount * 3 );
+	for ( unsigned int i = 0; i < triangleCount; ++i )
+	{
+		const float* const a = i_positions + ( io_indices[i * 3 + 0] * 3 );
+		const float* const b = i_positions + ( io_indices[i * 3 + 1] * 3 );
+		const float* const c = i_positions + ( io_indices[i * 3 + 2] * 3 );
+		float ab[3], ac[3];
+		Subtract( b, a, ab );
+		Subtract( c, a, ac );
+		float* const normal = &triangleNormals[i * 3];
+		Cross( ab, ac, normal );
+		Normalize( normal );
+	}
+	// Find the triangles that use each vertex
+	std::vector<uint32_t> vertexTriangleOffsets( i_vertexCount + 1, 0 );
+	std::vector<uint32_t> vertexTriangles( io_indices.size() );
+	{
+		for ( std::vector<uint32_t>::const_iterator i = io_indices.begin(); i != io_indices.end(); ++i )
+		{
+			++vertexTriangleOffsets[*i + 1];
+		}
+		for ( uint32_t i = 0; i < i_vertexCount; ++i )
+		{
+			vertexTriangleOffsets[i + 1] += vertexTriangleOffsets[i];
+		}
+		std::vector<uint32_t> nextTriangleOffsets( vertexTriangleOffsets.begin(), vertexTriangleOffsets.end() - 1 );
+		for ( unsigned int i = 0; i < static_cast<unsigned int>( io_indices.size() ); ++i )
+		{
+			vertexTriangles[nextTriangleOffsets[io_indices[i]]++] = i / 3;
+		}
+	}
+
+	// Clusters are grown greedily from the first triangle that isn't in one yet:
+	// a cluster's next triangle is the neighbor that adds the fewest new vertices
+	// (and then the one that faces closest to the cluster's average normal)
+	std::vector<uint32_t> clusteredIndices;
+	clusteredIndices.reserve( io_indices.size() );
+	std::vector<bool> isTriangleClustered( triangleCount, false );
+	// Which cluster each vertex was last added to
+	std::vector<unsigned int> vertexClusters( i_vertexCount, s_noCluster );
+	std::vector<uint32_t> clusterVertices;
+	std::vector<uint32_t> clusterTriangles;
+	std::vector<uint32_t> candidateTriangles;
+	unsigned int nextSeedTriangle = 0;
+	while ( true )
+	{
+		while ( ( nextSeedTriangle < triangleCount ) && isTriangleClustered[nextSeedTriangle] )
+		{
+			++nextSeedTriangle;
+		}
+		if ( nextSeedTriangle >= triangleCount )
+		{
+			break;
+		}
+
+		const unsigned int clusterIndex = static_cast<unsigned int>( m_clusters.size() );
+		clusterVertices.clear();
+		clusterTriangles.clear();
+		candidateTriangles.clear();
+		float normalSum[3] = { 0.0f, 0.0f, 0.0f };
+		uint32_t triangleToAdd = nextSeedTriangle;
+		while ( true )
+		{
+			// Add the triangle
+			{
+				isTriangleClustered[triangleToAdd] = true;
+				clusterTriangles.push_back( triangleToAdd );
+				for ( unsigned int i = 0; i < 3; ++i )
+				{
+					const uint32_t vertex = io_indices[triangleToAdd * 3 + i];
+					if ( vertexClusters[vertex] != clusterIndex )
+					{
+						vertexClusters[vertex] = clusterIndex;
+						clusterVertices.push_back( vertex );
+					}
+					// Its neighbors become candidates
+					for ( uint32_t j = vertexTriangleOffsets[vertex]; j < vertexTriangleOffsets[vertex + 1]; ++j )
+					{
+						if ( !isTriangleClustered[vertexTriangles[j]] )
+						{
+							candidateTriangles.push_back( vertexTriangles[j] );
+						}
+					}
+					normalSum[i] += triangleNormals[triangleToAdd * 3 + i];
+				}
+			}
+			if ( clusterTriangles.size() >= i_maxTriangleCount )
+			{
+				break;
+			}
+			// Choose the next triangle
+			float clusterNormal[3] = { normalSum[0], normalSum[1], normalSum[2] };
+			const bool doesClusterHaveNormal = Normalize( clusterNormal ) > 0.0f;
+			float bestScore = FLT_MAX;
+			for ( size_t i = 0; i < candidateTriangles.size(); )
+			{
+				const uint32_t candidate = candidateTriangles[i];
+				if ( isTriangleClustered[candidate] )
+				{
+					candidateTriangles[i] = candidateTriangles.back();
+					candidateTriangles.pop_back();
+					continue;
+				}
+				unsigned int newVertexCount = 0;
+				for ( unsigned int j = 0; j < 3; ++j )
+				{
+					newVertexCount += ( vertexClusters[io_indices[candidate * 3 + j]] != clusterIndex ) ? 1 : 0;
+				}
+				const float normalDot = doesClusterHaveNormal ? Dot( clusterNormal, &triangleNormals[candidate * 3] ) : 1.0f;
+				if ( ( ( clusterVertices.size() + newVertexCount ) <= i_maxVertexCount ) && ( normalDot >= s_minNormalDotWithCluster ) )
+				{
+					// The normal only breaks ties between candidates that add the same number of vertices
+					const float score = static_cast<float>( newVertexCount ) - normalDot;
+					if ( score < bestScore )
+					{
+						bestScore = score;
+						triangleToAdd = candidate;
+					}
+				}
+				++i;
+			}
+			if ( bestScore == FLT_MAX )
+			{
+				break;
+			}
+		}
+
+		// Finish the cluster
+		sCluster cluster;
+		cluster.firstIndex = static_cast<uint32_t>( clusteredIndices.size() );
+		cluster.triangleCount = static_cast<uint32_t>( clusterTriangles.size() );
+		for ( std::vector<uint32_t>::const_iterator i = clusterTriangles.begin(); i != clusterTriangles.end(); ++i )
+		{
+			clusteredIndices.push_back( io_indices[*i * 3 + 0] );
+			clusteredIndices.push_back( io_indices[*i * 3 + 1] );
+			clusteredIndices.push_back( io_indices[*i * 3 + 2] );
+		}
+		CalculateBounds( i_positions, clusterVertices, cluster );
+		CalculateCone( triangleNormals, &clusterTriangles[0], cluster.triangleCount, normalSum, cluster );
+		m_clusters.push_back( cluster );
+	}
+	io_indices.swap( clusteredIndices );
+	m_triangleCount = triangleCount;
+
+	// Copy the culling data into padded arrays
+	{
+		const size_t clusterCount = m_clusters.size();
+		const size_t paddedCount = ( clusterCount + 3 ) & ~size_t( 3 );
+		std::vector<float>* const arrays[] =
+		{
+			&m_centerX, &m_centerY, &m_centerZ, &m_radius, &m_coneAxisX, &m_coneAxisY, &m_coneAxisZ, &m_coneCutoff
+		};
+		for ( size_t i = 0; i < ( sizeof( arrays ) / sizeof( arrays[0] ) ); ++i )
+		{
+			arrays[i]->assign( paddedCount, 0.0f );
+		}
+		for ( size_t i = 0; i < clusterCount; ++i )
+		{
+			const sCluster& cluster = m_clusters[i];
+			m_centerX[i] = cluster.center[0];
+			m_centerY[i] = cluster.center[1];
+			m_centerZ[i] = cluster.center[2];
+			m_radius[i] = cluster.radius;
+			m_coneAxisX[i] = cluster.coneAxis[0];
+			m_coneAxisY[i] = cluster.coneAxis[1];
+			m_coneAxisZ[i] = cluster.coneAxis[2];
+			m_coneCutoff[i] = cluster.coneCutoff;
+		}
+	}
+
+	return true;
+}
+
+// Cull
+//-----
+
+void eae6320::Graphics::MeshClusters::CalculateView( const float i_cameraPosition[3], const float i_targetPosition[3], const float i_up[3],
+	const float i_verticalFieldOfView, const float i_aspectRatio, const float i_zNear, const float i_zFar,
+	sView& o_view )
+{
+	float forward[3], right[3], up[3];
+	Subtract( i_targetPosition, i_cameraPosition, forward );
+	Normalize( forward );
+	Cross( forward, i_up, right );
+	Normalize( right );
+	Cross( right, forward, up );
+
+	const float tangent_vertical = std::tan( i_verticalFieldOfView * 0.5f );
+	const float tangent_horizontal = tangent_vertical * i_aspectRatio;
+	// Each side plane contains the camera position,
+	// and its normal is the direction that it faces tilted toward the forward direction
+	const float sideDirections[4][3] =
+	{
+		{ right[0], right[1], right[2] }, { -right[0], -right[1], -right[2] },
+		{ up[0], up[1], up[2] }, { -up[0], -up[1], -up[2] },
+	};
+	const float sideTangents[4] = { tangent_horizontal, tangent_horizontal, tangent_vertical, tangent_vertical };
+	for ( unsigned int i = 0; i < 4; ++i )
+	{
+		float* const plane = o_view.planes[i];
+		for ( unsigned int j = 0; j < 3; ++j )
+		{
+			plane[j] = sideDirections[i][j] + ( forward[j] * sideTangents[i] );
+		}
+		Normalize( plane );
+		plane[3] = -Dot( plane, i_cameraPosition );
+	}
+	// Near and far
+	{
+		float* const nearPlane = o_view.planes[4];
+		float* const farPlane = o_view.planes[5];
+		const float distanceToCamera = Dot( forward, i_cameraPosition );
+		for ( unsigned int j = 0; j < 3; ++j )
+		{
+			nearPlane[j] = forward[j];
+			farPlane[j] = -forward[j];
+		}
+		nearPlane[3] = -( distanceToCamera + i_zNear );
+		farPlane[3] = distanceToCamera + i_zFar;
+	}
+	for ( unsigned int j = 0; j < 3; ++j )
+	{
+		o_view.cameraPosition[j] = i_cameraPosition[j];
+	}
+}
+
+void eae6320::Graphics::MeshClusters::Cull( const sView& i_view, std::vector<sIndexRange>& o_indexRanges, sCullResult& o_result ) const
+{
+	o_indexRanges.clear();
+	o_result.visibleClusterCount = o_result.frustumRejectedTriangleCount = o_result.backfaceRejectedTriangleCount = 0;
+
+	__m128 planes[6][4];
+	for ( unsigned int i = 0; i < 6; ++i )
+	{
+		for ( unsigned int j = 0; j < 4; ++j )
+		{
+			planes[i][j] = _mm_set1_ps( i_view.planes[i][j] );
+		}
+	}
+	const __m128 cameraX = _mm_set1_ps( i_view.cameraPosition[0] );
+	const __m128 cameraY = _mm_set1_ps( i_view.cameraPosition[1] );
+	const __m128 cameraZ = _mm_set1_ps( i_view.cameraPosition[2] );
+	const __m128 zero = _mm_setzero_ps();
+
+	const unsigned int clusterCount = static_cast<unsigned int>( m_clusters.size() );
+	for ( unsigned int i = 0; i < clusterCount; i += 4 )
+	{
+		const __m128 centerX = _mm_loadu_ps( &m_centerX[i] );
+		const __m128 centerY = _mm_loadu_ps( &m_centerY[i] );
+		const __m128 centerZ = _mm_loadu_ps( &m_centerZ[i] );
+		const __m128 radius = _mm_loadu_ps( &m_radius[i] );
+		// A sphere is outside of the frustum if it is completely behind any plane
+		const __m128 negativeRadius = _mm_sub_ps( zero, radius );
+		__m128 isOutside = _mm_setzero_ps();
+		for ( unsigned int j = 0; j < 6; ++j )
+		{
+			const __m128 distance = _mm_add_ps( _mm_add_ps( _mm_add_ps(
+				_mm_mul_ps( planes[j][0], centerX ), _mm_mul_ps( planes[j][1], centerY ) ), _mm_mul_ps( planes[j][2], centerZ ) ), planes[j][3] );
+			isOutside = _mm_or_ps( isOutside, _mm_cmplt_ps( distance, negativeRadius ) );
+		}
+		// A cluster faces away if ( dot( center - camera, axis ) >= ( cutoff * length( center - camera ) + radius ) )
+		__m128 isFacingAway;
+		{
+			const __m128 toCenterX = _mm_sub_ps( centerX, cameraX );
+			const __m128 toCenterY = _mm_sub_ps( centerY, cameraY );
+			const __m128 toCenterZ = _mm_sub_ps( centerZ, cameraZ );
+			const __m128 distanceSquared = _mm_add_ps( _mm_add_ps(
+				_mm_mul_ps( toCenterX, toCenterX ), _mm_mul_ps( toCenterY, toCenterY ) ), _mm_mul_ps( toCenterZ, toCenterZ ) );
+			const __m128 alongAxis = _mm_add_ps( _mm_add_ps(
+				_mm_mul_ps( toCenterX, _mm_loadu_ps( &m_coneAxisX[i] ) ), _mm_mul_ps( toCenterY, _mm_loadu_ps( &m_coneAxisY[i] ) ) ),
+				_mm_mul_ps( toCenterZ, _mm_loadu_ps( &m_coneAxisZ[i] ) ) );
+			const __m128 limit = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( &m_coneCutoff[i] ), _mm_sqrt_ps( distanceSquared ) ), radius );
+			isFacingAway = _mm_cmpge_ps( alongAxis, limit );
+		}
+
+		const int outsideMask = _mm_movemask_ps( isOutside );
+		const int facingAwayMask = _mm_movemask_ps( isFacingAway );
+		const unsigned int endIndex = ( ( i + 4 ) < clusterCount ) ? ( i + 4 ) : clusterCount;
+		for ( unsigned int j = i; j < endIndex; ++j )
+		{
+			const int bit = 1 << ( j - i );
+			const sCluster& cluster = m_clusters[j];
+			if ( outsideMask & bit )
+			{
+				o_result.frustumRejectedTriangleCount += cluster.triangleCount;
+			}
+			else if ( facingAwayMask & bit )
+			{
+				o_result.backfaceRejectedTriangleCount += cluster.triangleCount;
+			}
+			else
+			{
+				++o_result.visibleClusterCount;
+				AddIndexRange( cluster, o_indexRanges );
+			}
+		}
+	}
+}
+
+// Benchmark
+//----------
+
+void eae6320::Graphics::MeshClusters::LogCullingCost()
+{
+	// The sphere is tessellated finely enough that it is split into hundreds of clusters
+	const unsigned int stackCount = 128, sliceCount = 256;
+	std::vector<float> positions;
+	std::vector<uint32_t> indices;
+	CreateBenchmarkSphere( stackCount, sliceCount, positions, indices );
+
+	MeshClusters clusters;
+	double secondCountBuilding;
+	{
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		if ( !clusters.Build( &positions[0], static_cast<uint32_t>( positions.size() / 3 ), indices ) )
+		{
+			return;
+		}
+		secondCountBuilding = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	}
+
+	// The camera circles the sphere while moving closer to and further from it
+	// (when it is close the sphere fills more than the view)
+	const unsigned int frameCount = 240;
+	const float pi = 3.14159265f;
+	const float up[3] = { 0.0f, 1.0f, 0.0f };
+	const float target[3] = { 0.0f, 0.0f, 0.0f };
+	std::vector<sIndexRange> indexRanges, indexRanges_scalar;
+	sCullResult result, result_scalar;
+	uint64_t rejectedTriangleCount_frustum = 0, rejectedTriangleCount_backface = 0, indexRangeCount = 0;
+	double secondCountCulling = 0.0, secondCountCulling_scalar = 0.0;
+	unsigned int mismatchedFrameCount = 0;
+	for ( unsigned int frame = 0; frame < frameCount; ++frame )
+	{
+		const float angle = ( 2.0f * pi * frame ) / frameCount;
+		const float distance = 1.3f + ( 1.5f * ( 0.5f + ( 0.5f * std::sin( 3.0f * angle ) ) ) );
+		const float cameraPosition[3] =
+		{
+			distance * std::cos( angle ), distance * 0.5f * std::sin( 2.0f * angle ), distance * std::sin( angle )
+		};
+		sView view;
+		CalculateView( cameraPosition, target, up, pi / 3.0f, 16.0f / 9.0f, 0.1f, 100.0f, view );
+		{
+			const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+			clusters.Cull( view, indexRanges, result );
+			secondCountCulling += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+		}
+		{
+			const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+			clusters.Cull_scalar( view, indexRanges_scalar, result_scalar );
+			secondCountCulling_scalar += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+		}
+		if ( ( result.visibleClusterCount != result_scalar.visibleClusterCount )
+			|| ( result.frustumRejectedTriangleCount != result_scalar.frustumRejectedTriangleCount )
+			|| ( indexRanges.size() != indexRanges_scalar.size() ) )
+		{
+			++mismatchedFrameCount;
+		}
+		rejectedTriangleCount_frustum += result.frustumRejectedTriangleCount;
+		rejectedTriangleCount_backface += result.backfaceRejectedTriangleCount;
+		indexRangeCount += indexRanges.size();
+	}
+	EAE6320_ASSERTF( mismatchedFrameCount == 0, "The SSE and scalar cluster culling disagree" );
+
+	const unsigned int clusterCount = static_cast<unsigned int>( clusters.GetClusters().size() );
+	const unsigned int triangleCount = clusters.GetTriangleCount();
+	Logging::OutputMessage( "Splitting %u triangles into %u clusters (%.1f triangles per cluster) took %.3f ms",
+		triangleCount, clusterCount, static_cast<double>( triangleCount ) / clusterCount, secondCountBuilding * 1000.0 );
+	const double rejectedTriangleCountPerFrame_frustum = static_cast<double>( rejectedTriangleCount_frustum ) / frameCount;
+	const double rejectedTriangleCountPerFrame_backface = static_cast<double>( rejectedTriangleCount_backface ) / frameCount;
+	Logging::OutputMessage( "Culling the clusters rejected %.0f triangles per frame (%.1f%%):"
+		" %.0f outside of the frustum and %.0f facing away, and drew the rest with %.1f index ranges per frame",
+		rejectedTriangleCountPerFrame_frustum + rejectedTriangleCountPerFrame_backface,
+		( rejectedTriangleCountPerFrame_frustum + rejectedTriangleCountPerFrame_backface ) * 100.0 / triangleCount,
+		rejectedTriangleCountPerFrame_frustum, rejectedTriangleCountPerFrame_backface,
+		static_cast<double>( indexRangeCount ) / frameCount );
+	Logging::OutputMessage( "Culling took %.2f us per frame with SSE and %.2f us per frame one cluster at a time"
+		" (the results differed in %u of %u frames)",
+		secondCountCulling * 1.0e6 / frameCount, secondCountCulling_scalar * 1.0e6 / frameCount, mismatchedFrameCount, frameCount );
+}
+
+// Implementation
+//===============
+
+// Cull
+//-----
+
+void eae6320::Graphics::MeshClusters::Cull_scalar( const sView& i_view, std::vector<sIndexRange>& o_indexRanges, sCullResult& o_result ) const
+{
+	o_indexRanges.clear();
+	o_result.visibleClusterCount = o_result.frustumRejectedTriangleCount = o_result.backfaceRejectedTriangleCount = 0;
+
+	for ( std::vector<sCluster>::const_iterator i = m_clusters.begin(); i != m_clusters.end(); ++i )
+	{
+		bool isOutside = false;
+		for ( unsigned int j = 0; j < 6; ++j )
+		{
+			const float* const plane = i_view.planes[j];
+			const float distance = ( ( plane[0] * i->center[0] ) + ( plane[1] * i->center[1] ) ) + ( plane[2] * i->center[2] ) + plane[3];
+			isOutside |= distance < -i->radius;
+		}
+		if ( isOutside )
+		{
+			o_result.frustumRejectedTriangleCount += i->triangleCount;
+			continue;
+		}
+		float toCenter[3];
+		Subtract( i->center, i_view.cameraPosition, toCenter );
+		const float alongAxis = Dot( toCenter, i->coneAxis );
+		if ( alongAxis >= ( ( i->coneCutoff * std::sqrt( Dot( toCenter, toCenter ) ) ) + i->radius ) )
+		{
+			o_result.backfaceRejectedTriangleCount += i->triangleCount;
+			continue;
+		}
+		++o_result.visibleClusterCount;
+		AddIndexRange( *i, o_indexRanges );
+	}
+}
+
+void eae6320::Graphics::MeshClusters::AddIndexRange( const sCluster& i_cluster, std::vector<sIndexRange>& io_indexRanges )
+{
+	const uint32_t indexCount = i_cluster.triangleCount * 3;
+	if ( !io_indexRanges.empty() )
+	{
+		sIndexRange& previousRange = io_indexRanges.back();
+		if ( ( previousRange.firstIndex + previousRange.indexCount ) == i_cluster.firstIndex )
+		{
+			previousRange.indexCount += indexCount;
+			return;
+		}
+	}
+	const sIndexRange indexRange = { i_cluster.firstIndex, indexCount };
+	io_indexRanges.push_back( indexRange );
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	float Dot( const float i_lhs[3], const float i_rhs[3] )
+	{
+		return ( i_lhs[0] * i_rhs[0] ) + ( i_lhs[1] * i_rhs[1] ) + ( i_lhs[2] * i_rhs[2] );
+	}
+
+	void Cross( const float i_lhs[3], const float i_rhs[3], float o_result[3] )
+	{
+		o_result[0] = ( i_lhs[1] * i_rhs[2] ) - ( i_lhs[2] * i_rhs[1] );
+		o_result[1] = ( i_lhs[2] * i_rhs[0] ) - ( i_lhs[0] * i_rhs[2] );
+		o_result[2] = ( i_lhs[0] * i_rhs[1] ) - ( i_lhs[1] * i_rhs[0] );
+	}
+
+	void Subtract( const float i_lhs[3], const float i_rhs[3], float o_result[3] )
+	{
+		o_result[0] = i_lhs[0] - i_rhs[0];
+		o_result[1] = i_lhs[1] - i_rhs[1];
+		o_result[2] = i_lhs[2] - i_rhs[2];
+	}
+
+	float Normalize( float io_vector[3] )
+	{
+		const float length = std::sqrt( Dot( io_vector, io_vector ) );
+		if ( length > 0.0f )
+		{
+			const float scale = 1.0f / length;
+			io_vector[0] *= scale;
+			io_vector[1] *= scale;
+			io_vector[2] *= scale;
+		}
+		return length;
+	}
+
+	void CalculateBounds( const float* const i_positions, const std::vector<uint32_t>& i_vertices,
+		eae6320::Graphics::MeshClusters::sCluster& io_cluster )
+	{
+		// The sphere is centered on the vertices' bounding box
+		// (which is simple and close enough to the smallest sphere for clusters of neighboring triangles)
+		float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		for ( std::vector<uint32_t>::const_iterator i = i_vertices.begin(); i != i_vertices.end(); ++i )
+		{
+			const float* const position = i_positions + ( *i * 3 );
+			for ( unsigned int j = 0; j < 3; ++j )
+			{
+				minimum[j] = ( position[j] < minimum[j] ) ? position[j] : minimum[j];
+				maximum[j] = ( position[j] > maximum[j] ) ? position[j] : maximum[j];
+			}
+		}
+		for ( unsigned int j = 0; j < 3; ++j )
+		{
+			io_cluster.center[j] = ( minimum[j] + maximum[j] ) * 0.5f;
+		}
+		float radiusSquared = 0.0f;
+		for ( std::vector<uint32_t>::const_iterator i = i_vertices.begin(); i != i_vertices.end(); ++i )
+		{
+			float offset[3];
+			Subtract( i_positions + ( *i * 3 ), io_cluster.center, offset );
+			const float distanceSquared = Dot( offset, offset );
+			radiusSquared = ( distanceSquared > radiusSquared ) ? distanceSquared : radiusSquared;
+		}
+		io_cluster.radius = std::sqrt( radiusSquared );
+	}
+
+	void CalculateCone( const std::vector<float>& i_triangleNormals, const uint32_t* const i_triangles, const unsigned int i_triangleCount,
+		const float i_normalSum[3], eae6320::Graphics::MeshClusters::sCluster& io_cluster )
+	{
+		float axis[3] = { i_normalSum[0], i_normalSum[1], i_normalSum[2] };
+		float minDot = 1.0f;
+		if ( Normalize( axis ) > 0.0f )
+		{
+			for ( unsigned int i = 0; i < i_triangleCount; ++i )
+			{
+				const float* const normal = &i_triangleNormals[i_triangles[i] * 3];
+				// Degenerate triangles can't be seen from any direction
+				if ( Dot( normal, normal ) > 0.0f )
+				{
+					const float dot = Dot( normal, axis );
+					minDot = ( dot < minDot ) ? dot : minDot;
+				}
+			}
+		}
+		else
+		{
+			minDot = -1.0f;
+		}
+		io_cluster.coneAxis[0] = axis[0];
+		io_cluster.coneAxis[1] = axis[1];
+		io_cluster.coneAxis[2] = axis[2];
+		// The cluster faces away when the direction to it is within the cone's complement,
+		// which is tested with the sine of the cone's half-angle
+		io_cluster.coneCutoff = ( minDot > s_minNormalDotWithCone ) ? std::sqrt( 1.0f - ( minDot * minDot ) ) : 1.0f;
+	}
+
+	void CreateBenchmarkSphere( const unsigned int i_stackCount, const unsigned int i_sliceCount,
+		std::vector<float>& o_positions, std::vector<uint32_t>& o_indices )
+	{
+		const float pi = 3.14159265f;
+		const unsigned int rowVertexCount = i_sliceCount + 1;
+		o_positions.resize( ( i_stackCount + 1 ) * rowVertexCount * 3 );
+		for ( unsigned int stack = 0; stack <= i_stackCount; ++stack )
+		{
+			const float polarAngle = ( pi * stack ) / i_stackCount;
+			for ( unsigned int slice = 0; slice <= i_sliceCount; ++slice )
+			{
+				const float azimuth = ( 2.0f * pi * slice ) / i_sliceCount;
+				float* const position = &o_positions[( ( stack * rowVertexCount ) + slice ) * 3];
+				position[0] = std::sin( polarAngle ) * std::cos( azimuth );
+				position[1] = std::cos( polarAngle );
+				position[2] = std::sin( polarAngle ) * std::sin( azimuth );
+			}
+		}
+		// Every quad is two triangles that face out of the sphere
+		// (except at the poles, where one of them would be degenerate)
+		o_indices.clear();
+		for ( unsigned int stack = 0; stack < i_stackCount; ++stack )
+		{
+			for ( unsigned int slice = 0; slice < i_sliceCount; ++slice )
+			{
+				const uint32_t topLeft = ( stack * rowVertexCount ) + slice;
+				const uint32_t topRight = topLeft + 1;
+				const uint32_t bottomLeft = topLeft + rowVertexCount;
+				const uint32_t bottomRight = bottomLeft + 1;
+				if ( stack != 0 )
+				{
+					o_indices.push_back( topLeft );
+					o_indices.push_back( topRight );
+					o_indices.push_back( bottomLeft );
+				}
+				if ( stack != ( i_stackCount - 1 ) )
+				{
+					o_indices.push_back( topRight );
+					o_indices.push_back( bottomRight );
+					o_indices.push_back( bottomLeft );
+				}
+			}
+		}
+	}
+}
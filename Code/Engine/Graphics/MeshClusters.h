@@ -0,0 +1,143 @@
+/*
+	Mesh clusters split an indexed triangle mesh into small groups of neighboring triangles
+	so that the CPU can skip the groups that can't be seen before they are drawn
+
+	Building the clusters reorders the index buffer so that every cluster's triangles are contiguous,
+	and so it is meant to be done once (when a mesh is built) rather than every frame.
+	Each cluster stores a bounding sphere and a cone that contains every triangle's normal:
+	a cluster is culled if its sphere is outside of the view frustum
+	or if the camera is inside of the region where every triangle in its cone faces away.
+
+	The culling data is stored as a structure of arrays so that 4 clusters are tested at a time with SSE,
+	and the visible clusters are compacted into a list of index ranges
+	(clusters that are next to each other in the index buffer are merged)
+	that can be drawn with a single multi-draw call.
+*/
+
+#ifndef EAE6320_GRAPHICS_MESHCLUSTERS_H
+#define EAE6320_GRAPHICS_MESHCLUSTERS_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+#include <vector>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class MeshClusters
+		{
+		public:
+
+			// A cluster never has more than this many triangles or vertices
+			// (the defaults keep a cluster's vertices small enough to fit in a GPU's on-chip cache)
+			static const unsigned int s_defaultMaxTriangleCount = 124;
+			static const unsigned int s_defaultMaxVertexCount = 64;
+
+			struct sCluster
+			{
+				float center[3];
+				float radius;
+				// Every triangle's normal is within the cone around this axis.
+				// The cutoff is the sine of the cone's half-angle,
+				// or 1 if the normals are too spread out for the cluster to ever face away
+				float coneAxis[3];
+				float coneCutoff;
+				uint32_t firstIndex;
+				uint32_t triangleCount;
+			};
+
+			// The range of indices that a single draw in a multi-draw call should use
+			struct sIndexRange
+			{
+				uint32_t firstIndex;
+				uint32_t indexCount;
+			};
+
+			// The view is described in the mesh's space
+			struct sView
+			{
+				// The normal of each plane (x, y, z) points into the frustum, and w is its distance from the origin,
+				// so a point p is inside of the plane if ( dot( normal, p ) + w ) >= 0
+				float planes[6][4];
+				float cameraPosition[3];
+			};
+
+			struct sCullResult
+			{
+				unsigned int visibleClusterCount;
+				unsigned int frustumRejectedTriangleCount;
+				// A cluster that is outside of the frustum isn't also counted as facing away
+				unsigned int backfaceRejectedTriangleCount;
+			};
+
+			// Build
+			//------
+
+			// The positions are 3 floats per vertex, and the indices are 3 per triangle.
+			// The front of a triangle is the side that cross( b - a, c - a ) points toward.
+			// The indices are reordered so that every cluster's triangles are contiguous
+			// (the vertices aren't changed).
+			bool Build( const float* const i_positions, const uint32_t i_vertexCount,
+				std::vector<uint32_t>& io_indices,
+				const unsigned int i_maxTriangleCount = s_defaultMaxTriangleCount, const unsigned int i_maxVertexCount = s_defaultMaxVertexCount );
+
+			// Cull
+			//-----
+
+			// This calculates the frustum planes of a perspective camera at i_cameraPosition looking at i_targetPosition
+			// (the vertical field of view is in radians)
+			static void CalculateView( const float i_cameraPosition[3], const float i_targetPosition[3], const float i_up[3],
+				const float i_verticalFieldOfView, const float i_aspectRatio, const float i_zNear, const float i_zFar,
+				sView& o_view );
+
+			// The index ranges of the clusters that might be visible replace the contents of o_indexRanges
+			void Cull( const sView& i_view, std::vector<sIndexRange>& o_indexRanges, sCullResult& o_result ) const;
+
+			// Access
+			//-------
+
+			const std::vector<sCluster>& GetClusters() const { return m_clusters; }
+			unsigned int GetTriangleCount() const { return m_triangleCount; }
+
+			// Benchmark
+			//----------
+
+			// This builds clusters for a sphere with many triangles,
+			// culls them from a camera that moves around it for a number of frames,
+			// and logs how many triangles were rejected per frame and how long building and culling took
+			static void LogCullingCost();
+
+			// Implementation
+			//===============
+
+		private:
+
+			// Cull
+			//-----
+
+			// This does the same tests as Cull() one cluster at a time (and is only used to check and measure it)
+			void Cull_scalar( const sView& i_view, std::vector<sIndexRange>& o_indexRanges, sCullResult& o_result ) const;
+			static void AddIndexRange( const sCluster& i_cluster, std::vector<sIndexRange>& io_indexRanges );
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<sCluster> m_clusters;
+			// The culling data is copied into separate arrays that are padded to a multiple of 4
+			// (the padding is tested but never reported as visible)
+			std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+			std::vector<float> m_coneAxisX, m_coneAxisY, m_coneAxisZ, m_coneCutoff;
+			unsigned int m_triangleCount = 0;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_MESHCLUSTERS_H
@@ -0,0 +1,272 @@
+// Header Files
+//=============
+
+#include "../ClusteredLights.h"
+
+#include <cstring>
+#include "DebugOutput.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// If the storage can't be allocated the buffer is deleted
+	bool CreateStreamingBuffer( const GLenum i_target, const GLsizeiptr i_byteCount, GLuint& o_bufferId );
+	bool DeleteObject( GLuint& io_id, const bool i_isTexture );
+	bool UploadToStreamingBuffer( const GLenum i_target, const GLuint i_bufferId, const void* const i_data, const size_t i_byteCount );
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::ClusteredLights::CreateBuffers()
+{
+	bool wereThereErrors = false;
+
+	// Every buffer is big enough for the most data that an assignment can have
+	const unsigned int clusterCount = GetClusterCount();
+	const GLsizeiptr byteCounts[BufferCount] =
+	{
+		static_cast<GLsizeiptr>( clusterCount * 2 * sizeof( uint32_t ) ),
+		static_cast<GLsizeiptr>( clusterCount * m_settings.maxLightCountPerCluster * sizeof( uint16_t ) ),
+		static_cast<GLsizeiptr>( m_settings.maxLightCount * sizeof( sLight ) ),
+	};
+	const GLenum internalFormats[BufferCount] = { GL_RG32UI, GL_R16UI, GL_RGBA32F };
+	const char* const bufferNames[BufferCount] = { "cluster", "light index", "light" };
+
+	if ( !CreateStreamingBuffer( GL_UNIFORM_BUFFER, sizeof( sConstants ), m_constantBufferId ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::ConstantBuffer, sizeof( sConstants ) ) );
+	for ( unsigned int i = 0; i < BufferCount; ++i )
+	{
+		if ( !CreateStreamingBuffer( GL_TEXTURE_BUFFER, byteCounts[i], m_bufferIds[i] ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		m_bufferSize += static_cast<size_t>( byteCounts[i] );
+		EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::ShaderResourceBuffer, static_cast<size_t>( byteCounts[i] ) ) );
+		// Shaders read the buffer as an array of typed texels through a buffer texture (e.g. usamplerBuffer)
+		{
+			const GLsizei textureCount = 1;
+			glGenTextures( textureCount, &m_textureIds[i] );
+			GLenum errorCode = glGetError();
+			if ( errorCode == GL_NO_ERROR )
+			{
+				glBindTexture( GL_TEXTURE_BUFFER, m_textureIds[i] );
+				glTexBuffer( GL_TEXTURE_BUFFER, internalFormats[i], m_bufferIds[i] );
+				errorCode = glGetError();
+				glBindTexture( GL_TEXTURE_BUFFER, 0 );
+				if ( errorCode != GL_NO_ERROR )
+				{
+					wereThereErrors = true;
+					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					Logging::OutputError( "OpenGL failed to attach the clustered %s buffer to its texture: %s",
+						bufferNames[i], reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					goto OnExit;
+				}
+			}
+			else
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to get an unused texture ID for the clustered %s buffer: %s",
+					bufferNames[i], reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+	}
+
+OnExit:
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::ClusteredLights::DestroyBuffers()
+{
+	bool wereThereErrors = false;
+
+	for ( unsigned int i = 0; i < BufferCount; ++i )
+	{
+		const bool isTexture = true;
+		if ( !DeleteObject( m_textureIds[i], isTexture ) )
+		{
+			wereThereErrors = true;
+		}
+		if ( !DeleteObject( m_bufferIds[i], !isTexture ) )
+		{
+			wereThereErrors = true;
+		}
+	}
+	if ( m_bufferSize > 0 )
+	{
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::ShaderResourceBuffer, m_bufferSize ) );
+		m_bufferSize = 0;
+	}
+	if ( m_constantBufferId != 0 )
+	{
+		const bool isTexture = false;
+		if ( !DeleteObject( m_constantBufferId, isTexture ) )
+		{
+			wereThereErrors = true;
+		}
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::ConstantBuffer, sizeof( sConstants ) ) );
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::ClusteredLights::UploadAndBindBuffers()
+{
+	// Only as much as the current assignment uses is written
+	const void* const data[BufferCount] =
+	{
+		m_clusterRanges.empty() ? NULL : &m_clusterRanges[0],
+		m_lightIndices.empty() ? NULL : &m_lightIndices[0],
+		m_lights.empty() ? NULL : &m_lights[0],
+	};
+	const size_t byteCounts[BufferCount] =
+	{
+		m_clusterRanges.size() * sizeof( uint32_t ),
+		m_lightIndices.size() * sizeof( uint16_t ),
+		m_lights.size() * sizeof( sLight ),
+	};
+	if ( !UploadToStreamingBuffer( GL_UNIFORM_BUFFER, m_constantBufferId, &m_constants, sizeof( m_constants ) ) )
+	{
+		return false;
+	}
+	for ( unsigned int i = 0; i < BufferCount; ++i )
+	{
+		if ( !UploadToStreamingBuffer( GL_TEXTURE_BUFFER, m_bufferIds[i], data[i], byteCounts[i] ) )
+		{
+			return false;
+		}
+	}
+
+	glBindBufferBase( GL_UNIFORM_BUFFER, s_constantBufferRegister, m_constantBufferId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+	{
+		const unsigned int textureUnits[BufferCount] = { s_clusterTextureUnit, s_lightIndexTextureUnit, s_lightTextureUnit };
+		for ( unsigned int i = 0; i < BufferCount; ++i )
+		{
+			glActiveTexture( GL_TEXTURE0 + textureUnits[i] );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+			glBindTexture( GL_TEXTURE_BUFFER, m_textureIds[i] );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( BufferCount ) );
+	}
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool CreateStreamingBuffer( const GLenum i_target, const GLsizeiptr i_byteCount, GLuint& o_bufferId )
+	{
+		const GLsizei bufferCount = 1;
+		glGenBuffers( bufferCount, &o_bufferId );
+		GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			eae6320::Logging::OutputError( "OpenGL failed to get an unused clustered light buffer ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			o_bufferId = 0;
+			return false;
+		}
+		glBindBuffer( i_target, o_bufferId );
+		// The contents are written every frame
+		const GLvoid* const noInitialData = NULL;
+		glBufferData( i_target, i_byteCount, noInitialData, GL_STREAM_DRAW );
+		errorCode = glGetError();
+		glBindBuffer( i_target, 0 );
+		if ( errorCode != GL_NO_ERROR )
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			eae6320::Logging::OutputError( "OpenGL failed to allocate a clustered light buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			const bool isTexture = false;
+			DeleteObject( o_bufferId, isTexture );
+			return false;
+		}
+		return true;
+	}
+
+	bool DeleteObject( GLuint& io_id, const bool i_isTexture )
+	{
+		if ( io_id == 0 )
+		{
+			return true;
+		}
+		const GLsizei count = 1;
+		if ( i_isTexture )
+		{
+			glDeleteTextures( count, &io_id );
+		}
+		else
+		{
+			glDeleteBuffers( count, &io_id );
+		}
+		io_id = 0;
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			eae6320::Logging::OutputError( "OpenGL failed to delete a clustered light %s: %s",
+				i_isTexture ? "texture" : "buffer", reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			return false;
+		}
+		return true;
+	}
+
+	bool UploadToStreamingBuffer( const GLenum i_target, const GLuint i_bufferId, const void* const i_data, const size_t i_byteCount )
+	{
+		if ( i_byteCount == 0 )
+		{
+			return true;
+		}
+		glBindBuffer( i_target, i_bufferId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+		// Invalidating the buffer lets the driver hand back fresh memory
+		// instead of waiting for the GPU to finish reading last frame's lights
+		const GLintptr offset = 0;
+		const GLsizeiptr length = static_cast<GLsizeiptr>( i_byteCount );
+		const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+		void* const memory = glMapBufferRange( i_target, offset, length, access );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		bool wereThereErrors = false;
+		if ( memory )
+		{
+			memcpy( memory, i_data, i_byteCount );
+			EAE6320_GRAPHICS_STATISTICS( CountUpload( i_byteCount ) );
+			// The contents are undefined if the buffer was corrupted while it was mapped
+			// (e.g. because the display mode changed)
+			if ( glUnmapBuffer( i_target ) == GL_FALSE )
+			{
+				wereThereErrors = true;
+				eae6320::Logging::OutputError( "A clustered light buffer was corrupted while it was mapped" );
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			eae6320::Logging::OutputError( "OpenGL failed to map a clustered light buffer" );
+		}
+		glBindBuffer( i_target, 0 );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		return !wereThereErrors;
+	}
+}
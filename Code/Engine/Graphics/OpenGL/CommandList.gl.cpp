@@ -0,0 +1,151 @@
+// Header Files
+//=============
+
+#include "../CommandList.h"
+
+#include "DebugOutput.h"
+#include "Includes.h"
+#include "../Material.h"
+#include "../Mesh.h"
+#include "../ParticleEmitter.h"
+#include "../SkinnedMesh.h"
+#include "../Terrain.h"
+#include "../Texture.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// SetConstants() writes to these
+	GLuint s_constantBufferIds[eae6320::Graphics::eConstantBuffer::Count] = { 0 };
+	// This is only used for statistics
+	// (every ID exists as soon as they are generated, but storage might not have been allocated for them)
+	unsigned int s_allocatedConstantBufferCount = 0;
+}
+
+// Interface
+//==========
+
+// Execute
+//--------
+
+void eae6320::Graphics::CommandList::Execute() const
+{
+	for ( std::vector<sCommand>::const_iterator i = m_commands.begin(); i != m_commands.end(); ++i )
+	{
+		switch ( i->type )
+		{
+		case sCommand::BindEffect:
+			i->material->BindEffect();
+			break;
+		case sCommand::BindParameterBlock:
+			i->material->BindParameterBlock();
+			break;
+		case sCommand::BindTexture:
+			i->texture->Bind( i->textureUnit );
+			break;
+		case sCommand::SetConstants:
+			{
+				const GLuint constantBufferId = s_constantBufferIds[i->constantBuffer];
+				glBindBuffer( GL_UNIFORM_BUFFER, constantBufferId );
+				EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+				EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+				const GLintptr updateAtTheBeginning = 0;
+				glBufferSubData( GL_UNIFORM_BUFFER, updateAtTheBeginning, static_cast<GLsizeiptr>( i->constantDataSize ),
+					&m_constantData[i->constantDataOffset] );
+				EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+				EAE6320_GRAPHICS_STATISTICS( CountUpload( i->constantDataSize ) );
+				// Each constant buffer's binding point is its eConstantBuffer value
+				const GLuint bindingPointAssignedInShader = i->constantBuffer;
+				glBindBufferBase( GL_UNIFORM_BUFFER, bindingPointAssignedInShader, constantBufferId );
+				EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+				EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+			}
+			break;
+		case sCommand::DrawMesh:
+			i->mesh->Draw();
+			break;
+		case sCommand::DrawSkinnedMesh:
+			i->skinnedMesh->Draw();
+			break;
+		case sCommand::DrawParticles:
+			i->emitter->Draw();
+			break;
+		case sCommand::DrawTerrain:
+			i->terrain->Draw();
+			break;
+		default:
+			EAE6320_ASSERTF( false, "Invalid command type" );
+		}
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::CommandList::Initialize()
+{
+	const GLsizei bufferCount = eConstantBuffer::Count;
+	glGenBuffers( bufferCount, s_constantBufferIds );
+	GLenum errorCode = glGetError();
+	if ( errorCode != GL_NO_ERROR )
+	{
+		EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		Logging::OutputError( "OpenGL failed to get unused uniform buffer IDs: %s",
+			reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		return false;
+	}
+	for ( unsigned int i = 0; i < eConstantBuffer::Count; ++i )
+	{
+		glBindBuffer( GL_UNIFORM_BUFFER, s_constantBufferIds[i] );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		// Every constant buffer is big enough for any SetConstants()
+		const GLvoid* const noInitialData = NULL;
+		const GLenum usage = GL_DYNAMIC_DRAW;	// The buffer will be modified frequently and used to draw
+		glBufferData( GL_UNIFORM_BUFFER, s_maxConstantDataSize, noInitialData, usage );
+		errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to allocate the uniform buffer %u: %s",
+				s_constantBufferIds[i], reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			return false;
+		}
+		++s_allocatedConstantBufferCount;
+		EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::ConstantBuffer, s_maxConstantDataSize ) );
+	}
+	return true;
+}
+
+bool eae6320::Graphics::CommandList::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	if ( s_constantBufferIds[0] != 0 )
+	{
+		const GLsizei bufferCount = eConstantBuffer::Count;
+		glDeleteBuffers( bufferCount, s_constantBufferIds );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete the constant buffers: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		for ( unsigned int i = 0; i < eConstantBuffer::Count; ++i )
+		{
+			s_constantBufferIds[i] = 0;
+		}
+		for ( ; s_allocatedConstantBufferCount > 0; --s_allocatedConstantBufferCount )
+		{
+			EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::ConstantBuffer, s_maxConstantDataSize ) );
+		}
+	}
+
+	return !wereThereErrors;
+}
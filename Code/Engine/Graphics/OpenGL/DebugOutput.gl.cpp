@@ -0,0 +1,351 @@
+// Header Files
+//=============
+
+#include "DebugOutput.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../../Logging/Logging.h"
+#include "../../Time/Time.h"
+#include "../../../External/OpenGlExtensions/OpenGlExtensions.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	struct sMessage
+	{
+		GLenum source;
+		GLenum type;
+		GLuint id;
+		GLenum severity;
+		std::string text;
+		// The most recently marked call site when the message was reported
+		const eae6320::Graphics::DebugOutput::sCallSite* callSite;
+	};
+
+	// The render thread is the only one that writes this
+	// (a pointer is written atomically, and so the callback never reads a torn value)
+	const eae6320::Graphics::DebugOutput::sCallSite* volatile s_callSite = NULL;
+
+	// The callback can be called from any thread,
+	// and so the queue is protected by a lock
+	CRITICAL_SECTION s_queuedMessagesLock;
+	std::vector<sMessage> s_queuedMessages;
+	// This keeps a broken frame from using unbounded memory
+	const size_t s_maxQueuedMessageCount = 64;
+	eae6320::Graphics::DebugOutput::sStats s_stats = { 0 };
+	bool s_isEnabled = false;
+	bool s_wasLockInitialized = false;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void APIENTRY OnMessageReported( GLenum i_source, GLenum i_type, GLuint i_id, GLenum i_severity, GLsizei i_length,
+		const GLchar* i_message, const void* i_userParam );
+	const char* GetSourceName( const GLenum i_source );
+	const char* GetTypeName( const GLenum i_type );
+	double MeasureDrawCost( const GLuint i_vertexArrayId, const unsigned int i_drawCount, const bool i_shouldGlGetErrorBeCalled );
+}
+
+// Interface
+//==========
+
+// Call Sites
+//-----------
+
+void eae6320::Graphics::DebugOutput::MarkCallSite( const sCallSite* const i_callSite )
+{
+	s_callSite = i_callSite;
+}
+
+// Messages
+//---------
+
+void eae6320::Graphics::DebugOutput::OutputQueuedMessages()
+{
+	if ( !s_isEnabled )
+	{
+		return;
+	}
+
+	// The messages are swapped out so that the callback isn't blocked while they are output
+	std::vector<sMessage> messages;
+	unsigned int droppedMessageCount;
+	EnterCriticalSection( &s_queuedMessagesLock );
+	{
+		messages.swap( s_queuedMessages );
+		droppedMessageCount = s_stats.droppedMessageCount;
+	}
+	LeaveCriticalSection( &s_queuedMessagesLock );
+
+	for ( std::vector<sMessage>::const_iterator i = messages.begin(); i != messages.end(); ++i )
+	{
+		const char* const file = i->callSite ? i->callSite->file : "an unmarked call";
+		const unsigned int line = i->callSite ? i->callSite->line : 0;
+		if ( i->type == GL_DEBUG_TYPE_ERROR )
+		{
+			Logging::OutputError( "OpenGL %s error %u (reported after %s(%u)): %s",
+				GetSourceName( i->source ), i->id, file, line, i->text.c_str() );
+			EAE6320_ASSERTF( false, "OpenGL error (reported after %s(%u)): %s", file, line, i->text.c_str() );
+		}
+		else
+		{
+			Logging::OutputMessage( "OpenGL %s %s %u (reported after %s(%u)): %s",
+				GetSourceName( i->source ), GetTypeName( i->type ), i->id, file, line, i->text.c_str() );
+		}
+	}
+	if ( droppedMessageCount > 0 )
+	{
+		static unsigned int droppedMessageCount_reported = 0;
+		if ( droppedMessageCount != droppedMessageCount_reported )
+		{
+			Logging::OutputError( "%u OpenGL debug messages have been dropped because too many were reported in a single frame",
+				droppedMessageCount - droppedMessageCount_reported );
+			droppedMessageCount_reported = droppedMessageCount;
+		}
+	}
+}
+
+const eae6320::Graphics::DebugOutput::sStats& eae6320::Graphics::DebugOutput::GetStats()
+{
+	return s_stats;
+}
+
+bool eae6320::Graphics::DebugOutput::IsEnabled()
+{
+	return s_isEnabled;
+}
+
+// Benchmark
+//----------
+
+void eae6320::Graphics::DebugOutput::LogDrawCost()
+{
+	GLuint vertexArrayId = 0;
+	glGenVertexArrays( 1, &vertexArrayId );
+	if ( glGetError() != GL_NO_ERROR )
+	{
+		Logging::OutputError( "The cost of OpenGL error checking can't be measured because a vertex array couldn't be created" );
+		return;
+	}
+
+	// Each draw binds a vertex array and then draws no vertices,
+	// and so the only cost is the driver's validation and whatever checking is done
+	const unsigned int drawCount = 10000;
+	// The first pass warms up the driver so that the passes that are measured are consistent
+	MeasureDrawCost( vertexArrayId, drawCount, false );
+	if ( s_isEnabled )
+	{
+		glDisable( GL_DEBUG_OUTPUT );
+	}
+	const double secondCount_unchecked = MeasureDrawCost( vertexArrayId, drawCount, false );
+	const double secondCount_glGetError = MeasureDrawCost( vertexArrayId, drawCount, true );
+	double secondCount_debugOutput = 0.0;
+	if ( s_isEnabled )
+	{
+		glEnable( GL_DEBUG_OUTPUT );
+		secondCount_debugOutput = MeasureDrawCost( vertexArrayId, drawCount, false );
+	}
+
+	glBindVertexArray( 0 );
+	glDeleteVertexArrays( 1, &vertexArrayId );
+	EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
+
+	const double nanosecondsPerDraw = 1.0e9 / drawCount;
+	if ( s_isEnabled )
+	{
+		Logging::OutputMessage( "An OpenGL draw cost %.1f ns without error checking, %.1f ns with glGetError() after every call,"
+			" and %.1f ns with the asynchronous debug output",
+			secondCount_unchecked * nanosecondsPerDraw, secondCount_glGetError * nanosecondsPerDraw, secondCount_debugOutput * nanosecondsPerDraw );
+	}
+	else
+	{
+		Logging::OutputMessage( "An OpenGL draw cost %.1f ns without error checking and %.1f ns with glGetError() after every call"
+			" (the debug output isn't enabled, and so it wasn't measured)",
+			secondCount_unchecked * nanosecondsPerDraw, secondCount_glGetError * nanosecondsPerDraw );
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::DebugOutput::Initialize()
+{
+	// The debug output only reports anything in a debug context
+	{
+		GLint contextFlags = 0;
+		glGetIntegerv( GL_CONTEXT_FLAGS, &contextFlags );
+		if ( ( contextFlags & GL_CONTEXT_FLAG_DEBUG_BIT ) == 0 )
+		{
+			return true;
+		}
+	}
+	if ( !glDebugMessageCallback || !glDebugMessageControl )
+	{
+#ifndef EAE6320_GRAPHICS_AREGLERRORSCHECKEDSYNCHRONOUSLY
+		Logging::OutputError( "The OpenGL driver doesn't support KHR_debug, and so errors in per-frame code won't be reported"
+			" (define EAE6320_GRAPHICS_AREGLERRORSCHECKEDSYNCHRONOUSLY to check them with glGetError())" );
+#endif
+		return true;
+	}
+
+	InitializeCriticalSection( &s_queuedMessagesLock );
+	s_wasLockInitialized = true;
+	s_queuedMessages.reserve( s_maxQueuedMessageCount );
+
+	// Notifications are only informational (e.g. where a buffer is stored), and there are a lot of them
+	{
+		const GLsizei noIds = 0;
+		glDebugMessageControl( GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, noIds, NULL, GL_FALSE );
+	}
+	const void* const noUserParam = NULL;
+	glDebugMessageCallback( OnMessageReported, noUserParam );
+	glEnable( GL_DEBUG_OUTPUT );
+#ifdef EAE6320_GRAPHICS_AREGLERRORSCHECKEDSYNCHRONOUSLY
+	// The callback will be called before the call that caused the message returns,
+	// and so the call site will be exact (and the stall doesn't matter since glGetError() is stalling anyway)
+	glEnable( GL_DEBUG_OUTPUT_SYNCHRONOUS );
+#endif
+	const GLenum errorCode = glGetError();
+	if ( errorCode != GL_NO_ERROR )
+	{
+		EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		Logging::OutputError( "OpenGL failed to enable the debug output: %s", reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		glDebugMessageCallback( NULL, NULL );
+		return false;
+	}
+	s_isEnabled = true;
+	Logging::OutputMessage( "OpenGL errors will be reported %s by the debug output",
+#ifdef EAE6320_GRAPHICS_AREGLERRORSCHECKEDSYNCHRONOUSLY
+		"synchronously"
+#else
+		"asynchronously"
+#endif
+		);
+
+	return true;
+}
+
+bool eae6320::Graphics::DebugOutput::CleanUp()
+{
+	if ( s_isEnabled )
+	{
+		glDisable( GL_DEBUG_OUTPUT );
+		glDebugMessageCallback( NULL, NULL );
+		// Any messages that were reported during clean up are output before they are lost
+		OutputQueuedMessages();
+		s_isEnabled = false;
+		Logging::OutputMessage( "The OpenGL debug output reported %u errors and %u other messages",
+			s_stats.errorCount, s_stats.warningCount );
+	}
+	if ( s_wasLockInitialized )
+	{
+		DeleteCriticalSection( &s_queuedMessagesLock );
+		s_wasLockInitialized = false;
+	}
+	std::vector<sMessage>().swap( s_queuedMessages );
+	s_callSite = NULL;
+
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void APIENTRY OnMessageReported( GLenum i_source, GLenum i_type, GLuint i_id, GLenum i_severity, GLsizei i_length,
+		const GLchar* i_message, const void* i_userParam )
+	{
+		EnterCriticalSection( &s_queuedMessagesLock );
+		{
+			if ( i_type == GL_DEBUG_TYPE_ERROR )
+			{
+				++s_stats.errorCount;
+			}
+			else
+			{
+				++s_stats.warningCount;
+			}
+			if ( s_queuedMessages.size() < s_maxQueuedMessageCount )
+			{
+				s_queuedMessages.push_back( sMessage() );
+				sMessage& message = s_queuedMessages.back();
+				message.source = i_source;
+				message.type = i_type;
+				message.id = i_id;
+				message.severity = i_severity;
+				// The length doesn't include the NULL terminator
+				message.text.assign( i_message, ( i_length >= 0 ) ? static_cast<size_t>( i_length ) : strlen( i_message ) );
+				message.callSite = s_callSite;
+			}
+			else
+			{
+				++s_stats.droppedMessageCount;
+			}
+		}
+		LeaveCriticalSection( &s_queuedMessagesLock );
+	}
+
+	const char* GetSourceName( const GLenum i_source )
+	{
+		switch ( i_source )
+		{
+		case GL_DEBUG_SOURCE_API: return "API";
+		case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "window system";
+		case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+		case GL_DEBUG_SOURCE_THIRD_PARTY: return "third party";
+		case GL_DEBUG_SOURCE_APPLICATION: return "application";
+		default: return "other";
+		}
+	}
+
+	const char* GetTypeName( const GLenum i_type )
+	{
+		switch ( i_type )
+		{
+		case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated behavior";
+		case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behavior";
+		case GL_DEBUG_TYPE_PORTABILITY: return "portability warning";
+		case GL_DEBUG_TYPE_PERFORMANCE: return "performance warning";
+		case GL_DEBUG_TYPE_MARKER: return "marker";
+		default: return "message";
+		}
+	}
+
+	double MeasureDrawCost( const GLuint i_vertexArrayId, const unsigned int i_drawCount, const bool i_shouldGlGetErrorBeCalled )
+	{
+		// The GPU is idle before and after so that only the CPU's cost of submitting the draws is measured
+		glFinish();
+		const uint64_t tickCount_start = eae6320::Time::GetCurrentSystemTimeTickCount();
+		for ( unsigned int i = 0; i < i_drawCount; ++i )
+		{
+			glBindVertexArray( i_vertexArrayId );
+			if ( i_shouldGlGetErrorBeCalled && ( glGetError() != GL_NO_ERROR ) )
+			{
+				break;
+			}
+			const GLint noFirstVertex = 0;
+			const GLsizei noVertices = 0;
+			glDrawArrays( GL_TRIANGLES, noFirstVertex, noVertices );
+			if ( i_shouldGlGetErrorBeCalled && ( glGetError() != GL_NO_ERROR ) )
+			{
+				break;
+			}
+			if ( !i_shouldGlGetErrorBeCalled )
+			{
+				static const eae6320::Graphics::DebugOutput::sCallSite callSite = { __FILE__, __LINE__ };
+				eae6320::Graphics::DebugOutput::MarkCallSite( &callSite );
+			}
+		}
+		const uint64_t tickCount_end = eae6320::Time::GetCurrentSystemTimeTickCount();
+		glFinish();
+		return eae6320::Time::ConvertTicksToSeconds( tickCount_end - tickCount_start );
+	}
+}
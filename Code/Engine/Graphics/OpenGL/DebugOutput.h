@@ -0,0 +1,98 @@
+/*
+	The debug output reports OpenGL errors asynchronously
+
+	Calling glGetError() after a GL call makes many drivers wait for every call before it to be processed,
+	and so per-frame code doesn't check for errors directly.
+	Instead the driver reports errors (and warnings) through the KHR_debug callback,
+	which can be called on any thread and at any time after the call that caused them;
+	the messages are queued and then output on the render thread once per frame.
+
+	Per-frame code uses EAE6320_GRAPHICS_GL_ASSERTNOERROR() after GL calls.
+	Normally this only remembers where it was called from (so that messages can say which call they were reported after),
+	but if EAE6320_GRAPHICS_AREGLERRORSCHECKEDSYNCHRONOUSLY is defined in Configuration.h
+	it checks glGetError() instead (and the debug output is made synchronous so that messages are reported from the right call).
+	When device debug info is disabled it compiles to nothing.
+*/
+
+#ifndef EAE6320_GRAPHICS_OPENGL_DEBUGOUTPUT_H
+#define EAE6320_GRAPHICS_OPENGL_DEBUGOUTPUT_H
+
+// Header Files
+//=============
+
+#include "Includes.h"
+#include "../Configuration.h"
+#include "../../Asserts/Asserts.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace DebugOutput
+		{
+			// Call Sites
+			//-----------
+
+			struct sCallSite
+			{
+				const char* file;
+				unsigned int line;
+			};
+			// Every call site is a static, and so marking one is a single pointer write
+			void MarkCallSite( const sCallSite* const i_callSite );
+
+			// Messages
+			//---------
+
+			// This must be called on the render thread,
+			// and it outputs every message that the driver has reported since it was last called
+			void OutputQueuedMessages();
+
+			struct sStats
+			{
+				unsigned int errorCount;
+				// Every message that isn't an error (e.g. performance or undefined behavior warnings)
+				unsigned int warningCount;
+				// Messages are dropped if too many are reported in a single frame
+				unsigned int droppedMessageCount;
+			};
+			// These are totals since the debug output was initialized
+			const sStats& GetStats();
+			// This is false if the context wasn't created with device debug info or the driver doesn't support KHR_debug
+			bool IsEnabled();
+
+			// Benchmark
+			//----------
+
+			// This draws nothing many times with each kind of error checking
+			// and logs how much CPU time each draw took
+			void LogDrawCost();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Initialize();
+			bool CleanUp();
+		}
+	}
+}
+
+// Error Checking
+//===============
+
+#if defined( EAE6320_GRAPHICS_AREGLERRORSCHECKEDSYNCHRONOUSLY )
+	#define EAE6320_GRAPHICS_GL_ASSERTNOERROR() EAE6320_ASSERT( glGetError() == GL_NO_ERROR )
+#elif defined( EAE6320_GRAPHICS_ISDEVICEDEBUGINFOENABLED )
+	#define EAE6320_GRAPHICS_GL_ASSERTNOERROR()	\
+		{	\
+			static const eae6320::Graphics::DebugOutput::sCallSite callSite = { __FILE__, __LINE__ };	\
+			eae6320::Graphics::DebugOutput::MarkCallSite( &callSite );	\
+		}
+#else
+	#define EAE6320_GRAPHICS_GL_ASSERTNOERROR()
+#endif
+
+#endif	// EAE6320_GRAPHICS_OPENGL_DEBUGOUTPUT_H
@@ -0,0 +1,120 @@
+// Header Files
+//=============
+
+#include "../FrameFences.h"
+
+#include "DebugOutput.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// A sync object is created when a fence is inserted and deleted when its frame retires
+	GLsync s_fences[eae6320::Graphics::FrameFences::s_maxFrameCountInFlight] = { NULL };
+}
+
+// Interface
+//==========
+
+// Deferred Deletion
+//------------------
+
+void eae6320::Graphics::FrameFences::DeferDelete( const eResourceType::eResourceType i_type, const GLuint i_id )
+{
+	EAE6320_ASSERT( i_type < eResourceType::Count );
+	if ( i_id != 0 )
+	{
+		sResource resource;
+		resource.id = i_id;
+		resource.type = static_cast<uint8_t>( i_type );
+		Defer( resource );
+	}
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::FrameFences::CreateFences()
+{
+	// Sync objects are created when they are inserted
+	return true;
+}
+
+void eae6320::Graphics::FrameFences::DestroyFences()
+{
+	for ( unsigned int i = 0; i < s_maxFrameCountInFlight; ++i )
+	{
+		ReleaseFence( i );
+	}
+}
+
+bool eae6320::Graphics::FrameFences::InsertFence( const unsigned int i_fenceIndex )
+{
+	EAE6320_ASSERT( s_fences[i_fenceIndex] == NULL );
+	const GLbitfield noFlags = 0;
+	s_fences[i_fenceIndex] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, noFlags );
+	if ( s_fences[i_fenceIndex] == NULL )
+	{
+		const GLenum errorCode = glGetError();
+		EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		Logging::OutputError( "OpenGL failed to insert a frame fence: %s",
+			reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		return false;
+	}
+	return true;
+}
+
+bool eae6320::Graphics::FrameFences::IsFenceSignaled( const unsigned int i_fenceIndex )
+{
+	EAE6320_ASSERT( s_fences[i_fenceIndex] != NULL );
+	// The fence is only polled, and so it isn't flushed
+	// (the next SwapBuffers() will flush it)
+	const GLbitfield dontFlush = 0;
+	const GLuint64 dontWait = 0;
+	const GLenum result = glClientWaitSync( s_fences[i_fenceIndex], dontFlush, dontWait );
+	// If the wait fails the fence would never be signaled,
+	// and so it is treated as if it were rather than leaking everything that is deferred after it
+	EAE6320_ASSERT( result != GL_WAIT_FAILED );
+	return result != GL_TIMEOUT_EXPIRED;
+}
+
+void eae6320::Graphics::FrameFences::WaitForFence( const unsigned int i_fenceIndex )
+{
+	EAE6320_ASSERT( s_fences[i_fenceIndex] != NULL );
+	const GLuint64 waitForever = ~GLuint64( 0 );
+	const GLenum result = glClientWaitSync( s_fences[i_fenceIndex], GL_SYNC_FLUSH_COMMANDS_BIT, waitForever );
+	EAE6320_ASSERT( ( result == GL_ALREADY_SIGNALED ) || ( result == GL_CONDITION_SATISFIED ) );
+}
+
+void eae6320::Graphics::FrameFences::ReleaseFence( const unsigned int i_fenceIndex )
+{
+	if ( s_fences[i_fenceIndex] != NULL )
+	{
+		glDeleteSync( s_fences[i_fenceIndex] );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		s_fences[i_fenceIndex] = NULL;
+	}
+}
+
+void eae6320::Graphics::FrameFences::DeleteResource( const sResource& i_resource )
+{
+	const GLsizei count = 1;
+	switch ( i_resource.type )
+	{
+	case eResourceType::Buffer:
+		glDeleteBuffers( count, &i_resource.id );
+		break;
+	case eResourceType::VertexArray:
+		glDeleteVertexArrays( count, &i_resource.id );
+		break;
+	case eResourceType::Texture:
+		glDeleteTextures( count, &i_resource.id );
+		break;
+	default:
+		EAE6320_ASSERTF( false, "Invalid resource type %u", static_cast<unsigned int>( i_resource.type ) );
+	}
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
@@ -0,0 +1,82 @@
+// Header Files
+//=============
+
+#include "../GpuTimer.h"
+
+#include "DebugOutput.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Every frame has a timestamp query written before it and another one after it
+	// (OpenGL timestamps are always in nanoseconds)
+	GLuint s_queryIds_begin[eae6320::Graphics::GpuTimer::s_queryCount] = { 0 };
+	GLuint s_queryIds_end[eae6320::Graphics::GpuTimer::s_queryCount] = { 0 };
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::GpuTimer::CreateQueries()
+{
+	glGenQueries( s_queryCount, s_queryIds_begin );
+	glGenQueries( s_queryCount, s_queryIds_end );
+	const GLenum errorCode = glGetError();
+	if ( errorCode != GL_NO_ERROR )
+	{
+		EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		Logging::OutputError( "OpenGL failed to create the GPU timer queries: %s",
+			reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		DestroyQueries();
+		return false;
+	}
+	return true;
+}
+
+void eae6320::Graphics::GpuTimer::DestroyQueries()
+{
+	// Names that are zero are ignored
+	glDeleteQueries( s_queryCount, s_queryIds_begin );
+	glDeleteQueries( s_queryCount, s_queryIds_end );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	for ( unsigned int i = 0; i < s_queryCount; ++i )
+	{
+		s_queryIds_begin[i] = s_queryIds_end[i] = 0;
+	}
+}
+
+void eae6320::Graphics::GpuTimer::BeginQuery( const unsigned int i_queryIndex )
+{
+	glQueryCounter( s_queryIds_begin[i_queryIndex], GL_TIMESTAMP );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
+
+void eae6320::Graphics::GpuTimer::EndQuery( const unsigned int i_queryIndex )
+{
+	glQueryCounter( s_queryIds_end[i_queryIndex], GL_TIMESTAMP );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
+
+bool eae6320::Graphics::GpuTimer::GetQueryResult( const unsigned int i_queryIndex, bool& o_isValid, double& o_secondCount )
+{
+	// The end timestamp is written after the begin one,
+	// and so if it is available they both are
+	GLint isAvailable = GL_FALSE;
+	glGetQueryObjectiv( s_queryIds_end[i_queryIndex], GL_QUERY_RESULT_AVAILABLE, &isAvailable );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	if ( isAvailable == GL_FALSE )
+	{
+		return false;
+	}
+	GLuint64 timestamp_begin = 0, timestamp_end = 0;
+	glGetQueryObjectui64v( s_queryIds_begin[i_queryIndex], GL_QUERY_RESULT, &timestamp_begin );
+	glGetQueryObjectui64v( s_queryIds_end[i_queryIndex], GL_QUERY_RESULT, &timestamp_end );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	o_isValid = timestamp_end >= timestamp_begin;
+	o_secondCount = o_isValid ? ( static_cast<double>( timestamp_end - timestamp_begin ) * 1.0e-9 ) : 0.0;
+	return true;
+}
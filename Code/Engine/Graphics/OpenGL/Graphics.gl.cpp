@@ -6,15 +6,17 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include "DebugOutput.h"
 #include "Includes.h"
 #include <string>
 #include <vector>
 #include <sstream>
+#include "../CommandList.h"
 #include "../Includes.h"
+#include "../MeshClusters.h"
 #include "../../Asserts/Asserts.h"
 #include "../../Logging/Logging.h"
 #include "../../Platform/Platform.h"
-#include "../../Time/Time.h"
 #include "../../Windows/Functions.h"
 #include "../../Windows/OpenGl.h"
 #include "../../../External/OpenGlExtensions/OpenGlExtensions.h"
@@ -30,9 +32,14 @@ namespace
 	HDC s_deviceContext = NULL;
 	HGLRC s_openGlRenderingContext = NULL;
 
-	//The list of renderables to be drawn
-	std::vector <eae6320::Graphics::Mesh *> s_listOfRenderables;
-
+	eae6320::Graphics::ePresentMode::ePresentMode s_presentMode = eae6320::Graphics::ePresentMode::VSync;
+	// OpenGL doesn't expose how many frames the driver queues, but this is what drivers usually allow
+	const unsigned int s_maxQueuedFrameCount_default = 3;
+	const unsigned int s_maxQueuedFrameCount_lowLatency = 1;
+	// In the low latency mode a fence is inserted after every frame is presented,
+	// and the CPU waits for the fence that is s_maxQueuedFrameCount_lowLatency frames old
+	GLsync s_queuedFrameFences[s_maxQueuedFrameCount_lowLatency] = { NULL };
+	unsigned int s_queuedFrameFenceIndex = 0;
 
 	//// This struct determines the layout of the geometric data that the CPU will send to the GPU
 	//struct sVertex
@@ -52,37 +59,6 @@ namespace
 	//GLuint s_vertexBufferId = 0;
 #endif
 
-	// OpenGL encapsulates a matching vertex shader and fragment shader into what it calls a "program".
-
-	// A vertex shader is a program that operates on vertices.
-	// Its input comes from a C/C++ "draw call" and is:
-	//	* Position
-	//	* Any other data we want
-	// Its output is:
-	//	* Position
-	//		(So that the graphics hardware knows which pixels to fill in for the triangle)
-	//	* Any other data we want
-
-	// The fragment shader is a program that operates on fragments
-	// (or potential pixels).
-	// Its input is:
-	//	* The data that was output from the vertex shader,
-	//		interpolated based on how close the fragment is
-	//		to each vertex in the triangle.
-	// Its output is:
-	//	* The final color that the pixel should be
-	GLuint s_programId = 0;
-
-	// This struct determines the layout of the constant data that the CPU will send to the GPU
-	struct
-	{
-		union
-		{
-			float g_elapsedSecondCount_total;
-			float register0[4];	// You won't have to worry about why I do this until a later assignment
-		};
-	} s_constantBufferData;
-	GLuint s_constantBufferId = 0;
 }
 
 // Helper Function Declarations
@@ -90,113 +66,50 @@ namespace
 
 namespace
 {
-	bool CreateConstantBuffer();
-	bool CreateProgram();
 	bool CreateRenderingContext();
 	bool CreateVertexBuffer();
+	void DeleteQueuedFrameFences();
+	void LimitQueuedFrames();
 	bool LoadAndAllocateShaderProgram( const char* i_path, void*& o_shader, size_t& o_size, std::string* o_errorMessage );
-	bool LoadFragmentShader( const GLuint i_programId );
-	bool LoadVertexShader( const GLuint i_programId );
-
-	// This helper struct exists to be able to dynamically allocate memory to get "log info"
-	// which will automatically be freed when the struct goes out of scope
-	struct sLogInfo
-	{
-		GLchar* memory;
-		sLogInfo( const size_t i_size ) { memory = reinterpret_cast<GLchar*>( malloc( i_size ) ); }
-		~sLogInfo() { if ( memory ) free( memory ); }
-	};
 }
 
 // Interface
 //==========
 
-// Submit to Draw
-//-------
-
-void eae6320::Graphics::SubmitObject(eae6320::Graphics::Mesh * object)
-{
-	s_listOfRenderables.push_back(object);
-}
-
 // Render
 //-------
 
 void eae6320::Graphics::RenderFrame()
 {
-	// Every frame an entirely new image will be created.
-	// Before drawing anything, then, the previous image will be erased
-	// by "clearing" the image buffer (filling it with a solid color)
+	BeginFrameWork();
+
+	// Create the GPU resources of assets that have finished loading asynchronously
+	// (before the texture streamer so that streamed textures are registered with it this frame)
+	AssetLoader::Update();
+	// Submit the copies of everything that was written to staging memory since the previous frame
+	// (before the texture streamer changes which mips of the new textures are resident)
+	UploadManager::Flush();
+	// Upload any texture mips that have been streamed in
+	// and decide which mips to stream in or evict based on what was needed last frame
+	TextureStreamer::Update();
+
+	// Clear the back buffer and draw the geometry
 	{
-		// Black is usually used
-		glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );
-		EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
-		// In addition to the color, "depth" and "stencil" can also be cleared,
-		// but for now we only care about color
-		const GLbitfield clearColor = GL_COLOR_BUFFER_BIT;
-		glClear( clearColor );
-		EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
-	}
-
-	// Update the constant buffer
-	{
-		// Update the struct (i.e. the memory that we own)
-		s_constantBufferData.g_elapsedSecondCount_total = Time::GetElapsedSecondCount_total();
-		// Make the uniform buffer active
-		{
-			glBindBuffer( GL_UNIFORM_BUFFER, s_constantBufferId );
-			EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
-		}
-		// Copy the updated memory to the GPU
+		// The back buffer is the size of the window's client area
+		RECT clientRectangle;
+		if ( GetClientRect( s_renderingWindow, &clientRectangle ) == FALSE )
 		{
-			GLintptr updateAtTheBeginning = 0;
-			GLsizeiptr updateTheEntireBuffer = static_cast<GLsizeiptr>( sizeof( s_constantBufferData ) );
-			glBufferSubData( GL_UNIFORM_BUFFER, updateAtTheBeginning, updateTheEntireBuffer, &s_constantBufferData );
-			EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
-		}
-		// Bind the constant buffer to the shader
-		{
-			const GLuint bindingPointAssignedInShader = 0;
-			glBindBufferBase( GL_UNIFORM_BUFFER, bindingPointAssignedInShader, s_constantBufferId );
-			EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
-		}
-	}
-
-	// Draw the geometry
-	{
-		// Set the vertex and fragment shaders
-		{
-			glUseProgram( s_programId );
-			EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
-		}
-		//// Bind a specific vertex buffer to the device as a data source
-		//{
-		//	glBindVertexArray( s_vertexArrayId );
-		//	EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
-		//}
-		//// Render triangles from the currently-bound vertex buffer
-		//{
-		//	// The mode defines how to interpret multiple vertices as a single "primitive";
-		//	// we define a triangle list
-		//	// (meaning that every primitive is a triangle and will be defined by three vertices)
-		//	const GLenum mode = GL_TRIANGLES;
-		//	// It's possible to start rendering primitives in the middle of the stream
-		//	const GLint indexOfFirstVertexToRender = 0;
-		//	// As of this comment we are only drawing a single triangle
-		//	// (you will have to update this code in future assignments!)
-		//	const unsigned int triangleCount = 2;
-		//	const unsigned int vertexCountPerTriangle = 3;
-		//	const unsigned int vertexCountToRender = triangleCount * vertexCountPerTriangle;
-		//	glDrawArrays( mode, indexOfFirstVertexToRender, vertexCountToRender );
-		//	EAE6320_ASSERT( glGetError() == GL_NO_ERROR );
-		//}
-
-		for (std::vector<Mesh *>::iterator i = s_listOfRenderables.begin(); i != s_listOfRenderables.end(); ++i)
-		{
-			(*i)->Draw();
+			EAE6320_ASSERT( false );
+			clientRectangle.left = clientRectangle.top = clientRectangle.right = clientRectangle.bottom = 0;
 		}
-		s_listOfRenderables.clear();
+		sTargetDescription backBufferDescription;
+		backBufferDescription.width = static_cast<uint16_t>( clientRectangle.right - clientRectangle.left );
+		backBufferDescription.height = static_cast<uint16_t>( clientRectangle.bottom - clientRectangle.top );
+		backBufferDescription.format = eTargetFormat::R8G8B8A8;
+		const bool wasGraphExecuted = ExecuteRenderGraph( backBufferDescription );
+		EAE6320_ASSERT( wasGraphExecuted );
 	}
+	EndFrameWork();
 
 	// Everything has been drawn to the "back buffer", which is just an image in memory.
 	// In order to display it, the contents of the back buffer must be swapped with the "front buffer"
@@ -205,6 +118,49 @@ void eae6320::Graphics::RenderFrame()
 		BOOL result = SwapBuffers( s_deviceContext );
 		EAE6320_ASSERT( result != FALSE );
 	}
+	if ( s_presentMode == ePresentMode::LowLatency )
+	{
+		LimitQueuedFrames();
+	}
+	// Resources that were deferred during frames that the GPU has finished are deleted
+	FrameFences::EndFrame();
+	EAE6320_GRAPHICS_STATISTICS( EndFrame() );
+
+	// Any errors from the frame that the driver has already reported are output
+	// (errors in the calls that the driver hasn't processed yet will be output after a later frame)
+	DebugOutput::OutputQueuedMessages();
+}
+
+// Presentation
+//-------------
+
+bool eae6320::Graphics::SetPresentMode( const ePresentMode::ePresentMode i_presentMode )
+{
+	EAE6320_ASSERT( i_presentMode < ePresentMode::Count );
+	s_presentMode = i_presentMode;
+	DeleteQueuedFrameFences();
+
+	const bool shouldWaitForVerticalBlank = ( s_presentMode == ePresentMode::VSync ) || ( s_presentMode == ePresentMode::LowLatency );
+	const int swapImmediately = 0;
+	const int swapOnVerticalBlank = 1;
+	if ( wglSwapIntervalEXT( shouldWaitForVerticalBlank ? swapOnVerticalBlank : swapImmediately ) == FALSE )
+	{
+		const std::string windowsErrorMessage = Windows::GetLastSystemError();
+		EAE6320_ASSERTF( false, windowsErrorMessage.c_str() );
+		Logging::OutputError( "Windows failed to set the OpenGL swap interval: %s", windowsErrorMessage.c_str() );
+		return false;
+	}
+	return true;
+}
+
+eae6320::Graphics::ePresentMode::ePresentMode eae6320::Graphics::GetPresentMode()
+{
+	return s_presentMode;
+}
+
+unsigned int eae6320::Graphics::GetMaxQueuedFrameCount()
+{
+	return ( s_presentMode == ePresentMode::LowLatency ) ? s_maxQueuedFrameCount_lowLatency : s_maxQueuedFrameCount_default;
 }
 
 // Initialization / Clean Up
@@ -229,6 +185,21 @@ bool eae6320::Graphics::Initialize( const sInitializationParameters& i_initializ
 		EAE6320_ASSERT( false );
 		return false;
 	}
+	// Errors in per-frame code are reported by the debug output
+	if ( !DebugOutput::Initialize() )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+#ifdef EAE6320_GRAPHICS_SHOULDGLERRORCHECKINGBEMEASURED
+	DebugOutput::LogDrawCost();
+#endif
+	EAE6320_GRAPHICS_STATISTICS( Initialize( i_initializationParameters.statisticsLogPeriodInFrames ) );
+	if ( !FrameFences::Initialize() )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
 
 	// Initialize the graphics objects
 	if ( !CreateVertexBuffer() )
@@ -236,12 +207,47 @@ bool eae6320::Graphics::Initialize( const sInitializationParameters& i_initializ
 		EAE6320_ASSERT( false );
 		return false;
 	}
-	if ( !CreateProgram() )
+	if ( !CommandList::Initialize() )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+#ifdef EAE6320_GRAPHICS_SHOULDPARTICLESIMULATIONBEMEASURED
+	ParticleEmitter::LogSimulationCost();
+#endif
+#ifdef EAE6320_GRAPHICS_SHOULDCOMMANDLISTRECORDINGBEMEASURED
+	CommandList::LogRecordingCost();
+#endif
+#ifdef EAE6320_GRAPHICS_SHOULDMESHCLUSTERCULLINGBEMEASURED
+	MeshClusters::LogCullingCost();
+#endif
+#ifdef EAE6320_GRAPHICS_SHOULDSKINNINGBEMEASURED
+	SkinnedMesh::LogSkinningCost();
+#endif
+#ifdef EAE6320_GRAPHICS_SHOULDCLUSTEREDLIGHTASSIGNMENTBEMEASURED
+	ClusteredLights::LogAssignmentCost();
+#endif
+	if ( !UploadManager::Initialize( i_initializationParameters.uploadManagerSettings ) )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+	if ( !TextureStreamer::Initialize( i_initializationParameters.textureStreamerSettings ) )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+	if ( !AssetLoader::Initialize( i_initializationParameters.assetLoaderSettings ) )
 	{
 		EAE6320_ASSERT( false );
 		return false;
 	}
-	if ( !CreateConstantBuffer() )
+	if ( !InitializeRenderGraph( i_initializationParameters.dynamicResolutionSettings ) )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+	if ( !SetPresentMode( i_initializationParameters.presentMode ) )
 	{
 		EAE6320_ASSERT( false );
 		return false;
@@ -254,21 +260,49 @@ bool eae6320::Graphics::CleanUp()
 {
 	bool wereThereErrors = false;
 
+	if ( !AssetLoader::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	if ( !TextureStreamer::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	if ( !CleanUpRenderGraph() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	if ( !CommandList::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	if ( !UploadManager::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	// This waits for the GPU to finish,
+	// and so anything that is still queued for deletion can be deleted
+	if ( !FrameFences::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+	DeleteQueuedFrameFences();
+	// Every graphics object should have been cleaned up by now
+	EAE6320_GRAPHICS_STATISTICS( CleanUp() );
+	if ( !DebugOutput::CleanUp() )
+	{
+		wereThereErrors = true;
+		EAE6320_ASSERT( false );
+	}
+
 	if ( s_openGlRenderingContext != NULL )
 	{
-		if ( s_programId != 0 )
-		{
-			glDeleteProgram( s_programId );
-			const GLenum errorCode = glGetError();
-			if ( errorCode != GL_NO_ERROR )
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				Logging::OutputError( "OpenGL failed to delete the program: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-			}
-			s_programId = 0;
-		}
 //#ifdef EAE6320_GRAPHICS_ISDEVICEDEBUGINFOENABLED
 //		if ( s_vertexBufferId != 0 )
 //		{
@@ -300,21 +334,6 @@ bool eae6320::Graphics::CleanUp()
 //			s_vertexArrayId = 0;
 //		}
 
-		if ( s_constantBufferId != 0 )
-		{
-			const GLsizei bufferCount = 1;
-			glDeleteBuffers( bufferCount, &s_constantBufferId );
-			const GLenum errorCode = glGetError();
-			if ( errorCode != GL_NO_ERROR )
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				Logging::OutputError( "OpenGL failed to delete the constant buffer: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-			}
-			s_constantBufferId = 0;
-		}
-
 		if ( wglMakeCurrent( s_deviceContext, NULL ) != FALSE )
 		{
 			if ( wglDeleteContext( s_openGlRenderingContext ) == FALSE )
@@ -352,166 +371,6 @@ bool eae6320::Graphics::CleanUp()
 
 namespace
 {
-	bool CreateConstantBuffer()
-	{
-		bool wereThereErrors = false;
-
-		// Create a uniform buffer object and make it active
-		{
-			const GLsizei bufferCount = 1;
-			glGenBuffers( bufferCount, &s_constantBufferId );
-			const GLenum errorCode = glGetError();
-			if ( errorCode == GL_NO_ERROR )
-			{
-				glBindBuffer( GL_UNIFORM_BUFFER, s_constantBufferId );
-				const GLenum errorCode = glGetError();
-				if ( errorCode != GL_NO_ERROR )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					eae6320::Logging::OutputError( "OpenGL failed to bind the new uniform buffer %u: %s",
-						s_constantBufferId, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					goto OnExit;
-				}
-			}
-			else
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to get an unused uniform buffer ID: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				goto OnExit;
-			}
-		}
-		// Fill in the constant buffer
-		s_constantBufferData.g_elapsedSecondCount_total = eae6320::Time::GetElapsedSecondCount_total();
-		// Allocate space and copy the constant data into the uniform buffer
-		{
-			const GLenum usage = GL_DYNAMIC_DRAW;	// The buffer will be modified frequently and used to draw
-			glBufferData( GL_UNIFORM_BUFFER, sizeof( s_constantBufferData ), reinterpret_cast<const GLvoid*>( &s_constantBufferData ), usage );
-			const GLenum errorCode = glGetError();
-			if ( errorCode != GL_NO_ERROR )
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to allocate the new uniform buffer %u: %s",
-					s_constantBufferId, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				goto OnExit;
-			}
-		}
-
-	OnExit:
-
-		return !wereThereErrors;
-	}
-
-	bool CreateProgram()
-	{
-		// Create a program
-		{
-			s_programId = glCreateProgram();
-			const GLenum errorCode = glGetError();
-			if ( errorCode != GL_NO_ERROR )
-			{
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to create a program: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				return false;
-			}
-			else if ( s_programId == 0 )
-			{
-				EAE6320_ASSERT( false );
-				eae6320::Logging::OutputError( "OpenGL failed to create a program" );
-				return false;
-			}
-		}
-		// Load and attach the shaders
-		if ( !LoadVertexShader( s_programId ) )
-		{
-			EAE6320_ASSERT( false );
-			return false;
-		}
-		if ( !LoadFragmentShader( s_programId ) )
-		{
-			EAE6320_ASSERT( false );
-			return false;
-		}
-		// Link the program
-		{
-			glLinkProgram( s_programId );
-			GLenum errorCode = glGetError();
-			if ( errorCode == GL_NO_ERROR )
-			{
-				// Get link info
-				// (this won't be used unless linking fails
-				// but it can be useful to look at when debugging)
-				std::string linkInfo;
-				{
-					GLint infoSize;
-					glGetProgramiv( s_programId, GL_INFO_LOG_LENGTH, &infoSize );
-					errorCode = glGetError();
-					if ( errorCode == GL_NO_ERROR )
-					{
-						sLogInfo info( static_cast<size_t>( infoSize ) );
-						GLsizei* dontReturnLength = NULL;
-						glGetProgramInfoLog( s_programId, static_cast<GLsizei>( infoSize ), dontReturnLength, info.memory );
-						errorCode = glGetError();
-						if ( errorCode == GL_NO_ERROR )
-						{
-							linkInfo = info.memory;
-						}
-						else
-						{
-							EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-							eae6320::Logging::OutputError( "OpenGL failed to get link info of the program: %s",
-								reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-							return false;
-						}
-					}
-					else
-					{
-						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						eae6320::Logging::OutputError( "OpenGL failed to get the length of the program link info: %s",
-							reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						return false;
-					}
-				}
-				// Check to see if there were link errors
-				GLint didLinkingSucceed;
-				{
-					glGetProgramiv( s_programId, GL_LINK_STATUS, &didLinkingSucceed );
-					errorCode = glGetError();
-					if ( errorCode == GL_NO_ERROR )
-					{
-						if ( didLinkingSucceed == GL_FALSE )
-						{
-							EAE6320_ASSERTF( false, linkInfo.c_str() );
-							eae6320::Logging::OutputError( "The program failed to link: %s",
-								linkInfo.c_str() );
-							return false;
-						}
-					}
-					else
-					{
-						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						eae6320::Logging::OutputError( "OpenGL failed to find out if linking of the program succeeded: %s",
-							reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						return false;
-					}
-				}
-			}
-			else
-			{
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to link the program: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				return false;
-			}
-		}
-
-		return true;
-	}
-
 	bool CreateRenderingContext()
 	{
 		// Get the device context
@@ -843,369 +702,36 @@ namespace
 		return !wereThereErrors;
 	}
 
-	bool LoadFragmentShader( const GLuint i_programId )
+	void DeleteQueuedFrameFences()
 	{
-		// Verify that compiling shaders at run-time is supported
-		{
-			GLboolean isShaderCompilingSupported;
-			glGetBooleanv( GL_SHADER_COMPILER, &isShaderCompilingSupported );
-			if ( !isShaderCompilingSupported )
-			{
-				//eae6320::UserOutput::Print( "Compiling shaders at run-time isn't supported on this implementation (this should never happen)" );
-				return false;
-			}
-		}
-
-		bool wereThereErrors = false;
-
-		// Load the source code from file and set it into a shader
-		GLuint fragmentShaderId = 0;
-		eae6320::Platform::sDataFromFile dataFromFile;
-		{
-			// Load the shader source code
-			{
-				const char* path_sourceCode = "data/fragmentShader.glsl";
-				std::string errorMessage;
-				if ( !eae6320::Platform::LoadBinaryFile( path_sourceCode, dataFromFile, &errorMessage ) )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF( false, errorMessage.c_str() );
-					eae6320::Logging::OutputError( "Failed to load the fragment shader \"%s\": %s",
-						path_sourceCode, errorMessage.c_str() );
-					goto OnExit;
-				}
-			}
-			// Generate a shader
-			fragmentShaderId = glCreateShader( GL_FRAGMENT_SHADER );
-			{
-				const GLenum errorCode = glGetError();
-				if ( errorCode != GL_NO_ERROR )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					eae6320::Logging::OutputError( "OpenGL failed to get an unused fragment shader ID: %s",
-						reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					goto OnExit;
-				}
-				else if ( fragmentShaderId == 0 )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERT( false );
-					eae6320::Logging::OutputError( "OpenGL failed to get an unused fragment shader ID" );
-					goto OnExit;
-				}
-			}
-			// Set the source code into the shader
-			{
-				const GLsizei shaderSourceCount = 1;
-				const GLint length = static_cast<GLuint>( dataFromFile.size );
-				glShaderSource( fragmentShaderId, shaderSourceCount, reinterpret_cast<GLchar**>( &dataFromFile.data ), &length );
-				const GLenum errorCode = glGetError();
-				if ( errorCode != GL_NO_ERROR )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					eae6320::Logging::OutputError( "OpenGL failed to set the fragment shader source code: %s",
-						reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					goto OnExit;
-				}
-			}
-		}
-		// Compile the shader source code
-		{
-			glCompileShader( fragmentShaderId );
-			GLenum errorCode = glGetError();
-			if ( errorCode == GL_NO_ERROR )
-			{
-				// Get compilation info
-				// (this won't be used unless compilation fails
-				// but it can be useful to look at when debugging)
-				std::string compilationInfo;
-				{
-					GLint infoSize;
-					glGetShaderiv( fragmentShaderId, GL_INFO_LOG_LENGTH, &infoSize );
-					errorCode = glGetError();
-					if ( errorCode == GL_NO_ERROR )
-					{
-						sLogInfo info( static_cast<size_t>( infoSize ) );
-						GLsizei* dontReturnLength = NULL;
-						glGetShaderInfoLog( fragmentShaderId, static_cast<GLsizei>( infoSize ), dontReturnLength, info.memory );
-						errorCode = glGetError();
-						if ( errorCode == GL_NO_ERROR )
-						{
-							compilationInfo = info.memory;
-						}
-						else
-						{
-							wereThereErrors = true;
-							EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-							eae6320::Logging::OutputError( "OpenGL failed to get compilation info about the fragment shader source code: %s",
-								reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-							goto OnExit;
-						}
-					}
-					else
-					{
-						wereThereErrors = true;
-						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						eae6320::Logging::OutputError( "OpenGL failed to get the length of the fragment shader compilation info: %s",
-							reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						goto OnExit;
-					}
-				}
-				// Check to see if there were compilation errors
-				GLint didCompilationSucceed;
-				{
-					glGetShaderiv( fragmentShaderId, GL_COMPILE_STATUS, &didCompilationSucceed );
-					errorCode = glGetError();
-					if ( errorCode == GL_NO_ERROR )
-					{
-						if ( didCompilationSucceed == GL_FALSE )
-						{
-							wereThereErrors = true;
-							EAE6320_ASSERTF( false, compilationInfo.c_str() );
-							eae6320::Logging::OutputError( "OpenGL failed to compile the fragment shader: %s",
-								compilationInfo.c_str() );
-							goto OnExit;
-						}
-					}
-					else
-					{
-						wereThereErrors = true;
-						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						eae6320::Logging::OutputError( "OpenGL failed to find if compilation of the fragment shader source code succeeded: %s",
-							reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						goto OnExit;
-					}
-				}
-			}
-			else
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to compile the fragment shader source code: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				goto OnExit;
-			}
-		}
-		// Attach the shader to the program
+		for ( unsigned int i = 0; i < s_maxQueuedFrameCount_lowLatency; ++i )
 		{
-			glAttachShader( i_programId, fragmentShaderId );
-			const GLenum errorCode = glGetError();
-			if ( errorCode != GL_NO_ERROR )
+			if ( s_queuedFrameFences[i] != NULL )
 			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to attach the fragment to the program: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				goto OnExit;
+				glDeleteSync( s_queuedFrameFences[i] );
+				EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+				s_queuedFrameFences[i] = NULL;
 			}
 		}
-
-	OnExit:
-
-		if ( fragmentShaderId != 0 )
-		{
-			// Even if the shader was successfully compiled
-			// once it has been attached to the program we can (and should) delete our reference to it
-			// (any associated memory that OpenGL has allocated internally will be freed
-			// once the program is deleted)
-			glDeleteShader( fragmentShaderId );
-			const GLenum errorCode = glGetError();
-			if ( errorCode != GL_NO_ERROR )
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to delete the fragment shader ID %u: %s",
-					fragmentShaderId, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-			}
-			fragmentShaderId = 0;
-		}
-		dataFromFile.Free();
-
-		return !wereThereErrors;
+		s_queuedFrameFenceIndex = 0;
 	}
 
-	bool LoadVertexShader( const GLuint i_programId )
+	void LimitQueuedFrames()
 	{
-		// Verify that compiling shaders at run-time is supported
+		// The fence that is about to be replaced was inserted after the oldest frame that can still be queued
+		GLsync& fence = s_queuedFrameFences[s_queuedFrameFenceIndex];
+		if ( fence != NULL )
 		{
-			GLboolean isShaderCompilingSupported;
-			glGetBooleanv( GL_SHADER_COMPILER, &isShaderCompilingSupported );
-			if ( !isShaderCompilingSupported )
-			{
-				//eae6320::UserOutput::Print( "Compiling shaders at run-time isn't supported on this implementation (this should never happen)" );
-				return false;
-			}
+			const GLuint64 waitForever = ~GLuint64( 0 );
+			const GLenum result = glClientWaitSync( fence, GL_SYNC_FLUSH_COMMANDS_BIT, waitForever );
+			EAE6320_ASSERT( ( result == GL_ALREADY_SIGNALED ) || ( result == GL_CONDITION_SATISFIED ) );
+			glDeleteSync( fence );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
 		}
-
-		bool wereThereErrors = false;
-
-		// Load the source code from file and set it into a shader
-		GLuint vertexShaderId = 0;
-		eae6320::Platform::sDataFromFile dataFromFile;
-		{
-			// Load the shader source code
-			{
-				const char* path_sourceCode = "data/vertexShader.glsl";
-				std::string errorMessage;
-				if ( !eae6320::Platform::LoadBinaryFile( path_sourceCode, dataFromFile, &errorMessage ) )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF( false, errorMessage.c_str() );
-					eae6320::Logging::OutputError( "Failed to load the vertex shader \"%s\": %s",
-						path_sourceCode, errorMessage.c_str() );
-					goto OnExit;
-				}
-			}
-			// Generate a shader
-			vertexShaderId = glCreateShader( GL_VERTEX_SHADER );
-			{
-				const GLenum errorCode = glGetError();
-				if ( errorCode != GL_NO_ERROR )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					eae6320::Logging::OutputError( "OpenGL failed to get an unused vertex shader ID: %s",
-						reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					goto OnExit;
-				}
-				else if ( vertexShaderId == 0 )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERT( false );
-					eae6320::Logging::OutputError( "OpenGL failed to get an unused vertex shader ID" );
-					goto OnExit;
-				}
-			}
-			// Set the source code into the shader
-			{
-				const GLsizei shaderSourceCount = 1;
-				const GLint length = static_cast<GLuint>( dataFromFile.size );
-				glShaderSource( vertexShaderId, shaderSourceCount, reinterpret_cast<GLchar**>( &dataFromFile.data ), &length );
-				const GLenum errorCode = glGetError();
-				if ( errorCode != GL_NO_ERROR )
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					eae6320::Logging::OutputError( "OpenGL failed to set the vertex shader source code: %s",
-						reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-					goto OnExit;
-				}
-			}
-		}
-		// Compile the shader source code
-		{
-			glCompileShader( vertexShaderId );
-			GLenum errorCode = glGetError();
-			if ( errorCode == GL_NO_ERROR )
-			{
-				// Get compilation info
-				// (this won't be used unless compilation fails
-				// but it can be useful to look at when debugging)
-				std::string compilationInfo;
-				{
-					GLint infoSize;
-					glGetShaderiv( vertexShaderId, GL_INFO_LOG_LENGTH, &infoSize );
-					errorCode = glGetError();
-					if ( errorCode == GL_NO_ERROR )
-					{
-						sLogInfo info( static_cast<size_t>( infoSize ) );
-						GLsizei* dontReturnLength = NULL;
-						glGetShaderInfoLog( vertexShaderId, static_cast<GLsizei>( infoSize ), dontReturnLength, info.memory );
-						errorCode = glGetError();
-						if ( errorCode == GL_NO_ERROR )
-						{
-							compilationInfo = info.memory;
-						}
-						else
-						{
-							wereThereErrors = true;
-							EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-							eae6320::Logging::OutputError( "OpenGL failed to get compilation info about the vertex shader source code: %s",
-								reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-							goto OnExit;
-						}
-					}
-					else
-					{
-						wereThereErrors = true;
-						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						eae6320::Logging::OutputError( "OpenGL failed to get the length of the vertex shader compilation info: %s",
-							reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						goto OnExit;
-					}
-				}
-				// Check to see if there were compilation errors
-				GLint didCompilationSucceed;
-				{
-					glGetShaderiv( vertexShaderId, GL_COMPILE_STATUS, &didCompilationSucceed );
-					errorCode = glGetError();
-					if ( errorCode == GL_NO_ERROR )
-					{
-						if ( didCompilationSucceed == GL_FALSE )
-						{
-							wereThereErrors = true;
-							EAE6320_ASSERTF( false, compilationInfo.c_str() );
-							eae6320::Logging::OutputError( "OpenGL failed to compile the vertex shader: %s",
-								compilationInfo.c_str() );
-							goto OnExit;
-						}
-					}
-					else
-					{
-						wereThereErrors = true;
-						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						eae6320::Logging::OutputError( "OpenGL failed to find if compilation of the vertex shader source code succeeded: %s",
-							reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-						goto OnExit;
-					}
-				}
-			}
-			else
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to compile the vertex shader source code: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				goto OnExit;
-			}
-		}
-		// Attach the shader to the program
-		{
-			glAttachShader( i_programId, vertexShaderId );
-			const GLenum errorCode = glGetError();
-			if ( errorCode != GL_NO_ERROR )
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to attach the vertex to the program: %s",
-					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				goto OnExit;
-			}
-		}
-
-	OnExit:
-
-		if ( vertexShaderId != 0 )
-		{
-			// Even if the shader was successfully compiled
-			// once it has been attached to the program we can (and should) delete our reference to it
-			// (any associated memory that OpenGL has allocated internally will be freed
-			// once the program is deleted)
-			glDeleteShader( vertexShaderId );
-			const GLenum errorCode = glGetError();
-			if ( errorCode != GL_NO_ERROR )
-			{
-				wereThereErrors = true;
-				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-				eae6320::Logging::OutputError( "OpenGL failed to delete the vertex shader ID %u: %s",
-					vertexShaderId, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
-			}
-			vertexShaderId = 0;
-		}
-		dataFromFile.Free();
-
-		return !wereThereErrors;
+		const GLbitfield noFlags = 0;
+		fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, noFlags );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		EAE6320_ASSERT( fence != NULL );
+		s_queuedFrameFenceIndex = ( s_queuedFrameFenceIndex + 1 ) % s_maxQueuedFrameCount_lowLatency;
 	}
 }
@@ -0,0 +1,494 @@
+// Header Files
+//=============
+
+#include "../Material.h"
+
+#include <cstdlib>
+#include <string>
+#include "DebugOutput.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+#include "../../Platform/Platform.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool LoadShader( const GLuint i_programId, const void* const i_sourceCode, const size_t i_sourceCodeSize,
+		const GLenum i_shaderType, const char* const i_path );
+
+	// This helper struct exists to be able to dynamically allocate memory to get "log info"
+	// which will automatically be freed when the struct goes out of scope
+	struct sLogInfo
+	{
+		GLchar* memory;
+		sLogInfo( const size_t i_size ) { memory = reinterpret_cast<GLchar*>( malloc( i_size ) ); }
+		~sLogInfo() { if ( memory ) free( memory ); }
+	};
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::Material::BindEffect() const
+{
+	// Set the vertex and fragment shaders
+	{
+		glUseProgram( m_effect->programId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		EAE6320_GRAPHICS_STATISTICS( CountProgramSwitch() );
+	}
+	// Set the render states
+	{
+		const uint8_t renderStates = m_effect->renderStates;
+		if ( renderStates & MaterialFormats::eRenderState::AlphaTransparency )
+		{
+			glEnable( GL_BLEND );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+			// result = ( source * source.a ) + ( destination * ( 1 - source.a ) )
+			glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+		else
+		{
+			glDisable( GL_BLEND );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+		if ( renderStates & MaterialFormats::eRenderState::DepthTesting )
+		{
+			glEnable( GL_DEPTH_TEST );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+			glDepthFunc( GL_LEQUAL );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+		else
+		{
+			glDisable( GL_DEPTH_TEST );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+		glDepthMask( ( renderStates & MaterialFormats::eRenderState::DepthWriting ) ? GL_TRUE : GL_FALSE );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		if ( renderStates & MaterialFormats::eRenderState::DrawBothTriangleSides )
+		{
+			glDisable( GL_CULL_FACE );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+		else
+		{
+			glEnable( GL_CULL_FACE );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+			// Triangles are authored with a clockwise winding order (which is what Direct3D expects)
+			glFrontFace( GL_CW );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+	}
+}
+
+void eae6320::Graphics::Material::BindParameterBlock() const
+{
+	const GLuint bindingPointAssignedInShader = 1;
+	glBindBufferBase( GL_UNIFORM_BUFFER, bindingPointAssignedInShader, m_parameterBuffer->constantBufferId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+}
+
+// Implementation
+//===============
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::Material::CreateEffect( const sShaderVariant& i_vertexShader, const sShaderVariant& i_fragmentShader,
+	const uint8_t i_renderStates, const uint8_t i_vertexFormat, sEffect& o_effect )
+{
+	// OpenGL doesn't have state objects, and so the render states are set when the effect is bound
+	// (and the vertex format is part of each vertex array object, and so the effect doesn't need to know it)
+	o_effect.renderStates = i_renderStates;
+	// Create a program
+	{
+		o_effect.programId = glCreateProgram();
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to create a program: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			return false;
+		}
+		else if ( o_effect.programId == 0 )
+		{
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "OpenGL failed to create a program" );
+			return false;
+		}
+	}
+	// Compile and attach the shaders
+	// (the ShaderBuilder has already inserted the permutation's #defines into the source code)
+	if ( !LoadShader( o_effect.programId, i_vertexShader.data, i_vertexShader.size, GL_VERTEX_SHADER, i_vertexShader.path ) )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+	if ( !LoadShader( o_effect.programId, i_fragmentShader.data, i_fragmentShader.size, GL_FRAGMENT_SHADER, i_fragmentShader.path ) )
+	{
+		EAE6320_ASSERT( false );
+		return false;
+	}
+	// Link the program
+	{
+		glLinkProgram( o_effect.programId );
+		GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			// Get link info
+			// (this won't be used unless linking fails
+			// but it can be useful to look at when debugging)
+			std::string linkInfo;
+			{
+				GLint infoSize;
+				glGetProgramiv( o_effect.programId, GL_INFO_LOG_LENGTH, &infoSize );
+				errorCode = glGetError();
+				if ( errorCode == GL_NO_ERROR )
+				{
+					sLogInfo info( static_cast<size_t>( infoSize ) );
+					GLsizei* dontReturnLength = NULL;
+					glGetProgramInfoLog( o_effect.programId, static_cast<GLsizei>( infoSize ), dontReturnLength, info.memory );
+					errorCode = glGetError();
+					if ( errorCode == GL_NO_ERROR )
+					{
+						linkInfo = info.memory;
+					}
+					else
+					{
+						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+						Logging::OutputError( "OpenGL failed to get link info of the program: %s",
+							reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+						return false;
+					}
+				}
+				else
+				{
+					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					Logging::OutputError( "OpenGL failed to get the length of the program link info: %s",
+						reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					return false;
+				}
+			}
+			// Check to see if there were link errors
+			GLint didLinkingSucceed;
+			{
+				glGetProgramiv( o_effect.programId, GL_LINK_STATUS, &didLinkingSucceed );
+				errorCode = glGetError();
+				if ( errorCode == GL_NO_ERROR )
+				{
+					if ( didLinkingSucceed == GL_FALSE )
+					{
+						EAE6320_ASSERTF( false, linkInfo.c_str() );
+						Logging::OutputError( "The program failed to link: %s",
+							linkInfo.c_str() );
+						return false;
+					}
+				}
+				else
+				{
+					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					Logging::OutputError( "OpenGL failed to find out if linking of the program succeeded: %s",
+						reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					return false;
+				}
+			}
+		}
+		else
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to link the program: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool eae6320::Graphics::Material::CleanUpEffect( sEffect& io_effect )
+{
+	bool wereThereErrors = false;
+
+	if ( io_effect.programId != 0 )
+	{
+		glDeleteProgram( io_effect.programId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete the program: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		io_effect.programId = 0;
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::Material::CreateParameterBuffer( const MaterialFormats::sParameterBlock& i_parameterBlock, sParameterBuffer& o_parameterBuffer )
+{
+	// Create a uniform buffer object and make it active
+	{
+		const GLsizei bufferCount = 1;
+		glGenBuffers( bufferCount, &o_parameterBuffer.constantBufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			glBindBuffer( GL_UNIFORM_BUFFER, o_parameterBuffer.constantBufferId );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to bind the new uniform buffer %u: %s",
+					o_parameterBuffer.constantBufferId, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				return false;
+			}
+		}
+		else
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused uniform buffer ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			return false;
+		}
+	}
+	// Allocate space and copy the constant data into the uniform buffer
+	{
+		const GLenum usage = GL_STATIC_DRAW;	// A material's constants never change after it's been loaded
+		glBufferData( GL_UNIFORM_BUFFER, sizeof( i_parameterBlock ), reinterpret_cast<const GLvoid*>( &i_parameterBlock ), usage );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to allocate the material uniform buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool eae6320::Graphics::Material::CleanUpParameterBuffer( sParameterBuffer& io_parameterBuffer )
+{
+	bool wereThereErrors = false;
+
+	if ( io_parameterBuffer.constantBufferId != 0 )
+	{
+		const GLsizei bufferCount = 1;
+		glDeleteBuffers( bufferCount, &io_parameterBuffer.constantBufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete the material uniform buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		io_parameterBuffer.constantBufferId = 0;
+	}
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::Material::sEffect::sEffect()
+	:
+	programId( 0 ), renderStates( 0 ), vertexShaderLibrary( NULL ), fragmentShaderLibrary( NULL ),
+	hash( MaterialFormats::s_emptyHash ), referenceCount( 0 )
+{
+
+}
+
+eae6320::Graphics::Material::sParameterBuffer::sParameterBuffer()
+	:
+	constantBufferId( 0 ), hash( MaterialFormats::s_emptyHash ), referenceCount( 0 )
+{
+
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool LoadShader( const GLuint i_programId, const void* const i_sourceCode, const size_t i_sourceCodeSize,
+		const GLenum i_shaderType, const char* const i_path )
+	{
+		// Verify that compiling shaders at run-time is supported
+		{
+			GLboolean isShaderCompilingSupported;
+			glGetBooleanv( GL_SHADER_COMPILER, &isShaderCompilingSupported );
+			if ( !isShaderCompilingSupported )
+			{
+				//eae6320::UserOutput::Print( "Compiling shaders at run-time isn't supported on this implementation (this should never happen)" );
+				return false;
+			}
+		}
+
+		bool wereThereErrors = false;
+
+		// Set the source code into a shader
+		GLuint shaderId = 0;
+		{
+			// Generate a shader
+			shaderId = glCreateShader( i_shaderType );
+			{
+				const GLenum errorCode = glGetError();
+				if ( errorCode != GL_NO_ERROR )
+				{
+					wereThereErrors = true;
+					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					eae6320::Logging::OutputError( "OpenGL failed to get an unused shader ID: %s",
+						reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					goto OnExit;
+				}
+				else if ( shaderId == 0 )
+				{
+					wereThereErrors = true;
+					EAE6320_ASSERT( false );
+					eae6320::Logging::OutputError( "OpenGL failed to get an unused shader ID" );
+					goto OnExit;
+				}
+			}
+			// Set the source code into the shader
+			{
+				const GLsizei shaderSourceCount = 1;
+				const GLchar* const sourceCode = reinterpret_cast<const GLchar*>( i_sourceCode );
+				const GLint length = static_cast<GLint>( i_sourceCodeSize );
+				glShaderSource( shaderId, shaderSourceCount, &sourceCode, &length );
+				const GLenum errorCode = glGetError();
+				if ( errorCode != GL_NO_ERROR )
+				{
+					wereThereErrors = true;
+					EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					eae6320::Logging::OutputError( "OpenGL failed to set the shader %s source code: %s",
+						i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+					goto OnExit;
+				}
+			}
+		}
+		// Compile the shader source code
+		{
+			glCompileShader( shaderId );
+			GLenum errorCode = glGetError();
+			if ( errorCode == GL_NO_ERROR )
+			{
+				// Get compilation info
+				// (this won't be used unless compilation fails
+				// but it can be useful to look at when debugging)
+				std::string compilationInfo;
+				{
+					GLint infoSize;
+					glGetShaderiv( shaderId, GL_INFO_LOG_LENGTH, &infoSize );
+					errorCode = glGetError();
+					if ( errorCode == GL_NO_ERROR )
+					{
+						sLogInfo info( static_cast<size_t>( infoSize ) );
+						GLsizei* dontReturnLength = NULL;
+						glGetShaderInfoLog( shaderId, static_cast<GLsizei>( infoSize ), dontReturnLength, info.memory );
+						errorCode = glGetError();
+						if ( errorCode == GL_NO_ERROR )
+						{
+							compilationInfo = info.memory;
+						}
+						else
+						{
+							wereThereErrors = true;
+							EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+							eae6320::Logging::OutputError( "OpenGL failed to get compilation info about the shader %s source code: %s",
+								i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+							goto OnExit;
+						}
+					}
+					else
+					{
+						wereThereErrors = true;
+						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+						eae6320::Logging::OutputError( "OpenGL failed to get the length of the shader %s compilation info: %s",
+							i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+						goto OnExit;
+					}
+				}
+				// Check to see if there were compilation errors
+				GLint didCompilationSucceed;
+				{
+					glGetShaderiv( shaderId, GL_COMPILE_STATUS, &didCompilationSucceed );
+					errorCode = glGetError();
+					if ( errorCode == GL_NO_ERROR )
+					{
+						if ( didCompilationSucceed == GL_FALSE )
+						{
+							wereThereErrors = true;
+							EAE6320_ASSERTF( false, compilationInfo.c_str() );
+							eae6320::Logging::OutputError( "OpenGL failed to compile the shader %s: %s",
+								i_path, compilationInfo.c_str() );
+							goto OnExit;
+						}
+					}
+					else
+					{
+						wereThereErrors = true;
+						EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+						eae6320::Logging::OutputError( "OpenGL failed to find if compilation of the shader %s source code succeeded: %s",
+							i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+						goto OnExit;
+					}
+				}
+			}
+			else
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				eae6320::Logging::OutputError( "OpenGL failed to compile the shader %s source code: %s",
+					i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		// Attach the shader to the program
+		{
+			glAttachShader( i_programId, shaderId );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				eae6320::Logging::OutputError( "OpenGL failed to attach the shader %s to the program: %s",
+					i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+
+	OnExit:
+
+		if ( shaderId != 0 )
+		{
+			// Even if the shader was successfully compiled
+			// once it has been attached to the program we can (and should) delete our reference to it
+			// (any associated memory that OpenGL has allocated internally will be freed
+			// once the program is deleted)
+			glDeleteShader( shaderId );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				eae6320::Logging::OutputError( "OpenGL failed to delete the shader ID %u: %s",
+					shaderId, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			}
+			shaderId = 0;
+		}
+
+		return !wereThereErrors;
+	}
+}
@@ -1,5 +1,9 @@
 #include "../Mesh.h"
 #include "../Includes.h"
+#include "../FrameFences.h"
+#include "../Statistics.h"
+#include "../UploadManager.h"
+#include "DebugOutput.h"
 #include "../../Asserts/Asserts.h"
 #include "../../Logging/Logging.h"
 
@@ -10,7 +14,6 @@ namespace eae6320
 		bool Mesh::Initialize()
 		{
 			bool wereThereErrors = false;
-			GLuint vertexBufferId = 0;
 
 			// Create a vertex array object and make it active
 			{
@@ -43,11 +46,11 @@ namespace eae6320
 			// Create a vertex buffer object and make it active
 			{
 				const GLsizei bufferCount = 1;
-				glGenBuffers(bufferCount, &vertexBufferId);
+				glGenBuffers(bufferCount, &m_vertexBufferId);
 				const GLenum errorCode = glGetError();
 				if (errorCode == GL_NO_ERROR)
 				{
-					glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
+					glBindBuffer(GL_ARRAY_BUFFER, m_vertexBufferId);
 					const GLenum errorCode = glGetError();
 					if (errorCode != GL_NO_ERROR)
 					{
@@ -77,7 +80,12 @@ namespace eae6320
 				const unsigned int vertexCountPerTriangle = 3;
 				const unsigned int vertexCount = triangleCount * vertexCountPerTriangle;
 				const unsigned int bufferSize = vertexCount * sizeof(sVertex);
-				sVertex vertexData[vertexCount];
+				// The vertices are written straight into staging memory and copied into the buffer when the frame is flushed
+				// (if there isn't room they are given to the driver when the buffer is allocated instead)
+				sVertex unstagedVertexData[vertexCount];
+				UploadManager::sAllocation stagingMemory;
+				const bool isStaged = UploadManager::Allocate(bufferSize, stagingMemory);
+				sVertex* const vertexData = isStaged ? reinterpret_cast<sVertex*>(stagingMemory.data) : unstagedVertexData;
 				// Fill in the data for the triangle
 				{
 					vertexData[0].x = 0.0f;
@@ -98,7 +106,7 @@ namespace eae6320
 					vertexData[5].x = 0.0f;
 					vertexData[5].y = 1.0f;
 				}
-				glBufferData(GL_ARRAY_BUFFER, bufferSize, reinterpret_cast<GLvoid*>(vertexData),
+				glBufferData(GL_ARRAY_BUFFER, bufferSize, isStaged ? NULL : reinterpret_cast<GLvoid*>(vertexData),
 					// In our class we won't ever read from the buffer
 					GL_STATIC_DRAW);
 				const GLenum errorCode = glGetError();
@@ -110,6 +118,13 @@ namespace eae6320
 						reinterpret_cast<const char*>(gluErrorString(errorCode)));
 					goto OnExit;
 				}
+				if (isStaged)
+				{
+					UploadManager::CopyToBuffer(stagingMemory, m_vertexBufferId);
+				}
+				m_vertexBufferSize = bufferSize;
+				EAE6320_GRAPHICS_STATISTICS(CountAllocation(Statistics::eResourceType::VertexBuffer, m_vertexBufferSize));
+				EAE6320_GRAPHICS_STATISTICS(CountUpload(m_vertexBufferSize));
 			}
 			// Initialize the vertex format
 		{
@@ -155,44 +170,16 @@ namespace eae6320
 			if (m_vertexArrayId != 0)
 			{
 				// Unbind the vertex array
-				// (this must be done before deleting the vertex buffer)
+				// (the vertex buffer isn't deleted yet even though the vertex array holds a reference to it
+				// because the upload manager copies the vertices into it by its ID)
 				glBindVertexArray(0);
 				const GLenum errorCode = glGetError();
-				if (errorCode == GL_NO_ERROR)
-				{
-					// The vertex and index buffer objects can be freed
-					// (the vertex array object will still hold references to them,
-					// and so they won't actually goes away until it gets freed).
-					// Unfortunately debuggers don't work well when these are freed
-					// (gDEBugger just doesn't show anything and RenderDoc crashes),
-					// and so don't free them if debug info is enabled.
-					if (vertexBufferId != 0)
-					{
-#ifndef EAE6320_GRAPHICS_ISDEVICEDEBUGINFOENABLED
-						const GLsizei bufferCount = 1;
-						glDeleteBuffers(bufferCount, &vertexBufferId);
-						const GLenum errorCode = glGetError();
-						if (errorCode != GL_NO_ERROR)
-						{
-							wereThereErrors = true;
-							EAE6320_ASSERTF(false, reinterpret_cast<const char*>(gluErrorString(errorCode)));
-							eae6320::Logging::OutputError("OpenGL failed to vertex buffer: %s",
-								reinterpret_cast<const char*>(gluErrorString(errorCode)));
-							goto OnExit;
-						}
-						vertexBufferId = 0;
-#else
-						m_vertexBufferId = vertexBufferId;
-#endif
-					}
-				}
-				else
+				if (errorCode != GL_NO_ERROR)
 				{
 					wereThereErrors = true;
 					EAE6320_ASSERTF(false, reinterpret_cast<const char*>(gluErrorString(errorCode)));
 					eae6320::Logging::OutputError("OpenGL failed to unbind the vertex array: %s",
 						reinterpret_cast<const char*>(gluErrorString(errorCode)));
-					goto OnExit;
 				}
 			}
 			return !wereThereErrors;
@@ -200,39 +187,19 @@ namespace eae6320
 
 		bool Mesh::CleanUp()
 		{
-
-			bool wereThereErrors = false;
-#ifdef EAE6320_GRAPHICS_ISDEVICEDEBUGINFOENABLED
-			if (m_vertexBufferId != 0)
+			// A frame that the GPU hasn't finished yet might still draw the mesh,
+			// and so its objects are deleted once the current frame has retired
+			// (which is also after its vertices have been copied from staging memory)
+			FrameFences::DeferDelete(FrameFences::eResourceType::Buffer, m_vertexBufferId);
+			m_vertexBufferId = 0;
+			FrameFences::DeferDelete(FrameFences::eResourceType::VertexArray, m_vertexArrayId);
+			m_vertexArrayId = 0;
+			if (m_vertexBufferSize != 0)
 			{
-				const GLsizei bufferCount = 1;
-				glDeleteBuffers(bufferCount, &m_vertexBufferId);
-				const GLenum errorCode = glGetError();
-				if (errorCode != GL_NO_ERROR)
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF(false, reinterpret_cast<const char*>(gluErrorString(errorCode)));
-					Logging::OutputError("OpenGL failed to delete the vertex buffer: %s",
-						reinterpret_cast<const char*>(gluErrorString(errorCode)));
-				}
-				m_vertexBufferId = 0;
-			}
-#endif
-			if (m_vertexArrayId != 0)
-			{
-				const GLsizei arrayCount = 1;
-				glDeleteVertexArrays(arrayCount, &m_vertexArrayId);
-				const GLenum errorCode = glGetError();
-				if (errorCode != GL_NO_ERROR)
-				{
-					wereThereErrors = true;
-					EAE6320_ASSERTF(false, reinterpret_cast<const char*>(gluErrorString(errorCode)));
-					Logging::OutputError("OpenGL failed to delete the vertex array: %s",
-						reinterpret_cast<const char*>(gluErrorString(errorCode)));
-				}
-				m_vertexArrayId = 0;
+				EAE6320_GRAPHICS_STATISTICS(CountFree(Statistics::eResourceType::VertexBuffer, m_vertexBufferSize));
+				m_vertexBufferSize = 0;
 			}
-			return !wereThereErrors;
+			return true;
 		}
 
 		bool Mesh::Draw()
@@ -240,7 +207,8 @@ namespace eae6320
 			// Bind a specific vertex buffer to the device as a data source
 			{
 				glBindVertexArray(m_vertexArrayId);
-				EAE6320_ASSERT(glGetError() == GL_NO_ERROR);
+				EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+				EAE6320_GRAPHICS_STATISTICS(CountBufferBinds(1));
 			}
 
 			// Render triangles from the currently-bound vertex buffer
@@ -257,7 +225,8 @@ namespace eae6320
 				const unsigned int vertexCountPerTriangle = 3;
 				const unsigned int vertexCountToRender = triangleCount * vertexCountPerTriangle;
 				glDrawArrays(mode, indexOfFirstVertexToRender, vertexCountToRender);
-				EAE6320_ASSERT(glGetError() == GL_NO_ERROR);
+				EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+				EAE6320_GRAPHICS_STATISTICS(CountDraw(triangleCount));
 			}
 
 			return true;
@@ -0,0 +1,184 @@
+// Header Files
+//=============
+
+#include "../RenderGraph.h"
+
+#include "DebugOutput.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Interface
+//==========
+
+// Execute
+//--------
+
+void eae6320::Graphics::RenderGraph::BindTexture( const unsigned int i_resourceIndex, const unsigned int i_textureUnit ) const
+{
+	EAE6320_ASSERT( ( i_resourceIndex < m_resources.size() ) && ( m_resources[i_resourceIndex].physicalTargetIndex != s_invalidIndex ) );
+	glActiveTexture( GL_TEXTURE0 + i_textureUnit );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	glBindTexture( GL_TEXTURE_2D, m_physicalTargets[m_resources[i_resourceIndex].physicalTargetIndex].textureId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::RenderGraph::CreatePhysicalTarget( sPhysicalTarget& io_target )
+{
+	bool wereThereErrors = false;
+	io_target.textureId = 0;
+	io_target.framebufferId = 0;
+
+	// Create the texture
+	{
+		const GLsizei textureCount = 1;
+		glGenTextures( textureCount, &io_target.textureId );
+		GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused texture ID for a render target: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+		// The texture is counted as soon as it exists because that is when DestroyPhysicalTarget() will free it
+		// (if allocating its storage fails the texture is deleted immediately)
+		EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::Texture, CalculateMemorySize( io_target.description ) ) );
+		glBindTexture( GL_TEXTURE_2D, io_target.textureId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		{
+			const GLint mipLevel = 0;
+			const bool isFloat = io_target.description.format == eTargetFormat::R16G16B16A16_FLOAT;
+			const GLint internalFormat = isFloat ? GL_RGBA16F : GL_RGBA8;
+			const GLint borderWidth = 0;
+			const GLenum type = isFloat ? GL_HALF_FLOAT : GL_UNSIGNED_BYTE;
+			const GLvoid* const noInitialData = NULL;
+			glTexImage2D( GL_TEXTURE_2D, mipLevel, internalFormat, io_target.description.width, io_target.description.height,
+				borderWidth, GL_RGBA, type, noInitialData );
+			errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to allocate a %ux%u render target texture: %s",
+					io_target.description.width, io_target.description.height, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		// A render target only has one mip
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+	// Create a framebuffer that renders to the texture
+	{
+		const GLsizei framebufferCount = 1;
+		glGenFramebuffers( framebufferCount, &io_target.framebufferId );
+		GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused framebuffer ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+		glBindFramebuffer( GL_FRAMEBUFFER, io_target.framebufferId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		const GLint mipLevel = 0;
+		glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, io_target.textureId, mipLevel );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		const GLenum status = glCheckFramebufferStatus( GL_FRAMEBUFFER );
+		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+		if ( status != GL_FRAMEBUFFER_COMPLETE )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERT( false );
+			Logging::OutputError( "OpenGL couldn't render to a %ux%u render target (the framebuffer status is %#06x)",
+				io_target.description.width, io_target.description.height, status );
+			goto OnExit;
+		}
+	}
+
+OnExit:
+
+	if ( wereThereErrors )
+	{
+		DestroyPhysicalTarget( io_target );
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::RenderGraph::DestroyPhysicalTarget( sPhysicalTarget& io_target )
+{
+	bool wereThereErrors = false;
+
+	if ( io_target.framebufferId != 0 )
+	{
+		const GLsizei framebufferCount = 1;
+		glDeleteFramebuffers( framebufferCount, &io_target.framebufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete a render target's framebuffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		io_target.framebufferId = 0;
+	}
+	if ( io_target.textureId != 0 )
+	{
+		const GLsizei textureCount = 1;
+		glDeleteTextures( textureCount, &io_target.textureId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete a render target's texture: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		io_target.textureId = 0;
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::Texture, CalculateMemorySize( io_target.description ) ) );
+	}
+
+	return !wereThereErrors;
+}
+
+void eae6320::Graphics::RenderGraph::BindTargets( const sPass& i_pass ) const
+{
+	if ( i_pass.writes.empty() )
+	{
+		return;
+	}
+
+	// A framebuffer object only has a single color attachment,
+	// and so a pass can either write the back buffer (framebuffer 0) or a single transient target
+	EAE6320_ASSERTF( i_pass.writes.size() == 1, "A pass can only write a single target on OpenGL" );
+	const sWrite& write = i_pass.writes.front();
+	const sResource& resource = m_resources[write.resourceIndex];
+	glBindFramebuffer( GL_FRAMEBUFFER, resource.isImported ? 0 : m_physicalTargets[resource.physicalTargetIndex].framebufferId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	{
+		uint16_t width, height;
+		GetViewportSize( i_pass, width, height );
+		glViewport( 0, 0, width, height );
+	}
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	if ( write.shouldBeCleared )
+	{
+		glClearColor( write.clearColor[0], write.clearColor[1], write.clearColor[2], write.clearColor[3] );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		const GLbitfield clearColor = GL_COLOR_BUFFER_BIT;
+		glClear( clearColor );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+}
@@ -0,0 +1,198 @@
+// Header Files
+//=============
+
+#include "../SkinnedMesh.h"
+
+#include <cstddef>
+#include "DebugOutput.h"
+#include "../Includes.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::SkinnedMesh::CreateVertexBuffer()
+{
+	bool wereThereErrors = false;
+
+	// Create a vertex array object and make it active
+	{
+		const GLsizei arrayCount = 1;
+		glGenVertexArrays( arrayCount, &m_vertexArrayId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			glBindVertexArray( m_vertexArrayId );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to bind the skinned vertex array: %s",
+					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused skinned vertex array ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// Create a vertex buffer object and make it active
+	{
+		const GLsizei bufferCount = 1;
+		glGenBuffers( bufferCount, &m_vertexBufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			glBindBuffer( GL_ARRAY_BUFFER, m_vertexBufferId );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to bind the skinned vertex buffer: %s",
+					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused skinned vertex buffer ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// Allocate space for every vertex
+	// (the contents are written every frame)
+	{
+		const GLsizeiptr bufferSize = static_cast<GLsizeiptr>( m_vertices.GetVertexCount() * sizeof( sVertex ) );
+		glBufferData( GL_ARRAY_BUFFER, bufferSize, NULL, GL_STREAM_DRAW );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to allocate the skinned vertex buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// Initialize the vertex format
+	{
+		const GLsizei stride = sizeof( sVertex );
+
+		// Position (0)
+		// 2 floats == 8 bytes
+		// Offset = 0
+		// (the skinned z is dropped)
+		{
+			const GLuint vertexElementLocation = 0;
+			const GLint elementCount = 2;
+			const GLboolean notNormalized = GL_FALSE;
+			glVertexAttribPointer( vertexElementLocation, elementCount, GL_FLOAT, notNormalized, stride,
+				reinterpret_cast<GLvoid*>( offsetof( sVertex, x ) ) );
+			glEnableVertexAttribArray( vertexElementLocation );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to set the skinned vertex POSITION vertex attribute at location %u: %s",
+					vertexElementLocation, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+	}
+
+OnExit:
+
+	if ( m_vertexArrayId != 0 )
+	{
+		glBindVertexArray( 0 );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::SkinnedMesh::DestroyVertexBuffer()
+{
+	bool wereThereErrors = false;
+
+	// Unlike a Mesh the vertex buffer ID is always kept
+	// because it must be mapped every frame
+	if ( m_vertexBufferId != 0 )
+	{
+		const GLsizei bufferCount = 1;
+		glDeleteBuffers( bufferCount, &m_vertexBufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete the skinned vertex buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		m_vertexBufferId = 0;
+	}
+	if ( m_vertexArrayId != 0 )
+	{
+		const GLsizei arrayCount = 1;
+		glDeleteVertexArrays( arrayCount, &m_vertexArrayId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete the skinned vertex array: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		m_vertexArrayId = 0;
+	}
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::sVertex* eae6320::Graphics::SkinnedMesh::MapVertexBuffer()
+{
+	glBindBuffer( GL_ARRAY_BUFFER, m_vertexBufferId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+	// Invalidating the buffer lets the driver hand back fresh memory
+	// instead of waiting for the GPU to finish drawing last frame's pose
+	const GLintptr offset = 0;
+	const GLsizeiptr length = static_cast<GLsizeiptr>( m_vertices.GetVertexCount() * sizeof( sVertex ) );
+	const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+	void* const memory = glMapBufferRange( GL_ARRAY_BUFFER, offset, length, access );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	return reinterpret_cast<sVertex*>( memory );
+}
+
+void eae6320::Graphics::SkinnedMesh::UnmapVertexBuffer()
+{
+	const GLboolean result = glUnmapBuffer( GL_ARRAY_BUFFER );
+	EAE6320_ASSERT( result != GL_FALSE );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
+
+void eae6320::Graphics::SkinnedMesh::DrawVertexBuffer()
+{
+	glBindVertexArray( m_vertexArrayId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+	// The vertices are a list of triangles
+	const GLint indexOfFirstVertexToRender = 0;
+	const GLsizei vertexCountToRender = static_cast<GLsizei>( m_vertices.GetVertexCount() );
+	glDrawArrays( GL_TRIANGLES, indexOfFirstVertexToRender, vertexCountToRender );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	EAE6320_GRAPHICS_STATISTICS( CountDraw( vertexCountToRender / 3 ) );
+}
@@ -0,0 +1,150 @@
+// Header Files
+//=============
+
+#include "../Terrain.h"
+
+#include <cstddef>
+#include "DebugOutput.h"
+#include "../FrameFences.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::Terrain::CreateIndexBuffer( const std::vector<uint16_t>& i_indices )
+{
+	{
+		const GLsizei bufferCount = 1;
+		glGenBuffers( bufferCount, &m_indexBufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused terrain index buffer ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			m_indexBufferId = 0;
+			return false;
+		}
+	}
+	// The index buffer never changes
+	// (it is bound to every tile's vertex array, and so it doesn't need to be bound again when drawing)
+	{
+		const GLsizeiptr bufferSize = static_cast<GLsizeiptr>( i_indices.size() * sizeof( uint16_t ) );
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indexBufferId );
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, bufferSize, &i_indices[0], GL_STATIC_DRAW );
+		const GLenum errorCode = glGetError();
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+		if ( errorCode != GL_NO_ERROR )
+		{
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to allocate the terrain index buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			const GLsizei bufferCount = 1;
+			glDeleteBuffers( bufferCount, &m_indexBufferId );
+			m_indexBufferId = 0;
+			return false;
+		}
+		EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::IndexBuffer, static_cast<size_t>( bufferSize ) ) );
+		EAE6320_GRAPHICS_STATISTICS( CountUpload( static_cast<size_t>( bufferSize ) ) );
+	}
+	return true;
+}
+
+void eae6320::Graphics::Terrain::DestroyIndexBuffer()
+{
+	if ( m_indexBufferId != 0 )
+	{
+		// A frame that the GPU hasn't finished yet might still draw the terrain,
+		// and so the buffer is deleted once the current frame has retired
+		FrameFences::DeferDelete( FrameFences::eResourceType::Buffer, m_indexBufferId );
+		m_indexBufferId = 0;
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::IndexBuffer, m_indexBufferSize ) );
+	}
+}
+
+bool eae6320::Graphics::Terrain::CreateVertexBuffer( sTile& io_tile, const sTerrainVertex* const i_vertices )
+{
+	// This is called every time a tile is streamed in,
+	// and so errors are only asserted (and reported by the debug output) rather than checked
+
+	// Create a vertex array object and make it active
+	{
+		const GLsizei arrayCount = 1;
+		glGenVertexArrays( arrayCount, &io_tile.vertexArrayId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		glBindVertexArray( io_tile.vertexArrayId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+	// Create the vertex buffer object
+	// (a tile's vertices never change while it is resident)
+	{
+		const GLsizei bufferCount = 1;
+		glGenBuffers( bufferCount, &io_tile.vertexBufferId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		glBindBuffer( GL_ARRAY_BUFFER, io_tile.vertexBufferId );
+		glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( m_vertexBufferSize ), i_vertices, GL_STATIC_DRAW );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+		EAE6320_GRAPHICS_STATISTICS( CountUpload( m_vertexBufferSize ) );
+	}
+	// Every tile's vertex array uses the same index buffer
+	{
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indexBufferId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+	// Initialize the vertex format
+	{
+		// Position (0)
+		// 3 floats == 12 bytes
+		// Offset = 0
+		const GLsizei stride = sizeof( sTerrainVertex );
+		const GLuint vertexElementLocation = 0;
+		const GLint elementCount = 3;
+		const GLboolean notNormalized = GL_FALSE;
+		glVertexAttribPointer( vertexElementLocation, elementCount, GL_FLOAT, notNormalized, stride,
+			reinterpret_cast<GLvoid*>( offsetof( sTerrainVertex, x ) ) );
+		glEnableVertexAttribArray( vertexElementLocation );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+
+	glBindVertexArray( 0 );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+
+	return true;
+}
+
+void eae6320::Graphics::Terrain::DestroyVertexBuffer( sTile& io_tile )
+{
+	// An evicted tile might have been drawn during a frame that the GPU hasn't finished yet,
+	// and so its objects are deleted once the current frame has retired
+	FrameFences::DeferDelete( FrameFences::eResourceType::VertexArray, io_tile.vertexArrayId );
+	io_tile.vertexArrayId = 0;
+	if ( io_tile.vertexBufferId != 0 )
+	{
+		FrameFences::DeferDelete( FrameFences::eResourceType::Buffer, io_tile.vertexBufferId );
+		io_tile.vertexBufferId = 0;
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+	}
+}
+
+void eae6320::Graphics::Terrain::DrawTiles()
+{
+	for ( std::vector<uint32_t>::const_iterator i = m_drawnTiles.begin(); i != m_drawnTiles.end(); ++i )
+	{
+		const sTile& tile = m_tiles[*i];
+		glBindVertexArray( tile.vertexArrayId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+		const MeshClusters::sIndexRange& indexRange = GetIndexRange( tile.lod, tile.stitchedEdges );
+		const GLvoid* const offset = reinterpret_cast<const GLvoid*>( indexRange.firstIndex * sizeof( uint16_t ) );
+		glDrawElements( GL_TRIANGLES, static_cast<GLsizei>( indexRange.indexCount ), GL_UNSIGNED_SHORT, offset );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		EAE6320_GRAPHICS_STATISTICS( CountDraw( indexRange.indexCount / 3 ) );
+	}
+	glBindVertexArray( 0 );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
@@ -0,0 +1,259 @@
+// Header Files
+//=============
+
+#include "../TextBatch.h"
+
+#include <cstddef>
+#include "DebugOutput.h"
+#include "../Statistics.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::TextBatch::CreateBuffers()
+{
+	bool wereThereErrors = false;
+
+	// Create a vertex array object and make it active
+	{
+		const GLsizei arrayCount = 1;
+		glGenVertexArrays( arrayCount, &m_vertexArrayId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			glBindVertexArray( m_vertexArrayId );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to bind the text vertex array: %s",
+					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused text vertex array ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// Create the vertex and index buffer objects
+	{
+		GLuint bufferIds[2];
+		const GLsizei bufferCount = 2;
+		glGenBuffers( bufferCount, bufferIds );
+		const GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			m_vertexBufferId = bufferIds[0];
+			m_indexBufferId = bufferIds[1];
+		}
+		else
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get unused text buffer IDs: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// Allocate space for every glyph's vertices
+	// (the contents are written every frame)
+	{
+		glBindBuffer( GL_ARRAY_BUFFER, m_vertexBufferId );
+		const GLsizeiptr bufferSize = static_cast<GLsizeiptr>( m_maxGlyphCount * 4 * sizeof( sTextVertex ) );
+		glBufferData( GL_ARRAY_BUFFER, bufferSize, NULL, GL_STREAM_DRAW );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to allocate the text vertex buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// The index buffer never changes
+	// (it is bound to the vertex array, and so it doesn't need to be bound again when drawing)
+	{
+		std::vector<uint32_t> indices;
+		GenerateIndices( m_maxGlyphCount, indices );
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_indexBufferId );
+		const GLsizeiptr bufferSize = static_cast<GLsizeiptr>( indices.size() * sizeof( uint32_t ) );
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, bufferSize, &indices[0], GL_STATIC_DRAW );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to allocate the text index buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// Initialize the vertex format
+	{
+		const GLsizei stride = sizeof( sTextVertex );
+
+		// Position (0)
+		// 2 floats == 8 bytes
+		// Offset = 0
+		{
+			const GLuint vertexElementLocation = 0;
+			const GLint elementCount = 2;
+			const GLboolean notNormalized = GL_FALSE;
+			glVertexAttribPointer( vertexElementLocation, elementCount, GL_FLOAT, notNormalized, stride,
+				reinterpret_cast<GLvoid*>( offsetof( sTextVertex, x ) ) );
+			glEnableVertexAttribArray( vertexElementLocation );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to set the text POSITION vertex attribute at location %u: %s",
+					vertexElementLocation, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		// Texture Coordinates (1)
+		// 2 floats == 8 bytes
+		// Offset = 8
+		{
+			const GLuint vertexElementLocation = 1;
+			const GLint elementCount = 2;
+			const GLboolean notNormalized = GL_FALSE;
+			glVertexAttribPointer( vertexElementLocation, elementCount, GL_FLOAT, notNormalized, stride,
+				reinterpret_cast<GLvoid*>( offsetof( sTextVertex, u ) ) );
+			glEnableVertexAttribArray( vertexElementLocation );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to set the text TEXCOORD vertex attribute at location %u: %s",
+					vertexElementLocation, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		// Color (2)
+		// 4 uint8_ts == 4 bytes
+		// Offset = 16
+		{
+			const GLuint vertexElementLocation = 2;
+			const GLint elementCount = 4;
+			const GLboolean normalized = GL_TRUE;	// The [0,255] values become [0,1] floats in the shader
+			glVertexAttribPointer( vertexElementLocation, elementCount, GL_UNSIGNED_BYTE, normalized, stride,
+				reinterpret_cast<GLvoid*>( offsetof( sTextVertex, r ) ) );
+			glEnableVertexAttribArray( vertexElementLocation );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to set the text COLOR vertex attribute at location %u: %s",
+					vertexElementLocation, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+	}
+
+OnExit:
+
+	if ( m_vertexArrayId != 0 )
+	{
+		glBindVertexArray( 0 );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::TextBatch::DestroyBuffers()
+{
+	bool wereThereErrors = false;
+
+	if ( m_vertexBufferId != 0 )
+	{
+		const GLsizei bufferCount = 1;
+		glDeleteBuffers( bufferCount, &m_vertexBufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete the text vertex buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		m_vertexBufferId = 0;
+	}
+	if ( m_indexBufferId != 0 )
+	{
+		const GLsizei bufferCount = 1;
+		glDeleteBuffers( bufferCount, &m_indexBufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete the text index buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		m_indexBufferId = 0;
+	}
+	if ( m_vertexArrayId != 0 )
+	{
+		const GLsizei arrayCount = 1;
+		glDeleteVertexArrays( arrayCount, &m_vertexArrayId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to delete the text vertex array: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+		}
+		m_vertexArrayId = 0;
+	}
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::sTextVertex* eae6320::Graphics::TextBatch::MapVertexBuffer()
+{
+	glBindBuffer( GL_ARRAY_BUFFER, m_vertexBufferId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+	// Invalidating the buffer lets the driver hand back fresh memory
+	// instead of waiting for the GPU to finish drawing last frame's text
+	const GLintptr offset = 0;
+	const GLsizeiptr length = static_cast<GLsizeiptr>( m_glyphCount * 4 * sizeof( sTextVertex ) );
+	const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+	void* const memory = glMapBufferRange( GL_ARRAY_BUFFER, offset, length, access );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	return reinterpret_cast<sTextVertex*>( memory );
+}
+
+void eae6320::Graphics::TextBatch::UnmapVertexBuffer()
+{
+	const GLboolean result = glUnmapBuffer( GL_ARRAY_BUFFER );
+	EAE6320_ASSERT( result != GL_FALSE );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
+
+void eae6320::Graphics::TextBatch::DrawBuffers()
+{
+	glBindVertexArray( m_vertexArrayId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	EAE6320_GRAPHICS_STATISTICS( CountBufferBinds( 1 ) );
+	// Every glyph is two triangles
+	const GLvoid* const offset = 0;
+	glDrawElements( GL_TRIANGLES, static_cast<GLsizei>( m_glyphCount * 6 ), GL_UNSIGNED_INT, offset );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	EAE6320_GRAPHICS_STATISTICS( CountDraw( m_glyphCount * 2 ) );
+}
@@ -0,0 +1,233 @@
+// Header Files
+//=============
+
+#include "../Texture.h"
+
+#include <cstring>
+#include "DebugOutput.h"
+#include "../AssetLoader.h"
+#include "../FrameFences.h"
+#include "../UploadManager.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	GLenum GetInternalFormat( const uint8_t i_format, const bool i_isSrgb );
+	// The texture must be bound,
+	// and the caller is responsible for checking errors
+	void UploadMip( const unsigned int i_mip, const uint8_t* const i_data, const uint8_t i_format, const uint8_t i_flags,
+		const eae6320::Graphics::TextureFormats::sMip& i_mipInfo );
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::Texture::Bind( const unsigned int i_textureUnit ) const
+{
+	glActiveTexture( GL_TEXTURE0 + i_textureUnit );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	// A texture that hasn't finished loading uses the placeholder instead
+	const GLuint textureId = ( m_textureId != 0 ) ? m_textureId : AssetLoader::GetPlaceholderTexture().m_textureId;
+	glBindTexture( GL_TEXTURE_2D, textureId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
+
+// Access
+//-------
+
+bool eae6320::Graphics::Texture::IsLoaded() const
+{
+	return m_textureId != 0;
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::Texture::CreateGpuTexture( const uint8_t* const i_fileData, const char* const i_path )
+{
+	bool wereThereErrors = false;
+
+	// Create a texture object and make it active
+	{
+		const GLsizei textureCount = 1;
+		glGenTextures( textureCount, &m_textureId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			glBindTexture( GL_TEXTURE_2D, m_textureId );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to bind the texture %s: %s",
+					i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused texture ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// Every resident mip is read from the file straight into staging memory
+	// and is copied into the texture when the frame is flushed
+	// (if there isn't room it is uploaded straight from the file instead)
+	for ( unsigned int i = m_firstResidentMip; i < m_mipCount; ++i )
+	{
+		const uint8_t* const mipData = i_fileData + m_mips[i].offset;
+		UploadManager::sAllocation stagingMemory;
+		const bool isStaged = UploadManager::Allocate( m_mips[i].size, stagingMemory );
+		if ( isStaged )
+		{
+			memcpy( stagingMemory.data, mipData, m_mips[i].size );
+		}
+		// A staged mip only has its storage allocated until the copy is submitted
+		UploadMip( i, isStaged ? NULL : mipData, m_format, m_flags, m_mips[i] );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to upload mip %u of the texture %s: %s",
+				i, i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+		if ( isStaged )
+		{
+			const GLenum compressedFormat = TextureFormats::IsBlockCompressed( m_format )
+				? GetInternalFormat( m_format, ( m_flags & TextureFormats::eFlag::IsSrgb ) != 0 ) : GL_NONE;
+			UploadManager::CopyToTexture( stagingMemory, m_textureId, i, m_mips[i].width, m_mips[i].height, compressedFormat );
+		}
+	}
+	// Set the sampling state
+	{
+		// The GPU won't sample from mips that aren't resident
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, m_firstResidentMip );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_mipCount - 1 );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to set the sampling state of the texture %s: %s",
+				i_path, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+
+OnExit:
+
+	glBindTexture( GL_TEXTURE_2D, 0 );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+
+	if ( wereThereErrors )
+	{
+		DestroyGpuTexture();
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::Texture::ChangeFirstResidentMip( const unsigned int i_firstResidentMip, const uint8_t* const i_mipData )
+{
+	// This is called every time a mip is streamed in or out,
+	// and so errors are only asserted (and reported by the debug output) rather than checked
+	glBindTexture( GL_TEXTURE_2D, m_textureId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+
+	if ( i_firstResidentMip < m_firstResidentMip )
+	{
+		EAE6320_ASSERT( ( ( i_firstResidentMip + 1 ) == m_firstResidentMip ) && ( i_mipData != NULL ) );
+		UploadMip( i_firstResidentMip, i_mipData, m_format, m_flags, m_mips[i_firstResidentMip] );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+	else
+	{
+		// Giving a mip a size of zero frees its storage
+		// (the texture is still complete because the mip is outside of the base and max levels)
+		const bool isBlockCompressed = TextureFormats::IsBlockCompressed( m_format );
+		const GLenum internalFormat = GetInternalFormat( m_format, ( m_flags & TextureFormats::eFlag::IsSrgb ) != 0 );
+		const GLint noBorder = 0;
+		for ( unsigned int i = m_firstResidentMip; i < i_firstResidentMip; ++i )
+		{
+			if ( isBlockCompressed )
+			{
+				glCompressedTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( i ), internalFormat, 0, 0, noBorder, 0, NULL );
+			}
+			else
+			{
+				glTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( i ), internalFormat, 0, 0, noBorder, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+			}
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+	}
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>( i_firstResidentMip ) );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+
+	glBindTexture( GL_TEXTURE_2D, 0 );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+
+	return true;
+}
+
+bool eae6320::Graphics::Texture::DestroyGpuTexture()
+{
+	// The upload manager might still have mips to copy into the texture
+	FrameFences::DeferDelete( FrameFences::eResourceType::Texture, m_textureId );
+	m_textureId = 0;
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	GLenum GetInternalFormat( const uint8_t i_format, const bool i_isSrgb )
+	{
+		namespace eFormat = eae6320::Graphics::TextureFormats::eFormat;
+		switch ( i_format )
+		{
+		case eFormat::BC1: return i_isSrgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		case eFormat::BC3: return i_isSrgb ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		// There are no sRGB versions of the 1 and 2 channel formats
+		case eFormat::BC4: return GL_COMPRESSED_RED_RGTC1;
+		case eFormat::BC5: return GL_COMPRESSED_RG_RGTC2;
+		case eFormat::BC7: return i_isSrgb ? GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : GL_COMPRESSED_RGBA_BPTC_UNORM;
+		}
+		return i_isSrgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+	}
+
+	void UploadMip( const unsigned int i_mip, const uint8_t* const i_data, const uint8_t i_format, const uint8_t i_flags,
+		const eae6320::Graphics::TextureFormats::sMip& i_mipInfo )
+	{
+		namespace TextureFormats = eae6320::Graphics::TextureFormats;
+		const GLenum internalFormat = GetInternalFormat( i_format, ( i_flags & TextureFormats::eFlag::IsSrgb ) != 0 );
+		const GLint mipLevel = static_cast<GLint>( i_mip );
+		const GLint noBorder = 0;
+		if ( TextureFormats::IsBlockCompressed( i_format ) )
+		{
+			glCompressedTexImage2D( GL_TEXTURE_2D, mipLevel, internalFormat, i_mipInfo.width, i_mipInfo.height, noBorder,
+				static_cast<GLsizei>( i_mipInfo.size ), i_data );
+		}
+		else
+		{
+			glTexImage2D( GL_TEXTURE_2D, mipLevel, internalFormat, i_mipInfo.width, i_mipInfo.height, noBorder,
+				GL_RGBA, GL_UNSIGNED_BYTE, i_data );
+		}
+	}
+}
@@ -0,0 +1,314 @@
+// Header Files
+//=============
+
+#include "../UploadManager.h"
+
+#include <vector>
+#include "DebugOutput.h"
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	struct sBufferCopy
+	{
+		GLuint destinationId;
+		GLintptr destinationOffset;
+		GLintptr sourceOffset;
+		GLsizeiptr size;
+	};
+
+	struct sTextureCopy
+	{
+		GLuint textureId;
+		GLint mip;
+		GLsizei width, height;
+		// This is GL_NONE if the data is RGBA8
+		GLenum compressedFormat;
+		GLsizei size;
+		GLintptr sourceOffset;
+	};
+
+	// Every batch is a part of a single buffer
+	GLuint s_stagingBufferId = 0;
+	size_t s_batchByteCount = 0;
+	// If the driver supports ARB_buffer_storage the whole buffer stays mapped
+	uint8_t* s_persistentMemory = NULL;
+	// Copies can only be queued from the current batch
+	std::vector<sBufferCopy> s_bufferCopies;
+	std::vector<sTextureCopy> s_textureCopies;
+	unsigned int s_queuedBatchIndex = 0;
+}
+
+// Interface
+//==========
+
+// Staging
+//--------
+
+void eae6320::Graphics::UploadManager::CopyToBuffer( const sAllocation& i_source, const GLuint i_destinationId,
+	const size_t i_destinationOffset )
+{
+	EAE6320_ASSERT( i_destinationId != 0 );
+	EAE6320_ASSERTF( ( s_bufferCopies.empty() && s_textureCopies.empty() ) || ( i_source.batchIndex == s_queuedBatchIndex ),
+		"A copy was queued from staging memory that has already been submitted" );
+
+	sBufferCopy copy;
+	{
+		copy.destinationId = i_destinationId;
+		copy.destinationOffset = static_cast<GLintptr>( i_destinationOffset );
+		copy.sourceOffset = static_cast<GLintptr>( ( i_source.batchIndex * s_batchByteCount ) + i_source.offset );
+		copy.size = static_cast<GLsizeiptr>( i_source.size );
+	}
+	s_bufferCopies.push_back( copy );
+	s_queuedBatchIndex = i_source.batchIndex;
+}
+
+void eae6320::Graphics::UploadManager::CopyToTexture( const sAllocation& i_source, const GLuint i_textureId, const unsigned int i_mip,
+	const unsigned int i_width, const unsigned int i_height, const GLenum i_compressedFormat )
+{
+	EAE6320_ASSERT( i_textureId != 0 );
+	EAE6320_ASSERTF( ( s_bufferCopies.empty() && s_textureCopies.empty() ) || ( i_source.batchIndex == s_queuedBatchIndex ),
+		"A copy was queued from staging memory that has already been submitted" );
+
+	sTextureCopy copy;
+	{
+		copy.textureId = i_textureId;
+		copy.mip = static_cast<GLint>( i_mip );
+		copy.width = static_cast<GLsizei>( i_width );
+		copy.height = static_cast<GLsizei>( i_height );
+		copy.compressedFormat = i_compressedFormat;
+		copy.size = static_cast<GLsizei>( i_source.size );
+		copy.sourceOffset = static_cast<GLintptr>( ( i_source.batchIndex * s_batchByteCount ) + i_source.offset );
+	}
+	s_textureCopies.push_back( copy );
+	s_queuedBatchIndex = i_source.batchIndex;
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::UploadManager::CreateStagingBuffers( const size_t i_batchByteCount )
+{
+	bool wereThereErrors = false;
+
+	s_batchByteCount = i_batchByteCount;
+	const GLsizeiptr stagingByteCount = static_cast<GLsizeiptr>( i_batchByteCount * s_batchCount );
+	// Create a buffer object and make it active
+	{
+		const GLsizei bufferCount = 1;
+		glGenBuffers( bufferCount, &s_stagingBufferId );
+		const GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			glBindBuffer( GL_COPY_READ_BUFFER, s_stagingBufferId );
+			const GLenum errorCode = glGetError();
+			if ( errorCode != GL_NO_ERROR )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to bind the staging buffer: %s",
+					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				goto OnExit;
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to get an unused staging buffer ID: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	// Allocate the buffer's storage
+	if ( glBufferStorage )
+	{
+		// The buffer is mapped once and the GPU can copy from it while it is mapped
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		const GLvoid* const noInitialData = NULL;
+		glBufferStorage( GL_COPY_READ_BUFFER, stagingByteCount, noInitialData, flags );
+		const GLenum errorCode = glGetError();
+		if ( errorCode == GL_NO_ERROR )
+		{
+			const GLintptr offset = 0;
+			s_persistentMemory = reinterpret_cast<uint8_t*>( glMapBufferRange( GL_COPY_READ_BUFFER, offset, stagingByteCount, flags ) );
+			const GLenum errorCode = glGetError();
+			if ( ( errorCode != GL_NO_ERROR ) || !s_persistentMemory )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				Logging::OutputError( "OpenGL failed to persistently map the staging buffer: %s",
+					reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+				s_persistentMemory = NULL;
+				goto OnExit;
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to allocate the staging buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	else
+	{
+		// Each batch is mapped while it is being filled
+		const GLvoid* const noInitialData = NULL;
+		glBufferData( GL_COPY_READ_BUFFER, stagingByteCount, noInitialData, GL_STREAM_DRAW );
+		const GLenum errorCode = glGetError();
+		if ( errorCode != GL_NO_ERROR )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			Logging::OutputError( "OpenGL failed to allocate the staging buffer: %s",
+				reinterpret_cast<const char*>( gluErrorString( errorCode ) ) );
+			goto OnExit;
+		}
+	}
+	Logging::OutputMessage( s_persistentMemory ? "The staging buffer is persistently mapped"
+		: "ARB_buffer_storage isn't supported, and so each staging batch is mapped while it is being filled" );
+
+OnExit:
+
+	glBindBuffer( GL_COPY_READ_BUFFER, 0 );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+
+	if ( wereThereErrors )
+	{
+		DestroyStagingBuffers();
+	}
+
+	return !wereThereErrors;
+}
+
+void eae6320::Graphics::UploadManager::DestroyStagingBuffers()
+{
+	if ( s_persistentMemory )
+	{
+		glBindBuffer( GL_COPY_READ_BUFFER, s_stagingBufferId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		glUnmapBuffer( GL_COPY_READ_BUFFER );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		glBindBuffer( GL_COPY_READ_BUFFER, 0 );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		s_persistentMemory = NULL;
+	}
+	// The GPU might still be copying from the buffer
+	FrameFences::DeferDelete( FrameFences::eResourceType::Buffer, s_stagingBufferId );
+	s_stagingBufferId = 0;
+}
+
+uint8_t* eae6320::Graphics::UploadManager::MapBatch( const unsigned int i_batchIndex )
+{
+	if ( s_persistentMemory )
+	{
+		return s_persistentMemory + ( i_batchIndex * s_batchByteCount );
+	}
+
+	glBindBuffer( GL_COPY_READ_BUFFER, s_stagingBufferId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	// The batch's frame has retired,
+	// and so the driver doesn't need to wait for the GPU
+	// (and the copies from other batches that are still in flight can't be affected)
+	const GLintptr offset = static_cast<GLintptr>( i_batchIndex * s_batchByteCount );
+	const GLsizeiptr length = static_cast<GLsizeiptr>( s_batchByteCount );
+	const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+	void* const memory = glMapBufferRange( GL_COPY_READ_BUFFER, offset, length, access );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	glBindBuffer( GL_COPY_READ_BUFFER, 0 );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	if ( !memory )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "OpenGL failed to map staging batch %u", i_batchIndex );
+	}
+	return reinterpret_cast<uint8_t*>( memory );
+}
+
+void eae6320::Graphics::UploadManager::UnmapBatch( const unsigned int i_batchIndex )
+{
+	if ( s_persistentMemory )
+	{
+		return;
+	}
+
+	glBindBuffer( GL_COPY_READ_BUFFER, s_stagingBufferId );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	// The contents are undefined if the buffer was corrupted while it was mapped
+	// (e.g. because the display mode changed)
+	if ( glUnmapBuffer( GL_COPY_READ_BUFFER ) == GL_FALSE )
+	{
+		Logging::OutputError( "Staging batch %u was corrupted while it was mapped", i_batchIndex );
+	}
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	glBindBuffer( GL_COPY_READ_BUFFER, 0 );
+	EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+}
+
+unsigned int eae6320::Graphics::UploadManager::SubmitCopies( const unsigned int i_batchIndex )
+{
+	EAE6320_ASSERT( ( s_bufferCopies.empty() && s_textureCopies.empty() ) || ( s_queuedBatchIndex == i_batchIndex ) );
+
+	if ( !s_bufferCopies.empty() )
+	{
+		glBindBuffer( GL_COPY_READ_BUFFER, s_stagingBufferId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		for ( std::vector<sBufferCopy>::const_iterator i = s_bufferCopies.begin(); i != s_bufferCopies.end(); ++i )
+		{
+			glBindBuffer( GL_COPY_WRITE_BUFFER, i->destinationId );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+			glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, i->sourceOffset, i->destinationOffset, i->size );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		}
+		glBindBuffer( GL_COPY_WRITE_BUFFER, 0 );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		glBindBuffer( GL_COPY_READ_BUFFER, 0 );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+	if ( !s_textureCopies.empty() )
+	{
+		// While a buffer is bound to GL_PIXEL_UNPACK_BUFFER
+		// the data pointers of texture uploads are offsets into it
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, s_stagingBufferId );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		const GLint noOffset = 0;
+		for ( std::vector<sTextureCopy>::const_iterator i = s_textureCopies.begin(); i != s_textureCopies.end(); ++i )
+		{
+			glBindTexture( GL_TEXTURE_2D, i->textureId );
+			EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+			const GLvoid* const sourceOffset = reinterpret_cast<const GLvoid*>( i->sourceOffset );
+			if ( i->compressedFormat != GL_NONE )
+			{
+				glCompressedTexSubImage2D( GL_TEXTURE_2D, i->mip, noOffset, noOffset, i->width, i->height, i->compressedFormat,
+					i->size, sourceOffset );
+				EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+			}
+			else
+			{
+				glTexSubImage2D( GL_TEXTURE_2D, i->mip, noOffset, noOffset, i->width, i->height, GL_RGBA, GL_UNSIGNED_BYTE, sourceOffset );
+				EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+			}
+		}
+		glBindTexture( GL_TEXTURE_2D, 0 );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+		// Texture uploads must read from client memory again
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+		EAE6320_GRAPHICS_GL_ASSERTNOERROR();
+	}
+
+	const unsigned int copyCount = static_cast<unsigned int>( s_bufferCopies.size() + s_textureCopies.size() );
+	DiscardCopies();
+	return copyCount;
+}
+
+void eae6320::Graphics::UploadManager::DiscardCopies()
+{
+	s_bufferCopies.clear();
+	s_textureCopies.clear();
+}
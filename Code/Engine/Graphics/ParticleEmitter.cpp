@@ -0,0 +1,476 @@
+// Header Files
+//=============
+
+#include "ParticleEmitter.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <xmmintrin.h>
+#include "Statistics.h"
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Batches must be a multiple of 4 so that every SSE load and store stays aligned
+	const unsigned int s_simulationBatchSize = 16 * 1024;
+	const unsigned int s_vertexBatchSize = 16 * 1024;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	template<typename tElement>
+	tElement* AllocateAlignedArray( const unsigned int i_count );
+	template<typename tElement>
+	void FreeAlignedArray( tElement*& io_array );
+	uint32_t GetNextRandomNumber( uint32_t& io_state );
+	float GetRandomFloat( uint32_t& io_state, const float i_min, const float i_max );
+}
+
+// Interface
+//==========
+
+// Update
+//-------
+
+void eae6320::Graphics::ParticleEmitter::Update( const float i_secondCountToIntegrate )
+{
+	const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+	m_stats.spawnedParticleCount = 0;
+	m_stats.killedParticleCount = 0;
+
+	const bool shouldScalarKernelBeUsed = false;
+	Simulate( i_secondCountToIntegrate, shouldScalarKernelBeUsed );
+	CompactDeadParticles();
+	// New particles are spawned after the dead ones have been removed
+	// so that they can reuse the freed slots in the same frame
+	{
+		m_spawnAccumulator += m_settings.spawnRatePerSecond * i_secondCountToIntegrate;
+		const unsigned int spawnCount = static_cast<unsigned int>( m_spawnAccumulator );
+		m_spawnAccumulator -= static_cast<float>( spawnCount );
+		Spawn( spawnCount );
+	}
+
+	m_stats.liveParticleCount = m_liveParticleCount;
+	m_stats.secondCountSimulating = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+}
+
+// Render
+//-------
+
+bool eae6320::Graphics::ParticleEmitter::Draw()
+{
+	if ( m_liveParticleCount == 0 )
+	{
+		return true;
+	}
+
+	// Write the particles straight into the vertex buffer
+	// (there is no intermediate copy of the vertex data on the CPU)
+	{
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		sParticleVertex* const vertices = MapVertexBuffer();
+		if ( vertices == NULL )
+		{
+			EAE6320_ASSERT( false );
+			return false;
+		}
+		WriteVertices( vertices );
+		UnmapVertexBuffer();
+		EAE6320_GRAPHICS_STATISTICS( CountUpload( m_liveParticleCount * sizeof( sParticleVertex ) ) );
+		m_stats.secondCountWritingVertices = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	}
+
+	DrawVertexBuffer( m_liveParticleCount );
+
+	return true;
+}
+
+// Benchmark
+//----------
+
+void eae6320::Graphics::ParticleEmitter::LogSimulationCost()
+{
+	const unsigned int particleCount = 1024 * 1024;
+	// Every particle starts at the same time and lives for between 1 and 2 seconds,
+	// and so during the second half of the frames particles die (and are replaced) every frame
+	const unsigned int frameCount = 120;
+	const float secondCountPerFrame = 1.0f / 60.0f;
+	// The vertices are written into system memory instead of a vertex buffer
+	std::vector<sParticleVertex> vertices( particleCount );
+
+	Logging::OutputMessage( "Simulating %u particles for %u frames on %u worker threads (and the calling thread):",
+		particleCount, frameCount, Jobs::GetWorkerThreadCount() );
+	double secondCounts_simulating[2];
+	for ( unsigned int k = 0; k < 2; ++k )
+	{
+		const bool shouldScalarKernelBeUsed = k == 1;
+		// Both kernels start from the same particles
+		// (the random state is seeded from the particle count)
+		ParticleEmitter emitter;
+		if ( !emitter.AllocateParticles( particleCount, sSettings() ) )
+		{
+			return;
+		}
+		emitter.Spawn( particleCount );
+
+		double secondCount_compacting = 0.0, secondCount_spawning = 0.0, secondCount_writingVertices = 0.0;
+		secondCounts_simulating[k] = 0.0;
+		unsigned int killedParticleCount = 0;
+		for ( unsigned int f = 0; f < frameCount; ++f )
+		{
+			const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+			emitter.Simulate( secondCountPerFrame, shouldScalarKernelBeUsed );
+			const uint64_t tickCount_simulated = Time::GetCurrentSystemTimeTickCount();
+			emitter.CompactDeadParticles();
+			const uint64_t tickCount_compacted = Time::GetCurrentSystemTimeTickCount();
+			killedParticleCount += particleCount - emitter.m_liveParticleCount;
+			emitter.Spawn( particleCount - emitter.m_liveParticleCount );
+			const uint64_t tickCount_spawned = Time::GetCurrentSystemTimeTickCount();
+			emitter.WriteVertices( &vertices[0] );
+			const uint64_t tickCount_end = Time::GetCurrentSystemTimeTickCount();
+			secondCounts_simulating[k] += Time::ConvertTicksToSeconds( tickCount_simulated - tickCount_start );
+			secondCount_compacting += Time::ConvertTicksToSeconds( tickCount_compacted - tickCount_simulated );
+			secondCount_spawning += Time::ConvertTicksToSeconds( tickCount_spawned - tickCount_compacted );
+			secondCount_writingVertices += Time::ConvertTicksToSeconds( tickCount_end - tickCount_spawned );
+		}
+		emitter.CleanUp();
+
+		const double millisecondsPerFrame = 1000.0 / frameCount;
+		const double secondCount_total = secondCounts_simulating[k] + secondCount_compacting + secondCount_spawning + secondCount_writingVertices;
+		Logging::OutputMessage( "\t%s kernel: %.3f ms per frame (simulating %.3f ms, compacting %.3f ms,"
+			" respawning %.3f ms, writing vertices %.3f ms) with %.0f particles replaced per frame",
+			shouldScalarKernelBeUsed ? "Scalar" : "SSE", secondCount_total * millisecondsPerFrame,
+			secondCounts_simulating[k] * millisecondsPerFrame, secondCount_compacting * millisecondsPerFrame,
+			secondCount_spawning * millisecondsPerFrame, secondCount_writingVertices * millisecondsPerFrame,
+			static_cast<double>( killedParticleCount ) / frameCount );
+	}
+	Logging::OutputMessage( "\tThe SSE simulation kernel was %.2f times as fast as the scalar one",
+		( secondCounts_simulating[0] > 0.0 ) ? ( secondCounts_simulating[1] / secondCounts_simulating[0] ) : 0.0 );
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::ParticleEmitter::Initialize( const unsigned int i_maxParticleCount, const sSettings& i_settings )
+{
+	if ( !AllocateParticles( i_maxParticleCount, i_settings ) )
+	{
+		return false;
+	}
+
+	if ( !CreateVertexBuffer() )
+	{
+		EAE6320_ASSERT( false );
+		CleanUp();
+		return false;
+	}
+	m_vertexBufferSize = m_maxParticleCount * sizeof( sParticleVertex );
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+
+	return true;
+}
+
+bool eae6320::Graphics::ParticleEmitter::CleanUp()
+{
+	const bool wereThereErrors = !DestroyVertexBuffer();
+	if ( m_vertexBufferSize != 0 )
+	{
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+		m_vertexBufferSize = 0;
+	}
+
+	FreeAlignedArray( m_positionX );
+	FreeAlignedArray( m_positionY );
+	FreeAlignedArray( m_velocityX );
+	FreeAlignedArray( m_velocityY );
+	FreeAlignedArray( m_lifetimeRemaining );
+	FreeAlignedArray( m_lifetimeInverse );
+	FreeAlignedArray( m_color );
+	m_maxParticleCount = 0;
+	m_liveParticleCount = 0;
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::ParticleEmitter::sSettings::sSettings()
+	:
+	positionX( 0.0f ), positionY( 0.0f ),
+	speedMin( 0.1f ), speedMax( 0.5f ),
+	lifetimeMin( 1.0f ), lifetimeMax( 2.0f ),
+	spawnRatePerSecond( 1000.0f ),
+	accelerationX( 0.0f ), accelerationY( -0.25f ),
+	colorA( 0xff0080ffu ), colorB( 0xff00ffffu )
+{
+
+}
+
+eae6320::Graphics::ParticleEmitter::ParticleEmitter()
+	:
+	m_positionX( NULL ), m_positionY( NULL ), m_velocityX( NULL ), m_velocityY( NULL ),
+	m_lifetimeRemaining( NULL ), m_lifetimeInverse( NULL ), m_color( NULL ),
+	m_maxParticleCount( 0 ), m_liveParticleCount( 0 ), m_spawnAccumulator( 0.0f ), m_randomState( 1 ),
+	m_secondCountToIntegrate( 0.0f ), m_mappedVertices( NULL ), m_vertexBufferSize( 0 ),
+#if defined( EAE6320_PLATFORM_D3D )
+	m_vertexBuffer( NULL )
+#elif defined( EAE6320_PLATFORM_GL )
+	m_vertexArrayId( 0 ), m_vertexBufferId( 0 )
+#endif
+{
+	memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+eae6320::Graphics::ParticleEmitter::~ParticleEmitter()
+{
+	EAE6320_ASSERTF( m_positionX == NULL, "A particle emitter was destroyed without being cleaned up" );
+}
+
+// Implementation
+//===============
+
+bool eae6320::Graphics::ParticleEmitter::AllocateParticles( const unsigned int i_maxParticleCount, const sSettings& i_settings )
+{
+	EAE6320_ASSERTF( m_positionX == NULL, "A particle emitter can't be initialized twice" );
+
+	m_settings = i_settings;
+	// The capacity is rounded up so that the SIMD update never needs a scalar remainder loop
+	m_maxParticleCount = ( i_maxParticleCount + 3 ) & ~3u;
+	m_liveParticleCount = 0;
+	m_spawnAccumulator = 0.0f;
+	m_randomState = 0x9e3779b9u ^ m_maxParticleCount;
+	memset( &m_stats, 0, sizeof( m_stats ) );
+
+	m_positionX = AllocateAlignedArray<float>( m_maxParticleCount );
+	m_positionY = AllocateAlignedArray<float>( m_maxParticleCount );
+	m_velocityX = AllocateAlignedArray<float>( m_maxParticleCount );
+	m_velocityY = AllocateAlignedArray<float>( m_maxParticleCount );
+	m_lifetimeRemaining = AllocateAlignedArray<float>( m_maxParticleCount );
+	m_lifetimeInverse = AllocateAlignedArray<float>( m_maxParticleCount );
+	m_color = AllocateAlignedArray<uint32_t>( m_maxParticleCount );
+	if ( !m_positionX || !m_positionY || !m_velocityX || !m_velocityY
+		|| !m_lifetimeRemaining || !m_lifetimeInverse || !m_color )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "Failed to allocate memory for %u particles", m_maxParticleCount );
+		CleanUp();
+		return false;
+	}
+
+	return true;
+}
+
+void eae6320::Graphics::ParticleEmitter::Spawn( const unsigned int i_count )
+{
+	const unsigned int freeCount = m_maxParticleCount - m_liveParticleCount;
+	const unsigned int spawnCount = ( i_count < freeCount ) ? i_count : freeCount;
+	const float twoPi = 6.28318530718f;
+	for ( unsigned int i = m_liveParticleCount; i < ( m_liveParticleCount + spawnCount ); ++i )
+	{
+		m_positionX[i] = m_settings.positionX;
+		m_positionY[i] = m_settings.positionY;
+		{
+			const float angle = GetRandomFloat( m_randomState, 0.0f, twoPi );
+			const float speed = GetRandomFloat( m_randomState, m_settings.speedMin, m_settings.speedMax );
+			m_velocityX[i] = std::cos( angle ) * speed;
+			m_velocityY[i] = std::sin( angle ) * speed;
+		}
+		{
+			const float lifetime = GetRandomFloat( m_randomState, m_settings.lifetimeMin, m_settings.lifetimeMax );
+			m_lifetimeRemaining[i] = lifetime;
+			m_lifetimeInverse[i] = ( lifetime > 0.0f ) ? ( 1.0f / lifetime ) : 0.0f;
+		}
+		// Each channel is interpolated independently between the two settings colors
+		{
+			const float t = GetRandomFloat( m_randomState, 0.0f, 1.0f );
+			uint32_t color = 0;
+			for ( unsigned int shift = 0; shift < 32; shift += 8 )
+			{
+				const float a = static_cast<float>( ( m_settings.colorA >> shift ) & 0xff );
+				const float b = static_cast<float>( ( m_settings.colorB >> shift ) & 0xff );
+				color |= static_cast<uint32_t>( a + ( ( b - a ) * t ) ) << shift;
+			}
+			m_color[i] = color;
+		}
+	}
+	m_liveParticleCount += spawnCount;
+	m_stats.spawnedParticleCount += spawnCount;
+}
+
+void eae6320::Graphics::ParticleEmitter::Simulate( const float i_secondCountToIntegrate, const bool i_shouldScalarKernelBeUsed )
+{
+	m_secondCountToIntegrate = i_secondCountToIntegrate;
+	// The padding slots past the live count are simulated too,
+	// which is harmless and keeps the kernel free of a remainder loop
+	const unsigned int paddedCount = ( m_liveParticleCount + 3 ) & ~3u;
+	Jobs::ParallelFor( paddedCount, s_simulationBatchSize, i_shouldScalarKernelBeUsed ? SimulateBatch_scalar : SimulateBatch, this );
+}
+
+void eae6320::Graphics::ParticleEmitter::CompactDeadParticles()
+{
+	// Dead particles are replaced by the last live particle,
+	// which keeps the live particles contiguous without ever reallocating
+	// (the order of particles doesn't matter)
+	const __m128 zero = _mm_setzero_ps();
+	unsigned int liveCount = m_liveParticleCount;
+	unsigned int i = 0;
+	while ( i < liveCount )
+	{
+		// Skip over groups of 4 where every particle is still alive
+		if ( ( ( i & 3 ) == 0 ) && ( ( i + 4 ) <= liveCount ) )
+		{
+			const __m128 lifetimeRemaining = _mm_load_ps( m_lifetimeRemaining + i );
+			if ( _mm_movemask_ps( _mm_cmple_ps( lifetimeRemaining, zero ) ) == 0 )
+			{
+				i += 4;
+				continue;
+			}
+		}
+		if ( m_lifetimeRemaining[i] <= 0.0f )
+		{
+			--liveCount;
+			m_positionX[i] = m_positionX[liveCount];
+			m_positionY[i] = m_positionY[liveCount];
+			m_velocityX[i] = m_velocityX[liveCount];
+			m_velocityY[i] = m_velocityY[liveCount];
+			m_lifetimeRemaining[i] = m_lifetimeRemaining[liveCount];
+			m_lifetimeInverse[i] = m_lifetimeInverse[liveCount];
+			m_color[i] = m_color[liveCount];
+			// The same index is checked again since it now holds a different particle
+		}
+		else
+		{
+			++i;
+		}
+	}
+	m_stats.killedParticleCount += m_liveParticleCount - liveCount;
+	m_liveParticleCount = liveCount;
+}
+
+void eae6320::Graphics::ParticleEmitter::WriteVertices( sParticleVertex* const o_vertices )
+{
+	m_mappedVertices = o_vertices;
+	Jobs::ParallelFor( m_liveParticleCount, s_vertexBatchSize, WriteVerticesBatch, this );
+	m_mappedVertices = NULL;
+}
+
+void eae6320::Graphics::ParticleEmitter::SimulateBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+{
+	ParticleEmitter& emitter = *reinterpret_cast<ParticleEmitter*>( io_userData );
+	EAE6320_ASSERT( ( ( i_begin & 3 ) == 0 ) && ( ( i_end & 3 ) == 0 ) );
+
+	const __m128 deltaTime = _mm_set1_ps( emitter.m_secondCountToIntegrate );
+	const __m128 deltaVelocityX = _mm_set1_ps( emitter.m_settings.accelerationX * emitter.m_secondCountToIntegrate );
+	const __m128 deltaVelocityY = _mm_set1_ps( emitter.m_settings.accelerationY * emitter.m_secondCountToIntegrate );
+	float* const positionX = emitter.m_positionX;
+	float* const positionY = emitter.m_positionY;
+	float* const velocityX = emitter.m_velocityX;
+	float* const velocityY = emitter.m_velocityY;
+	float* const lifetimeRemaining = emitter.m_lifetimeRemaining;
+	for ( unsigned int i = i_begin; i < i_end; i += 4 )
+	{
+		// Semi-implicit Euler
+		const __m128 vx = _mm_add_ps( _mm_load_ps( velocityX + i ), deltaVelocityX );
+		const __m128 vy = _mm_add_ps( _mm_load_ps( velocityY + i ), deltaVelocityY );
+		_mm_store_ps( velocityX + i, vx );
+		_mm_store_ps( velocityY + i, vy );
+		_mm_store_ps( positionX + i, _mm_add_ps( _mm_load_ps( positionX + i ), _mm_mul_ps( vx, deltaTime ) ) );
+		_mm_store_ps( positionY + i, _mm_add_ps( _mm_load_ps( positionY + i ), _mm_mul_ps( vy, deltaTime ) ) );
+		_mm_store_ps( lifetimeRemaining + i, _mm_sub_ps( _mm_load_ps( lifetimeRemaining + i ), deltaTime ) );
+	}
+}
+
+void eae6320::Graphics::ParticleEmitter::SimulateBatch_scalar( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+{
+	ParticleEmitter& emitter = *reinterpret_cast<ParticleEmitter*>( io_userData );
+
+	// This does the same thing as SimulateBatch() one particle at a time
+	const float deltaTime = emitter.m_secondCountToIntegrate;
+	const float deltaVelocityX = emitter.m_settings.accelerationX * emitter.m_secondCountToIntegrate;
+	const float deltaVelocityY = emitter.m_settings.accelerationY * emitter.m_secondCountToIntegrate;
+	for ( unsigned int i = i_begin; i < i_end; ++i )
+	{
+		const float vx = emitter.m_velocityX[i] + deltaVelocityX;
+		const float vy = emitter.m_velocityY[i] + deltaVelocityY;
+		emitter.m_velocityX[i] = vx;
+		emitter.m_velocityY[i] = vy;
+		emitter.m_positionX[i] += vx * deltaTime;
+		emitter.m_positionY[i] += vy * deltaTime;
+		emitter.m_lifetimeRemaining[i] -= deltaTime;
+	}
+}
+
+void eae6320::Graphics::ParticleEmitter::WriteVerticesBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+{
+	const ParticleEmitter& emitter = *reinterpret_cast<const ParticleEmitter*>( io_userData );
+	sParticleVertex* const vertices = emitter.m_mappedVertices;
+	for ( unsigned int i = i_begin; i < i_end; ++i )
+	{
+		sParticleVertex& vertex = vertices[i];
+		vertex.x = emitter.m_positionX[i];
+		vertex.y = emitter.m_positionY[i];
+		const uint32_t color = emitter.m_color[i];
+		vertex.r = static_cast<uint8_t>( color );
+		vertex.g = static_cast<uint8_t>( color >> 8 );
+		vertex.b = static_cast<uint8_t>( color >> 16 );
+		// The alpha fades out as the particle approaches the end of its life
+		{
+			const float remainingFraction = emitter.m_lifetimeRemaining[i] * emitter.m_lifetimeInverse[i];
+			const float alpha = static_cast<float>( color >> 24 ) * ( ( remainingFraction > 0.0f ) ? remainingFraction : 0.0f );
+			vertex.a = static_cast<uint8_t>( alpha );
+		}
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	template<typename tElement>
+	tElement* AllocateAlignedArray( const unsigned int i_count )
+	{
+		const size_t alignment = 16;
+		const size_t size = sizeof( tElement ) * i_count;
+		tElement* const newArray = reinterpret_cast<tElement*>( _mm_malloc( size, alignment ) );
+		if ( newArray )
+		{
+			// The padding slots get simulated, and so they shouldn't contain garbage
+			memset( newArray, 0, size );
+		}
+		return newArray;
+	}
+
+	template<typename tElement>
+	void FreeAlignedArray( tElement*& io_array )
+	{
+		if ( io_array )
+		{
+			_mm_free( io_array );
+			io_array = NULL;
+		}
+	}
+
+	uint32_t GetNextRandomNumber( uint32_t& io_state )
+	{
+		// xorshift32
+		io_state ^= io_state << 13;
+		io_state ^= io_state >> 17;
+		io_state ^= io_state << 5;
+		return io_state;
+	}
+
+	float GetRandomFloat( uint32_t& io_state, const float i_min, const float i_max )
+	{
+		const float zeroToOne = static_cast<float>( GetNextRandomNumber( io_state ) >> 8 ) * ( 1.0f / 16777216.0f );
+		return i_min + ( ( i_max - i_min ) * zeroToOne );
+	}
+}
@@ -0,0 +1,179 @@
+/*
+	A particle emitter simulates a large number of short-lived points
+	and streams them into a dynamic vertex buffer every frame
+
+	The particles are stored as a structure of arrays
+	so that they can be updated 4 at a time with SSE
+	and so that the update can be split across the job worker threads.
+*/
+
+#ifndef EAE6320_GRAPHICS_PARTICLEEMITTER_H
+#define EAE6320_GRAPHICS_PARTICLEEMITTER_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		// This struct determines the layout of the particle data that the CPU will send to the GPU.
+		// The position must come first so that it matches the layout of sVertex.
+		struct sParticleVertex
+		{
+			// POSITION
+			// 2 floats == 8 bytes
+			// Offset = 0
+			float x, y;
+			// COLOR
+			// 4 uint8_ts == 4 bytes
+			// Offset = 8
+			uint8_t r, g, b, a;
+		};
+
+		class ParticleEmitter
+		{
+		public:
+
+			struct sSettings
+			{
+				// Where new particles are spawned
+				float positionX, positionY;
+				// New particles are launched in a random direction
+				// with a random speed in this range
+				float speedMin, speedMax;
+				// How long (in seconds) a particle lives for
+				float lifetimeMin, lifetimeMax;
+				// How many particles are spawned every second
+				float spawnRatePerSecond;
+				// A constant acceleration applied to every particle
+				float accelerationX, accelerationY;
+				// New particles get a random color between these two (RGBA8, with red in the lowest byte).
+				// The alpha fades to zero over the particle's lifetime.
+				uint32_t colorA, colorB;
+
+				sSettings();
+			};
+
+			// These can be used to profile the emitter
+			struct sStats
+			{
+				unsigned int liveParticleCount;
+				unsigned int spawnedParticleCount;
+				unsigned int killedParticleCount;
+				double secondCountSimulating;
+				double secondCountWritingVertices;
+			};
+
+			// Update
+			//-------
+
+			void Update( const float i_secondCountToIntegrate );
+
+			// Render
+			//-------
+
+			// This must be called from the render thread
+			// (it writes the particles straight into the mapped vertex buffer)
+			bool Draw();
+
+			// Access
+			//-------
+
+			unsigned int GetLiveParticleCount() const { return m_liveParticleCount; }
+			unsigned int GetMaxParticleCount() const { return m_maxParticleCount; }
+			const sStats& GetStats() const { return m_stats; }
+			sSettings& GetSettings() { return m_settings; }
+
+			// Benchmark
+			//----------
+
+			// This simulates, compacts, and writes the vertices of more than a million particles for many frames
+			// (without drawing them) and logs how long a frame took with the SSE and the scalar simulation kernels
+			static void LogSimulationCost();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Initialize( const unsigned int i_maxParticleCount, const sSettings& i_settings );
+			bool CleanUp();
+
+			ParticleEmitter();
+			~ParticleEmitter();
+
+			// Implementation
+			//===============
+
+		private:
+
+			// This is everything from Initialize() except for creating the vertex buffer
+			bool AllocateParticles( const unsigned int i_maxParticleCount, const sSettings& i_settings );
+			void Spawn( const unsigned int i_count );
+			// The scalar kernel is only used to measure how much faster the SSE one is
+			void Simulate( const float i_secondCountToIntegrate, const bool i_shouldScalarKernelBeUsed );
+			void CompactDeadParticles();
+			void WriteVertices( sParticleVertex* const o_vertices );
+
+			// Platform-specific
+			bool CreateVertexBuffer();
+			bool DestroyVertexBuffer();
+			sParticleVertex* MapVertexBuffer();
+			void UnmapVertexBuffer();
+			void DrawVertexBuffer( const unsigned int i_vertexCount );
+
+			static void SimulateBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+			static void SimulateBatch_scalar( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+			static void WriteVerticesBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+
+			// Data
+			//=====
+
+		private:
+
+			sSettings m_settings;
+			sStats m_stats;
+
+			// Structure of arrays
+			// (every array is 16-byte aligned and has room for a multiple of 4 particles)
+			float* m_positionX;
+			float* m_positionY;
+			float* m_velocityX;
+			float* m_velocityY;
+			float* m_lifetimeRemaining;
+			float* m_lifetimeInverse;
+			uint32_t* m_color;
+
+			unsigned int m_maxParticleCount;
+			unsigned int m_liveParticleCount;
+			float m_spawnAccumulator;
+			uint32_t m_randomState;
+
+			// The per-frame integration values are stored so that the job batches can read them
+			float m_secondCountToIntegrate;
+			sParticleVertex* m_mappedVertices;
+			// This is only used for statistics
+			size_t m_vertexBufferSize;
+
+#if defined( EAE6320_PLATFORM_D3D )
+			ID3D11Buffer* m_vertexBuffer;
+#elif defined( EAE6320_PLATFORM_GL )
+			GLuint m_vertexArrayId;
+			GLuint m_vertexBufferId;
+#endif
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_PARTICLEEMITTER_H
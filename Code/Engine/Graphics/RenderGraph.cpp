@@ -0,0 +1,543 @@
+// Header Files
+//=============
+
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	struct sLifetime
+	{
+		unsigned int resourceIndex;
+		unsigned int firstUse;
+	};
+	bool StartsBefore( const sLifetime& i_lhs, const sLifetime& i_rhs );
+}
+
+// Interface
+//==========
+
+// Build
+//------
+
+unsigned int eae6320::Graphics::RenderGraph::ImportBackBuffer( const sTargetDescription& i_description )
+{
+	EAE6320_ASSERTF( m_backBufferIndex == s_invalidIndex, "The back buffer can only be imported once per frame" );
+	sResource resource;
+	{
+		resource.name = "Back Buffer";
+		resource.description = i_description;
+		resource.readerCount = 0;
+		resource.firstUse = resource.lastUse = s_invalidIndex;
+		resource.physicalTargetIndex = s_invalidIndex;
+		resource.isImported = true;
+	}
+	m_backBufferIndex = static_cast<unsigned int>( m_resources.size() );
+	m_resources.push_back( resource );
+	m_isCompiled = false;
+	return m_backBufferIndex;
+}
+
+unsigned int eae6320::Graphics::RenderGraph::CreateTransientTarget( const char* const i_name, const sTargetDescription& i_description )
+{
+	EAE6320_ASSERT( ( i_description.width > 0 ) && ( i_description.height > 0 ) );
+	sResource resource;
+	{
+		resource.name = i_name;
+		resource.description = i_description;
+		resource.readerCount = 0;
+		resource.firstUse = resource.lastUse = s_invalidIndex;
+		resource.physicalTargetIndex = s_invalidIndex;
+		resource.isImported = false;
+	}
+	m_resources.push_back( resource );
+	m_isCompiled = false;
+	return static_cast<unsigned int>( m_resources.size() - 1 );
+}
+
+unsigned int eae6320::Graphics::RenderGraph::AddPass( const char* const i_name, const fExecutePass i_function, void* const io_userData,
+	const bool i_hasSideEffects )
+{
+	EAE6320_ASSERT( i_function );
+	sPass pass;
+	{
+		pass.name = i_name;
+		pass.function = i_function;
+		pass.userData = io_userData;
+		pass.viewportWidth = pass.viewportHeight = 0;
+		pass.referenceCount = 0;
+		pass.hasSideEffects = i_hasSideEffects;
+		pass.isCulled = false;
+	}
+	m_passes.push_back( pass );
+	m_isCompiled = false;
+	return static_cast<unsigned int>( m_passes.size() - 1 );
+}
+
+void eae6320::Graphics::RenderGraph::Read( const unsigned int i_passIndex, const unsigned int i_resourceIndex )
+{
+	EAE6320_ASSERT( ( i_passIndex < m_passes.size() ) && ( i_resourceIndex < m_resources.size() ) );
+	EAE6320_ASSERTF( !m_resources[i_resourceIndex].isImported, "The back buffer can't be read" );
+	sPass& pass = m_passes[i_passIndex];
+	for ( std::vector<sWrite>::const_iterator i = pass.writes.begin(); i != pass.writes.end(); ++i )
+	{
+		EAE6320_ASSERTF( i->resourceIndex != i_resourceIndex, "A pass can't read a resource that it writes" );
+	}
+	pass.readIndices.push_back( i_resourceIndex );
+	++m_resources[i_resourceIndex].readerCount;
+	m_isCompiled = false;
+}
+
+void eae6320::Graphics::RenderGraph::Write( const unsigned int i_passIndex, const unsigned int i_resourceIndex, const float* const i_clearColor )
+{
+	EAE6320_ASSERT( ( i_passIndex < m_passes.size() ) && ( i_resourceIndex < m_resources.size() ) );
+	sPass& pass = m_passes[i_passIndex];
+	EAE6320_ASSERTF( std::find( pass.readIndices.begin(), pass.readIndices.end(), i_resourceIndex ) == pass.readIndices.end(),
+		"A pass can't write a resource that it reads" );
+	EAE6320_ASSERTF( pass.writes.empty()
+		|| AreDescriptionsEqual( m_resources[pass.writes.front().resourceIndex].description, m_resources[i_resourceIndex].description ),
+		"All of the targets that a pass writes must be the same size" );
+	sWrite write;
+	{
+		write.resourceIndex = i_resourceIndex;
+		write.shouldBeCleared = i_clearColor != NULL;
+		for ( unsigned int i = 0; i < 4; ++i )
+		{
+			write.clearColor[i] = i_clearColor ? i_clearColor[i] : 0.0f;
+		}
+	}
+	pass.writes.push_back( write );
+	m_resources[i_resourceIndex].writerIndices.push_back( i_passIndex );
+	m_isCompiled = false;
+}
+
+void eae6320::Graphics::RenderGraph::SetViewport( const unsigned int i_passIndex, const uint16_t i_width, const uint16_t i_height )
+{
+	EAE6320_ASSERT( i_passIndex < m_passes.size() );
+	sPass& pass = m_passes[i_passIndex];
+	pass.viewportWidth = i_width;
+	pass.viewportHeight = i_height;
+}
+
+// Compile
+//--------
+
+bool eae6320::Graphics::RenderGraph::Compile()
+{
+	const sStats previousStats = m_stats;
+
+	CullPasses();
+	if ( !OrderPasses() )
+	{
+		return false;
+	}
+	AssignPhysicalTargets();
+
+	// The physical targets that already exist are reused if they have the right description,
+	// and only the ones that are missing are created
+	{
+		bool wereThereErrors = false;
+
+		std::vector<sPhysicalTarget> existingTargets;
+		existingTargets.swap( m_physicalTargets );
+		m_physicalTargets.resize( m_stats.physicalTargetCount );
+		for ( std::vector<sResource>::const_iterator i = m_resources.begin(); i != m_resources.end(); ++i )
+		{
+			if ( i->physicalTargetIndex != s_invalidIndex )
+			{
+				m_physicalTargets[i->physicalTargetIndex].description = i->description;
+			}
+		}
+		for ( std::vector<sPhysicalTarget>::iterator i = m_physicalTargets.begin(); i != m_physicalTargets.end(); ++i )
+		{
+			std::vector<sPhysicalTarget>::iterator existingTarget = existingTargets.begin();
+			while ( ( existingTarget != existingTargets.end() ) && !AreDescriptionsEqual( existingTarget->description, i->description ) )
+			{
+				++existingTarget;
+			}
+			if ( existingTarget != existingTargets.end() )
+			{
+				*i = *existingTarget;
+				existingTargets.erase( existingTarget );
+			}
+			else if ( !CreatePhysicalTarget( *i ) )
+			{
+				wereThereErrors = true;
+			}
+		}
+		for ( std::vector<sPhysicalTarget>::iterator i = existingTargets.begin(); i != existingTargets.end(); ++i )
+		{
+			if ( !DestroyPhysicalTarget( *i ) )
+			{
+				wereThereErrors = true;
+			}
+		}
+		if ( wereThereErrors )
+		{
+			Logging::OutputError( "The render graph couldn't create all of its render targets" );
+			return false;
+		}
+	}
+
+	// The graph is usually the same every frame,
+	// and so the statistics are only logged when they change
+	if ( ( m_stats.passCount != previousStats.passCount ) || ( m_stats.culledPassCount != previousStats.culledPassCount )
+		|| ( m_stats.transientTargetCount != previousStats.transientTargetCount )
+		|| ( m_stats.physicalTargetCount != previousStats.physicalTargetCount )
+		|| ( m_stats.transientMemory_withAliasing != previousStats.transientMemory_withAliasing )
+		|| ( m_stats.transientMemory_withoutAliasing != previousStats.transientMemory_withoutAliasing ) )
+	{
+		LogStats();
+	}
+
+	m_isCompiled = true;
+	return true;
+}
+
+// Execute
+//--------
+
+bool eae6320::Graphics::RenderGraph::Execute()
+{
+	if ( !m_isCompiled )
+	{
+		EAE6320_ASSERTF( false, "The render graph must be compiled before it is executed" );
+		Logging::OutputError( "The render graph was executed without being compiled" );
+		return false;
+	}
+
+	for ( std::vector<unsigned int>::const_iterator i = m_passOrder.begin(); i != m_passOrder.end(); ++i )
+	{
+		const sPass& pass = m_passes[*i];
+		BindTargets( pass );
+		pass.function( *this, pass.userData );
+	}
+
+	return true;
+}
+
+// Statistics
+//-----------
+
+void eae6320::Graphics::RenderGraph::LogStats() const
+{
+	Logging::OutputMessage( "Render graph: %u passes (%u culled), %u transient targets aliased to %u physical targets:"
+		" %u KB of transient memory with aliasing and %u KB without",
+		m_stats.passCount, m_stats.culledPassCount, m_stats.transientTargetCount, m_stats.physicalTargetCount,
+		static_cast<unsigned int>( m_stats.transientMemory_withAliasing / 1024 ),
+		static_cast<unsigned int>( m_stats.transientMemory_withoutAliasing / 1024 ) );
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+void eae6320::Graphics::RenderGraph::Reset()
+{
+	m_resources.clear();
+	m_passes.clear();
+	m_passOrder.clear();
+	m_backBufferIndex = s_invalidIndex;
+	m_isCompiled = false;
+}
+
+bool eae6320::Graphics::RenderGraph::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	Reset();
+	for ( std::vector<sPhysicalTarget>::iterator i = m_physicalTargets.begin(); i != m_physicalTargets.end(); ++i )
+	{
+		if ( !DestroyPhysicalTarget( *i ) )
+		{
+			wereThereErrors = true;
+		}
+	}
+	m_physicalTargets.clear();
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::RenderGraph::RenderGraph()
+	:
+	m_backBufferIndex( s_invalidIndex ), m_isAliasingEnabled( true ), m_isCompiled( false )
+{
+	m_stats.passCount = m_stats.culledPassCount = 0;
+	m_stats.transientTargetCount = m_stats.physicalTargetCount = 0;
+	m_stats.transientMemory_withoutAliasing = m_stats.transientMemory_withAliasing = 0;
+}
+
+eae6320::Graphics::RenderGraph::~RenderGraph()
+{
+	EAE6320_ASSERTF( m_physicalTargets.empty(), "A render graph must be cleaned up before it is destroyed" );
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::RenderGraph::CullPasses()
+{
+	// Every pass is referenced by the resources that it writes
+	// and every resource is referenced by the passes that read it.
+	// The back buffer (and anything written by a pass with side effects) is always needed,
+	// and anything else that ends up without any references is culled.
+	std::vector<unsigned int> resourceReferenceCounts( m_resources.size() );
+	for ( size_t i = 0; i < m_resources.size(); ++i )
+	{
+		resourceReferenceCounts[i] = m_resources[i].readerCount + ( m_resources[i].isImported ? 1 : 0 );
+	}
+	for ( std::vector<sPass>::iterator i = m_passes.begin(); i != m_passes.end(); ++i )
+	{
+		i->referenceCount = static_cast<unsigned int>( i->writes.size() );
+		i->isCulled = false;
+		for ( std::vector<sWrite>::const_iterator j = i->writes.begin(); j != i->writes.end(); ++j )
+		{
+			i->hasSideEffects = i->hasSideEffects || m_resources[j->resourceIndex].isImported;
+		}
+	}
+
+	std::vector<unsigned int> unreferencedResources;
+	for ( size_t i = 0; i < m_resources.size(); ++i )
+	{
+		if ( resourceReferenceCounts[i] == 0 )
+		{
+			unreferencedResources.push_back( static_cast<unsigned int>( i ) );
+		}
+	}
+	while ( !unreferencedResources.empty() )
+	{
+		const sResource& resource = m_resources[unreferencedResources.back()];
+		unreferencedResources.pop_back();
+		for ( std::vector<unsigned int>::const_iterator i = resource.writerIndices.begin(); i != resource.writerIndices.end(); ++i )
+		{
+			sPass& writer = m_passes[*i];
+			EAE6320_ASSERT( writer.referenceCount > 0 );
+			if ( ( --writer.referenceCount == 0 ) && !writer.hasSideEffects )
+			{
+				// Nothing that the pass writes is used,
+				// and so nothing that it reads is used by it either
+				writer.isCulled = true;
+				for ( std::vector<unsigned int>::const_iterator j = writer.readIndices.begin(); j != writer.readIndices.end(); ++j )
+				{
+					if ( --resourceReferenceCounts[*j] == 0 )
+					{
+						unreferencedResources.push_back( *j );
+					}
+				}
+			}
+		}
+	}
+
+	// A pass that writes nothing and has no side effects is never needed
+	for ( std::vector<sPass>::iterator i = m_passes.begin(); i != m_passes.end(); ++i )
+	{
+		i->isCulled = i->isCulled || ( i->writes.empty() && !i->hasSideEffects );
+	}
+}
+
+bool eae6320::Graphics::RenderGraph::OrderPasses()
+{
+	// Every pass that reads a resource depends on every pass that writes it,
+	// and the passes that write the same resource depend on each other in the order they were added.
+	// The passes are sorted topologically, and when more than one pass is ready the one that was added first is chosen
+	// (which keeps the order that the passes were added in whenever it is already valid).
+	const size_t passCount = m_passes.size();
+	std::vector<std::vector<unsigned int> > dependents( passCount );
+	std::vector<unsigned int> dependencyCounts( passCount, 0 );
+	for ( size_t i = 0; i < passCount; ++i )
+	{
+		const sPass& pass = m_passes[i];
+		if ( pass.isCulled )
+		{
+			continue;
+		}
+		for ( std::vector<unsigned int>::const_iterator j = pass.readIndices.begin(); j != pass.readIndices.end(); ++j )
+		{
+			const std::vector<unsigned int>& writerIndices = m_resources[*j].writerIndices;
+			for ( std::vector<unsigned int>::const_iterator k = writerIndices.begin(); k != writerIndices.end(); ++k )
+			{
+				if ( !m_passes[*k].isCulled )
+				{
+					dependents[*k].push_back( static_cast<unsigned int>( i ) );
+					++dependencyCounts[i];
+				}
+			}
+		}
+		for ( std::vector<sWrite>::const_iterator j = pass.writes.begin(); j != pass.writes.end(); ++j )
+		{
+			// Only the previous writer is needed because it depends on the writers before it
+			const std::vector<unsigned int>& writerIndices = m_resources[j->resourceIndex].writerIndices;
+			unsigned int previousWriterIndex = s_invalidIndex;
+			for ( std::vector<unsigned int>::const_iterator k = writerIndices.begin(); ( k != writerIndices.end() ) && ( *k < i ); ++k )
+			{
+				if ( !m_passes[*k].isCulled )
+				{
+					previousWriterIndex = *k;
+				}
+			}
+			if ( previousWriterIndex != s_invalidIndex )
+			{
+				dependents[previousWriterIndex].push_back( static_cast<unsigned int>( i ) );
+				++dependencyCounts[i];
+			}
+		}
+	}
+
+	m_passOrder.clear();
+	unsigned int culledPassCount = 0;
+	std::vector<unsigned int> readyPasses;
+	for ( size_t i = 0; i < passCount; ++i )
+	{
+		if ( m_passes[i].isCulled )
+		{
+			++culledPassCount;
+		}
+		else if ( dependencyCounts[i] == 0 )
+		{
+			readyPasses.push_back( static_cast<unsigned int>( i ) );
+		}
+	}
+	while ( !readyPasses.empty() )
+	{
+		const std::vector<unsigned int>::iterator firstReadyPass = std::min_element( readyPasses.begin(), readyPasses.end() );
+		const unsigned int passIndex = *firstReadyPass;
+		readyPasses.erase( firstReadyPass );
+		m_passOrder.push_back( passIndex );
+		for ( std::vector<unsigned int>::const_iterator i = dependents[passIndex].begin(); i != dependents[passIndex].end(); ++i )
+		{
+			if ( --dependencyCounts[*i] == 0 )
+			{
+				readyPasses.push_back( *i );
+			}
+		}
+	}
+
+	m_stats.passCount = static_cast<unsigned int>( passCount );
+	m_stats.culledPassCount = culledPassCount;
+	if ( ( m_passOrder.size() + culledPassCount ) != passCount )
+	{
+		EAE6320_ASSERTF( false, "The render graph has a cycle" );
+		Logging::OutputError( "The render graph couldn't be ordered because %u passes depend on each other",
+			static_cast<unsigned int>( passCount - culledPassCount - m_passOrder.size() ) );
+		return false;
+	}
+	return true;
+}
+
+void eae6320::Graphics::RenderGraph::AssignPhysicalTargets()
+{
+	// Find when each resource is first and last used
+	for ( std::vector<sResource>::iterator i = m_resources.begin(); i != m_resources.end(); ++i )
+	{
+		i->firstUse = i->lastUse = s_invalidIndex;
+		i->physicalTargetIndex = s_invalidIndex;
+	}
+	for ( unsigned int i = 0; i < m_passOrder.size(); ++i )
+	{
+		const sPass& pass = m_passes[m_passOrder[i]];
+		for ( std::vector<unsigned int>::const_iterator j = pass.readIndices.begin(); j != pass.readIndices.end(); ++j )
+		{
+			sResource& resource = m_resources[*j];
+			resource.firstUse = std::min( resource.firstUse, i );
+			resource.lastUse = ( resource.lastUse == s_invalidIndex ) ? i : std::max( resource.lastUse, i );
+		}
+		for ( std::vector<sWrite>::const_iterator j = pass.writes.begin(); j != pass.writes.end(); ++j )
+		{
+			sResource& resource = m_resources[j->resourceIndex];
+			resource.firstUse = std::min( resource.firstUse, i );
+			resource.lastUse = ( resource.lastUse == s_invalidIndex ) ? i : std::max( resource.lastUse, i );
+		}
+	}
+
+	// Assigning targets in the order they start being used
+	// to the first free physical target with the same description
+	// uses the fewest possible physical targets for each description
+	std::vector<sLifetime> lifetimes;
+	size_t memory_withoutAliasing = 0;
+	for ( size_t i = 0; i < m_resources.size(); ++i )
+	{
+		const sResource& resource = m_resources[i];
+		if ( !resource.isImported && ( resource.firstUse != s_invalidIndex ) )
+		{
+			const sLifetime lifetime = { static_cast<unsigned int>( i ), resource.firstUse };
+			lifetimes.push_back( lifetime );
+			memory_withoutAliasing += CalculateMemorySize( resource.description );
+		}
+	}
+	std::stable_sort( lifetimes.begin(), lifetimes.end(), StartsBefore );
+	struct sAliasedTarget
+	{
+		sTargetDescription description;
+		unsigned int lastUse;
+	};
+	std::vector<sAliasedTarget> aliasedTargets;
+	unsigned int physicalTargetCount = 0;
+	for ( std::vector<sLifetime>::const_iterator i = lifetimes.begin(); i != lifetimes.end(); ++i )
+	{
+		sResource& resource = m_resources[i->resourceIndex];
+		unsigned int aliasedTargetIndex = 0;
+		while ( ( aliasedTargetIndex < aliasedTargets.size() )
+			&& ( ( aliasedTargets[aliasedTargetIndex].lastUse >= resource.firstUse )
+				|| !AreDescriptionsEqual( aliasedTargets[aliasedTargetIndex].description, resource.description ) ) )
+		{
+			++aliasedTargetIndex;
+		}
+		if ( aliasedTargetIndex < aliasedTargets.size() )
+		{
+			aliasedTargets[aliasedTargetIndex].lastUse = resource.lastUse;
+		}
+		else
+		{
+			const sAliasedTarget aliasedTarget = { resource.description, resource.lastUse };
+			aliasedTargets.push_back( aliasedTarget );
+		}
+		resource.physicalTargetIndex = m_isAliasingEnabled ? aliasedTargetIndex : physicalTargetCount;
+		++physicalTargetCount;
+	}
+	size_t memory_withAliasing = 0;
+	for ( std::vector<sAliasedTarget>::const_iterator i = aliasedTargets.begin(); i != aliasedTargets.end(); ++i )
+	{
+		memory_withAliasing += CalculateMemorySize( i->description );
+	}
+
+	m_stats.transientTargetCount = static_cast<unsigned int>( lifetimes.size() );
+	m_stats.physicalTargetCount = m_isAliasingEnabled ? static_cast<unsigned int>( aliasedTargets.size() ) : physicalTargetCount;
+	m_stats.transientMemory_withoutAliasing = memory_withoutAliasing;
+	m_stats.transientMemory_withAliasing = memory_withAliasing;
+}
+
+size_t eae6320::Graphics::RenderGraph::CalculateMemorySize( const sTargetDescription& i_description )
+{
+	const size_t bytesPerPixel = ( i_description.format == eTargetFormat::R16G16B16A16_FLOAT ) ? 8 : 4;
+	return static_cast<size_t>( i_description.width ) * i_description.height * bytesPerPixel;
+}
+
+bool eae6320::Graphics::RenderGraph::AreDescriptionsEqual( const sTargetDescription& i_lhs, const sTargetDescription& i_rhs )
+{
+	return ( i_lhs.width == i_rhs.width ) && ( i_lhs.height == i_rhs.height ) && ( i_lhs.format == i_rhs.format );
+}
+
+void eae6320::Graphics::RenderGraph::GetViewportSize( const sPass& i_pass, uint16_t& o_width, uint16_t& o_height ) const
+{
+	// Every target that a pass writes is the same size
+	EAE6320_ASSERT( !i_pass.writes.empty() );
+	const sTargetDescription& description = m_resources[i_pass.writes.front().resourceIndex].description;
+	o_width = ( i_pass.viewportWidth > 0 ) ? std::min( i_pass.viewportWidth, description.width ) : description.width;
+	o_height = ( i_pass.viewportHeight > 0 ) ? std::min( i_pass.viewportHeight, description.height ) : description.height;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool StartsBefore( const sLifetime& i_lhs, const sLifetime& i_rhs )
+	{
+		return i_lhs.firstUse < i_rhs.firstUse;
+	}
+}
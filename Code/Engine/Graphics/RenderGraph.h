@@ -0,0 +1,217 @@
+/*
+	A render graph describes a frame as a list of passes
+	and the render targets that each pass reads and writes
+
+	The graph is rebuilt every frame:
+		* Resources are declared (either "transient" render targets that only exist during the frame
+			or the imported back buffer)
+		* Passes are added, and each one declares what it reads and writes
+		* Compile() culls any pass whose output is never used,
+			orders the passes so that every read happens after the writes it depends on,
+			and assigns each transient target to a physical render target
+		* Execute() binds each pass's targets and calls its function
+
+	Transient targets whose lifetimes (from the first pass that uses them to the last) don't overlap
+	and that have the same description share the same physical render target ("aliasing").
+	The physical render targets are kept from frame to frame so that a graph that doesn't change
+	doesn't create anything after the first frame.
+*/
+
+#ifndef EAE6320_GRAPHICS_RENDERGRAPH_H
+#define EAE6320_GRAPHICS_RENDERGRAPH_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class RenderGraph;
+
+		namespace eTargetFormat
+		{
+			enum eTargetFormat
+			{
+				R8G8B8A8,
+				R16G16B16A16_FLOAT,
+			};
+		}
+
+		struct sTargetDescription
+		{
+			uint16_t width, height;
+			eTargetFormat::eTargetFormat format;
+		};
+
+		// This is called by Execute() with the pass's targets already bound
+		typedef void ( *fExecutePass )( const RenderGraph& i_graph, void* const io_userData );
+
+		class RenderGraph
+		{
+		public:
+
+			// A resource or pass is identified by its index
+			static const unsigned int s_invalidIndex = ~0u;
+
+			// Build
+			//------
+
+			// These are only valid until Reset()
+			unsigned int ImportBackBuffer( const sTargetDescription& i_description );
+			unsigned int CreateTransientTarget( const char* const i_name, const sTargetDescription& i_description );
+			// A pass with side effects is never culled
+			// (a pass that writes the back buffer always has side effects)
+			unsigned int AddPass( const char* const i_name, const fExecutePass i_function, void* const io_userData,
+				const bool i_hasSideEffects = false );
+			// The pass will sample the resource as a texture
+			void Read( const unsigned int i_passIndex, const unsigned int i_resourceIndex );
+			// The pass will render to the resource;
+			// if it should be cleared first the clear color must be provided.
+			// A pass can write more than one target on Direct3D but only one on OpenGL.
+			void Write( const unsigned int i_passIndex, const unsigned int i_resourceIndex, const float* const i_clearColor = NULL );
+			// By default a pass renders to the whole of its targets,
+			// but it can be restricted to the top-left (Direct3D) or bottom-left (OpenGL) corner
+			// so that a target doesn't have to be recreated when the size that is rendered changes
+			void SetViewport( const unsigned int i_passIndex, const uint16_t i_width, const uint16_t i_height );
+
+			// Compile
+			//--------
+
+			bool Compile();
+
+			// When aliasing is disabled every transient target gets its own physical render target
+			// (the statistics report both cases regardless)
+			void SetIsAliasingEnabled( const bool i_isAliasingEnabled ) { m_isAliasingEnabled = i_isAliasingEnabled; }
+
+			// Execute
+			//--------
+
+			bool Execute();
+
+			// This is called by a pass's function to sample a resource that the pass reads
+			void BindTexture( const unsigned int i_resourceIndex, const unsigned int i_textureUnit ) const;
+
+			// Statistics
+			//-----------
+
+			// These are calculated by Compile()
+			struct sStats
+			{
+				unsigned int passCount;
+				unsigned int culledPassCount;
+				unsigned int transientTargetCount;
+				unsigned int physicalTargetCount;
+				// The memory that all of the transient targets would need without aliasing
+				size_t transientMemory_withoutAliasing;
+				// The memory that the physical targets that the transient targets are aliased to need
+				size_t transientMemory_withAliasing;
+			};
+			const sStats& GetStats() const { return m_stats; }
+			void LogStats() const;
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// This forgets the passes and resources but keeps the physical render targets for the next frame
+			void Reset();
+			bool CleanUp();
+
+			RenderGraph();
+			~RenderGraph();
+
+			// Implementation
+			//===============
+
+		private:
+
+			struct sResource
+			{
+				const char* name;
+				sTargetDescription description;
+				// The passes that write the resource, in the order they were added
+				std::vector<unsigned int> writerIndices;
+				unsigned int readerCount;
+				// These are indices into m_passOrder
+				unsigned int firstUse, lastUse;
+				unsigned int physicalTargetIndex;
+				bool isImported;
+			};
+			struct sWrite
+			{
+				unsigned int resourceIndex;
+				float clearColor[4];
+				bool shouldBeCleared;
+			};
+			struct sPass
+			{
+				const char* name;
+				fExecutePass function;
+				void* userData;
+				std::vector<unsigned int> readIndices;
+				std::vector<sWrite> writes;
+				// Zero means the whole target
+				uint16_t viewportWidth, viewportHeight;
+				unsigned int referenceCount;
+				bool hasSideEffects;
+				bool isCulled;
+			};
+			struct sPhysicalTarget
+			{
+				sTargetDescription description;
+#if defined( EAE6320_PLATFORM_D3D )
+				ID3D11Texture2D* texture;
+				ID3D11RenderTargetView* renderTargetView;
+				ID3D11ShaderResourceView* shaderResourceView;
+#elif defined( EAE6320_PLATFORM_GL )
+				GLuint textureId;
+				GLuint framebufferId;
+#endif
+			};
+
+			void CullPasses();
+			bool OrderPasses();
+			void AssignPhysicalTargets();
+
+			static size_t CalculateMemorySize( const sTargetDescription& i_description );
+			static bool AreDescriptionsEqual( const sTargetDescription& i_lhs, const sTargetDescription& i_rhs );
+
+			// Platform-specific
+			static bool CreatePhysicalTarget( sPhysicalTarget& io_target );
+			static bool DestroyPhysicalTarget( sPhysicalTarget& io_target );
+			void BindTargets( const sPass& i_pass ) const;
+
+			void GetViewportSize( const sPass& i_pass, uint16_t& o_width, uint16_t& o_height ) const;
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<sResource> m_resources;
+			std::vector<sPass> m_passes;
+			// The indices of the passes that weren't culled, in the order they will be executed
+			std::vector<unsigned int> m_passOrder;
+			std::vector<sPhysicalTarget> m_physicalTargets;
+			sStats m_stats;
+			unsigned int m_backBufferIndex;
+			bool m_isAliasingEnabled;
+			bool m_isCompiled;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_RENDERGRAPH_H
@@ -0,0 +1,221 @@
+// Header Files
+//=============
+
+#include "ShaderLibrary.h"
+
+#include <cstring>
+#include <sstream>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+std::map<std::string, eae6320::Graphics::ShaderLibrary*> eae6320::Graphics::ShaderLibrary::s_libraries;
+
+// Interface
+//==========
+
+// Access
+//-------
+
+bool eae6320::Graphics::ShaderLibrary::Find( const uint64_t i_key, const void*& o_data, size_t& o_size )
+{
+	// The slot table is never full, and so this always ends at either the key or an empty slot
+	const uint32_t slotMask = m_header->slotCount - 1;
+	for ( uint32_t slotIndex = ShaderLibraryFormats::CalculateSlotIndex( i_key, m_header->slotCount ); ;
+		slotIndex = ( slotIndex + 1 ) & slotMask )
+	{
+		const ShaderLibraryFormats::sSlot& slot = m_slots[slotIndex];
+		if ( slot.variantIndex == ShaderLibraryFormats::s_invalidIndex )
+		{
+			return false;
+		}
+		else if ( slot.key == i_key )
+		{
+			const ShaderLibraryFormats::sBlob& blob = m_blobs[m_variants[slot.variantIndex].blobIndex];
+			o_data = reinterpret_cast<const uint8_t*>( m_file.data ) + blob.offset;
+			o_size = blob.size;
+			m_wereVariantsRequested[slot.variantIndex] = true;
+			return true;
+		}
+	}
+}
+
+eae6320::Graphics::ShaderLibraryFormats::eShaderType::eShaderType eae6320::Graphics::ShaderLibrary::GetShaderType() const
+{
+	return static_cast<ShaderLibraryFormats::eShaderType::eShaderType>( m_header->shaderType );
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+eae6320::Graphics::ShaderLibrary* eae6320::Graphics::ShaderLibrary::Load( const char* const i_path )
+{
+	// If the library has already been loaded it can be shared
+	{
+		const std::map<std::string, ShaderLibrary*>::iterator loadedLibrary = s_libraries.find( i_path );
+		if ( loadedLibrary != s_libraries.end() )
+		{
+			++loadedLibrary->second->m_referenceCount;
+			return loadedLibrary->second;
+		}
+	}
+
+	bool wereThereErrors = false;
+
+	ShaderLibrary* library = new ShaderLibrary;
+	library->m_path = i_path;
+	{
+		std::string errorMessage;
+		if ( !Platform::MapBinaryFile( i_path, library->m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to map the shader library %s: %s", i_path, errorMessage.c_str() );
+			goto OnExit;
+		}
+	}
+	// Validate the file
+	{
+		const uint8_t* const fileData = reinterpret_cast<const uint8_t*>( library->m_file.data );
+		const size_t fileSize = library->m_file.size;
+		const ShaderLibraryFormats::sHeader* const header = reinterpret_cast<const ShaderLibraryFormats::sHeader*>( fileData );
+		if ( ( fileSize < sizeof( ShaderLibraryFormats::sHeader ) )
+			|| ( header->fourCc != ShaderLibraryFormats::s_fourCc ) || ( header->version != ShaderLibraryFormats::s_version ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Invalid shader library file" );
+			Logging::OutputError( "The shader library %s isn't a built shader library (or was built by a different version of the ShaderBuilder)",
+				i_path );
+			goto OnExit;
+		}
+		// The slot table must have at least one empty slot for a search to stop at
+		const bool isSlotCountValid = ( header->slotCount > header->variantCount ) && ( ( header->slotCount & ( header->slotCount - 1 ) ) == 0 );
+		if ( !isSlotCountValid
+			|| ( fileSize < ( header->axesOffset + ( static_cast<size_t>( header->axisCount ) * sizeof( ShaderLibraryFormats::sAxis ) ) ) )
+			|| ( fileSize < ( header->variantsOffset + ( static_cast<size_t>( header->variantCount ) * sizeof( ShaderLibraryFormats::sVariant ) ) ) )
+			|| ( fileSize < ( header->slotsOffset + ( static_cast<size_t>( header->slotCount ) * sizeof( ShaderLibraryFormats::sSlot ) ) ) )
+			|| ( fileSize < ( header->blobsOffset + ( static_cast<size_t>( header->blobCount ) * sizeof( ShaderLibraryFormats::sBlob ) ) ) ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Truncated shader library file" );
+			Logging::OutputError( "The shader library %s is shorter than its header says it should be", i_path );
+			goto OnExit;
+		}
+		library->m_header = header;
+		library->m_axes = reinterpret_cast<const ShaderLibraryFormats::sAxis*>( fileData + header->axesOffset );
+		library->m_variants = reinterpret_cast<const ShaderLibraryFormats::sVariant*>( fileData + header->variantsOffset );
+		library->m_slots = reinterpret_cast<const ShaderLibraryFormats::sSlot*>( fileData + header->slotsOffset );
+		library->m_blobs = reinterpret_cast<const ShaderLibraryFormats::sBlob*>( fileData + header->blobsOffset );
+		for ( uint32_t i = 0; i < header->blobCount; ++i )
+		{
+			if ( fileSize < ( static_cast<size_t>( library->m_blobs[i].offset ) + library->m_blobs[i].size ) )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, "Truncated shader library file" );
+				Logging::OutputError( "The shader library %s is shorter than its header says it should be", i_path );
+				goto OnExit;
+			}
+		}
+		for ( uint32_t i = 0; i < header->variantCount; ++i )
+		{
+			if ( library->m_variants[i].blobIndex >= header->blobCount )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, "Invalid shader library file" );
+				Logging::OutputError( "The shader library %s has a variant without a shader", i_path );
+				goto OnExit;
+			}
+		}
+		library->m_wereVariantsRequested.resize( header->variantCount, false );
+	}
+	library->m_referenceCount = 1;
+	s_libraries.insert( std::make_pair( library->m_path, library ) );
+
+OnExit:
+
+	if ( wereThereErrors )
+	{
+		// Release() can't be used because the library was never added to s_libraries
+		delete library;
+		library = NULL;
+	}
+
+	return library;
+}
+
+void eae6320::Graphics::ShaderLibrary::Release()
+{
+	EAE6320_ASSERT( m_referenceCount > 0 );
+	if ( --m_referenceCount == 0 )
+	{
+		LogUnrequestedVariants();
+		s_libraries.erase( m_path );
+		delete this;
+	}
+}
+
+// Implementation
+//===============
+
+// Initialization / Clean Up
+//--------------------------
+
+eae6320::Graphics::ShaderLibrary::ShaderLibrary()
+	:
+	m_header( NULL ), m_axes( NULL ), m_variants( NULL ), m_slots( NULL ), m_blobs( NULL ), m_referenceCount( 0 )
+{
+
+}
+
+eae6320::Graphics::ShaderLibrary::~ShaderLibrary()
+{
+	if ( m_file.data )
+	{
+		std::string errorMessage;
+		if ( !Platform::UnmapBinaryFile( m_file, &errorMessage ) )
+		{
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to unmap the shader library %s: %s", m_path.c_str(), errorMessage.c_str() );
+		}
+	}
+}
+
+// Logging
+//--------
+
+void eae6320::Graphics::ShaderLibrary::LogUnrequestedVariants() const
+{
+	const uint32_t variantCount = m_header->variantCount;
+	uint32_t unrequestedVariantCount = 0;
+	for ( uint32_t i = 0; i < variantCount; ++i )
+	{
+		unrequestedVariantCount += m_wereVariantsRequested[i] ? 0 : 1;
+	}
+	if ( unrequestedVariantCount == 0 )
+	{
+		return;
+	}
+
+	Logging::OutputMessage( "%u of the %u permutations in the shader library %s were never requested:",
+		unrequestedVariantCount, variantCount, m_path.c_str() );
+	const uint8_t* const fileData = reinterpret_cast<const uint8_t*>( m_file.data );
+	for ( uint32_t i = 0; i < variantCount; ++i )
+	{
+		if ( !m_wereVariantsRequested[i] )
+		{
+			// The key is decoded back into the #defines that the permutation was compiled with
+			std::ostringstream description;
+			for ( uint8_t j = 0; j < m_header->axisCount; ++j )
+			{
+				const ShaderLibraryFormats::sAxis& axis = m_axes[j];
+				const unsigned int valueIndex = ShaderLibraryFormats::GetValueIndex( axis, m_variants[i].key );
+				int32_t value;
+				memcpy( &value, fileData + axis.valuesOffset + ( valueIndex * sizeof( int32_t ) ), sizeof( value ) );
+				description << ( ( j > 0 ) ? " " : "" ) << reinterpret_cast<const char*>( fileData + axis.nameOffset ) << "=" << value;
+			}
+			Logging::OutputMessage( "\t%s (key 0x%016llx)", description.str().c_str(), static_cast<unsigned long long>( m_variants[i].key ) );
+		}
+	}
+}
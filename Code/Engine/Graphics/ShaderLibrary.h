@@ -0,0 +1,87 @@
+/*
+	A shader library has every permutation of a shader,
+	built by the ShaderBuilder
+
+	A permutation is found by its 64-bit key in constant time
+	(the library has a hash table that was built offline and is used as-is from the mapped file).
+	The library remembers which permutations were requested,
+	and when it is released it logs the ones that never were
+	so that axes (or values) that the game doesn't need can be removed from the authored shader.
+*/
+
+#ifndef EAE6320_GRAPHICS_SHADERLIBRARY_H
+#define EAE6320_GRAPHICS_SHADERLIBRARY_H
+
+// Header Files
+//=============
+
+#include <map>
+#include <string>
+#include <vector>
+#include "ShaderLibraryFormats.h"
+#include "../Platform/Platform.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class ShaderLibrary
+		{
+		public:
+
+			// Access
+			//-------
+
+			// This returns false if the library doesn't have a permutation with the key;
+			// otherwise the data is a compiled shader on Direct3D and source code on OpenGL
+			// and is valid until the library is released
+			bool Find( const uint64_t i_key, const void*& o_data, size_t& o_size );
+
+			ShaderLibraryFormats::eShaderType::eShaderType GetShaderType() const;
+			const char* GetPath() const { return m_path.c_str(); }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// If the library has already been loaded it is returned (with another reference) instead.
+			// Every successful Load() must be matched by a Release().
+			static ShaderLibrary* Load( const char* const i_path );
+			void Release();
+
+			// Implementation
+			//===============
+
+		private:
+
+			ShaderLibrary();
+			~ShaderLibrary();
+
+			void LogUnrequestedVariants() const;
+
+			// Data
+			//=====
+
+		private:
+
+			Platform::sMappedFile m_file;
+			// These point into the mapped file
+			const ShaderLibraryFormats::sHeader* m_header;
+			const ShaderLibraryFormats::sAxis* m_axes;
+			const ShaderLibraryFormats::sVariant* m_variants;
+			const ShaderLibraryFormats::sSlot* m_slots;
+			const ShaderLibraryFormats::sBlob* m_blobs;
+			// This has an entry for every variant
+			std::vector<bool> m_wereVariantsRequested;
+			std::string m_path;
+			unsigned int m_referenceCount;
+
+			// Everything that is currently loaded, keyed by path
+			static std::map<std::string, ShaderLibrary*> s_libraries;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_SHADERLIBRARY_H
@@ -0,0 +1,135 @@
+/*
+	This file describes the layout of a built shader library file
+
+	It is shared between the ShaderBuilder (which writes the file)
+	and the runtime ShaderLibrary (which reads it),
+	and so it must not depend on any graphics platform
+	(although the compiled shaders that it contains do).
+
+	An authored shader declares "permutation axes",
+	each of which is a #define that can have one of a small list of values.
+	The ShaderBuilder compiles every combination of values,
+	and identifies each combination by a 64-bit key
+	made by packing the index of each axis's value into its own range of bits.
+	A built shader library is:
+		* An sHeader
+		* An sAxis for every axis,
+			followed by the int32_t values of every axis
+		* An sVariant for every combination of values
+		* An sSlot table that the runtime uses to find a variant from its key
+		* An sBlob for every unique compiled shader
+			(combinations that compile to identical output share a blob)
+		* The NULL-terminated axis names
+		* The compiled shaders
+	All offsets are from the start of the file.
+*/
+
+#ifndef EAE6320_GRAPHICS_SHADERLIBRARYFORMATS_H
+#define EAE6320_GRAPHICS_SHADERLIBRARYFORMATS_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace ShaderLibraryFormats
+		{
+			// "ESHL" read as a little-endian uint32_t
+			const uint32_t s_fourCc = 0x4c485345;
+			const uint16_t s_version = 1;
+
+			// A key can't use more bits than this
+			const unsigned int s_maxKeyBitCount = 64;
+			// An empty slot has this instead of a variant index
+			const uint32_t s_invalidIndex = 0xffffffff;
+
+			namespace eShaderType
+			{
+				enum eShaderType
+				{
+					Vertex,
+					Fragment,
+				};
+			}
+
+			struct sHeader
+			{
+				uint32_t fourCc;
+				uint16_t version;
+				uint8_t shaderType;
+				uint8_t axisCount;
+				uint32_t variantCount;
+				uint32_t blobCount;
+				// This is always a power of two
+				uint32_t slotCount;
+				uint32_t axesOffset;
+				uint32_t variantsOffset;
+				uint32_t slotsOffset;
+				uint32_t blobsOffset;
+				uint32_t padding;
+			};
+
+			struct sAxis
+			{
+				uint32_t nameOffset;
+				// The offset of valueCount int32_t values
+				uint32_t valuesOffset;
+				uint16_t valueCount;
+				// The index of the axis's value is stored in these bits of a key
+				uint8_t bitOffset;
+				uint8_t bitCount;
+			};
+
+			struct sVariant
+			{
+				uint64_t key;
+				uint32_t blobIndex;
+				uint32_t padding;
+			};
+
+			// The slots are an open-addressed hash table:
+			// A key's first slot is CalculateSlotIndex()
+			// and if that slot has a different key the following slots are checked in order
+			// (wrapping around) until either the key or an empty slot is found.
+			// The table is built with at most half of the slots used,
+			// and so a lookup almost always only needs to check one or two slots.
+			struct sSlot
+			{
+				uint64_t key;
+				uint32_t variantIndex;
+				uint32_t padding;
+			};
+
+			struct sBlob
+			{
+				uint32_t offset;
+				uint32_t size;
+			};
+
+			// Helper Functions
+			//-----------------
+
+			// Keys are made of small packed indices and so similar keys differ only in their low bits;
+			// multiplying by 2^64 / phi ("Fibonacci hashing") spreads them out into the high bits
+			inline uint32_t CalculateSlotIndex( const uint64_t i_key, const uint32_t i_slotCount )
+			{
+				return static_cast<uint32_t>( ( i_key * 11400714819323198485ull ) >> 32 ) & ( i_slotCount - 1 );
+			}
+
+			inline unsigned int GetValueIndex( const sAxis& i_axis, const uint64_t i_key )
+			{
+				const uint64_t mask = ( i_axis.bitCount < 64 ) ? ( ( 1ull << i_axis.bitCount ) - 1 ) : ~0ull;
+				return static_cast<unsigned int>( ( i_key >> i_axis.bitOffset ) & mask );
+			}
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_SHADERLIBRARYFORMATS_H
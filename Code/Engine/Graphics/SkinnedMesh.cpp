@@ -0,0 +1,345 @@
+// Header Files
+//=============
+
+#include "SkinnedMesh.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "Includes.h"
+#include "Statistics.h"
+#include "../Animation/AnimationClip.h"
+#include "../Animation/Animator.h"
+#include "../Animation/Skeleton.h"
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Batches must be a multiple of 4 so that every batch starts where the SSE kernel expects
+	const unsigned int s_skinningBatchSize = 4 * 1024;
+
+	// The benchmark skins each character in a single batch
+	struct sBenchmarkSkinningData
+	{
+		const eae6320::Animation::SkinnedVertices* vertices;
+		const eae6320::Animation::Animator* animators;
+		eae6320::Graphics::sVertex* output;
+		bool shouldScalarKernelBeUsed;
+	};
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	uint32_t GetNextRandomNumber( uint32_t& io_state );
+	// This is a Jobs::fJob that skins a batch of characters for the benchmark
+	void SkinBenchmarkCharacters( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+bool eae6320::Graphics::SkinnedMesh::Draw()
+{
+	const unsigned int vertexCount = m_vertices.GetVertexCount();
+	if ( vertexCount == 0 )
+	{
+		return true;
+	}
+
+	// Skin the vertices straight into the vertex buffer
+	// (there is no intermediate copy of the skinned vertices on the CPU)
+	{
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		sVertex* const vertices = MapVertexBuffer();
+		if ( vertices == NULL )
+		{
+			EAE6320_ASSERT( false );
+			return false;
+		}
+		m_mappedVertices = vertices;
+		Jobs::ParallelFor( vertexCount, s_skinningBatchSize, SkinBatch, this );
+		m_mappedVertices = NULL;
+		UnmapVertexBuffer();
+		EAE6320_GRAPHICS_STATISTICS( CountUpload( vertexCount * sizeof( sVertex ) ) );
+		m_stats.secondCountSkinning = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	}
+
+	DrawVertexBuffer();
+
+	return true;
+}
+
+// Benchmark
+//----------
+
+void eae6320::Graphics::SkinnedMesh::LogSkinningCost()
+{
+	const unsigned int characterCount = 256;
+	const unsigned int vertexCountPerCharacter = 4 * 1024;
+	const unsigned int frameCount = 30;
+	const float secondCountPerFrame = 1.0f / 60.0f;
+	const unsigned int boneCounts[] = { 32, 64, 128 };
+	const float boneLength = 0.1f;
+
+	Logging::OutputMessage( "Animating and skinning %u characters of %u vertices each on %u worker threads (and the calling thread):",
+		characterCount, vertexCountPerCharacter, Jobs::GetWorkerThreadCount() );
+	for ( unsigned int b = 0; b < ( sizeof( boneCounts ) / sizeof( *boneCounts ) ); ++b )
+	{
+		const unsigned int boneCount = boneCounts[b];
+		uint32_t randomState = 0x9e3779b9u ^ boneCount;
+
+		// Every bone branches off of the one halfway back towards the root,
+		// which gives a bushy hierarchy that is only a few bones deep
+		Animation::Skeleton skeleton;
+		{
+			std::vector<uint16_t> parentIndices( boneCount );
+			std::vector<Animation::sTransform> bindPose( boneCount );
+			for ( unsigned int i = 0; i < boneCount; ++i )
+			{
+				parentIndices[i] = ( i == 0 ) ? Animation::Skeleton::s_noParent : static_cast<uint16_t>( ( i - 1 ) / 2 );
+				Animation::SetRotationZ( 0.0f, ( i == 0 ) ? 0.0f : boneLength, 0.0f, bindPose[i] );
+			}
+			if ( !skeleton.Initialize( &parentIndices[0], &bindPose[0], boneCount ) )
+			{
+				return;
+			}
+		}
+		// The two clips swing every bone back and forth at different speeds
+		Animation::AnimationClip clips[2];
+		{
+			const unsigned int keyCount = 30;
+			const float keysPerSecond = 30.0f;
+			std::vector<Animation::sTransform> keys( keyCount * boneCount );
+			for ( unsigned int c = 0; c < 2; ++c )
+			{
+				for ( unsigned int k = 0; k < keyCount; ++k )
+				{
+					for ( unsigned int i = 0; i < boneCount; ++i )
+					{
+						const float phase = ( ( 6.28318530718f * ( c + 1 ) * k ) / keyCount ) + ( i * 0.5f );
+						Animation::SetRotationZ( 0.3f * std::sin( phase ), ( i == 0 ) ? 0.0f : boneLength, 0.0f,
+							keys[( k * boneCount ) + i] );
+					}
+				}
+				if ( !clips[c].Initialize( &keys[0], boneCount, keyCount, keysPerSecond ) )
+				{
+					return;
+				}
+			}
+		}
+		// Every character uses the same mesh
+		// (each vertex is influenced by a bone and three of its neighbors)
+		Animation::SkinnedVertices vertices;
+		{
+			std::vector<Animation::sSkinnedVertex> bindPoseVertices( vertexCountPerCharacter );
+			for ( unsigned int i = 0; i < vertexCountPerCharacter; ++i )
+			{
+				Animation::sSkinnedVertex& vertex = bindPoseVertices[i];
+				vertex.x = static_cast<float>( GetNextRandomNumber( randomState ) & 0xffff ) / 65536.0f;
+				vertex.y = static_cast<float>( GetNextRandomNumber( randomState ) & 0xffff ) / 65536.0f;
+				vertex.z = static_cast<float>( GetNextRandomNumber( randomState ) & 0xffff ) / 65536.0f;
+				const unsigned int boneIndex = GetNextRandomNumber( randomState ) % boneCount;
+				for ( unsigned int j = 0; j < 4; ++j )
+				{
+					vertex.boneIndices[j] = static_cast<uint8_t>( ( boneIndex + j ) % boneCount );
+					vertex.boneWeights[j] = static_cast<float>( ( GetNextRandomNumber( randomState ) & 0xff ) + 1 );
+				}
+			}
+			if ( !vertices.Initialize( &bindPoseVertices[0], vertexCountPerCharacter, boneCount ) )
+			{
+				return;
+			}
+		}
+		std::vector<Animation::Animator> animators( characterCount );
+		std::vector<Animation::Animator*> animatorPointers( characterCount );
+		for ( unsigned int i = 0; i < characterCount; ++i )
+		{
+			if ( !animators[i].Initialize( skeleton ) )
+			{
+				vertices.CleanUp();
+				return;
+			}
+			animators[i].SetClips( &clips[0], &clips[1] );
+			animators[i].SetBlendWeight( static_cast<float>( i ) / characterCount );
+			animators[i].SetPlaybackRate( 0.5f + ( static_cast<float>( i % 16 ) / 16.0f ) );
+			animatorPointers[i] = &animators[i];
+		}
+		std::vector<sVertex> output_simd( characterCount * vertexCountPerCharacter );
+		std::vector<sVertex> output_scalar( characterCount * vertexCountPerCharacter );
+
+		// Animate
+		double secondCount_animating;
+		{
+			const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+			for ( unsigned int f = 0; f < frameCount; ++f )
+			{
+				Animation::Animator::UpdateAll( &animatorPointers[0], characterCount, secondCountPerFrame );
+			}
+			secondCount_animating = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+		}
+		// Skin
+		double secondCounts_skinning[2];
+		for ( unsigned int k = 0; k < 2; ++k )
+		{
+			const bool shouldScalarKernelBeUsed = k == 1;
+			sBenchmarkSkinningData skinningData = { &vertices, &animators[0],
+				shouldScalarKernelBeUsed ? &output_scalar[0] : &output_simd[0], shouldScalarKernelBeUsed };
+			const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+			for ( unsigned int f = 0; f < frameCount; ++f )
+			{
+				const unsigned int charactersPerBatch = 1;
+				Jobs::ParallelFor( characterCount, charactersPerBatch, SkinBenchmarkCharacters, &skinningData );
+			}
+			secondCounts_skinning[k] = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+		}
+		// Both kernels should give the same results (within rounding)
+		float maxDifference = 0.0f;
+		for ( size_t i = 0; i < output_simd.size(); ++i )
+		{
+			const float differenceX = std::abs( output_simd[i].x - output_scalar[i].x );
+			const float differenceY = std::abs( output_simd[i].y - output_scalar[i].y );
+			maxDifference = ( differenceX > maxDifference ) ? differenceX : maxDifference;
+			maxDifference = ( differenceY > maxDifference ) ? differenceY : maxDifference;
+		}
+
+		const double characterFrameCount = static_cast<double>( characterCount * frameCount );
+		const double millisecondCount_animating = secondCount_animating * 1000.0;
+		const double millisecondCount_skinning = secondCounts_skinning[0] * 1000.0;
+		const double millisecondCount_skinning_scalar = secondCounts_skinning[1] * 1000.0;
+		Logging::OutputMessage( "\t%u bones: %.1f characters per millisecond (%.1f animating, %.1f skinning with SSE"
+			", %.1f skinning with scalar code which is %.2fx slower; the kernels differ by at most %g)",
+			boneCount, characterFrameCount / ( millisecondCount_animating + millisecondCount_skinning ),
+			characterFrameCount / millisecondCount_animating, characterFrameCount / millisecondCount_skinning,
+			characterFrameCount / millisecondCount_skinning_scalar, secondCounts_skinning[1] / secondCounts_skinning[0],
+			maxDifference );
+
+		for ( unsigned int i = 0; i < characterCount; ++i )
+		{
+			animators[i].CleanUp();
+		}
+		vertices.CleanUp();
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::SkinnedMesh::Initialize( const Animation::sSkinnedVertex* const i_vertices, const unsigned int i_vertexCount,
+	const Animation::Animator& i_animator )
+{
+	EAE6320_ASSERTF( m_animator == NULL, "A skinned mesh can't be initialized twice" );
+	EAE6320_ASSERT( i_animator.GetSkeleton() );
+	if ( ( i_vertexCount == 0 ) || ( ( i_vertexCount % 3 ) != 0 ) )
+	{
+		EAE6320_ASSERT( false );
+		Logging::OutputError( "A skinned mesh must be a list of triangles (it can't have %u vertices)", i_vertexCount );
+		return false;
+	}
+
+	m_animator = &i_animator;
+	memset( &m_stats, 0, sizeof( m_stats ) );
+	if ( !m_vertices.Initialize( i_vertices, i_vertexCount, i_animator.GetSkeleton()->GetBoneCount() ) )
+	{
+		CleanUp();
+		return false;
+	}
+	if ( !CreateVertexBuffer() )
+	{
+		EAE6320_ASSERT( false );
+		CleanUp();
+		return false;
+	}
+	m_vertexBufferSize = i_vertexCount * sizeof( sVertex );
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+
+	return true;
+}
+
+bool eae6320::Graphics::SkinnedMesh::CleanUp()
+{
+	const bool wereThereErrors = !DestroyVertexBuffer();
+	if ( m_vertexBufferSize != 0 )
+	{
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+		m_vertexBufferSize = 0;
+	}
+	m_vertices.CleanUp();
+	m_animator = NULL;
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::SkinnedMesh::SkinnedMesh()
+	:
+	m_animator( NULL ), m_mappedVertices( NULL ), m_vertexBufferSize( 0 ),
+#if defined( EAE6320_PLATFORM_D3D )
+	m_vertexBuffer( NULL )
+#elif defined( EAE6320_PLATFORM_GL )
+	m_vertexArrayId( 0 ), m_vertexBufferId( 0 )
+#endif
+{
+	memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+eae6320::Graphics::SkinnedMesh::~SkinnedMesh()
+{
+	EAE6320_ASSERTF( m_animator == NULL, "A skinned mesh was destroyed without being cleaned up" );
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::SkinnedMesh::SkinBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+{
+	const SkinnedMesh& mesh = *reinterpret_cast<const SkinnedMesh*>( io_userData );
+	const unsigned int componentCount = 2;
+	mesh.m_vertices.Skin( mesh.m_animator->GetSkinningMatrices(), i_begin, i_end,
+		mesh.m_mappedVertices, sizeof( sVertex ), componentCount );
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	uint32_t GetNextRandomNumber( uint32_t& io_state )
+	{
+		// xorshift32
+		io_state ^= io_state << 13;
+		io_state ^= io_state >> 17;
+		io_state ^= io_state << 5;
+		return io_state;
+	}
+
+	void SkinBenchmarkCharacters( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+	{
+		const sBenchmarkSkinningData& skinningData = *reinterpret_cast<const sBenchmarkSkinningData*>( io_userData );
+		const unsigned int vertexCount = skinningData.vertices->GetVertexCount();
+		const unsigned int componentCount = 2;
+		for ( unsigned int i = i_begin; i < i_end; ++i )
+		{
+			const float* const skinningMatrices = skinningData.animators[i].GetSkinningMatrices();
+			eae6320::Graphics::sVertex* const output = skinningData.output + ( i * vertexCount );
+			if ( !skinningData.shouldScalarKernelBeUsed )
+			{
+				skinningData.vertices->Skin( skinningMatrices, 0, vertexCount, output, sizeof( *output ), componentCount );
+			}
+			else
+			{
+				skinningData.vertices->Skin_scalar( skinningMatrices, 0, vertexCount, output, sizeof( *output ), componentCount );
+			}
+		}
+	}
+}
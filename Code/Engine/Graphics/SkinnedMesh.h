@@ -0,0 +1,134 @@
+/*
+	A skinned mesh is a triangle list whose vertices follow an animator's skeleton
+
+	The bind-pose vertices (with their bone indices and weights) stay on the CPU,
+	and every frame they are skinned with the animator's current skinning matrices
+	straight into a dynamic vertex buffer.
+	Skinning is split across the job worker threads, 4 vertices at a time with SSE
+	(see SkinnedVertices.h in the Animation project).
+
+	The vertex buffer uses the sVertex layout so that skinned meshes can use the same materials as meshes,
+	and so the skinned z component is dropped.
+*/
+
+#ifndef EAE6320_GRAPHICS_SKINNEDMESH_H
+#define EAE6320_GRAPHICS_SKINNEDMESH_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include "../Animation/SkinnedVertices.h"
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Forward Declarations
+//=====================
+
+namespace eae6320
+{
+	namespace Animation
+	{
+		class Animator;
+	}
+	namespace Graphics
+	{
+		struct sVertex;
+	}
+}
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class SkinnedMesh
+		{
+		public:
+
+			// These can be used to profile the mesh
+			struct sStats
+			{
+				double secondCountSkinning;
+			};
+
+			// Render
+			//-------
+
+			// This must be called from the render thread
+			// (it skins the vertices straight into the mapped vertex buffer)
+			bool Draw();
+
+			// Access
+			//-------
+
+			const sStats& GetStats() const { return m_stats; }
+			unsigned int GetVertexCount() const { return m_vertices.GetVertexCount(); }
+
+			// Benchmark
+			//----------
+
+			// This animates and skins many characters for skeletons of 32, 64, and 128 bones
+			// and logs how many characters are updated per millisecond
+			// (and how much faster the SSE skinning kernel is than the scalar one)
+			static void LogSkinningCost();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// Every 3 vertices are a triangle.
+			// The animator must stay valid for as long as the mesh is drawn,
+			// and it must be updated before the mesh is drawn each frame.
+			bool Initialize( const Animation::sSkinnedVertex* const i_vertices, const unsigned int i_vertexCount,
+				const Animation::Animator& i_animator );
+			bool CleanUp();
+
+			SkinnedMesh();
+			~SkinnedMesh();
+
+			// Implementation
+			//===============
+
+		private:
+
+			// Platform-specific
+			bool CreateVertexBuffer();
+			bool DestroyVertexBuffer();
+			sVertex* MapVertexBuffer();
+			void UnmapVertexBuffer();
+			void DrawVertexBuffer();
+
+			static void SkinBatch( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+
+			// Data
+			//=====
+
+		private:
+
+			Animation::SkinnedVertices m_vertices;
+			const Animation::Animator* m_animator;
+			sStats m_stats;
+
+			// The mapped buffer is stored so that the job batches can write to it
+			sVertex* m_mappedVertices;
+			// This is only used for statistics
+			size_t m_vertexBufferSize;
+
+#if defined( EAE6320_PLATFORM_D3D )
+			ID3D11Buffer* m_vertexBuffer;
+#elif defined( EAE6320_PLATFORM_GL )
+			GLuint m_vertexArrayId;
+			GLuint m_vertexBufferId;
+#endif
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_SKINNEDMESH_H
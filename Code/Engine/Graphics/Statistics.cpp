@@ -0,0 +1,176 @@
+// Header Files
+//=============
+
+#include "Statistics.h"
+
+#ifdef EAE6320_GRAPHICS_ARESTATISTICSTRACKED
+
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	const char* const s_resourceTypeNames[eae6320::Graphics::Statistics::eResourceType::Count] =
+	{
+		"vertex buffers", "index buffers", "constant buffers", "shader resource buffers", "textures"
+	};
+
+	eae6320::Graphics::Statistics::sMemory s_memory = { 0 };
+	// The frame that is being rendered and the one that was rendered most recently
+	eae6320::Graphics::Statistics::sFrame s_currentFrame = { 0 };
+	eae6320::Graphics::Statistics::sFrame s_previousFrame = { 0 };
+	uint64_t s_frameCount = 0;
+	unsigned int s_logPeriodInFrames = 0;
+}
+
+// Interface
+//==========
+
+// Count
+//------
+
+void eae6320::Graphics::Statistics::CountAllocation( const eResourceType::eResourceType i_type, const size_t i_byteCount )
+{
+	EAE6320_ASSERT( i_type < eResourceType::Count );
+	s_memory.byteCount[i_type] += i_byteCount;
+	if ( s_memory.byteCount[i_type] > s_memory.maxByteCount[i_type] )
+	{
+		s_memory.maxByteCount[i_type] = s_memory.byteCount[i_type];
+	}
+	++s_memory.allocationCount[i_type];
+}
+
+void eae6320::Graphics::Statistics::CountFree( const eResourceType::eResourceType i_type, const size_t i_byteCount )
+{
+	EAE6320_ASSERT( i_type < eResourceType::Count );
+	EAE6320_ASSERTF( ( s_memory.byteCount[i_type] >= i_byteCount ) && ( s_memory.allocationCount[i_type] > 0 ),
+		"More %s were freed than were allocated", s_resourceTypeNames[i_type] );
+	s_memory.byteCount[i_type] -= i_byteCount;
+	--s_memory.allocationCount[i_type];
+}
+
+void eae6320::Graphics::Statistics::CountResize( const eResourceType::eResourceType i_type,
+	const size_t i_byteCount_old, const size_t i_byteCount_new )
+{
+	EAE6320_ASSERT( i_type < eResourceType::Count );
+	EAE6320_ASSERTF( ( s_memory.byteCount[i_type] >= i_byteCount_old ) && ( s_memory.allocationCount[i_type] > 0 ),
+		"More %s were resized than were allocated", s_resourceTypeNames[i_type] );
+	s_memory.byteCount[i_type] = ( s_memory.byteCount[i_type] - i_byteCount_old ) + i_byteCount_new;
+	if ( s_memory.byteCount[i_type] > s_memory.maxByteCount[i_type] )
+	{
+		s_memory.maxByteCount[i_type] = s_memory.byteCount[i_type];
+	}
+}
+
+void eae6320::Graphics::Statistics::CountDraw( const unsigned int i_primitiveCount )
+{
+	++s_currentFrame.drawCallCount;
+	s_currentFrame.primitiveCount += i_primitiveCount;
+}
+
+void eae6320::Graphics::Statistics::CountProgramSwitch()
+{
+	++s_currentFrame.programSwitchCount;
+}
+
+void eae6320::Graphics::Statistics::CountBufferBinds( const unsigned int i_bufferCount )
+{
+	s_currentFrame.bufferBindCount += i_bufferCount;
+}
+
+void eae6320::Graphics::Statistics::CountUpload( const size_t i_byteCount )
+{
+	s_currentFrame.uploadedByteCount += i_byteCount;
+}
+
+// Render
+//-------
+
+void eae6320::Graphics::Statistics::EndFrame()
+{
+	s_previousFrame = s_currentFrame;
+	{
+		const sFrame noCounts = { 0 };
+		s_currentFrame = noCounts;
+	}
+	++s_frameCount;
+	if ( ( s_logPeriodInFrames > 0 ) && ( ( s_frameCount % s_logPeriodInFrames ) == 0 ) )
+	{
+		LogStats();
+	}
+}
+
+// Access
+//-------
+
+const eae6320::Graphics::Statistics::sMemory& eae6320::Graphics::Statistics::GetMemory()
+{
+	return s_memory;
+}
+
+const eae6320::Graphics::Statistics::sFrame& eae6320::Graphics::Statistics::GetPreviousFrame()
+{
+	return s_previousFrame;
+}
+
+const char* eae6320::Graphics::Statistics::GetResourceTypeName( const eResourceType::eResourceType i_type )
+{
+	EAE6320_ASSERT( i_type < eResourceType::Count );
+	return s_resourceTypeNames[i_type];
+}
+
+void eae6320::Graphics::Statistics::LogStats()
+{
+	Logging::OutputMessage( "Graphics statistics after frame %llu:"
+		" %u draw calls (%llu primitives), %u program switches, %u buffer binds, %.1f KB uploaded",
+		s_frameCount, s_previousFrame.drawCallCount, s_previousFrame.primitiveCount,
+		s_previousFrame.programSwitchCount, s_previousFrame.bufferBindCount, s_previousFrame.uploadedByteCount / 1024.0 );
+	for ( unsigned int i = 0; i < eResourceType::Count; ++i )
+	{
+		Logging::OutputMessage( "\t%u %s use %.1f KB (at most %.1f KB)",
+			s_memory.allocationCount[i], s_resourceTypeNames[i],
+			s_memory.byteCount[i] / 1024.0, s_memory.maxByteCount[i] / 1024.0 );
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+void eae6320::Graphics::Statistics::SetLogPeriod( const unsigned int i_frameCount )
+{
+	s_logPeriodInFrames = i_frameCount;
+}
+
+unsigned int eae6320::Graphics::Statistics::GetLogPeriod()
+{
+	return s_logPeriodInFrames;
+}
+
+void eae6320::Graphics::Statistics::Initialize( const unsigned int i_logPeriodInFrames )
+{
+	// Memory isn't reset because it is counted whenever resources are created or freed
+	s_logPeriodInFrames = i_logPeriodInFrames;
+	{
+		const sFrame noCounts = { 0 };
+		s_currentFrame = s_previousFrame = noCounts;
+	}
+	s_frameCount = 0;
+}
+
+void eae6320::Graphics::Statistics::CleanUp()
+{
+	LogStats();
+	for ( unsigned int i = 0; i < eResourceType::Count; ++i )
+	{
+		if ( s_memory.allocationCount[i] > 0 )
+		{
+			Logging::OutputMessage( "%u %s (%.1f KB) haven't been freed when graphics is cleaned up",
+				s_memory.allocationCount[i], s_resourceTypeNames[i], s_memory.byteCount[i] / 1024.0 );
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_ARESTATISTICSTRACKED
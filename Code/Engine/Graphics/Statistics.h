@@ -0,0 +1,127 @@
+/*
+	Graphics statistics track how much GPU memory each type of resource uses
+	and count what the device is asked to do every frame
+
+	The counters are incremented next to the graphics API calls that they describe,
+	and so they count what actually reaches the device
+	(sRenderStats in Graphics.h counts what the renderer submits).
+	Counting is a function call and an add on the render thread, and so nothing is synchronized.
+
+	Statistics are only tracked when EAE6320_GRAPHICS_ARESTATISTICSTRACKED is defined (see Configuration.h).
+	Otherwise EAE6320_GRAPHICS_STATISTICS() expands to nothing and none of the interface exists,
+	and so code outside of the graphics module that uses the interface must check that it is defined.
+*/
+
+#ifndef EAE6320_GRAPHICS_STATISTICS_H
+#define EAE6320_GRAPHICS_STATISTICS_H
+
+// Header Files
+//=============
+
+#include "Configuration.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Interface
+//==========
+
+// This calls a function in the Statistics namespace only when statistics are tracked, e.g.:
+//	EAE6320_GRAPHICS_STATISTICS( CountDraw( triangleCount ) );
+#ifdef EAE6320_GRAPHICS_ARESTATISTICSTRACKED
+	#define EAE6320_GRAPHICS_STATISTICS( i_call ) eae6320::Graphics::Statistics::i_call
+#else
+	#define EAE6320_GRAPHICS_STATISTICS( i_call )
+#endif
+
+#ifdef EAE6320_GRAPHICS_ARESTATISTICSTRACKED
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace Statistics
+		{
+			namespace eResourceType
+			{
+				enum eResourceType
+				{
+					VertexBuffer,
+					IndexBuffer,
+					ConstantBuffer,
+					// Buffers that shaders read as arrays (e.g. the clustered lights)
+					ShaderResourceBuffer,
+					// Render targets are included
+					Texture,
+
+					Count
+				};
+			}
+
+			struct sMemory
+			{
+				size_t byteCount[eResourceType::Count];
+				size_t maxByteCount[eResourceType::Count];
+				unsigned int allocationCount[eResourceType::Count];
+			};
+
+			struct sFrame
+			{
+				unsigned int drawCallCount;
+				// Triangles, lines, or points
+				uint64_t primitiveCount;
+				unsigned int programSwitchCount;
+				// Vertex, index, and constant buffers
+				// (binding a GL vertex array counts as a single bind)
+				unsigned int bufferBindCount;
+				// Data that the CPU wrote to buffers or textures
+				size_t uploadedByteCount;
+			};
+
+			// Count
+			//------
+
+			void CountAllocation( const eResourceType::eResourceType i_type, const size_t i_byteCount );
+			void CountFree( const eResourceType::eResourceType i_type, const size_t i_byteCount );
+			// This is for an allocation whose size changes without it being freed
+			// (e.g. a streamed texture whose resident mips change),
+			// and so the allocation count doesn't change
+			void CountResize( const eResourceType::eResourceType i_type, const size_t i_byteCount_old, const size_t i_byteCount_new );
+			void CountDraw( const unsigned int i_primitiveCount );
+			void CountProgramSwitch();
+			void CountBufferBinds( const unsigned int i_bufferCount );
+			void CountUpload( const size_t i_byteCount );
+
+			// Render
+			//-------
+
+			// This must be called after every frame is presented.
+			// The frame's counters become the ones that GetPreviousFrame() returns,
+			// and every time the log period has passed the statistics are logged.
+			void EndFrame();
+
+			// Access
+			//-------
+
+			const sMemory& GetMemory();
+			const sFrame& GetPreviousFrame();
+			const char* GetResourceTypeName( const eResourceType::eResourceType i_type );
+			void LogStats();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// If the period is 0 the statistics are never logged while rendering
+			void SetLogPeriod( const unsigned int i_frameCount );
+			unsigned int GetLogPeriod();
+
+			void Initialize( const unsigned int i_logPeriodInFrames );
+			// This logs the statistics and any memory that is still allocated
+			void CleanUp();
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_ARESTATISTICSTRACKED
+
+#endif	// EAE6320_GRAPHICS_STATISTICS_H
@@ -0,0 +1,633 @@
+// Header Files
+//=============
+
+#include "Terrain.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// The distance from a value to a range (or 0 if the value is inside of it)
+	float GetDistanceToRange( const float i_value, const float i_minimum, const float i_maximum );
+	bool IsPowerOfTwo( const unsigned int i_value );
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::Terrain::Update( const MeshClusters::sView& i_view, const float i_verticalFieldOfView, const float i_viewportHeight )
+{
+	if ( !m_header )
+	{
+		return;
+	}
+	const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+	const unsigned int tileCount = static_cast<unsigned int>( m_tiles.size() );
+	const unsigned int tileCountX = m_header->tileCountX;
+	const unsigned int tileCountZ = m_header->tileCountZ;
+	m_stats.streamedTileCount = 0;
+	m_stats.evictedTileCount = 0;
+
+	// Create the vertex buffers of the tiles that the background thread has finished reading
+	// and update every tile's distance from the camera
+	for ( unsigned int i = 0; i < tileCount; ++i )
+	{
+		sTile& tile = m_tiles[i];
+		if ( ( tile.state == Pending ) && ( tile.request->isComplete != 0 ) )
+		{
+			CompleteReadRequest( i );
+		}
+		tile.distance = CalculateDistance( i, i_view.cameraPosition );
+	}
+	// Request the closest tiles that are needed but not resident
+	{
+		const float streamingDistance = m_settings.viewDistance + m_settings.prefetchDistance;
+		m_tilesToStream.clear();
+		for ( unsigned int i = 0; i < tileCount; ++i )
+		{
+			const sTile& tile = m_tiles[i];
+			if ( ( tile.state == NotResident ) && ( tile.distance <= streamingDistance ) )
+			{
+				m_tilesToStream.push_back( i );
+			}
+		}
+		const unsigned int requestCount = std::min( static_cast<unsigned int>( m_tilesToStream.size() ),
+			m_settings.maxPendingTileCount - std::min( m_pendingTileCount, m_settings.maxPendingTileCount ) );
+		if ( requestCount > 0 )
+		{
+			const std::vector<sTile>& tiles = m_tiles;
+			std::partial_sort( m_tilesToStream.begin(), m_tilesToStream.begin() + requestCount, m_tilesToStream.end(),
+				[&tiles]( const uint32_t i_lhs, const uint32_t i_rhs )
+				{
+					return tiles[i_lhs].distance < tiles[i_rhs].distance;
+				} );
+		}
+		const unsigned int sampleCount = m_header->tileSampleCount;
+		const float tileSize = static_cast<float>( sampleCount - 1 ) * m_header->sampleSpacing;
+		for ( unsigned int i = 0; i < requestCount; ++i )
+		{
+			const unsigned int tileIndex = m_tilesToStream[i];
+			sTile& tile = m_tiles[tileIndex];
+			if ( ( m_residentTileCount + m_pendingTileCount ) >= m_settings.maxResidentTileCount )
+			{
+				// A tile that is further away than every resident tile can wait
+				// (the tiles are in order, and so none of the remaining ones can be loaded either)
+				if ( !EvictFurthestTile( tile.distance ) )
+				{
+					break;
+				}
+			}
+			sReadRequest* const request = new sReadRequest;
+			{
+				request->samples = reinterpret_cast<const uint16_t*>(
+					reinterpret_cast<const uint8_t*>( m_file.data ) + m_tileDescriptions[tileIndex].sampleOffset );
+				request->vertices = reinterpret_cast<sTerrainVertex*>( malloc( m_vertexCountPerTile * sizeof( sTerrainVertex ) ) );
+				EAE6320_ASSERT( request->vertices );
+				request->x = static_cast<float>( tileIndex % tileCountX ) * tileSize;
+				request->z = static_cast<float>( tileIndex / tileCountX ) * tileSize;
+				request->sampleSpacing = m_header->sampleSpacing;
+				request->heightMin = m_header->heightMin;
+				request->heightScale = m_header->heightScale;
+				request->sampleCount = sampleCount;
+				request->isComplete = 0;
+			}
+			tile.request = request;
+			tile.state = Pending;
+			++m_pendingTileCount;
+			Jobs::SubmitBackgroundJob( ReadTile, request );
+		}
+	}
+	// Choose the LOD of every tile that is close enough to be drawn
+	{
+		// A world-space length at a distance of 1 covers this many pixels
+		const float pixelsPerUnit = i_viewportHeight / ( 2.0f * std::tan( i_verticalFieldOfView * 0.5f ) );
+		const unsigned int lodCount = m_header->lodCount;
+		m_activeTiles.clear();
+		for ( unsigned int i = 0; i < tileCount; ++i )
+		{
+			sTile& tile = m_tiles[i];
+			tile.isActive = ( tile.state == Resident ) && ( tile.distance <= m_settings.viewDistance );
+			if ( tile.isActive )
+			{
+				// The geometric errors never decrease as the LOD gets coarser
+				const float* const geometricErrors = m_tileDescriptions[i].geometricErrors;
+				const float maxError = m_settings.maxPixelError * std::max( tile.distance, 1.0e-3f ) / pixelsPerUnit;
+				unsigned int lod = lodCount - 1;
+				while ( ( lod > 0 ) && ( geometricErrors[lod] > maxError ) )
+				{
+					--lod;
+				}
+				tile.lod = static_cast<uint8_t>( lod );
+				m_activeTiles.push_back( i );
+			}
+		}
+		// Neighbors can only be stitched if they are at most one LOD apart,
+		// and so coarser tiles are made finer until every pair is
+		// (a LOD only ever decreases, and so this always finishes)
+		bool wasALodChanged;
+		do
+		{
+			wasALodChanged = false;
+			for ( std::vector<uint32_t>::const_iterator i = m_activeTiles.begin(); i != m_activeTiles.end(); ++i )
+			{
+				const unsigned int x = *i % tileCountX;
+				const unsigned int z = *i / tileCountX;
+				sTile& tile = m_tiles[*i];
+				const sTile* const neighbors[4] =
+				{
+					( x > 0 ) ? &m_tiles[*i - 1] : NULL,
+					( ( x + 1 ) < tileCountX ) ? &m_tiles[*i + 1] : NULL,
+					( z > 0 ) ? &m_tiles[*i - tileCountX] : NULL,
+					( ( z + 1 ) < tileCountZ ) ? &m_tiles[*i + tileCountX] : NULL,
+				};
+				for ( unsigned int j = 0; j < 4; ++j )
+				{
+					if ( neighbors[j] && neighbors[j]->isActive && ( tile.lod > ( neighbors[j]->lod + 1 ) ) )
+					{
+						tile.lod = neighbors[j]->lod + 1;
+						wasALodChanged = true;
+					}
+				}
+			}
+		} while ( wasALodChanged );
+		// Stitch the edges that are next to a coarser tile
+		// and draw the tiles that are in the view
+		m_drawnTiles.clear();
+		m_stats.triangleCount = 0;
+		memset( m_stats.drawnTileCountPerLod, 0, sizeof( m_stats.drawnTileCountPerLod ) );
+		for ( std::vector<uint32_t>::const_iterator i = m_activeTiles.begin(); i != m_activeTiles.end(); ++i )
+		{
+			const unsigned int x = *i % tileCountX;
+			const unsigned int z = *i / tileCountX;
+			sTile& tile = m_tiles[*i];
+			const sTile* const neighbors[4] =
+			{
+				( x > 0 ) ? &m_tiles[*i - 1] : NULL,
+				( ( x + 1 ) < tileCountX ) ? &m_tiles[*i + 1] : NULL,
+				( z > 0 ) ? &m_tiles[*i - tileCountX] : NULL,
+				( ( z + 1 ) < tileCountZ ) ? &m_tiles[*i + tileCountX] : NULL,
+			};
+			const unsigned int edges[4] = { NegativeX, PositiveX, NegativeZ, PositiveZ };
+			tile.stitchedEdges = 0;
+			for ( unsigned int j = 0; j < 4; ++j )
+			{
+				if ( neighbors[j] && neighbors[j]->isActive && ( neighbors[j]->lod > tile.lod ) )
+				{
+					tile.stitchedEdges |= edges[j];
+				}
+			}
+			if ( IsVisible( *i, i_view ) )
+			{
+				m_drawnTiles.push_back( *i );
+				m_stats.triangleCount += GetIndexRange( tile.lod, tile.stitchedEdges ).indexCount / 3;
+				++m_stats.drawnTileCountPerLod[tile.lod];
+			}
+		}
+	}
+	// Update the statistics
+	{
+		m_stats.residentTileCount = m_residentTileCount;
+		m_stats.pendingTileCount = m_pendingTileCount;
+		m_stats.residentByteCount = ( m_residentTileCount * m_vertexBufferSize ) + m_indexBufferSize;
+		m_stats.drawnTileCount = static_cast<unsigned int>( m_drawnTiles.size() );
+		m_streamingWindowTileCount += m_stats.streamedTileCount;
+		const uint64_t tickCount_end = Time::GetCurrentSystemTimeTickCount();
+		if ( m_streamingWindowStartTickCount == 0 )
+		{
+			m_streamingWindowStartTickCount = tickCount_start;
+		}
+		const double secondCount_window = Time::ConvertTicksToSeconds( tickCount_end - m_streamingWindowStartTickCount );
+		if ( secondCount_window >= 1.0 )
+		{
+			m_stats.tilesStreamedPerSecond = static_cast<float>( m_streamingWindowTileCount / secondCount_window );
+			m_streamingWindowTileCount = 0;
+			m_streamingWindowStartTickCount = tickCount_end;
+		}
+		m_stats.secondCountUpdating = Time::ConvertTicksToSeconds( tickCount_end - tickCount_start );
+	}
+}
+
+bool eae6320::Graphics::Terrain::Draw()
+{
+	if ( !m_drawnTiles.empty() )
+	{
+		DrawTiles();
+	}
+	return true;
+}
+
+// Access
+//-------
+
+float eae6320::Graphics::Terrain::GetSizeX() const
+{
+	return m_header ? ( static_cast<float>( m_header->tileCountX * ( m_header->tileSampleCount - 1 ) ) * m_header->sampleSpacing ) : 0.0f;
+}
+
+float eae6320::Graphics::Terrain::GetSizeZ() const
+{
+	return m_header ? ( static_cast<float>( m_header->tileCountZ * ( m_header->tileSampleCount - 1 ) ) * m_header->sampleSpacing ) : 0.0f;
+}
+
+float eae6320::Graphics::Terrain::GetTileHeightMax( const float i_x, const float i_z ) const
+{
+	if ( !m_header )
+	{
+		return 0.0f;
+	}
+	const float tileSize = static_cast<float>( m_header->tileSampleCount - 1 ) * m_header->sampleSpacing;
+	const int x = std::min( std::max( static_cast<int>( std::floor( i_x / tileSize ) ), 0 ), m_header->tileCountX - 1 );
+	const int z = std::min( std::max( static_cast<int>( std::floor( i_z / tileSize ) ), 0 ), m_header->tileCountZ - 1 );
+	return m_tileDescriptions[( z * m_header->tileCountX ) + x].heightMax;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::Terrain::Load( const char* const i_path, const sSettings& i_settings )
+{
+	bool wereThereErrors = false;
+
+	// A terrain can only be loaded once
+	EAE6320_ASSERT( m_header == NULL );
+	EAE6320_ASSERT( ( i_settings.maxResidentTileCount > 0 ) && ( i_settings.maxPendingTileCount > 0 ) );
+	m_settings = i_settings;
+
+	{
+		std::string errorMessage;
+		if ( !Platform::MapBinaryFile( i_path, m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to map the terrain %s: %s", i_path, errorMessage.c_str() );
+			goto OnExit;
+		}
+	}
+	// Validate the file
+	{
+		const uint8_t* const fileData = reinterpret_cast<const uint8_t*>( m_file.data );
+		const TerrainFormats::sHeader* const header = reinterpret_cast<const TerrainFormats::sHeader*>( fileData );
+		if ( ( m_file.size < sizeof( TerrainFormats::sHeader ) )
+			|| ( header->fourCc != TerrainFormats::s_fourCc ) || ( header->version != TerrainFormats::s_version ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Invalid terrain file" );
+			Logging::OutputError( "The terrain %s isn't a built terrain (or was built by a different version of the TerrainBuilder)", i_path );
+			goto OnExit;
+		}
+		const unsigned int sampleCount = header->tileSampleCount;
+		if ( ( sampleCount < TerrainFormats::s_minTileSampleCount ) || ( sampleCount > TerrainFormats::s_maxTileSampleCount )
+			|| !IsPowerOfTwo( sampleCount - 1 )
+			|| ( header->tileCountX == 0 ) || ( header->tileCountZ == 0 )
+			|| ( header->lodCount == 0 ) || ( header->lodCount > TerrainFormats::s_maxLodCount )
+			|| ( ( 1u << ( header->lodCount - 1 ) ) != ( sampleCount - 1 ) )
+			|| !( header->sampleSpacing > 0.0f ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Invalid terrain header" );
+			Logging::OutputError( "The terrain %s has an invalid header", i_path );
+			goto OnExit;
+		}
+		const unsigned int tileCount = header->tileCountX * header->tileCountZ;
+		const size_t offset_tiles = sizeof( TerrainFormats::sHeader );
+		const size_t offset_samples = offset_tiles + ( tileCount * sizeof( TerrainFormats::sTile ) );
+		const size_t sampleSize = sampleCount * sampleCount * sizeof( uint16_t );
+		if ( m_file.size < offset_samples )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, "Truncated terrain file" );
+			Logging::OutputError( "The terrain %s is shorter than its header says it should be", i_path );
+			goto OnExit;
+		}
+		m_tileDescriptions = reinterpret_cast<const TerrainFormats::sTile*>( fileData + offset_tiles );
+		for ( unsigned int i = 0; i < tileCount; ++i )
+		{
+			const size_t sampleOffset = m_tileDescriptions[i].sampleOffset;
+			if ( ( sampleOffset < offset_samples ) || ( ( sampleOffset % sizeof( uint16_t ) ) != 0 )
+				|| ( sampleOffset > ( m_file.size - sampleSize ) ) )
+			{
+				wereThereErrors = true;
+				EAE6320_ASSERTF( false, "Truncated terrain file" );
+				Logging::OutputError( "The samples of tile %u of the terrain %s are outside of the file", i, i_path );
+				goto OnExit;
+			}
+		}
+		m_header = header;
+		m_vertexCountPerTile = sampleCount * sampleCount;
+		m_vertexBufferSize = m_vertexCountPerTile * sizeof( sTerrainVertex );
+		{
+			sTile tile;
+			{
+				memset( &tile, 0, sizeof( tile ) );
+				tile.state = NotResident;
+			}
+			m_tiles.assign( tileCount, tile );
+		}
+		m_drawnTiles.reserve( tileCount );
+		m_activeTiles.reserve( tileCount );
+		m_tilesToStream.reserve( tileCount );
+	}
+	// Every tile uses the same index buffer
+	{
+		std::vector<uint16_t> indices;
+		GenerateIndices( indices );
+		if ( !CreateIndexBuffer( indices ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		m_indexBufferSize = indices.size() * sizeof( uint16_t );
+	}
+	memset( &m_stats, 0, sizeof( m_stats ) );
+	m_stats.tileCount = static_cast<unsigned int>( m_tiles.size() );
+	m_stats.residentByteCount = m_indexBufferSize;
+
+OnExit:
+
+	if ( wereThereErrors )
+	{
+		CleanUp();
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::Terrain::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	for ( std::vector<sTile>::iterator i = m_tiles.begin(); i != m_tiles.end(); ++i )
+	{
+		if ( i->state == Pending )
+		{
+			// The background thread reads from the mapped file,
+			// and so it must be finished before the file is unmapped
+			WaitForReadRequest( *i->request );
+			free( i->request->vertices );
+			delete i->request;
+			i->request = NULL;
+		}
+		else if ( i->state == Resident )
+		{
+			DestroyVertexBuffer( *i );
+		}
+		i->state = NotResident;
+	}
+	m_tiles.clear();
+	m_drawnTiles.clear();
+	m_activeTiles.clear();
+	m_tilesToStream.clear();
+	m_indexRanges.clear();
+	DestroyIndexBuffer();
+	m_indexBufferSize = 0;
+	if ( m_file.data )
+	{
+		std::string errorMessage;
+		if ( !Platform::UnmapBinaryFile( m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to unmap a terrain: %s", errorMessage.c_str() );
+		}
+	}
+	m_header = NULL;
+	m_tileDescriptions = NULL;
+	m_vertexCountPerTile = 0;
+	m_vertexBufferSize = 0;
+	m_residentTileCount = m_pendingTileCount = 0;
+	m_streamingWindowStartTickCount = 0;
+	m_streamingWindowTileCount = 0;
+
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::Terrain::sSettings::sSettings()
+	:
+	viewDistance( 1000.0f ), prefetchDistance( 200.0f ),
+	maxPixelError( 2.0f ),
+	maxResidentTileCount( 256 ), maxPendingTileCount( 8 )
+{
+
+}
+
+eae6320::Graphics::Terrain::Terrain()
+{
+	memset( &m_stats, 0, sizeof( m_stats ) );
+}
+
+eae6320::Graphics::Terrain::~Terrain()
+{
+	CleanUp();
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::Terrain::GenerateIndices( std::vector<uint16_t>& o_indices )
+{
+	const unsigned int sampleCount = m_header->tileSampleCount;
+	const unsigned int lodCount = m_header->lodCount;
+	m_indexRanges.resize( lodCount * EdgeCombinationCount );
+	o_indices.clear();
+	for ( unsigned int lod = 0; lod < lodCount; ++lod )
+	{
+		const unsigned int step = 1u << lod;
+		for ( unsigned int stitchedEdges = 0; stitchedEdges < EdgeCombinationCount; ++stitchedEdges )
+		{
+			MeshClusters::sIndexRange& indexRange = m_indexRanges[( lod * EdgeCombinationCount ) + stitchedEdges];
+			indexRange.firstIndex = static_cast<uint32_t>( o_indices.size() );
+			// The coarsest LOD can't have a coarser neighbor
+			// (it only has a range for every combination so that ranges can always be looked up the same way)
+			const unsigned int edgesToStitch = ( ( lod + 1 ) < lodCount ) ? stitchedEdges : 0;
+			for ( unsigned int z = 0; ( z + step ) < sampleCount; z += step )
+			{
+				for ( unsigned int x = 0; ( x + step ) < sampleCount; x += step )
+				{
+					const uint16_t i00 = GetStitchedIndex( x, z, step, sampleCount, edgesToStitch );
+					const uint16_t i10 = GetStitchedIndex( x + step, z, step, sampleCount, edgesToStitch );
+					const uint16_t i01 = GetStitchedIndex( x, z + step, step, sampleCount, edgesToStitch );
+					const uint16_t i11 = GetStitchedIndex( x + step, z + step, step, sampleCount, edgesToStitch );
+					// Both triangles face up (+y)
+					// (the front of a triangle is clockwise in Direct3D and counterclockwise in OpenGL)
+					const uint16_t triangles[2][3] = { { i00, i01, i11 }, { i00, i11, i10 } };
+					for ( unsigned int i = 0; i < 2; ++i )
+					{
+						const uint16_t* const triangle = triangles[i];
+						// Stitching makes some triangles degenerate
+						if ( ( triangle[0] != triangle[1] ) && ( triangle[1] != triangle[2] ) && ( triangle[2] != triangle[0] ) )
+						{
+							o_indices.push_back( triangle[0] );
+#if defined( EAE6320_PLATFORM_D3D )
+							o_indices.push_back( triangle[2] );
+							o_indices.push_back( triangle[1] );
+#else
+							o_indices.push_back( triangle[1] );
+							o_indices.push_back( triangle[2] );
+#endif
+						}
+					}
+				}
+			}
+			indexRange.indexCount = static_cast<uint32_t>( o_indices.size() ) - indexRange.firstIndex;
+		}
+	}
+}
+
+uint16_t eae6320::Graphics::Terrain::GetStitchedIndex( unsigned int i_x, unsigned int i_z, const unsigned int i_step,
+	const unsigned int i_sampleCount, const unsigned int i_stitchedEdges )
+{
+	const unsigned int lastSample = i_sampleCount - 1;
+	if ( ( ( ( i_x == 0 ) && ( i_stitchedEdges & NegativeX ) ) || ( ( i_x == lastSample ) && ( i_stitchedEdges & PositiveX ) ) )
+		&& ( ( ( i_z / i_step ) % 2 ) != 0 ) )
+	{
+		i_z -= i_step;
+	}
+	if ( ( ( ( i_z == 0 ) && ( i_stitchedEdges & NegativeZ ) ) || ( ( i_z == lastSample ) && ( i_stitchedEdges & PositiveZ ) ) )
+		&& ( ( ( i_x / i_step ) % 2 ) != 0 ) )
+	{
+		i_x -= i_step;
+	}
+	return static_cast<uint16_t>( ( i_z * i_sampleCount ) + i_x );
+}
+
+float eae6320::Graphics::Terrain::CalculateDistance( const unsigned int i_tileIndex, const float i_cameraPosition[3] ) const
+{
+	const float tileSize = static_cast<float>( m_header->tileSampleCount - 1 ) * m_header->sampleSpacing;
+	const float minimumX = static_cast<float>( i_tileIndex % m_header->tileCountX ) * tileSize;
+	const float minimumZ = static_cast<float>( i_tileIndex / m_header->tileCountX ) * tileSize;
+	const TerrainFormats::sTile& tileDescription = m_tileDescriptions[i_tileIndex];
+	const float distances[3] =
+	{
+		GetDistanceToRange( i_cameraPosition[0], minimumX, minimumX + tileSize ),
+		GetDistanceToRange( i_cameraPosition[1], tileDescription.heightMin, tileDescription.heightMax ),
+		GetDistanceToRange( i_cameraPosition[2], minimumZ, minimumZ + tileSize ),
+	};
+	return std::sqrt( ( distances[0] * distances[0] ) + ( distances[1] * distances[1] ) + ( distances[2] * distances[2] ) );
+}
+
+bool eae6320::Graphics::Terrain::IsVisible( const unsigned int i_tileIndex, const MeshClusters::sView& i_view ) const
+{
+	const float tileSize = static_cast<float>( m_header->tileSampleCount - 1 ) * m_header->sampleSpacing;
+	const float minimumX = static_cast<float>( i_tileIndex % m_header->tileCountX ) * tileSize;
+	const float minimumZ = static_cast<float>( i_tileIndex / m_header->tileCountX ) * tileSize;
+	const TerrainFormats::sTile& tileDescription = m_tileDescriptions[i_tileIndex];
+	const float minimum[3] = { minimumX, tileDescription.heightMin, minimumZ };
+	const float maximum[3] = { minimumX + tileSize, tileDescription.heightMax, minimumZ + tileSize };
+	// The box is outside of the frustum if its corner that is furthest along a plane's normal is outside of that plane
+	for ( unsigned int i = 0; i < 6; ++i )
+	{
+		const float* const plane = i_view.planes[i];
+		float distance = plane[3];
+		for ( unsigned int j = 0; j < 3; ++j )
+		{
+			distance += plane[j] * ( ( plane[j] >= 0.0f ) ? maximum[j] : minimum[j] );
+		}
+		if ( distance < 0.0f )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void eae6320::Graphics::Terrain::CompleteReadRequest( const unsigned int i_tileIndex )
+{
+	sTile& tile = m_tiles[i_tileIndex];
+	sReadRequest* const request = tile.request;
+	if ( CreateVertexBuffer( tile, request->vertices ) )
+	{
+		tile.state = Resident;
+		++m_residentTileCount;
+		++m_stats.streamedTileCount;
+	}
+	else
+	{
+		// The tile will be requested again
+		tile.state = NotResident;
+	}
+	--m_pendingTileCount;
+	free( request->vertices );
+	delete request;
+	tile.request = NULL;
+}
+
+bool eae6320::Graphics::Terrain::EvictFurthestTile( const float i_distance )
+{
+	sTile* furthestTile = NULL;
+	float furthestDistance = i_distance;
+	for ( std::vector<sTile>::iterator i = m_tiles.begin(); i != m_tiles.end(); ++i )
+	{
+		if ( ( i->state == Resident ) && ( i->distance > furthestDistance ) )
+		{
+			furthestTile = &*i;
+			furthestDistance = i->distance;
+		}
+	}
+	if ( furthestTile == NULL )
+	{
+		return false;
+	}
+	DestroyVertexBuffer( *furthestTile );
+	furthestTile->state = NotResident;
+	furthestTile->isActive = false;
+	--m_residentTileCount;
+	++m_stats.evictedTileCount;
+	return true;
+}
+
+void eae6320::Graphics::Terrain::ReadTile( void* const io_request )
+{
+	sReadRequest& request = *reinterpret_cast<sReadRequest*>( io_request );
+	// Reading from the mapped file is what makes the operating system read the tile from disk
+	const uint16_t* sample = request.samples;
+	sTerrainVertex* vertex = request.vertices;
+	for ( unsigned int z = 0; z < request.sampleCount; ++z )
+	{
+		const float positionZ = request.z + ( static_cast<float>( z ) * request.sampleSpacing );
+		for ( unsigned int x = 0; x < request.sampleCount; ++x, ++sample, ++vertex )
+		{
+			vertex->x = request.x + ( static_cast<float>( x ) * request.sampleSpacing );
+			vertex->y = request.heightMin + ( request.heightScale * static_cast<float>( *sample ) );
+			vertex->z = positionZ;
+		}
+	}
+	// The exchange is a full memory barrier, and so the vertices will be visible to the render thread
+	InterlockedExchange( &request.isComplete, 1 );
+}
+
+void eae6320::Graphics::Terrain::WaitForReadRequest( sReadRequest& io_request )
+{
+	while ( io_request.isComplete == 0 )
+	{
+		SwitchToThread();
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	float GetDistanceToRange( const float i_value, const float i_minimum, const float i_maximum )
+	{
+		return ( i_value < i_minimum ) ? ( i_minimum - i_value ) : ( ( i_value > i_maximum ) ? ( i_value - i_maximum ) : 0.0f );
+	}
+
+	bool IsPowerOfTwo( const unsigned int i_value )
+	{
+		return ( i_value != 0 ) && ( ( i_value & ( i_value - 1 ) ) == 0 );
+	}
+}
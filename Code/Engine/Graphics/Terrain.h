@@ -0,0 +1,252 @@
+/*
+	A terrain is a large heightfield that is streamed in tiles around the camera
+	and drawn with a level of detail (LOD) for each tile (geomipmapping)
+
+	Loading a terrain maps the built file (see TerrainFormats.h) but only reads its table of tiles.
+	Every frame the tiles that are within the view and prefetch distances of the camera are requested (closest first),
+	and each one's samples are read and turned into vertices on the background job thread
+	before its vertex buffer is created on the render thread.
+	When the maximum number of tiles is resident the tile that is furthest from the camera is evicted to make room
+	(as long as it is further away than the tile that needs the room).
+
+	Each tile that is drawn uses the coarsest LOD whose geometric error (which was calculated when the terrain was built)
+	would cover fewer pixels on screen than the maximum.
+	Neighboring tiles are then made to be at most one LOD apart,
+	and the edge of a tile that is next to a coarser tile skips every other vertex so that there are no cracks between them.
+	Every tile has the same grid of vertices,
+	and so a single index buffer has every LOD with every combination of stitched edges and is shared by every tile.
+*/
+
+#ifndef EAE6320_GRAPHICS_TERRAIN_H
+#define EAE6320_GRAPHICS_TERRAIN_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MeshClusters.h"
+#include "TerrainFormats.h"
+#include "../Platform/Platform.h"
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		// A terrain's vertices are in world space
+		// (and so a terrain must be drawn with a material whose vertex shader reads 3 floats of POSITION)
+		struct sTerrainVertex
+		{
+			float x, y, z;
+		};
+
+		class Terrain
+		{
+		public:
+
+			struct sSettings
+			{
+				// Tiles that are closer to the camera than this are drawn
+				float viewDistance;
+				// Tiles that are within this much further than the view distance are loaded before they are needed
+				float prefetchDistance;
+				// A tile uses the coarsest LOD whose geometric error covers fewer pixels than this
+				float maxPixelError;
+				unsigned int maxResidentTileCount;
+				// This is how many tiles can be waiting for the background thread at once
+				unsigned int maxPendingTileCount;
+
+				sSettings();
+			};
+
+			// These describe the terrain after the most recent call to Update()
+			struct sStats
+			{
+				unsigned int tileCount;
+				unsigned int residentTileCount;
+				unsigned int pendingTileCount;
+				// The vertex buffers of the resident tiles and the shared index buffer
+				size_t residentByteCount;
+				unsigned int drawnTileCount;
+				unsigned int drawnTileCountPerLod[TerrainFormats::s_maxLodCount];
+				unsigned int triangleCount;
+				// These only count what happened during the most recent call to Update()
+				unsigned int streamedTileCount;
+				unsigned int evictedTileCount;
+				// This is measured over about a second
+				float tilesStreamedPerSecond;
+				double secondCountUpdating;
+			};
+
+			// Render
+			//-------
+
+			// This must be called once every frame from the render thread before the terrain is drawn.
+			// It creates the vertex buffers of tiles that have finished loading, decides which tiles to load and evict,
+			// and chooses the LOD of every tile that will be drawn.
+			// The view is in world space (see MeshClusters::CalculateView()),
+			// and the viewport height is in pixels.
+			void Update( const MeshClusters::sView& i_view, const float i_verticalFieldOfView, const float i_viewportHeight );
+			// This draws the tiles that were chosen by the most recent call to Update()
+			bool Draw();
+
+			// Access
+			//-------
+
+			const sSettings& GetSettings() const { return m_settings; }
+			const sStats& GetStats() const { return m_stats; }
+			float GetSizeX() const;
+			float GetSizeZ() const;
+			// This returns the highest point of the tile under a position
+			// (which is known even when the tile isn't resident)
+			float GetTileHeightMax( const float i_x, const float i_z ) const;
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Load( const char* const i_path, const sSettings& i_settings = sSettings() );
+			// If a tile is still being read this waits for it to finish
+			bool CleanUp();
+
+			Terrain();
+			~Terrain();
+
+			// Implementation
+			//===============
+
+		private:
+
+			// A tile's stitched edges are a combination of these
+			// (an edge is stitched when the neighbor on that side is one LOD coarser)
+			enum eEdge
+			{
+				NegativeX = 1 << 0,
+				PositiveX = 1 << 1,
+				NegativeZ = 1 << 2,
+				PositiveZ = 1 << 3,
+
+				EdgeCombinationCount = 1 << 4
+			};
+
+			enum eTileState
+			{
+				NotResident,
+				// The tile is being read on the background thread
+				Pending,
+				Resident,
+			};
+
+			// A tile's samples are turned into vertices on the background job thread
+			// so that the render thread never has to wait for the disk
+			struct sReadRequest
+			{
+				const uint16_t* samples;
+				sTerrainVertex* vertices;
+				// The position of the tile's first sample
+				float x, z;
+				float sampleSpacing;
+				float heightMin, heightScale;
+				unsigned int sampleCount;
+				// This is set by the background thread once the vertices have been created
+				volatile LONG isComplete;
+			};
+
+			struct sTile
+			{
+				// This is NULL unless the tile is being read
+				sReadRequest* request;
+				float distance;
+				// This is an eTileState
+				uint8_t state;
+				uint8_t lod;
+				// This is a combination of eEdge
+				uint8_t stitchedEdges;
+				// Whether the tile is resident and within the view distance
+				bool isActive;
+#if defined( EAE6320_PLATFORM_D3D )
+				ID3D11Buffer* vertexBuffer;
+#elif defined( EAE6320_PLATFORM_GL )
+				GLuint vertexArrayId;
+				GLuint vertexBufferId;
+#endif
+			};
+
+			// This generates the indices of every LOD with every combination of stitched edges
+			// and stores where each one is in m_indexRanges
+			void GenerateIndices( std::vector<uint16_t>& o_indices );
+			// An edge vertex that isn't on the next coarser LOD is moved to the previous vertex that is
+			// (this makes one of the two triangles that touch it degenerate and stretches the other to cover it)
+			static uint16_t GetStitchedIndex( unsigned int i_x, unsigned int i_z, const unsigned int i_step,
+				const unsigned int i_sampleCount, const unsigned int i_stitchedEdges );
+			const MeshClusters::sIndexRange& GetIndexRange( const unsigned int i_lod, const unsigned int i_stitchedEdges ) const
+			{
+				return m_indexRanges[( i_lod * EdgeCombinationCount ) + i_stitchedEdges];
+			}
+			// The distance is from the camera to the closest point of the tile's box
+			float CalculateDistance( const unsigned int i_tileIndex, const float i_cameraPosition[3] ) const;
+			bool IsVisible( const unsigned int i_tileIndex, const MeshClusters::sView& i_view ) const;
+			void CompleteReadRequest( const unsigned int i_tileIndex );
+			// Evicts the resident tile that is furthest away if it is further than the given distance
+			bool EvictFurthestTile( const float i_distance );
+
+			static void ReadTile( void* const io_request );
+			static void WaitForReadRequest( sReadRequest& io_request );
+
+			// Platform-specific
+			bool CreateIndexBuffer( const std::vector<uint16_t>& i_indices );
+			void DestroyIndexBuffer();
+			bool CreateVertexBuffer( sTile& io_tile, const sTerrainVertex* const i_vertices );
+			void DestroyVertexBuffer( sTile& io_tile );
+			void DrawTiles();
+
+			// Data
+			//=====
+
+		private:
+
+			Platform::sMappedFile m_file;
+			const TerrainFormats::sHeader* m_header = NULL;
+			const TerrainFormats::sTile* m_tileDescriptions = NULL;
+			sSettings m_settings;
+			sStats m_stats;
+
+			std::vector<sTile> m_tiles;
+			// The tiles that the most recent call to Update() chose to draw
+			std::vector<uint32_t> m_drawnTiles;
+			// These are kept so that their memory can be reused every frame
+			std::vector<uint32_t> m_tilesToStream;
+			std::vector<uint32_t> m_activeTiles;
+
+			// Every LOD has a range for every combination of stitched edges
+			std::vector<MeshClusters::sIndexRange> m_indexRanges;
+			unsigned int m_vertexCountPerTile = 0;
+			unsigned int m_residentTileCount = 0;
+			unsigned int m_pendingTileCount = 0;
+
+			// Tiles streamed per second is measured by counting the tiles that are streamed in a window of time
+			uint64_t m_streamingWindowStartTickCount = 0;
+			unsigned int m_streamingWindowTileCount = 0;
+
+			// These are only used for statistics
+			size_t m_vertexBufferSize = 0;
+			size_t m_indexBufferSize = 0;
+#if defined( EAE6320_PLATFORM_D3D )
+			ID3D11Buffer* m_indexBuffer = NULL;
+#elif defined( EAE6320_PLATFORM_GL )
+			GLuint m_indexBufferId = 0;
+#endif
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_TERRAIN_H
@@ -0,0 +1,83 @@
+/*
+	This file describes the layout of a built terrain
+
+	It is shared between the TerrainBuilder (which writes the file)
+	and the runtime Terrain (which streams it).
+
+	A terrain is a grid of square tiles of height samples.
+	Every tile has tileSampleCount samples on each side (which is a power of 2 plus 1),
+	and neighboring tiles share the samples along their common edge
+	so that a tile can be drawn without reading any of its neighbors.
+	Sample (x, z) of the terrain is at ( x * sampleSpacing, height, z * sampleSpacing ) in world space.
+
+	A tile is drawn as a grid of quads that is a level of detail (LOD) of its samples:
+	LOD 0 uses every sample, LOD 1 every second one, and so on until the last LOD is a single quad.
+	Every quad is split into two triangles along the diagonal from its (minimum x, minimum z) corner
+	to its (maximum x, maximum z) corner.
+	The geometric error of a LOD is the largest vertical distance between a sample
+	and the triangles of that LOD (it never decreases as the LOD gets coarser).
+
+	A built terrain is:
+		* An sHeader
+		* An sTile for every tile (a row of tiles along x for each z)
+		* The samples of every tile
+	The samples of each tile are a uint16_t for every sample (a row along x for each z),
+	and a sample's height is heightMin + ( heightScale * sample ).
+	The tiles' samples are stored along a Z-order curve (rather than in the order of the sTiles)
+	so that tiles that are near each other in the world are near each other in the file.
+*/
+
+#ifndef EAE6320_GRAPHICS_TERRAINFORMATS_H
+#define EAE6320_GRAPHICS_TERRAINFORMATS_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace TerrainFormats
+		{
+			// "ETRN" read as a little-endian uint32_t
+			const uint32_t s_fourCc = 0x4e525445;
+			const uint16_t s_version = 1;
+
+			// A tile's vertices are indexed with 16 bits,
+			// and so a tile can't have more than 129 x 129 samples (and 8 LODs)
+			const unsigned int s_minTileSampleCount = 3;
+			const unsigned int s_maxTileSampleCount = 129;
+			const unsigned int s_maxLodCount = 8;
+
+			struct sHeader
+			{
+				uint32_t fourCc;
+				uint16_t version;
+				uint16_t tileSampleCount;
+				uint16_t tileCountX, tileCountZ;
+				uint16_t lodCount;
+				uint16_t padding;
+				// The distance between neighboring samples
+				float sampleSpacing;
+				float heightMin, heightScale;
+			};
+
+			struct sTile
+			{
+				// The offset of the tile's samples from the start of the file
+				uint32_t sampleOffset;
+				// The range of the tile's heights
+				float heightMin, heightMax;
+				// Only the first lodCount are used
+				float geometricErrors[s_maxLodCount];
+			};
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_TERRAINFORMATS_H
@@ -0,0 +1,337 @@
+// Header Files
+//=============
+
+#include "TextBatch.h"
+
+#include <cstring>
+#include "Atlas.h"
+#include "Font.h"
+#include "Statistics.h"
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Interface
+//==========
+
+// Layout
+//-------
+
+void eae6320::Graphics::TextBatch::AddText( const char* const i_text, const float i_x, const float i_y,
+	const uint32_t i_color, const float i_scale )
+{
+	EAE6320_ASSERT( m_font && i_text );
+	const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+
+	const FontFormats::sGlyph* const missingGlyph = m_font->GetGlyph( '?' );
+	const float lineHeight = m_font->GetLineHeight() * i_scale;
+	float penX = i_x;
+	float baseline = i_y + ( m_font->GetAscent() * i_scale );
+	sTextVertex* vertex = m_vertices.empty() ? NULL : &m_vertices[m_glyphCount * 4];
+	for ( const unsigned char* character = reinterpret_cast<const unsigned char*>( i_text ); *character != '\0'; ++character )
+	{
+		if ( *character == '\n' )
+		{
+			penX = i_x;
+			baseline += lineHeight;
+			continue;
+		}
+		const FontFormats::sGlyph* glyph = m_font->GetGlyph( *character );
+		if ( !glyph )
+		{
+			glyph = missingGlyph;
+			if ( !glyph )
+			{
+				continue;
+			}
+		}
+		// Characters like spaces only move the pen
+		if ( glyph->width > 0.0f )
+		{
+			if ( m_glyphCount < m_maxGlyphCount )
+			{
+				const float x0 = penX + ( glyph->offsetX * i_scale );
+				const float y0 = baseline + ( glyph->offsetY * i_scale );
+				const float x1 = x0 + ( glyph->width * i_scale );
+				const float y1 = y0 + ( glyph->height * i_scale );
+				// Top left, top right, bottom left, bottom right
+				vertex[0].x = x0; vertex[0].y = y0; vertex[0].u = glyph->u0; vertex[0].v = glyph->v0;
+				vertex[1].x = x1; vertex[1].y = y0; vertex[1].u = glyph->u1; vertex[1].v = glyph->v0;
+				vertex[2].x = x0; vertex[2].y = y1; vertex[2].u = glyph->u0; vertex[2].v = glyph->v1;
+				vertex[3].x = x1; vertex[3].y = y1; vertex[3].u = glyph->u1; vertex[3].v = glyph->v1;
+				memcpy( &vertex[0].r, &i_color, sizeof( i_color ) );
+				memcpy( &vertex[1].r, &i_color, sizeof( i_color ) );
+				memcpy( &vertex[2].r, &i_color, sizeof( i_color ) );
+				memcpy( &vertex[3].r, &i_color, sizeof( i_color ) );
+				vertex += 4;
+				++m_glyphCount;
+			}
+			else
+			{
+				++m_droppedGlyphCount;
+			}
+		}
+		penX += glyph->advance * i_scale;
+	}
+
+	m_secondCountLayingOut += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+}
+
+void eae6320::Graphics::TextBatch::AddSprite( const AtlasFormats::sEntry& i_sprite, const float i_x, const float i_y,
+	const uint32_t i_color, const float i_scale )
+{
+	EAE6320_ASSERT( m_atlas );
+	const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+
+	if ( m_glyphCount < m_maxGlyphCount )
+	{
+		const float x0 = i_x;
+		const float y0 = i_y;
+		const float x1 = x0 + ( static_cast<float>( i_sprite.width ) * i_scale );
+		const float y1 = y0 + ( static_cast<float>( i_sprite.height ) * i_scale );
+		sTextVertex* const vertex = &m_vertices[m_glyphCount * 4];
+		// Top left, top right, bottom left, bottom right
+		vertex[0].x = x0; vertex[0].y = y0; vertex[0].u = i_sprite.u0; vertex[0].v = i_sprite.v0;
+		vertex[1].x = x1; vertex[1].y = y0; vertex[1].u = i_sprite.u1; vertex[1].v = i_sprite.v0;
+		vertex[2].x = x0; vertex[2].y = y1; vertex[2].u = i_sprite.u0; vertex[2].v = i_sprite.v1;
+		vertex[3].x = x1; vertex[3].y = y1; vertex[3].u = i_sprite.u1; vertex[3].v = i_sprite.v1;
+		memcpy( &vertex[0].r, &i_color, sizeof( i_color ) );
+		memcpy( &vertex[1].r, &i_color, sizeof( i_color ) );
+		memcpy( &vertex[2].r, &i_color, sizeof( i_color ) );
+		memcpy( &vertex[3].r, &i_color, sizeof( i_color ) );
+		++m_glyphCount;
+	}
+	else
+	{
+		++m_droppedGlyphCount;
+	}
+
+	m_secondCountLayingOut += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+}
+
+float eae6320::Graphics::TextBatch::MeasureText( const char* const i_text, const float i_scale ) const
+{
+	EAE6320_ASSERT( m_font && i_text );
+	const FontFormats::sGlyph* const missingGlyph = m_font->GetGlyph( '?' );
+	float maxWidth = 0.0f;
+	float width = 0.0f;
+	for ( const unsigned char* character = reinterpret_cast<const unsigned char*>( i_text ); *character != '\0'; ++character )
+	{
+		if ( *character == '\n' )
+		{
+			maxWidth = ( width > maxWidth ) ? width : maxWidth;
+			width = 0.0f;
+			continue;
+		}
+		const FontFormats::sGlyph* const glyph = m_font->GetGlyph( *character );
+		if ( glyph || missingGlyph )
+		{
+			width += ( glyph ? glyph : missingGlyph )->advance;
+		}
+	}
+	maxWidth = ( width > maxWidth ) ? width : maxWidth;
+	return maxWidth * i_scale;
+}
+
+void eae6320::Graphics::TextBatch::Clear()
+{
+	m_glyphCount = 0;
+	m_droppedGlyphCount = 0;
+	m_secondCountLayingOut = 0.0;
+}
+
+// Render
+//-------
+
+bool eae6320::Graphics::TextBatch::Draw( const unsigned int i_targetWidth, const unsigned int i_targetHeight )
+{
+	bool wereThereErrors = false;
+
+	m_stats.glyphCount = m_glyphCount;
+	m_stats.droppedGlyphCount = m_droppedGlyphCount;
+	m_stats.secondCountLayingOut = m_secondCountLayingOut;
+	m_stats.secondCountWritingVertices = 0.0;
+	m_stats.drawCallCount = 0;
+	if ( m_glyphCount > 0 )
+	{
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		sTextVertex* const vertices = MapVertexBuffer();
+		if ( vertices )
+		{
+			WriteVertices( static_cast<float>( i_targetWidth ), static_cast<float>( i_targetHeight ), vertices );
+			UnmapVertexBuffer();
+			EAE6320_GRAPHICS_STATISTICS( CountUpload( m_glyphCount * 4 * sizeof( sTextVertex ) ) );
+			m_stats.secondCountWritingVertices = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+			DrawBuffers();
+			m_stats.drawCallCount = 1;
+		}
+		else
+		{
+			wereThereErrors = true;
+		}
+	}
+
+	Clear();
+	return !wereThereErrors;
+}
+
+// Access
+//-------
+
+const eae6320::Graphics::Texture& eae6320::Graphics::TextBatch::GetTexture() const
+{
+	EAE6320_ASSERT( m_font || m_atlas );
+	return m_font ? m_font->GetTexture() : m_atlas->GetTexture();
+}
+
+// Benchmark
+//----------
+
+void eae6320::Graphics::TextBatch::LogLayoutCost( const Font& i_font, const unsigned int i_glyphCount )
+{
+	// Only the CPU parts of the batch are used, and so it doesn't need any buffers
+	TextBatch textBatch;
+	textBatch.m_font = &i_font;
+	textBatch.AllocateVertices( i_glyphCount );
+	std::vector<sTextVertex> vertices( i_glyphCount * 4 );
+	const char* const line = "The quick brown fox jumps over the lazy dog 0123456789 (!?)";
+	// Typical HUD text is a few short lines
+	const unsigned int linesPerBlock = 8;
+	const float lineHeight = i_font.GetLineHeight();
+
+	// The first pass touches all of the memory so that the second one measures what laying out costs every frame
+	double secondCountLayingOut = 0.0, secondCountWritingVertices = 0.0;
+	for ( unsigned int pass = 0; pass < 2; ++pass )
+	{
+		textBatch.Clear();
+		unsigned int lineIndex = 0;
+		while ( ( textBatch.m_glyphCount < i_glyphCount ) && ( textBatch.m_droppedGlyphCount == 0 ) )
+		{
+			const float y = static_cast<float>( lineIndex % linesPerBlock ) * lineHeight;
+			textBatch.AddText( line, 0.0f, y );
+			++lineIndex;
+		}
+		secondCountLayingOut = textBatch.m_secondCountLayingOut;
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		textBatch.WriteVertices( 1920.0f, 1080.0f, &vertices[0] );
+		secondCountWritingVertices = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	}
+
+	const unsigned int glyphCount = textBatch.m_glyphCount;
+	Logging::OutputMessage( "Laying out %u glyphs took %.3f ms (%.1f ns per glyph)"
+		" and writing their vertices took %.3f ms (%.1f ns per glyph)",
+		glyphCount, secondCountLayingOut * 1000.0, secondCountLayingOut * 1.0e9 / glyphCount,
+		secondCountWritingVertices * 1000.0, secondCountWritingVertices * 1.0e9 / glyphCount );
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::TextBatch::Initialize( const Font& i_font, const unsigned int i_maxGlyphCount )
+{
+	m_font = &i_font;
+	return InitializeBuffers( i_maxGlyphCount );
+}
+
+bool eae6320::Graphics::TextBatch::Initialize( const Atlas& i_atlas, const unsigned int i_maxSpriteCount )
+{
+	m_atlas = &i_atlas;
+	return InitializeBuffers( i_maxSpriteCount );
+}
+
+bool eae6320::Graphics::TextBatch::CleanUp()
+{
+	const bool wereBuffersDestroyed = DestroyBuffers();
+	if ( m_vertexBufferSize != 0 )
+	{
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::IndexBuffer, m_indexBufferSize ) );
+		m_vertexBufferSize = m_indexBufferSize = 0;
+	}
+	std::vector<sTextVertex>().swap( m_vertices );
+	m_glyphCount = m_maxGlyphCount = 0;
+	m_font = NULL;
+	m_atlas = NULL;
+	return wereBuffersDestroyed;
+}
+
+eae6320::Graphics::TextBatch::TextBatch()
+	:
+	m_font( NULL ), m_atlas( NULL ), m_glyphCount( 0 ), m_maxGlyphCount( 0 ), m_droppedGlyphCount( 0 ), m_secondCountLayingOut( 0.0 ),
+	m_vertexBufferSize( 0 ), m_indexBufferSize( 0 ),
+#if defined( EAE6320_PLATFORM_D3D )
+	m_vertexBuffer( NULL ), m_indexBuffer( NULL )
+#elif defined( EAE6320_PLATFORM_GL )
+	m_vertexArrayId( 0 ), m_vertexBufferId( 0 ), m_indexBufferId( 0 )
+#endif
+{
+	const sStats noStats = { 0 };
+	m_stats = noStats;
+}
+
+eae6320::Graphics::TextBatch::~TextBatch()
+{
+	CleanUp();
+}
+
+// Implementation
+//===============
+
+void eae6320::Graphics::TextBatch::AllocateVertices( const unsigned int i_maxGlyphCount )
+{
+	EAE6320_ASSERT( i_maxGlyphCount > 0 );
+	m_maxGlyphCount = i_maxGlyphCount;
+	m_vertices.resize( i_maxGlyphCount * 4 );
+	Clear();
+}
+
+bool eae6320::Graphics::TextBatch::InitializeBuffers( const unsigned int i_maxGlyphCount )
+{
+	AllocateVertices( i_maxGlyphCount );
+	if ( !CreateBuffers() )
+	{
+		CleanUp();
+		return false;
+	}
+	// The index buffer is filled when it is created
+	m_vertexBufferSize = i_maxGlyphCount * 4 * sizeof( sTextVertex );
+	m_indexBufferSize = i_maxGlyphCount * 6 * sizeof( uint32_t );
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::VertexBuffer, m_vertexBufferSize ) );
+	EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::IndexBuffer, m_indexBufferSize ) );
+	EAE6320_GRAPHICS_STATISTICS( CountUpload( m_indexBufferSize ) );
+	return true;
+}
+
+void eae6320::Graphics::TextBatch::WriteVertices( const float i_targetWidth, const float i_targetHeight, sTextVertex* const o_vertices ) const
+{
+	// Pixels from the top left become clip space from -1 to 1 (with Y up)
+	const float scaleX = 2.0f / i_targetWidth;
+	const float scaleY = -2.0f / i_targetHeight;
+	const unsigned int vertexCount = m_glyphCount * 4;
+	const sTextVertex* const vertices = &m_vertices[0];
+	for ( unsigned int i = 0; i < vertexCount; ++i )
+	{
+		sTextVertex vertex = vertices[i];
+		vertex.x = ( vertex.x * scaleX ) - 1.0f;
+		vertex.y = ( vertex.y * scaleY ) + 1.0f;
+		// The buffer is write-combined memory, and so every byte is written exactly once in order
+		o_vertices[i] = vertex;
+	}
+}
+
+void eae6320::Graphics::TextBatch::GenerateIndices( const unsigned int i_glyphCount, std::vector<uint32_t>& o_indices )
+{
+	// Every glyph is two triangles
+	o_indices.resize( i_glyphCount * 6 );
+	for ( unsigned int i = 0; i < i_glyphCount; ++i )
+	{
+		const uint32_t firstVertex = i * 4;
+		uint32_t* const indices = &o_indices[i * 6];
+		indices[0] = firstVertex + 0;
+		indices[1] = firstVertex + 1;
+		indices[2] = firstVertex + 2;
+		indices[3] = firstVertex + 2;
+		indices[4] = firstVertex + 1;
+		indices[5] = firstVertex + 3;
+	}
+}
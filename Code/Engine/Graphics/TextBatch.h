@@ -0,0 +1,186 @@
+/*
+	A text batch lays out strings in a single font as quads
+	and draws all of them with one draw call
+
+	A batch can instead be initialized with an atlas,
+	in which case it lays out sprites from the atlas's texture the same way
+	(so that a HUD made of many images is still only one draw call)
+
+	Text is laid out on the CPU into an array of vertices (in pixels from the top left of the render target)
+	whenever it is added, and then every frame that the batch is drawn
+	the vertices are converted to clip space while they are copied into a streaming vertex buffer.
+	The index buffer never changes (every glyph is two triangles of the same four vertices),
+	and so it is only created once.
+
+	The batch is cleared after it is drawn,
+	and so text that should stay on screen must be added again every frame.
+*/
+
+#ifndef EAE6320_GRAPHICS_TEXTBATCH_H
+#define EAE6320_GRAPHICS_TEXTBATCH_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Atlas;
+		class Font;
+		class Texture;
+
+		namespace AtlasFormats
+		{
+			struct sEntry;
+		}
+
+		// This struct determines the layout of the text data that the CPU will send to the GPU
+		struct sTextVertex
+		{
+			// POSITION
+			// 2 floats == 8 bytes
+			// Offset = 0
+			float x, y;
+			// TEXCOORD
+			// 2 floats == 8 bytes
+			// Offset = 8
+			float u, v;
+			// COLOR
+			// 4 uint8_ts == 4 bytes
+			// Offset = 16
+			uint8_t r, g, b, a;
+		};
+
+		class TextBatch
+		{
+		public:
+
+			// These can be used to profile the batch
+			// (they describe the text that was drawn most recently)
+			struct sStats
+			{
+				// A sprite counts as a glyph
+				unsigned int glyphCount;
+				// Glyphs that didn't fit in the batch
+				unsigned int droppedGlyphCount;
+				// This is 0 if the batch was empty and 1 otherwise
+				unsigned int drawCallCount;
+				double secondCountLayingOut;
+				double secondCountWritingVertices;
+			};
+
+			// Layout
+			//-------
+
+			// The position is the top left of the first line, in pixels from the top left of the render target.
+			// A '\n' starts a new line, and characters that aren't in the font are drawn as '?'.
+			// The color is RGBA8 with red in the lowest byte, and the scale is relative to the size the font was built at.
+			void AddText( const char* const i_text, const float i_x, const float i_y,
+				const uint32_t i_color = 0xffffffff, const float i_scale = 1.0f );
+			// The position is the top left of the sprite in pixels from the top left of the render target,
+			// and the scale is relative to the sprite's size in the atlas.
+			// This can only be used if the batch was initialized with an atlas.
+			void AddSprite( const AtlasFormats::sEntry& i_sprite, const float i_x, const float i_y,
+				const uint32_t i_color = 0xffffffff, const float i_scale = 1.0f );
+			// This returns the width of the widest line in pixels
+			float MeasureText( const char* const i_text, const float i_scale = 1.0f ) const;
+			void Clear();
+
+			// Render
+			//-------
+
+			// This must be called from the render thread with the batch's texture and a text material bound.
+			// It clears the batch.
+			bool Draw( const unsigned int i_targetWidth, const unsigned int i_targetHeight );
+
+			// Access
+			//-------
+
+			// This is the font's texture or the atlas's texture
+			const Texture& GetTexture() const;
+			unsigned int GetGlyphCount() const { return m_glyphCount; }
+			unsigned int GetMaxGlyphCount() const { return m_maxGlyphCount; }
+			const sStats& GetStats() const { return m_stats; }
+
+			// Benchmark
+			//----------
+
+			// This lays out enough text with the font to fill a batch of the given size (without drawing it)
+			// and logs how long laying out and writing the vertices took
+			static void LogLayoutCost( const Font& i_font, const unsigned int i_glyphCount );
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Initialize( const Font& i_font, const unsigned int i_maxGlyphCount );
+			bool Initialize( const Atlas& i_atlas, const unsigned int i_maxSpriteCount );
+			bool CleanUp();
+
+			TextBatch();
+			~TextBatch();
+
+			// Implementation
+			//===============
+
+		private:
+
+			// These are the CPU parts of Initialize() and Draw()
+			void AllocateVertices( const unsigned int i_maxGlyphCount );
+			bool InitializeBuffers( const unsigned int i_maxGlyphCount );
+			void WriteVertices( const float i_targetWidth, const float i_targetHeight, sTextVertex* const o_vertices ) const;
+			// The platform-specific CreateBuffers() uses this to fill the index buffer
+			static void GenerateIndices( const unsigned int i_glyphCount, std::vector<uint32_t>& o_indices );
+
+			// Platform-specific
+			bool CreateBuffers();
+			bool DestroyBuffers();
+			sTextVertex* MapVertexBuffer();
+			void UnmapVertexBuffer();
+			void DrawBuffers();
+
+			// Data
+			//=====
+
+		private:
+
+			// Only one of these is set
+			const Font* m_font;
+			const Atlas* m_atlas;
+			sStats m_stats;
+			// 4 vertices for every glyph in pixels
+			std::vector<sTextVertex> m_vertices;
+			unsigned int m_glyphCount;
+			unsigned int m_maxGlyphCount;
+			// These are for the text that has been added since the batch was last drawn
+			unsigned int m_droppedGlyphCount;
+			double m_secondCountLayingOut;
+			// These are only used for statistics
+			size_t m_vertexBufferSize, m_indexBufferSize;
+
+#if defined( EAE6320_PLATFORM_D3D )
+			ID3D11Buffer* m_vertexBuffer;
+			ID3D11Buffer* m_indexBuffer;
+#elif defined( EAE6320_PLATFORM_GL )
+			GLuint m_vertexArrayId;
+			GLuint m_vertexBufferId;
+			GLuint m_indexBufferId;
+#endif
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_TEXTBATCH_H
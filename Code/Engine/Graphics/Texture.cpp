@@ -0,0 +1,331 @@
+// Header Files
+//=============
+
+#include "Texture.h"
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include "AssetLoader.h"
+#include "Statistics.h"
+#include "TextureStreamer.h"
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Interface
+//==========
+
+// Streaming
+//----------
+
+void eae6320::Graphics::Texture::ReportScreenSize( const float i_widthInPixels, const float i_heightInPixels )
+{
+	m_screenWidth = ( i_widthInPixels > m_screenWidth ) ? i_widthInPixels : m_screenWidth;
+	m_screenHeight = ( i_heightInPixels > m_screenHeight ) ? i_heightInPixels : m_screenHeight;
+}
+
+const uint8_t* eae6320::Graphics::Texture::GetMipDataInFile( const unsigned int i_mip ) const
+{
+	EAE6320_ASSERT( m_isStreamed && ( m_file.data != NULL ) && ( i_mip < m_mipCount ) );
+	return reinterpret_cast<const uint8_t*>( m_file.data ) + m_mips[i_mip].offset;
+}
+
+unsigned int eae6320::Graphics::Texture::ConsumeDesiredMip( const float i_mipBias )
+{
+	unsigned int desiredMip = m_mipCount - 1;
+	if ( ( m_screenWidth > 0.0f ) && ( m_screenHeight > 0.0f ) )
+	{
+		// The mip whose texels are closest to one per pixel is the one that the GPU would sample
+		const float texelsPerPixelX = static_cast<float>( m_width ) / m_screenWidth;
+		const float texelsPerPixelY = static_cast<float>( m_height ) / m_screenHeight;
+		const float texelsPerPixel = ( texelsPerPixelX > texelsPerPixelY ) ? texelsPerPixelX : texelsPerPixelY;
+		const float mip = std::floor( std::log2( texelsPerPixel ) + i_mipBias );
+		if ( mip <= 0.0f )
+		{
+			desiredMip = 0;
+		}
+		else if ( mip < static_cast<float>( desiredMip ) )
+		{
+			desiredMip = static_cast<unsigned int>( mip );
+		}
+	}
+	m_screenWidth = m_screenHeight = 0.0f;
+	return desiredMip;
+}
+
+bool eae6320::Graphics::Texture::MakeMipResident( const unsigned int i_mip, const uint8_t* const i_mipData )
+{
+	EAE6320_ASSERT( m_isStreamed && ( ( i_mip + 1 ) == m_firstResidentMip ) && ( i_mipData != NULL ) );
+	if ( ChangeFirstResidentMip( i_mip, i_mipData ) )
+	{
+		// The texture is still a single allocation (CleanUp() frees it once),
+		// and so streaming only changes its size
+		EAE6320_GRAPHICS_STATISTICS( CountResize( Statistics::eResourceType::Texture,
+			GetResidentByteCount(), GetResidentByteCount() + m_mips[i_mip].size ) );
+		m_firstResidentMip = static_cast<uint8_t>( i_mip );
+		EAE6320_GRAPHICS_STATISTICS( CountUpload( m_mips[i_mip].size ) );
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+bool eae6320::Graphics::Texture::EvictFirstResidentMip()
+{
+	EAE6320_ASSERT( m_isStreamed && ( m_firstResidentMip < m_firstPermanentMip ) );
+	const unsigned int firstResidentMip = m_firstResidentMip + 1u;
+	if ( ChangeFirstResidentMip( firstResidentMip, NULL ) )
+	{
+		EAE6320_GRAPHICS_STATISTICS( CountResize( Statistics::eResourceType::Texture,
+			GetResidentByteCount(), GetResidentByteCount() - m_mips[m_firstResidentMip].size ) );
+		m_firstResidentMip = static_cast<uint8_t>( firstResidentMip );
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+// Asynchronous Loading
+//---------------------
+
+bool eae6320::Graphics::Texture::ReadFile( const char* const i_path, const bool i_shouldBeStreamed, std::string& o_errorMessage )
+{
+	bool wereThereErrors = false;
+
+	// A texture can only be loaded once
+	EAE6320_ASSERT( ( m_mipCount == 0 ) && ( m_file.data == NULL ) );
+
+	{
+		std::string errorMessage;
+		if ( !Platform::MapBinaryFile( i_path, m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			o_errorMessage = std::string( "Failed to map the texture " ) + i_path + ": " + errorMessage;
+			goto OnExit;
+		}
+	}
+	// Validate the file before handing any of it to the GPU
+	{
+		const uint8_t* const fileData = reinterpret_cast<const uint8_t*>( m_file.data );
+		const TextureFormats::sHeader* const header = reinterpret_cast<const TextureFormats::sHeader*>( fileData );
+		const TextureFormats::sMip* const mips = reinterpret_cast<const TextureFormats::sMip*>( fileData + sizeof( TextureFormats::sHeader ) );
+		if ( ( m_file.size < sizeof( TextureFormats::sHeader ) )
+			|| ( header->fourCc != TextureFormats::s_fourCc ) || ( header->version != TextureFormats::s_version ) )
+		{
+			wereThereErrors = true;
+			o_errorMessage = std::string( "The texture " ) + i_path + " isn't a built texture (or was built by a different version of the TextureBuilder)";
+			goto OnExit;
+		}
+		if ( ( header->format >= TextureFormats::eFormat::Count )
+			|| ( header->mipCount == 0 ) || ( header->mipCount > TextureFormats::s_maxMipCount )
+			|| ( m_file.size < ( sizeof( TextureFormats::sHeader ) + ( header->mipCount * sizeof( TextureFormats::sMip ) ) ) ) )
+		{
+			wereThereErrors = true;
+			o_errorMessage = std::string( "The texture " ) + i_path + " has an invalid header";
+			goto OnExit;
+		}
+		for ( unsigned int i = 0; i < header->mipCount; ++i )
+		{
+			if ( ( static_cast<size_t>( mips[i].offset ) + mips[i].size ) > m_file.size )
+			{
+				wereThereErrors = true;
+				std::ostringstream errorMessage;
+				errorMessage << "Mip " << i << " of the texture " << i_path << " extends past the end of the file";
+				o_errorMessage = errorMessage.str();
+				goto OnExit;
+			}
+		}
+
+		m_width = header->width;
+		m_height = header->height;
+		m_mipCount = header->mipCount;
+		m_format = header->format;
+		m_flags = header->flags;
+		for ( unsigned int i = 0; i < m_mipCount; ++i )
+		{
+			m_mips[i] = mips[i];
+		}
+		// A streamed texture starts with only its permanent mips resident
+		m_isStreamed = i_shouldBeStreamed;
+		m_firstPermanentMip = 0;
+		if ( m_isStreamed )
+		{
+			const unsigned int maxPermanentMipDimension = TextureStreamer::GetSettings().maxPermanentMipDimension;
+			while ( ( ( m_firstPermanentMip + 1u ) < m_mipCount )
+				&& ( ( m_mips[m_firstPermanentMip].width > maxPermanentMipDimension ) || ( m_mips[m_firstPermanentMip].height > maxPermanentMipDimension ) ) )
+			{
+				++m_firstPermanentMip;
+			}
+		}
+		m_firstResidentMip = m_firstPermanentMip;
+
+		// Reading a byte from every page of the resident mips makes the operating system read them from disk now
+		// rather than when the GPU texture is created
+		// (the mips are stored largest first, and so the resident ones are contiguous)
+		{
+			const size_t pageSize = 4096;
+			const volatile uint8_t* const begin = fileData + m_mips[m_firstResidentMip].offset;
+			const volatile uint8_t* const end = fileData + m_mips[m_mipCount - 1].offset + m_mips[m_mipCount - 1].size;
+			uint8_t touchedValue = 0;
+			for ( const volatile uint8_t* i = begin; i < end; i += pageSize )
+			{
+				touchedValue ^= *i;
+			}
+			touchedValue ^= *( end - 1 );
+		}
+	}
+
+OnExit:
+
+	if ( wereThereErrors )
+	{
+		std::string errorMessage;
+		Platform::UnmapBinaryFile( m_file, &errorMessage );
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Graphics::Texture::CreateGpuTextureFromFile( const char* const i_path )
+{
+	bool wereThereErrors = false;
+
+	EAE6320_ASSERT( ( m_mipCount > 0 ) && ( m_file.data != NULL ) );
+	if ( CreateGpuTexture( reinterpret_cast<const uint8_t*>( m_file.data ), i_path ) )
+	{
+		EAE6320_GRAPHICS_STATISTICS( CountAllocation( Statistics::eResourceType::Texture, GetResidentByteCount() ) );
+		EAE6320_GRAPHICS_STATISTICS( CountUpload( GetResidentByteCount() ) );
+		if ( m_isStreamed )
+		{
+			TextureStreamer::Register( *this );
+		}
+	}
+	else
+	{
+		wereThereErrors = true;
+	}
+
+	// The file is only kept mapped if larger mips might be streamed from it later
+	if ( wereThereErrors || !m_isStreamed )
+	{
+		std::string errorMessage;
+		if ( !Platform::UnmapBinaryFile( m_file, &errorMessage ) )
+		{
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to unmap the texture %s: %s", i_path, errorMessage.c_str() );
+		}
+	}
+	if ( wereThereErrors )
+	{
+		m_mipCount = 0;
+		m_isStreamed = false;
+	}
+
+	return !wereThereErrors;
+}
+
+// Access
+//-------
+
+size_t eae6320::Graphics::Texture::GetResidentByteCount() const
+{
+	size_t byteCount = 0;
+	for ( unsigned int i = m_firstResidentMip; i < m_mipCount; ++i )
+	{
+		byteCount += m_mips[i].size;
+	}
+	return byteCount;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::Texture::Load( const char* const i_path, const bool i_shouldBeStreamed )
+{
+	const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+
+	{
+		std::string errorMessage;
+		if ( !ReadFile( i_path, i_shouldBeStreamed, errorMessage ) )
+		{
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "%s", errorMessage.c_str() );
+			return false;
+		}
+	}
+	if ( !CreateGpuTextureFromFile( i_path ) )
+	{
+		return false;
+	}
+
+	m_secondCountToLoad = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	Logging::OutputMessage( "Loaded the texture %s (%ux%u, %u mips, %u resident) in %.3f ms",
+		i_path, m_width, m_height, m_mipCount, m_mipCount - m_firstResidentMip, m_secondCountToLoad * 1000.0 );
+	return true;
+}
+
+void eae6320::Graphics::Texture::LoadAsync( const char* const i_path, const bool i_shouldBeStreamed )
+{
+	AssetLoader::LoadTexture( *this, i_path, i_shouldBeStreamed );
+}
+
+bool eae6320::Graphics::Texture::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	// If the file is still being read this waits for it to finish
+	const bool wasLoadInProgress = AssetLoader::CancelLoad( *this );
+	if ( m_isStreamed && !wasLoadInProgress )
+	{
+		// This waits for any mip that is still being read from the file
+		TextureStreamer::Unregister( *this );
+	}
+	// A streamed texture keeps its file mapped,
+	// as does a texture whose file has been read but whose GPU texture hasn't been created yet
+	if ( m_file.data )
+	{
+		std::string errorMessage;
+		if ( !Platform::UnmapBinaryFile( m_file, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			EAE6320_ASSERTF( false, errorMessage.c_str() );
+			Logging::OutputError( "Failed to unmap a texture: %s", errorMessage.c_str() );
+		}
+	}
+	m_isStreamed = false;
+	if ( ( m_mipCount > 0 ) && !wasLoadInProgress )
+	{
+		EAE6320_GRAPHICS_STATISTICS( CountFree( Statistics::eResourceType::Texture, GetResidentByteCount() ) );
+	}
+	if ( !DestroyGpuTexture() )
+	{
+		wereThereErrors = true;
+	}
+	m_width = m_height = 0;
+	m_mipCount = 0;
+	m_firstResidentMip = m_firstPermanentMip = 0;
+	return !wereThereErrors;
+}
+
+eae6320::Graphics::Texture::Texture()
+	:
+#if defined( EAE6320_PLATFORM_D3D )
+	m_shaderResourceView( NULL ),
+#elif defined( EAE6320_PLATFORM_GL )
+	m_textureId( 0 ),
+#endif
+	m_secondCountToLoad( 0.0 ), m_screenWidth( 0.0f ), m_screenHeight( 0.0f ), m_width( 0 ), m_height( 0 ), m_mipCount( 0 ),
+	m_format( TextureFormats::eFormat::R8G8B8A8 ), m_flags( 0 ), m_firstResidentMip( 0 ), m_firstPermanentMip( 0 ), m_isStreamed( false )
+{
+
+}
+
+eae6320::Graphics::Texture::~Texture()
+{
+	CleanUp();
+}
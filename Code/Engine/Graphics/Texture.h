@@ -0,0 +1,155 @@
+/*
+	A texture is an image that has been built by the TextureBuilder
+	and uploaded to the GPU
+
+	The built file is mapped rather than read into allocated memory,
+	and every mip is uploaded straight from the mapped data without any CPU conversion.
+
+	A streamed texture keeps its file mapped and only uploads its smallest mips when it is loaded;
+	the TextureStreamer then makes larger mips resident (and evicts them again) as they are needed.
+
+	A texture can also be loaded asynchronously:
+	The file is read on an I/O thread and the AssetLoader creates the GPU texture later on the render thread,
+	and until then binding the texture binds the AssetLoader's placeholder instead.
+*/
+
+#ifndef EAE6320_GRAPHICS_TEXTURE_H
+#define EAE6320_GRAPHICS_TEXTURE_H
+
+// Header Files
+//=============
+
+#include <string>
+#include "TextureFormats.h"
+#include "../Platform/Platform.h"
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3D11.h>
+#elif defined( EAE6320_PLATFORM_GL )
+	#include "OpenGL/Includes.h"
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Texture
+		{
+		public:
+
+			// Render
+			//-------
+
+			void Bind( const unsigned int i_textureUnit ) const;
+
+			// Streaming
+			//----------
+
+			// The game should call this every frame that a streamed texture is visible
+			// with the approximate number of pixels that it covers on screen
+			// (if it is called more than once in a frame the largest size is used)
+			void ReportScreenSize( const float i_widthInPixels, const float i_heightInPixels );
+
+			// These are used by the TextureStreamer
+
+			bool IsStreamed() const { return m_isStreamed; }
+			unsigned int GetFirstResidentMip() const { return m_firstResidentMip; }
+			// Mips from this one to the smallest are always resident
+			unsigned int GetFirstPermanentMip() const { return m_firstPermanentMip; }
+			size_t GetMipSize( const unsigned int i_mip ) const { return m_mips[i_mip].size; }
+			// This returns the mapped file data, and so reading it may have to wait for the disk
+			const uint8_t* GetMipDataInFile( const unsigned int i_mip ) const;
+			// This returns the mip that would be used for the largest screen size reported since the last call
+			// (or the smallest mip if nothing was reported),
+			// and then resets the reported size for the next frame
+			unsigned int ConsumeDesiredMip( const float i_mipBias );
+			// The mip must be the one just larger than the current first resident mip
+			bool MakeMipResident( const unsigned int i_mip, const uint8_t* const i_mipData );
+			bool EvictFirstResidentMip();
+
+			// Asynchronous Loading
+			//---------------------
+
+			// These are used by the AssetLoader
+
+			// This maps and validates the file without touching the GPU, and so it can be called from any thread
+			// (it doesn't output errors itself because logging isn't thread-safe)
+			bool ReadFile( const char* const i_path, const bool i_shouldBeStreamed, std::string& o_errorMessage );
+			// This must be called on the render thread after ReadFile() has succeeded
+			bool CreateGpuTextureFromFile( const char* const i_path );
+			void SetSecondCountToLoad( const double i_secondCount ) { m_secondCountToLoad = i_secondCount; }
+
+			// Access
+			//-------
+
+			unsigned int GetWidth() const { return m_width; }
+			unsigned int GetHeight() const { return m_height; }
+			unsigned int GetMipCount() const { return m_mipCount; }
+			// The size of every mip that is currently on the GPU
+			size_t GetResidentByteCount() const;
+			// How long the last call to Load() took
+			// (or, for an asynchronous load, how long it was from the request until the GPU texture was created)
+			double GetSecondCountToLoad() const { return m_secondCountToLoad; }
+			// This is false until the GPU texture has been created
+			bool IsLoaded() const;
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Load( const char* const i_path, const bool i_shouldBeStreamed = false );
+			// This returns immediately and the texture can be bound straight away (see the comment at the top of this file).
+			// Any errors are output once the file has been read.
+			void LoadAsync( const char* const i_path, const bool i_shouldBeStreamed = false );
+			// If the texture is still being loaded asynchronously the load is cancelled
+			bool CleanUp();
+
+			Texture();
+			~Texture();
+
+			// Implementation
+			//===============
+
+		private:
+
+			// Platform-specific
+			bool CreateGpuTexture( const uint8_t* const i_fileData, const char* const i_path );
+			// The new first resident mip can either be the next larger mip (in which case its data must be provided)
+			// or any smaller mip (in which case the mips larger than it are evicted)
+			bool ChangeFirstResidentMip( const unsigned int i_firstResidentMip, const uint8_t* const i_mipData );
+			bool DestroyGpuTexture();
+#if defined( EAE6320_PLATFORM_D3D )
+			bool CreateTextureAndView( const unsigned int i_firstMip, const D3D11_USAGE i_usage,
+				const D3D11_SUBRESOURCE_DATA* const i_initialData, ID3D11ShaderResourceView*& o_shaderResourceView ) const;
+#endif
+
+			// Data
+			//=====
+
+		private:
+
+#if defined( EAE6320_PLATFORM_D3D )
+			ID3D11ShaderResourceView* m_shaderResourceView;
+#elif defined( EAE6320_PLATFORM_GL )
+			GLuint m_textureId;
+#endif
+			// Streamed textures keep their file mapped so that mips can be read from it later
+			Platform::sMappedFile m_file;
+			TextureFormats::sMip m_mips[TextureFormats::s_maxMipCount];
+			double m_secondCountToLoad;
+			// The largest size reported since the streamer last checked
+			float m_screenWidth, m_screenHeight;
+			uint16_t m_width, m_height;
+			uint8_t m_mipCount;
+			uint8_t m_format;
+			uint8_t m_flags;
+			uint8_t m_firstResidentMip;
+			uint8_t m_firstPermanentMip;
+			bool m_isStreamed;
+		};
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_TEXTURE_H
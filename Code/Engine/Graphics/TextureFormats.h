@@ -0,0 +1,129 @@
+/*
+	This file describes the layout of a built texture file
+
+	It is shared between the TextureBuilder (which writes the file)
+	and the runtime Texture (which reads it),
+	and so it must not depend on any graphics platform.
+
+	A built texture is:
+		* An sHeader
+		* An sMip for every mip level (largest first)
+		* The data of every mip level,
+			each one starting at a multiple of s_dataAlignment bytes from the start of the file
+	The mip data is already in the format that the GPU expects
+	and can be uploaded directly from the file without any conversion.
+*/
+
+#ifndef EAE6320_GRAPHICS_TEXTUREFORMATS_H
+#define EAE6320_GRAPHICS_TEXTUREFORMATS_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace TextureFormats
+		{
+			namespace eFormat
+			{
+				enum eFormat : uint8_t
+				{
+					// Uncompressed, 4 bytes per pixel
+					R8G8B8A8,
+					// Block compressed, 8 bytes per 4x4 block (color with no alpha)
+					BC1,
+					// Block compressed, 16 bytes per 4x4 block (color with interpolated alpha)
+					BC3,
+					// Block compressed, 8 bytes per 4x4 block (a single channel)
+					BC4,
+					// Block compressed, 16 bytes per 4x4 block (two channels)
+					BC5,
+					// Block compressed, 16 bytes per 4x4 block (high quality color and alpha)
+					BC7,
+
+					Count
+				};
+			}
+
+			namespace eFlag
+			{
+				enum eFlag : uint8_t
+				{
+					// The color channels are in sRGB space and must be linearized when sampled
+					IsSrgb = 1 << 0,
+				};
+			}
+
+			// "ETEX" read as a little-endian uint32_t
+			const uint32_t s_fourCc = 0x58455445;
+			const uint16_t s_version = 1;
+			const unsigned int s_maxMipCount = 16;
+			const unsigned int s_dataAlignment = 16;
+
+			struct sHeader
+			{
+				uint32_t fourCc;
+				uint16_t version;
+				uint8_t format;
+				uint8_t flags;
+				uint16_t width, height;
+				uint8_t mipCount;
+				uint8_t padding[3];
+			};
+
+			struct sMip
+			{
+				// The offset is from the start of the file
+				uint32_t offset;
+				uint32_t size;
+				uint32_t rowPitch;
+				uint16_t width, height;
+			};
+
+			// Helper Functions
+			//-----------------
+
+			inline bool IsBlockCompressed( const uint8_t i_format )
+			{
+				return ( i_format != eFormat::R8G8B8A8 ) && ( i_format < eFormat::Count );
+			}
+
+			// For block-compressed formats this is the size of a 4x4 block,
+			// and for uncompressed formats it is the size of a single pixel
+			inline unsigned int GetBytesPerElement( const uint8_t i_format )
+			{
+				switch ( i_format )
+				{
+				case eFormat::R8G8B8A8: return 4;
+				case eFormat::BC1: return 8;
+				case eFormat::BC3: return 16;
+				case eFormat::BC4: return 8;
+				case eFormat::BC5: return 16;
+				case eFormat::BC7: return 16;
+				}
+				return 0;
+			}
+
+			inline uint32_t CalculateRowPitch( const uint8_t i_format, const uint32_t i_width )
+			{
+				const uint32_t elementCount = IsBlockCompressed( i_format ) ? ( ( i_width + 3 ) / 4 ) : i_width;
+				return elementCount * GetBytesPerElement( i_format );
+			}
+
+			inline uint32_t CalculateMipSize( const uint8_t i_format, const uint32_t i_width, const uint32_t i_height )
+			{
+				const uint32_t rowCount = IsBlockCompressed( i_format ) ? ( ( i_height + 3 ) / 4 ) : i_height;
+				return rowCount * CalculateRowPitch( i_format, i_width );
+			}
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_TEXTUREFORMATS_H
@@ -0,0 +1,347 @@
+// Header Files
+//=============
+
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Texture.h"
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+#include "../Windows/Includes.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// A mip is copied out of the mapped file on an I/O job thread
+	// so that the render thread never has to wait for the disk
+	// (every texture has at most one request, and so they can finish in any order)
+	struct sReadRequest
+	{
+		const uint8_t* source;
+		uint8_t* destination;
+		size_t size;
+		unsigned int mip;
+		// This is set by the I/O thread once the mip has been read
+		volatile LONG isComplete;
+	};
+
+	struct sStreamedTexture
+	{
+		eae6320::Graphics::Texture* texture;
+		// This is NULL unless a mip is being read
+		sReadRequest* request;
+		// The frame index that each mip was last needed during
+		uint64_t lastFrameNeeded[eae6320::Graphics::TextureFormats::s_maxMipCount];
+		unsigned int desiredMip;
+	};
+
+	eae6320::Graphics::TextureStreamer::sSettings s_settings;
+	eae6320::Graphics::TextureStreamer::sStats s_stats = { 0 };
+	std::vector<sStreamedTexture> s_streamedTextures;
+	uint64_t s_frameIndex = 0;
+	size_t s_residentByteCount = 0;
+	size_t s_pendingByteCount = 0;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void CompleteReadRequest( sStreamedTexture& io_streamedTexture );
+	// Evicts the least recently needed mips that weren't needed during the current frame
+	// until the given number of bytes fits in the budget
+	bool EvictUntilThereIsRoomFor( const size_t i_byteCount );
+	size_t CalculateResidentByteCount( const eae6320::Graphics::Texture& i_texture );
+	std::vector<sStreamedTexture>::iterator FindStreamedTexture( const eae6320::Graphics::Texture& i_texture );
+	void ReadMip( void* const io_request );
+	void WaitForReadRequest( sReadRequest& io_request );
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::TextureStreamer::Update()
+{
+	++s_frameIndex;
+	s_stats.streamedInByteCount = s_stats.evictedByteCount = 0;
+	s_stats.streamedInMipCount = s_stats.evictedMipCount = s_stats.deferredMipCount = 0;
+
+	// Upload any mips that have finished being read
+	for ( std::vector<sStreamedTexture>::iterator i = s_streamedTextures.begin(); i != s_streamedTextures.end(); ++i )
+	{
+		if ( i->request && ( i->request->isComplete != 0 ) )
+		{
+			CompleteReadRequest( *i );
+		}
+	}
+	// Find out which mip every texture needs this frame
+	std::vector<sStreamedTexture*> texturesToStream;
+	size_t desiredByteCount = 0;
+	for ( std::vector<sStreamedTexture>::iterator i = s_streamedTextures.begin(); i != s_streamedTextures.end(); ++i )
+	{
+		Texture& texture = *i->texture;
+		const unsigned int firstPermanentMip = texture.GetFirstPermanentMip();
+		i->desiredMip = std::min( texture.ConsumeDesiredMip( s_settings.mipBias ), firstPermanentMip );
+		for ( unsigned int mip = i->desiredMip; mip < texture.GetMipCount(); ++mip )
+		{
+			i->lastFrameNeeded[mip] = s_frameIndex;
+			desiredByteCount += texture.GetMipSize( mip );
+		}
+		if ( ( i->desiredMip < texture.GetFirstResidentMip() ) && ( i->request == NULL ) )
+		{
+			texturesToStream.push_back( &*i );
+		}
+	}
+	// Request the next larger mip of every texture that needs one,
+	// starting with the textures that are furthest from the mip that they need
+	std::sort( texturesToStream.begin(), texturesToStream.end(),
+		[]( const sStreamedTexture* const i_lhs, const sStreamedTexture* const i_rhs )
+		{
+			return ( i_lhs->texture->GetFirstResidentMip() - i_lhs->desiredMip ) > ( i_rhs->texture->GetFirstResidentMip() - i_rhs->desiredMip );
+		} );
+	for ( std::vector<sStreamedTexture*>::iterator i = texturesToStream.begin(); i != texturesToStream.end(); ++i )
+	{
+		sStreamedTexture& streamedTexture = **i;
+		const Texture& texture = *streamedTexture.texture;
+		const unsigned int mip = texture.GetFirstResidentMip() - 1;
+		const size_t size = texture.GetMipSize( mip );
+		if ( !EvictUntilThereIsRoomFor( size ) )
+		{
+			++s_stats.deferredMipCount;
+			continue;
+		}
+		sReadRequest* const request = new sReadRequest;
+		{
+			request->source = texture.GetMipDataInFile( mip );
+			request->destination = reinterpret_cast<uint8_t*>( malloc( size ) );
+			request->size = size;
+			request->mip = mip;
+			request->isComplete = 0;
+		}
+		if ( request->destination == NULL )
+		{
+			EAE6320_ASSERTF( false, "Failed to allocate %u bytes for a streamed mip", static_cast<unsigned int>( size ) );
+			Logging::OutputError( "Failed to allocate %u bytes to stream mip %u of a texture into", static_cast<unsigned int>( size ), mip );
+			delete request;
+			continue;
+		}
+		streamedTexture.request = request;
+		s_pendingByteCount += size;
+		Jobs::SubmitIoJob( ReadMip, request );
+	}
+	// If the budget has been reduced there may still be too much resident
+	EvictUntilThereIsRoomFor( 0 );
+
+	// Update the stats
+	{
+		s_stats.budgetByteCount = s_settings.budgetInBytes;
+		s_stats.residentByteCount = s_residentByteCount;
+		s_stats.pendingByteCount = s_pendingByteCount;
+		s_stats.desiredByteCount = desiredByteCount;
+		s_stats.textureCount = static_cast<unsigned int>( s_streamedTextures.size() );
+		s_stats.residentMipCount = s_stats.pendingMipCount = 0;
+		for ( std::vector<sStreamedTexture>::const_iterator i = s_streamedTextures.begin(); i != s_streamedTextures.end(); ++i )
+		{
+			s_stats.residentMipCount += i->texture->GetMipCount() - i->texture->GetFirstResidentMip();
+			s_stats.pendingMipCount += i->request ? 1 : 0;
+		}
+	}
+}
+
+// Access
+//-------
+
+const eae6320::Graphics::TextureStreamer::sSettings& eae6320::Graphics::TextureStreamer::GetSettings()
+{
+	return s_settings;
+}
+
+const eae6320::Graphics::TextureStreamer::sStats& eae6320::Graphics::TextureStreamer::GetStats()
+{
+	return s_stats;
+}
+
+// Streamed Textures
+//------------------
+
+void eae6320::Graphics::TextureStreamer::Register( Texture& io_texture )
+{
+	EAE6320_ASSERT( io_texture.IsStreamed() );
+	EAE6320_ASSERT( FindStreamedTexture( io_texture ) == s_streamedTextures.end() );
+
+	sStreamedTexture streamedTexture;
+	{
+		streamedTexture.texture = &io_texture;
+		streamedTexture.request = NULL;
+		for ( unsigned int i = 0; i < TextureFormats::s_maxMipCount; ++i )
+		{
+			streamedTexture.lastFrameNeeded[i] = s_frameIndex;
+		}
+		streamedTexture.desiredMip = io_texture.GetFirstResidentMip();
+	}
+	s_streamedTextures.push_back( streamedTexture );
+	s_residentByteCount += CalculateResidentByteCount( io_texture );
+}
+
+void eae6320::Graphics::TextureStreamer::Unregister( Texture& io_texture )
+{
+	std::vector<sStreamedTexture>::iterator streamedTexture = FindStreamedTexture( io_texture );
+	if ( streamedTexture != s_streamedTextures.end() )
+	{
+		if ( streamedTexture->request )
+		{
+			// The request reads from the texture's mapped file, and so it must finish before the file is unmapped
+			WaitForReadRequest( *streamedTexture->request );
+			s_pendingByteCount -= streamedTexture->request->size;
+			free( streamedTexture->request->destination );
+			delete streamedTexture->request;
+		}
+		s_residentByteCount -= CalculateResidentByteCount( io_texture );
+		s_streamedTextures.erase( streamedTexture );
+	}
+	else
+	{
+		EAE6320_ASSERTF( false, "A texture is being unregistered that was never registered" );
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::TextureStreamer::Initialize( const sSettings& i_settings )
+{
+	s_settings = i_settings;
+	s_frameIndex = 0;
+	s_residentByteCount = s_pendingByteCount = 0;
+	memset( &s_stats, 0, sizeof( s_stats ) );
+	s_stats.budgetByteCount = s_settings.budgetInBytes;
+	Logging::OutputMessage( "Initialized the texture streamer with a budget of %.2f MB",
+		static_cast<double>( s_settings.budgetInBytes ) / ( 1024.0 * 1024.0 ) );
+	return true;
+}
+
+bool eae6320::Graphics::TextureStreamer::CleanUp()
+{
+	// Every streamed texture should have been cleaned up before the streamer
+	EAE6320_ASSERTF( s_streamedTextures.empty(), "%u streamed textures weren't cleaned up", static_cast<unsigned int>( s_streamedTextures.size() ) );
+	for ( std::vector<sStreamedTexture>::iterator i = s_streamedTextures.begin(); i != s_streamedTextures.end(); ++i )
+	{
+		if ( i->request )
+		{
+			WaitForReadRequest( *i->request );
+			free( i->request->destination );
+			delete i->request;
+		}
+	}
+	s_streamedTextures.clear();
+	s_residentByteCount = s_pendingByteCount = 0;
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void CompleteReadRequest( sStreamedTexture& io_streamedTexture )
+	{
+		sReadRequest* const request = io_streamedTexture.request;
+		// The resident mips of a texture with a pending request are never evicted,
+		// and so the mip that was read must still be the next one that is needed
+		EAE6320_ASSERT( ( request->mip + 1 ) == io_streamedTexture.texture->GetFirstResidentMip() );
+		if ( io_streamedTexture.texture->MakeMipResident( request->mip, request->destination ) )
+		{
+			s_residentByteCount += request->size;
+			s_stats.streamedInByteCount += request->size;
+			++s_stats.streamedInMipCount;
+		}
+		s_pendingByteCount -= request->size;
+		free( request->destination );
+		delete request;
+		io_streamedTexture.request = NULL;
+	}
+
+	bool EvictUntilThereIsRoomFor( const size_t i_byteCount )
+	{
+		while ( ( s_residentByteCount + s_pendingByteCount + i_byteCount ) > s_settings.budgetInBytes )
+		{
+			// Only the largest resident mip of a texture can be evicted
+			sStreamedTexture* leastRecentlyNeededTexture = NULL;
+			uint64_t leastRecentFrame = s_frameIndex;
+			for ( std::vector<sStreamedTexture>::iterator i = s_streamedTextures.begin(); i != s_streamedTextures.end(); ++i )
+			{
+				const eae6320::Graphics::Texture& texture = *i->texture;
+				const unsigned int mip = texture.GetFirstResidentMip();
+				if ( ( mip < texture.GetFirstPermanentMip() ) && ( i->request == NULL ) && ( i->lastFrameNeeded[mip] < leastRecentFrame ) )
+				{
+					leastRecentlyNeededTexture = &*i;
+					leastRecentFrame = i->lastFrameNeeded[mip];
+				}
+			}
+			if ( leastRecentlyNeededTexture == NULL )
+			{
+				return false;
+			}
+			eae6320::Graphics::Texture& texture = *leastRecentlyNeededTexture->texture;
+			const size_t size = texture.GetMipSize( texture.GetFirstResidentMip() );
+			if ( !texture.EvictFirstResidentMip() )
+			{
+				return false;
+			}
+			s_residentByteCount -= size;
+			s_stats.evictedByteCount += size;
+			++s_stats.evictedMipCount;
+		}
+		return true;
+	}
+
+	size_t CalculateResidentByteCount( const eae6320::Graphics::Texture& i_texture )
+	{
+		size_t byteCount = 0;
+		for ( unsigned int i = i_texture.GetFirstResidentMip(); i < i_texture.GetMipCount(); ++i )
+		{
+			byteCount += i_texture.GetMipSize( i );
+		}
+		return byteCount;
+	}
+
+	std::vector<sStreamedTexture>::iterator FindStreamedTexture( const eae6320::Graphics::Texture& i_texture )
+	{
+		std::vector<sStreamedTexture>::iterator i = s_streamedTextures.begin();
+		for ( ; i != s_streamedTextures.end(); ++i )
+		{
+			if ( i->texture == &i_texture )
+			{
+				break;
+			}
+		}
+		return i;
+	}
+
+	void ReadMip( void* const io_request )
+	{
+		sReadRequest& request = *reinterpret_cast<sReadRequest*>( io_request );
+		// Copying from the mapped file is what makes the operating system read the mip from disk
+		memcpy( request.destination, request.source, request.size );
+		// The exchange is a full memory barrier, and so the mip will be visible to the render thread
+		InterlockedExchange( &request.isComplete, 1 );
+	}
+
+	void WaitForReadRequest( sReadRequest& io_request )
+	{
+		while ( io_request.isComplete == 0 )
+		{
+			SwitchToThread();
+		}
+	}
+}
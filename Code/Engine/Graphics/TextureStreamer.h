@@ -0,0 +1,109 @@
+/*
+	The texture streamer decides which mips of streamed textures should be resident on the GPU
+
+	A streamed texture only has its smallest mips uploaded when it is loaded.
+	Every frame the game reports how large each texture appears on screen,
+	and the streamer uses that to decide which mip each texture needs.
+	Larger mips are then read from disk on the I/O job threads
+	and uploaded one at a time (largest deficit first)
+	for as long as the resident mips fit within the memory budget.
+	When a new mip doesn't fit, the mips that were needed least recently are evicted to make room
+	(a mip that was needed during the current frame is never evicted).
+*/
+
+#ifndef EAE6320_GRAPHICS_TEXTURESTREAMER_H
+#define EAE6320_GRAPHICS_TEXTURESTREAMER_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+
+// Forward Declarations
+//=====================
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		class Texture;
+	}
+}
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace TextureStreamer
+		{
+			struct sSettings
+			{
+				// The total size of every resident mip of every streamed texture
+				size_t budgetInBytes;
+				// Mips whose width and height are both this size or smaller
+				// are uploaded when a texture is loaded and are never evicted
+				unsigned int maxPermanentMipDimension;
+				// This is added to the mip that each texture needs
+				// (a positive bias trades sharpness for memory)
+				float mipBias;
+
+				sSettings() : budgetInBytes( 64 * 1024 * 1024 ), maxPermanentMipDimension( 64 ), mipBias( 0.0f ) {}
+			};
+
+			// These describe the streamer after the most recent call to Update()
+			struct sStats
+			{
+				size_t budgetByteCount;
+				size_t residentByteCount;
+				// Mips that are being read from disk count against the budget
+				size_t pendingByteCount;
+				// How many bytes would be resident if the budget were unlimited
+				size_t desiredByteCount;
+				unsigned int textureCount;
+				unsigned int residentMipCount;
+				unsigned int pendingMipCount;
+
+				// These only count what happened during the most recent call to Update()
+				size_t streamedInByteCount;
+				size_t evictedByteCount;
+				unsigned int streamedInMipCount;
+				unsigned int evictedMipCount;
+				// Mips that were needed but didn't fit in the budget
+				unsigned int deferredMipCount;
+			};
+
+			// Render
+			//-------
+
+			// This must be called once every frame from the render thread
+			// (it uploads mips that have finished loading and then decides which mips to load and evict)
+			void Update();
+
+			// Access
+			//-------
+
+			const sSettings& GetSettings();
+			const sStats& GetStats();
+
+			// Streamed Textures
+			//------------------
+
+			// These are called by Texture when a streamed texture is loaded and cleaned up
+			void Register( Texture& io_texture );
+			// If a mip of the texture is still being read from disk this waits for it to finish
+			void Unregister( Texture& io_texture );
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Initialize( const sSettings& i_settings );
+			bool CleanUp();
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_TEXTURESTREAMER_H
@@ -0,0 +1,249 @@
+// Header Files
+//=============
+
+#include "UploadManager.h"
+
+#include <cstring>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Frame 0 is never recorded, and so it means that a batch hasn't been copied from yet
+	const uint64_t s_noFrame = 0;
+	// Allocations are aligned so that they can be copied into any kind of resource
+	const size_t s_allocationAlignment = 16;
+
+	eae6320::Graphics::UploadManager::sSettings s_settings;
+	eae6320::Graphics::UploadManager::sStats s_stats = { 0 };
+	size_t s_batchByteCount = 0;
+	// The frame that each batch's copies were last submitted during
+	uint64_t s_batchFrames[eae6320::Graphics::UploadManager::s_batchCount] = { 0 };
+	unsigned int s_currentBatch = 0;
+	// The current batch is only mapped once something is allocated from it
+	uint8_t* s_currentBatchMemory = NULL;
+	size_t s_currentBatchUsedByteCount = 0;
+	size_t s_currentBatchUploadedByteCount = 0;
+	bool s_isInitialized = false;
+
+	// These are published in the stats when the frame is flushed
+	size_t s_uploadedByteCount_frame = 0;
+	unsigned int s_copyCount_frame = 0;
+	unsigned int s_batchCount_frame = 0;
+	// The bandwidth is measured over windows of about a second
+	uint64_t s_tickCount_windowStart = 0;
+	uint64_t s_uploadedByteCount_window = 0;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// The current batch's copies are submitted and the next batch becomes the current one
+	void SubmitBatch();
+}
+
+// Interface
+//==========
+
+// Render
+//-------
+
+void eae6320::Graphics::UploadManager::Flush()
+{
+	EAE6320_ASSERT( s_isInitialized );
+
+	SubmitBatch();
+
+	// Update the stats
+	{
+		s_stats.uploadedByteCount = s_uploadedByteCount_frame;
+		s_stats.copyCount = s_copyCount_frame;
+		s_stats.batchCount = s_batchCount_frame;
+		s_stats.totalUploadedByteCount += s_uploadedByteCount_frame;
+		s_uploadedByteCount_frame = 0;
+		s_copyCount_frame = 0;
+		s_batchCount_frame = 0;
+	}
+	{
+		s_uploadedByteCount_window += s_stats.uploadedByteCount;
+		const uint64_t tickCount_current = Time::GetCurrentSystemTimeTickCount();
+		const double secondCountInWindow = Time::ConvertTicksToSeconds( tickCount_current - s_tickCount_windowStart );
+		if ( secondCountInWindow >= 1.0 )
+		{
+			s_stats.bytesPerSecond = static_cast<double>( s_uploadedByteCount_window ) / secondCountInWindow;
+			s_uploadedByteCount_window = 0;
+			s_tickCount_windowStart = tickCount_current;
+		}
+	}
+}
+
+// Staging
+//--------
+
+bool eae6320::Graphics::UploadManager::Allocate( const size_t i_size, sAllocation& o_allocation )
+{
+	EAE6320_ASSERTF( s_isInitialized, "Staging memory can't be allocated before the upload manager is initialized" );
+	if ( !s_isInitialized || ( i_size > s_batchByteCount ) )
+	{
+		++s_stats.directUploadCount;
+		return false;
+	}
+
+	size_t offset = ( s_currentBatchUsedByteCount + ( s_allocationAlignment - 1 ) ) & ~( s_allocationAlignment - 1 );
+	if ( ( offset + i_size ) > s_batchByteCount )
+	{
+		SubmitBatch();
+		offset = 0;
+	}
+	if ( !s_currentBatchMemory )
+	{
+		// If every batch has already been copied from during this frame
+		// then none of them can be reused until the frame has ended
+		const uint64_t frame = s_batchFrames[s_currentBatch];
+		if ( frame == FrameFences::GetCurrentFrame() )
+		{
+			++s_stats.directUploadCount;
+			return false;
+		}
+		// The GPU might still be copying from the batch during a frame that hasn't retired
+		if ( frame > FrameFences::GetLastRetiredFrame() )
+		{
+			// (the fences often turn out to have been signaled already, and then nothing is counted)
+			const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+			if ( FrameFences::WaitForFrame( frame ) )
+			{
+				s_stats.secondCountStalled += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+				++s_stats.stallCount;
+			}
+		}
+		s_currentBatchMemory = MapBatch( s_currentBatch );
+		if ( !s_currentBatchMemory )
+		{
+			++s_stats.directUploadCount;
+			return false;
+		}
+	}
+
+	o_allocation.data = s_currentBatchMemory + offset;
+	o_allocation.size = i_size;
+	o_allocation.offset = offset;
+	o_allocation.batchIndex = s_currentBatch;
+	s_currentBatchUsedByteCount = offset + i_size;
+	s_currentBatchUploadedByteCount += i_size;
+	return true;
+}
+
+// Access
+//-------
+
+const eae6320::Graphics::UploadManager::sSettings& eae6320::Graphics::UploadManager::GetSettings()
+{
+	return s_settings;
+}
+
+const eae6320::Graphics::UploadManager::sStats& eae6320::Graphics::UploadManager::GetStats()
+{
+	return s_stats;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Graphics::UploadManager::Initialize( const sSettings& i_settings )
+{
+	EAE6320_ASSERT( !s_isInitialized );
+
+	s_settings = i_settings;
+	// Every batch starts on an aligned offset
+	s_batchByteCount = ( s_settings.stagingByteCount / s_batchCount ) & ~( s_allocationAlignment - 1 );
+	if ( s_batchByteCount == 0 )
+	{
+		EAE6320_ASSERTF( false, "The staging ring is too small" );
+		Logging::OutputError( "The upload manager's staging ring (%u bytes) is too small to be split into %u batches",
+			static_cast<unsigned int>( s_settings.stagingByteCount ), s_batchCount );
+		return false;
+	}
+	if ( !CreateStagingBuffers( s_batchByteCount ) )
+	{
+		return false;
+	}
+	for ( unsigned int i = 0; i < s_batchCount; ++i )
+	{
+		s_batchFrames[i] = s_noFrame;
+	}
+	s_currentBatch = 0;
+	s_currentBatchMemory = NULL;
+	s_currentBatchUsedByteCount = s_currentBatchUploadedByteCount = 0;
+	s_uploadedByteCount_frame = 0;
+	s_copyCount_frame = s_batchCount_frame = 0;
+	s_tickCount_windowStart = Time::GetCurrentSystemTimeTickCount();
+	s_uploadedByteCount_window = 0;
+	memset( &s_stats, 0, sizeof( s_stats ) );
+	s_stats.stagingByteCount = s_batchByteCount * s_batchCount;
+	s_stats.batchByteCount = s_batchByteCount;
+	s_isInitialized = true;
+
+	Logging::OutputMessage( "Initialized the upload manager with %u staging batches of %.1f MB",
+		s_batchCount, s_batchByteCount / ( 1024.0 * 1024.0 ) );
+	return true;
+}
+
+bool eae6320::Graphics::UploadManager::CleanUp()
+{
+	if ( !s_isInitialized )
+	{
+		return true;
+	}
+
+	if ( s_currentBatchMemory )
+	{
+		UnmapBatch( s_currentBatch );
+		s_currentBatchMemory = NULL;
+	}
+	DiscardCopies();
+	DestroyStagingBuffers();
+	s_isInitialized = false;
+
+	Logging::OutputMessage( "The upload manager uploaded %.1f MB (at most %.1f KB in one batch)"
+		" and the CPU stalled waiting for a batch %u times (for %.3f ms in total);"
+		" %u uploads didn't fit and were made directly",
+		s_stats.totalUploadedByteCount / ( 1024.0 * 1024.0 ), s_stats.maxBatchByteCount / 1024.0,
+		s_stats.stallCount, s_stats.secondCountStalled * 1000.0, s_stats.directUploadCount );
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void SubmitBatch()
+	{
+		if ( s_currentBatchMemory )
+		{
+			eae6320::Graphics::UploadManager::UnmapBatch( s_currentBatch );
+			s_currentBatchMemory = NULL;
+		}
+		if ( s_currentBatchUsedByteCount == 0 )
+		{
+			return;
+		}
+
+		s_copyCount_frame += eae6320::Graphics::UploadManager::SubmitCopies( s_currentBatch );
+		s_uploadedByteCount_frame += s_currentBatchUploadedByteCount;
+		++s_batchCount_frame;
+		if ( s_currentBatchUsedByteCount > s_stats.maxBatchByteCount )
+		{
+			s_stats.maxBatchByteCount = s_currentBatchUsedByteCount;
+		}
+		s_batchFrames[s_currentBatch] = eae6320::Graphics::FrameFences::GetCurrentFrame();
+		s_currentBatch = ( s_currentBatch + 1 ) % eae6320::Graphics::UploadManager::s_batchCount;
+		s_currentBatchUsedByteCount = s_currentBatchUploadedByteCount = 0;
+	}
+}
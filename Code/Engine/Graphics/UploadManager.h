@@ -0,0 +1,149 @@
+/*
+	The upload manager owns a staging ring that data is written into before the GPU copies it into its resources
+
+	Instead of giving each new resource its initial data (which makes the driver copy it when the resource is created)
+	the data is written straight into staging memory and a copy is queued,
+	and every queued copy is submitted at once when the frame is flushed.
+	The ring is split into s_batchCount batches of the same size;
+	a batch is filled until it is flushed (or until it doesn't have room for an allocation)
+	and then the next batch is used.
+	A batch's memory can't be written to again until the GPU has finished the frame that copied from it,
+	and if that frame is still in flight the CPU waits for its fence (which is counted as a stall).
+
+	Direct3D 11 can't copy from a resource while it is mapped,
+	and so every batch is its own staging buffer that is mapped while the batch is being filled.
+	OpenGL maps the whole ring once if the driver supports ARB_buffer_storage,
+	and otherwise maps each batch without synchronization while it is being filled
+	(which is safe because the batch's frame has retired).
+	Direct3D 11 also can't copy from a buffer into a texture,
+	and so only OpenGL textures are uploaded through the ring.
+*/
+
+#ifndef EAE6320_GRAPHICS_UPLOADMANAGER_H
+#define EAE6320_GRAPHICS_UPLOADMANAGER_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include "FrameFences.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Graphics
+	{
+		namespace UploadManager
+		{
+			// A batch can only be reused once the frame that copied from it has retired,
+			// and so with one batch per frame the CPU only waits when it gets further ahead than the fences allow
+			const unsigned int s_batchCount = FrameFences::s_maxFrameCountInFlight + 1;
+
+			struct sSettings
+			{
+				// The size of the whole ring (every batch gets an equal part of it)
+				size_t stagingByteCount;
+
+				sSettings() : stagingByteCount( 32 * 1024 * 1024 ) {}
+			};
+
+			// These describe the manager after the most recent call to Flush()
+			struct sStats
+			{
+				size_t stagingByteCount;
+				size_t batchByteCount;
+
+				// These only count what happened since the previous call to Flush()
+				size_t uploadedByteCount;
+				unsigned int copyCount;
+				unsigned int batchCount;
+
+				// The bytes that were uploaded during about the last second
+				double bytesPerSecond;
+
+				// These count everything since the manager was initialized
+				uint64_t totalUploadedByteCount;
+				size_t maxBatchByteCount;
+				// Times that the CPU had to wait for the GPU to finish copying from a batch before it could be reused
+				unsigned int stallCount;
+				double secondCountStalled;
+				// Allocations that didn't fit and whose data had to be uploaded directly
+				unsigned int directUploadCount;
+			};
+
+			// Staging memory that a copy can be queued from
+			struct sAllocation
+			{
+				// This can only be written to (reading from it can be very slow)
+				uint8_t* data;
+				size_t size;
+				// These are used by the platform-specific code
+				size_t offset;
+				unsigned int batchIndex;
+			};
+
+			// Render
+			//-------
+
+			// This must be called once every frame from the render thread
+			// before anything that uses the copied resources is drawn
+			// (it submits every copy that has been queued)
+			void Flush();
+
+			// Staging
+			//--------
+
+			// These must be called from the render thread.
+			// If false is returned there wasn't room and the data must be uploaded some other way;
+			// otherwise the allocation must be written to and its copy queued
+			// before Allocate() or Flush() is called again
+			// (a full batch is submitted early when a later allocation doesn't fit).
+			bool Allocate( const size_t i_size, sAllocation& o_allocation );
+#if defined( EAE6320_PLATFORM_D3D )
+			// The buffer must not be immutable
+			// (the manager holds a reference to it until the copy has been submitted)
+			void CopyToBuffer( const sAllocation& i_source, ID3D11Buffer* const io_destination, const unsigned int i_destinationOffset = 0 );
+#elif defined( EAE6320_PLATFORM_GL )
+			// The buffer or texture must not be deleted before the copy has been submitted
+			// (deferring its deletion with FrameFences guarantees this)
+			void CopyToBuffer( const sAllocation& i_source, const GLuint i_destinationId, const size_t i_destinationOffset = 0 );
+			// The mip must already have storage.
+			// i_compressedFormat is the internal format of a block-compressed mip or GL_NONE if the data is RGBA8.
+			void CopyToTexture( const sAllocation& i_source, const GLuint i_textureId, const unsigned int i_mip,
+				const unsigned int i_width, const unsigned int i_height, const GLenum i_compressedFormat );
+#endif
+
+			// Access
+			//-------
+
+			const sSettings& GetSettings();
+			const sStats& GetStats();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			bool Initialize( const sSettings& i_settings );
+			// Any copies that haven't been submitted are discarded
+			bool CleanUp();
+
+			// Implementation
+			//===============
+
+			// These are platform-specific and are only called by UploadManager.cpp
+			// (every batch has an index from 0 to s_batchCount - 1)
+			bool CreateStagingBuffers( const size_t i_batchByteCount );
+			void DestroyStagingBuffers();
+			// NULL is returned if the batch couldn't be mapped
+			uint8_t* MapBatch( const unsigned int i_batchIndex );
+			void UnmapBatch( const unsigned int i_batchIndex );
+			// This submits every copy that was queued from the batch and returns how many there were
+			unsigned int SubmitCopies( const unsigned int i_batchIndex );
+			void DiscardCopies();
+		}
+	}
+}
+
+#endif	// EAE6320_GRAPHICS_UPLOADMANAGER_H
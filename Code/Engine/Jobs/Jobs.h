@@ -0,0 +1,71 @@
+/*
+	This file provides a pool of worker threads
+	that data-parallel work can be split across,
+	a background thread for work that spends most of its time waiting (e.g. reading files),
+	and a small pool of I/O threads for reads that don't have to happen in any particular order
+*/
+
+#ifndef EAE6320_JOBS_H
+#define EAE6320_JOBS_H
+
+#ifndef NULL
+	#define NULL 0
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Jobs
+	{
+		// A job function is called once for every batch of work,
+		// and it should process the elements in the range [i_begin, i_end)
+		typedef void ( *fJob )( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+		// A background job is called once
+		typedef void ( *fBackgroundJob )( void* const io_userData );
+
+		// Parallel Work
+		//--------------
+
+		// The range [0, i_count) is split into batches of (at most) i_batchSize elements
+		// and the batches are distributed across the worker threads and the calling thread.
+		// The function only returns once every batch has finished.
+		// If the workers are already busy (e.g. if this is called from inside of a job)
+		// all of the batches are run on the calling thread instead.
+		void ParallelFor( const unsigned int i_count, const unsigned int i_batchSize, fJob i_job, void* const io_userData = NULL );
+
+		// Background Work
+		//----------------
+
+		// The job is queued and then run on the background thread (in the order that jobs were submitted),
+		// and so this function returns immediately.
+		// The caller is responsible for finding out when the job has finished
+		// (e.g. by having the job set a flag in its user data).
+		// If the background thread doesn't exist the job is run on the calling thread instead.
+		void SubmitBackgroundJob( fBackgroundJob i_job, void* const io_userData = NULL );
+
+		// I/O Work
+		//---------
+
+		// The job is queued and then run on one of the I/O threads, and so this function returns immediately.
+		// More than one I/O job can be in flight at once, and so they can finish in any order
+		// (the background thread should be used instead if jobs depend on each other).
+		// If there are no I/O threads the job is run on the calling thread instead.
+		void SubmitIoJob( fBackgroundJob i_job, void* const io_userData = NULL );
+
+		// Info
+		//-----
+
+		// This doesn't include the calling thread
+		unsigned int GetWorkerThreadCount();
+
+		// Initialization / Clean Up
+		//--------------------------
+
+		bool Initialize();
+		bool CleanUp();
+	}
+}
+
+#endif	// EAE6320_JOBS_H
@@ -0,0 +1,470 @@
+// Header Files
+//=============
+
+#include "../Jobs.h"
+
+#include <deque>
+#include "../../Asserts/Asserts.h"
+#include "../../Logging/Logging.h"
+#include "../../Windows/Includes.h"
+#include "../../Windows/Functions.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// There is only ever a single job in flight;
+	// all of the workers cooperate on it by claiming batches until none are left
+	struct sJob
+	{
+		eae6320::Jobs::fJob function;
+		void* userData;
+		unsigned int count;
+		unsigned int batchSize;
+		LONG batchCount;
+		volatile LONG nextBatchIndex;
+		volatile LONG activeWorkerCount;
+	} s_job = { 0 };
+
+	HANDLE* s_workerThreads = NULL;
+	unsigned int s_workerThreadCount = 0;
+	// Workers sleep on this semaphore until there is a job
+	HANDLE s_wakeUpWorkers = NULL;
+	// The last worker to finish a job signals this event
+	HANDLE s_haveWorkersFinished = NULL;
+	volatile LONG s_isJobInProgress = 0;
+	volatile LONG s_shouldWorkersExit = 0;
+
+	// Background and I/O jobs are queued and run by threads that only take jobs from their own queue
+	struct sBackgroundJob
+	{
+		eae6320::Jobs::fBackgroundJob function;
+		void* userData;
+	};
+	struct sJobQueue
+	{
+		std::deque<sBackgroundJob> jobs;
+		CRITICAL_SECTION lock;
+		bool isLockInitialized;
+		HANDLE* threads;
+		unsigned int threadCount;
+		// The semaphore's count is the number of queued jobs
+		HANDLE jobCount;
+		volatile LONG shouldThreadsExit;
+	};
+	// The background queue only has one thread so that its jobs run in the order that they were submitted
+	sJobQueue s_backgroundQueue;
+	// Reading a file is mostly spent waiting for the disk,
+	// and so a few reads are kept in flight at once
+	sJobQueue s_ioQueue;
+	const unsigned int s_ioThreadCount = 2;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void ExecuteBatches();
+	void RunInline( const unsigned int i_count, eae6320::Jobs::fJob i_job, void* const io_userData );
+	void SubmitToQueue( sJobQueue& io_queue, eae6320::Jobs::fBackgroundJob i_job, void* const io_userData );
+	bool StartQueue( sJobQueue& io_queue, const unsigned int i_threadCount, const char* const i_name );
+	// Any jobs that are still queued are finished before the threads exit
+	bool StopQueue( sJobQueue& io_queue, const char* const i_name );
+	DWORD WINAPI QueueThreadMain( void* io_queue );
+	DWORD WINAPI WorkerThreadMain( void* );
+}
+
+// Interface
+//==========
+
+// Parallel Work
+//--------------
+
+void eae6320::Jobs::ParallelFor( const unsigned int i_count, const unsigned int i_batchSize, fJob i_job, void* const io_userData )
+{
+	EAE6320_ASSERT( i_job != NULL );
+	if ( i_count == 0 )
+	{
+		return;
+	}
+	const unsigned int batchSize = ( i_batchSize > 0 ) ? i_batchSize : i_count;
+	const unsigned int batchCount = ( i_count + batchSize - 1 ) / batchSize;
+	// There is no point in waking up the workers when there is nothing to split,
+	// and if another job is already using them the work is done on this thread
+	if ( ( s_workerThreadCount == 0 ) || ( batchCount == 1 )
+		|| ( InterlockedCompareExchange( &s_isJobInProgress, 1, 0 ) != 0 ) )
+	{
+		RunInline( i_count, i_job, io_userData );
+		return;
+	}
+
+	// Publish the job
+	const LONG workersToWake = static_cast<LONG>( ( ( batchCount - 1 ) < s_workerThreadCount ) ? ( batchCount - 1 ) : s_workerThreadCount );
+	{
+		s_job.function = i_job;
+		s_job.userData = io_userData;
+		s_job.count = i_count;
+		s_job.batchSize = batchSize;
+		s_job.batchCount = static_cast<LONG>( batchCount );
+		s_job.nextBatchIndex = 0;
+		s_job.activeWorkerCount = workersToWake;
+		ResetEvent( s_haveWorkersFinished );
+	}
+	// Wake up as many workers as can be used
+	// (the semaphore release is a full memory barrier, and so the job will be visible to them)
+	ReleaseSemaphore( s_wakeUpWorkers, workersToWake, NULL );
+	// This thread helps rather than just waiting
+	ExecuteBatches();
+	// Wait for any batches that workers are still executing
+	{
+		const DWORD result = WaitForSingleObject( s_haveWorkersFinished, INFINITE );
+		EAE6320_ASSERT( result == WAIT_OBJECT_0 );
+	}
+
+	InterlockedExchange( &s_isJobInProgress, 0 );
+}
+
+// Background Work
+//----------------
+
+void eae6320::Jobs::SubmitBackgroundJob( fBackgroundJob i_job, void* const io_userData )
+{
+	SubmitToQueue( s_backgroundQueue, i_job, io_userData );
+}
+
+// I/O Work
+//---------
+
+void eae6320::Jobs::SubmitIoJob( fBackgroundJob i_job, void* const io_userData )
+{
+	SubmitToQueue( s_ioQueue, i_job, io_userData );
+}
+
+// Info
+//-----
+
+unsigned int eae6320::Jobs::GetWorkerThreadCount()
+{
+	return s_workerThreadCount;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+bool eae6320::Jobs::Initialize()
+{
+	bool wereThereErrors = false;
+
+	// Use one worker for every logical processor except the one that the calling thread is using
+	unsigned int workerThreadCount;
+	{
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo( &systemInfo );
+		workerThreadCount = ( systemInfo.dwNumberOfProcessors > 1 ) ? ( systemInfo.dwNumberOfProcessors - 1 ) : 0;
+	}
+
+	// Create the synchronization objects
+	{
+		const LONG initialCount = 0;
+		const LONG maximumCount = ( workerThreadCount > 0 ) ? static_cast<LONG>( workerThreadCount ) : 1;
+		s_wakeUpWorkers = CreateSemaphore( NULL, initialCount, maximumCount, NULL );
+		if ( s_wakeUpWorkers == NULL )
+		{
+			wereThereErrors = true;
+			const std::string windowsErrorMessage = Windows::GetLastSystemError();
+			EAE6320_ASSERTF( false, windowsErrorMessage.c_str() );
+			Logging::OutputError( "Windows failed to create the job semaphore: %s", windowsErrorMessage.c_str() );
+			goto OnExit;
+		}
+	}
+	{
+		const BOOL manualReset = TRUE;
+		const BOOL initiallySignaled = FALSE;
+		s_haveWorkersFinished = CreateEvent( NULL, manualReset, initiallySignaled, NULL );
+		if ( s_haveWorkersFinished == NULL )
+		{
+			wereThereErrors = true;
+			const std::string windowsErrorMessage = Windows::GetLastSystemError();
+			EAE6320_ASSERTF( false, windowsErrorMessage.c_str() );
+			Logging::OutputError( "Windows failed to create the job completion event: %s", windowsErrorMessage.c_str() );
+			goto OnExit;
+		}
+	}
+
+	// Start the workers
+	if ( workerThreadCount > 0 )
+	{
+		s_shouldWorkersExit = 0;
+		s_workerThreads = new HANDLE[workerThreadCount];
+		for ( unsigned int i = 0; i < workerThreadCount; ++i )
+		{
+			const SIZE_T useDefaultStackSize = 0;
+			const DWORD startImmediately = 0;
+			s_workerThreads[i] = CreateThread( NULL, useDefaultStackSize, WorkerThreadMain, NULL, startImmediately, NULL );
+			if ( s_workerThreads[i] != NULL )
+			{
+				++s_workerThreadCount;
+			}
+			else
+			{
+				wereThereErrors = true;
+				const std::string windowsErrorMessage = Windows::GetLastSystemError();
+				EAE6320_ASSERTF( false, windowsErrorMessage.c_str() );
+				Logging::OutputError( "Windows failed to create job worker thread #%u: %s", i, windowsErrorMessage.c_str() );
+				goto OnExit;
+			}
+		}
+	}
+
+	// Start the background thread and the I/O threads
+	if ( !StartQueue( s_backgroundQueue, 1, "background" ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	if ( !StartQueue( s_ioQueue, s_ioThreadCount, "I/O" ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+
+	Logging::OutputMessage( "Initialized jobs with %u worker threads, a background thread, and %u I/O threads",
+		s_workerThreadCount, s_ioQueue.threadCount );
+
+OnExit:
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Jobs::CleanUp()
+{
+	bool wereThereErrors = false;
+
+	EAE6320_ASSERTF( s_isJobInProgress == 0, "Jobs are being cleaned up while a job is in progress" );
+
+	if ( !StopQueue( s_ioQueue, "I/O" ) )
+	{
+		wereThereErrors = true;
+	}
+	if ( !StopQueue( s_backgroundQueue, "background" ) )
+	{
+		wereThereErrors = true;
+	}
+
+	if ( s_workerThreads )
+	{
+		// Wake every worker up and tell it to exit
+		InterlockedExchange( &s_shouldWorkersExit, 1 );
+		if ( s_workerThreadCount > 0 )
+		{
+			ReleaseSemaphore( s_wakeUpWorkers, static_cast<LONG>( s_workerThreadCount ), NULL );
+			const BOOL waitForAll = TRUE;
+			if ( WaitForMultipleObjects( s_workerThreadCount, s_workerThreads, waitForAll, INFINITE ) == WAIT_FAILED )
+			{
+				wereThereErrors = true;
+				const std::string windowsErrorMessage = Windows::GetLastSystemError();
+				EAE6320_ASSERTF( false, windowsErrorMessage.c_str() );
+				Logging::OutputError( "Windows failed to wait for the job worker threads to exit: %s", windowsErrorMessage.c_str() );
+			}
+		}
+		for ( unsigned int i = 0; i < s_workerThreadCount; ++i )
+		{
+			CloseHandle( s_workerThreads[i] );
+		}
+		delete [] s_workerThreads;
+		s_workerThreads = NULL;
+		s_workerThreadCount = 0;
+	}
+	if ( s_haveWorkersFinished )
+	{
+		CloseHandle( s_haveWorkersFinished );
+		s_haveWorkersFinished = NULL;
+	}
+	if ( s_wakeUpWorkers )
+	{
+		CloseHandle( s_wakeUpWorkers );
+		s_wakeUpWorkers = NULL;
+	}
+
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void ExecuteBatches()
+	{
+		for ( ;; )
+		{
+			const LONG batchIndex = InterlockedIncrement( &s_job.nextBatchIndex ) - 1;
+			if ( batchIndex >= s_job.batchCount )
+			{
+				break;
+			}
+			const unsigned int begin = static_cast<unsigned int>( batchIndex ) * s_job.batchSize;
+			const unsigned int end = ( ( s_job.count - begin ) > s_job.batchSize ) ? ( begin + s_job.batchSize ) : s_job.count;
+			s_job.function( begin, end, s_job.userData );
+		}
+	}
+
+	void RunInline( const unsigned int i_count, eae6320::Jobs::fJob i_job, void* const io_userData )
+	{
+		i_job( 0, i_count, io_userData );
+	}
+
+	void SubmitToQueue( sJobQueue& io_queue, eae6320::Jobs::fBackgroundJob i_job, void* const io_userData )
+	{
+		EAE6320_ASSERT( i_job != NULL );
+		if ( io_queue.threadCount == 0 )
+		{
+			i_job( io_userData );
+			return;
+		}
+
+		{
+			sBackgroundJob job;
+			job.function = i_job;
+			job.userData = io_userData;
+			EnterCriticalSection( &io_queue.lock );
+			io_queue.jobs.push_back( job );
+			LeaveCriticalSection( &io_queue.lock );
+		}
+		ReleaseSemaphore( io_queue.jobCount, 1, NULL );
+	}
+
+	bool StartQueue( sJobQueue& io_queue, const unsigned int i_threadCount, const char* const i_name )
+	{
+		InitializeCriticalSection( &io_queue.lock );
+		io_queue.isLockInitialized = true;
+		{
+			const LONG initialCount = 0;
+			const LONG maximumCount = 0x7fffffff;
+			io_queue.jobCount = CreateSemaphore( NULL, initialCount, maximumCount, NULL );
+			if ( io_queue.jobCount == NULL )
+			{
+				const std::string windowsErrorMessage = eae6320::Windows::GetLastSystemError();
+				EAE6320_ASSERTF( false, windowsErrorMessage.c_str() );
+				eae6320::Logging::OutputError( "Windows failed to create the %s job semaphore: %s", i_name, windowsErrorMessage.c_str() );
+				return false;
+			}
+		}
+		io_queue.shouldThreadsExit = 0;
+		io_queue.threads = new HANDLE[i_threadCount];
+		for ( unsigned int i = 0; i < i_threadCount; ++i )
+		{
+			const SIZE_T useDefaultStackSize = 0;
+			const DWORD startImmediately = 0;
+			io_queue.threads[i] = CreateThread( NULL, useDefaultStackSize, QueueThreadMain, &io_queue, startImmediately, NULL );
+			if ( io_queue.threads[i] != NULL )
+			{
+				++io_queue.threadCount;
+			}
+			else
+			{
+				const std::string windowsErrorMessage = eae6320::Windows::GetLastSystemError();
+				EAE6320_ASSERTF( false, windowsErrorMessage.c_str() );
+				eae6320::Logging::OutputError( "Windows failed to create %s job thread #%u: %s", i_name, i, windowsErrorMessage.c_str() );
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool StopQueue( sJobQueue& io_queue, const char* const i_name )
+	{
+		bool wereThereErrors = false;
+
+		if ( io_queue.threads )
+		{
+			// Every thread is woken up one more time than there are queued jobs
+			// and exits when it finds the queue empty
+			InterlockedExchange( &io_queue.shouldThreadsExit, 1 );
+			if ( io_queue.threadCount > 0 )
+			{
+				ReleaseSemaphore( io_queue.jobCount, static_cast<LONG>( io_queue.threadCount ), NULL );
+				const BOOL waitForAll = TRUE;
+				if ( WaitForMultipleObjects( io_queue.threadCount, io_queue.threads, waitForAll, INFINITE ) == WAIT_FAILED )
+				{
+					wereThereErrors = true;
+					const std::string windowsErrorMessage = eae6320::Windows::GetLastSystemError();
+					EAE6320_ASSERTF( false, windowsErrorMessage.c_str() );
+					eae6320::Logging::OutputError( "Windows failed to wait for the %s job threads to exit: %s", i_name, windowsErrorMessage.c_str() );
+				}
+			}
+			for ( unsigned int i = 0; i < io_queue.threadCount; ++i )
+			{
+				CloseHandle( io_queue.threads[i] );
+			}
+			delete [] io_queue.threads;
+			io_queue.threads = NULL;
+			io_queue.threadCount = 0;
+		}
+		if ( io_queue.jobCount )
+		{
+			CloseHandle( io_queue.jobCount );
+			io_queue.jobCount = NULL;
+		}
+		if ( io_queue.isLockInitialized )
+		{
+			DeleteCriticalSection( &io_queue.lock );
+			io_queue.isLockInitialized = false;
+		}
+
+		return !wereThereErrors;
+	}
+
+	DWORD WINAPI QueueThreadMain( void* io_queue )
+	{
+		sJobQueue& queue = *reinterpret_cast<sJobQueue*>( io_queue );
+		for ( ;; )
+		{
+			WaitForSingleObject( queue.jobCount, INFINITE );
+			sBackgroundJob job = { 0 };
+			bool wasJobFound = false;
+			{
+				EnterCriticalSection( &queue.lock );
+				if ( !queue.jobs.empty() )
+				{
+					job = queue.jobs.front();
+					queue.jobs.pop_front();
+					wasJobFound = true;
+				}
+				LeaveCriticalSection( &queue.lock );
+			}
+			if ( wasJobFound )
+			{
+				job.function( job.userData );
+			}
+			// The exit signals are only seen once the queue is empty
+			// (they are released after every job that was submitted before them)
+			else if ( queue.shouldThreadsExit != 0 )
+			{
+				break;
+			}
+		}
+		return 0;
+	}
+
+	DWORD WINAPI WorkerThreadMain( void* )
+	{
+		for ( ;; )
+		{
+			WaitForSingleObject( s_wakeUpWorkers, INFINITE );
+			if ( s_shouldWorkersExit != 0 )
+			{
+				break;
+			}
+			ExecuteBatches();
+			// The last worker to finish lets the thread that started the job know
+			if ( InterlockedDecrement( &s_job.activeWorkerCount ) == 0 )
+			{
+				SetEvent( s_haveWorkersFinished );
+			}
+		}
+		return 0;
+	}
+}
@@ -0,0 +1,220 @@
+// Header Files
+//=============
+
+#include "Batch.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Scalar.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// This is a xorshift generator
+	// (the benchmark only needs numbers that are the same every time it runs)
+	uint32_t GetNextRandomNumber( uint32_t& io_state );
+	float GetRandomFloat( uint32_t& io_state );
+
+	float GetMaxDifference( const float* const i_a, const float* const i_b, const size_t i_count );
+}
+
+// Interface
+//==========
+
+void eae6320::Math::TransformVectors( const sMatrix& i_matrix, const sVector* const i_vectors, const unsigned int i_count, sVector* const o_vectors )
+{
+	unsigned int i = 0;
+#if defined( EAE6320_MATH_AVX )
+	// Two vectors are transformed at a time:
+	// Each column is copied into both halves of a register
+	// and each vector component is copied across its own half
+	{
+		const __m256 column0 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( &i_matrix.columns[0].x ) );
+		const __m256 column1 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( &i_matrix.columns[1].x ) );
+		const __m256 column2 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( &i_matrix.columns[2].x ) );
+		const __m256 column3 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( &i_matrix.columns[3].x ) );
+		for ( ; ( i + 2 ) <= i_count; i += 2 )
+		{
+			const __m256 vectors = _mm256_loadu_ps( &i_vectors[i].x );
+			__m256 result = _mm256_mul_ps( column0, _mm256_permute_ps( vectors, 0x00 ) );
+			result = _mm256_add_ps( result, _mm256_mul_ps( column1, _mm256_permute_ps( vectors, 0x55 ) ) );
+			result = _mm256_add_ps( result, _mm256_mul_ps( column2, _mm256_permute_ps( vectors, 0xaa ) ) );
+			result = _mm256_add_ps( result, _mm256_mul_ps( column3, _mm256_permute_ps( vectors, 0xff ) ) );
+			_mm256_storeu_ps( &o_vectors[i].x, result );
+		}
+	}
+#endif
+	for ( ; i < i_count; ++i )
+	{
+		Simd::Store( i_matrix.Transform( i_vectors[i].Load() ), &o_vectors[i].x );
+	}
+}
+
+void eae6320::Math::RotateVectors( const sQuaternion& i_rotation, const sVector* const i_vectors, const unsigned int i_count, sVector* const o_vectors )
+{
+	// This is the same as Rotate() but with the quaternion's registers only prepared once
+	const Simd::tFloat4 u = Simd::Multiply( i_rotation.Load(), Simd::Set( 1.0f, 1.0f, 1.0f, 0.0f ) );
+	const Simd::tFloat4 w = Simd::Splat( i_rotation.w );
+	const Simd::tFloat4 two = Simd::Splat( 2.0f );
+	for ( unsigned int i = 0; i < i_count; ++i )
+	{
+		const Simd::tFloat4 v = i_vectors[i].Load();
+		const Simd::tFloat4 t = Simd::Multiply( Simd::Cross( u, v ), two );
+		Simd::Store( Simd::Add( Simd::MultiplyAdd( w, t, v ), Simd::Cross( u, t ) ), &o_vectors[i].x );
+	}
+}
+
+void eae6320::Math::MultiplyMatrices( const sMatrix* const i_lefts, const sMatrix* const i_rights, const unsigned int i_count, sMatrix* const o_products )
+{
+	for ( unsigned int i = 0; i < i_count; ++i )
+	{
+		// The left matrix is loaded before anything is stored
+		// in case the output is the same as the input
+		// (each right column is loaded before its product column is stored)
+		const sMatrix& left = i_lefts[i];
+		const sMatrix& right = i_rights[i];
+		sMatrix& product = o_products[i];
+#if defined( EAE6320_MATH_AVX )
+		const __m256 column0 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( &left.columns[0].x ) );
+		const __m256 column1 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( &left.columns[1].x ) );
+		const __m256 column2 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( &left.columns[2].x ) );
+		const __m256 column3 = _mm256_broadcast_ps( reinterpret_cast<const __m128*>( &left.columns[3].x ) );
+		for ( unsigned int j = 0; j < 4; j += 2 )
+		{
+			const __m256 rightColumns = _mm256_loadu_ps( &right.columns[j].x );
+			__m256 result = _mm256_mul_ps( column0, _mm256_permute_ps( rightColumns, 0x00 ) );
+			result = _mm256_add_ps( result, _mm256_mul_ps( column1, _mm256_permute_ps( rightColumns, 0x55 ) ) );
+			result = _mm256_add_ps( result, _mm256_mul_ps( column2, _mm256_permute_ps( rightColumns, 0xaa ) ) );
+			result = _mm256_add_ps( result, _mm256_mul_ps( column3, _mm256_permute_ps( rightColumns, 0xff ) ) );
+			_mm256_storeu_ps( &product.columns[j].x, result );
+		}
+#else
+		const Simd::tFloat4 column0 = left.columns[0].Load();
+		const Simd::tFloat4 column1 = left.columns[1].Load();
+		const Simd::tFloat4 column2 = left.columns[2].Load();
+		const Simd::tFloat4 column3 = left.columns[3].Load();
+		for ( unsigned int j = 0; j < 4; ++j )
+		{
+			const Simd::tFloat4 rightColumn = right.columns[j].Load();
+			Simd::tFloat4 result = Simd::Multiply( column0, Simd::Swizzle<0, 0, 0, 0>( rightColumn ) );
+			result = Simd::MultiplyAdd( column1, Simd::Swizzle<1, 1, 1, 1>( rightColumn ), result );
+			result = Simd::MultiplyAdd( column2, Simd::Swizzle<2, 2, 2, 2>( rightColumn ), result );
+			result = Simd::MultiplyAdd( column3, Simd::Swizzle<3, 3, 3, 3>( rightColumn ), result );
+			Simd::Store( result, &product.columns[j].x );
+		}
+#endif
+	}
+}
+
+// Benchmark
+//----------
+
+void eae6320::Math::LogBatchCost()
+{
+	const unsigned int elementCount = 4 * 1024;
+	const unsigned int repetitionCount = 256;
+
+	// The inputs are random, with positions having a w of 1
+	uint32_t randomState = 0x9e3779b9u;
+	std::vector<sVector> vectors( elementCount );
+	for ( unsigned int i = 0; i < elementCount; ++i )
+	{
+		vectors[i] = sVector( GetRandomFloat( randomState ), GetRandomFloat( randomState ), GetRandomFloat( randomState ), 1.0f );
+	}
+	std::vector<sMatrix> matrices( elementCount );
+	for ( unsigned int i = 0; i < elementCount; ++i )
+	{
+		const sVector axis = Normalize( sVector( GetRandomFloat( randomState ), GetRandomFloat( randomState ), GetRandomFloat( randomState ) + 2.0f, 0.0f ) );
+		matrices[i] = sMatrix::CreateTransform( sQuaternion::CreateFromAxisAngle( axis, GetRandomFloat( randomState ) * 3.14159265f ),
+			sVector( GetRandomFloat( randomState ), GetRandomFloat( randomState ), GetRandomFloat( randomState ), 1.0f ) );
+	}
+	const sQuaternion rotation = sQuaternion::CreateFromAxisAngle( Normalize( sVector( 1.0f, 2.0f, 3.0f, 0.0f ) ), 1.0f );
+	const sMatrix& matrix = matrices[0];
+
+	Logging::OutputMessage( "Comparing the %s math batch functions with scalar code (%u elements %u times):",
+		Simd::GetInstructionSetName(), elementCount, repetitionCount );
+	for ( unsigned int f = 0; f < 3; ++f )
+	{
+		// Each function is run with the SIMD implementation first and then the scalar one
+		double secondCounts[2];
+		std::vector<sVector> outputVectors[2];
+		std::vector<sMatrix> outputMatrices[2];
+		for ( unsigned int k = 0; k < 2; ++k )
+		{
+			const bool shouldScalarCodeBeUsed = k == 1;
+			outputVectors[k].resize( elementCount );
+			outputMatrices[k].resize( elementCount );
+			const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+			for ( unsigned int r = 0; r < repetitionCount; ++r )
+			{
+				switch ( f )
+				{
+				case 0:
+					( shouldScalarCodeBeUsed ? Scalar::TransformVectors : TransformVectors )( matrix, &vectors[0], elementCount, &outputVectors[k][0] );
+					break;
+				case 1:
+					( shouldScalarCodeBeUsed ? Scalar::RotateVectors : RotateVectors )( rotation, &vectors[0], elementCount, &outputVectors[k][0] );
+					break;
+				default:
+					// Each matrix is multiplied by the one after it
+					( shouldScalarCodeBeUsed ? Scalar::MultiplyMatrices : MultiplyMatrices )(
+						&matrices[0], &matrices[1], elementCount - 1, &outputMatrices[k][0] );
+				}
+			}
+			secondCounts[k] = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+		}
+		// Both implementations should give the same results (within rounding)
+		const char* name;
+		float maxDifference;
+		if ( f < 2 )
+		{
+			name = ( f == 0 ) ? "TransformVectors()" : "RotateVectors()";
+			maxDifference = GetMaxDifference( &outputVectors[0][0].x, &outputVectors[1][0].x, elementCount * 4 );
+		}
+		else
+		{
+			name = "MultiplyMatrices()";
+			maxDifference = GetMaxDifference( &outputMatrices[0][0].columns[0].x, &outputMatrices[1][0].columns[0].x, ( elementCount - 1 ) * 16 );
+		}
+
+		const double elementCountPerMillisecond = static_cast<double>( elementCount ) * repetitionCount / ( secondCounts[0] * 1000.0 );
+		Logging::OutputMessage( "\t%s: %.1f elements per millisecond, which is %.2fx faster than scalar code (the results differ by at most %g)",
+			name, elementCountPerMillisecond, secondCounts[1] / secondCounts[0], maxDifference );
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	uint32_t GetNextRandomNumber( uint32_t& io_state )
+	{
+		io_state ^= io_state << 13;
+		io_state ^= io_state >> 17;
+		io_state ^= io_state << 5;
+		return io_state;
+	}
+
+	// Returns a number between -1 and 1
+	float GetRandomFloat( uint32_t& io_state )
+	{
+		return ( static_cast<float>( GetNextRandomNumber( io_state ) & 0xffff ) / 32768.0f ) - 1.0f;
+	}
+
+	float GetMaxDifference( const float* const i_a, const float* const i_b, const size_t i_count )
+	{
+		float maxDifference = 0.0f;
+		for ( size_t i = 0; i < i_count; ++i )
+		{
+			const float difference = std::abs( i_a[i] - i_b[i] );
+			maxDifference = ( difference > maxDifference ) ? difference : maxDifference;
+		}
+		return maxDifference;
+	}
+}
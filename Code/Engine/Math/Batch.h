@@ -0,0 +1,43 @@
+/*
+	These functions transform arrays of vectors and matrices
+
+	They are faster than calling the math types' functions in a loop
+	because the matrix (or rotation) is only loaded once,
+	and when the compiler targets AVX two vectors (or two columns) are transformed at a time.
+	The output can be the same array as the input.
+*/
+
+#ifndef EAE6320_MATH_BATCH_H
+#define EAE6320_MATH_BATCH_H
+
+// Header Files
+//=============
+
+#include "sMatrix.h"
+#include "sQuaternion.h"
+#include "sVector.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Math
+	{
+		// o_vectors[i] = i_matrix * i_vectors[i]
+		void TransformVectors( const sMatrix& i_matrix, const sVector* const i_vectors, const unsigned int i_count, sVector* const o_vectors );
+		// o_vectors[i] = Rotate( i_rotation, i_vectors[i] )
+		void RotateVectors( const sQuaternion& i_rotation, const sVector* const i_vectors, const unsigned int i_count, sVector* const o_vectors );
+		// o_products[i] = i_lefts[i] * i_rights[i]
+		void MultiplyMatrices( const sMatrix* const i_lefts, const sMatrix* const i_rights, const unsigned int i_count, sMatrix* const o_products );
+
+		// Benchmark
+		//----------
+
+		// This compares every batch function with the scalar reference implementation (see Scalar.h)
+		// and logs how much faster it is and how different the results are
+		void LogBatchCost();
+	}
+}
+
+#endif	// EAE6320_MATH_BATCH_H
@@ -0,0 +1,35 @@
+/*
+	This file configures which instructions the math library is implemented with
+
+	The instruction set is chosen when the engine is compiled
+	from what the compiler is targeting:
+		* SSE on x86 and x64 (which every x64 CPU has)
+		* AVX for the batch functions if the compiler targets it (/arch:AVX)
+		* NEON on ARM
+		* Otherwise plain scalar code
+*/
+
+#ifndef EAE6320_MATH_CONFIGURATION_H
+#define EAE6320_MATH_CONFIGURATION_H
+
+// When this is defined the scalar implementation is used even if the compiler targets SIMD instructions
+// (which can be used to find out whether a bug is in the SIMD code)
+//#define EAE6320_MATH_ISSIMDDISABLED
+
+// When this is defined the batch functions are compared with the scalar reference implementation at initialization,
+// and how much faster they are is logged
+// (it is only meaningful in an optimized build)
+//#define EAE6320_MATH_SHOULDSIMDBEMEASURED
+
+#if !defined( EAE6320_MATH_ISSIMDDISABLED )
+	#if defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 1 ) ) || defined( __SSE__ )
+		#define EAE6320_MATH_SSE
+		#if defined( __AVX__ )
+			#define EAE6320_MATH_AVX
+		#endif
+	#elif defined( _M_ARM ) || defined( _M_ARM64 ) || defined( __ARM_NEON )
+		#define EAE6320_MATH_NEON
+	#endif
+#endif
+
+#endif	// EAE6320_MATH_CONFIGURATION_H
@@ -0,0 +1,71 @@
+// Header Files
+//=============
+
+#include "Scalar.h"
+
+#include "sMatrix.h"
+#include "sQuaternion.h"
+#include "sVector.h"
+
+// Interface
+//==========
+
+void eae6320::Math::Scalar::TransformVectors( const sMatrix& i_matrix, const sVector* const i_vectors, const unsigned int i_count, sVector* const o_vectors )
+{
+	const float* const matrix = &i_matrix.columns[0].x;
+	for ( unsigned int i = 0; i < i_count; ++i )
+	{
+		const float vector[4] = { i_vectors[i].x, i_vectors[i].y, i_vectors[i].z, i_vectors[i].w };
+		float* const output = &o_vectors[i].x;
+		for ( unsigned int row = 0; row < 4; ++row )
+		{
+			output[row] = ( matrix[row] * vector[0] ) + ( matrix[4 + row] * vector[1] )
+				+ ( matrix[8 + row] * vector[2] ) + ( matrix[12 + row] * vector[3] );
+		}
+	}
+}
+
+void eae6320::Math::Scalar::RotateVectors( const sQuaternion& i_rotation, const sVector* const i_vectors, const unsigned int i_count, sVector* const o_vectors )
+{
+	const float qx = i_rotation.x, qy = i_rotation.y, qz = i_rotation.z, qw = i_rotation.w;
+	for ( unsigned int i = 0; i < i_count; ++i )
+	{
+		const float vx = i_vectors[i].x, vy = i_vectors[i].y, vz = i_vectors[i].z;
+		// t = 2(u x v)
+		const float tx = 2.0f * ( ( qy * vz ) - ( qz * vy ) );
+		const float ty = 2.0f * ( ( qz * vx ) - ( qx * vz ) );
+		const float tz = 2.0f * ( ( qx * vy ) - ( qy * vx ) );
+		// v' = v + wt + u x t
+		o_vectors[i].x = vx + ( qw * tx ) + ( ( qy * tz ) - ( qz * ty ) );
+		o_vectors[i].y = vy + ( qw * ty ) + ( ( qz * tx ) - ( qx * tz ) );
+		o_vectors[i].z = vz + ( qw * tz ) + ( ( qx * ty ) - ( qy * tx ) );
+		o_vectors[i].w = i_vectors[i].w;
+	}
+}
+
+void eae6320::Math::Scalar::MultiplyMatrices( const sMatrix* const i_lefts, const sMatrix* const i_rights, const unsigned int i_count, sMatrix* const o_products )
+{
+	for ( unsigned int i = 0; i < i_count; ++i )
+	{
+		// The inputs are copied in case the output is the same as one of them
+		float left[16], right[16];
+		for ( unsigned int j = 0; j < 16; ++j )
+		{
+			left[j] = ( &i_lefts[i].columns[0].x )[j];
+			right[j] = ( &i_rights[i].columns[0].x )[j];
+		}
+		float* const product = &o_products[i].columns[0].x;
+		for ( unsigned int column = 0; column < 4; ++column )
+		{
+			for ( unsigned int row = 0; row < 4; ++row )
+			{
+				float sum = 0.0f;
+				for ( unsigned int k = 0; k < 4; ++k )
+				{
+					sum += left[( k * 4 ) + row] * right[( column * 4 ) + k];
+				}
+				product[( column * 4 ) + row] = sum;
+			}
+		}
+	}
+}
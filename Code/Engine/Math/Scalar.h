@@ -0,0 +1,42 @@
+/*
+	These are plain implementations of the batch functions in Batch.h
+
+	They are always compiled (whichever instructions the rest of the library uses)
+	so that the SIMD implementations can be checked against them
+	and so that the benchmark has something to compare with.
+	Nothing else should need to call them.
+*/
+
+#ifndef EAE6320_MATH_SCALAR_H
+#define EAE6320_MATH_SCALAR_H
+
+// Forward Declarations
+//=====================
+
+namespace eae6320
+{
+	namespace Math
+	{
+		struct sMatrix;
+		struct sQuaternion;
+		struct sVector;
+	}
+}
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Math
+	{
+		namespace Scalar
+		{
+			void TransformVectors( const sMatrix& i_matrix, const sVector* const i_vectors, const unsigned int i_count, sVector* const o_vectors );
+			void RotateVectors( const sQuaternion& i_rotation, const sVector* const i_vectors, const unsigned int i_count, sVector* const o_vectors );
+			void MultiplyMatrices( const sMatrix* const i_lefts, const sMatrix* const i_rights, const unsigned int i_count, sMatrix* const o_products );
+		}
+	}
+}
+
+#endif	// EAE6320_MATH_SCALAR_H
@@ -0,0 +1,317 @@
+/*
+	This file wraps the 4-float SIMD operations that the math types are built from
+
+	Every operation has an SSE, a NEON, and a scalar implementation
+	(which one is compiled is chosen in Configuration.h),
+	and so the math types only have to be written once.
+	Gameplay code should use the math types rather than these functions.
+
+	Loads and stores don't require 16-byte alignment:
+	the math types are aligned so that they never straddle a cache line,
+	but arrays allocated with new or std::vector on 32-bit Windows are only aligned to 8 bytes,
+	and unaligned loads of aligned data are as fast as aligned ones on any CPU that the engine runs on.
+*/
+
+#ifndef EAE6320_MATH_SIMD_H
+#define EAE6320_MATH_SIMD_H
+
+// Header Files
+//=============
+
+#include <cmath>
+#include "Configuration.h"
+
+#if defined( EAE6320_MATH_SSE )
+	#include <xmmintrin.h>
+	#if defined( EAE6320_MATH_AVX )
+		#include <immintrin.h>
+	#endif
+#elif defined( EAE6320_MATH_NEON )
+	#include <arm_neon.h>
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Math
+	{
+		namespace Simd
+		{
+#if defined( EAE6320_MATH_SSE )
+			typedef __m128 tFloat4;
+#elif defined( EAE6320_MATH_NEON )
+			typedef float32x4_t tFloat4;
+#else
+			struct tFloat4
+			{
+				float v[4];
+			};
+#endif
+			// A comparison returns a mask with every bit of each component set if the comparison was true
+#if defined( EAE6320_MATH_SSE )
+			typedef __m128 tMask4;
+#elif defined( EAE6320_MATH_NEON )
+			typedef uint32x4_t tMask4;
+#else
+			struct tMask4
+			{
+				bool v[4];
+			};
+#endif
+
+			// The name of the instructions that were compiled (for logging)
+			inline const char* GetInstructionSetName()
+			{
+#if defined( EAE6320_MATH_AVX )
+				return "AVX";
+#elif defined( EAE6320_MATH_SSE )
+				return "SSE";
+#elif defined( EAE6320_MATH_NEON )
+				return "NEON";
+#else
+				return "scalar";
+#endif
+			}
+
+			// Load / Store
+			//-------------
+
+			inline tFloat4 Load( const float* const i_values )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_loadu_ps( i_values );
+#elif defined( EAE6320_MATH_NEON )
+				return vld1q_f32( i_values );
+#else
+				const tFloat4 result = { { i_values[0], i_values[1], i_values[2], i_values[3] } };
+				return result;
+#endif
+			}
+			inline void Store( const tFloat4 i_value, float* const o_values )
+			{
+#if defined( EAE6320_MATH_SSE )
+				_mm_storeu_ps( o_values, i_value );
+#elif defined( EAE6320_MATH_NEON )
+				vst1q_f32( o_values, i_value );
+#else
+				for ( unsigned int i = 0; i < 4; ++i )
+				{
+					o_values[i] = i_value.v[i];
+				}
+#endif
+			}
+			inline tFloat4 Set( const float i_x, const float i_y, const float i_z, const float i_w )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_setr_ps( i_x, i_y, i_z, i_w );
+#else
+				const float values[4] = { i_x, i_y, i_z, i_w };
+				return Load( values );
+#endif
+			}
+			inline tFloat4 Splat( const float i_value )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_set1_ps( i_value );
+#elif defined( EAE6320_MATH_NEON )
+				return vdupq_n_f32( i_value );
+#else
+				const tFloat4 result = { { i_value, i_value, i_value, i_value } };
+				return result;
+#endif
+			}
+			inline float GetX( const tFloat4 i_value )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_cvtss_f32( i_value );
+#elif defined( EAE6320_MATH_NEON )
+				return vgetq_lane_f32( i_value, 0 );
+#else
+				return i_value.v[0];
+#endif
+			}
+
+			// Arithmetic
+			//-----------
+
+			inline tFloat4 Add( const tFloat4 i_a, const tFloat4 i_b )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_add_ps( i_a, i_b );
+#elif defined( EAE6320_MATH_NEON )
+				return vaddq_f32( i_a, i_b );
+#else
+				const tFloat4 result = { { i_a.v[0] + i_b.v[0], i_a.v[1] + i_b.v[1], i_a.v[2] + i_b.v[2], i_a.v[3] + i_b.v[3] } };
+				return result;
+#endif
+			}
+			inline tFloat4 Subtract( const tFloat4 i_a, const tFloat4 i_b )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_sub_ps( i_a, i_b );
+#elif defined( EAE6320_MATH_NEON )
+				return vsubq_f32( i_a, i_b );
+#else
+				const tFloat4 result = { { i_a.v[0] - i_b.v[0], i_a.v[1] - i_b.v[1], i_a.v[2] - i_b.v[2], i_a.v[3] - i_b.v[3] } };
+				return result;
+#endif
+			}
+			inline tFloat4 Multiply( const tFloat4 i_a, const tFloat4 i_b )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_mul_ps( i_a, i_b );
+#elif defined( EAE6320_MATH_NEON )
+				return vmulq_f32( i_a, i_b );
+#else
+				const tFloat4 result = { { i_a.v[0] * i_b.v[0], i_a.v[1] * i_b.v[1], i_a.v[2] * i_b.v[2], i_a.v[3] * i_b.v[3] } };
+				return result;
+#endif
+			}
+			// Returns ( i_a * i_b ) + i_c
+			inline tFloat4 MultiplyAdd( const tFloat4 i_a, const tFloat4 i_b, const tFloat4 i_c )
+			{
+#if defined( EAE6320_MATH_NEON )
+				return vmlaq_f32( i_c, i_a, i_b );
+#else
+				return Add( Multiply( i_a, i_b ), i_c );
+#endif
+			}
+			inline tFloat4 SquareRoot( const tFloat4 i_value )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_sqrt_ps( i_value );
+#else
+				float values[4];
+				Store( i_value, values );
+				for ( unsigned int i = 0; i < 4; ++i )
+				{
+					values[i] = std::sqrt( values[i] );
+				}
+				return Load( values );
+#endif
+			}
+			inline tFloat4 Divide( const tFloat4 i_a, const tFloat4 i_b )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_div_ps( i_a, i_b );
+#else
+				float a[4], b[4];
+				Store( i_a, a );
+				Store( i_b, b );
+				for ( unsigned int i = 0; i < 4; ++i )
+				{
+					a[i] /= b[i];
+				}
+				return Load( a );
+#endif
+			}
+
+			inline tFloat4 Minimum( const tFloat4 i_a, const tFloat4 i_b )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_min_ps( i_a, i_b );
+#elif defined( EAE6320_MATH_NEON )
+				return vminq_f32( i_a, i_b );
+#else
+				const tFloat4 result = { {
+					( i_a.v[0] < i_b.v[0] ) ? i_a.v[0] : i_b.v[0], ( i_a.v[1] < i_b.v[1] ) ? i_a.v[1] : i_b.v[1],
+					( i_a.v[2] < i_b.v[2] ) ? i_a.v[2] : i_b.v[2], ( i_a.v[3] < i_b.v[3] ) ? i_a.v[3] : i_b.v[3] } };
+				return result;
+#endif
+			}
+			inline tFloat4 Maximum( const tFloat4 i_a, const tFloat4 i_b )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_max_ps( i_a, i_b );
+#elif defined( EAE6320_MATH_NEON )
+				return vmaxq_f32( i_a, i_b );
+#else
+				const tFloat4 result = { {
+					( i_a.v[0] > i_b.v[0] ) ? i_a.v[0] : i_b.v[0], ( i_a.v[1] > i_b.v[1] ) ? i_a.v[1] : i_b.v[1],
+					( i_a.v[2] > i_b.v[2] ) ? i_a.v[2] : i_b.v[2], ( i_a.v[3] > i_b.v[3] ) ? i_a.v[3] : i_b.v[3] } };
+				return result;
+#endif
+			}
+
+			// Comparisons
+			//------------
+
+			inline tMask4 IsLessOrEqual( const tFloat4 i_a, const tFloat4 i_b )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_cmple_ps( i_a, i_b );
+#elif defined( EAE6320_MATH_NEON )
+				return vcleq_f32( i_a, i_b );
+#else
+				const tMask4 result = { { i_a.v[0] <= i_b.v[0], i_a.v[1] <= i_b.v[1], i_a.v[2] <= i_b.v[2], i_a.v[3] <= i_b.v[3] } };
+				return result;
+#endif
+			}
+			inline tMask4 And( const tMask4 i_a, const tMask4 i_b )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_and_ps( i_a, i_b );
+#elif defined( EAE6320_MATH_NEON )
+				return vandq_u32( i_a, i_b );
+#else
+				const tMask4 result = { { i_a.v[0] && i_b.v[0], i_a.v[1] && i_b.v[1], i_a.v[2] && i_b.v[2], i_a.v[3] && i_b.v[3] } };
+				return result;
+#endif
+			}
+			// Bit i of the result is set if component i of the mask is true
+			inline unsigned int GetBits( const tMask4 i_mask )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return static_cast<unsigned int>( _mm_movemask_ps( i_mask ) );
+#elif defined( EAE6320_MATH_NEON )
+				return ( vgetq_lane_u32( i_mask, 0 ) & 1 ) | ( vgetq_lane_u32( i_mask, 1 ) & 2 )
+					| ( vgetq_lane_u32( i_mask, 2 ) & 4 ) | ( vgetq_lane_u32( i_mask, 3 ) & 8 );
+#else
+				return ( i_mask.v[0] ? 1u : 0u ) | ( i_mask.v[1] ? 2u : 0u ) | ( i_mask.v[2] ? 4u : 0u ) | ( i_mask.v[3] ? 8u : 0u );
+#endif
+			}
+
+			// Swizzles
+			//---------
+
+			// Each template argument is the index of the component that goes into that slot
+			// (e.g. Swizzle<3,3,3,3>() copies w into every component)
+			template<unsigned int X, unsigned int Y, unsigned int Z, unsigned int W>
+			inline tFloat4 Swizzle( const tFloat4 i_value )
+			{
+#if defined( EAE6320_MATH_SSE )
+				return _mm_shuffle_ps( i_value, i_value, _MM_SHUFFLE( W, Z, Y, X ) );
+#else
+				// NEON doesn't have a general shuffle, and so it goes through memory
+				float values[4];
+				Store( i_value, values );
+				return Set( values[X], values[Y], values[Z], values[W] );
+#endif
+			}
+
+			// The result is in every component
+			inline tFloat4 Dot3( const tFloat4 i_a, const tFloat4 i_b )
+			{
+				const tFloat4 products = Multiply( i_a, i_b );
+				return Add( Add( Swizzle<0, 0, 0, 0>( products ), Swizzle<1, 1, 1, 1>( products ) ), Swizzle<2, 2, 2, 2>( products ) );
+			}
+			inline tFloat4 Dot4( const tFloat4 i_a, const tFloat4 i_b )
+			{
+				const tFloat4 products = Multiply( i_a, i_b );
+				const tFloat4 pairs = Add( products, Swizzle<1, 0, 3, 2>( products ) );
+				return Add( pairs, Swizzle<2, 3, 0, 1>( pairs ) );
+			}
+			// The result's w is 0
+			inline tFloat4 Cross( const tFloat4 i_a, const tFloat4 i_b )
+			{
+				return Subtract(
+					Multiply( Swizzle<1, 2, 0, 3>( i_a ), Swizzle<2, 0, 1, 3>( i_b ) ),
+					Multiply( Swizzle<2, 0, 1, 3>( i_a ), Swizzle<1, 2, 0, 3>( i_b ) ) );
+			}
+		}
+	}
+}
+
+#endif	// EAE6320_MATH_SIMD_H
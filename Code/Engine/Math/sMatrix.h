@@ -0,0 +1,105 @@
+/*
+	A matrix is a 4x4 transform
+
+	Matrices transform column vectors (transformed = matrix * vector),
+	and so a product applies the right matrix first.
+	Each column is stored contiguously
+	so that transforming a vector is the sum of the columns scaled by the vector's components,
+	which doesn't need any shuffling between SIMD registers.
+*/
+
+#ifndef EAE6320_MATH_SMATRIX_H
+#define EAE6320_MATH_SMATRIX_H
+
+// Header Files
+//=============
+
+#include "Simd.h"
+#include "sQuaternion.h"
+#include "sVector.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Math
+	{
+		struct alignas( 16 ) sMatrix
+		{
+			sVector columns[4];
+
+			// Transformation
+			//---------------
+
+			sVector operator *( const sVector& i_rhs ) const { return sVector( Transform( i_rhs.Load() ) ); }
+			sMatrix operator *( const sMatrix& i_rhs ) const
+			{
+				sMatrix product;
+				for ( unsigned int i = 0; i < 4; ++i )
+				{
+					Simd::Store( Transform( i_rhs.columns[i].Load() ), &product.columns[i].x );
+				}
+				return product;
+			}
+
+			Simd::tFloat4 Transform( const Simd::tFloat4 i_vector ) const
+			{
+				Simd::tFloat4 result = Simd::Multiply( columns[0].Load(), Simd::Swizzle<0, 0, 0, 0>( i_vector ) );
+				result = Simd::MultiplyAdd( columns[1].Load(), Simd::Swizzle<1, 1, 1, 1>( i_vector ), result );
+				result = Simd::MultiplyAdd( columns[2].Load(), Simd::Swizzle<2, 2, 2, 2>( i_vector ), result );
+				return Simd::MultiplyAdd( columns[3].Load(), Simd::Swizzle<3, 3, 3, 3>( i_vector ), result );
+			}
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The columns aren't initialized
+			sMatrix() {}
+
+			static sMatrix CreateIdentity()
+			{
+				return CreateTransform( sQuaternion::CreateIdentity(), sVector( 0.0f, 0.0f, 0.0f, 1.0f ) );
+			}
+			// The rotation is applied first and then the translation
+			// (the translation's w is ignored)
+			static sMatrix CreateTransform( const sQuaternion& i_rotation, const sVector& i_translation )
+			{
+				const float x = i_rotation.x, y = i_rotation.y, z = i_rotation.z, w = i_rotation.w;
+				sMatrix matrix;
+				matrix.columns[0] = sVector( 1.0f - ( 2.0f * ( ( y * y ) + ( z * z ) ) ), 2.0f * ( ( x * y ) + ( w * z ) ), 2.0f * ( ( x * z ) - ( w * y ) ), 0.0f );
+				matrix.columns[1] = sVector( 2.0f * ( ( x * y ) - ( w * z ) ), 1.0f - ( 2.0f * ( ( x * x ) + ( z * z ) ) ), 2.0f * ( ( y * z ) + ( w * x ) ), 0.0f );
+				matrix.columns[2] = sVector( 2.0f * ( ( x * z ) + ( w * y ) ), 2.0f * ( ( y * z ) - ( w * x ) ), 1.0f - ( 2.0f * ( ( x * x ) + ( y * y ) ) ), 0.0f );
+				matrix.columns[3] = sVector( i_translation.x, i_translation.y, i_translation.z, 1.0f );
+				return matrix;
+			}
+		};
+
+		inline sMatrix Transpose( const sMatrix& i_matrix )
+		{
+			sMatrix transpose;
+#if defined( EAE6320_MATH_SSE )
+			__m128 column0 = i_matrix.columns[0].Load(), column1 = i_matrix.columns[1].Load(),
+				column2 = i_matrix.columns[2].Load(), column3 = i_matrix.columns[3].Load();
+			_MM_TRANSPOSE4_PS( column0, column1, column2, column3 );
+			Simd::Store( column0, &transpose.columns[0].x );
+			Simd::Store( column1, &transpose.columns[1].x );
+			Simd::Store( column2, &transpose.columns[2].x );
+			Simd::Store( column3, &transpose.columns[3].x );
+#else
+			const float* const source = &i_matrix.columns[0].x;
+			float* const target = &transpose.columns[0].x;
+			for ( unsigned int i = 0; i < 4; ++i )
+			{
+				for ( unsigned int j = 0; j < 4; ++j )
+				{
+					target[( i * 4 ) + j] = source[( j * 4 ) + i];
+				}
+			}
+#endif
+			return transpose;
+		}
+	}
+}
+
+#endif	// EAE6320_MATH_SMATRIX_H
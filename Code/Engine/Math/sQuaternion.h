@@ -0,0 +1,104 @@
+/*
+	A quaternion represents a rotation as (x,y,z,w),
+	where (x,y,z) is the axis scaled by the sine of half of the angle and w is the cosine of half of the angle
+
+	The functions expect quaternions to be normalized
+	(multiplying normalized quaternions keeps them normalized except for rounding,
+	and so a quaternion that is updated every frame should be normalized every once in a while).
+*/
+
+#ifndef EAE6320_MATH_SQUATERNION_H
+#define EAE6320_MATH_SQUATERNION_H
+
+// Header Files
+//=============
+
+#include "Simd.h"
+#include "sVector.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Math
+	{
+		struct alignas( 16 ) sQuaternion
+		{
+			float x, y, z, w;
+
+			// Rotation
+			//---------
+
+			// The result rotates by i_rhs first and then by this quaternion
+			sQuaternion operator *( const sQuaternion& i_rhs ) const
+			{
+				// Each component of this quaternion multiplies a sign-flipped shuffle of the other
+				const Simd::tFloat4 rhs = i_rhs.Load();
+				Simd::tFloat4 result = Simd::Multiply( Simd::Splat( w ), rhs );
+				result = Simd::MultiplyAdd( Simd::Splat( x ),
+					Simd::Multiply( Simd::Swizzle<3, 2, 1, 0>( rhs ), Simd::Set( 1.0f, -1.0f, 1.0f, -1.0f ) ), result );
+				result = Simd::MultiplyAdd( Simd::Splat( y ),
+					Simd::Multiply( Simd::Swizzle<2, 3, 0, 1>( rhs ), Simd::Set( 1.0f, 1.0f, -1.0f, -1.0f ) ), result );
+				result = Simd::MultiplyAdd( Simd::Splat( z ),
+					Simd::Multiply( Simd::Swizzle<1, 0, 3, 2>( rhs ), Simd::Set( -1.0f, 1.0f, 1.0f, -1.0f ) ), result );
+				return sQuaternion( result );
+			}
+
+			// SIMD
+			//-----
+
+			Simd::tFloat4 Load() const { return Simd::Load( &x ); }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The components aren't initialized
+			sQuaternion() {}
+			sQuaternion( const float i_x, const float i_y, const float i_z, const float i_w ) : x( i_x ), y( i_y ), z( i_z ), w( i_w ) {}
+			explicit sQuaternion( const Simd::tFloat4 i_value ) { Simd::Store( i_value, &x ); }
+
+			static sQuaternion CreateIdentity() { return sQuaternion( 0.0f, 0.0f, 0.0f, 1.0f ); }
+			// The axis must be normalized
+			static sQuaternion CreateFromAxisAngle( const sVector& i_axis, const float i_radians )
+			{
+				const float halfAngle = i_radians * 0.5f;
+				const float sine = std::sin( halfAngle );
+				return sQuaternion( i_axis.x * sine, i_axis.y * sine, i_axis.z * sine, std::cos( halfAngle ) );
+			}
+		};
+
+		// The inverse of a normalized quaternion
+		inline sQuaternion Conjugate( const sQuaternion& i_quaternion )
+		{
+			return sQuaternion( Simd::Multiply( i_quaternion.Load(), Simd::Set( -1.0f, -1.0f, -1.0f, 1.0f ) ) );
+		}
+		inline sQuaternion Normalize( const sQuaternion& i_quaternion )
+		{
+			const Simd::tFloat4 value = i_quaternion.Load();
+			return sQuaternion( Simd::Divide( value, Simd::SquareRoot( Simd::Dot4( value, value ) ) ) );
+		}
+		// The vector's x, y, and z are rotated and its w is unchanged
+		inline sVector Rotate( const sQuaternion& i_rotation, const sVector& i_vector )
+		{
+			// v' = v + 2w(u x v) + 2u x (u x v), where u is the quaternion's (x,y,z)
+			const Simd::tFloat4 u = Simd::Multiply( i_rotation.Load(), Simd::Set( 1.0f, 1.0f, 1.0f, 0.0f ) );
+			const Simd::tFloat4 v = i_vector.Load();
+			const Simd::tFloat4 t = Simd::Multiply( Simd::Cross( u, v ), Simd::Splat( 2.0f ) );
+			const Simd::tFloat4 result = Simd::Add( Simd::MultiplyAdd( Simd::Splat( i_rotation.w ), t, v ), Simd::Cross( u, t ) );
+			return sVector( result );
+		}
+		// The rotations are interpolated linearly and then normalized (nlerp),
+		// taking the shorter way around
+		inline sQuaternion Nlerp( const sQuaternion& i_a, const sQuaternion& i_b, const float i_t )
+		{
+			const Simd::tFloat4 a = i_a.Load();
+			const Simd::tFloat4 b = i_b.Load();
+			const float weightB = ( Simd::GetX( Simd::Dot4( a, b ) ) < 0.0f ) ? -i_t : i_t;
+			const Simd::tFloat4 blended = Simd::MultiplyAdd( b, Simd::Splat( weightB ), Simd::Multiply( a, Simd::Splat( 1.0f - i_t ) ) );
+			return sQuaternion( Simd::Divide( blended, Simd::SquareRoot( Simd::Dot4( blended, blended ) ) ) );
+		}
+	}
+}
+
+#endif	// EAE6320_MATH_SQUATERNION_H
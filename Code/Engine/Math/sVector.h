@@ -0,0 +1,73 @@
+/*
+	A vector has 4 components so that it fits in a SIMD register
+
+	Positions should have a w of 1 (so that they are translated when they are transformed)
+	and directions a w of 0.
+	The 3D functions (Dot3(), Cross(), Length(), Normalize()) ignore w.
+*/
+
+#ifndef EAE6320_MATH_SVECTOR_H
+#define EAE6320_MATH_SVECTOR_H
+
+// Header Files
+//=============
+
+#include "Simd.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Math
+	{
+		struct alignas( 16 ) sVector
+		{
+			float x, y, z, w;
+
+			// Arithmetic
+			//-----------
+
+			sVector operator +( const sVector& i_rhs ) const { return sVector( Simd::Add( Load(), i_rhs.Load() ) ); }
+			sVector operator -( const sVector& i_rhs ) const { return sVector( Simd::Subtract( Load(), i_rhs.Load() ) ); }
+			sVector operator -() const { return sVector( Simd::Subtract( Simd::Splat( 0.0f ), Load() ) ); }
+			// Each component is multiplied by the matching component
+			sVector operator *( const sVector& i_rhs ) const { return sVector( Simd::Multiply( Load(), i_rhs.Load() ) ); }
+			sVector operator *( const float i_rhs ) const { return sVector( Simd::Multiply( Load(), Simd::Splat( i_rhs ) ) ); }
+			sVector& operator +=( const sVector& i_rhs ) { Simd::Store( Simd::Add( Load(), i_rhs.Load() ), &x ); return *this; }
+			sVector& operator -=( const sVector& i_rhs ) { Simd::Store( Simd::Subtract( Load(), i_rhs.Load() ), &x ); return *this; }
+			sVector& operator *=( const float i_rhs ) { Simd::Store( Simd::Multiply( Load(), Simd::Splat( i_rhs ) ), &x ); return *this; }
+
+			// SIMD
+			//-----
+
+			Simd::tFloat4 Load() const { return Simd::Load( &x ); }
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			// The components aren't initialized
+			sVector() {}
+			sVector( const float i_x, const float i_y, const float i_z, const float i_w ) : x( i_x ), y( i_y ), z( i_z ), w( i_w ) {}
+			explicit sVector( const Simd::tFloat4 i_value ) { Simd::Store( i_value, &x ); }
+		};
+
+		inline sVector operator *( const float i_lhs, const sVector& i_rhs ) { return i_rhs * i_lhs; }
+
+		inline float Dot3( const sVector& i_a, const sVector& i_b ) { return Simd::GetX( Simd::Dot3( i_a.Load(), i_b.Load() ) ); }
+		inline float Dot4( const sVector& i_a, const sVector& i_b ) { return Simd::GetX( Simd::Dot4( i_a.Load(), i_b.Load() ) ); }
+		// The result's w is 0
+		inline sVector Cross( const sVector& i_a, const sVector& i_b ) { return sVector( Simd::Cross( i_a.Load(), i_b.Load() ) ); }
+		inline float Length( const sVector& i_vector ) { return Simd::GetX( Simd::SquareRoot( Simd::Dot3( i_vector.Load(), i_vector.Load() ) ) ); }
+		// x, y, and z are divided by the length, and w is unchanged.
+		// The vector must not be zero.
+		inline sVector Normalize( const sVector& i_vector )
+		{
+			const Simd::tFloat4 value = i_vector.Load();
+			const sVector normalized( Simd::Divide( value, Simd::SquareRoot( Simd::Dot3( value, value ) ) ) );
+			return sVector( normalized.x, normalized.y, normalized.z, i_vector.w );
+		}
+	}
+}
+
+#endif	// EAE6320_MATH_SVECTOR_H
@@ -43,6 +43,20 @@ namespace eae6320
 			sDataFromFile() : data( NULL ), size( 0 ) {}
 		};
 
+		// A mapped file is read directly from the operating system's file cache
+		// without being copied into allocated memory first
+		// (the data is read-only and is valid until UnmapBinaryFile() is called)
+		struct sMappedFile
+		{
+			const void* data;
+			size_t size;
+			// These are used by the platform-specific implementation
+			void* fileHandle;
+			void* mappingHandle;
+
+			sMappedFile() : data( NULL ), size( 0 ), fileHandle( NULL ), mappingHandle( NULL ) {}
+		};
+
 		bool CopyFile( const char* const i_path_source, const char* i_path_target,
 			const bool i_shouldFunctionFailIfTargetAlreadyExists = false, const bool i_shouldTargetFileTimeBeModified = false,
 			std::string* o_errorMessage = NULL );
@@ -53,6 +67,8 @@ namespace eae6320
 		bool GetLastWriteTime( const char* const i_path, uint64_t& o_lastWriteTime, std::string* const o_errorMessage = NULL );
 		bool InvalidateLastWriteTime( const char* const i_path, std::string* const o_errorMessage = NULL );
 		bool LoadBinaryFile( const char* const i_path, sDataFromFile& o_data, std::string* const o_errorMessage = NULL );
+		bool MapBinaryFile( const char* const i_path, sMappedFile& o_file, std::string* const o_errorMessage = NULL );
+		bool UnmapBinaryFile( sMappedFile& io_file, std::string* const o_errorMessage = NULL );
 		// This function writes an entire file in a single operation in the most efficient way possible.
 		// If you need to write out more than one smaller chunk to a file, however,
 		// you should use one of the standard library functions that does buffering.
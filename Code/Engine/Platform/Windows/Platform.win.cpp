@@ -65,6 +65,38 @@ bool eae6320::Platform::LoadBinaryFile( const char* const i_path, sDataFromFile&
 	return result;
 }
 
+bool eae6320::Platform::MapBinaryFile( const char* const i_path, sMappedFile& o_file, std::string* const o_errorMessage )
+{
+	Windows::sMappedFile mappedFile;
+	const bool result = Windows::MapBinaryFile( i_path, mappedFile, o_errorMessage );
+	{
+		o_file.data = mappedFile.data;
+		o_file.size = mappedFile.size;
+		o_file.fileHandle = ( mappedFile.fileHandle != INVALID_HANDLE_VALUE ) ? mappedFile.fileHandle : NULL;
+		o_file.mappingHandle = mappedFile.mappingHandle;
+	}
+	return result;
+}
+
+bool eae6320::Platform::UnmapBinaryFile( sMappedFile& io_file, std::string* const o_errorMessage )
+{
+	Windows::sMappedFile mappedFile;
+	{
+		mappedFile.data = io_file.data;
+		mappedFile.size = io_file.size;
+		mappedFile.fileHandle = io_file.fileHandle ? io_file.fileHandle : INVALID_HANDLE_VALUE;
+		mappedFile.mappingHandle = io_file.mappingHandle;
+	}
+	const bool result = Windows::UnmapBinaryFile( mappedFile, o_errorMessage );
+	{
+		io_file.data = NULL;
+		io_file.size = 0;
+		io_file.fileHandle = NULL;
+		io_file.mappingHandle = NULL;
+	}
+	return result;
+}
+
 bool eae6320::Platform::WriteBinaryFile( const char* const i_path, const void* const i_data, const size_t i_size, std::string* const o_errorMessage )
 {
 	return Windows::WriteBinaryFile( i_path, i_data, i_size, o_errorMessage );
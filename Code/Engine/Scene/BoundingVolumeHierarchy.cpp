@@ -0,0 +1,1112 @@
+// Header Files
+//=============
+
+#include "BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "../Asserts/Asserts.h"
+#include "../Logging/Logging.h"
+#include "../Math/Simd.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	typedef eae6320::Scene::BoundingVolumeHierarchy::sBox sBox;
+
+	// Empty child slots have this box so that every query rejects them
+	const sBox s_emptyBox = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+	// The SAH builder sorts the primitives' centers into this many bins along the longest axis
+	// and only considers splits between bins
+	// (which is much faster than considering a split between every primitive and almost as good)
+	const unsigned int s_binCount = 16;
+
+	struct sBin
+	{
+		sBox box;
+		uint32_t count;
+	};
+
+	// The builder moves copies of the boxes around
+	// so that it reads them in order instead of jumping around the caller's array
+	struct sBuildPrimitive
+	{
+		sBox box;
+		uint32_t primitive;
+	};
+
+	struct sBuildTask
+	{
+		uint32_t begin, end;
+		uint32_t node;
+	};
+
+	// Queries keep the nodes that still have to be visited on this stack,
+	// which only has to allocate memory if a tree is unusually deep
+	class TraversalStack
+	{
+	public:
+
+		struct sEntry
+		{
+			uint32_t node;
+			// This is the distance along the ray to the node's box (for ray casts)
+			float distance;
+		};
+
+		bool IsEmpty() const { return ( m_count == 0 ) && m_overflow.empty(); }
+		void Push( const uint32_t i_node, const float i_distance = 0.0f )
+		{
+			const sEntry entry = { i_node, i_distance };
+			if ( m_count < s_capacity )
+			{
+				m_entries[m_count++] = entry;
+			}
+			else
+			{
+				m_overflow.push_back( entry );
+			}
+		}
+		sEntry Pop()
+		{
+			if ( !m_overflow.empty() )
+			{
+				const sEntry entry = m_overflow.back();
+				m_overflow.pop_back();
+				return entry;
+			}
+			return m_entries[--m_count];
+		}
+
+		TraversalStack() : m_count( 0 ) {}
+
+	private:
+
+		static const unsigned int s_capacity = 128;
+		sEntry m_entries[s_capacity];
+		unsigned int m_count;
+		std::vector<sEntry> m_overflow;
+	};
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void Grow( const sBox& i_box, sBox& io_box );
+	// Half of the surface area is enough to compare costs
+	float GetHalfSurfaceArea( const sBox& i_box );
+	float GetCenter( const sBox& i_box, const unsigned int i_axis );
+	// The primitives in [i_begin, i_end) are partitioned into [i_begin, o_middle) and [o_middle, i_end)
+	void SplitRange( sBuildPrimitive* const io_primitives, const uint32_t i_begin, const uint32_t i_end,
+		uint32_t& o_middle, sBox& o_leftBox, sBox& o_rightBox );
+	// Returns the smallest of the 4 components (in every component)
+	eae6320::Math::Simd::tFloat4 GetMinimum4( const eae6320::Math::Simd::tFloat4 i_value );
+	eae6320::Math::Simd::tFloat4 GetMaximum4( const eae6320::Math::Simd::tFloat4 i_value );
+
+	// This is a xorshift generator
+	// (the benchmark only needs numbers that are the same every time it runs)
+	uint32_t GetNextRandomNumber( uint32_t& io_state );
+	float GetRandomFloat( uint32_t& io_state );
+	bool DoBoxesOverlap( const sBox& i_a, const sBox& i_b );
+	bool IsBoxInFrustum( const sBox& i_box, const eae6320::Scene::BoundingVolumeHierarchy::sFrustum& i_frustum );
+	bool DoesRayHitBox( const float i_origin[3], const float i_direction[3], const sBox& i_box, const float i_maxDistance, float& o_distance );
+}
+
+// Interface
+//==========
+
+// Build
+//------
+
+void eae6320::Scene::BoundingVolumeHierarchy::Build( const sBox* const i_boxes, const uint32_t i_boxCount )
+{
+	EAE6320_ASSERTF( i_boxCount < s_primitiveBit, "A bounding volume hierarchy can't have %u primitives", i_boxCount );
+	CleanUp();
+	m_primitiveSlots.resize( i_boxCount, static_cast<uint32_t>( s_emptySlot ) );
+	AddNode( s_emptySlot );
+	if ( i_boxCount == 0 )
+	{
+		return;
+	}
+
+	std::vector<sBuildPrimitive> primitives( i_boxCount );
+	for ( uint32_t i = 0; i < i_boxCount; ++i )
+	{
+		primitives[i].box = i_boxes[i];
+		primitives[i].primitive = i;
+	}
+	// Each task fills in a node that has already been added
+	// (the tasks are done depth first so that a node's children tend to be near it in memory)
+	std::vector<sBuildTask> tasks;
+	{
+		const sBuildTask rootTask = { 0, i_boxCount, 0 };
+		tasks.push_back( rootTask );
+	}
+	while ( !tasks.empty() )
+	{
+		const sBuildTask task = tasks.back();
+		tasks.pop_back();
+
+		// If there are few enough primitives they each get their own slot
+		if ( ( task.end - task.begin ) <= 4 )
+		{
+			for ( uint32_t i = task.begin; i < task.end; ++i )
+			{
+				const uint32_t slot = ( task.node * 4 ) + ( i - task.begin );
+				const uint32_t primitive = primitives[i].primitive;
+				SetChild( slot, primitive | s_primitiveBit, primitives[i].box );
+				m_primitiveSlots[primitive] = slot;
+			}
+			continue;
+		}
+		// Otherwise the range is split in two and then each half is split again,
+		// which gives up to 4 children
+		uint32_t rangeBegins[4], rangeEnds[4];
+		sBox rangeBoxes[4];
+		unsigned int rangeCount = 0;
+		{
+			uint32_t middle;
+			sBox halfBoxes[2];
+			SplitRange( &primitives[0], task.begin, task.end, middle, halfBoxes[0], halfBoxes[1] );
+			const uint32_t halfBegins[2] = { task.begin, middle };
+			const uint32_t halfEnds[2] = { middle, task.end };
+			for ( unsigned int h = 0; h < 2; ++h )
+			{
+				if ( ( halfEnds[h] - halfBegins[h] ) > 1 )
+				{
+					uint32_t quarterMiddle;
+					SplitRange( &primitives[0], halfBegins[h], halfEnds[h], quarterMiddle, rangeBoxes[rangeCount], rangeBoxes[rangeCount + 1] );
+					rangeBegins[rangeCount] = halfBegins[h];
+					rangeEnds[rangeCount] = quarterMiddle;
+					rangeBegins[rangeCount + 1] = quarterMiddle;
+					rangeEnds[rangeCount + 1] = halfEnds[h];
+					rangeCount += 2;
+				}
+				else
+				{
+					rangeBegins[rangeCount] = halfBegins[h];
+					rangeEnds[rangeCount] = halfEnds[h];
+					rangeBoxes[rangeCount] = halfBoxes[h];
+					++rangeCount;
+				}
+			}
+		}
+		for ( unsigned int r = 0; r < rangeCount; ++r )
+		{
+			const uint32_t slot = ( task.node * 4 ) + r;
+			if ( ( rangeEnds[r] - rangeBegins[r] ) == 1 )
+			{
+				const uint32_t primitive = primitives[rangeBegins[r]].primitive;
+				SetChild( slot, primitive | s_primitiveBit, primitives[rangeBegins[r]].box );
+				m_primitiveSlots[primitive] = slot;
+			}
+			else
+			{
+				const uint32_t child = AddNode( slot );
+				SetChild( slot, child, rangeBoxes[r] );
+				const sBuildTask childTask = { rangeBegins[r], rangeEnds[r], child };
+				tasks.push_back( childTask );
+			}
+		}
+	}
+}
+
+void eae6320::Scene::BoundingVolumeHierarchy::Refit( const sBox* const i_boxes )
+{
+	// Every node's children come after it,
+	// and so going backwards updates every child before its parent
+	for ( uint32_t n = static_cast<uint32_t>( m_nodes.size() ); n > 0; --n )
+	{
+		const uint32_t node = n - 1;
+		for ( uint32_t c = 0; c < 4; ++c )
+		{
+			const uint32_t child = m_nodes[node].children[c];
+			if ( child != s_emptySlot )
+			{
+				SetChild( ( node * 4 ) + c, child,
+					( ( child & s_primitiveBit ) != 0 ) ? i_boxes[child & ~s_primitiveBit] : CalculateNodeBox( child ) );
+			}
+		}
+	}
+}
+
+// Dynamic Primitives
+//-------------------
+
+uint32_t eae6320::Scene::BoundingVolumeHierarchy::InsertPrimitive( const sBox& i_box )
+{
+	uint32_t primitive;
+	if ( !m_freePrimitives.empty() )
+	{
+		primitive = m_freePrimitives.back();
+		m_freePrimitives.pop_back();
+	}
+	else
+	{
+		primitive = static_cast<uint32_t>( m_primitiveSlots.size() );
+		EAE6320_ASSERT( primitive < s_primitiveBit );
+		m_primitiveSlots.push_back( static_cast<uint32_t>( s_emptySlot ) );
+	}
+	if ( m_nodes.empty() )
+	{
+		AddNode( s_emptySlot );
+	}
+
+	// The primitive goes down the tree through the children whose surface areas would grow the least,
+	// and each of those children is grown along the way
+	uint32_t node = 0;
+	for ( ;; )
+	{
+		// If there is an empty slot the primitive can go there
+		uint32_t bestChild = 4;
+		for ( uint32_t c = 0; c < 4; ++c )
+		{
+			if ( m_nodes[node].children[c] == s_emptySlot )
+			{
+				bestChild = c;
+				break;
+			}
+		}
+		if ( bestChild < 4 )
+		{
+			const uint32_t slot = ( node * 4 ) + bestChild;
+			SetChild( slot, primitive | s_primitiveBit, i_box );
+			m_primitiveSlots[primitive] = slot;
+			break;
+		}
+		sBox grownBoxes[4];
+		{
+			float bestGrowth = FLT_MAX, bestHalfSurfaceArea = FLT_MAX;
+			for ( uint32_t c = 0; c < 4; ++c )
+			{
+				const sBox childBox = GetChildBox( ( node * 4 ) + c );
+				const float halfSurfaceArea = GetHalfSurfaceArea( childBox );
+				grownBoxes[c] = childBox;
+				Grow( i_box, grownBoxes[c] );
+				const float growth = GetHalfSurfaceArea( grownBoxes[c] ) - halfSurfaceArea;
+				if ( ( growth < bestGrowth ) || ( ( growth == bestGrowth ) && ( halfSurfaceArea < bestHalfSurfaceArea ) ) )
+				{
+					bestChild = c;
+					bestGrowth = growth;
+					bestHalfSurfaceArea = halfSurfaceArea;
+				}
+			}
+		}
+		const uint32_t slot = ( node * 4 ) + bestChild;
+		const uint32_t child = m_nodes[node].children[bestChild];
+		if ( ( child & s_primitiveBit ) != 0 )
+		{
+			// A primitive is replaced with a node that has both primitives
+			const sBox childBox = GetChildBox( slot );
+			const uint32_t newNode = AddNode( slot );
+			SetChild( newNode * 4, child, childBox );
+			m_primitiveSlots[child & ~s_primitiveBit] = newNode * 4;
+			SetChild( ( newNode * 4 ) + 1, primitive | s_primitiveBit, i_box );
+			m_primitiveSlots[primitive] = ( newNode * 4 ) + 1;
+			SetChild( slot, newNode, grownBoxes[bestChild] );
+			break;
+		}
+		SetChild( slot, child, grownBoxes[bestChild] );
+		node = child;
+	}
+	// The primitive's box is already part of every ancestor's box
+	return primitive;
+}
+
+void eae6320::Scene::BoundingVolumeHierarchy::RemovePrimitive( const uint32_t i_primitive )
+{
+	EAE6320_ASSERT( ( i_primitive < m_primitiveSlots.size() ) && ( m_primitiveSlots[i_primitive] != s_emptySlot ) );
+	const uint32_t slot = m_primitiveSlots[i_primitive];
+	SetChild( slot, s_emptySlot, s_emptyBox );
+	m_primitiveSlots[i_primitive] = s_emptySlot;
+	m_freePrimitives.push_back( i_primitive );
+
+	// A node that is left empty is removed from its parent,
+	// and a node that is left with a single child is replaced by that child.
+	// The removed nodes stay in the array (with no children) until the tree is rebuilt.
+	uint32_t node = slot / 4;
+	while ( node != 0 )
+	{
+		uint32_t childCount = 0, onlyChild = 0;
+		for ( uint32_t c = 0; c < 4; ++c )
+		{
+			if ( m_nodes[node].children[c] != s_emptySlot )
+			{
+				++childCount;
+				onlyChild = c;
+			}
+		}
+		const uint32_t parentSlot = m_nodes[node].parentSlot;
+		if ( childCount == 0 )
+		{
+			SetChild( parentSlot, s_emptySlot, s_emptyBox );
+			node = parentSlot / 4;
+		}
+		else
+		{
+			if ( childCount == 1 )
+			{
+				const uint32_t child = m_nodes[node].children[onlyChild];
+				SetChild( parentSlot, child, GetChildBox( ( node * 4 ) + onlyChild ) );
+				if ( ( child & s_primitiveBit ) != 0 )
+				{
+					m_primitiveSlots[child & ~s_primitiveBit] = parentSlot;
+				}
+				SetChild( ( node * 4 ) + onlyChild, s_emptySlot, s_emptyBox );
+				node = parentSlot / 4;
+			}
+			break;
+		}
+	}
+	UpdateAncestors( node );
+}
+
+void eae6320::Scene::BoundingVolumeHierarchy::UpdatePrimitive( const uint32_t i_primitive, const sBox& i_box )
+{
+	EAE6320_ASSERT( ( i_primitive < m_primitiveSlots.size() ) && ( m_primitiveSlots[i_primitive] != s_emptySlot ) );
+	const uint32_t slot = m_primitiveSlots[i_primitive];
+	SetChild( slot, i_primitive | s_primitiveBit, i_box );
+	UpdateAncestors( slot / 4 );
+}
+
+// Queries
+//--------
+
+void eae6320::Scene::BoundingVolumeHierarchy::QueryBox( const sBox& i_box, std::vector<uint32_t>& o_primitives ) const
+{
+	o_primitives.clear();
+	if ( m_nodes.empty() )
+	{
+		return;
+	}
+	const Math::Simd::tFloat4 queryMinimumX = Math::Simd::Splat( i_box.minimum[0] );
+	const Math::Simd::tFloat4 queryMinimumY = Math::Simd::Splat( i_box.minimum[1] );
+	const Math::Simd::tFloat4 queryMinimumZ = Math::Simd::Splat( i_box.minimum[2] );
+	const Math::Simd::tFloat4 queryMaximumX = Math::Simd::Splat( i_box.maximum[0] );
+	const Math::Simd::tFloat4 queryMaximumY = Math::Simd::Splat( i_box.maximum[1] );
+	const Math::Simd::tFloat4 queryMaximumZ = Math::Simd::Splat( i_box.maximum[2] );
+
+	TraversalStack stack;
+	stack.Push( 0 );
+	while ( !stack.IsEmpty() )
+	{
+		const sNode& node = m_nodes[stack.Pop().node];
+		// A child overlaps if its box overlaps on every axis
+		Math::Simd::tMask4 overlaps = Math::Simd::And(
+			Math::Simd::IsLessOrEqual( Math::Simd::Load( node.minimumX ), queryMaximumX ),
+			Math::Simd::IsLessOrEqual( queryMinimumX, Math::Simd::Load( node.maximumX ) ) );
+		overlaps = Math::Simd::And( overlaps, Math::Simd::And(
+			Math::Simd::IsLessOrEqual( Math::Simd::Load( node.minimumY ), queryMaximumY ),
+			Math::Simd::IsLessOrEqual( queryMinimumY, Math::Simd::Load( node.maximumY ) ) ) );
+		overlaps = Math::Simd::And( overlaps, Math::Simd::And(
+			Math::Simd::IsLessOrEqual( Math::Simd::Load( node.minimumZ ), queryMaximumZ ),
+			Math::Simd::IsLessOrEqual( queryMinimumZ, Math::Simd::Load( node.maximumZ ) ) ) );
+		const unsigned int overlapBits = Math::Simd::GetBits( overlaps );
+		for ( uint32_t c = 0; c < 4; ++c )
+		{
+			const uint32_t child = node.children[c];
+			if ( ( ( overlapBits & ( 1u << c ) ) != 0 ) && ( child != s_emptySlot ) )
+			{
+				if ( ( child & s_primitiveBit ) != 0 )
+				{
+					o_primitives.push_back( child & ~s_primitiveBit );
+				}
+				else
+				{
+					stack.Push( child );
+				}
+			}
+		}
+	}
+}
+
+void eae6320::Scene::BoundingVolumeHierarchy::QueryFrustum( const sFrustum& i_frustum, std::vector<uint32_t>& o_primitives ) const
+{
+	o_primitives.clear();
+	if ( m_nodes.empty() )
+	{
+		return;
+	}
+	// A box is outside of a plane if the corner that is the furthest along the plane's normal is outside,
+	// and which corner that is only depends on the signs of the normal
+	Math::Simd::tFloat4 normalsX[6], normalsY[6], normalsZ[6], distances[6];
+	bool areNormalsPositive[6][3];
+	for ( unsigned int p = 0; p < 6; ++p )
+	{
+		normalsX[p] = Math::Simd::Splat( i_frustum.planes[p][0] );
+		normalsY[p] = Math::Simd::Splat( i_frustum.planes[p][1] );
+		normalsZ[p] = Math::Simd::Splat( i_frustum.planes[p][2] );
+		distances[p] = Math::Simd::Splat( i_frustum.planes[p][3] );
+		for ( unsigned int a = 0; a < 3; ++a )
+		{
+			areNormalsPositive[p][a] = i_frustum.planes[p][a] >= 0.0f;
+		}
+	}
+	const Math::Simd::tFloat4 zero = Math::Simd::Splat( 0.0f );
+
+	TraversalStack stack;
+	stack.Push( 0 );
+	while ( !stack.IsEmpty() )
+	{
+		const sNode& node = m_nodes[stack.Pop().node];
+		unsigned int insideBits = 0xf;
+		for ( unsigned int p = 0; ( p < 6 ) && ( insideBits != 0 ); ++p )
+		{
+			const Math::Simd::tFloat4 cornerX = Math::Simd::Load( areNormalsPositive[p][0] ? node.maximumX : node.minimumX );
+			const Math::Simd::tFloat4 cornerY = Math::Simd::Load( areNormalsPositive[p][1] ? node.maximumY : node.minimumY );
+			const Math::Simd::tFloat4 cornerZ = Math::Simd::Load( areNormalsPositive[p][2] ? node.maximumZ : node.minimumZ );
+			const Math::Simd::tFloat4 distance = Math::Simd::MultiplyAdd( normalsX[p], cornerX,
+				Math::Simd::MultiplyAdd( normalsY[p], cornerY, Math::Simd::MultiplyAdd( normalsZ[p], cornerZ, distances[p] ) ) );
+			insideBits &= Math::Simd::GetBits( Math::Simd::IsLessOrEqual( zero, distance ) );
+		}
+		for ( uint32_t c = 0; c < 4; ++c )
+		{
+			const uint32_t child = node.children[c];
+			if ( ( ( insideBits & ( 1u << c ) ) != 0 ) && ( child != s_emptySlot ) )
+			{
+				if ( ( child & s_primitiveBit ) != 0 )
+				{
+					o_primitives.push_back( child & ~s_primitiveBit );
+				}
+				else
+				{
+					stack.Push( child );
+				}
+			}
+		}
+	}
+}
+
+uint32_t eae6320::Scene::BoundingVolumeHierarchy::Raycast( const float i_origin[3], const float i_direction[3], const float i_maxDistance,
+	float& o_distance, fRayTest i_rayTest, void* const io_userData ) const
+{
+	uint32_t nearestPrimitive = s_noPrimitive;
+	float nearestDistance = i_maxDistance;
+	if ( m_nodes.empty() )
+	{
+		return s_noPrimitive;
+	}
+
+	// Each box is tested by finding where the ray enters and exits the slabs between its planes on each axis
+	// (a direction of 0 is replaced with a tiny number so that the division doesn't make NaNs)
+	Math::Simd::tFloat4 origins[3], inverseDirections[3];
+	for ( unsigned int a = 0; a < 3; ++a )
+	{
+		const float minDirection = 1.0e-20f;
+		const float direction = ( std::abs( i_direction[a] ) >= minDirection ) ? i_direction[a]
+			: ( ( i_direction[a] < 0.0f ) ? -minDirection : minDirection );
+		origins[a] = Math::Simd::Splat( i_origin[a] );
+		inverseDirections[a] = Math::Simd::Splat( 1.0f / direction );
+	}
+	const Math::Simd::tFloat4 zero = Math::Simd::Splat( 0.0f );
+
+	// The closest children are visited first
+	// so that further ones can be skipped once something has been hit
+	TraversalStack stack;
+	stack.Push( 0, 0.0f );
+	while ( !stack.IsEmpty() )
+	{
+		const TraversalStack::sEntry entry = stack.Pop();
+		if ( entry.distance > nearestDistance )
+		{
+			continue;
+		}
+		const sNode& node = m_nodes[entry.node];
+
+		Math::Simd::tFloat4 entryDistances = zero;
+		Math::Simd::tFloat4 exitDistances = Math::Simd::Splat( nearestDistance );
+		{
+			const float* const minimums[3] = { node.minimumX, node.minimumY, node.minimumZ };
+			const float* const maximums[3] = { node.maximumX, node.maximumY, node.maximumZ };
+			for ( unsigned int a = 0; a < 3; ++a )
+			{
+				const Math::Simd::tFloat4 distances_minimum = Math::Simd::Multiply(
+					Math::Simd::Subtract( Math::Simd::Load( minimums[a] ), origins[a] ), inverseDirections[a] );
+				const Math::Simd::tFloat4 distances_maximum = Math::Simd::Multiply(
+					Math::Simd::Subtract( Math::Simd::Load( maximums[a] ), origins[a] ), inverseDirections[a] );
+				entryDistances = Math::Simd::Maximum( entryDistances, Math::Simd::Minimum( distances_minimum, distances_maximum ) );
+				exitDistances = Math::Simd::Minimum( exitDistances, Math::Simd::Maximum( distances_minimum, distances_maximum ) );
+			}
+		}
+		const unsigned int hitBits = Math::Simd::GetBits( Math::Simd::IsLessOrEqual( entryDistances, exitDistances ) );
+		if ( hitBits == 0 )
+		{
+			continue;
+		}
+
+		// The hit children are sorted from nearest to furthest
+		uint32_t hitChildren[4];
+		float hitDistances[4];
+		unsigned int hitCount = 0;
+		{
+			float distances[4];
+			Math::Simd::Store( entryDistances, distances );
+			for ( uint32_t c = 0; c < 4; ++c )
+			{
+				const uint32_t child = node.children[c];
+				if ( ( ( hitBits & ( 1u << c ) ) != 0 ) && ( child != s_emptySlot ) )
+				{
+					unsigned int i = hitCount++;
+					for ( ; ( i > 0 ) && ( hitDistances[i - 1] > distances[c] ); --i )
+					{
+						hitChildren[i] = hitChildren[i - 1];
+						hitDistances[i] = hitDistances[i - 1];
+					}
+					hitChildren[i] = child;
+					hitDistances[i] = distances[c];
+				}
+			}
+		}
+		// Primitives are tested right away (nearest first),
+		// and nodes are pushed furthest first so that the nearest is popped first
+		for ( unsigned int i = 0; i < hitCount; ++i )
+		{
+			const uint32_t child = hitChildren[i];
+			if ( ( ( child & s_primitiveBit ) != 0 ) && ( hitDistances[i] <= nearestDistance ) )
+			{
+				const uint32_t primitive = child & ~s_primitiveBit;
+				float distance = hitDistances[i];
+				if ( ( !i_rayTest || i_rayTest( primitive, i_origin, i_direction, distance, io_userData ) )
+					&& ( distance <= nearestDistance ) )
+				{
+					nearestPrimitive = primitive;
+					nearestDistance = distance;
+				}
+			}
+		}
+		for ( unsigned int i = hitCount; i > 0; --i )
+		{
+			const uint32_t child = hitChildren[i - 1];
+			if ( ( child & s_primitiveBit ) == 0 )
+			{
+				stack.Push( child, hitDistances[i - 1] );
+			}
+		}
+	}
+
+	if ( nearestPrimitive != s_noPrimitive )
+	{
+		o_distance = nearestDistance;
+	}
+	return nearestPrimitive;
+}
+
+// Benchmark
+//----------
+
+void eae6320::Scene::BoundingVolumeHierarchy::LogQueryCost()
+{
+	const uint32_t primitiveCount = 1000 * 1000;
+	const float worldSize = 1000.0f;
+	const unsigned int queryCount = 10 * 1000;
+	const unsigned int checkedQueryCount = 16;
+	const float queryBoxSize = 20.0f;
+	const unsigned int changedPrimitiveCount = 10 * 1000;
+
+	// The boxes are scattered randomly with random sizes
+	uint32_t randomState = 0x9e3779b9u;
+	std::vector<sBox> boxes( primitiveCount );
+	for ( uint32_t i = 0; i < primitiveCount; ++i )
+	{
+		for ( unsigned int a = 0; a < 3; ++a )
+		{
+			const float center = ( GetRandomFloat( randomState ) * 0.5f + 0.5f ) * worldSize;
+			const float halfSize = 0.25f + ( GetRandomFloat( randomState ) * 0.5f + 0.5f );
+			boxes[i].minimum[a] = center - halfSize;
+			boxes[i].maximum[a] = center + halfSize;
+		}
+	}
+
+	BoundingVolumeHierarchy hierarchy;
+	double secondCount_build, secondCount_refit, secondCount_removing, secondCount_inserting;
+	{
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		hierarchy.Build( &boxes[0], primitiveCount );
+		secondCount_build = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	}
+	// Every box moves a little
+	{
+		for ( uint32_t i = 0; i < primitiveCount; ++i )
+		{
+			for ( unsigned int a = 0; a < 3; ++a )
+			{
+				const float offset = GetRandomFloat( randomState ) * 0.5f;
+				boxes[i].minimum[a] += offset;
+				boxes[i].maximum[a] += offset;
+			}
+		}
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		hierarchy.Refit( &boxes[0] );
+		secondCount_refit = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	}
+	// Some of the boxes are removed and then added somewhere else
+	// (the primitives that are removed last are reused first, and so each keeps its number)
+	{
+		std::vector<uint32_t> changedPrimitives( changedPrimitiveCount );
+		for ( unsigned int i = 0; i < changedPrimitiveCount; ++i )
+		{
+			changedPrimitives[i] = static_cast<uint32_t>( ( static_cast<uint64_t>( i ) * primitiveCount ) / changedPrimitiveCount );
+		}
+		uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		for ( unsigned int i = 0; i < changedPrimitiveCount; ++i )
+		{
+			hierarchy.RemovePrimitive( changedPrimitives[i] );
+		}
+		secondCount_removing = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+		for ( unsigned int i = changedPrimitiveCount; i > 0; --i )
+		{
+			sBox& box = boxes[changedPrimitives[i - 1]];
+			for ( unsigned int a = 0; a < 3; ++a )
+			{
+				const float offset = GetRandomFloat( randomState ) * 10.0f;
+				box.minimum[a] += offset;
+				box.maximum[a] += offset;
+			}
+		}
+		tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		for ( unsigned int i = changedPrimitiveCount; i > 0; --i )
+		{
+			const uint32_t primitive = hierarchy.InsertPrimitive( boxes[changedPrimitives[i - 1]] );
+			EAE6320_ASSERT( primitive == changedPrimitives[i - 1] );
+			static_cast<void>( primitive );
+		}
+		secondCount_inserting = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	}
+	Logging::OutputMessage( "Querying a bounding volume hierarchy of %u boxes (%u nodes):", primitiveCount, hierarchy.GetNodeCount() );
+	Logging::OutputMessage( "\tBuilding took %.1f ms and refitting took %.1f ms;"
+		" removing a box took %.2f microseconds and inserting a box took %.2f microseconds",
+		secondCount_build * 1000.0, secondCount_refit * 1000.0,
+		secondCount_removing * 1.0e6 / changedPrimitiveCount, secondCount_inserting * 1.0e6 / changedPrimitiveCount );
+
+	// Each kind of query is done at random places
+	// and the first few are checked against testing every box
+	std::vector<uint32_t> primitives, expectedPrimitives;
+	const char* const queryNames[] = { "Box", "Frustum", "Ray" };
+	for ( unsigned int q = 0; q < 3; ++q )
+	{
+		double secondCount_querying = 0.0, secondCount_testingEveryBox = 0.0;
+		size_t resultCount = 0;
+		unsigned int mismatchCount = 0;
+		for ( unsigned int i = 0; i < queryCount; ++i )
+		{
+			const bool shouldBeChecked = i < checkedQueryCount;
+			float position[3];
+			for ( unsigned int a = 0; a < 3; ++a )
+			{
+				position[a] = ( GetRandomFloat( randomState ) * 0.5f + 0.5f ) * worldSize;
+			}
+			if ( q == 0 )
+			{
+				sBox queryBox;
+				for ( unsigned int a = 0; a < 3; ++a )
+				{
+					queryBox.minimum[a] = position[a];
+					queryBox.maximum[a] = position[a] + queryBoxSize;
+				}
+				uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+				hierarchy.QueryBox( queryBox, primitives );
+				secondCount_querying += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+				resultCount += primitives.size();
+				if ( shouldBeChecked )
+				{
+					tickCount_start = Time::GetCurrentSystemTimeTickCount();
+					expectedPrimitives.clear();
+					for ( uint32_t j = 0; j < primitiveCount; ++j )
+					{
+						if ( DoBoxesOverlap( boxes[j], queryBox ) )
+						{
+							expectedPrimitives.push_back( j );
+						}
+					}
+					secondCount_testingEveryBox += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+				}
+			}
+			else if ( q == 1 )
+			{
+				// The frustum looks down the z axis with a 90 degree field of view
+				// and a far plane that is the same distance away as the query box's size
+				const float zFar = queryBoxSize;
+				const sFrustum frustum = { {
+					{ 0.0f, 0.0f, 1.0f, -position[2] },
+					{ 0.0f, 0.0f, -1.0f, position[2] + zFar },
+					{ 1.0f, 0.0f, 1.0f, -position[0] - position[2] },
+					{ -1.0f, 0.0f, 1.0f, position[0] - position[2] },
+					{ 0.0f, 1.0f, 1.0f, -position[1] - position[2] },
+					{ 0.0f, -1.0f, 1.0f, position[1] - position[2] } } };
+				uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+				hierarchy.QueryFrustum( frustum, primitives );
+				secondCount_querying += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+				resultCount += primitives.size();
+				if ( shouldBeChecked )
+				{
+					tickCount_start = Time::GetCurrentSystemTimeTickCount();
+					expectedPrimitives.clear();
+					for ( uint32_t j = 0; j < primitiveCount; ++j )
+					{
+						if ( IsBoxInFrustum( boxes[j], frustum ) )
+						{
+							expectedPrimitives.push_back( j );
+						}
+					}
+					secondCount_testingEveryBox += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+				}
+			}
+			else
+			{
+				// The rays go in random directions
+				// and are long enough to cross the whole world
+				float direction[3];
+				for ( unsigned int a = 0; a < 3; ++a )
+				{
+					direction[a] = GetRandomFloat( randomState );
+				}
+				const float maxDistance = worldSize;
+				float distance;
+				uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+				const uint32_t primitive = hierarchy.Raycast( position, direction, maxDistance, distance );
+				secondCount_querying += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+				primitives.clear();
+				if ( primitive != s_noPrimitive )
+				{
+					primitives.push_back( primitive );
+					++resultCount;
+				}
+				if ( shouldBeChecked )
+				{
+					tickCount_start = Time::GetCurrentSystemTimeTickCount();
+					expectedPrimitives.clear();
+					float nearestDistance = maxDistance;
+					uint32_t nearestPrimitive = s_noPrimitive;
+					for ( uint32_t j = 0; j < primitiveCount; ++j )
+					{
+						float boxDistance;
+						if ( DoesRayHitBox( position, direction, boxes[j], nearestDistance, boxDistance ) )
+						{
+							nearestDistance = boxDistance;
+							nearestPrimitive = j;
+						}
+					}
+					if ( nearestPrimitive != s_noPrimitive )
+					{
+						expectedPrimitives.push_back( nearestPrimitive );
+					}
+					secondCount_testingEveryBox += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+				}
+			}
+			if ( shouldBeChecked )
+			{
+				std::sort( primitives.begin(), primitives.end() );
+				if ( primitives != expectedPrimitives )
+				{
+					++mismatchCount;
+				}
+			}
+		}
+
+		const double secondCountPerQuery = secondCount_querying / queryCount;
+		const double secondCountPerQuery_testingEveryBox = secondCount_testingEveryBox / checkedQueryCount;
+		Logging::OutputMessage( "\t%s queries: %.1f queries per millisecond with %.1f results each,"
+			" which is %.0fx faster than testing every box (%u of %u checked queries had different results)",
+			queryNames[q], 1.0e-3 / secondCountPerQuery, static_cast<double>( resultCount ) / queryCount,
+			secondCountPerQuery_testingEveryBox / secondCountPerQuery, mismatchCount, checkedQueryCount );
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+void eae6320::Scene::BoundingVolumeHierarchy::CleanUp()
+{
+	m_nodes.clear();
+	m_primitiveSlots.clear();
+	m_freePrimitives.clear();
+}
+
+// Implementation
+//===============
+
+void eae6320::Scene::BoundingVolumeHierarchy::SetChild( const uint32_t i_slot, const uint32_t i_child, const sBox& i_box )
+{
+	sNode& node = m_nodes[i_slot / 4];
+	const uint32_t c = i_slot % 4;
+	node.minimumX[c] = i_box.minimum[0];
+	node.minimumY[c] = i_box.minimum[1];
+	node.minimumZ[c] = i_box.minimum[2];
+	node.maximumX[c] = i_box.maximum[0];
+	node.maximumY[c] = i_box.maximum[1];
+	node.maximumZ[c] = i_box.maximum[2];
+	node.children[c] = i_child;
+	if ( ( i_child & s_primitiveBit ) == 0 )
+	{
+		m_nodes[i_child].parentSlot = i_slot;
+	}
+}
+
+uint32_t eae6320::Scene::BoundingVolumeHierarchy::AddNode( const uint32_t i_parentSlot )
+{
+	sNode node;
+	for ( unsigned int c = 0; c < 4; ++c )
+	{
+		node.minimumX[c] = node.minimumY[c] = node.minimumZ[c] = FLT_MAX;
+		node.maximumX[c] = node.maximumY[c] = node.maximumZ[c] = -FLT_MAX;
+		node.children[c] = s_emptySlot;
+	}
+	node.parentSlot = i_parentSlot;
+	node.padding[0] = node.padding[1] = node.padding[2] = 0;
+	m_nodes.push_back( node );
+	return static_cast<uint32_t>( m_nodes.size() - 1 );
+}
+
+eae6320::Scene::BoundingVolumeHierarchy::sBox eae6320::Scene::BoundingVolumeHierarchy::GetChildBox( const uint32_t i_slot ) const
+{
+	const sNode& node = m_nodes[i_slot / 4];
+	const uint32_t c = i_slot % 4;
+	const sBox box = { { node.minimumX[c], node.minimumY[c], node.minimumZ[c] }, { node.maximumX[c], node.maximumY[c], node.maximumZ[c] } };
+	return box;
+}
+
+eae6320::Scene::BoundingVolumeHierarchy::sBox eae6320::Scene::BoundingVolumeHierarchy::CalculateNodeBox( const uint32_t i_node ) const
+{
+	const sNode& node = m_nodes[i_node];
+	// Empty slots have an inside-out box that doesn't change the result
+	const sBox box = {
+		{
+			Math::Simd::GetX( GetMinimum4( Math::Simd::Load( node.minimumX ) ) ),
+			Math::Simd::GetX( GetMinimum4( Math::Simd::Load( node.minimumY ) ) ),
+			Math::Simd::GetX( GetMinimum4( Math::Simd::Load( node.minimumZ ) ) )
+		},
+		{
+			Math::Simd::GetX( GetMaximum4( Math::Simd::Load( node.maximumX ) ) ),
+			Math::Simd::GetX( GetMaximum4( Math::Simd::Load( node.maximumY ) ) ),
+			Math::Simd::GetX( GetMaximum4( Math::Simd::Load( node.maximumZ ) ) )
+		} };
+	return box;
+}
+
+void eae6320::Scene::BoundingVolumeHierarchy::UpdateAncestors( uint32_t i_node )
+{
+	for ( uint32_t parentSlot = m_nodes[i_node].parentSlot; parentSlot != s_emptySlot; parentSlot = m_nodes[i_node].parentSlot )
+	{
+		SetChild( parentSlot, i_node, CalculateNodeBox( i_node ) );
+		i_node = parentSlot / 4;
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void Grow( const sBox& i_box, sBox& io_box )
+	{
+		for ( unsigned int a = 0; a < 3; ++a )
+		{
+			io_box.minimum[a] = std::min( io_box.minimum[a], i_box.minimum[a] );
+			io_box.maximum[a] = std::max( io_box.maximum[a], i_box.maximum[a] );
+		}
+	}
+
+	float GetHalfSurfaceArea( const sBox& i_box )
+	{
+		const float sizeX = i_box.maximum[0] - i_box.minimum[0];
+		const float sizeY = i_box.maximum[1] - i_box.minimum[1];
+		const float sizeZ = i_box.maximum[2] - i_box.minimum[2];
+		// An empty box is inside out
+		return ( ( sizeX >= 0.0f ) && ( sizeY >= 0.0f ) && ( sizeZ >= 0.0f ) ) ? ( ( sizeX * sizeY ) + ( sizeY * sizeZ ) + ( sizeZ * sizeX ) ) : 0.0f;
+	}
+
+	float GetCenter( const sBox& i_box, const unsigned int i_axis )
+	{
+		return ( i_box.minimum[i_axis] + i_box.maximum[i_axis] ) * 0.5f;
+	}
+
+	void SplitRange( sBuildPrimitive* const io_primitives, const uint32_t i_begin, const uint32_t i_end,
+		uint32_t& o_middle, sBox& o_leftBox, sBox& o_rightBox )
+	{
+		EAE6320_ASSERT( ( i_end - i_begin ) >= 2 );
+
+		// The range is split along the axis that its primitives' centers are the most spread out on
+		sBox centerBox = s_emptyBox;
+		for ( uint32_t i = i_begin; i < i_end; ++i )
+		{
+			const sBox& box = io_primitives[i].box;
+			for ( unsigned int a = 0; a < 3; ++a )
+			{
+				const float center = GetCenter( box, a );
+				centerBox.minimum[a] = std::min( centerBox.minimum[a], center );
+				centerBox.maximum[a] = std::max( centerBox.maximum[a], center );
+			}
+		}
+		unsigned int axis = 0;
+		for ( unsigned int a = 1; a < 3; ++a )
+		{
+			if ( ( centerBox.maximum[a] - centerBox.minimum[a] ) > ( centerBox.maximum[axis] - centerBox.minimum[axis] ) )
+			{
+				axis = a;
+			}
+		}
+		const float extent = centerBox.maximum[axis] - centerBox.minimum[axis];
+
+		// If every center is in the same place the primitives can't be separated,
+		// and so the range is split in the middle
+		if ( !( extent > 0.0f ) )
+		{
+			o_middle = i_begin + ( ( i_end - i_begin ) / 2 );
+			o_leftBox = o_rightBox = s_emptyBox;
+			for ( uint32_t i = i_begin; i < i_end; ++i )
+			{
+				Grow( io_primitives[i].box, ( i < o_middle ) ? o_leftBox : o_rightBox );
+			}
+			return;
+		}
+
+		// Each primitive is put in the bin that its center is in
+		const float binScale = ( s_binCount * 0.9999f ) / extent;
+		sBin bins[s_binCount];
+		for ( unsigned int b = 0; b < s_binCount; ++b )
+		{
+			bins[b].box = s_emptyBox;
+			bins[b].count = 0;
+		}
+		for ( uint32_t i = i_begin; i < i_end; ++i )
+		{
+			const sBox& box = io_primitives[i].box;
+			const unsigned int b = static_cast<unsigned int>( ( GetCenter( box, axis ) - centerBox.minimum[axis] ) * binScale );
+			sBin& bin = bins[std::min( b, s_binCount - 1 )];
+			Grow( box, bin.box );
+			++bin.count;
+		}
+		// The cost of splitting after each bin is the surface area of each side times the number of primitives in it
+		// (the first and last bins always have a primitive, and so every split has a primitive on each side)
+		float leftCosts[s_binCount - 1];
+		{
+			sBox leftBox = s_emptyBox;
+			uint32_t leftCount = 0;
+			for ( unsigned int b = 0; b < ( s_binCount - 1 ); ++b )
+			{
+				Grow( bins[b].box, leftBox );
+				leftCount += bins[b].count;
+				leftCosts[b] = GetHalfSurfaceArea( leftBox ) * leftCount;
+			}
+		}
+		unsigned int bestSplit = 0;
+		{
+			float bestCost = FLT_MAX;
+			sBox rightBox = s_emptyBox;
+			uint32_t rightCount = 0;
+			for ( unsigned int b = s_binCount - 1; b > 0; --b )
+			{
+				Grow( bins[b].box, rightBox );
+				rightCount += bins[b].count;
+				const float cost = leftCosts[b - 1] + ( GetHalfSurfaceArea( rightBox ) * rightCount );
+				if ( ( cost < bestCost ) && ( rightCount < ( i_end - i_begin ) ) )
+				{
+					bestCost = cost;
+					bestSplit = b - 1;
+				}
+			}
+		}
+
+		// The primitives in the bins up to and including the best split are moved to the front
+		uint32_t middle = i_begin;
+		for ( uint32_t i = i_begin; i < i_end; ++i )
+		{
+			const unsigned int b = static_cast<unsigned int>( ( GetCenter( io_primitives[i].box, axis ) - centerBox.minimum[axis] ) * binScale );
+			if ( std::min( b, s_binCount - 1 ) <= bestSplit )
+			{
+				std::swap( io_primitives[i], io_primitives[middle] );
+				++middle;
+			}
+		}
+		EAE6320_ASSERT( ( middle > i_begin ) && ( middle < i_end ) );
+		o_middle = middle;
+		o_leftBox = o_rightBox = s_emptyBox;
+		for ( unsigned int b = 0; b < s_binCount; ++b )
+		{
+			Grow( bins[b].box, ( b <= bestSplit ) ? o_leftBox : o_rightBox );
+		}
+	}
+
+	eae6320::Math::Simd::tFloat4 GetMinimum4( const eae6320::Math::Simd::tFloat4 i_value )
+	{
+		using namespace eae6320::Math::Simd;
+		const tFloat4 pairs = Minimum( i_value, Swizzle<1, 0, 3, 2>( i_value ) );
+		return Minimum( pairs, Swizzle<2, 3, 0, 1>( pairs ) );
+	}
+
+	eae6320::Math::Simd::tFloat4 GetMaximum4( const eae6320::Math::Simd::tFloat4 i_value )
+	{
+		using namespace eae6320::Math::Simd;
+		const tFloat4 pairs = Maximum( i_value, Swizzle<1, 0, 3, 2>( i_value ) );
+		return Maximum( pairs, Swizzle<2, 3, 0, 1>( pairs ) );
+	}
+
+	uint32_t GetNextRandomNumber( uint32_t& io_state )
+	{
+		io_state ^= io_state << 13;
+		io_state ^= io_state >> 17;
+		io_state ^= io_state << 5;
+		return io_state;
+	}
+
+	// Returns a number between -1 and 1
+	float GetRandomFloat( uint32_t& io_state )
+	{
+		return ( static_cast<float>( GetNextRandomNumber( io_state ) & 0xffff ) / 32768.0f ) - 1.0f;
+	}
+
+	bool DoBoxesOverlap( const sBox& i_a, const sBox& i_b )
+	{
+		for ( unsigned int a = 0; a < 3; ++a )
+		{
+			if ( ( i_a.minimum[a] > i_b.maximum[a] ) || ( i_b.minimum[a] > i_a.maximum[a] ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool IsBoxInFrustum( const sBox& i_box, const eae6320::Scene::BoundingVolumeHierarchy::sFrustum& i_frustum )
+	{
+		for ( unsigned int p = 0; p < 6; ++p )
+		{
+			const float* const plane = i_frustum.planes[p];
+			float distance = plane[3];
+			for ( unsigned int a = 0; a < 3; ++a )
+			{
+				distance += plane[a] * ( ( plane[a] >= 0.0f ) ? i_box.maximum[a] : i_box.minimum[a] );
+			}
+			if ( distance < 0.0f )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool DoesRayHitBox( const float i_origin[3], const float i_direction[3], const sBox& i_box, const float i_maxDistance, float& o_distance )
+	{
+		float entryDistance = 0.0f, exitDistance = i_maxDistance;
+		for ( unsigned int a = 0; a < 3; ++a )
+		{
+			const float minDirection = 1.0e-20f;
+			const float direction = ( std::abs( i_direction[a] ) >= minDirection ) ? i_direction[a]
+				: ( ( i_direction[a] < 0.0f ) ? -minDirection : minDirection );
+			const float inverseDirection = 1.0f / direction;
+			const float distance_minimum = ( i_box.minimum[a] - i_origin[a] ) * inverseDirection;
+			const float distance_maximum = ( i_box.maximum[a] - i_origin[a] ) * inverseDirection;
+			entryDistance = std::max( entryDistance, std::min( distance_minimum, distance_maximum ) );
+			exitDistance = std::min( exitDistance, std::max( distance_minimum, distance_maximum ) );
+		}
+		o_distance = entryDistance;
+		return entryDistance <= exitDistance;
+	}
+}
@@ -0,0 +1,160 @@
+/*
+	A bounding volume hierarchy is a tree of boxes that finds which objects are near a region
+	without testing every object
+
+	Every node has 4 children, and each child's box is stored in the node
+	as a structure of arrays (all of the minimum x values, then all of the minimum y values, etc.)
+	so that the 4 children are tested at once with SIMD instructions.
+	A child is either another node or a single primitive (the caller's object).
+	The nodes are stored in a single array, and a node's children always come after it.
+
+	Static objects should be added all at once with Build(),
+	which splits them using the surface area heuristic (SAH)
+	so that the fewest boxes have to be tested for a typical query.
+	Moving objects can be updated cheaply with Refit() or UpdatePrimitive(),
+	which enlarge or shrink the boxes without changing the tree,
+	and objects can be added and removed one at a time with InsertPrimitive() and RemovePrimitive().
+	Both of those make queries slower as objects move far from where they were when the tree was built,
+	and so the tree should be rebuilt every once in a while if objects move around a lot.
+*/
+
+#ifndef EAE6320_SCENE_BOUNDINGVOLUMEHIERARCHY_H
+#define EAE6320_SCENE_BOUNDINGVOLUMEHIERARCHY_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Scene
+	{
+		class BoundingVolumeHierarchy
+		{
+		public:
+
+			struct sBox
+			{
+				float minimum[3];
+				float maximum[3];
+			};
+
+			struct sFrustum
+			{
+				// The normal of each plane (x, y, z) points into the frustum, and w is its distance from the origin,
+				// so a point p is inside of the plane if ( dot( normal, p ) + w ) >= 0
+				float planes[6][4];
+			};
+
+			// A ray test is called for every primitive whose box the ray hits (nearest boxes first)
+			// and should return true if the ray hits the primitive itself,
+			// in which case io_distance should be changed to the distance to the hit
+			// (it starts as the distance to the box).
+			// If no ray test is provided the boxes are treated as the primitives.
+			typedef bool ( *fRayTest )( const uint32_t i_primitive, const float i_origin[3], const float i_direction[3],
+				float& io_distance, void* const io_userData );
+
+			static const uint32_t s_noPrimitive = 0xffffffff;
+
+			// Build
+			//------
+
+			// The primitives are numbered in the order of the boxes,
+			// and the previous primitives are removed
+			void Build( const sBox* const i_boxes, const uint32_t i_boxCount );
+
+			// Every primitive's box is replaced with the one at its index in i_boxes
+			// (i_boxes must have at least GetPrimitiveCapacity() boxes, and the ones of removed primitives are ignored)
+			void Refit( const sBox* const i_boxes );
+
+			// Dynamic Primitives
+			//-------------------
+
+			// This returns the new primitive
+			// (which is either the next number or one that has been removed)
+			uint32_t InsertPrimitive( const sBox& i_box );
+			void RemovePrimitive( const uint32_t i_primitive );
+			// The box of every ancestor is updated
+			void UpdatePrimitive( const uint32_t i_primitive, const sBox& i_box );
+
+			// Queries
+			//--------
+
+			// The primitives whose boxes overlap the query replace the contents of o_primitives
+			void QueryBox( const sBox& i_box, std::vector<uint32_t>& o_primitives ) const;
+			void QueryFrustum( const sFrustum& i_frustum, std::vector<uint32_t>& o_primitives ) const;
+			// This finds the nearest primitive that the ray hits within i_maxDistance
+			// (the direction doesn't have to be normalized, and the distance is in multiples of it)
+			// and returns s_noPrimitive if it doesn't hit anything
+			uint32_t Raycast( const float i_origin[3], const float i_direction[3], const float i_maxDistance,
+				float& o_distance, fRayTest i_rayTest = NULL, void* const io_userData = NULL ) const;
+
+			// Access
+			//-------
+
+			// This is one more than the largest primitive number that has been used
+			uint32_t GetPrimitiveCapacity() const { return static_cast<uint32_t>( m_primitiveSlots.size() ); }
+			unsigned int GetNodeCount() const { return static_cast<unsigned int>( m_nodes.size() ); }
+
+			// Benchmark
+			//----------
+
+			// This builds a hierarchy of a million boxes,
+			// refits it, inserts and removes boxes, and queries it,
+			// and logs how long each step took
+			static void LogQueryCost();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			void CleanUp();
+
+			// Implementation
+			//===============
+
+		private:
+
+			// A node is 128 bytes (two cache lines)
+			struct sNode
+			{
+				float minimumX[4], minimumY[4], minimumZ[4];
+				float maximumX[4], maximumY[4], maximumZ[4];
+				// Each child is a node index, a primitive (with s_primitiveBit set), or s_emptySlot
+				uint32_t children[4];
+				// This is the parent's index times 4 plus the child slot that this node is in
+				uint32_t parentSlot;
+				uint32_t padding[3];
+			};
+
+			static const uint32_t s_primitiveBit = 0x80000000;
+			static const uint32_t s_emptySlot = 0xffffffff;
+
+			void SetChild( const uint32_t i_slot, const uint32_t i_child, const sBox& i_box );
+			uint32_t AddNode( const uint32_t i_parentSlot );
+			sBox GetChildBox( const uint32_t i_slot ) const;
+			// This is the box around all of a node's children
+			sBox CalculateNodeBox( const uint32_t i_node ) const;
+			// The node's box in its parent (and its parent's box in the grandparent, etc.) is recalculated from its children
+			void UpdateAncestors( uint32_t i_node );
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<sNode> m_nodes;
+			// This is the slot that each primitive is in (the node index times 4 plus the child index)
+			// or s_emptySlot if the primitive has been removed
+			std::vector<uint32_t> m_primitiveSlots;
+			std::vector<uint32_t> m_freePrimitives;
+		};
+	}
+}
+
+#endif	// EAE6320_SCENE_BOUNDINGVOLUMEHIERARCHY_H
@@ -0,0 +1,19 @@
+/*
+	This file configures the scene
+*/
+
+#ifndef EAE6320_SCENE_CONFIGURATION_H
+#define EAE6320_SCENE_CONFIGURATION_H
+
+// When this is defined a large transform hierarchy is updated at initialization
+// with different fractions of its nodes changing,
+// and how long the updates take is logged
+// (it is only meaningful in an optimized build)
+//#define EAE6320_SCENE_SHOULDTRANSFORMUPDATESBEMEASURED
+
+// When this is defined a bounding volume hierarchy of a million boxes is built, changed, and queried at initialization,
+// and how long each step takes is logged
+// (it is only meaningful in an optimized build)
+//#define EAE6320_SCENE_SHOULDBVHQUERIESBEMEASURED
+
+#endif	// EAE6320_SCENE_CONFIGURATION_H
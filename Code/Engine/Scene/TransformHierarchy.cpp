@@ -0,0 +1,530 @@
+// Header Files
+//=============
+
+#include "TransformHierarchy.h"
+
+#include <algorithm>
+#include <cmath>
+#include "../Asserts/Asserts.h"
+#include "../Jobs/Jobs.h"
+#include "../Logging/Logging.h"
+#include "../Time/Time.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// The nodes are also indexed with this when they don't have a parent
+	const uint32_t s_invalidIndex = eae6320::Scene::TransformHierarchy::s_invalidHandle;
+
+	// If more than this fraction of the nodes have changed
+	// it is faster to look through every node's dirty flag than to sort the changed nodes
+	const unsigned int s_dirtyFractionToScanFor = 16;
+	// Updating fewer nodes than this isn't worth handing to the worker threads
+	const unsigned int s_minNodeCountToSplit = 4 * 1024;
+	// Each worker thread should get a few ranges so that a thread that finishes early can take another one
+	const unsigned int s_rangeCountPerThread = 4;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	// This is a xorshift generator
+	// (the benchmark only needs numbers that are the same every time it runs)
+	uint32_t GetNextRandomNumber( uint32_t& io_state );
+}
+
+// Interface
+//==========
+
+// Update
+//-------
+
+void eae6320::Scene::TransformHierarchy::Update()
+{
+	if ( m_dirtyHandles.empty() )
+	{
+		return;
+	}
+	if ( m_isSortNeeded )
+	{
+		Sort();
+	}
+	FindDirtyRanges();
+	SplitLargeRanges();
+
+	const unsigned int rangeCount = static_cast<unsigned int>( m_dirtyRanges.size() );
+	const unsigned int threadCount = Jobs::GetWorkerThreadCount() + 1;
+	const unsigned int batchSize = std::max( rangeCount / ( threadCount * s_rangeCountPerThread ), 1u );
+	Jobs::ParallelFor( rangeCount, batchSize, UpdateRanges, this );
+	m_dirtyRanges.clear();
+}
+
+// Nodes
+//------
+
+uint32_t eae6320::Scene::TransformHierarchy::CreateNode( const uint32_t i_parent,
+	const Math::sQuaternion& i_rotation, const Math::sVector& i_translation, const float i_scale )
+{
+	const uint32_t parentIndex = ( i_parent != s_invalidHandle ) ? m_indices[i_parent] : s_invalidIndex;
+	EAE6320_ASSERTF( ( i_parent == s_invalidHandle ) || ( parentIndex != s_invalidIndex ), "A node's parent must exist" );
+
+	uint32_t handle;
+	if ( !m_freeHandles.empty() )
+	{
+		handle = m_freeHandles.back();
+		m_freeHandles.pop_back();
+	}
+	else
+	{
+		handle = static_cast<uint32_t>( m_indices.size() );
+		m_indices.push_back( s_invalidIndex );
+	}
+	const uint32_t index = static_cast<uint32_t>( m_handles.size() );
+	m_indices[handle] = index;
+
+	// The new node is added to the end,
+	// which keeps the nodes sorted if it is a root or if its parent's subtree is also at the end
+	// (which is the case when a hierarchy is created depth first)
+	if ( ( parentIndex != s_invalidIndex ) && !m_isSortNeeded )
+	{
+		if ( ( parentIndex + m_subtreeSizes[parentIndex] ) == index )
+		{
+			for ( uint32_t ancestorIndex = parentIndex; ancestorIndex != s_invalidIndex; ancestorIndex = m_parentIndices[ancestorIndex] )
+			{
+				++m_subtreeSizes[ancestorIndex];
+			}
+		}
+		else
+		{
+			m_isSortNeeded = true;
+		}
+	}
+	m_rotations.push_back( i_rotation );
+	m_translations.push_back( i_translation );
+	m_scales.push_back( i_scale );
+	m_worldMatrices.push_back( Math::sMatrix::CreateIdentity() );
+	m_parentIndices.push_back( parentIndex );
+	m_subtreeSizes.push_back( 1 );
+	m_isDirty.push_back( 1 );
+	m_handles.push_back( handle );
+	m_dirtyHandles.push_back( handle );
+
+	return handle;
+}
+
+void eae6320::Scene::TransformHierarchy::DestroyNode( const uint32_t i_node )
+{
+	EAE6320_ASSERT( ( i_node < m_indices.size() ) && ( m_indices[i_node] != s_invalidIndex ) );
+	// The subtree must be contiguous so that it can be erased
+	if ( m_isSortNeeded )
+	{
+		Sort();
+	}
+	const uint32_t begin = m_indices[i_node];
+	const uint32_t subtreeSize = m_subtreeSizes[begin];
+	const uint32_t end = begin + subtreeSize;
+
+	for ( uint32_t ancestorIndex = m_parentIndices[begin]; ancestorIndex != s_invalidIndex; ancestorIndex = m_parentIndices[ancestorIndex] )
+	{
+		m_subtreeSizes[ancestorIndex] -= subtreeSize;
+	}
+	// The destroyed nodes' handles can be reused
+	// (if a destroyed node is still in the dirty list it is skipped because its index is invalid)
+	for ( uint32_t i = begin; i < end; ++i )
+	{
+		m_indices[m_handles[i]] = s_invalidIndex;
+		m_freeHandles.push_back( m_handles[i] );
+	}
+	m_rotations.erase( m_rotations.begin() + begin, m_rotations.begin() + end );
+	m_translations.erase( m_translations.begin() + begin, m_translations.begin() + end );
+	m_scales.erase( m_scales.begin() + begin, m_scales.begin() + end );
+	m_worldMatrices.erase( m_worldMatrices.begin() + begin, m_worldMatrices.begin() + end );
+	m_parentIndices.erase( m_parentIndices.begin() + begin, m_parentIndices.begin() + end );
+	m_subtreeSizes.erase( m_subtreeSizes.begin() + begin, m_subtreeSizes.begin() + end );
+	m_isDirty.erase( m_isDirty.begin() + begin, m_isDirty.begin() + end );
+	m_handles.erase( m_handles.begin() + begin, m_handles.begin() + end );
+	// The nodes after the subtree have moved
+	const uint32_t nodeCount = static_cast<uint32_t>( m_handles.size() );
+	for ( uint32_t i = begin; i < nodeCount; ++i )
+	{
+		m_indices[m_handles[i]] = i;
+		if ( ( m_parentIndices[i] != s_invalidIndex ) && ( m_parentIndices[i] >= end ) )
+		{
+			m_parentIndices[i] -= subtreeSize;
+		}
+	}
+}
+
+// Access
+//-------
+
+void eae6320::Scene::TransformHierarchy::SetLocalTransform( const uint32_t i_node,
+	const Math::sQuaternion& i_rotation, const Math::sVector& i_translation, const float i_scale )
+{
+	EAE6320_ASSERT( ( i_node < m_indices.size() ) && ( m_indices[i_node] != s_invalidIndex ) );
+	const uint32_t index = m_indices[i_node];
+	m_rotations[index] = i_rotation;
+	m_translations[index] = i_translation;
+	m_scales[index] = i_scale;
+	if ( !m_isDirty[index] )
+	{
+		m_isDirty[index] = 1;
+		m_dirtyHandles.push_back( i_node );
+	}
+}
+
+const eae6320::Math::sMatrix& eae6320::Scene::TransformHierarchy::GetWorldMatrix( const uint32_t i_node ) const
+{
+	EAE6320_ASSERT( ( i_node < m_indices.size() ) && ( m_indices[i_node] != s_invalidIndex ) );
+	return m_worldMatrices[m_indices[i_node]];
+}
+
+// Benchmark
+//----------
+
+void eae6320::Scene::TransformHierarchy::LogUpdateCost()
+{
+	const unsigned int nodeCount = 100 * 1000;
+	const unsigned int rootCount = 16;
+	const unsigned int childCount = 4;
+	const unsigned int frameCount = 30;
+	const unsigned int changingPercentages[] = { 1, 10, 100 };
+
+	// Every node after the roots has 4 children,
+	// and they are created breadth first so that the first update has to sort them
+	TransformHierarchy hierarchy;
+	std::vector<uint32_t> handles( nodeCount );
+	for ( unsigned int i = 0; i < nodeCount; ++i )
+	{
+		const uint32_t parent = ( i < rootCount ) ? s_invalidHandle : handles[( i - rootCount ) / childCount];
+		handles[i] = hierarchy.CreateNode( parent, Math::sQuaternion::CreateFromAxisAngle( Math::sVector( 0.0f, 0.0f, 1.0f, 0.0f ), 0.1f ),
+			Math::sVector( 1.0f, 0.0f, 0.0f, 1.0f ), 0.99f );
+	}
+	double secondCount_first;
+	{
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		hierarchy.Update();
+		secondCount_first = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+	}
+	// Recalculating every node on the calling thread is what the incremental update is compared with
+	double secondCount_everyNode;
+	{
+		const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+		for ( unsigned int f = 0; f < frameCount; ++f )
+		{
+			for ( uint32_t i = 0; i < nodeCount; ++i )
+			{
+				hierarchy.UpdateNode( i );
+			}
+		}
+		secondCount_everyNode = Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start ) / frameCount;
+	}
+	Logging::OutputMessage( "Updating a hierarchy of %u transforms on %u worker threads (and the calling thread)"
+		" (sorting and updating it the first time took %.2f ms, and updating every node on one thread takes %.2f ms):",
+		nodeCount, Jobs::GetWorkerThreadCount(), secondCount_first * 1000.0, secondCount_everyNode * 1000.0 );
+
+	uint32_t randomState = 0x9e3779b9u;
+	for ( unsigned int p = 0; p < ( sizeof( changingPercentages ) / sizeof( *changingPercentages ) ); ++p )
+	{
+		const unsigned int changingCount = ( nodeCount * changingPercentages[p] ) / 100;
+		double secondCount_updating = 0.0;
+		for ( unsigned int f = 0; f < frameCount; ++f )
+		{
+			for ( unsigned int i = 0; i < changingCount; ++i )
+			{
+				// Every node is changed at the 100% level, and random ones otherwise
+				const uint32_t node = ( changingCount == nodeCount ) ? handles[i] : handles[GetNextRandomNumber( randomState ) % nodeCount];
+				const float angle = static_cast<float>( GetNextRandomNumber( randomState ) & 0xffff ) / 65536.0f;
+				hierarchy.SetLocalTransform( node, Math::sQuaternion::CreateFromAxisAngle( Math::sVector( 0.0f, 0.0f, 1.0f, 0.0f ), angle ),
+					Math::sVector( 1.0f, 0.0f, 0.0f, 1.0f ), 0.99f );
+			}
+			const uint64_t tickCount_start = Time::GetCurrentSystemTimeTickCount();
+			hierarchy.Update();
+			secondCount_updating += Time::ConvertTicksToSeconds( Time::GetCurrentSystemTimeTickCount() - tickCount_start );
+		}
+		secondCount_updating /= frameCount;
+
+		// The incremental update should give the same results as updating every node
+		float maxDifference = 0.0f;
+		{
+			const std::vector<Math::sMatrix> worldMatrices( hierarchy.m_worldMatrices );
+			for ( uint32_t i = 0; i < nodeCount; ++i )
+			{
+				hierarchy.UpdateNode( i );
+				const float* const expected = &hierarchy.m_worldMatrices[i].columns[0].x;
+				const float* const actual = &worldMatrices[i].columns[0].x;
+				for ( unsigned int j = 0; j < 16; ++j )
+				{
+					const float difference = std::abs( expected[j] - actual[j] );
+					maxDifference = ( difference > maxDifference ) ? difference : maxDifference;
+				}
+			}
+		}
+
+		Logging::OutputMessage( "\t%u%% of the nodes changing: %.3f ms per update, which is %.1fx faster than updating every node on one thread"
+			" (the world matrices differ by at most %g)",
+			changingPercentages[p], secondCount_updating * 1000.0, secondCount_everyNode / secondCount_updating, maxDifference );
+	}
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+void eae6320::Scene::TransformHierarchy::CleanUp()
+{
+	m_rotations.clear();
+	m_translations.clear();
+	m_scales.clear();
+	m_worldMatrices.clear();
+	m_parentIndices.clear();
+	m_subtreeSizes.clear();
+	m_isDirty.clear();
+	m_handles.clear();
+	m_indices.clear();
+	m_freeHandles.clear();
+	m_dirtyHandles.clear();
+	m_dirtyRanges.clear();
+	m_scratch.clear();
+	m_isSortNeeded = false;
+}
+
+// Implementation
+//===============
+
+void eae6320::Scene::TransformHierarchy::Sort()
+{
+	const uint32_t nodeCount = static_cast<uint32_t>( m_handles.size() );
+
+	// Each node's children are grouped together
+	// (the first child of node i is at childrenBegins[i] and the children of node i + 1 start after them)
+	std::vector<uint32_t> childrenBegins( nodeCount + 1, 0 );
+	std::vector<uint32_t> children( nodeCount );
+	std::vector<uint32_t> roots;
+	{
+		for ( uint32_t i = 0; i < nodeCount; ++i )
+		{
+			if ( m_parentIndices[i] != s_invalidIndex )
+			{
+				++childrenBegins[m_parentIndices[i] + 1];
+			}
+			else
+			{
+				roots.push_back( i );
+			}
+		}
+		for ( uint32_t i = 0; i < nodeCount; ++i )
+		{
+			childrenBegins[i + 1] += childrenBegins[i];
+		}
+		std::vector<uint32_t> childCounts( nodeCount, 0 );
+		for ( uint32_t i = 0; i < nodeCount; ++i )
+		{
+			const uint32_t parentIndex = m_parentIndices[i];
+			if ( parentIndex != s_invalidIndex )
+			{
+				children[childrenBegins[parentIndex] + childCounts[parentIndex]++] = i;
+			}
+		}
+	}
+	// The new order is found depth first
+	// (the nodes are pushed in reverse so that siblings stay in the order they were created in)
+	std::vector<uint32_t> oldIndices;
+	std::vector<uint32_t> newIndices( nodeCount );
+	{
+		oldIndices.reserve( nodeCount );
+		std::vector<uint32_t> stack( roots.rbegin(), roots.rend() );
+		while ( !stack.empty() )
+		{
+			const uint32_t oldIndex = stack.back();
+			stack.pop_back();
+			newIndices[oldIndex] = static_cast<uint32_t>( oldIndices.size() );
+			oldIndices.push_back( oldIndex );
+			for ( uint32_t i = childrenBegins[oldIndex + 1]; i > childrenBegins[oldIndex]; --i )
+			{
+				stack.push_back( children[i - 1] );
+			}
+		}
+		EAE6320_ASSERT( oldIndices.size() == nodeCount );
+	}
+	// Every array is reordered
+	{
+		std::vector<Math::sQuaternion> rotations( nodeCount );
+		std::vector<Math::sVector> translations( nodeCount );
+		std::vector<float> scales( nodeCount );
+		std::vector<Math::sMatrix> worldMatrices( nodeCount );
+		std::vector<uint32_t> parentIndices( nodeCount );
+		std::vector<uint8_t> isDirty( nodeCount );
+		std::vector<uint32_t> handles( nodeCount );
+		for ( uint32_t i = 0; i < nodeCount; ++i )
+		{
+			const uint32_t oldIndex = oldIndices[i];
+			rotations[i] = m_rotations[oldIndex];
+			translations[i] = m_translations[oldIndex];
+			scales[i] = m_scales[oldIndex];
+			worldMatrices[i] = m_worldMatrices[oldIndex];
+			const uint32_t oldParentIndex = m_parentIndices[oldIndex];
+			parentIndices[i] = ( oldParentIndex != s_invalidIndex ) ? newIndices[oldParentIndex] : s_invalidIndex;
+			isDirty[i] = m_isDirty[oldIndex];
+			handles[i] = m_handles[oldIndex];
+			m_indices[handles[i]] = i;
+		}
+		m_rotations.swap( rotations );
+		m_translations.swap( translations );
+		m_scales.swap( scales );
+		m_worldMatrices.swap( worldMatrices );
+		m_parentIndices.swap( parentIndices );
+		m_isDirty.swap( isDirty );
+		m_handles.swap( handles );
+	}
+	// Every child comes after its parent,
+	// and so going backwards adds each subtree's size to its parent's before the parent is reached
+	{
+		m_subtreeSizes.assign( nodeCount, 1 );
+		for ( uint32_t i = nodeCount; i > 0; --i )
+		{
+			const uint32_t parentIndex = m_parentIndices[i - 1];
+			if ( parentIndex != s_invalidIndex )
+			{
+				m_subtreeSizes[parentIndex] += m_subtreeSizes[i - 1];
+			}
+		}
+	}
+	m_isSortNeeded = false;
+}
+
+void eae6320::Scene::TransformHierarchy::FindDirtyRanges()
+{
+	EAE6320_ASSERT( !m_isSortNeeded );
+	EAE6320_ASSERT( m_dirtyRanges.empty() );
+	const uint32_t nodeCount = static_cast<uint32_t>( m_handles.size() );
+
+	// A dirty node's whole subtree has to be updated,
+	// and so any dirty nodes inside of it are skipped
+	if ( ( m_dirtyHandles.size() * s_dirtyFractionToScanFor ) > nodeCount )
+	{
+		for ( uint32_t i = 0; i < nodeCount; )
+		{
+			if ( m_isDirty[i] )
+			{
+				const sRange range = { i, i + m_subtreeSizes[i] };
+				m_dirtyRanges.push_back( range );
+				i = range.end;
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+	else
+	{
+		m_scratch.clear();
+		for ( size_t i = 0; i < m_dirtyHandles.size(); ++i )
+		{
+			// Nodes that have been destroyed are skipped
+			const uint32_t index = m_indices[m_dirtyHandles[i]];
+			if ( index != s_invalidIndex )
+			{
+				m_scratch.push_back( index );
+			}
+		}
+		std::sort( m_scratch.begin(), m_scratch.end() );
+		uint32_t end = 0;
+		for ( size_t i = 0; i < m_scratch.size(); ++i )
+		{
+			const uint32_t index = m_scratch[i];
+			if ( index >= end )
+			{
+				const sRange range = { index, index + m_subtreeSizes[index] };
+				m_dirtyRanges.push_back( range );
+				end = range.end;
+			}
+		}
+	}
+	m_dirtyHandles.clear();
+}
+
+void eae6320::Scene::TransformHierarchy::SplitLargeRanges()
+{
+	uint32_t dirtyNodeCount = 0;
+	for ( size_t i = 0; i < m_dirtyRanges.size(); ++i )
+	{
+		dirtyNodeCount += m_dirtyRanges[i].end - m_dirtyRanges[i].begin;
+	}
+	const unsigned int threadCount = Jobs::GetWorkerThreadCount() + 1;
+	if ( ( threadCount == 1 ) || ( dirtyNodeCount < s_minNodeCountToSplit ) )
+	{
+		return;
+	}
+	// A range that is too large is split by updating its root here
+	// and then replacing it with its children's subtrees
+	// (which are re-checked in case they are also too large)
+	const uint32_t maxRangeSize = std::max( dirtyNodeCount / ( threadCount * s_rangeCountPerThread ), 1u );
+	for ( size_t i = 0; i < m_dirtyRanges.size(); )
+	{
+		const sRange range = m_dirtyRanges[i];
+		if ( ( range.end - range.begin ) > maxRangeSize )
+		{
+			UpdateNode( range.begin );
+			const uint32_t firstChild = range.begin + 1;
+			const sRange firstChildRange = { firstChild, firstChild + m_subtreeSizes[firstChild] };
+			m_dirtyRanges[i] = firstChildRange;
+			for ( uint32_t child = firstChildRange.end; child < range.end; child += m_subtreeSizes[child] )
+			{
+				const sRange childRange = { child, child + m_subtreeSizes[child] };
+				m_dirtyRanges.push_back( childRange );
+			}
+		}
+		else
+		{
+			++i;
+		}
+	}
+}
+
+void eae6320::Scene::TransformHierarchy::UpdateNode( const uint32_t i_index )
+{
+	// The local matrix is scaled and rotated and then translated
+	Math::sMatrix localMatrix = Math::sMatrix::CreateTransform( m_rotations[i_index], m_translations[i_index] );
+	const float scale = m_scales[i_index];
+	for ( unsigned int i = 0; i < 3; ++i )
+	{
+		localMatrix.columns[i] *= scale;
+	}
+	const uint32_t parentIndex = m_parentIndices[i_index];
+	m_worldMatrices[i_index] = ( parentIndex != s_invalidIndex ) ? ( m_worldMatrices[parentIndex] * localMatrix ) : localMatrix;
+	m_isDirty[i_index] = 0;
+}
+
+void eae6320::Scene::TransformHierarchy::UpdateRanges( const unsigned int i_begin, const unsigned int i_end, void* const io_userData )
+{
+	// Each range is a subtree whose root's parent has already been updated,
+	// and going through a subtree in order updates every parent before its children
+	TransformHierarchy& hierarchy = *reinterpret_cast<TransformHierarchy*>( io_userData );
+	for ( unsigned int r = i_begin; r < i_end; ++r )
+	{
+		const sRange range = hierarchy.m_dirtyRanges[r];
+		for ( uint32_t i = range.begin; i < range.end; ++i )
+		{
+			hierarchy.UpdateNode( i );
+		}
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	uint32_t GetNextRandomNumber( uint32_t& io_state )
+	{
+		io_state ^= io_state << 13;
+		io_state ^= io_state >> 17;
+		io_state ^= io_state << 5;
+		return io_state;
+	}
+}
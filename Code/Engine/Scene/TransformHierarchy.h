@@ -0,0 +1,134 @@
+/*
+	A transform hierarchy stores the transforms of every object in a scene
+	and calculates each object's local-to-world matrix from its parent's
+
+	The transforms are stored as separate arrays (rotations, translations, scales, world matrices, etc.)
+	that are sorted depth first,
+	which means that every node's parent comes before it
+	and that every subtree is a contiguous range of nodes.
+	Objects refer to nodes with handles that stay the same when the nodes are re-sorted.
+
+	Only nodes whose local transforms have changed (and their descendants) are updated:
+	The changed subtrees don't depend on each other,
+	and so they are split into ranges that are updated on the worker threads.
+*/
+
+#ifndef EAE6320_SCENE_TRANSFORMHIERARCHY_H
+#define EAE6320_SCENE_TRANSFORMHIERARCHY_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+#include <vector>
+#include "../Math/sMatrix.h"
+#include "../Math/sQuaternion.h"
+#include "../Math/sVector.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace Scene
+	{
+		class TransformHierarchy
+		{
+		public:
+
+			// Root nodes use this as their parent
+			static const uint32_t s_invalidHandle = 0xffffffff;
+
+			// Update
+			//-------
+
+			// This calculates the world matrices of every node that has changed since the previous update
+			// (and of all of their descendants)
+			void Update();
+
+			// Nodes
+			//------
+
+			// The parent must already exist.
+			// The node's world matrix is valid after the next update.
+			uint32_t CreateNode( const uint32_t i_parent,
+				const Math::sQuaternion& i_rotation, const Math::sVector& i_translation, const float i_scale = 1.0f );
+			// The node's descendants are destroyed with it
+			void DestroyNode( const uint32_t i_node );
+
+			// Access
+			//-------
+
+			// The local transform is relative to the node's parent
+			// (the rotation and scale are applied first and then the translation)
+			void SetLocalTransform( const uint32_t i_node,
+				const Math::sQuaternion& i_rotation, const Math::sVector& i_translation, const float i_scale = 1.0f );
+			// This is the matrix from the previous update
+			const Math::sMatrix& GetWorldMatrix( const uint32_t i_node ) const;
+
+			unsigned int GetNodeCount() const { return static_cast<unsigned int>( m_handles.size() ); }
+
+			// Benchmark
+			//----------
+
+			// This updates a large hierarchy with different fractions of its nodes changing every frame
+			// and logs how long it takes
+			static void LogUpdateCost();
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			void CleanUp();
+
+			// Implementation
+			//===============
+
+		private:
+
+			struct sRange
+			{
+				uint32_t begin, end;
+			};
+
+			// The nodes are only re-sorted before an update
+			// (rather than every time a node is created or destroyed)
+			void Sort();
+			void FindDirtyRanges();
+			void SplitLargeRanges();
+			void UpdateNode( const uint32_t i_index );
+			static void UpdateRanges( const unsigned int i_begin, const unsigned int i_end, void* const io_userData );
+
+			// Data
+			//=====
+
+		private:
+
+			// These are indexed by node
+			// (the order changes when the nodes are sorted)
+			std::vector<Math::sQuaternion> m_rotations;
+			std::vector<Math::sVector> m_translations;
+			std::vector<float> m_scales;
+			std::vector<Math::sMatrix> m_worldMatrices;
+			std::vector<uint32_t> m_parentIndices;
+			// A node's subtree is the range [index, index + subtree size)
+			std::vector<uint32_t> m_subtreeSizes;
+			std::vector<uint8_t> m_isDirty;
+			std::vector<uint32_t> m_handles;
+
+			// These are indexed by handle
+			std::vector<uint32_t> m_indices;
+			std::vector<uint32_t> m_freeHandles;
+
+			// Nodes that have changed since the previous update
+			// (these are handles rather than indices so that they stay valid when the nodes are sorted)
+			std::vector<uint32_t> m_dirtyHandles;
+			// These are kept from update to update so that updating doesn't allocate
+			std::vector<sRange> m_dirtyRanges;
+			std::vector<sRange> m_splitRanges;
+			std::vector<uint32_t> m_scratch;
+			bool m_isSortNeeded = false;
+		};
+	}
+}
+
+#endif	// EAE6320_SCENE_TRANSFORMHIERARCHY_H
@@ -5,6 +5,11 @@
 #ifndef EAE6320_TIME_H
 #define EAE6320_TIME_H
 
+// Header Files
+//=============
+
+#include <cstdint>
+
 // Interface
 //==========
 
@@ -20,6 +25,26 @@ namespace eae6320
 
 		void OnNewFrame();
 
+		// Ticks
+		//------
+
+		// These can be used to measure durations that are shorter than a frame
+		// (e.g. how long a single system takes to update)
+		uint64_t GetCurrentSystemTimeTickCount();
+		// This is the system tick count when OnNewFrame() was last called
+		// (the CPU time that the current frame has taken so far is the current tick count minus this)
+		uint64_t GetFrameStartSystemTimeTickCount();
+		double ConvertTicksToSeconds( const uint64_t i_tickCount );
+		uint64_t ConvertSecondsToTicks( const double i_secondCount );
+
+		// Waiting
+		//--------
+
+		// This returns as soon after the given tick count as possible:
+		// It sleeps while there is enough time left for the OS scheduler to wake the thread up late
+		// and then spins for the rest
+		void WaitUntil( const uint64_t i_tickCount );
+
 		// Initialization / Clean Up
 		//--------------------------
 
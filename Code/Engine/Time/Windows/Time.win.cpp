@@ -8,6 +8,8 @@
 #include "../../Windows/Includes.h"
 #include "../../Windows/Functions.h"
 
+#include <mmsystem.h>
+
 // Static Data Initialization
 //===========================
 
@@ -19,6 +21,13 @@ namespace
 	LARGE_INTEGER s_totalTicksElapsed_atInitializion = { 0 };
 	LARGE_INTEGER s_totalTicksElapsed_duringRun = { 0 };
 	LARGE_INTEGER s_totalTicksElapsed_previousFrame = { 0 };
+
+	// By default Windows only wakes sleeping threads every ~15 ms;
+	// while time is initialized the period is shortened to this
+	const UINT s_timerPeriodInMilliseconds = 1;
+	bool s_wasTimerPeriodChanged = false;
+	// When less than this is left to wait a sleep could wake up too late, and so WaitUntil() spins instead
+	const double s_spinSecondCount = 0.002;
 }
 
 // Helper Function Declarations
@@ -66,6 +75,57 @@ void eae6320::Time::OnNewFrame()
 	}
 }
 
+// Ticks
+//------
+
+uint64_t eae6320::Time::GetCurrentSystemTimeTickCount()
+{
+	LARGE_INTEGER totalCountsElapsed;
+	const BOOL result = QueryPerformanceCounter( &totalCountsElapsed );
+	EAE6320_ASSERTF( result != FALSE, "QueryPerformanceCounter() failed" );
+	return static_cast<uint64_t>( totalCountsElapsed.QuadPart );
+}
+
+uint64_t eae6320::Time::GetFrameStartSystemTimeTickCount()
+{
+	InitializeIfNecessary();
+	return static_cast<uint64_t>( s_totalTicksElapsed_atInitializion.QuadPart + s_totalTicksElapsed_duringRun.QuadPart );
+}
+
+double eae6320::Time::ConvertTicksToSeconds( const uint64_t i_tickCount )
+{
+	InitializeIfNecessary();
+	return static_cast<double>( i_tickCount ) * s_secondsPerTick;
+}
+
+uint64_t eae6320::Time::ConvertSecondsToTicks( const double i_secondCount )
+{
+	InitializeIfNecessary();
+	return static_cast<uint64_t>( ( i_secondCount / s_secondsPerTick ) + 0.5 );
+}
+
+// Waiting
+//--------
+
+void eae6320::Time::WaitUntil( const uint64_t i_tickCount )
+{
+	InitializeIfNecessary();
+	const uint64_t spinTickCount = ConvertSecondsToTicks( s_spinSecondCount );
+	uint64_t tickCount_current = GetCurrentSystemTimeTickCount();
+	// Sleep
+	while ( ( tickCount_current < i_tickCount ) && ( ( i_tickCount - tickCount_current ) > spinTickCount ) )
+	{
+		Sleep( s_timerPeriodInMilliseconds );
+		tickCount_current = GetCurrentSystemTimeTickCount();
+	}
+	// Spin
+	while ( tickCount_current < i_tickCount )
+	{
+		YieldProcessor();
+		tickCount_current = GetCurrentSystemTimeTickCount();
+	}
+}
+
 // Initialization / Clean Up
 //--------------------------
 
@@ -111,6 +171,17 @@ bool eae6320::Time::Initialize()
 			goto OnExit;
 		}
 
+		// Make sleeping accurate enough for WaitUntil()
+		// (this isn't an error because the waits will still finish on time by spinning longer)
+		if ( timeBeginPeriod( s_timerPeriodInMilliseconds ) == TIMERR_NOERROR )
+		{
+			s_wasTimerPeriodChanged = true;
+		}
+		else
+		{
+			Logging::OutputMessage( "Windows couldn't change the timer period to %u ms", s_timerPeriodInMilliseconds );
+		}
+
 		Logging::OutputMessage( "Initialized time" );
 		s_isInitialized = true;
 	}
@@ -127,6 +198,11 @@ OnExit:
 
 bool eae6320::Time::CleanUp()
 {
+	if ( s_wasTimerPeriodChanged )
+	{
+		timeEndPeriod( s_timerPeriodInMilliseconds );
+		s_wasTimerPeriodChanged = false;
+	}
 	return true;
 }
 
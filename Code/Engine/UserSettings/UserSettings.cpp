@@ -18,6 +18,11 @@ namespace
 {
 	unsigned int s_resolutionHeight = 512;
 	unsigned int s_resolutionWidth = 512;
+	unsigned int s_textureBudgetInMegabytes = 64;
+	unsigned int s_targetFrameRate = 60;
+	float s_minResolutionScale = 0.5f;
+	std::string s_presentMode = "vsync";
+	unsigned int s_statisticsLogPeriodInFrames = 0;
 
 	const char* const s_userSettingsFileName = "settings.ini";
 }
@@ -48,6 +53,36 @@ unsigned int eae6320::UserSettings::GetResolutionWidth()
 	return s_resolutionWidth;
 }
 
+unsigned int eae6320::UserSettings::GetTextureBudgetInMegabytes()
+{
+	InitializeIfNecessary();
+	return s_textureBudgetInMegabytes;
+}
+
+unsigned int eae6320::UserSettings::GetTargetFrameRate()
+{
+	InitializeIfNecessary();
+	return s_targetFrameRate;
+}
+
+float eae6320::UserSettings::GetMinResolutionScale()
+{
+	InitializeIfNecessary();
+	return s_minResolutionScale;
+}
+
+const char* eae6320::UserSettings::GetPresentMode()
+{
+	InitializeIfNecessary();
+	return s_presentMode.c_str();
+}
+
+unsigned int eae6320::UserSettings::GetStatisticsLogPeriodInFrames()
+{
+	InitializeIfNecessary();
+	return s_statisticsLogPeriodInFrames;
+}
+
 // Helper Function Definitions
 //============================
 
@@ -275,6 +310,121 @@ namespace
 			}
 			lua_pop(&io_luaState, 1);
 		}
+		// Texture Budget
+		{
+			const char* key_textureBudget = "textureBudgetInMegabytes";
+
+			lua_pushstring(&io_luaState, key_textureBudget);
+			lua_gettable(&io_luaState, -2);
+			if (lua_isnumber(&io_luaState, -1))
+			{
+				lua_Number floatingPointResult = lua_tonumber(&io_luaState, -1);
+				if (IsNumberAnInteger(floatingPointResult))
+				{
+					if (floatingPointResult >= lua_Number(0))
+					{
+						s_textureBudgetInMegabytes = static_cast<unsigned int>(floatingPointResult + 0.5f);
+						eae6320::Logging::OutputMessage("The user settings file ran the game with a texture budget of %u MB.",
+							s_textureBudgetInMegabytes);
+					}
+					else
+					{
+						eae6320::Logging::OutputError("The user settings file %s specifies a negative texture budget of %f. Using default %u instead",
+							s_userSettingsFileName, floatingPointResult, s_textureBudgetInMegabytes);
+					}
+				}
+			}
+			lua_pop(&io_luaState, 1);
+		}
+		// Target Frame Rate
+		{
+			const char* key_targetFrameRate = "targetFrameRate";
+
+			lua_pushstring(&io_luaState, key_targetFrameRate);
+			lua_gettable(&io_luaState, -2);
+			if (lua_isnumber(&io_luaState, -1))
+			{
+				lua_Number floatingPointResult = lua_tonumber(&io_luaState, -1);
+				if (IsNumberAnInteger(floatingPointResult))
+				{
+					if (floatingPointResult > lua_Number(0))
+					{
+						s_targetFrameRate = static_cast<unsigned int>(floatingPointResult + 0.5f);
+						eae6320::Logging::OutputMessage("The user settings file ran the game with a target frame rate of %u.",
+							s_targetFrameRate);
+					}
+					else
+					{
+						eae6320::Logging::OutputError("The user settings file %s specifies a target frame rate of %f that isn't positive. Using default %u instead",
+							s_userSettingsFileName, floatingPointResult, s_targetFrameRate);
+					}
+				}
+			}
+			lua_pop(&io_luaState, 1);
+		}
+		// Minimum Resolution Scale
+		{
+			const char* key_minResolutionScale = "minResolutionScale";
+
+			lua_pushstring(&io_luaState, key_minResolutionScale);
+			lua_gettable(&io_luaState, -2);
+			if (lua_isnumber(&io_luaState, -1))
+			{
+				lua_Number floatingPointResult = lua_tonumber(&io_luaState, -1);
+				if ((floatingPointResult > lua_Number(0)) && (floatingPointResult <= lua_Number(1)))
+				{
+					s_minResolutionScale = static_cast<float>(floatingPointResult);
+					eae6320::Logging::OutputMessage("The user settings file ran the game with a minimum resolution scale of %.2f.",
+						s_minResolutionScale);
+				}
+				else
+				{
+					eae6320::Logging::OutputError("The user settings file %s specifies a minimum resolution scale of %f that isn't in (0,1]. Using default %.2f instead",
+						s_userSettingsFileName, floatingPointResult, s_minResolutionScale);
+				}
+			}
+			lua_pop(&io_luaState, 1);
+		}
+		// Present Mode
+		{
+			const char* key_presentMode = "presentMode";
+
+			lua_pushstring(&io_luaState, key_presentMode);
+			lua_gettable(&io_luaState, -2);
+			if (lua_type(&io_luaState, -1) == LUA_TSTRING)
+			{
+				s_presentMode = lua_tostring(&io_luaState, -1);
+				eae6320::Logging::OutputMessage("The user settings file ran the game with the \"%s\" present mode.",
+					s_presentMode.c_str());
+			}
+			lua_pop(&io_luaState, 1);
+		}
+		// Statistics Log Period
+		{
+			const char* key_statisticsLogPeriodInFrames = "statisticsLogPeriodInFrames";
+
+			lua_pushstring(&io_luaState, key_statisticsLogPeriodInFrames);
+			lua_gettable(&io_luaState, -2);
+			if (lua_isnumber(&io_luaState, -1))
+			{
+				lua_Number floatingPointResult = lua_tonumber(&io_luaState, -1);
+				if (IsNumberAnInteger(floatingPointResult))
+				{
+					if (floatingPointResult >= lua_Number(0))
+					{
+						s_statisticsLogPeriodInFrames = static_cast<unsigned int>(floatingPointResult + 0.5f);
+						eae6320::Logging::OutputMessage("The user settings file ran the game with a statistics log period of %u frames.",
+							s_statisticsLogPeriodInFrames);
+					}
+					else
+					{
+						eae6320::Logging::OutputError("The user settings file %s specifies a negative statistics log period of %f. Using default %u instead",
+							s_userSettingsFileName, floatingPointResult, s_statisticsLogPeriodInFrames);
+					}
+				}
+			}
+			lua_pop(&io_luaState, 1);
+		}
 
 		return true;
 	}
@@ -15,6 +15,20 @@ namespace eae6320
 	{
 		unsigned int GetResolutionHeight();
 		unsigned int GetResolutionWidth();
+		// How much memory streamed textures may use
+		unsigned int GetTextureBudgetInMegabytes();
+		// Dynamic resolution tries to keep every frame shorter than one frame at this rate
+		// (and the "targetFrameRate" present mode never renders frames faster than this)
+		unsigned int GetTargetFrameRate();
+		// The scene is never rendered at less than this fraction of the resolution
+		// (if it is 1 the resolution is never scaled)
+		float GetMinResolutionScale();
+		// How frames are paced and presented
+		// ("uncapped", "vsync", "targetFrameRate", or "lowLatency")
+		const char* GetPresentMode();
+		// If graphics statistics are tracked they are logged every time this many frames have been rendered
+		// (if it is 0 they are only logged when the game exits)
+		unsigned int GetStatisticsLogPeriodInFrames();
 	}
 }
 
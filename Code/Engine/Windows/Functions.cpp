@@ -744,6 +744,159 @@ OnExit:
 	return !wereThereErrors;
 }
 
+bool eae6320::Windows::MapBinaryFile( const char* const i_path, sMappedFile& o_file, std::string* const o_errorMessage )
+{
+	bool wereThereErrors = false;
+
+	// Open the file
+	{
+		const DWORD desiredAccess = FILE_GENERIC_READ;
+		const DWORD otherProgramsCanStillReadTheFile = FILE_SHARE_READ;
+		SECURITY_ATTRIBUTES* useDefaultSecurity = NULL;
+		const DWORD onlySucceedIfFileExists = OPEN_EXISTING;
+		// The file will be read from start to finish
+		const DWORD attributes = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+		const HANDLE dontUseTemplateFile = NULL;
+		o_file.fileHandle = CreateFile( i_path, desiredAccess, otherProgramsCanStillReadTheFile,
+			useDefaultSecurity, onlySucceedIfFileExists, attributes, dontUseTemplateFile );
+		if ( o_file.fileHandle == INVALID_HANDLE_VALUE )
+		{
+			wereThereErrors = true;
+			if ( o_errorMessage )
+			{
+				const std::string windowsError = eae6320::Windows::GetLastSystemError();
+				std::ostringstream errorMessage;
+				errorMessage << "Windows failed to open the file \"" << i_path << "\" for mapping: " << windowsError;
+				*o_errorMessage = errorMessage.str();
+			}
+			goto OnExit;
+		}
+	}
+	// Get the file's size
+	{
+		LARGE_INTEGER fileSize_integer;
+		if ( GetFileSizeEx( o_file.fileHandle, &fileSize_integer ) != FALSE )
+		{
+			EAE6320_ASSERT( fileSize_integer.QuadPart <= SIZE_MAX );
+			o_file.size = static_cast<size_t>( fileSize_integer.QuadPart );
+		}
+		else
+		{
+			wereThereErrors = true;
+			if ( o_errorMessage )
+			{
+				const std::string windowsError = eae6320::Windows::GetLastSystemError();
+				std::ostringstream errorMessage;
+				errorMessage << "Windows failed to get the size of the file \"" << i_path << "\": " << windowsError;
+				*o_errorMessage = errorMessage.str();
+			}
+			goto OnExit;
+		}
+		// An empty file can't be mapped
+		if ( o_file.size == 0 )
+		{
+			wereThereErrors = true;
+			if ( o_errorMessage )
+			{
+				std::ostringstream errorMessage;
+				errorMessage << "The file \"" << i_path << "\" can't be mapped because it is empty";
+				*o_errorMessage = errorMessage.str();
+			}
+			goto OnExit;
+		}
+	}
+	// Map the file's contents into the address space
+	{
+		SECURITY_ATTRIBUTES* useDefaultSecurity = NULL;
+		const DWORD mapTheEntireFile = 0;
+		const char* const noName = NULL;
+		o_file.mappingHandle = CreateFileMapping( o_file.fileHandle, useDefaultSecurity, PAGE_READONLY,
+			mapTheEntireFile, mapTheEntireFile, noName );
+		if ( o_file.mappingHandle == NULL )
+		{
+			wereThereErrors = true;
+			if ( o_errorMessage )
+			{
+				const std::string windowsError = eae6320::Windows::GetLastSystemError();
+				std::ostringstream errorMessage;
+				errorMessage << "Windows failed to create a file mapping for \"" << i_path << "\": " << windowsError;
+				*o_errorMessage = errorMessage.str();
+			}
+			goto OnExit;
+		}
+		const DWORD offsetHigh = 0;
+		const DWORD offsetLow = 0;
+		const SIZE_T mapTheEntireView = 0;
+		o_file.data = MapViewOfFile( o_file.mappingHandle, FILE_MAP_READ, offsetHigh, offsetLow, mapTheEntireView );
+		if ( o_file.data == NULL )
+		{
+			wereThereErrors = true;
+			if ( o_errorMessage )
+			{
+				const std::string windowsError = eae6320::Windows::GetLastSystemError();
+				std::ostringstream errorMessage;
+				errorMessage << "Windows failed to map a view of the file \"" << i_path << "\": " << windowsError;
+				*o_errorMessage = errorMessage.str();
+			}
+			goto OnExit;
+		}
+	}
+
+OnExit:
+
+	if ( wereThereErrors )
+	{
+		UnmapBinaryFile( o_file );
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::Windows::UnmapBinaryFile( sMappedFile& io_file, std::string* const o_errorMessage )
+{
+	bool wereThereErrors = false;
+
+	if ( io_file.data )
+	{
+		if ( UnmapViewOfFile( io_file.data ) == FALSE )
+		{
+			wereThereErrors = true;
+			if ( o_errorMessage )
+			{
+				*o_errorMessage = "Windows failed to unmap a view of a file: " + eae6320::Windows::GetLastSystemError();
+			}
+		}
+		io_file.data = NULL;
+	}
+	if ( io_file.mappingHandle != NULL )
+	{
+		if ( CloseHandle( io_file.mappingHandle ) == FALSE )
+		{
+			if ( !wereThereErrors && o_errorMessage )
+			{
+				*o_errorMessage = "Windows failed to close a file mapping handle: " + eae6320::Windows::GetLastSystemError();
+			}
+			wereThereErrors = true;
+		}
+		io_file.mappingHandle = NULL;
+	}
+	if ( io_file.fileHandle != INVALID_HANDLE_VALUE )
+	{
+		if ( CloseHandle( io_file.fileHandle ) == FALSE )
+		{
+			if ( !wereThereErrors && o_errorMessage )
+			{
+				*o_errorMessage = "Windows failed to close a mapped file handle: " + eae6320::Windows::GetLastSystemError();
+			}
+			wereThereErrors = true;
+		}
+		io_file.fileHandle = INVALID_HANDLE_VALUE;
+	}
+	io_file.size = 0;
+
+	return !wereThereErrors;
+}
+
 bool eae6320::Windows::WriteBinaryFile( const char* const i_path, const void* const i_data, const size_t i_size, std::string* const o_errorMessage )
 {
 	bool wereThereErrors = false;
@@ -38,6 +38,18 @@ namespace eae6320
 			sDataFromFile() : data( NULL ), size( 0 ) {}
 		};
 
+		// A mapped file is read directly from the operating system's file cache
+		// (the data is read-only and is valid until UnmapBinaryFile() is called)
+		struct sMappedFile
+		{
+			const void* data;
+			size_t size;
+			HANDLE fileHandle;
+			HANDLE mappingHandle;
+
+			sMappedFile() : data( NULL ), size( 0 ), fileHandle( INVALID_HANDLE_VALUE ), mappingHandle( NULL ) {}
+		};
+
 		bool CopyFile( const char* const i_path_source, const char* i_path_target,
 			const bool i_shouldFunctionFailIfTargetAlreadyExists = false, const bool i_shouldTargetFileTimeBeModified = false,
 			std::string* o_errorMessage = NULL );
@@ -52,6 +64,8 @@ namespace eae6320
 		bool GetLastWriteTime( const char* const i_path, uint64_t& o_lastWriteTime, std::string* const o_errorMessage = NULL );
 		bool InvalidateLastWriteTime( const char* const i_path, std::string* const o_errorMessage = NULL );
 		bool LoadBinaryFile( const char* const i_path, sDataFromFile& o_data, std::string* const o_errorMessage = NULL );
+		bool MapBinaryFile( const char* const i_path, sMappedFile& o_file, std::string* const o_errorMessage = NULL );
+		bool UnmapBinaryFile( sMappedFile& io_file, std::string* const o_errorMessage = NULL );
 		bool WriteBinaryFile( const char* const i_path, const void* const i_data, const size_t i_size, std::string* const o_errorMessage = NULL );
 	}
 }
@@ -29,27 +29,49 @@ extern PFNGLACTIVETEXTUREPROC glActiveTexture;
 extern PFNGLATTACHSHADERPROC glAttachShader;
 extern PFNGLBINDBUFFERPROC glBindBuffer;
 extern PFNGLBINDBUFFERBASEPROC glBindBufferBase;
+extern PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer;
 extern PFNGLBINDVERTEXARRAYPROC glBindVertexArray;
 extern PFNGLBUFFERDATAPROC glBufferData;
+// ARB_buffer_storage isn't required, and so this is NULL if the driver doesn't support it
+extern PFNGLBUFFERSTORAGEPROC glBufferStorage;
 extern PFNGLBUFFERSUBDATAPROC glBufferSubData;
+extern PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus;
+extern PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
 extern PFNGLCOMPILESHADERPROC glCompileShader;
 extern PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
+extern PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC glCompressedTexSubImage2D;
+extern PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData;
 extern PFNGLCREATEPROGRAMPROC glCreateProgram;
 extern PFNGLCREATESHADERPROC glCreateShader;
+// KHR_debug isn't required, and so these are NULL if the driver doesn't support it
+extern PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback;
+extern PFNGLDEBUGMESSAGECONTROLPROC glDebugMessageControl;
 extern PFNGLDELETEBUFFERSPROC glDeleteBuffers;
+extern PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers;
 extern PFNGLDELETEPROGRAMPROC glDeleteProgram;
+extern PFNGLDELETEQUERIESPROC glDeleteQueries;
 extern PFNGLDELETESHADERPROC glDeleteShader;
+extern PFNGLDELETESYNCPROC glDeleteSync;
 extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays;
 extern PFNGLENABLEVERTEXATTRIBARRAYARBPROC glEnableVertexAttribArray;
+extern PFNGLFENCESYNCPROC glFenceSync;
+extern PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D;
 extern PFNGLGENBUFFERSPROC glGenBuffers;
+extern PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers;
+extern PFNGLGENQUERIESPROC glGenQueries;
 extern PFNGLGENVERTEXARRAYSPROC glGenVertexArrays;
 extern PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog;
 extern PFNGLGETPROGRAMIVPROC glGetProgramiv;
+extern PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv;
+extern PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
 extern PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog;
 extern PFNGLGETSHADERIVPROC glGetShaderiv;
 extern PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
 extern PFNGLLINKPROGRAMPROC glLinkProgram;
+extern PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+extern PFNGLQUERYCOUNTERPROC glQueryCounter;
 extern PFNGLSHADERSOURCEPROC glShaderSource;
+extern PFNGLTEXBUFFERPROC glTexBuffer;
 extern PFNGLUNIFORM1FVPROC glUniform1fv;
 extern PFNGLUNIFORM1IPROC glUniform1i;
 extern PFNGLUNIFORM2FVPROC glUniform2fv;
@@ -57,11 +79,13 @@ extern PFNGLUNIFORM3FVPROC glUniform3fv;
 extern PFNGLUNIFORM4FVPROC glUniform4fv;
 extern PFNGLUNIFORMBLOCKBINDINGPROC glUniformBlockBinding;
 extern PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv;
+extern PFNGLUNMAPBUFFERPROC glUnmapBuffer;
 extern PFNGLUSEPROGRAMPROC glUseProgram;
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer;
 #if defined( EAE6320_PLATFORM_WINDOWS )
 	extern PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB;
 	extern PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB;
+	extern PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT;
 #endif
 
 // Initialization
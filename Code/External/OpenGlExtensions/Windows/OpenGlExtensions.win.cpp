@@ -14,6 +14,8 @@
 namespace
 {
 	void* GetGlFunctionAddress( const char* i_functionName, std::string* o_errorMessage = NULL );
+	// This doesn't assert or look in the non-extension functions
+	void* GetOptionalGlFunctionAddress( const char* i_functionName );
 }
 
 // Interface
@@ -26,27 +28,48 @@ PFNGLACTIVETEXTUREPROC glActiveTexture = NULL;
 PFNGLATTACHSHADERPROC glAttachShader = NULL;
 PFNGLBINDBUFFERPROC glBindBuffer = NULL;
 PFNGLBINDBUFFERBASEPROC glBindBufferBase = NULL;
+PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer = NULL;
 PFNGLBINDVERTEXARRAYPROC glBindVertexArray = NULL;
 PFNGLBUFFERDATAPROC glBufferData = NULL;
+PFNGLBUFFERSTORAGEPROC glBufferStorage = NULL;
 PFNGLBUFFERSUBDATAPROC glBufferSubData = NULL;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus = NULL;
+PFNGLCLIENTWAITSYNCPROC glClientWaitSync = NULL;
 PFNGLCOMPILESHADERPROC glCompileShader = NULL;
 PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D = NULL;
+PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC glCompressedTexSubImage2D = NULL;
+PFNGLCOPYBUFFERSUBDATAPROC glCopyBufferSubData = NULL;
 PFNGLCREATEPROGRAMPROC glCreateProgram = NULL;
 PFNGLCREATESHADERPROC glCreateShader = NULL;
+PFNGLDEBUGMESSAGECALLBACKPROC glDebugMessageCallback = NULL;
+PFNGLDEBUGMESSAGECONTROLPROC glDebugMessageControl = NULL;
 PFNGLDELETEBUFFERSPROC glDeleteBuffers = NULL;
+PFNGLDELETEFRAMEBUFFERSPROC glDeleteFramebuffers = NULL;
 PFNGLDELETEPROGRAMPROC glDeleteProgram = NULL;
+PFNGLDELETEQUERIESPROC glDeleteQueries = NULL;
 PFNGLDELETESHADERPROC glDeleteShader = NULL;
+PFNGLDELETESYNCPROC glDeleteSync = NULL;
 PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArrays = NULL;
 PFNGLENABLEVERTEXATTRIBARRAYARBPROC glEnableVertexAttribArray = NULL;
+PFNGLFENCESYNCPROC glFenceSync = NULL;
+PFNGLFRAMEBUFFERTEXTURE2DPROC glFramebufferTexture2D = NULL;
 PFNGLGENBUFFERSPROC glGenBuffers = NULL;
+PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers = NULL;
+PFNGLGENQUERIESPROC glGenQueries = NULL;
 PFNGLGENVERTEXARRAYSPROC glGenVertexArrays = NULL;
 PFNGLGETPROGRAMINFOLOGPROC glGetProgramInfoLog = NULL;
 PFNGLGETPROGRAMIVPROC glGetProgramiv = NULL;
+PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv = NULL;
+PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v = NULL;
 PFNGLGETSHADERINFOLOGPROC glGetShaderInfoLog = NULL;
 PFNGLGETSHADERIVPROC glGetShaderiv = NULL;
 PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation = NULL;
 PFNGLLINKPROGRAMPROC glLinkProgram = NULL;
+PFNGLMAPBUFFERRANGEPROC glMapBufferRange = NULL;
+PFNGLQUERYCOUNTERPROC glQueryCounter = NULL;
 PFNGLSHADERSOURCEPROC glShaderSource = NULL;
+PFNGLTEXBUFFERPROC glTexBuffer = NULL;
+PFNGLUNMAPBUFFERPROC glUnmapBuffer = NULL;
 PFNGLUSEPROGRAMPROC glUseProgram = NULL;
 PFNGLUNIFORM1FVPROC glUniform1fv = NULL;
 PFNGLUNIFORM1IPROC glUniform1i = NULL;
@@ -58,6 +81,7 @@ PFNGLUNIFORMMATRIX4FVPROC glUniformMatrix4fv = NULL;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointer = NULL;
 PFNWGLCHOOSEPIXELFORMATARBPROC wglChoosePixelFormatARB = NULL;
 PFNWGLCREATECONTEXTATTRIBSARBPROC wglCreateContextAttribsARB = NULL;
+PFNWGLSWAPINTERVALEXTPROC wglSwapIntervalEXT = NULL;
 
 // Initialization
 //---------------
@@ -95,27 +119,44 @@ bool eae6320::OpenGlExtensions::Load( std::string* o_errorMessage )
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glAttachShader, PFNGLATTACHSHADERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glBindBuffer, PFNGLBINDBUFFERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glBindBufferBase, PFNGLBINDBUFFERBASEPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glBindFramebuffer, PFNGLBINDFRAMEBUFFERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glBindVertexArray, PFNGLBINDVERTEXARRAYPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glBufferData, PFNGLBUFFERDATAPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glBufferSubData, PFNGLBUFFERSUBDATAPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glCheckFramebufferStatus, PFNGLCHECKFRAMEBUFFERSTATUSPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glClientWaitSync, PFNGLCLIENTWAITSYNCPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glCompileShader, PFNGLCOMPILESHADERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glCompressedTexImage2D, PFNGLCOMPRESSEDTEXIMAGE2DPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glCompressedTexSubImage2D, PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glCopyBufferSubData, PFNGLCOPYBUFFERSUBDATAPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glCreateProgram, PFNGLCREATEPROGRAMPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glCreateShader, PFNGLCREATESHADERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glDeleteBuffers, PFNGLDELETEBUFFERSPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glDeleteFramebuffers, PFNGLDELETEFRAMEBUFFERSPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glDeleteProgram, PFNGLDELETEPROGRAMPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glDeleteQueries, PFNGLDELETEQUERIESPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glDeleteSync, PFNGLDELETESYNCPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glDeleteVertexArrays, PFNGLDELETEVERTEXARRAYSPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glDeleteShader, PFNGLDELETESHADERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glEnableVertexAttribArray, PFNGLENABLEVERTEXATTRIBARRAYARBPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glFenceSync, PFNGLFENCESYNCPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glFramebufferTexture2D, PFNGLFRAMEBUFFERTEXTURE2DPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGenBuffers, PFNGLGENBUFFERSPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGenFramebuffers, PFNGLGENFRAMEBUFFERSPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGenQueries, PFNGLGENQUERIESPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGenVertexArrays, PFNGLGENVERTEXARRAYSPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGetProgramInfoLog, PFNGLGETPROGRAMINFOLOGPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGetProgramiv, PFNGLGETPROGRAMIVPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGetQueryObjectiv, PFNGLGETQUERYOBJECTIVPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGetQueryObjectui64v, PFNGLGETQUERYOBJECTUI64VPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGetShaderInfoLog, PFNGLGETSHADERINFOLOGPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGetShaderiv, PFNGLGETSHADERIVPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glGetUniformLocation, PFNGLGETUNIFORMLOCATIONPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glLinkProgram, PFNGLLINKPROGRAMPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glMapBufferRange, PFNGLMAPBUFFERRANGEPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glQueryCounter, PFNGLQUERYCOUNTERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glShaderSource, PFNGLSHADERSOURCEPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glTexBuffer, PFNGLTEXBUFFERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glUniform1fv, PFNGLUNIFORM1FVPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glUniform1i, PFNGLUNIFORM1IPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glUniform2fv, PFNGLUNIFORM2FVPROC );
@@ -123,13 +164,25 @@ bool eae6320::OpenGlExtensions::Load( std::string* o_errorMessage )
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glUniform4fv, PFNGLUNIFORM4FVPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glUniformBlockBinding, PFNGLUNIFORMBLOCKBINDINGPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glUniformMatrix4fv, PFNGLUNIFORMMATRIX4FVPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glUnmapBuffer, PFNGLUNMAPBUFFERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glUseProgram, PFNGLUSEPROGRAMPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( glVertexAttribPointer, PFNGLVERTEXATTRIBPOINTERPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( wglChoosePixelFormatARB, PFNWGLCHOOSEPIXELFORMATARBPROC );
 	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( wglCreateContextAttribsARB, PFNWGLCREATECONTEXTATTRIBSARBPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADFUNCTION( wglSwapIntervalEXT, PFNWGLSWAPINTERVALEXTPROC );
 
 #undef EAE6320_OPENGLEXTENSIONS_LOADFUNCTION
 
+	// Optional extensions are left NULL if they aren't found
+#define EAE6320_OPENGLEXTENSIONS_LOADOPTIONALFUNCTION( i_functionName, i_functionType )	\
+		i_functionName = reinterpret_cast<i_functionType>( GetOptionalGlFunctionAddress( #i_functionName ) );
+
+	EAE6320_OPENGLEXTENSIONS_LOADOPTIONALFUNCTION( glBufferStorage, PFNGLBUFFERSTORAGEPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADOPTIONALFUNCTION( glDebugMessageCallback, PFNGLDEBUGMESSAGECALLBACKPROC );
+	EAE6320_OPENGLEXTENSIONS_LOADOPTIONALFUNCTION( glDebugMessageControl, PFNGLDEBUGMESSAGECONTROLPROC );
+
+#undef EAE6320_OPENGLEXTENSIONS_LOADOPTIONALFUNCTION
+
 OnExit:
 
 	if ( !eae6320::Windows::OpenGl::FreeHiddenContextWindow( hInstance, hiddenWindowInfo, o_errorMessage ) )
@@ -213,4 +266,11 @@ namespace
 
 		return NULL;
 	}
+
+	void* GetOptionalGlFunctionAddress( const char* i_functionName )
+	{
+		void* address = reinterpret_cast<void*>( wglGetProcAddress( i_functionName ) );
+		return ( ( address != reinterpret_cast<void*>( 1 ) ) && ( address != reinterpret_cast<void*>( 2 ) )
+			&& ( address != reinterpret_cast<void*>( 3 ) ) && ( address != reinterpret_cast<void*>( -1 ) ) ) ? address : NULL;
+	}
 }
@@ -2,12 +2,71 @@
 //=============
 
 #include "cMyGame.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "../../Engine/Animation/AnimationClip.h"
+#include "../../Engine/Animation/Animator.h"
+#include "../../Engine/Animation/Skeleton.h"
+#include "../../Engine/Graphics/Atlas.h"
+#include "../../Engine/Graphics/Font.h"
 #include "../../Engine/Graphics/Graphics.h"
+#include "../../Engine/Graphics/Material.h"
+#include "../../Engine/Graphics/Terrain.h"
+#include "../../Engine/Graphics/TextBatch.h"
+#include "../../Engine/Graphics/Texture.h"
+#include "../../Engine/Logging/Logging.h"
+#include "../../Engine/Time/Time.h"
+#include "../../Engine/UserSettings/UserSettings.h"
 
 namespace
 {
 	eae6320::Graphics::Mesh * s_Mesh = NULL;
+	eae6320::Graphics::ParticleEmitter * s_particleEmitter = NULL;
+	eae6320::Graphics::Texture * s_texture = NULL;
+	eae6320::Graphics::Atlas * s_uiAtlas = NULL;
+	eae6320::Graphics::Material* s_defaultMaterial = NULL;
+	eae6320::Graphics::Material* s_texturedMaterial = NULL;
+	eae6320::Graphics::Material* s_particleMaterial = NULL;
+	eae6320::Graphics::Font* s_hudFont = NULL;
+	eae6320::Graphics::TextBatch* s_hudText = NULL;
+	eae6320::Graphics::Material* s_textMaterial = NULL;
+	eae6320::Graphics::TextBatch* s_hudSprites = NULL;
+	eae6320::Graphics::Material* s_spriteMaterial = NULL;
+
+	// A tentacle that blends between waving and curling
+	eae6320::Animation::Skeleton* s_tentacleSkeleton = NULL;
+	eae6320::Animation::AnimationClip* s_tentacleClips = NULL;
+	eae6320::Animation::Animator* s_tentacleAnimator = NULL;
+	eae6320::Graphics::SkinnedMesh* s_tentacleMesh = NULL;
+	const unsigned int s_tentacleBoneCount = 8;
+	const float s_tentacleBoneLength = 0.1f;
+
+	// The renderer doesn't have a 3D camera (view and projection constants) or a depth buffer yet,
+	// and so the terrain is only streamed around a camera that flies over it and isn't submitted
+	// (the HUD shows how many triangles its LODs would draw every frame)
+	eae6320::Graphics::Terrain* s_terrain = NULL;
+	const float s_terrainCameraFieldOfView = 1.0471976f;	// 60 degrees
+	const float s_terrainCameraHeight = 20.0f;
+
+	// A sample HUD made of sprites from the UI atlas
+	// (they are all in one batch, and so they are one draw call instead of one per sprite)
+	const char* const s_hudSpriteNames[] = { "panel", "button", "button", "health", "mana", "star", "star", "star", "cursor" };
+	const unsigned int s_hudSpriteCount = sizeof( s_hudSpriteNames ) / sizeof( *s_hudSpriteNames );
+	const eae6320::Graphics::AtlasFormats::sEntry* s_hudSprites_entries[s_hudSpriteCount] = { NULL };
 }
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool InitializeTentacle();
+	void CleanUpTentacle();
+	void UpdateTerrain();
+}
+
 // Interface
 //==========
 
@@ -24,7 +83,92 @@ eae6320::cMyGame::~cMyGame()
 
 void eae6320::cMyGame::Update()
 {
-	eae6320::Graphics::SubmitObject(s_Mesh);
+	// The quad is drawn with the streamed texture (or the placeholder until it has loaded)
+	eae6320::Graphics::SubmitObject( s_Mesh, s_texturedMaterial, s_texture );
+	// The quad is 1 unit across in clip space (which is 2 units across),
+	// and so it covers half of the width and height of the scene's pixels
+	// (the scene is rendered at the dynamic resolution scale)
+	{
+		const float quadFractionOfScene = 0.5f;
+		const float sceneScale = eae6320::Graphics::GetResolutionScale();
+		s_texture->ReportScreenSize( eae6320::UserSettings::GetResolutionWidth() * sceneScale * quadFractionOfScene,
+			eae6320::UserSettings::GetResolutionHeight() * sceneScale * quadFractionOfScene );
+	}
+
+	// The tentacle slowly alternates between waving and curling
+	{
+		const float blendWeight = 0.5f + ( 0.5f * std::sin( eae6320::Time::GetElapsedSecondCount_total() * 0.5f ) );
+		s_tentacleAnimator->SetBlendWeight( blendWeight );
+		s_tentacleAnimator->Update( eae6320::Time::GetElapsedSecondCount_duringPreviousFrame() );
+		eae6320::Graphics::SubmitSkinnedMesh( s_tentacleMesh, s_defaultMaterial );
+	}
+
+	s_particleEmitter->Update( eae6320::Time::GetElapsedSecondCount_duringPreviousFrame() );
+	eae6320::Graphics::SubmitParticleEmitter( s_particleEmitter, s_particleMaterial );
+
+	UpdateTerrain();
+
+	// The HUD's sprites are laid out in a row along the bottom of the screen
+	{
+		const float margin = 8.0f;
+		const float bottom = static_cast<float>( eae6320::UserSettings::GetResolutionHeight() ) - margin;
+		float x = margin;
+		for ( unsigned int i = 0; i < s_hudSpriteCount; ++i )
+		{
+			const eae6320::Graphics::AtlasFormats::sEntry& sprite = *s_hudSprites_entries[i];
+			s_hudSprites->AddSprite( sprite, x, bottom - sprite.height );
+			x += sprite.width + margin;
+		}
+		eae6320::Graphics::SubmitTextBatch( s_hudSprites, s_spriteMaterial );
+	}
+
+	// The HUD shows how the previous frame was rendered
+	{
+		const eae6320::Graphics::sRenderStats& renderStats = eae6320::Graphics::GetRenderStats();
+		const eae6320::Graphics::TextBatch::sStats& textStats = s_hudText->GetStats();
+		const eae6320::Graphics::TextBatch::sStats& spriteStats = s_hudSprites->GetStats();
+		const eae6320::Graphics::FrameFences::sStats& fenceStats = eae6320::Graphics::FrameFences::GetStats();
+		const eae6320::Graphics::Terrain::sStats& terrainStats = s_terrain->GetStats();
+		const eae6320::Graphics::AssetLoader::sStats& loaderStats = eae6320::Graphics::AssetLoader::GetStats();
+		const eae6320::Graphics::UploadManager::sStats& uploadStats = eae6320::Graphics::UploadManager::GetStats();
+		char text[1024];
+		snprintf( text, sizeof( text ), "%.2f ms\n%u draw calls\n%.0f%% resolution\n%u glyphs laid out in %.1f us"
+			"\n%u HUD sprites in %u draw call(s) (%u with a texture per sprite)"
+			"\n%u deletions queued\n%u fence stalls"
+			"\nterrain (not drawn): %u/%u tiles resident (%.1f MB), %.1f tiles streamed/s, %u triangles chosen in %u tiles"
+			"\nassets: %u reading, %u waiting, %.2f of %.2f ms budget used, %.1f ms average latency"
+			"\nuploads: %.1f KB in %u copies, %.2f MB/s, %u stalls (%.2f ms)",
+			eae6320::Time::GetElapsedSecondCount_duringPreviousFrame() * 1000.0f, renderStats.drawCallCount,
+			eae6320::Graphics::GetResolutionScale() * 100.0f,
+			textStats.glyphCount, ( textStats.secondCountLayingOut + textStats.secondCountWritingVertices ) * 1.0e6,
+			spriteStats.glyphCount, spriteStats.drawCallCount, spriteStats.glyphCount,
+			fenceStats.queuedDeletionCount, fenceStats.stallCount,
+			terrainStats.residentTileCount, terrainStats.tileCount, terrainStats.residentByteCount / ( 1024.0 * 1024.0 ),
+			terrainStats.tilesStreamedPerSecond, terrainStats.triangleCount, terrainStats.drawnTileCount,
+			loaderStats.readingCount, loaderStats.waitingCount, loaderStats.secondCountCreating * 1000.0,
+			loaderStats.budgetInSeconds * 1000.0, loaderStats.averageLatencyInSeconds * 1000.0,
+			uploadStats.uploadedByteCount / 1024.0, uploadStats.copyCount, uploadStats.bytesPerSecond / ( 1024.0 * 1024.0 ),
+			uploadStats.stallCount, uploadStats.secondCountStalled * 1000.0 );
+#ifdef EAE6320_GRAPHICS_ARESTATISTICSTRACKED
+		{
+			namespace Statistics = eae6320::Graphics::Statistics;
+			const Statistics::sFrame& frameStats = Statistics::GetPreviousFrame();
+			const Statistics::sMemory& memoryStats = Statistics::GetMemory();
+			size_t gpuByteCount = 0;
+			for ( unsigned int i = 0; i < Statistics::eResourceType::Count; ++i )
+			{
+				gpuByteCount += memoryStats.byteCount[i];
+			}
+			const size_t length = strlen( text );
+			snprintf( text + length, sizeof( text ) - length, "\n%llu primitives\n%u program switches\n%.1f KB uploaded\n%.1f MB GPU memory",
+				frameStats.primitiveCount, frameStats.programSwitchCount,
+				frameStats.uploadedByteCount / 1024.0, gpuByteCount / ( 1024.0 * 1024.0 ) );
+		}
+#endif
+		const float margin = 8.0f;
+		s_hudText->AddText( text, margin, margin );
+		eae6320::Graphics::SubmitTextBatch( s_hudText, s_textMaterial );
+	}
 }
 
 // Initialization / Clean Up
@@ -32,14 +176,336 @@ void eae6320::cMyGame::Update()
 
 bool eae6320::cMyGame::Initialize()
 {
+	s_defaultMaterial = eae6320::Graphics::Material::Load( "data/default.material" );
+	if ( !s_defaultMaterial )
+	{
+		return false;
+	}
+	s_texturedMaterial = eae6320::Graphics::Material::Load( "data/textured.material" );
+	if ( !s_texturedMaterial )
+	{
+		return false;
+	}
+	s_particleMaterial = eae6320::Graphics::Material::Load( "data/particles.material" );
+	if ( !s_particleMaterial )
+	{
+		return false;
+	}
+
+	s_textMaterial = eae6320::Graphics::Material::Load( "data/text.material" );
+	if ( !s_textMaterial )
+	{
+		return false;
+	}
+
 	s_Mesh = new eae6320::Graphics::Mesh();
 	s_Mesh->Initialize();
 
+	s_particleEmitter = new eae6320::Graphics::ParticleEmitter();
+	{
+		eae6320::Graphics::ParticleEmitter::sSettings settings;
+		settings.positionY = -0.5f;
+		settings.accelerationY = -1.0f;
+		settings.spawnRatePerSecond = 100000.0f;
+		const unsigned int maxParticleCount = 256 * 1024;
+		if ( !s_particleEmitter->Initialize( maxParticleCount, settings ) )
+		{
+			return false;
+		}
+	}
+
+	if ( !InitializeTentacle() )
+	{
+		return false;
+	}
+
+	// The texture is read on an I/O thread instead of delaying startup,
+	// and the placeholder is used until it has finished loading
+	s_texture = new eae6320::Graphics::Texture();
+	const bool shouldTextureBeStreamed = true;
+	s_texture->LoadAsync( "data/checkerboard.texture", shouldTextureBeStreamed );
+
+	s_uiAtlas = new eae6320::Graphics::Atlas();
+	if ( !s_uiAtlas->Load( "data/ui.atlas" ) )
+	{
+		return false;
+	}
+	// Every sprite that the HUD uses must be in the atlas
+	// (loading the atlas logs how much of its texture the images occupy)
+	for ( unsigned int i = 0; i < s_hudSpriteCount; ++i )
+	{
+		s_hudSprites_entries[i] = s_uiAtlas->Find( s_hudSpriteNames[i] );
+		if ( !s_hudSprites_entries[i] )
+		{
+			eae6320::Logging::OutputError( "The UI atlas doesn't have the HUD sprite \"%s\"", s_hudSpriteNames[i] );
+			return false;
+		}
+	}
+	s_spriteMaterial = eae6320::Graphics::Material::Load( "data/sprite.material" );
+	if ( !s_spriteMaterial )
+	{
+		return false;
+	}
+	s_hudSprites = new eae6320::Graphics::TextBatch();
+	if ( !s_hudSprites->Initialize( *s_uiAtlas, s_hudSpriteCount ) )
+	{
+		return false;
+	}
+
+	s_hudFont = new eae6320::Graphics::Font();
+	if ( !s_hudFont->Load( "data/hud.font" ) )
+	{
+		return false;
+	}
+	s_hudText = new eae6320::Graphics::TextBatch();
+	{
+		const unsigned int maxGlyphCount = 16 * 1024;
+		if ( !s_hudText->Initialize( *s_hudFont, maxGlyphCount ) )
+		{
+			return false;
+		}
+	}
+#ifdef EAE6320_GRAPHICS_SHOULDTEXTLAYOUTBEMEASURED
+	// A full screen of debug text is around 10,000 glyphs
+	eae6320::Graphics::TextBatch::LogLayoutCost( *s_hudFont, 10000 );
+#endif
+
+	s_terrain = new eae6320::Graphics::Terrain();
+	if ( !s_terrain->Load( "data/hills.terrain" ) )
+	{
+		return false;
+	}
+
 	return true;
 }
 
 bool eae6320::cMyGame::CleanUp()
 {
 	s_Mesh->CleanUp();
+	if ( s_particleEmitter )
+	{
+		s_particleEmitter->CleanUp();
+		delete s_particleEmitter;
+		s_particleEmitter = NULL;
+	}
+	CleanUpTentacle();
+	if ( s_texture )
+	{
+		s_texture->CleanUp();
+		delete s_texture;
+		s_texture = NULL;
+	}
+	if ( s_hudSprites )
+	{
+		s_hudSprites->CleanUp();
+		delete s_hudSprites;
+		s_hudSprites = NULL;
+	}
+	if ( s_uiAtlas )
+	{
+		s_uiAtlas->CleanUp();
+		delete s_uiAtlas;
+		s_uiAtlas = NULL;
+	}
+	if ( s_hudText )
+	{
+		s_hudText->CleanUp();
+		delete s_hudText;
+		s_hudText = NULL;
+	}
+	if ( s_hudFont )
+	{
+		s_hudFont->CleanUp();
+		delete s_hudFont;
+		s_hudFont = NULL;
+	}
+	if ( s_terrain )
+	{
+		s_terrain->CleanUp();
+		delete s_terrain;
+		s_terrain = NULL;
+	}
+	if ( s_defaultMaterial )
+	{
+		s_defaultMaterial->Release();
+		s_defaultMaterial = NULL;
+	}
+	if ( s_texturedMaterial )
+	{
+		s_texturedMaterial->Release();
+		s_texturedMaterial = NULL;
+	}
+	if ( s_particleMaterial )
+	{
+		s_particleMaterial->Release();
+		s_particleMaterial = NULL;
+	}
+	if ( s_textMaterial )
+	{
+		s_textMaterial->Release();
+		s_textMaterial = NULL;
+	}
+	if ( s_spriteMaterial )
+	{
+		s_spriteMaterial->Release();
+		s_spriteMaterial = NULL;
+	}
 	return true;
 }
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool InitializeTentacle()
+	{
+		// The bones are a chain along the x axis
+		s_tentacleSkeleton = new eae6320::Animation::Skeleton();
+		{
+			uint16_t parentIndices[s_tentacleBoneCount];
+			eae6320::Animation::sTransform bindPose[s_tentacleBoneCount];
+			for ( unsigned int i = 0; i < s_tentacleBoneCount; ++i )
+			{
+				parentIndices[i] = ( i == 0 ) ? eae6320::Animation::Skeleton::s_noParent : static_cast<uint16_t>( i - 1 );
+				const float translationX = ( i == 0 ) ? -0.4f : s_tentacleBoneLength;
+				const float translationY = ( i == 0 ) ? 0.5f : 0.0f;
+				eae6320::Animation::SetRotationZ( 0.0f, translationX, translationY, bindPose[i] );
+			}
+			if ( !s_tentacleSkeleton->Initialize( parentIndices, bindPose, s_tentacleBoneCount ) )
+			{
+				return false;
+			}
+		}
+		// Clip A sends a wave down the tentacle and clip B curls it up and uncurls it
+		s_tentacleClips = new eae6320::Animation::AnimationClip[2];
+		if ( !s_tentacleClips[0].Load( "data/tentacleWave.animation" )
+			|| !s_tentacleClips[1].Load( "data/tentacleCurl.animation" ) )
+		{
+			return false;
+		}
+		s_tentacleAnimator = new eae6320::Animation::Animator();
+		if ( !s_tentacleAnimator->Initialize( *s_tentacleSkeleton ) )
+		{
+			return false;
+		}
+		s_tentacleAnimator->SetClips( &s_tentacleClips[0], &s_tentacleClips[1] );
+		// The mesh is a strip of quads that gets narrower towards the tip,
+		// and each edge across the strip is weighted between the two closest bones
+		s_tentacleMesh = new eae6320::Graphics::SkinnedMesh();
+		{
+			const unsigned int segmentsPerBone = 2;
+			const unsigned int segmentCount = s_tentacleBoneCount * segmentsPerBone;
+			const unsigned int vertexCount = segmentCount * 6;
+			eae6320::Animation::sSkinnedVertex vertices[vertexCount];
+			for ( unsigned int s = 0; s < segmentCount; ++s )
+			{
+				eae6320::Animation::sSkinnedVertex edges[2][2];
+				for ( unsigned int e = 0; e < 2; ++e )
+				{
+					const float distance = static_cast<float>( s + e ) / segmentsPerBone;
+					const float halfWidth = 0.06f * ( 1.0f - ( distance / ( s_tentacleBoneCount + 1 ) ) );
+					// The weight moves from one bone to the next halfway along each bone
+					const float boneDistance = distance - 0.5f;
+					unsigned int boneIndex = ( boneDistance > 0.0f ) ? static_cast<unsigned int>( boneDistance ) : 0;
+					boneIndex = ( boneIndex < ( s_tentacleBoneCount - 1 ) ) ? boneIndex : ( s_tentacleBoneCount - 2 );
+					float weight = boneDistance - static_cast<float>( boneIndex );
+					weight = ( weight < 0.0f ) ? 0.0f : ( ( weight > 1.0f ) ? 1.0f : weight );
+					for ( unsigned int side = 0; side < 2; ++side )
+					{
+						eae6320::Animation::sSkinnedVertex& vertex = edges[e][side];
+						vertex.x = -0.4f + ( distance * s_tentacleBoneLength );
+						vertex.y = 0.5f + ( ( side == 0 ) ? -halfWidth : halfWidth );
+						vertex.z = 0.0f;
+						vertex.boneIndices[0] = static_cast<uint8_t>( boneIndex );
+						vertex.boneIndices[1] = static_cast<uint8_t>( boneIndex + 1 );
+						vertex.boneIndices[2] = vertex.boneIndices[3] = 0;
+						vertex.boneWeights[0] = 1.0f - weight;
+						vertex.boneWeights[1] = weight;
+						vertex.boneWeights[2] = vertex.boneWeights[3] = 0.0f;
+					}
+				}
+				// Direct3D's front faces are clockwise and OpenGL's are counterclockwise
+				// (the same as the platforms' Mesh quads)
+				eae6320::Animation::sSkinnedVertex* const quad = vertices + ( s * 6 );
+#if defined( EAE6320_PLATFORM_D3D )
+				quad[0] = edges[0][0];
+				quad[1] = edges[1][1];
+				quad[2] = edges[1][0];
+				quad[3] = edges[0][0];
+				quad[4] = edges[0][1];
+				quad[5] = edges[1][1];
+#elif defined( EAE6320_PLATFORM_GL )
+				quad[0] = edges[0][0];
+				quad[1] = edges[1][0];
+				quad[2] = edges[1][1];
+				quad[3] = edges[0][0];
+				quad[4] = edges[1][1];
+				quad[5] = edges[0][1];
+#endif
+			}
+			if ( !s_tentacleMesh->Initialize( vertices, vertexCount, *s_tentacleAnimator ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void CleanUpTentacle()
+	{
+		if ( s_tentacleMesh )
+		{
+			s_tentacleMesh->CleanUp();
+			delete s_tentacleMesh;
+			s_tentacleMesh = NULL;
+		}
+		if ( s_tentacleAnimator )
+		{
+			s_tentacleAnimator->CleanUp();
+			delete s_tentacleAnimator;
+			s_tentacleAnimator = NULL;
+		}
+		if ( s_tentacleClips )
+		{
+			s_tentacleClips[0].CleanUp();
+			s_tentacleClips[1].CleanUp();
+			delete [] s_tentacleClips;
+			s_tentacleClips = NULL;
+		}
+		if ( s_tentacleSkeleton )
+		{
+			s_tentacleSkeleton->CleanUp();
+			delete s_tentacleSkeleton;
+			s_tentacleSkeleton = NULL;
+		}
+	}
+
+	void UpdateTerrain()
+	{
+		// The camera circles the middle of the terrain, looking ahead and slightly down
+		const float angle = eae6320::Time::GetElapsedSecondCount_total() * 0.05f;
+		const float sizeX = s_terrain->GetSizeX();
+		const float sizeZ = s_terrain->GetSizeZ();
+		float cameraPosition[3] =
+		{
+			( 0.5f * sizeX ) + ( 0.4f * sizeX * std::cos( angle ) ),
+			0.0f,
+			( 0.5f * sizeZ ) + ( 0.4f * sizeZ * std::sin( angle ) ),
+		};
+		cameraPosition[1] = s_terrain->GetTileHeightMax( cameraPosition[0], cameraPosition[2] ) + s_terrainCameraHeight;
+		const float targetPosition[3] =
+		{
+			cameraPosition[0] - ( 100.0f * std::sin( angle ) ),
+			cameraPosition[1] - 15.0f,
+			cameraPosition[2] + ( 100.0f * std::cos( angle ) ),
+		};
+		const float up[3] = { 0.0f, 1.0f, 0.0f };
+		const float width = static_cast<float>( eae6320::UserSettings::GetResolutionWidth() );
+		const float height = static_cast<float>( eae6320::UserSettings::GetResolutionHeight() );
+		eae6320::Graphics::MeshClusters::sView view;
+		eae6320::Graphics::MeshClusters::CalculateView( cameraPosition, targetPosition, up,
+			s_terrainCameraFieldOfView, width / height, 0.1f, s_terrain->GetSettings().viewDistance, view );
+		s_terrain->Update( view, s_terrainCameraFieldOfView, height );
+	}
+}
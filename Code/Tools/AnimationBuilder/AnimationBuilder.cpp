@@ -0,0 +1,624 @@
+// Header Files
+//=============
+
+#include "AnimationBuilder.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "../AssetBuildLibrary/LuaAssets.h"
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+#include "../../Engine/Animation/AnimationClip.h"
+#include "../../Engine/Animation/AnimationFormats.h"
+#include "../../Engine/Animation/Skeleton.h"
+#include "../../Engine/Animation/Transform.h"
+#include "../../Engine/Platform/Platform.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	struct sBoneDescription
+	{
+		// 4 floats for every rotation key and 3 for every translation key
+		std::vector<float> rotations;
+		std::vector<float> translations;
+	};
+	struct sAnimationDescription
+	{
+		std::vector<sBoneDescription> bones;
+		float keysPerSecond;
+		// In degrees
+		float maxRotationError;
+		float maxTranslationError;
+		unsigned int blockKeyCount;
+
+		sAnimationDescription() : keysPerSecond( 30.0f ), maxRotationError( 0.1f ), maxTranslationError( 0.0001f ), blockKeyCount( 16 ) {}
+	};
+
+	const float s_radiansPerDegree = 0.0174532925f;
+	// Enough poses are sampled to take at least a few milliseconds
+	const unsigned int s_sampledBoneCountToMeasure = 4000000;
+
+	bool LoadAnimationDescription( const char* const i_path, sAnimationDescription& o_description );
+	bool LoadTrack( lua_State& io_luaState, const char* const i_key, const unsigned int i_componentCount, const unsigned int i_boneIndex,
+		const char* const i_path, std::vector<float>& o_values );
+
+	// A track with 4 components is a rotation and one with 3 is a translation
+	void Interpolate( const float* const i_a, const float* const i_b, const float i_t, const unsigned int i_componentCount, float* const o_value );
+	// The rotation error is the angle between the rotations (in radians)
+	// and the translation error is the distance between the translations
+	float CalculateError( const float* const i_a, const float* const i_b, const unsigned int i_componentCount );
+
+	// Returns the frames (relative to the block's first frame) that must be kept as keys
+	// so that interpolating between the quantized keys stays within the tolerance at every frame
+	void ReduceKeys( const float* const i_values_raw, const float* const i_values_quantized, const unsigned int i_componentCount,
+		const unsigned int i_frameCount, const float i_tolerance, std::vector<uint8_t>& o_keyFrames );
+	void AppendTrack( const std::vector<uint8_t>& i_keyFrames, const void* const i_values, const size_t i_valueSize, std::vector<uint8_t>& io_block );
+}
+
+// Interface
+//==========
+
+bool eae6320::AnimationBuilder::Build( const char* const i_path_source, const char* const i_path_target )
+{
+	bool wereThereErrors = false;
+
+	sAnimationDescription description;
+	unsigned int boneCount = 0;
+	unsigned int keyCount = 0;
+	unsigned int blockCount = 0;
+	std::vector<Animation::AnimationFormats::sBone> bones;
+	size_t builtSize = 0;
+	size_t animatedKeyCount = 0, keptKeyCount = 0;
+
+	if ( !LoadAnimationDescription( i_path_source, description ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	boneCount = static_cast<unsigned int>( description.bones.size() );
+	// Every track is expanded to a key for every frame
+	// with a copy of the first frame at the end (so that the last block can blend back into it)
+	{
+		for ( unsigned int i = 0; i < boneCount; ++i )
+		{
+			const unsigned int rotationKeyCount = static_cast<unsigned int>( description.bones[i].rotations.size() / 4 );
+			const unsigned int translationKeyCount = static_cast<unsigned int>( description.bones[i].translations.size() / 3 );
+			keyCount = ( rotationKeyCount > keyCount ) ? rotationKeyCount : keyCount;
+			keyCount = ( translationKeyCount > keyCount ) ? translationKeyCount : keyCount;
+		}
+		if ( keyCount > 65535 )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "An animation clip can't have more than 65535 keys", i_path_source );
+			goto OnExit;
+		}
+		for ( unsigned int i = 0; i < boneCount; ++i )
+		{
+			std::vector<float>* const tracks[] = { &description.bones[i].rotations, &description.bones[i].translations };
+			for ( unsigned int j = 0; j < 2; ++j )
+			{
+				std::vector<float>& track = *tracks[j];
+				const unsigned int componentCount = ( j == 0 ) ? 4 : 3;
+				const unsigned int trackKeyCount = static_cast<unsigned int>( track.size() / componentCount );
+				if ( trackKeyCount == 1 )
+				{
+					track.resize( ( keyCount + 1 ) * componentCount );
+					for ( unsigned int k = 1; k <= keyCount; ++k )
+					{
+						memcpy( &track[k * componentCount], &track[0], componentCount * sizeof( float ) );
+					}
+				}
+				else if ( trackKeyCount == keyCount )
+				{
+					track.insert( track.end(), track.begin(), track.begin() + componentCount );
+				}
+				else
+				{
+					wereThereErrors = true;
+					std::ostringstream errorMessage;
+					errorMessage << "Bone " << ( i + 1 ) << " has " << trackKeyCount << ( ( j == 0 ) ? " rotation" : " translation" )
+						<< " keys, but every track must have either 1 key or " << keyCount;
+					AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path_source );
+					goto OnExit;
+				}
+			}
+		}
+	}
+	// Find which tracks are constant and the range that each bone's translations are quantized in
+	{
+		const float maxRotationError = description.maxRotationError * s_radiansPerDegree;
+		bones.resize( boneCount );
+		for ( unsigned int i = 0; i < boneCount; ++i )
+		{
+			const float* const rotations = &description.bones[i].rotations[0];
+			const float* const translations = &description.bones[i].translations[0];
+			Animation::AnimationFormats::sBone& bone = bones[i];
+			memset( &bone, 0, sizeof( bone ) );
+
+			bool isRotationConstant = true;
+			bool isTranslationConstant = true;
+			float translationMax[3];
+			for ( unsigned int j = 0; j < 3; ++j )
+			{
+				bone.translationMin[j] = translationMax[j] = translations[j];
+			}
+			for ( unsigned int k = 1; k < keyCount; ++k )
+			{
+				isRotationConstant = isRotationConstant && ( CalculateError( rotations, rotations + ( k * 4 ), 4 ) <= maxRotationError );
+				isTranslationConstant = isTranslationConstant
+					&& ( CalculateError( translations, translations + ( k * 3 ), 3 ) <= description.maxTranslationError );
+				for ( unsigned int j = 0; j < 3; ++j )
+				{
+					const float translation = translations[( k * 3 ) + j];
+					bone.translationMin[j] = ( translation < bone.translationMin[j] ) ? translation : bone.translationMin[j];
+					translationMax[j] = ( translation > translationMax[j] ) ? translation : translationMax[j];
+				}
+			}
+			if ( isRotationConstant )
+			{
+				bone.flags |= Animation::AnimationFormats::eBoneFlag::IsRotationConstant;
+				memcpy( bone.rotation, rotations, sizeof( bone.rotation ) );
+			}
+			if ( isTranslationConstant )
+			{
+				bone.flags |= Animation::AnimationFormats::eBoneFlag::IsTranslationConstant;
+				memcpy( bone.translationMin, translations, sizeof( bone.translationMin ) );
+			}
+			else
+			{
+				for ( unsigned int j = 0; j < 3; ++j )
+				{
+					bone.translationExtent[j] = translationMax[j] - bone.translationMin[j];
+				}
+			}
+		}
+	}
+	// Reduce the keys of every animated track in every block and write the clip
+	{
+		const unsigned int blockKeyCount = description.blockKeyCount;
+		blockCount = ( keyCount + blockKeyCount - 1 ) / blockKeyCount;
+		std::vector<uint32_t> blockOffsets( blockCount );
+		std::vector<uint8_t> blocks;
+		{
+			const float maxRotationError = description.maxRotationError * s_radiansPerDegree;
+			std::vector<Animation::AnimationFormats::sQuantizedRotation> rotations_quantized;
+			std::vector<Animation::AnimationFormats::sQuantizedTranslation> translations_quantized;
+			std::vector<float> values_quantized;
+			std::vector<uint8_t> keyFrames;
+			for ( unsigned int b = 0; b < blockCount; ++b )
+			{
+				// Every block starts on a 4 byte boundary
+				// so that the track values can be aligned relative to the start of the block
+				while ( ( blocks.size() % 4 ) != 0 )
+				{
+					blocks.push_back( 0 );
+				}
+				blockOffsets[b] = static_cast<uint32_t>( blocks.size() );
+				const unsigned int firstFrame = b * blockKeyCount;
+				const unsigned int lastFrame = ( ( firstFrame + blockKeyCount ) < keyCount ) ? ( firstFrame + blockKeyCount ) : keyCount;
+				const unsigned int frameCount = lastFrame - firstFrame + 1;
+				for ( unsigned int i = 0; i < boneCount; ++i )
+				{
+					const Animation::AnimationFormats::sBone& bone = bones[i];
+					if ( ( bone.flags & Animation::AnimationFormats::eBoneFlag::IsRotationConstant ) == 0 )
+					{
+						const float* const rotations = &description.bones[i].rotations[firstFrame * 4];
+						rotations_quantized.resize( frameCount );
+						values_quantized.resize( frameCount * 4 );
+						for ( unsigned int f = 0; f < frameCount; ++f )
+						{
+							Animation::AnimationFormats::QuantizeRotation( rotations + ( f * 4 ), rotations_quantized[f] );
+							Animation::AnimationFormats::DequantizeRotation( rotations_quantized[f], &values_quantized[f * 4] );
+						}
+						ReduceKeys( rotations, &values_quantized[0], 4, frameCount, maxRotationError, keyFrames );
+						AppendTrack( keyFrames, &rotations_quantized[0], sizeof( rotations_quantized[0] ), blocks );
+						animatedKeyCount += frameCount - 1;
+						keptKeyCount += keyFrames.size() - 1;
+					}
+					if ( ( bone.flags & Animation::AnimationFormats::eBoneFlag::IsTranslationConstant ) == 0 )
+					{
+						const float* const translations = &description.bones[i].translations[firstFrame * 3];
+						translations_quantized.resize( frameCount );
+						values_quantized.resize( frameCount * 3 );
+						for ( unsigned int f = 0; f < frameCount; ++f )
+						{
+							Animation::AnimationFormats::QuantizeTranslation( translations + ( f * 3 ), bone, translations_quantized[f] );
+							Animation::AnimationFormats::DequantizeTranslation( translations_quantized[f], bone, &values_quantized[f * 3] );
+						}
+						ReduceKeys( translations, &values_quantized[0], 3, frameCount, description.maxTranslationError, keyFrames );
+						AppendTrack( keyFrames, &translations_quantized[0], sizeof( translations_quantized[0] ), blocks );
+						animatedKeyCount += frameCount - 1;
+						keptKeyCount += keyFrames.size() - 1;
+					}
+				}
+			}
+		}
+
+		Animation::AnimationFormats::sHeader header;
+		memset( &header, 0, sizeof( header ) );
+		header.fourCc = Animation::AnimationFormats::s_fourCc;
+		header.version = Animation::AnimationFormats::s_version;
+		header.boneCount = static_cast<uint16_t>( boneCount );
+		header.keyCount = static_cast<uint16_t>( keyCount );
+		header.blockKeyCount = static_cast<uint16_t>( blockKeyCount );
+		header.blockCount = static_cast<uint16_t>( blockCount );
+		header.keysPerSecond = description.keysPerSecond;
+		// A clip whose tracks are all constant still has an (empty) block
+		// so that the runtime can tell where the file's data ends
+		if ( blocks.empty() )
+		{
+			blocks.resize( 4, 0 );
+		}
+		const size_t size_bones = boneCount * sizeof( Animation::AnimationFormats::sBone );
+		const size_t size_blockOffsets = blockCount * sizeof( uint32_t );
+		std::vector<uint8_t> targetData( sizeof( header ) + size_bones + size_blockOffsets + blocks.size() );
+		{
+			uint8_t* target = &targetData[0];
+			memcpy( target, &header, sizeof( header ) );
+			target += sizeof( header );
+			memcpy( target, &bones[0], size_bones );
+			target += size_bones;
+			memcpy( target, &blockOffsets[0], size_blockOffsets );
+			target += size_blockOffsets;
+			memcpy( target, &blocks[0], blocks.size() );
+		}
+		std::string errorMessage;
+		if ( !Platform::WriteBinaryFile( i_path_target, &targetData[0], targetData.size(), &errorMessage ) )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path_target );
+			goto OnExit;
+		}
+		builtSize = targetData.size();
+	}
+	// Sample the built clip with the runtime's code
+	// and compare it with the authored keys to report how much was lost and how fast it is
+	{
+		Animation::AnimationClip clip_raw;
+		{
+			std::vector<Animation::sTransform> keys( keyCount * boneCount );
+			for ( unsigned int k = 0; k < keyCount; ++k )
+			{
+				for ( unsigned int i = 0; i < boneCount; ++i )
+				{
+					Animation::sTransform& key = keys[( k * boneCount ) + i];
+					memcpy( key.rotation, &description.bones[i].rotations[k * 4], sizeof( key.rotation ) );
+					memcpy( key.translation, &description.bones[i].translations[k * 3], sizeof( key.translation ) );
+				}
+			}
+			if ( !clip_raw.Initialize( &keys[0], boneCount, keyCount, description.keysPerSecond ) )
+			{
+				wereThereErrors = true;
+				AssetBuild::OutputErrorMessage( "The authored keys couldn't be sampled", i_path_source );
+				goto OnExit;
+			}
+		}
+		Animation::AnimationClip clip_built;
+		if ( !clip_built.Load( i_path_target ) )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "The built clip couldn't be loaded", i_path_target );
+			goto OnExit;
+		}
+
+		// The clips are compared between the frames as well as at them
+		const unsigned int samplesPerFrame = 4;
+		const float secondsPerSample = 1.0f / ( description.keysPerSecond * samplesPerFrame );
+		std::vector<Animation::sTransform> pose_raw( boneCount ), pose_built( boneCount );
+		float maxRotationError = 0.0f, maxTranslationError = 0.0f;
+		for ( unsigned int s = 0; s < ( keyCount * samplesPerFrame ); ++s )
+		{
+			const float secondCount = s * secondsPerSample;
+			clip_raw.Sample( secondCount, &pose_raw[0] );
+			clip_built.Sample( secondCount, &pose_built[0] );
+			for ( unsigned int i = 0; i < boneCount; ++i )
+			{
+				const float rotationError = CalculateError( pose_raw[i].rotation, pose_built[i].rotation, 4 );
+				const float translationError = CalculateError( pose_raw[i].translation, pose_built[i].translation, 3 );
+				maxRotationError = ( rotationError > maxRotationError ) ? rotationError : maxRotationError;
+				maxTranslationError = ( translationError > maxTranslationError ) ? translationError : maxTranslationError;
+			}
+		}
+
+		// Random times are sampled so that every block is read as often as it would be by many characters
+		double posesPerMillisecond_raw, posesPerMillisecond_built;
+		{
+			const unsigned int poseCount = ( s_sampledBoneCountToMeasure + boneCount - 1 ) / boneCount;
+			const float duration = clip_built.GetDuration();
+			const Animation::AnimationClip* const clips[] = { &clip_raw, &clip_built };
+			double* const posesPerMillisecond[] = { &posesPerMillisecond_raw, &posesPerMillisecond_built };
+			for ( unsigned int c = 0; c < 2; ++c )
+			{
+				uint32_t random = 12345;
+				const std::chrono::high_resolution_clock::time_point startTime = std::chrono::high_resolution_clock::now();
+				for ( unsigned int p = 0; p < poseCount; ++p )
+				{
+					random = ( random * 1664525 ) + 1013904223;
+					const float secondCount = ( static_cast<float>( random >> 8 ) / 16777216.0f ) * duration;
+					clips[c]->Sample( secondCount, &pose_built[0] );
+				}
+				const std::chrono::duration<double, std::milli> elapsedTime = std::chrono::high_resolution_clock::now() - startTime;
+				*posesPerMillisecond[c] = ( elapsedTime.count() > 0.0 ) ? ( poseCount / elapsedTime.count() ) : 0.0;
+			}
+		}
+
+		const size_t rawSize = static_cast<size_t>( keyCount ) * boneCount * sizeof( Animation::sTransform );
+		std::cout << "AnimationBuilder: " << boneCount << " bones x " << keyCount << " keys in "
+			<< blockCount << " blocks: " << rawSize << " -> " << builtSize << " bytes ("
+			<< ( static_cast<double>( rawSize ) / static_cast<double>( builtSize ) ) << ":1; kept " << keptKeyCount << " of "
+			<< animatedKeyCount << " animated keys); max error " << ( maxRotationError / s_radiansPerDegree ) << " degrees and "
+			<< maxTranslationError << " units; " << posesPerMillisecond_built << " poses sampled per ms ("
+			<< posesPerMillisecond_raw << " uncompressed)\n";
+	}
+
+OnExit:
+
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool LoadAnimationDescription( const char* const i_path, sAnimationDescription& o_description )
+	{
+		bool wereThereErrors = false;
+
+		lua_State* const luaState = eae6320::AssetBuild::LoadLuaAsset( i_path );
+		if ( !luaState )
+		{
+			return false;
+		}
+
+		if ( !eae6320::AssetBuild::GetOptionalNumber( *luaState, "keysPerSecond", i_path, o_description.keysPerSecond )
+			|| !eae6320::AssetBuild::GetOptionalNumber( *luaState, "maxRotationError", i_path, o_description.maxRotationError )
+			|| !eae6320::AssetBuild::GetOptionalNumber( *luaState, "maxTranslationError", i_path, o_description.maxTranslationError )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "blockKeyCount", i_path, o_description.blockKeyCount ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		if ( !( o_description.keysPerSecond > 0.0f ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "An animation clip's \"keysPerSecond\" must be positive", i_path );
+			goto OnExit;
+		}
+		if ( !( o_description.maxRotationError >= 0.0f ) || !( o_description.maxTranslationError >= 0.0f ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "An animation clip's error tolerances can't be negative", i_path );
+			goto OnExit;
+		}
+		if ( ( o_description.blockKeyCount == 0 ) || ( o_description.blockKeyCount > eae6320::Animation::AnimationFormats::s_maxBlockKeyCount ) )
+		{
+			wereThereErrors = true;
+			std::ostringstream errorMessage;
+			errorMessage << "An animation clip's \"blockKeyCount\" must be between 1 and " << eae6320::Animation::AnimationFormats::s_maxBlockKeyCount;
+			eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+			goto OnExit;
+		}
+		lua_getfield( luaState, -1, "bones" );
+		{
+			const unsigned int boneCount = lua_istable( luaState, -1 ) ? static_cast<unsigned int>( luaL_len( luaState, -1 ) ) : 0;
+			if ( ( boneCount == 0 ) || ( boneCount > eae6320::Animation::Skeleton::s_maxBoneCount ) )
+			{
+				wereThereErrors = true;
+				std::ostringstream errorMessage;
+				errorMessage << "An animation clip's \"bones\" must be a table of between 1 and " << eae6320::Animation::Skeleton::s_maxBoneCount << " bones";
+				eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+			}
+			o_description.bones.resize( boneCount );
+			for ( unsigned int i = 0; ( i < boneCount ) && !wereThereErrors; ++i )
+			{
+				lua_rawgeti( luaState, -1, i + 1 );
+				if ( lua_istable( luaState, -1 ) )
+				{
+					sBoneDescription& bone = o_description.bones[i];
+					if ( !LoadTrack( *luaState, "rotations", 4, i, i_path, bone.rotations )
+						|| !LoadTrack( *luaState, "translations", 3, i, i_path, bone.translations ) )
+					{
+						wereThereErrors = true;
+					}
+				}
+				else
+				{
+					wereThereErrors = true;
+					std::ostringstream errorMessage;
+					errorMessage << "Bone " << ( i + 1 ) << " must be a table with \"rotations\" and \"translations\"";
+					eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+				}
+				lua_pop( luaState, 1 );
+			}
+		}
+		lua_pop( luaState, 1 );
+
+	OnExit:
+
+		lua_close( luaState );
+		return !wereThereErrors;
+	}
+
+	bool LoadTrack( lua_State& io_luaState, const char* const i_key, const unsigned int i_componentCount, const unsigned int i_boneIndex,
+		const char* const i_path, std::vector<float>& o_values )
+	{
+		bool wereThereErrors = false;
+		lua_getfield( &io_luaState, -1, i_key );
+		const unsigned int keyCount = lua_istable( &io_luaState, -1 ) ? static_cast<unsigned int>( luaL_len( &io_luaState, -1 ) ) : 0;
+		if ( keyCount == 0 )
+		{
+			wereThereErrors = true;
+		}
+		o_values.resize( keyCount * i_componentCount );
+		for ( unsigned int k = 0; ( k < keyCount ) && !wereThereErrors; ++k )
+		{
+			lua_rawgeti( &io_luaState, -1, k + 1 );
+			if ( lua_istable( &io_luaState, -1 ) && ( static_cast<unsigned int>( luaL_len( &io_luaState, -1 ) ) == i_componentCount ) )
+			{
+				for ( unsigned int j = 0; j < i_componentCount; ++j )
+				{
+					lua_rawgeti( &io_luaState, -1, j + 1 );
+					if ( lua_type( &io_luaState, -1 ) == LUA_TNUMBER )
+					{
+						o_values[( k * i_componentCount ) + j] = static_cast<float>( lua_tonumber( &io_luaState, -1 ) );
+					}
+					else
+					{
+						wereThereErrors = true;
+					}
+					lua_pop( &io_luaState, 1 );
+				}
+			}
+			else
+			{
+				wereThereErrors = true;
+			}
+			lua_pop( &io_luaState, 1 );
+		}
+		// Rotations are normalized so that the authored values don't have to be exact
+		if ( !wereThereErrors && ( i_componentCount == 4 ) )
+		{
+			for ( unsigned int k = 0; ( k < keyCount ) && !wereThereErrors; ++k )
+			{
+				float* const rotation = &o_values[k * 4];
+				const float length = std::sqrt( ( rotation[0] * rotation[0] ) + ( rotation[1] * rotation[1] )
+					+ ( rotation[2] * rotation[2] ) + ( rotation[3] * rotation[3] ) );
+				if ( length > 1.0e-6f )
+				{
+					for ( unsigned int j = 0; j < 4; ++j )
+					{
+						rotation[j] /= length;
+					}
+				}
+				else
+				{
+					wereThereErrors = true;
+				}
+			}
+		}
+		if ( wereThereErrors )
+		{
+			std::ostringstream errorMessage;
+			errorMessage << "Bone " << ( i_boneIndex + 1 ) << "'s \"" << i_key << "\" must be a table of keys that each have "
+				<< i_componentCount << " numbers" << ( ( i_componentCount == 4 ) ? " (and that aren't all 0)" : "" );
+			eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+		}
+		lua_pop( &io_luaState, 1 );
+		return !wereThereErrors;
+	}
+
+	void Interpolate( const float* const i_a, const float* const i_b, const float i_t, const unsigned int i_componentCount, float* const o_value )
+	{
+		// This must match how the runtime interpolates between keys
+		if ( i_componentCount == 4 )
+		{
+			eae6320::Animation::BlendRotations( i_a, i_b, i_t, o_value );
+		}
+		else
+		{
+			for ( unsigned int i = 0; i < i_componentCount; ++i )
+			{
+				o_value[i] = i_a[i] + ( ( i_b[i] - i_a[i] ) * i_t );
+			}
+		}
+	}
+
+	float CalculateError( const float* const i_a, const float* const i_b, const unsigned int i_componentCount )
+	{
+		if ( i_componentCount == 4 )
+		{
+			// q and -q are the same rotation
+			double dot = 0.0;
+			for ( unsigned int i = 0; i < 4; ++i )
+			{
+				dot += static_cast<double>( i_a[i] ) * static_cast<double>( i_b[i] );
+			}
+			dot = std::fabs( dot );
+			return static_cast<float>( 2.0 * std::acos( ( dot < 1.0 ) ? dot : 1.0 ) );
+		}
+		else
+		{
+			double distanceSquared = 0.0;
+			for ( unsigned int i = 0; i < i_componentCount; ++i )
+			{
+				const double difference = static_cast<double>( i_a[i] ) - static_cast<double>( i_b[i] );
+				distanceSquared += difference * difference;
+			}
+			return static_cast<float>( std::sqrt( distanceSquared ) );
+		}
+	}
+
+	void ReduceKeys( const float* const i_values_raw, const float* const i_values_quantized, const unsigned int i_componentCount,
+		const unsigned int i_frameCount, const float i_tolerance, std::vector<uint8_t>& o_keyFrames )
+	{
+		// The block's ends are always keys,
+		// and then the frame with the worst error is made a key until every frame is close enough
+		// (the error is measured against the quantized keys because those are what the runtime will interpolate)
+		std::vector<bool> isKey( i_frameCount, false );
+		isKey[0] = isKey[i_frameCount - 1] = true;
+		for ( ;; )
+		{
+			float maxError = i_tolerance;
+			unsigned int worstFrame = 0;
+			for ( unsigned int key_a = 0; key_a < ( i_frameCount - 1 ); )
+			{
+				unsigned int key_b = key_a + 1;
+				while ( !isKey[key_b] )
+				{
+					++key_b;
+				}
+				for ( unsigned int f = key_a + 1; f < key_b; ++f )
+				{
+					const float t = static_cast<float>( f - key_a ) / static_cast<float>( key_b - key_a );
+					float value[4];
+					Interpolate( i_values_quantized + ( key_a * i_componentCount ), i_values_quantized + ( key_b * i_componentCount ), t,
+						i_componentCount, value );
+					const float error = CalculateError( value, i_values_raw + ( f * i_componentCount ), i_componentCount );
+					if ( error > maxError )
+					{
+						maxError = error;
+						worstFrame = f;
+					}
+				}
+				key_a = key_b;
+			}
+			if ( worstFrame == 0 )
+			{
+				break;
+			}
+			isKey[worstFrame] = true;
+		}
+		o_keyFrames.clear();
+		for ( unsigned int f = 0; f < i_frameCount; ++f )
+		{
+			if ( isKey[f] )
+			{
+				o_keyFrames.push_back( static_cast<uint8_t>( f ) );
+			}
+		}
+	}
+
+	void AppendTrack( const std::vector<uint8_t>& i_keyFrames, const void* const i_values, const size_t i_valueSize, std::vector<uint8_t>& io_block )
+	{
+		io_block.push_back( static_cast<uint8_t>( i_keyFrames.size() ) );
+		io_block.insert( io_block.end(), i_keyFrames.begin(), i_keyFrames.end() );
+		if ( ( io_block.size() % 2 ) != 0 )
+		{
+			io_block.push_back( 0 );
+		}
+		// The values are for every frame in the block, and only the keys are kept
+		const uint8_t* const values = reinterpret_cast<const uint8_t*>( i_values );
+		for ( std::vector<uint8_t>::const_iterator i = i_keyFrames.begin(); i != i_keyFrames.end(); ++i )
+		{
+			io_block.insert( io_block.end(), values + ( *i * i_valueSize ), values + ( ( *i + 1 ) * i_valueSize ) );
+		}
+	}
+}
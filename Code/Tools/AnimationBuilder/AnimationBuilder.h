@@ -0,0 +1,50 @@
+/*
+	The AnimationBuilder compresses an animation clip into the format that is described in Animation/AnimationFormats.h
+
+	An authored animation clip is a Lua file that returns a table like this:
+		return
+		{
+			-- How many keys there are every second
+			keysPerSecond = 30,
+			-- Every bone in the skeleton (in the same order) has a rotation track and a translation track,
+			-- which are either a key for every frame or a single key if the track doesn't change.
+			-- Rotations are quaternions (x,y,z,w) and both are relative to the bone's parent.
+			-- The clip loops, and so the last frame blends back into the first.
+			bones =
+			{
+				{
+					rotations = { { 0, 0, 0, 1 }, { 0, 0, 0.0871557, 0.9961947 }, ... },
+					translations = { { 0.1, 0, 0 } },
+				},
+				...
+			},
+			-- These are optional:
+			-- How far a sampled rotation can be from the authored one (in degrees)
+			maxRotationError = 0.1,
+			-- How far a sampled translation can be from the authored one
+			maxTranslationError = 0.0001,
+			-- How many frames are in each block of keys
+			blockKeyCount = 16,
+		}
+
+	Keys are removed wherever interpolating between the (quantized) keys on either side stays within the error tolerances.
+	The tolerances are for each bone relative to its parent,
+	and so a long chain of bones should use tighter ones.
+	The builder samples the built clip with the runtime's AnimationClip to report its actual error and how fast it is.
+*/
+
+#ifndef EAE6320_ANIMATIONBUILDER_H
+#define EAE6320_ANIMATIONBUILDER_H
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace AnimationBuilder
+	{
+		bool Build( const char* const i_path_source, const char* const i_path_target );
+	}
+}
+
+#endif	// EAE6320_ANIMATIONBUILDER_H
@@ -0,0 +1,854 @@
+// Header Files
+//=============
+
+#include "BlockCompression.h"
+
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+#include <thread>
+#include <vector>
+#include "../../Engine/Asserts/Asserts.h"
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// How much of endpoint 0 is in each palette entry
+	// (the entries are in the order of the indices that are stored in the block)
+	const float s_bc1Weights[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+	const float s_bc4Weights[8] = { 1.0f, 0.0f, 6.0f / 7.0f, 5.0f / 7.0f, 4.0f / 7.0f, 3.0f / 7.0f, 2.0f / 7.0f, 1.0f / 7.0f };
+	// BC7 interpolates with integer weights out of 64
+	const int s_bc7IndexWeights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+	float s_bc7Weights[16];
+	bool s_areBc7WeightsInitialized = false;
+
+	// A PSNR is infinite when there is no error,
+	// and so a finite value that is higher than any lossy result is reported instead
+	// (this allows results to be averaged)
+	const double s_losslessPeakSignalToNoiseRatio = 100.0;
+
+	// How many times the High quality preset refits the endpoints to the indices
+	const unsigned int s_refinementIterationCount = 2;
+}
+
+// Helper Class Declarations
+//==========================
+
+namespace
+{
+	// A block with each channel stored contiguously
+	// so that 4 pixels of a channel can be loaded at once
+	struct sBlock
+	{
+		float channels[4][16];
+		// Partial blocks at the right and bottom edges are padded by repeating the last pixel,
+		// and the padding has a weight of 0 so that it doesn't count towards the error
+		float pixelWeights[16];
+	};
+
+	// Blocks are written starting at the least significant bit of the first byte
+	class cBitWriter
+	{
+	public:
+
+		void Write( const uint32_t i_value, const unsigned int i_bitCount )
+		{
+			for ( unsigned int i = 0; i < i_bitCount; ++i )
+			{
+				if ( ( i_value >> i ) & 1 )
+				{
+					m_output[m_position / 8] |= static_cast<uint8_t>( 1u << ( m_position % 8 ) );
+				}
+				++m_position;
+			}
+		}
+
+		cBitWriter( uint8_t* const o_output, const size_t i_byteCount ) : m_output( o_output ), m_position( 0 )
+		{
+			memset( o_output, 0, i_byteCount );
+		}
+
+	private:
+
+		uint8_t* m_output;
+		unsigned int m_position;
+	};
+
+	struct sCompressionJob
+	{
+		eae6320::AssetBuild::BlockCompression::eFormat::eFormat format;
+		eae6320::AssetBuild::BlockCompression::eQuality::eQuality quality;
+		const uint8_t* pixels;
+		unsigned int width, height;
+		uint8_t* blocks;
+		unsigned int blockCountX, blockCountY;
+		unsigned int bytesPerBlock;
+		// Each thread claims the next row of blocks that hasn't been compressed yet
+		std::atomic<unsigned int> nextBlockRow;
+	};
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void CompressBlockRows( sCompressionJob* const io_job, double* const o_squaredError );
+	void LoadBlock( const sCompressionJob& i_job, const unsigned int i_blockX, const unsigned int i_blockY, sBlock& o_block );
+
+	// Each of these returns the squared error of the encoded block
+	// (the error of every pixel is multiplied by its weight)
+	float EncodeBc1Block( const float* const* const i_channels, const float i_pixelWeights[16],
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality, uint8_t o_output[8] );
+	float EncodeBc1BlockWithEndpoints( const float* const* const i_channels, const float i_pixelWeights[16],
+		const float i_endpoint0[4], const float i_endpoint1[4], uint8_t o_indices[16], uint8_t o_output[8] );
+	float EncodeBc4Block( const float* const i_values, const float i_pixelWeights[16],
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality, uint8_t o_output[8] );
+	float EncodeBc4BlockWithEndpoints( const float* const i_values, const float i_pixelWeights[16],
+		const int i_endpoint0, const int i_endpoint1, uint8_t o_indices[16], uint8_t o_output[8] );
+	float EncodeBc7Block( const float* const* const i_channels, const float i_pixelWeights[16],
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality, uint8_t o_output[16] );
+	float EncodeBc7BlockWithEndpoints( const float* const* const i_channels, const float i_pixelWeights[16],
+		const float i_endpoint0[4], const float i_endpoint1[4], uint8_t o_indices[16], uint8_t o_output[16] );
+
+	void FindEndpoints( const float* const* const i_channels, const unsigned int i_channelCount,
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality, float o_endpoint0[4], float o_endpoint1[4] );
+	// Finds the endpoints that best fit the given indices in a least-squares sense
+	bool RefineEndpoints( const float* const* const i_channels, const unsigned int i_channelCount,
+		const uint8_t i_indices[16], const float* const i_weights, float o_endpoint0[4], float o_endpoint1[4] );
+	// Chooses the closest palette entry for every pixel and returns the total weighted squared error
+	float SelectIndices( const float* const* const i_channels, const float i_pixelWeights[16], const unsigned int i_channelCount,
+		const float ( * const i_palette )[4], const unsigned int i_paletteCount, uint8_t o_indices[16] );
+
+	uint16_t PackRgb565( const float i_rgb[3] );
+	void UnpackRgb565( const uint16_t i_color, float o_rgb[3] );
+	int Clamp( const int i_value, const int i_min, const int i_max );
+	unsigned int GetChannelCount( const eae6320::AssetBuild::BlockCompression::eFormat::eFormat i_format );
+	unsigned int GetBytesPerBlock( const eae6320::AssetBuild::BlockCompression::eFormat::eFormat i_format );
+}
+
+// Interface
+//==========
+
+void eae6320::AssetBuild::BlockCompression::Compress( const eFormat::eFormat i_format, const eQuality::eQuality i_quality,
+	const uint8_t* const i_pixels, const unsigned int i_width, const unsigned int i_height,
+	uint8_t* const o_blocks, sStats* const o_stats )
+{
+	const std::chrono::high_resolution_clock::time_point time_start = std::chrono::high_resolution_clock::now();
+
+	if ( !s_areBc7WeightsInitialized )
+	{
+		for ( unsigned int i = 0; i < 16; ++i )
+		{
+			s_bc7Weights[i] = static_cast<float>( 64 - s_bc7IndexWeights[i] ) / 64.0f;
+		}
+		s_areBc7WeightsInitialized = true;
+	}
+
+	sCompressionJob job;
+	{
+		job.format = i_format;
+		job.quality = i_quality;
+		job.pixels = i_pixels;
+		job.width = i_width;
+		job.height = i_height;
+		job.blocks = o_blocks;
+		job.blockCountX = ( i_width + 3 ) / 4;
+		job.blockCountY = ( i_height + 3 ) / 4;
+		job.bytesPerBlock = GetBytesPerBlock( i_format );
+		job.nextBlockRow = 0;
+	}
+
+	// Every core compresses rows of blocks until there are none left
+	// (the calling thread does its share instead of waiting)
+	double squaredError = 0.0;
+	{
+		unsigned int threadCount = std::thread::hardware_concurrency();
+		threadCount = ( threadCount > 0 ) ? threadCount : 1;
+		threadCount = ( threadCount < job.blockCountY ) ? threadCount : job.blockCountY;
+		threadCount = ( threadCount > 0 ) ? threadCount : 1;
+		std::vector<double> squaredErrors( threadCount, 0.0 );
+		std::vector<std::thread> threads;
+		threads.reserve( threadCount - 1 );
+		for ( unsigned int i = 1; i < threadCount; ++i )
+		{
+			threads.push_back( std::thread( CompressBlockRows, &job, &squaredErrors[i] ) );
+		}
+		CompressBlockRows( &job, &squaredErrors[0] );
+		for ( size_t i = 0; i < threads.size(); ++i )
+		{
+			threads[i].join();
+		}
+		for ( size_t i = 0; i < squaredErrors.size(); ++i )
+		{
+			squaredError += squaredErrors[i];
+		}
+	}
+
+	if ( o_stats )
+	{
+		o_stats->secondCount = std::chrono::duration<double>( std::chrono::high_resolution_clock::now() - time_start ).count();
+		o_stats->megapixelsPerSecond = ( static_cast<double>( i_width ) * i_height / 1000000.0 )
+			/ ( ( o_stats->secondCount > 0.0 ) ? o_stats->secondCount : DBL_MIN );
+		// The padding in partial blocks isn't included in the error,
+		// and so it is averaged over the source pixels
+		const double sampleCount = static_cast<double>( i_width ) * i_height * GetChannelCount( i_format );
+		const double meanSquaredError = squaredError / sampleCount;
+		o_stats->peakSignalToNoiseRatio = ( meanSquaredError > 0.0 ) ?
+			( 10.0 * std::log10( ( 255.0 * 255.0 ) / meanSquaredError ) ) : s_losslessPeakSignalToNoiseRatio;
+	}
+}
+
+size_t eae6320::AssetBuild::BlockCompression::CalculateCompressedSize( const eFormat::eFormat i_format, const unsigned int i_width, const unsigned int i_height )
+{
+	return static_cast<size_t>( ( i_width + 3 ) / 4 ) * ( ( i_height + 3 ) / 4 ) * GetBytesPerBlock( i_format );
+}
+
+const char* eae6320::AssetBuild::BlockCompression::GetFormatName( const eFormat::eFormat i_format )
+{
+	switch ( i_format )
+	{
+	case eFormat::BC1: return "BC1";
+	case eFormat::BC3: return "BC3";
+	case eFormat::BC4: return "BC4";
+	case eFormat::BC5: return "BC5";
+	case eFormat::BC7: return "BC7";
+	default:
+		EAE6320_ASSERTF( false, "Invalid block compression format %u", static_cast<unsigned int>( i_format ) );
+	}
+	return "Unknown";
+}
+
+const char* eae6320::AssetBuild::BlockCompression::GetQualityName( const eQuality::eQuality i_quality )
+{
+	switch ( i_quality )
+	{
+	case eQuality::Fast: return "Fast";
+	case eQuality::Normal: return "Normal";
+	case eQuality::High: return "High";
+	default:
+		EAE6320_ASSERTF( false, "Invalid block compression quality %u", static_cast<unsigned int>( i_quality ) );
+	}
+	return "Unknown";
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void CompressBlockRows( sCompressionJob* const io_job, double* const o_squaredError )
+	{
+		namespace eFormat = eae6320::AssetBuild::BlockCompression::eFormat;
+
+		double squaredError = 0.0;
+		sBlock block;
+		const float* const channels[4] = { block.channels[0], block.channels[1], block.channels[2], block.channels[3] };
+		for ( unsigned int blockY = io_job->nextBlockRow++; blockY < io_job->blockCountY; blockY = io_job->nextBlockRow++ )
+		{
+			uint8_t* output = io_job->blocks + ( static_cast<size_t>( blockY ) * io_job->blockCountX * io_job->bytesPerBlock );
+			for ( unsigned int blockX = 0; blockX < io_job->blockCountX; ++blockX, output += io_job->bytesPerBlock )
+			{
+				LoadBlock( *io_job, blockX, blockY, block );
+				switch ( io_job->format )
+				{
+				case eFormat::BC1:
+					squaredError += EncodeBc1Block( channels, block.pixelWeights, io_job->quality, output );
+					break;
+				case eFormat::BC3:
+					squaredError += EncodeBc4Block( channels[3], block.pixelWeights, io_job->quality, output );
+					squaredError += EncodeBc1Block( channels, block.pixelWeights, io_job->quality, output + 8 );
+					break;
+				case eFormat::BC4:
+					squaredError += EncodeBc4Block( channels[0], block.pixelWeights, io_job->quality, output );
+					break;
+				case eFormat::BC5:
+					squaredError += EncodeBc4Block( channels[0], block.pixelWeights, io_job->quality, output );
+					squaredError += EncodeBc4Block( channels[1], block.pixelWeights, io_job->quality, output + 8 );
+					break;
+				case eFormat::BC7:
+					squaredError += EncodeBc7Block( channels, block.pixelWeights, io_job->quality, output );
+					break;
+				default:
+					EAE6320_ASSERTF( false, "Invalid block compression format %u", static_cast<unsigned int>( io_job->format ) );
+				}
+			}
+		}
+		*o_squaredError = squaredError;
+	}
+
+	void LoadBlock( const sCompressionJob& i_job, const unsigned int i_blockX, const unsigned int i_blockY, sBlock& o_block )
+	{
+		for ( unsigned int y = 0; y < 4; ++y )
+		{
+			unsigned int sourceY = ( i_blockY * 4 ) + y;
+			const bool isRowInImage = sourceY < i_job.height;
+			sourceY = isRowInImage ? sourceY : ( i_job.height - 1 );
+			for ( unsigned int x = 0; x < 4; ++x )
+			{
+				unsigned int sourceX = ( i_blockX * 4 ) + x;
+				const bool isInImage = isRowInImage && ( sourceX < i_job.width );
+				sourceX = ( sourceX < i_job.width ) ? sourceX : ( i_job.width - 1 );
+				o_block.pixelWeights[( y * 4 ) + x] = isInImage ? 1.0f : 0.0f;
+				const uint8_t* const pixel = i_job.pixels + ( ( ( static_cast<size_t>( sourceY ) * i_job.width ) + sourceX ) * 4 );
+				for ( unsigned int c = 0; c < 4; ++c )
+				{
+					o_block.channels[c][( y * 4 ) + x] = static_cast<float>( pixel[c] );
+				}
+			}
+		}
+	}
+
+	// BC1
+	//----
+
+	float EncodeBc1Block( const float* const* const i_channels, const float i_pixelWeights[16],
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality, uint8_t o_output[8] )
+	{
+		float endpoint0[4], endpoint1[4];
+		FindEndpoints( i_channels, 3, i_quality, endpoint0, endpoint1 );
+		uint8_t indices[16];
+		float bestError = EncodeBc1BlockWithEndpoints( i_channels, i_pixelWeights, endpoint0, endpoint1, indices, o_output );
+		if ( i_quality == eae6320::AssetBuild::BlockCompression::eQuality::High )
+		{
+			for ( unsigned int i = 0; ( i < s_refinementIterationCount ) && ( bestError > 0.0f ); ++i )
+			{
+				if ( !RefineEndpoints( i_channels, 3, indices, s_bc1Weights, endpoint0, endpoint1 ) )
+				{
+					break;
+				}
+				uint8_t refinedIndices[16];
+				uint8_t refinedOutput[8];
+				const float error = EncodeBc1BlockWithEndpoints( i_channels, i_pixelWeights, endpoint0, endpoint1, refinedIndices, refinedOutput );
+				if ( error >= bestError )
+				{
+					break;
+				}
+				bestError = error;
+				memcpy( indices, refinedIndices, sizeof( indices ) );
+				memcpy( o_output, refinedOutput, sizeof( refinedOutput ) );
+			}
+		}
+		return bestError;
+	}
+
+	float EncodeBc1BlockWithEndpoints( const float* const* const i_channels, const float i_pixelWeights[16],
+		const float i_endpoint0[4], const float i_endpoint1[4], uint8_t o_indices[16], uint8_t o_output[8] )
+	{
+		uint16_t color0 = PackRgb565( i_endpoint0 );
+		uint16_t color1 = PackRgb565( i_endpoint1 );
+		// The 4 color mode is only used when color0 > color1
+		if ( color0 < color1 )
+		{
+			const uint16_t temp = color0;
+			color0 = color1;
+			color1 = temp;
+		}
+
+		float palette[4][4];
+		UnpackRgb565( color0, palette[0] );
+		UnpackRgb565( color1, palette[1] );
+		for ( unsigned int c = 0; c < 3; ++c )
+		{
+			palette[2][c] = ( ( 2.0f * palette[0][c] ) + palette[1][c] ) / 3.0f;
+			palette[3][c] = ( palette[0][c] + ( 2.0f * palette[1][c] ) ) / 3.0f;
+		}
+		// If the endpoints are the same then every pixel uses index 0
+		const unsigned int paletteCount = ( color0 != color1 ) ? 4 : 1;
+		const float error = SelectIndices( i_channels, i_pixelWeights, 3, palette, paletteCount, o_indices );
+
+		uint32_t packedIndices = 0;
+		for ( unsigned int i = 0; i < 16; ++i )
+		{
+			packedIndices |= static_cast<uint32_t>( o_indices[i] ) << ( i * 2 );
+		}
+		o_output[0] = static_cast<uint8_t>( color0 & 0xff );
+		o_output[1] = static_cast<uint8_t>( color0 >> 8 );
+		o_output[2] = static_cast<uint8_t>( color1 & 0xff );
+		o_output[3] = static_cast<uint8_t>( color1 >> 8 );
+		for ( unsigned int i = 0; i < 4; ++i )
+		{
+			o_output[4 + i] = static_cast<uint8_t>( ( packedIndices >> ( i * 8 ) ) & 0xff );
+		}
+		return error;
+	}
+
+	// BC4 (also used for the alpha of BC3 and both channels of BC5)
+	//----
+
+	float EncodeBc4Block( const float* const i_values, const float i_pixelWeights[16],
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality, uint8_t o_output[8] )
+	{
+		namespace eQuality = eae6320::AssetBuild::BlockCompression::eQuality;
+
+		// The exact extremes are used (rather than an inset bounding box)
+		// so that fully transparent and fully opaque pixels stay exact
+		int minValue = 255, maxValue = 0;
+		for ( unsigned int i = 0; i < 16; ++i )
+		{
+			const int value = static_cast<int>( i_values[i] );
+			minValue = ( value < minValue ) ? value : minValue;
+			maxValue = ( value > maxValue ) ? value : maxValue;
+		}
+		const float* const channels[1] = { i_values };
+		float endpoint0[4] = { static_cast<float>( maxValue ) };
+		float endpoint1[4] = { static_cast<float>( minValue ) };
+
+		// The 8 value mode is used when endpoint0 > endpoint1
+		uint8_t indices[16];
+		float bestError = EncodeBc4BlockWithEndpoints( i_values, i_pixelWeights, maxValue, minValue, indices, o_output );
+		if ( ( i_quality == eQuality::Fast ) || ( bestError <= 0.0f ) )
+		{
+			return bestError;
+		}
+
+		uint8_t candidateIndices[16];
+		uint8_t candidateOutput[8];
+		// The 6 value mode has explicit 0 and 255 entries,
+		// and so blocks with both extremes can spend the interpolated values on the rest
+		{
+			int innerMin = 255, innerMax = 0;
+			for ( unsigned int i = 0; i < 16; ++i )
+			{
+				const int value = static_cast<int>( i_values[i] );
+				if ( ( value > 0 ) && ( value < 255 ) )
+				{
+					innerMin = ( value < innerMin ) ? value : innerMin;
+					innerMax = ( value > innerMax ) ? value : innerMax;
+				}
+			}
+			if ( ( innerMin <= innerMax ) && ( ( minValue == 0 ) || ( maxValue == 255 ) ) )
+			{
+				const float error = EncodeBc4BlockWithEndpoints( i_values, i_pixelWeights, innerMin, innerMax, candidateIndices, candidateOutput );
+				if ( error < bestError )
+				{
+					bestError = error;
+					memcpy( o_output, candidateOutput, sizeof( candidateOutput ) );
+				}
+			}
+		}
+		// Refit the 8 value endpoints to the chosen indices
+		if ( i_quality == eQuality::High )
+		{
+			for ( unsigned int i = 0; ( i < s_refinementIterationCount ) && ( bestError > 0.0f ); ++i )
+			{
+				if ( !RefineEndpoints( channels, 1, indices, s_bc4Weights, endpoint0, endpoint1 ) )
+				{
+					break;
+				}
+				const int refinedMax = Clamp( static_cast<int>( endpoint0[0] + 0.5f ), 0, 255 );
+				const int refinedMin = Clamp( static_cast<int>( endpoint1[0] + 0.5f ), 0, 255 );
+				if ( refinedMax <= refinedMin )
+				{
+					break;
+				}
+				const float error = EncodeBc4BlockWithEndpoints( i_values, i_pixelWeights, refinedMax, refinedMin, candidateIndices, candidateOutput );
+				if ( error >= bestError )
+				{
+					break;
+				}
+				bestError = error;
+				memcpy( indices, candidateIndices, sizeof( indices ) );
+				memcpy( o_output, candidateOutput, sizeof( candidateOutput ) );
+			}
+		}
+		return bestError;
+	}
+
+	float EncodeBc4BlockWithEndpoints( const float* const i_values, const float i_pixelWeights[16],
+		const int i_endpoint0, const int i_endpoint1, uint8_t o_indices[16], uint8_t o_output[8] )
+	{
+		float palette[8][4];
+		palette[0][0] = static_cast<float>( i_endpoint0 );
+		palette[1][0] = static_cast<float>( i_endpoint1 );
+		if ( i_endpoint0 > i_endpoint1 )
+		{
+			for ( unsigned int i = 2; i < 8; ++i )
+			{
+				palette[i][0] = ( s_bc4Weights[i] * palette[0][0] ) + ( ( 1.0f - s_bc4Weights[i] ) * palette[1][0] );
+			}
+		}
+		else
+		{
+			for ( unsigned int i = 2; i < 6; ++i )
+			{
+				palette[i][0] = ( ( static_cast<float>( 6 - i ) * palette[0][0] ) + ( static_cast<float>( i - 1 ) * palette[1][0] ) ) / 5.0f;
+			}
+			palette[6][0] = 0.0f;
+			palette[7][0] = 255.0f;
+		}
+		const float* const channels[1] = { i_values };
+		const float error = SelectIndices( channels, i_pixelWeights, 1, palette, 8, o_indices );
+
+		uint64_t packedIndices = 0;
+		for ( unsigned int i = 0; i < 16; ++i )
+		{
+			packedIndices |= static_cast<uint64_t>( o_indices[i] ) << ( i * 3 );
+		}
+		o_output[0] = static_cast<uint8_t>( i_endpoint0 );
+		o_output[1] = static_cast<uint8_t>( i_endpoint1 );
+		for ( unsigned int i = 0; i < 6; ++i )
+		{
+			o_output[2 + i] = static_cast<uint8_t>( ( packedIndices >> ( i * 8 ) ) & 0xff );
+		}
+		return error;
+	}
+
+	// BC7 (mode 6)
+	//----
+
+	float EncodeBc7Block( const float* const* const i_channels, const float i_pixelWeights[16],
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality, uint8_t o_output[16] )
+	{
+		float endpoint0[4], endpoint1[4];
+		FindEndpoints( i_channels, 4, i_quality, endpoint0, endpoint1 );
+		uint8_t indices[16];
+		float bestError = EncodeBc7BlockWithEndpoints( i_channels, i_pixelWeights, endpoint0, endpoint1, indices, o_output );
+		if ( i_quality == eae6320::AssetBuild::BlockCompression::eQuality::High )
+		{
+			for ( unsigned int i = 0; ( i < s_refinementIterationCount ) && ( bestError > 0.0f ); ++i )
+			{
+				if ( !RefineEndpoints( i_channels, 4, indices, s_bc7Weights, endpoint0, endpoint1 ) )
+				{
+					break;
+				}
+				uint8_t refinedIndices[16];
+				uint8_t refinedOutput[16];
+				const float error = EncodeBc7BlockWithEndpoints( i_channels, i_pixelWeights, endpoint0, endpoint1, refinedIndices, refinedOutput );
+				if ( error >= bestError )
+				{
+					break;
+				}
+				bestError = error;
+				memcpy( indices, refinedIndices, sizeof( indices ) );
+				memcpy( o_output, refinedOutput, sizeof( refinedOutput ) );
+			}
+		}
+		return bestError;
+	}
+
+	float EncodeBc7BlockWithEndpoints( const float* const* const i_channels, const float i_pixelWeights[16],
+		const float i_endpoint0[4], const float i_endpoint1[4], uint8_t o_indices[16], uint8_t o_output[16] )
+	{
+		// Mode 6 endpoints are 7 bits per channel plus a shared least significant "p-bit" per endpoint,
+		// and so every combination of p-bits is tried
+		float bestError = FLT_MAX;
+		int bestQuantized[2][4] = { { 0 } };
+		int bestPBits[2] = { 0, 0 };
+		for ( int pBit0 = 0; pBit0 < 2; ++pBit0 )
+		{
+			for ( int pBit1 = 0; pBit1 < 2; ++pBit1 )
+			{
+				int quantized[2][4];
+				int values[2][4];
+				for ( unsigned int c = 0; c < 4; ++c )
+				{
+					quantized[0][c] = Clamp( static_cast<int>( std::floor( ( ( i_endpoint0[c] - pBit0 ) * 0.5f ) + 0.5f ) ), 0, 127 );
+					quantized[1][c] = Clamp( static_cast<int>( std::floor( ( ( i_endpoint1[c] - pBit1 ) * 0.5f ) + 0.5f ) ), 0, 127 );
+					values[0][c] = ( quantized[0][c] << 1 ) | pBit0;
+					values[1][c] = ( quantized[1][c] << 1 ) | pBit1;
+				}
+				float palette[16][4];
+				for ( unsigned int i = 0; i < 16; ++i )
+				{
+					for ( unsigned int c = 0; c < 4; ++c )
+					{
+						palette[i][c] = static_cast<float>(
+							( ( ( 64 - s_bc7IndexWeights[i] ) * values[0][c] ) + ( s_bc7IndexWeights[i] * values[1][c] ) + 32 ) >> 6 );
+					}
+				}
+				uint8_t indices[16];
+				const float error = SelectIndices( i_channels, i_pixelWeights, 4, palette, 16, indices );
+				if ( error < bestError )
+				{
+					bestError = error;
+					memcpy( bestQuantized, quantized, sizeof( quantized ) );
+					bestPBits[0] = pBit0;
+					bestPBits[1] = pBit1;
+					memcpy( o_indices, indices, 16 );
+				}
+			}
+		}
+		// The most significant bit of the first index isn't stored and is implicitly 0,
+		// and so if it would be set the endpoints are swapped instead
+		if ( o_indices[0] & 0x8 )
+		{
+			for ( unsigned int c = 0; c < 4; ++c )
+			{
+				const int temp = bestQuantized[0][c];
+				bestQuantized[0][c] = bestQuantized[1][c];
+				bestQuantized[1][c] = temp;
+			}
+			const int temp = bestPBits[0];
+			bestPBits[0] = bestPBits[1];
+			bestPBits[1] = temp;
+			for ( unsigned int i = 0; i < 16; ++i )
+			{
+				o_indices[i] = static_cast<uint8_t>( 15 - o_indices[i] );
+			}
+		}
+
+		cBitWriter writer( o_output, 16 );
+		// Mode 6 is identified by 6 zero bits followed by a one
+		writer.Write( 1u << 6, 7 );
+		for ( unsigned int c = 0; c < 4; ++c )
+		{
+			writer.Write( static_cast<uint32_t>( bestQuantized[0][c] ), 7 );
+			writer.Write( static_cast<uint32_t>( bestQuantized[1][c] ), 7 );
+		}
+		writer.Write( static_cast<uint32_t>( bestPBits[0] ), 1 );
+		writer.Write( static_cast<uint32_t>( bestPBits[1] ), 1 );
+		writer.Write( o_indices[0], 3 );
+		for ( unsigned int i = 1; i < 16; ++i )
+		{
+			writer.Write( o_indices[i], 4 );
+		}
+		return bestError;
+	}
+
+	// Endpoints
+	//----------
+
+	void FindEndpoints( const float* const* const i_channels, const unsigned int i_channelCount,
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality, float o_endpoint0[4], float o_endpoint1[4] )
+	{
+		float minValues[4] = { 255.0f, 255.0f, 255.0f, 255.0f };
+		float maxValues[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float means[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for ( unsigned int c = 0; c < i_channelCount; ++c )
+		{
+			for ( unsigned int i = 0; i < 16; ++i )
+			{
+				const float value = i_channels[c][i];
+				minValues[c] = ( value < minValues[c] ) ? value : minValues[c];
+				maxValues[c] = ( value > maxValues[c] ) ? value : maxValues[c];
+				means[c] += value;
+			}
+			means[c] /= 16.0f;
+		}
+
+		// The bounding box is used for the Fast preset
+		// and as a fallback if the block has no dominant direction
+		for ( unsigned int c = 0; c < 4; ++c )
+		{
+			// Insetting slightly makes the interpolated values cover the interior better
+			const float inset = ( c < i_channelCount ) ? ( ( maxValues[c] - minValues[c] ) / 16.0f ) : 0.0f;
+			o_endpoint0[c] = ( c < i_channelCount ) ? ( maxValues[c] - inset ) : 255.0f;
+			o_endpoint1[c] = ( c < i_channelCount ) ? ( minValues[c] + inset ) : 255.0f;
+		}
+		if ( ( i_quality == eae6320::AssetBuild::BlockCompression::eQuality::Fast ) || ( i_channelCount == 1 ) )
+		{
+			return;
+		}
+
+		// Find the principal axis of the colors
+		// (the eigenvector of the covariance matrix with the largest eigenvalue)
+		// using a few steps of power iteration
+		float covariance[4][4] = { { 0.0f } };
+		for ( unsigned int i = 0; i < 16; ++i )
+		{
+			float offset[4];
+			for ( unsigned int c = 0; c < i_channelCount; ++c )
+			{
+				offset[c] = i_channels[c][i] - means[c];
+			}
+			for ( unsigned int row = 0; row < i_channelCount; ++row )
+			{
+				for ( unsigned int column = 0; column < i_channelCount; ++column )
+				{
+					covariance[row][column] += offset[row] * offset[column];
+				}
+			}
+		}
+		float axis[4];
+		for ( unsigned int c = 0; c < 4; ++c )
+		{
+			axis[c] = ( c < i_channelCount ) ? ( maxValues[c] - minValues[c] ) : 0.0f;
+		}
+		const unsigned int iterationCount = 8;
+		for ( unsigned int iteration = 0; iteration < iterationCount; ++iteration )
+		{
+			float product[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float largest = 0.0f;
+			for ( unsigned int row = 0; row < i_channelCount; ++row )
+			{
+				for ( unsigned int column = 0; column < i_channelCount; ++column )
+				{
+					product[row] += covariance[row][column] * axis[column];
+				}
+				largest = ( std::fabs( product[row] ) > largest ) ? std::fabs( product[row] ) : largest;
+			}
+			if ( largest < FLT_EPSILON )
+			{
+				// Every pixel is the same (or close enough)
+				return;
+			}
+			for ( unsigned int c = 0; c < i_channelCount; ++c )
+			{
+				axis[c] = product[c] / largest;
+			}
+		}
+		float axisLengthSquared = 0.0f;
+		for ( unsigned int c = 0; c < i_channelCount; ++c )
+		{
+			axisLengthSquared += axis[c] * axis[c];
+		}
+		if ( axisLengthSquared < FLT_EPSILON )
+		{
+			return;
+		}
+
+		// The endpoints are the extremes of the pixels projected onto the axis
+		float minProjection = FLT_MAX, maxProjection = -FLT_MAX;
+		for ( unsigned int i = 0; i < 16; ++i )
+		{
+			float projection = 0.0f;
+			for ( unsigned int c = 0; c < i_channelCount; ++c )
+			{
+				projection += ( i_channels[c][i] - means[c] ) * axis[c];
+			}
+			projection /= axisLengthSquared;
+			minProjection = ( projection < minProjection ) ? projection : minProjection;
+			maxProjection = ( projection > maxProjection ) ? projection : maxProjection;
+		}
+		for ( unsigned int c = 0; c < i_channelCount; ++c )
+		{
+			const float endpoint0 = means[c] + ( axis[c] * maxProjection );
+			const float endpoint1 = means[c] + ( axis[c] * minProjection );
+			o_endpoint0[c] = ( endpoint0 < 0.0f ) ? 0.0f : ( ( endpoint0 > 255.0f ) ? 255.0f : endpoint0 );
+			o_endpoint1[c] = ( endpoint1 < 0.0f ) ? 0.0f : ( ( endpoint1 > 255.0f ) ? 255.0f : endpoint1 );
+		}
+	}
+
+	bool RefineEndpoints( const float* const* const i_channels, const unsigned int i_channelCount,
+		const uint8_t i_indices[16], const float* const i_weights, float o_endpoint0[4], float o_endpoint1[4] )
+	{
+		// Each pixel is approximated as ( w * endpoint0 ) + ( ( 1 - w ) * endpoint1 ),
+		// and so the best endpoints are the solution of a 2x2 linear system
+		float weight00 = 0.0f, weight01 = 0.0f, weight11 = 0.0f;
+		float weightedValues0[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float weightedValues1[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for ( unsigned int i = 0; i < 16; ++i )
+		{
+			const float weight0 = i_weights[i_indices[i]];
+			const float weight1 = 1.0f - weight0;
+			weight00 += weight0 * weight0;
+			weight01 += weight0 * weight1;
+			weight11 += weight1 * weight1;
+			for ( unsigned int c = 0; c < i_channelCount; ++c )
+			{
+				weightedValues0[c] += weight0 * i_channels[c][i];
+				weightedValues1[c] += weight1 * i_channels[c][i];
+			}
+		}
+		const float determinant = ( weight00 * weight11 ) - ( weight01 * weight01 );
+		if ( std::fabs( determinant ) < 1.0e-6f )
+		{
+			// Every pixel uses the same weight
+			return false;
+		}
+		const float determinantInverse = 1.0f / determinant;
+		for ( unsigned int c = 0; c < i_channelCount; ++c )
+		{
+			const float endpoint0 = ( ( weightedValues0[c] * weight11 ) - ( weightedValues1[c] * weight01 ) ) * determinantInverse;
+			const float endpoint1 = ( ( weightedValues1[c] * weight00 ) - ( weightedValues0[c] * weight01 ) ) * determinantInverse;
+			o_endpoint0[c] = ( endpoint0 < 0.0f ) ? 0.0f : ( ( endpoint0 > 255.0f ) ? 255.0f : endpoint0 );
+			o_endpoint1[c] = ( endpoint1 < 0.0f ) ? 0.0f : ( ( endpoint1 > 255.0f ) ? 255.0f : endpoint1 );
+		}
+		return true;
+	}
+
+	float SelectIndices( const float* const* const i_channels, const float i_pixelWeights[16], const unsigned int i_channelCount,
+		const float ( * const i_palette )[4], const unsigned int i_paletteCount, uint8_t o_indices[16] )
+	{
+		float totalError = 0.0f;
+		// Every palette entry is tested against 4 pixels at a time
+		for ( unsigned int group = 0; group < 4; ++group )
+		{
+			__m128 pixels[4];
+			for ( unsigned int c = 0; c < i_channelCount; ++c )
+			{
+				pixels[c] = _mm_loadu_ps( i_channels[c] + ( group * 4 ) );
+			}
+			__m128 bestErrors = _mm_set1_ps( FLT_MAX );
+			__m128 bestIndices = _mm_setzero_ps();
+			for ( unsigned int p = 0; p < i_paletteCount; ++p )
+			{
+				__m128 errors = _mm_setzero_ps();
+				for ( unsigned int c = 0; c < i_channelCount; ++c )
+				{
+					const __m128 difference = _mm_sub_ps( pixels[c], _mm_set1_ps( i_palette[p][c] ) );
+					errors = _mm_add_ps( errors, _mm_mul_ps( difference, difference ) );
+				}
+				const __m128 isBetter = _mm_cmplt_ps( errors, bestErrors );
+				bestErrors = _mm_min_ps( errors, bestErrors );
+				bestIndices = _mm_or_ps( _mm_andnot_ps( isBetter, bestIndices ), _mm_and_ps( isBetter, _mm_set1_ps( static_cast<float>( p ) ) ) );
+			}
+			const __m128i indices = _mm_cvttps_epi32( bestIndices );
+			int32_t indexValues[4];
+			float errorValues[4];
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( indexValues ), indices );
+			_mm_storeu_ps( errorValues, bestErrors );
+			for ( unsigned int i = 0; i < 4; ++i )
+			{
+				o_indices[( group * 4 ) + i] = static_cast<uint8_t>( indexValues[i] );
+				totalError += errorValues[i] * i_pixelWeights[( group * 4 ) + i];
+			}
+		}
+		return totalError;
+	}
+
+	// Utility
+	//--------
+
+	uint16_t PackRgb565( const float i_rgb[3] )
+	{
+		// Round to the nearest representable value
+		const int r = Clamp( static_cast<int>( ( i_rgb[0] * ( 31.0f / 255.0f ) ) + 0.5f ), 0, 31 );
+		const int g = Clamp( static_cast<int>( ( i_rgb[1] * ( 63.0f / 255.0f ) ) + 0.5f ), 0, 63 );
+		const int b = Clamp( static_cast<int>( ( i_rgb[2] * ( 31.0f / 255.0f ) ) + 0.5f ), 0, 31 );
+		return static_cast<uint16_t>( ( r << 11 ) | ( g << 5 ) | b );
+	}
+
+	void UnpackRgb565( const uint16_t i_color, float o_rgb[3] )
+	{
+		const int r = ( i_color >> 11 ) & 0x1f;
+		const int g = ( i_color >> 5 ) & 0x3f;
+		const int b = i_color & 0x1f;
+		o_rgb[0] = static_cast<float>( ( r << 3 ) | ( r >> 2 ) );
+		o_rgb[1] = static_cast<float>( ( g << 2 ) | ( g >> 4 ) );
+		o_rgb[2] = static_cast<float>( ( b << 3 ) | ( b >> 2 ) );
+	}
+
+	int Clamp( const int i_value, const int i_min, const int i_max )
+	{
+		return ( i_value < i_min ) ? i_min : ( ( i_value > i_max ) ? i_max : i_value );
+	}
+
+	unsigned int GetChannelCount( const eae6320::AssetBuild::BlockCompression::eFormat::eFormat i_format )
+	{
+		namespace eFormat = eae6320::AssetBuild::BlockCompression::eFormat;
+		switch ( i_format )
+		{
+		case eFormat::BC1: return 3;
+		case eFormat::BC3: return 4;
+		case eFormat::BC4: return 1;
+		case eFormat::BC5: return 2;
+		case eFormat::BC7: return 4;
+		default:
+			EAE6320_ASSERTF( false, "Invalid block compression format %u", static_cast<unsigned int>( i_format ) );
+		}
+		return 4;
+	}
+
+	unsigned int GetBytesPerBlock( const eae6320::AssetBuild::BlockCompression::eFormat::eFormat i_format )
+	{
+		namespace eFormat = eae6320::AssetBuild::BlockCompression::eFormat;
+		return ( ( i_format == eFormat::BC1 ) || ( i_format == eFormat::BC4 ) ) ? 8 : 16;
+	}
+}
@@ -0,0 +1,93 @@
+/*
+	These functions compress RGBA8 images into GPU block-compressed formats
+
+	Every format works on 4x4 blocks of pixels.
+	Images whose dimensions aren't multiples of 4 are handled
+	by repeating the last row/column of pixels into the partial blocks.
+
+	The rows of blocks are split between one thread per core,
+	and the inner loops that choose the best palette entry for each pixel
+	test 4 pixels at a time with SSE.
+*/
+
+#ifndef EAE6320_ASSETBUILD_BLOCKCOMPRESSION_H
+#define EAE6320_ASSETBUILD_BLOCKCOMPRESSION_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef NULL
+	#define NULL 0
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace AssetBuild
+	{
+		namespace BlockCompression
+		{
+			namespace eFormat
+			{
+				enum eFormat
+				{
+					// 8 bytes per block: RGB (the alpha channel is ignored)
+					BC1,
+					// 16 bytes per block: RGB with interpolated alpha
+					BC3,
+					// 8 bytes per block: R only
+					BC4,
+					// 16 bytes per block: R and G (e.g. tangent-space normals)
+					BC5,
+					// 16 bytes per block: RGBA
+					// (only mode 6 is used, which is fast to encode and good for smooth color and alpha)
+					BC7,
+
+					Count
+				};
+			}
+
+			namespace eQuality
+			{
+				enum eQuality
+				{
+					// Endpoints come from the bounding box of each block
+					Fast,
+					// Endpoints come from the principal axis of each block
+					Normal,
+					// Like Normal, but the endpoints are then refined to fit the chosen indices
+					High,
+
+					Count
+				};
+			}
+
+			struct sStats
+			{
+				// Measured against the source pixels in the channels that the format stores
+				// (a lossless result is reported as 100 dB)
+				double peakSignalToNoiseRatio;
+				double secondCount;
+				double megapixelsPerSecond;
+			};
+
+			// The pixels must be tightly-packed RGBA8 (4 bytes per pixel, red first).
+			// The output must have room for CalculateCompressedSize() bytes,
+			// and the blocks are stored in rows from the top left.
+			void Compress( const eFormat::eFormat i_format, const eQuality::eQuality i_quality,
+				const uint8_t* const i_pixels, const unsigned int i_width, const unsigned int i_height,
+				uint8_t* const o_blocks, sStats* const o_stats = NULL );
+
+			size_t CalculateCompressedSize( const eFormat::eFormat i_format, const unsigned int i_width, const unsigned int i_height );
+			const char* GetFormatName( const eFormat::eFormat i_format );
+			const char* GetQualityName( const eQuality::eQuality i_quality );
+		}
+	}
+}
+
+#endif	// EAE6320_ASSETBUILD_BLOCKCOMPRESSION_H
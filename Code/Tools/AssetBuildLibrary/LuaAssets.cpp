@@ -0,0 +1,130 @@
+// Header Files
+//=============
+
+#include "LuaAssets.h"
+
+#include <cmath>
+#include <sstream>
+#include "UtilityFunctions.h"
+
+// Interface
+//==========
+
+lua_State* eae6320::AssetBuild::LoadLuaAsset( const char* const i_path )
+{
+	lua_State* luaState = luaL_newstate();
+	if ( !luaState )
+	{
+		OutputErrorMessage( "Failed to create a new Lua state", i_path );
+		return NULL;
+	}
+
+	int result = luaL_loadfile( luaState, i_path );
+	if ( result == LUA_OK )
+	{
+		// Set the function's environment to an empty table
+		lua_newtable( luaState );
+		if ( lua_setupvalue( luaState, -2, 1 ) == NULL )
+		{
+			lua_pop( luaState, 1 );
+		}
+		const int noArguments = 0;
+		const int returnValueCount = 1;
+		const int noErrorMessageHandler = 0;
+		result = lua_pcall( luaState, noArguments, returnValueCount, noErrorMessageHandler );
+	}
+	if ( result != LUA_OK )
+	{
+		OutputErrorMessage( lua_tostring( luaState, -1 ), i_path );
+		lua_close( luaState );
+		return NULL;
+	}
+	if ( !lua_istable( luaState, -1 ) )
+	{
+		OutputErrorMessage( "The asset file must return a table", i_path );
+		lua_close( luaState );
+		return NULL;
+	}
+
+	return luaState;
+}
+
+bool eae6320::AssetBuild::GetOptionalBoolean( lua_State& io_luaState, const char* const i_key, const char* const i_path, bool& io_value )
+{
+	bool wereThereErrors = false;
+	lua_getfield( &io_luaState, -1, i_key );
+	if ( lua_isboolean( &io_luaState, -1 ) )
+	{
+		io_value = lua_toboolean( &io_luaState, -1 ) != 0;
+	}
+	else if ( !lua_isnil( &io_luaState, -1 ) )
+	{
+		wereThereErrors = true;
+		std::ostringstream errorMessage;
+		errorMessage << "\"" << i_key << "\" must be true or false";
+		OutputErrorMessage( errorMessage.str().c_str(), i_path );
+	}
+	lua_pop( &io_luaState, 1 );
+	return !wereThereErrors;
+}
+
+bool eae6320::AssetBuild::GetOptionalUnsignedInteger( lua_State& io_luaState, const char* const i_key, const char* const i_path, unsigned int& io_value )
+{
+	bool wereThereErrors = false;
+	lua_getfield( &io_luaState, -1, i_key );
+	if ( !lua_isnil( &io_luaState, -1 ) )
+	{
+		const lua_Number value = lua_isnumber( &io_luaState, -1 ) ? lua_tonumber( &io_luaState, -1 ) : -1.0;
+		if ( ( value >= 0.0 ) && ( std::floor( value ) == value ) && ( value <= 65535.0 ) )
+		{
+			io_value = static_cast<unsigned int>( value );
+		}
+		else
+		{
+			wereThereErrors = true;
+			std::ostringstream errorMessage;
+			errorMessage << "\"" << i_key << "\" must be a non-negative integer";
+			OutputErrorMessage( errorMessage.str().c_str(), i_path );
+		}
+	}
+	lua_pop( &io_luaState, 1 );
+	return !wereThereErrors;
+}
+
+bool eae6320::AssetBuild::GetOptionalNumber( lua_State& io_luaState, const char* const i_key, const char* const i_path, float& io_value )
+{
+	bool wereThereErrors = false;
+	lua_getfield( &io_luaState, -1, i_key );
+	if ( lua_type( &io_luaState, -1 ) == LUA_TNUMBER )
+	{
+		io_value = static_cast<float>( lua_tonumber( &io_luaState, -1 ) );
+	}
+	else if ( !lua_isnil( &io_luaState, -1 ) )
+	{
+		wereThereErrors = true;
+		std::ostringstream errorMessage;
+		errorMessage << "\"" << i_key << "\" must be a number";
+		OutputErrorMessage( errorMessage.str().c_str(), i_path );
+	}
+	lua_pop( &io_luaState, 1 );
+	return !wereThereErrors;
+}
+
+bool eae6320::AssetBuild::GetOptionalString( lua_State& io_luaState, const char* const i_key, const char* const i_path, std::string& io_value )
+{
+	bool wereThereErrors = false;
+	lua_getfield( &io_luaState, -1, i_key );
+	if ( lua_type( &io_luaState, -1 ) == LUA_TSTRING )
+	{
+		io_value = lua_tostring( &io_luaState, -1 );
+	}
+	else if ( !lua_isnil( &io_luaState, -1 ) )
+	{
+		wereThereErrors = true;
+		std::ostringstream errorMessage;
+		errorMessage << "\"" << i_key << "\" must be a string";
+		OutputErrorMessage( errorMessage.str().c_str(), i_path );
+	}
+	lua_pop( &io_luaState, 1 );
+	return !wereThereErrors;
+}
@@ -0,0 +1,39 @@
+/*
+	Some authored assets are Lua files that return a table describing the asset
+	(e.g. atlases and materials),
+	and these functions are shared by the builders that read them
+*/
+
+#ifndef EAE6320_ASSETBUILD_LUAASSETS_H
+#define EAE6320_ASSETBUILD_LUAASSETS_H
+
+// Header Files
+//=============
+
+#include <string>
+#include "../../External/Lua/Includes.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace AssetBuild
+	{
+		// Runs the file in an empty environment (so that it can't do anything other than describe the asset)
+		// and leaves the table that it returns on the top of the stack.
+		// If this succeeds the caller must call lua_close() on the returned state;
+		// if it fails the error has already been output and NULL is returned.
+		lua_State* LoadLuaAsset( const char* const i_path );
+
+		// These read an optional value from the table on the top of the stack;
+		// if the key doesn't exist then the value isn't changed.
+		// If the key exists but has the wrong type the error is output and false is returned.
+		bool GetOptionalBoolean( lua_State& io_luaState, const char* const i_key, const char* const i_path, bool& io_value );
+		bool GetOptionalUnsignedInteger( lua_State& io_luaState, const char* const i_key, const char* const i_path, unsigned int& io_value );
+		bool GetOptionalNumber( lua_State& io_luaState, const char* const i_key, const char* const i_path, float& io_value );
+		bool GetOptionalString( lua_State& io_luaState, const char* const i_key, const char* const i_path, std::string& io_value );
+	}
+}
+
+#endif	// EAE6320_ASSETBUILD_LUAASSETS_H
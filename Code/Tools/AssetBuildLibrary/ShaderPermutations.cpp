@@ -0,0 +1,379 @@
+// Header Files
+//=============
+
+#include "ShaderPermutations.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include "LuaAssets.h"
+#include "UtilityFunctions.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool LoadAxes( lua_State& io_luaState, const char* const i_path, eae6320::AssetBuild::ShaderPermutations::sShader& io_shader );
+	bool LoadAxis( lua_State& io_luaState, const char* const i_path, eae6320::AssetBuild::ShaderPermutations::sAxis& o_axis );
+	bool IsValidName( const std::string& i_name );
+	bool GetInteger( lua_State& io_luaState, const int i_index, int32_t& o_value );
+}
+
+// Interface
+//==========
+
+bool eae6320::AssetBuild::ShaderPermutations::Load( const char* const i_path, sShader& o_shader )
+{
+	bool wereThereErrors = false;
+
+	lua_State* const luaState = LoadLuaAsset( i_path );
+	if ( !luaState )
+	{
+		return false;
+	}
+
+	// Type
+	{
+		lua_getfield( luaState, -1, "type" );
+		const char* const type = ( lua_type( luaState, -1 ) == LUA_TSTRING ) ? lua_tostring( luaState, -1 ) : "";
+		if ( strcmp( type, "vertex" ) == 0 )
+		{
+			o_shader.type = Graphics::ShaderLibraryFormats::eShaderType::Vertex;
+		}
+		else if ( strcmp( type, "fragment" ) == 0 )
+		{
+			o_shader.type = Graphics::ShaderLibraryFormats::eShaderType::Fragment;
+		}
+		else
+		{
+			wereThereErrors = true;
+			OutputErrorMessage( "A shader's \"type\" must be \"vertex\" or \"fragment\"", i_path );
+		}
+		lua_pop( luaState, 1 );
+	}
+	// Axes
+	if ( !wereThereErrors )
+	{
+		o_shader.axes.clear();
+		if ( !LoadAxes( *luaState, i_path, o_shader ) )
+		{
+			wereThereErrors = true;
+		}
+	}
+
+	lua_close( luaState );
+
+	// Assign the bits of the key to each axis
+	if ( !wereThereErrors )
+	{
+		unsigned int bitOffset = 0;
+		o_shader.permutationCount = 1;
+		for ( std::vector<sAxis>::iterator i = o_shader.axes.begin(); i != o_shader.axes.end(); ++i )
+		{
+			// An axis with only one value doesn't need any bits
+			const size_t valueCount = i->values.size();
+			i->bitCount = 0;
+			while ( ( static_cast<size_t>( 1 ) << i->bitCount ) < valueCount )
+			{
+				++i->bitCount;
+			}
+			i->bitOffset = bitOffset;
+			bitOffset += i->bitCount;
+			if ( bitOffset > Graphics::ShaderLibraryFormats::s_maxKeyBitCount )
+			{
+				wereThereErrors = true;
+				std::ostringstream errorMessage;
+				errorMessage << "The shader's axes need more than " << Graphics::ShaderLibraryFormats::s_maxKeyBitCount << " bits for their key";
+				OutputErrorMessage( errorMessage.str().c_str(), i_path );
+				break;
+			}
+			// The count can't overflow unless every axis has a power-of-two number of values that uses all 64 bits,
+			// and the builder will refuse a number of permutations that large anyway
+			o_shader.permutationCount = ( o_shader.permutationCount <= ( UINT64_MAX / valueCount ) ) ?
+				( o_shader.permutationCount * valueCount ) : UINT64_MAX;
+		}
+	}
+
+	return !wereThereErrors;
+}
+
+bool eae6320::AssetBuild::ShaderPermutations::CalculateKey( const sShader& i_shader, lua_State& io_luaState, const char* const i_path, uint64_t& o_key )
+{
+	// Every axis uses its first value unless the table says otherwise,
+	// and the first value always has an index of zero
+	o_key = 0;
+	if ( lua_isnil( &io_luaState, -1 ) )
+	{
+		return true;
+	}
+	else if ( !lua_istable( &io_luaState, -1 ) )
+	{
+		OutputErrorMessage( "A shader permutation must be a table of axis names and values", i_path );
+		return false;
+	}
+
+	bool wereThereErrors = false;
+	lua_pushnil( &io_luaState );
+	while ( lua_next( &io_luaState, -2 ) != 0 )
+	{
+		// The key is at -2 and the value is at -1
+		const char* const name = ( lua_type( &io_luaState, -2 ) == LUA_TSTRING ) ? lua_tostring( &io_luaState, -2 ) : NULL;
+		const sAxis* axis = NULL;
+		if ( name )
+		{
+			for ( std::vector<sAxis>::const_iterator i = i_shader.axes.begin(); i != i_shader.axes.end(); ++i )
+			{
+				if ( i->name == name )
+				{
+					axis = &*i;
+					break;
+				}
+			}
+		}
+		if ( axis )
+		{
+			int32_t value;
+			size_t valueIndex = axis->values.size();
+			if ( GetInteger( io_luaState, -1, value ) )
+			{
+				for ( valueIndex = 0; valueIndex < axis->values.size(); ++valueIndex )
+				{
+					if ( axis->values[valueIndex] == value )
+					{
+						break;
+					}
+				}
+			}
+			if ( valueIndex < axis->values.size() )
+			{
+				o_key |= static_cast<uint64_t>( valueIndex ) << axis->bitOffset;
+			}
+			else
+			{
+				wereThereErrors = true;
+				std::ostringstream errorMessage;
+				errorMessage << "The value of the shader permutation axis \"" << axis->name << "\" isn't one of the values that the shader declares";
+				OutputErrorMessage( errorMessage.str().c_str(), i_path );
+			}
+		}
+		else
+		{
+			wereThereErrors = true;
+			std::ostringstream errorMessage;
+			errorMessage << "The shader doesn't have a permutation axis named \"" << ( name ? name : "(not a string)" ) << "\"";
+			OutputErrorMessage( errorMessage.str().c_str(), i_path );
+		}
+		lua_pop( &io_luaState, 1 );
+	}
+
+	return !wereThereErrors;
+}
+
+uint64_t eae6320::AssetBuild::ShaderPermutations::GetKey( const sShader& i_shader, uint64_t i_permutationIndex )
+{
+	// The permutation index is treated as a number whose digits are the axes' value indices
+	uint64_t key = 0;
+	for ( std::vector<sAxis>::const_iterator i = i_shader.axes.begin(); i != i_shader.axes.end(); ++i )
+	{
+		const uint64_t valueCount = i->values.size();
+		key |= ( i_permutationIndex % valueCount ) << i->bitOffset;
+		i_permutationIndex /= valueCount;
+	}
+	return key;
+}
+
+int32_t eae6320::AssetBuild::ShaderPermutations::GetValue( const sAxis& i_axis, const uint64_t i_key )
+{
+	const uint64_t mask = ( i_axis.bitCount < 64 ) ? ( ( 1ull << i_axis.bitCount ) - 1 ) : ~0ull;
+	const size_t valueIndex = static_cast<size_t>( ( i_key >> i_axis.bitOffset ) & mask );
+	return ( valueIndex < i_axis.values.size() ) ? i_axis.values[valueIndex] : i_axis.values[0];
+}
+
+std::string eae6320::AssetBuild::ShaderPermutations::GetSourcePath( const char* const i_path_shader )
+{
+	std::string path( i_path_shader );
+	{
+		const size_t extension = path.find_last_of( '.' );
+		const size_t slash = path.find_last_of( "/\\" );
+		if ( ( extension != std::string::npos ) && ( ( slash == std::string::npos ) || ( extension > slash ) ) )
+		{
+			path.resize( extension );
+		}
+	}
+#if defined( EAE6320_PLATFORM_D3D )
+	return path + ".hlsl";
+#elif defined( EAE6320_PLATFORM_GL )
+	return path + ".glsl";
+#endif
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool LoadAxes( lua_State& io_luaState, const char* const i_path, eae6320::AssetBuild::ShaderPermutations::sShader& io_shader )
+	{
+		bool wereThereErrors = false;
+
+		lua_getfield( &io_luaState, -1, "axes" );
+		if ( lua_istable( &io_luaState, -1 ) )
+		{
+			const int axisCount = static_cast<int>( luaL_len( &io_luaState, -1 ) );
+			if ( axisCount > 0xff )
+			{
+				wereThereErrors = true;
+				eae6320::AssetBuild::OutputErrorMessage( "A shader can't have more than 255 permutation axes", i_path );
+				goto OnExit;
+			}
+			for ( int i = 1; i <= axisCount; ++i )
+			{
+				eae6320::AssetBuild::ShaderPermutations::sAxis axis;
+				lua_rawgeti( &io_luaState, -1, i );
+				const bool wasAxisLoaded = LoadAxis( io_luaState, i_path, axis );
+				lua_pop( &io_luaState, 1 );
+				if ( !wasAxisLoaded )
+				{
+					wereThereErrors = true;
+					goto OnExit;
+				}
+				for ( std::vector<eae6320::AssetBuild::ShaderPermutations::sAxis>::const_iterator j = io_shader.axes.begin();
+					j != io_shader.axes.end(); ++j )
+				{
+					if ( j->name == axis.name )
+					{
+						wereThereErrors = true;
+						std::ostringstream errorMessage;
+						errorMessage << "The permutation axis \"" << axis.name << "\" is declared more than once";
+						eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+						goto OnExit;
+					}
+				}
+				io_shader.axes.push_back( axis );
+			}
+		}
+		else if ( !lua_isnil( &io_luaState, -1 ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "A shader's \"axes\" must be a table", i_path );
+		}
+
+	OnExit:
+
+		lua_pop( &io_luaState, 1 );
+		return !wereThereErrors;
+	}
+
+	bool LoadAxis( lua_State& io_luaState, const char* const i_path, eae6320::AssetBuild::ShaderPermutations::sAxis& o_axis )
+	{
+		if ( !lua_istable( &io_luaState, -1 ) )
+		{
+			eae6320::AssetBuild::OutputErrorMessage( "Every permutation axis must be a table", i_path );
+			return false;
+		}
+
+		bool wereThereErrors = false;
+
+		// Name
+		{
+			lua_getfield( &io_luaState, -1, "name" );
+			if ( lua_type( &io_luaState, -1 ) == LUA_TSTRING )
+			{
+				o_axis.name = lua_tostring( &io_luaState, -1 );
+			}
+			lua_pop( &io_luaState, 1 );
+			if ( !IsValidName( o_axis.name ) )
+			{
+				eae6320::AssetBuild::OutputErrorMessage( "Every permutation axis must have a \"name\" that can be used as a #define", i_path );
+				return false;
+			}
+		}
+		// Values
+		{
+			lua_getfield( &io_luaState, -1, "values" );
+			if ( lua_istable( &io_luaState, -1 ) )
+			{
+				const int valueCount = static_cast<int>( luaL_len( &io_luaState, -1 ) );
+				if ( ( valueCount > 0 ) && ( valueCount <= 0xffff ) )
+				{
+					for ( int i = 1; i <= valueCount; ++i )
+					{
+						int32_t value;
+						lua_rawgeti( &io_luaState, -1, i );
+						if ( GetInteger( io_luaState, -1, value ) )
+						{
+							for ( std::vector<int32_t>::const_iterator j = o_axis.values.begin(); j != o_axis.values.end(); ++j )
+							{
+								if ( *j == value )
+								{
+									wereThereErrors = true;
+								}
+							}
+							o_axis.values.push_back( value );
+						}
+						else
+						{
+							wereThereErrors = true;
+						}
+						lua_pop( &io_luaState, 1 );
+					}
+				}
+				else
+				{
+					wereThereErrors = true;
+				}
+			}
+			else if ( lua_isnil( &io_luaState, -1 ) )
+			{
+				// An axis without values is a switch
+				o_axis.values.push_back( 0 );
+				o_axis.values.push_back( 1 );
+			}
+			else
+			{
+				wereThereErrors = true;
+			}
+			lua_pop( &io_luaState, 1 );
+			if ( wereThereErrors )
+			{
+				std::ostringstream errorMessage;
+				errorMessage << "The \"values\" of the permutation axis \"" << o_axis.name << "\" must be a table of different integers";
+				eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+			}
+		}
+
+		return !wereThereErrors;
+	}
+
+	bool IsValidName( const std::string& i_name )
+	{
+		if ( i_name.empty() || ( ( i_name[0] >= '0' ) && ( i_name[0] <= '9' ) ) )
+		{
+			return false;
+		}
+		for ( std::string::const_iterator i = i_name.begin(); i != i_name.end(); ++i )
+		{
+			const char c = *i;
+			if ( !( ( ( c >= 'A' ) && ( c <= 'Z' ) ) || ( ( c >= 'a' ) && ( c <= 'z' ) ) || ( ( c >= '0' ) && ( c <= '9' ) ) || ( c == '_' ) ) )
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool GetInteger( lua_State& io_luaState, const int i_index, int32_t& o_value )
+	{
+		if ( lua_type( &io_luaState, i_index ) == LUA_TNUMBER )
+		{
+			const lua_Number value = lua_tonumber( &io_luaState, i_index );
+			if ( ( std::floor( value ) == value ) && ( value >= INT32_MIN ) && ( value <= INT32_MAX ) )
+			{
+				o_value = static_cast<int32_t>( value );
+				return true;
+			}
+		}
+		return false;
+	}
+}
@@ -0,0 +1,77 @@
+/*
+	An authored shader (a ".shader" file) is a Lua file that describes
+	which permutations of a shader's source code should be compiled:
+
+		return
+		{
+			type = "fragment",	-- or "vertex"
+			axes =
+			{
+				{ name = "ANIMATE_COLOR" },	-- A switch that can be 0 or 1
+				{ name = "LIGHT_COUNT", values = { 0, 1, 2, 4 } },
+			},
+		}
+
+	The source code is the file next to it with the same name and a platform-specific extension.
+	These functions are shared by the ShaderBuilder (which compiles every permutation)
+	and the MaterialBuilder (which calculates the key of the permutation that a material uses).
+*/
+
+#ifndef EAE6320_ASSETBUILD_SHADERPERMUTATIONS_H
+#define EAE6320_ASSETBUILD_SHADERPERMUTATIONS_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../../Engine/Graphics/ShaderLibraryFormats.h"
+#include "../../External/Lua/Includes.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace AssetBuild
+	{
+		namespace ShaderPermutations
+		{
+			struct sAxis
+			{
+				std::string name;
+				std::vector<int32_t> values;
+				unsigned int bitOffset;
+				unsigned int bitCount;
+			};
+
+			struct sShader
+			{
+				Graphics::ShaderLibraryFormats::eShaderType::eShaderType type;
+				std::vector<sAxis> axes;
+				// The product of the number of values of every axis
+				uint64_t permutationCount;
+			};
+
+			// This reads and validates an authored ".shader" file
+			// and assigns the bits of the key to each axis
+			bool Load( const char* const i_path, sShader& o_shader );
+
+			// This reads a table of axis names and values from the top of the stack
+			// (e.g. { ANIMATE_COLOR = 1, LIGHT_COUNT = 2 })
+			// and calculates the key of that permutation.
+			// Axes that aren't in the table use their first value.
+			bool CalculateKey( const sShader& i_shader, lua_State& io_luaState, const char* const i_path, uint64_t& o_key );
+
+			// Every index in the range [0, permutationCount) is a different permutation
+			uint64_t GetKey( const sShader& i_shader, uint64_t i_permutationIndex );
+			int32_t GetValue( const sAxis& i_axis, const uint64_t i_key );
+
+			// The source code path has the extension of the platform that the tool was built for
+			std::string GetSourcePath( const char* const i_path_shader );
+		}
+	}
+}
+
+#endif	// EAE6320_ASSETBUILD_SHADERPERMUTATIONS_H
@@ -0,0 +1,581 @@
+// Header Files
+//=============
+
+#include "FontBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include "../AssetBuildLibrary/LuaAssets.h"
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+#include "../TextureBuilder/AtlasPacker.h"
+#include "../TextureBuilder/TextureBuilder.h"
+#include "../../Engine/Graphics/FontFormats.h"
+#include "../../Engine/Platform/Platform.h"
+#include "../../Engine/Windows/Includes.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	struct sFontDescription
+	{
+		std::string face;
+		std::string file;
+		unsigned int size;
+		unsigned int firstCharacter, lastCharacter;
+		bool distanceField;
+		unsigned int spread;
+		unsigned int padding;
+		unsigned int maxDimension;
+
+		sFontDescription() : size( 0 ), firstCharacter( 32 ), lastCharacter( 126 ), distanceField( false ), spread( 4 ), padding( 1 ), maxDimension( 2048 ) {}
+	};
+	struct sRasterizedGlyph
+	{
+		// 1 byte per texel (either coverage or distance), stored in rows from the top left
+		std::vector<uint8_t> texels;
+		unsigned int width, height;
+		// These are in pixels at the size that the font is built at
+		float offsetX, offsetY;
+		float advance;
+		// Where the glyph's cell (the glyph and its padding) is in the texture
+		eae6320::TextureBuilder::sRectangle cell;
+
+		sRasterizedGlyph() : width( 0 ), height( 0 ), offsetX( 0.0f ), offsetY( 0.0f ), advance( 0.0f ) {}
+	};
+
+	// Distance fields are calculated from glyphs that are rasterized this many times larger
+	// so that the edges are found more precisely than a single texel
+	const unsigned int s_distanceFieldUpscale = 4;
+
+	bool LoadFontDescription( const char* const i_path, sFontDescription& o_description );
+	bool RasterizeGlyph( HDC i_deviceContext, const unsigned int i_character, const sFontDescription& i_description,
+		const char* const i_path, sRasterizedGlyph& o_glyph );
+	void ConvertToDistanceField( const std::vector<uint8_t>& i_coverage, const unsigned int i_width, const unsigned int i_height,
+		const unsigned int i_spread, sRasterizedGlyph& io_glyph );
+	void CalculateSquaredDistances( std::vector<float>& io_values, const unsigned int i_width, const unsigned int i_height );
+	void CalculateSquaredDistances( const float* const i_values, const unsigned int i_count, const unsigned int i_stride,
+		float* const o_distances, std::vector<float>& io_scratch, std::vector<unsigned int>& io_parabolas, std::vector<float>& io_boundaries );
+	bool SortByArea( const sRasterizedGlyph* const i_lhs, const sRasterizedGlyph* const i_rhs );
+}
+
+// Interface
+//==========
+
+bool eae6320::FontBuilder::Build( const char* const i_path_source, const char* const i_path_target )
+{
+	namespace FontFormats = Graphics::FontFormats;
+
+	bool wereThereErrors = false;
+
+	sFontDescription description;
+	std::string path_file;
+	bool wasFileAdded = false;
+	HDC deviceContext = NULL;
+	HFONT font = NULL;
+	HGDIOBJ previousFont = NULL;
+	TEXTMETRICA textMetrics;
+	std::vector<sRasterizedGlyph> glyphs;
+	unsigned int textureWidth = 0, textureHeight = 0;
+	unsigned int rasterizationScale = 1;
+
+	if ( !LoadFontDescription( i_path_source, description ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	rasterizationScale = description.distanceField ? s_distanceFieldUpscale : 1;
+
+	// Make the font available to GDI
+	if ( !description.file.empty() )
+	{
+		// The file is relative to the authored font
+		path_file = i_path_source;
+		{
+			const size_t slash = path_file.find_last_of( "/\\" );
+			path_file = ( slash != std::string::npos ) ? path_file.substr( 0, slash + 1 ) : std::string();
+		}
+		path_file += description.file;
+		// A private font is only visible to this process, and so it doesn't need to be installed
+		if ( AddFontResourceExA( path_file.c_str(), FR_PRIVATE, NULL ) == 0 )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "Windows couldn't load the font file", path_file.c_str() );
+			goto OnExit;
+		}
+		wasFileAdded = true;
+	}
+	{
+		deviceContext = CreateCompatibleDC( NULL );
+		if ( !deviceContext )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "Windows couldn't create a device context to rasterize the font with", i_path_source );
+			goto OnExit;
+		}
+		// A negative height is the size of the em square rather than of the whole cell
+		font = CreateFontA( -static_cast<int>( description.size * rasterizationScale ), 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
+			DEFAULT_CHARSET, OUT_TT_PRECIS, CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH | FF_DONTCARE, description.face.c_str() );
+		if ( !font )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "Windows couldn't create the font", i_path_source );
+			goto OnExit;
+		}
+		previousFont = SelectObject( deviceContext, font );
+		// GDI silently substitutes a different face for one that doesn't exist
+		{
+			char face_selected[LF_FACESIZE] = { 0 };
+			GetTextFaceA( deviceContext, LF_FACESIZE, face_selected );
+			if ( _stricmp( face_selected, description.face.c_str() ) != 0 )
+			{
+				wereThereErrors = true;
+				std::ostringstream errorMessage;
+				errorMessage << "The font face \"" << description.face << "\" doesn't exist (Windows would have used \"" << face_selected << "\")";
+				AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path_source );
+				goto OnExit;
+			}
+		}
+		if ( !GetTextMetricsA( deviceContext, &textMetrics ) )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "Windows couldn't get the font's metrics", i_path_source );
+			goto OnExit;
+		}
+	}
+	// Rasterize every glyph
+	{
+		glyphs.resize( description.lastCharacter - description.firstCharacter + 1 );
+		for ( unsigned int i = 0; i < glyphs.size(); ++i )
+		{
+			if ( !RasterizeGlyph( deviceContext, description.firstCharacter + i, description, i_path_source, glyphs[i] ) )
+			{
+				wereThereErrors = true;
+				goto OnExit;
+			}
+		}
+	}
+	// Pack the cells, largest first
+	{
+		std::vector<sRasterizedGlyph*> packingOrder;
+		for ( std::vector<sRasterizedGlyph>::iterator i = glyphs.begin(); i != glyphs.end(); ++i )
+		{
+			// Glyphs without anything to draw don't need a cell
+			if ( i->width > 0 )
+			{
+				packingOrder.push_back( &*i );
+			}
+		}
+		if ( packingOrder.empty() )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "None of the font's characters have anything to draw", i_path_source );
+			goto OnExit;
+		}
+		std::stable_sort( packingOrder.begin(), packingOrder.end(), SortByArea );
+		// The texture isn't mipmapped, and so cells only need to be aligned to compressed blocks
+		const unsigned int cellAlignment = 4;
+		std::vector<TextureBuilder::sRectangle> cellSizes( packingOrder.size() );
+		for ( size_t i = 0; i < packingOrder.size(); ++i )
+		{
+			cellSizes[i].x = cellSizes[i].y = 0;
+			cellSizes[i].width = ( packingOrder[i]->width + ( 2 * description.padding ) + ( cellAlignment - 1 ) ) & ~( cellAlignment - 1 );
+			cellSizes[i].height = ( packingOrder[i]->height + ( 2 * description.padding ) + ( cellAlignment - 1 ) ) & ~( cellAlignment - 1 );
+		}
+		std::vector<TextureBuilder::sRectangle> cells;
+		if ( !TextureBuilder::AtlasPacker::Pack( cellSizes, description.maxDimension, textureWidth, textureHeight, cells ) )
+		{
+			wereThereErrors = true;
+			std::ostringstream errorMessage;
+			errorMessage << "The glyphs don't fit in a " << description.maxDimension << "x" << description.maxDimension << " texture";
+			AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path_source );
+			goto OnExit;
+		}
+		for ( size_t i = 0; i < packingOrder.size(); ++i )
+		{
+			packingOrder[i]->cell = cells[i];
+		}
+	}
+	// Copy every glyph into the texture and write it
+	{
+		TextureBuilder::sImage texture;
+		texture.width = textureWidth;
+		texture.height = textureHeight;
+		// Empty texels have no coverage (or are as far outside of a glyph as a distance field can store)
+		texture.pixels.resize( textureWidth * textureHeight * 4, 0 );
+		for ( std::vector<sRasterizedGlyph>::const_iterator i = glyphs.begin(); i != glyphs.end(); ++i )
+		{
+			for ( unsigned int y = 0; y < i->height; ++y )
+			{
+				uint8_t* const row_target = &texture.pixels[( ( ( i->cell.y + description.padding + y ) * textureWidth ) + i->cell.x + description.padding ) * 4];
+				const uint8_t* const row_source = &i->texels[y * i->width];
+				for ( unsigned int x = 0; x < i->width; ++x )
+				{
+					// Only red is sampled, but every channel is the same so that the uncompressed texture can be looked at
+					memset( row_target + ( x * 4 ), row_source[x], 4 );
+				}
+			}
+		}
+		std::string path_texture( i_path_target );
+		{
+			const size_t extension = path_texture.find_last_of( '.' );
+			const size_t slash = path_texture.find_last_of( "/\\" );
+			if ( ( extension != std::string::npos ) && ( ( slash == std::string::npos ) || ( extension > slash ) ) )
+			{
+				path_texture.resize( extension );
+			}
+			path_texture += ".texture";
+		}
+		// Text is drawn at (or near) the size it was built at, and so it isn't mipmapped
+		TextureBuilder::sOptions options;
+		options.format = Graphics::TextureFormats::eFormat::BC4;
+		options.isSrgb = false;
+		options.maxMipCount = 1;
+		if ( !TextureBuilder::WriteTexture( texture, path_texture.c_str(), options ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+	}
+	// Write the glyph table
+	{
+		std::vector<FontFormats::sGlyph> entries( glyphs.size() );
+		for ( size_t i = 0; i < glyphs.size(); ++i )
+		{
+			const sRasterizedGlyph& glyph = glyphs[i];
+			FontFormats::sGlyph& entry = entries[i];
+			memset( &entry, 0, sizeof( entry ) );
+			if ( glyph.width > 0 )
+			{
+				entry.u0 = static_cast<float>( glyph.cell.x + description.padding ) / static_cast<float>( textureWidth );
+				entry.v0 = static_cast<float>( glyph.cell.y + description.padding ) / static_cast<float>( textureHeight );
+				entry.u1 = static_cast<float>( glyph.cell.x + description.padding + glyph.width ) / static_cast<float>( textureWidth );
+				entry.v1 = static_cast<float>( glyph.cell.y + description.padding + glyph.height ) / static_cast<float>( textureHeight );
+				entry.offsetX = glyph.offsetX;
+				entry.offsetY = glyph.offsetY;
+				entry.width = static_cast<float>( glyph.width );
+				entry.height = static_cast<float>( glyph.height );
+			}
+			entry.advance = glyph.advance;
+		}
+
+		FontFormats::sHeader header;
+		memset( &header, 0, sizeof( header ) );
+		header.fourCc = FontFormats::s_fourCc;
+		header.version = FontFormats::s_version;
+		header.flags = description.distanceField ? static_cast<uint8_t>( FontFormats::eFlag::IsDistanceField ) : 0;
+		header.firstCharacter = description.firstCharacter;
+		header.glyphCount = static_cast<uint32_t>( entries.size() );
+		header.width = static_cast<uint16_t>( textureWidth );
+		header.height = static_cast<uint16_t>( textureHeight );
+		header.size = static_cast<float>( description.size );
+		header.lineHeight = static_cast<float>( textMetrics.tmHeight + textMetrics.tmExternalLeading ) / static_cast<float>( rasterizationScale );
+		header.ascent = static_cast<float>( textMetrics.tmAscent ) / static_cast<float>( rasterizationScale );
+		header.distanceFieldRange = description.distanceField ? static_cast<float>( 2 * description.spread ) : 0.0f;
+		std::vector<uint8_t> targetData( sizeof( header ) + ( entries.size() * sizeof( FontFormats::sGlyph ) ) );
+		memcpy( &targetData[0], &header, sizeof( header ) );
+		memcpy( &targetData[sizeof( header )], &entries[0], entries.size() * sizeof( FontFormats::sGlyph ) );
+		std::string errorMessage;
+		if ( !Platform::WriteBinaryFile( i_path_target, &targetData[0], targetData.size(), &errorMessage ) )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path_target );
+			goto OnExit;
+		}
+	}
+	// Report how well the glyphs were packed
+	{
+		unsigned int glyphArea = 0;
+		for ( std::vector<sRasterizedGlyph>::const_iterator i = glyphs.begin(); i != glyphs.end(); ++i )
+		{
+			glyphArea += i->width * i->height;
+		}
+		std::cout << "FontBuilder: Rasterized " << glyphs.size() << " glyphs of " << description.face << " at " << description.size
+			<< " pixels into a " << textureWidth << "x" << textureHeight << " texture ("
+			<< ( 100.0 * glyphArea / static_cast<double>( textureWidth * textureHeight ) ) << "% occupied by glyphs"
+			<< ( description.distanceField ? "; a distance field" : "" ) << ")\n";
+	}
+
+OnExit:
+
+	if ( previousFont )
+	{
+		SelectObject( deviceContext, previousFont );
+	}
+	if ( font )
+	{
+		DeleteObject( font );
+	}
+	if ( deviceContext )
+	{
+		DeleteDC( deviceContext );
+	}
+	if ( wasFileAdded )
+	{
+		RemoveFontResourceExA( path_file.c_str(), FR_PRIVATE, NULL );
+	}
+
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool LoadFontDescription( const char* const i_path, sFontDescription& o_description )
+	{
+		bool wereThereErrors = false;
+
+		lua_State* const luaState = eae6320::AssetBuild::LoadLuaAsset( i_path );
+		if ( !luaState )
+		{
+			return false;
+		}
+
+		if ( !eae6320::AssetBuild::GetOptionalString( *luaState, "face", i_path, o_description.face )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "size", i_path, o_description.size )
+			|| !eae6320::AssetBuild::GetOptionalString( *luaState, "file", i_path, o_description.file )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "firstCharacter", i_path, o_description.firstCharacter )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "lastCharacter", i_path, o_description.lastCharacter )
+			|| !eae6320::AssetBuild::GetOptionalBoolean( *luaState, "distanceField", i_path, o_description.distanceField )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "spread", i_path, o_description.spread )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "padding", i_path, o_description.padding )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "maxDimension", i_path, o_description.maxDimension ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		if ( o_description.face.empty() || ( o_description.face.size() >= LF_FACESIZE ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "A font must have a \"face\" that is shorter than 32 characters", i_path );
+			goto OnExit;
+		}
+		if ( ( o_description.size < 4 ) || ( o_description.size > 256 ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "A font's \"size\" must be between 4 and 256 pixels", i_path );
+			goto OnExit;
+		}
+		if ( o_description.firstCharacter > o_description.lastCharacter )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "A font's \"firstCharacter\" can't be after its \"lastCharacter\"", i_path );
+			goto OnExit;
+		}
+		if ( o_description.distanceField && ( o_description.spread == 0 ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "A distance field font's \"spread\" must be at least 1 pixel", i_path );
+			goto OnExit;
+		}
+
+	OnExit:
+
+		lua_close( luaState );
+		return !wereThereErrors;
+	}
+
+	bool RasterizeGlyph( HDC i_deviceContext, const unsigned int i_character, const sFontDescription& i_description,
+		const char* const i_path, sRasterizedGlyph& o_glyph )
+	{
+		const unsigned int rasterizationScale = i_description.distanceField ? s_distanceFieldUpscale : 1;
+		const MAT2 identity = { { 0, 1 }, { 0, 0 }, { 0, 0 }, { 0, 1 } };
+		GLYPHMETRICS metrics;
+		const DWORD bufferSize = GetGlyphOutlineW( i_deviceContext, i_character, GGO_GRAY8_BITMAP, &metrics, 0, NULL, &identity );
+		if ( bufferSize == GDI_ERROR )
+		{
+			std::ostringstream errorMessage;
+			errorMessage << "Windows couldn't rasterize character " << i_character;
+			eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+			return false;
+		}
+		o_glyph.advance = static_cast<float>( metrics.gmCellIncX ) / static_cast<float>( rasterizationScale );
+		// Characters like a space have nothing to draw
+		if ( bufferSize == 0 )
+		{
+			return true;
+		}
+
+		std::vector<uint8_t> buffer( bufferSize );
+		if ( GetGlyphOutlineW( i_deviceContext, i_character, GGO_GRAY8_BITMAP, &metrics, bufferSize, &buffer[0], &identity ) == GDI_ERROR )
+		{
+			std::ostringstream errorMessage;
+			errorMessage << "Windows couldn't rasterize character " << i_character;
+			eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+			return false;
+		}
+		const unsigned int width = metrics.gmBlackBoxX;
+		const unsigned int height = metrics.gmBlackBoxY;
+		// GDI's rows are aligned to DWORDs
+		const unsigned int pitch = ( width + 3 ) & ~3u;
+		// The GDI origin is the top left of the black box relative to the pen with Y up
+		const float originX = static_cast<float>( metrics.gmptGlyphOrigin.x );
+		const float originY = -static_cast<float>( metrics.gmptGlyphOrigin.y );
+		if ( !i_description.distanceField )
+		{
+			o_glyph.width = width;
+			o_glyph.height = height;
+			o_glyph.offsetX = originX;
+			o_glyph.offsetY = originY;
+			o_glyph.texels.resize( width * height );
+			for ( unsigned int y = 0; y < height; ++y )
+			{
+				for ( unsigned int x = 0; x < width; ++x )
+				{
+					// GDI's gray levels are [0,64]
+					o_glyph.texels[( y * width ) + x] = static_cast<uint8_t>( ( ( buffer[( y * pitch ) + x] * 255u ) + 32u ) / 64u );
+				}
+			}
+		}
+		else
+		{
+			// The glyph is surrounded by enough empty space for the distance field to reach,
+			// and rounded up to a whole number of output texels
+			const unsigned int spread = i_description.spread * rasterizationScale;
+			const unsigned int paddedWidth = ( ( width + ( 2 * spread ) + ( rasterizationScale - 1 ) ) / rasterizationScale ) * rasterizationScale;
+			const unsigned int paddedHeight = ( ( height + ( 2 * spread ) + ( rasterizationScale - 1 ) ) / rasterizationScale ) * rasterizationScale;
+			std::vector<uint8_t> coverage( paddedWidth * paddedHeight, 0 );
+			for ( unsigned int y = 0; y < height; ++y )
+			{
+				for ( unsigned int x = 0; x < width; ++x )
+				{
+					coverage[( ( y + spread ) * paddedWidth ) + x + spread] = buffer[( y * pitch ) + x];
+				}
+			}
+			o_glyph.offsetX = ( originX - static_cast<float>( spread ) ) / static_cast<float>( rasterizationScale );
+			o_glyph.offsetY = ( originY - static_cast<float>( spread ) ) / static_cast<float>( rasterizationScale );
+			ConvertToDistanceField( coverage, paddedWidth, paddedHeight, spread, o_glyph );
+		}
+
+		return true;
+	}
+
+	void ConvertToDistanceField( const std::vector<uint8_t>& i_coverage, const unsigned int i_width, const unsigned int i_height,
+		const unsigned int i_spread, sRasterizedGlyph& io_glyph )
+	{
+		// Every texel gets the squared distance to the nearest texel inside of the glyph and to the nearest one outside
+		const size_t texelCount = i_coverage.size();
+		std::vector<float> distances_inside( texelCount ), distances_outside( texelCount );
+		{
+			// A texel is inside if at least half of it is covered
+			const uint8_t threshold = 32;
+			const float infinity = 1.0e20f;
+			for ( size_t i = 0; i < texelCount; ++i )
+			{
+				const bool isInside = i_coverage[i] >= threshold;
+				distances_inside[i] = isInside ? 0.0f : infinity;
+				distances_outside[i] = isInside ? infinity : 0.0f;
+			}
+			CalculateSquaredDistances( distances_inside, i_width, i_height );
+			CalculateSquaredDistances( distances_outside, i_width, i_height );
+		}
+		// The signed distances (positive inside) are averaged over every block of texels that becomes one output texel
+		// and then mapped so that the edge is at 0.5 and [0,1] covers the spread on both sides of it
+		const unsigned int scale = s_distanceFieldUpscale;
+		io_glyph.width = i_width / scale;
+		io_glyph.height = i_height / scale;
+		io_glyph.texels.resize( io_glyph.width * io_glyph.height );
+		const float encodingScale = 1.0f / ( 2.0f * static_cast<float>( i_spread ) * static_cast<float>( scale * scale ) );
+		for ( unsigned int y = 0; y < io_glyph.height; ++y )
+		{
+			for ( unsigned int x = 0; x < io_glyph.width; ++x )
+			{
+				float distanceSum = 0.0f;
+				for ( unsigned int blockY = 0; blockY < scale; ++blockY )
+				{
+					for ( unsigned int blockX = 0; blockX < scale; ++blockX )
+					{
+						const size_t i = ( ( ( y * scale ) + blockY ) * i_width ) + ( x * scale ) + blockX;
+						// The edge is halfway between an inside texel and an outside one
+						distanceSum += ( distances_inside[i] == 0.0f ) ?
+							( std::sqrt( distances_outside[i] ) - 0.5f ) : ( 0.5f - std::sqrt( distances_inside[i] ) );
+					}
+				}
+				float value = 0.5f + ( distanceSum * encodingScale );
+				value = ( value < 0.0f ) ? 0.0f : ( ( value > 1.0f ) ? 1.0f : value );
+				io_glyph.texels[( y * io_glyph.width ) + x] = static_cast<uint8_t>( ( value * 255.0f ) + 0.5f );
+			}
+		}
+	}
+
+	void CalculateSquaredDistances( std::vector<float>& io_values, const unsigned int i_width, const unsigned int i_height )
+	{
+		// A 2D distance transform is a 1D transform of every column followed by a 1D transform of every row
+		const unsigned int maxCount = ( i_width > i_height ) ? i_width : i_height;
+		std::vector<float> line( maxCount ), scratch( maxCount ), boundaries( maxCount + 1 );
+		std::vector<unsigned int> parabolas( maxCount );
+		for ( unsigned int x = 0; x < i_width; ++x )
+		{
+			CalculateSquaredDistances( &io_values[x], i_height, i_width, &line[0], scratch, parabolas, boundaries );
+			for ( unsigned int y = 0; y < i_height; ++y )
+			{
+				io_values[( y * i_width ) + x] = line[y];
+			}
+		}
+		for ( unsigned int y = 0; y < i_height; ++y )
+		{
+			CalculateSquaredDistances( &io_values[y * i_width], i_width, 1, &line[0], scratch, parabolas, boundaries );
+			memcpy( &io_values[y * i_width], &line[0], i_width * sizeof( float ) );
+		}
+	}
+
+	void CalculateSquaredDistances( const float* const i_values, const unsigned int i_count, const unsigned int i_stride,
+		float* const o_distances, std::vector<float>& io_scratch, std::vector<unsigned int>& io_parabolas, std::vector<float>& io_boundaries )
+	{
+		// This is the linear-time transform from Felzenszwalb and Huttenlocher's "Distance Transforms of Sampled Functions":
+		// The result at every position is the lowest of the parabolas rooted at each input value,
+		// and so the lower envelope of the parabolas is found first and then sampled
+		float* const values = &io_scratch[0];
+		for ( unsigned int i = 0; i < i_count; ++i )
+		{
+			values[i] = i_values[i * i_stride];
+		}
+		unsigned int* const parabolas = &io_parabolas[0];
+		float* const boundaries = &io_boundaries[0];
+		unsigned int k = 0;
+		parabolas[0] = 0;
+		boundaries[0] = -1.0e20f;
+		boundaries[1] = 1.0e20f;
+		for ( unsigned int q = 1; q < i_count; ++q )
+		{
+			const float qf = static_cast<float>( q );
+			float intersection;
+			for ( ;; )
+			{
+				const float p = static_cast<float>( parabolas[k] );
+				intersection = ( ( values[q] + ( qf * qf ) ) - ( values[parabolas[k]] + ( p * p ) ) ) / ( ( 2.0f * qf ) - ( 2.0f * p ) );
+				// The first boundary is minus infinity, and so this always stops at the first parabola
+				if ( intersection > boundaries[k] )
+				{
+					break;
+				}
+				--k;
+			}
+			++k;
+			parabolas[k] = q;
+			boundaries[k] = intersection;
+			boundaries[k + 1] = 1.0e20f;
+		}
+		k = 0;
+		for ( unsigned int q = 0; q < i_count; ++q )
+		{
+			while ( boundaries[k + 1] < static_cast<float>( q ) )
+			{
+				++k;
+			}
+			const float offset = static_cast<float>( q ) - static_cast<float>( parabolas[k] );
+			o_distances[q] = ( offset * offset ) + values[parabolas[k]];
+		}
+	}
+
+	bool SortByArea( const sRasterizedGlyph* const i_lhs, const sRasterizedGlyph* const i_rhs )
+	{
+		return ( i_lhs->width * i_lhs->height ) > ( i_rhs->width * i_rhs->height );
+	}
+}
@@ -0,0 +1,47 @@
+/*
+	The FontBuilder rasterizes the glyphs of a font into a texture
+	and writes the table of how to lay them out that is described in Graphics/FontFormats.h
+
+	An authored font is a Lua file that returns a table like this:
+		return
+		{
+			-- The name of an installed font (or of the font in "file")
+			face = "Consolas",
+			-- The height of the font's em square in pixels
+			size = 24,
+			-- These are optional:
+			-- A TrueType file (relative to the font) that is used instead of an installed font
+			file = "Fonts/MyFont.ttf",
+			-- The range of characters that the font contains
+			firstCharacter = 32,
+			lastCharacter = 126,
+			-- Whether the texture stores the distance to each glyph's edge
+			-- (so that the text stays sharp when it is scaled) instead of coverage
+			distanceField = false,
+			-- How many pixels outside of each glyph's edge the distance field reaches
+			spread = 4,
+			-- How many empty pixels are kept around each glyph in the texture
+			padding = 1,
+			-- The largest width or height that the texture can grow to
+			maxDimension = 2048,
+		}
+
+	Glyphs are rasterized with GDI, and so the FontBuilder only runs on Windows.
+	The texture is written next to the target with a ".texture" extension.
+*/
+
+#ifndef EAE6320_FONTBUILDER_H
+#define EAE6320_FONTBUILDER_H
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace FontBuilder
+	{
+		bool Build( const char* const i_path_source, const char* const i_path_target );
+	}
+}
+
+#endif	// EAE6320_FONTBUILDER_H
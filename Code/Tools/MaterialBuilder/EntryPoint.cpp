@@ -0,0 +1,25 @@
+/*
+	The main() function is where the program starts execution
+*/
+
+// Header Files
+//=============
+
+#include <cstdlib>
+#include "MaterialBuilder.h"
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+
+// Entry Point
+//============
+
+int main( int i_argumentCount, char** i_arguments )
+{
+	// The command line should have the source path and the target path
+	if ( i_argumentCount != 3 )
+	{
+		eae6320::AssetBuild::OutputErrorMessage( "The MaterialBuilder must be called with a source path and a target path" );
+		return EXIT_FAILURE;
+	}
+
+	return eae6320::MaterialBuilder::Build( i_arguments[1], i_arguments[2] ) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
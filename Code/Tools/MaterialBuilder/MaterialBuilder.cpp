@@ -0,0 +1,246 @@
+// Header Files
+//=============
+
+#include "MaterialBuilder.h"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../AssetBuildLibrary/LuaAssets.h"
+#include "../AssetBuildLibrary/ShaderPermutations.h"
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+#include "../../Engine/Graphics/MaterialFormats.h"
+#include "../../Engine/Platform/Platform.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool GetShaderPath( lua_State& io_luaState, const char* const i_key, const char* const i_path, std::string& o_shaderPath );
+	// This reads the authored shader's axes and calculates the key of the permutation that the material uses
+	bool GetShaderKey( lua_State& io_luaState, const char* const i_key, const std::string& i_shaderPath,
+		const eae6320::Graphics::ShaderLibraryFormats::eShaderType::eShaderType i_shaderType, const char* const i_path,
+		uint64_t& o_shaderKey );
+	bool GetColor( lua_State& io_luaState, const char* const i_path, float( &io_color )[4] );
+}
+
+// Interface
+//==========
+
+bool eae6320::MaterialBuilder::Build( const char* const i_path_source, const char* const i_path_target )
+{
+	namespace MaterialFormats = Graphics::MaterialFormats;
+
+	bool wereThereErrors = false;
+
+	MaterialFormats::sHeader header;
+	memset( &header, 0, sizeof( header ) );
+	std::string path_vertexShader, path_fragmentShader;
+
+	// Read the authored material
+	{
+		lua_State* const luaState = AssetBuild::LoadLuaAsset( i_path_source );
+		if ( !luaState )
+		{
+			return false;
+		}
+
+		bool alphaTransparency = false;
+		bool depthTesting = true;
+		bool depthWriting = true;
+		bool drawBothTriangleSides = false;
+		std::string vertexFormat( "mesh" );
+		MaterialFormats::sParameterBlock& parameterBlock = header.parameterBlock;
+		parameterBlock.color[0] = parameterBlock.color[1] = parameterBlock.color[2] = parameterBlock.color[3] = 1.0f;
+		if ( !GetShaderPath( *luaState, "vertexShader", i_path_source, path_vertexShader )
+			|| !GetShaderPath( *luaState, "fragmentShader", i_path_source, path_fragmentShader )
+			|| !GetShaderKey( *luaState, "vertexShaderPermutation", path_vertexShader,
+				Graphics::ShaderLibraryFormats::eShaderType::Vertex, i_path_source, header.vertexShaderKey )
+			|| !GetShaderKey( *luaState, "fragmentShaderPermutation", path_fragmentShader,
+				Graphics::ShaderLibraryFormats::eShaderType::Fragment, i_path_source, header.fragmentShaderKey )
+			|| !GetColor( *luaState, i_path_source, parameterBlock.color )
+			|| !AssetBuild::GetOptionalBoolean( *luaState, "alphaTransparency", i_path_source, alphaTransparency )
+			|| !AssetBuild::GetOptionalBoolean( *luaState, "depthTesting", i_path_source, depthTesting )
+			|| !AssetBuild::GetOptionalBoolean( *luaState, "depthWriting", i_path_source, depthWriting )
+			|| !AssetBuild::GetOptionalBoolean( *luaState, "drawBothTriangleSides", i_path_source, drawBothTriangleSides )
+			|| !AssetBuild::GetOptionalString( *luaState, "vertexFormat", i_path_source, vertexFormat ) )
+		{
+			wereThereErrors = true;
+		}
+		else if ( vertexFormat == "mesh" )
+		{
+			header.vertexFormat = MaterialFormats::eVertexFormat::Mesh;
+		}
+		else if ( vertexFormat == "text" )
+		{
+			header.vertexFormat = MaterialFormats::eVertexFormat::Text;
+		}
+		else if ( vertexFormat == "particle" )
+		{
+			header.vertexFormat = MaterialFormats::eVertexFormat::Particle;
+		}
+		else
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "A material's \"vertexFormat\" must be \"mesh\", \"text\", or \"particle\"", i_path_source );
+		}
+		lua_close( luaState );
+		if ( wereThereErrors )
+		{
+			return false;
+		}
+
+		header.renderStates = static_cast<uint8_t>(
+			( alphaTransparency ? MaterialFormats::eRenderState::AlphaTransparency : 0 )
+			| ( depthTesting ? MaterialFormats::eRenderState::DepthTesting : 0 )
+			| ( depthWriting ? MaterialFormats::eRenderState::DepthWriting : 0 )
+			| ( drawBothTriangleSides ? MaterialFormats::eRenderState::DrawBothTriangleSides : 0 ) );
+	}
+	// Fill in the header
+	{
+		header.fourCc = MaterialFormats::s_fourCc;
+		header.version = MaterialFormats::s_version;
+		// The built shader libraries are next to the authored shaders
+		path_vertexShader += ".shaderlibrary";
+		path_fragmentShader += ".shaderlibrary";
+		header.vertexShaderPathOffset = static_cast<uint16_t>( sizeof( header ) );
+		header.fragmentShaderPathOffset = static_cast<uint16_t>( sizeof( header ) + path_vertexShader.size() + 1 );
+		// Two materials with the same shaders, render states, and vertex format can share the same effect
+		{
+			uint64_t hash = MaterialFormats::CalculateHash( &header.renderStates, sizeof( header.renderStates ) );
+			hash = MaterialFormats::CalculateHash( &header.vertexFormat, sizeof( header.vertexFormat ), hash );
+			hash = MaterialFormats::CalculateHash( path_vertexShader.c_str(), path_vertexShader.size() + 1, hash );
+			hash = MaterialFormats::CalculateHash( path_fragmentShader.c_str(), path_fragmentShader.size() + 1, hash );
+			hash = MaterialFormats::CalculateHash( &header.vertexShaderKey, sizeof( header.vertexShaderKey ), hash );
+			hash = MaterialFormats::CalculateHash( &header.fragmentShaderKey, sizeof( header.fragmentShaderKey ), hash );
+			header.effectHash = hash;
+		}
+		header.parameterBlockHash = MaterialFormats::CalculateHash( &header.parameterBlock, sizeof( header.parameterBlock ) );
+		{
+			uint64_t hash = MaterialFormats::CalculateHash( &header.effectHash, sizeof( header.effectHash ) );
+			hash = MaterialFormats::CalculateHash( &header.parameterBlockHash, sizeof( header.parameterBlockHash ), hash );
+			header.contentHash = hash;
+		}
+	}
+	// Write the built material
+	{
+		const size_t fileSize = header.fragmentShaderPathOffset + path_fragmentShader.size() + 1;
+		if ( fileSize > 0xffff )
+		{
+			AssetBuild::OutputErrorMessage( "The material's shader paths are too long", i_path_source );
+			return false;
+		}
+		std::vector<uint8_t> targetData( fileSize );
+		memcpy( &targetData[0], &header, sizeof( header ) );
+		memcpy( &targetData[header.vertexShaderPathOffset], path_vertexShader.c_str(), path_vertexShader.size() + 1 );
+		memcpy( &targetData[header.fragmentShaderPathOffset], path_fragmentShader.c_str(), path_fragmentShader.size() + 1 );
+		std::string errorMessage;
+		if ( !Platform::WriteBinaryFile( i_path_target, &targetData[0], targetData.size(), &errorMessage ) )
+		{
+			AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path_target );
+			return false;
+		}
+	}
+
+	std::cout << "MaterialBuilder: " << path_vertexShader << " (key " << std::hex << header.vertexShaderKey << ") + "
+		<< path_fragmentShader << " (key " << header.fragmentShaderKey << ") (content hash " << std::hex << std::setw( 16 ) << std::setfill( '0' ) << header.contentHash << ")\n";
+
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool GetShaderPath( lua_State& io_luaState, const char* const i_key, const char* const i_path, std::string& o_shaderPath )
+	{
+		bool wereThereErrors = false;
+		lua_getfield( &io_luaState, -1, i_key );
+		if ( lua_type( &io_luaState, -1 ) == LUA_TSTRING )
+		{
+			o_shaderPath = lua_tostring( &io_luaState, -1 );
+		}
+		else
+		{
+			wereThereErrors = true;
+			std::string errorMessage( "A material must have a \"" );
+			errorMessage += i_key;
+			errorMessage += "\" path";
+			eae6320::AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path );
+		}
+		lua_pop( &io_luaState, 1 );
+		return !wereThereErrors;
+	}
+
+	bool GetShaderKey( lua_State& io_luaState, const char* const i_key, const std::string& i_shaderPath,
+		const eae6320::Graphics::ShaderLibraryFormats::eShaderType::eShaderType i_shaderType, const char* const i_path,
+		uint64_t& o_shaderKey )
+	{
+		// The shader path is relative to the material
+		std::string path_shader( i_path );
+		{
+			const size_t slash = path_shader.find_last_of( "/\\" );
+			path_shader.resize( ( slash != std::string::npos ) ? ( slash + 1 ) : 0 );
+		}
+		path_shader += i_shaderPath + ".shader";
+		eae6320::AssetBuild::ShaderPermutations::sShader shader;
+		if ( !eae6320::AssetBuild::ShaderPermutations::Load( path_shader.c_str(), shader ) )
+		{
+			return false;
+		}
+		if ( shader.type != i_shaderType )
+		{
+			eae6320::AssetBuild::OutputErrorMessage( "The material uses a shader of the wrong type", path_shader.c_str() );
+			return false;
+		}
+
+		lua_getfield( &io_luaState, -1, i_key );
+		const bool wasKeyCalculated = eae6320::AssetBuild::ShaderPermutations::CalculateKey( shader, io_luaState, i_path, o_shaderKey );
+		lua_pop( &io_luaState, 1 );
+		return wasKeyCalculated;
+	}
+
+	bool GetColor( lua_State& io_luaState, const char* const i_path, float( &io_color )[4] )
+	{
+		bool wereThereErrors = false;
+		lua_getfield( &io_luaState, -1, "color" );
+		if ( lua_istable( &io_luaState, -1 ) )
+		{
+			const int channelCount = static_cast<int>( luaL_len( &io_luaState, -1 ) );
+			if ( ( channelCount == 3 ) || ( channelCount == 4 ) )
+			{
+				for ( int i = 0; i < channelCount; ++i )
+				{
+					lua_rawgeti( &io_luaState, -1, i + 1 );
+					if ( lua_isnumber( &io_luaState, -1 ) )
+					{
+						io_color[i] = static_cast<float>( lua_tonumber( &io_luaState, -1 ) );
+					}
+					else
+					{
+						wereThereErrors = true;
+					}
+					lua_pop( &io_luaState, 1 );
+				}
+			}
+			else
+			{
+				wereThereErrors = true;
+			}
+		}
+		else if ( !lua_isnil( &io_luaState, -1 ) )
+		{
+			wereThereErrors = true;
+		}
+		if ( wereThereErrors )
+		{
+			eae6320::AssetBuild::OutputErrorMessage( "A material's \"color\" must be a table of 3 or 4 numbers", i_path );
+		}
+		lua_pop( &io_luaState, 1 );
+		return !wereThereErrors;
+	}
+}
@@ -0,0 +1,39 @@
+/*
+	The MaterialBuilder converts an authored material into the binary format
+	that is described in Graphics/MaterialFormats.h
+
+	An authored material is a Lua file that returns a table like this:
+		return
+		{
+			-- These are authored shaders (see AssetBuildLibrary/ShaderPermutations.h)
+			-- that are relative to the material and don't have an extension
+			vertexShader = "vertexShader",
+			fragmentShader = "fragmentShader",
+			-- These are optional:
+			-- (they choose the value of each permutation axis,
+			-- and any axis that isn't listed uses its first value)
+			vertexShaderPermutation = { ANIMATE_POSITION = 1 },
+			fragmentShaderPermutation = {},
+			color = { 1.0, 1.0, 1.0, 1.0 },
+			alphaTransparency = false,
+			depthTesting = true,
+			depthWriting = true,
+			drawBothTriangleSides = false,
+		}
+*/
+
+#ifndef EAE6320_MATERIALBUILDER_H
+#define EAE6320_MATERIALBUILDER_H
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace MaterialBuilder
+	{
+		bool Build( const char* const i_path_source, const char* const i_path_target );
+	}
+}
+
+#endif	// EAE6320_MATERIALBUILDER_H
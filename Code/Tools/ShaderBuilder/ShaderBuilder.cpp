@@ -0,0 +1,424 @@
+// Header Files
+//=============
+
+#include "ShaderBuilder.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../AssetBuildLibrary/ShaderPermutations.h"
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+#include "../../Engine/Graphics/ShaderLibraryFormats.h"
+#include "../../Engine/Platform/Platform.h"
+
+#if defined( EAE6320_PLATFORM_D3D )
+	#include <D3Dcompiler.h>
+#endif
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Every permutation is compiled, and so the number of them has to be limited
+	// (an authored shader that needs more than this probably has axes that should be branches instead)
+	const uint64_t s_maxPermutationCount = 4096;
+
+	struct sCompiledPermutation
+	{
+		// This is the compiled shader (or an error message if compilation failed)
+		std::string output;
+		bool wasSuccessful;
+	};
+
+	struct sCompilationJob
+	{
+		const eae6320::AssetBuild::ShaderPermutations::sShader* shader;
+		const char* sourceCode;
+		size_t sourceCodeSize;
+		const char* path_sourceCode;
+		std::vector<sCompiledPermutation> permutations;
+		// Each thread claims the next permutation that hasn't been compiled yet
+		std::atomic<uint64_t> nextPermutation;
+	};
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void CompilePermutations( sCompilationJob* const io_job );
+	void CompilePermutation( const sCompilationJob& i_job, const uint64_t i_key, sCompiledPermutation& o_permutation );
+	// Returns the #defines of the permutation as "NAME=value NAME=value" for error messages
+	std::string DescribePermutation( const eae6320::AssetBuild::ShaderPermutations::sShader& i_shader, const uint64_t i_key );
+	uint32_t Align( const size_t i_offset, const size_t i_alignment );
+}
+
+// Interface
+//==========
+
+bool eae6320::ShaderBuilder::Build( const char* const i_path_source, const char* const i_path_target )
+{
+	namespace ShaderLibraryFormats = Graphics::ShaderLibraryFormats;
+
+	bool wereThereErrors = false;
+	const std::chrono::high_resolution_clock::time_point time_start = std::chrono::high_resolution_clock::now();
+
+	AssetBuild::ShaderPermutations::sShader shader;
+	const std::string path_sourceCode = AssetBuild::ShaderPermutations::GetSourcePath( i_path_source );
+	Platform::sDataFromFile sourceCode;
+	sCompilationJob job;
+	unsigned int threadCount = 1;
+	std::vector<ShaderLibraryFormats::sVariant> variants;
+	// The unique outputs are owned by the map
+	std::map<std::string, uint32_t> blobIndices;
+	std::vector<const std::string*> blobs;
+	std::vector<ShaderLibraryFormats::sSlot> slots;
+	std::vector<uint8_t> targetData;
+
+	// Read the authored shader
+	{
+		if ( !AssetBuild::ShaderPermutations::Load( i_path_source, shader ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		if ( shader.permutationCount > s_maxPermutationCount )
+		{
+			wereThereErrors = true;
+			std::ostringstream errorMessage;
+			errorMessage << "The shader has " << shader.permutationCount << " permutations but the limit is " << s_maxPermutationCount;
+			AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path_source );
+			goto OnExit;
+		}
+		std::string errorMessage;
+		if ( !Platform::LoadBinaryFile( path_sourceCode.c_str(), sourceCode, &errorMessage ) )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( errorMessage.c_str(), path_sourceCode.c_str() );
+			goto OnExit;
+		}
+	}
+	// Every core compiles permutations until there are none left
+	// (the calling thread does its share instead of waiting)
+	{
+		job.shader = &shader;
+		job.sourceCode = reinterpret_cast<const char*>( sourceCode.data );
+		job.sourceCodeSize = sourceCode.size;
+		job.path_sourceCode = path_sourceCode.c_str();
+		job.permutations.resize( static_cast<size_t>( shader.permutationCount ) );
+		job.nextPermutation = 0;
+
+		threadCount = std::thread::hardware_concurrency();
+		threadCount = ( threadCount > 0 ) ? threadCount : 1;
+		threadCount = ( threadCount < shader.permutationCount ) ? threadCount : static_cast<unsigned int>( shader.permutationCount );
+		std::vector<std::thread> threads;
+		threads.reserve( threadCount - 1 );
+		for ( unsigned int i = 1; i < threadCount; ++i )
+		{
+			threads.push_back( std::thread( CompilePermutations, &job ) );
+		}
+		CompilePermutations( &job );
+		for ( size_t i = 0; i < threads.size(); ++i )
+		{
+			threads[i].join();
+		}
+	}
+	// Report every permutation that failed
+	for ( uint64_t i = 0; i < shader.permutationCount; ++i )
+	{
+		const sCompiledPermutation& permutation = job.permutations[static_cast<size_t>( i )];
+		if ( !permutation.wasSuccessful )
+		{
+			wereThereErrors = true;
+			std::ostringstream errorMessage;
+			errorMessage << "The permutation " << DescribePermutation( shader, AssetBuild::ShaderPermutations::GetKey( shader, i ) )
+				<< " failed to compile: " << permutation.output;
+			AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), path_sourceCode.c_str() );
+		}
+	}
+	if ( wereThereErrors )
+	{
+		goto OnExit;
+	}
+	// Permutations with identical output share a blob
+	{
+		variants.resize( static_cast<size_t>( shader.permutationCount ) );
+		for ( uint64_t i = 0; i < shader.permutationCount; ++i )
+		{
+			const std::string& output = job.permutations[static_cast<size_t>( i )].output;
+			const std::pair<std::map<std::string, uint32_t>::iterator, bool> result =
+				blobIndices.insert( std::make_pair( output, static_cast<uint32_t>( blobs.size() ) ) );
+			if ( result.second )
+			{
+				blobs.push_back( &result.first->first );
+			}
+			ShaderLibraryFormats::sVariant& variant = variants[static_cast<size_t>( i )];
+			variant.key = AssetBuild::ShaderPermutations::GetKey( shader, i );
+			variant.blobIndex = result.first->second;
+			variant.padding = 0;
+		}
+	}
+	// Build the slot table with at most half of the slots used
+	{
+		size_t slotCount = 1;
+		while ( slotCount < ( variants.size() * 2 ) )
+		{
+			slotCount *= 2;
+		}
+		ShaderLibraryFormats::sSlot emptySlot;
+		{
+			emptySlot.key = 0;
+			emptySlot.variantIndex = ShaderLibraryFormats::s_invalidIndex;
+			emptySlot.padding = 0;
+		}
+		slots.resize( slotCount, emptySlot );
+		for ( size_t i = 0; i < variants.size(); ++i )
+		{
+			uint32_t slotIndex = ShaderLibraryFormats::CalculateSlotIndex( variants[i].key, static_cast<uint32_t>( slotCount ) );
+			while ( slots[slotIndex].variantIndex != ShaderLibraryFormats::s_invalidIndex )
+			{
+				slotIndex = ( slotIndex + 1 ) & static_cast<uint32_t>( slotCount - 1 );
+			}
+			slots[slotIndex].key = variants[i].key;
+			slots[slotIndex].variantIndex = static_cast<uint32_t>( i );
+		}
+	}
+	// Write the built library
+	{
+		ShaderLibraryFormats::sHeader header;
+		memset( &header, 0, sizeof( header ) );
+		std::vector<ShaderLibraryFormats::sAxis> axes( shader.axes.size() );
+		std::vector<ShaderLibraryFormats::sBlob> blobEntries( blobs.size() );
+		// Lay out the file
+		size_t fileSize = sizeof( header );
+		{
+			header.fourCc = ShaderLibraryFormats::s_fourCc;
+			header.version = ShaderLibraryFormats::s_version;
+			header.shaderType = static_cast<uint8_t>( shader.type );
+			header.axisCount = static_cast<uint8_t>( axes.size() );
+			header.variantCount = static_cast<uint32_t>( variants.size() );
+			header.blobCount = static_cast<uint32_t>( blobs.size() );
+			header.slotCount = static_cast<uint32_t>( slots.size() );
+
+			header.axesOffset = static_cast<uint32_t>( fileSize );
+			fileSize += axes.size() * sizeof( ShaderLibraryFormats::sAxis );
+			for ( size_t i = 0; i < axes.size(); ++i )
+			{
+				axes[i].valuesOffset = static_cast<uint32_t>( fileSize );
+				axes[i].valueCount = static_cast<uint16_t>( shader.axes[i].values.size() );
+				axes[i].bitOffset = static_cast<uint8_t>( shader.axes[i].bitOffset );
+				axes[i].bitCount = static_cast<uint8_t>( shader.axes[i].bitCount );
+				fileSize += shader.axes[i].values.size() * sizeof( int32_t );
+			}
+			header.variantsOffset = Align( fileSize, 8 );
+			fileSize = header.variantsOffset + ( variants.size() * sizeof( ShaderLibraryFormats::sVariant ) );
+			header.slotsOffset = static_cast<uint32_t>( fileSize );
+			fileSize += slots.size() * sizeof( ShaderLibraryFormats::sSlot );
+			header.blobsOffset = static_cast<uint32_t>( fileSize );
+			fileSize += blobs.size() * sizeof( ShaderLibraryFormats::sBlob );
+			for ( size_t i = 0; i < axes.size(); ++i )
+			{
+				axes[i].nameOffset = static_cast<uint32_t>( fileSize );
+				fileSize += shader.axes[i].name.size() + 1;
+			}
+			for ( size_t i = 0; i < blobs.size(); ++i )
+			{
+				blobEntries[i].offset = Align( fileSize, 4 );
+				blobEntries[i].size = static_cast<uint32_t>( blobs[i]->size() );
+				fileSize = blobEntries[i].offset + blobs[i]->size();
+			}
+			if ( fileSize > 0xffffffff )
+			{
+				wereThereErrors = true;
+				AssetBuild::OutputErrorMessage( "The shader library would be larger than 4 GB", i_path_source );
+				goto OnExit;
+			}
+		}
+		// Copy everything into place
+		{
+			targetData.resize( fileSize, 0 );
+			uint8_t* const fileData = &targetData[0];
+			memcpy( fileData, &header, sizeof( header ) );
+			for ( size_t i = 0; i < axes.size(); ++i )
+			{
+				memcpy( fileData + header.axesOffset + ( i * sizeof( ShaderLibraryFormats::sAxis ) ), &axes[i], sizeof( axes[i] ) );
+				memcpy( fileData + axes[i].valuesOffset, &shader.axes[i].values[0], shader.axes[i].values.size() * sizeof( int32_t ) );
+				memcpy( fileData + axes[i].nameOffset, shader.axes[i].name.c_str(), shader.axes[i].name.size() + 1 );
+			}
+			memcpy( fileData + header.variantsOffset, &variants[0], variants.size() * sizeof( ShaderLibraryFormats::sVariant ) );
+			memcpy( fileData + header.slotsOffset, &slots[0], slots.size() * sizeof( ShaderLibraryFormats::sSlot ) );
+			memcpy( fileData + header.blobsOffset, &blobEntries[0], blobEntries.size() * sizeof( ShaderLibraryFormats::sBlob ) );
+			for ( size_t i = 0; i < blobs.size(); ++i )
+			{
+				if ( !blobs[i]->empty() )
+				{
+					memcpy( fileData + blobEntries[i].offset, blobs[i]->data(), blobs[i]->size() );
+				}
+			}
+		}
+		{
+			std::string errorMessage;
+			if ( !Platform::WriteBinaryFile( i_path_target, &targetData[0], targetData.size(), &errorMessage ) )
+			{
+				wereThereErrors = true;
+				AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path_target );
+				goto OnExit;
+			}
+		}
+		// Report how many permutations there were and how many of them were unique
+		{
+			const double secondCount = std::chrono::duration<double>( std::chrono::high_resolution_clock::now() - time_start ).count();
+			std::cout << "ShaderBuilder: " << variants.size() << " permutations of " << path_sourceCode
+				<< " compiled into " << blobs.size() << " unique variants using "
+				<< threadCount << ( ( threadCount == 1 ) ? " thread in " : " threads in " )
+				<< ( secondCount * 1000.0 ) << " ms (" << ( targetData.size() / 1024.0 ) << " KB)\n";
+		}
+	}
+
+OnExit:
+
+	sourceCode.Free();
+
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void CompilePermutations( sCompilationJob* const io_job )
+	{
+		const uint64_t permutationCount = io_job->shader->permutationCount;
+		for ( uint64_t i = io_job->nextPermutation++; i < permutationCount; i = io_job->nextPermutation++ )
+		{
+			const uint64_t key = eae6320::AssetBuild::ShaderPermutations::GetKey( *io_job->shader, i );
+			CompilePermutation( *io_job, key, io_job->permutations[static_cast<size_t>( i )] );
+		}
+	}
+
+	void CompilePermutation( const sCompilationJob& i_job, const uint64_t i_key, sCompiledPermutation& o_permutation )
+	{
+		const eae6320::AssetBuild::ShaderPermutations::sShader& shader = *i_job.shader;
+		std::vector<std::string> values( shader.axes.size() );
+		for ( size_t i = 0; i < shader.axes.size(); ++i )
+		{
+			std::ostringstream value;
+			value << eae6320::AssetBuild::ShaderPermutations::GetValue( shader.axes[i], i_key );
+			values[i] = value.str();
+		}
+
+#if defined( EAE6320_PLATFORM_D3D )
+		std::vector<D3D_SHADER_MACRO> defines( shader.axes.size() + 1 );
+		for ( size_t i = 0; i < shader.axes.size(); ++i )
+		{
+			defines[i].Name = shader.axes[i].name.c_str();
+			defines[i].Definition = values[i].c_str();
+		}
+		// The list of defines is terminated by a NULL entry
+		defines.back().Name = NULL;
+		defines.back().Definition = NULL;
+
+		ID3DInclude* const noIncludes = NULL;
+		const char* const entryPoint = "main";
+		const char* const profile = ( shader.type == eae6320::Graphics::ShaderLibraryFormats::eShaderType::Vertex ) ? "vs_4_0" : "ps_4_0";
+		const unsigned int compileFlags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+		const unsigned int noEffectFlags = 0;
+		ID3DBlob* compiledShader = NULL;
+		ID3DBlob* errorMessages = NULL;
+		const HRESULT result = D3DCompile( i_job.sourceCode, i_job.sourceCodeSize, i_job.path_sourceCode, &defines[0], noIncludes,
+			entryPoint, profile, compileFlags, noEffectFlags, &compiledShader, &errorMessages );
+		if ( SUCCEEDED( result ) )
+		{
+			o_permutation.output.assign( reinterpret_cast<const char*>( compiledShader->GetBufferPointer() ), compiledShader->GetBufferSize() );
+			o_permutation.wasSuccessful = true;
+		}
+		else
+		{
+			if ( errorMessages )
+			{
+				o_permutation.output = reinterpret_cast<const char*>( errorMessages->GetBufferPointer() );
+			}
+			else
+			{
+				std::ostringstream errorMessage;
+				errorMessage << "D3DCompile() failed with HRESULT " << std::hex << result;
+				o_permutation.output = errorMessage.str();
+			}
+			o_permutation.wasSuccessful = false;
+		}
+		if ( compiledShader )
+		{
+			compiledShader->Release();
+		}
+		if ( errorMessages )
+		{
+			errorMessages->Release();
+		}
+#elif defined( EAE6320_PLATFORM_GL )
+		// GLSL requires the #version directive to come before anything else (other than comments),
+		// and so the #defines are inserted immediately after it
+		const std::string sourceCode( i_job.sourceCode, i_job.sourceCodeSize );
+		size_t insertionPoint = 0;
+		unsigned int lineCount = 0;
+		{
+			size_t lineStart = 0;
+			while ( lineStart < sourceCode.size() )
+			{
+				size_t lineEnd = sourceCode.find( '\n', lineStart );
+				lineEnd = ( lineEnd != std::string::npos ) ? ( lineEnd + 1 ) : sourceCode.size();
+				const size_t directive = sourceCode.find_first_not_of( " \t", lineStart );
+				++lineCount;
+				if ( ( directive < lineEnd ) && ( sourceCode.compare( directive, 8, "#version" ) == 0 ) )
+				{
+					insertionPoint = lineEnd;
+					break;
+				}
+				lineStart = lineEnd;
+			}
+			if ( insertionPoint == 0 )
+			{
+				lineCount = 0;
+			}
+		}
+		std::ostringstream output;
+		output << sourceCode.substr( 0, insertionPoint );
+		if ( ( insertionPoint > 0 ) && ( sourceCode[insertionPoint - 1] != '\n' ) )
+		{
+			output << "\n";
+		}
+		for ( size_t i = 0; i < shader.axes.size(); ++i )
+		{
+			output << "#define " << shader.axes[i].name << " " << values[i] << "\n";
+		}
+		// Errors will still be reported with the line numbers of the authored source code
+		output << "#line " << ( lineCount + 1 ) << "\n" << sourceCode.substr( insertionPoint );
+		o_permutation.output = output.str();
+		o_permutation.wasSuccessful = true;
+#endif
+	}
+
+	std::string DescribePermutation( const eae6320::AssetBuild::ShaderPermutations::sShader& i_shader, const uint64_t i_key )
+	{
+		std::ostringstream description;
+		for ( size_t i = 0; i < i_shader.axes.size(); ++i )
+		{
+			description << ( ( i > 0 ) ? " " : "" ) << i_shader.axes[i].name << "="
+				<< eae6320::AssetBuild::ShaderPermutations::GetValue( i_shader.axes[i], i_key );
+		}
+		return i_shader.axes.empty() ? std::string( "(with no axes)" ) : description.str();
+	}
+
+	uint32_t Align( const size_t i_offset, const size_t i_alignment )
+	{
+		return static_cast<uint32_t>( ( i_offset + ( i_alignment - 1 ) ) & ~( i_alignment - 1 ) );
+	}
+}
@@ -0,0 +1,29 @@
+/*
+	The ShaderBuilder compiles every permutation of an authored shader
+	into the shader library format that is described in Graphics/ShaderLibraryFormats.h
+
+	The authored ".shader" file declares the permutation axes (see AssetBuildLibrary/ShaderPermutations.h)
+	and the source code is the file next to it with the platform's extension:
+		* Direct3D: The HLSL is compiled into bytecode, and the game doesn't compile any shaders
+		* OpenGL: There is no offline compiler,
+			and so the library contains the GLSL of each permutation with its #defines already inserted
+			(the game still compiles the one permutation that it uses)
+	Permutations are compiled in parallel,
+	and permutations that result in identical output are only stored once.
+*/
+
+#ifndef EAE6320_SHADERBUILDER_H
+#define EAE6320_SHADERBUILDER_H
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace ShaderBuilder
+	{
+		bool Build( const char* const i_path_source, const char* const i_path_target );
+	}
+}
+
+#endif	// EAE6320_SHADERBUILDER_H
@@ -0,0 +1,442 @@
+// Header Files
+//=============
+
+#include "TerrainBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include "../AssetBuildLibrary/LuaAssets.h"
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+#include "../../Engine/Graphics/TerrainFormats.h"
+#include "../../Engine/Platform/Platform.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	struct sNoiseDescription
+	{
+		unsigned int seed;
+		unsigned int octaveCount;
+		// In samples
+		float wavelength;
+		float persistence;
+
+		sNoiseDescription() : seed( 1 ), octaveCount( 6 ), wavelength( 256.0f ), persistence( 0.5f ) {}
+	};
+	struct sTerrainDescription
+	{
+		// This is relative to the authored terrain (and empty if the heights are generated)
+		std::string heightMap;
+		sNoiseDescription noise;
+		bool isNoiseUsed;
+		unsigned int sampleCountX, sampleCountZ;
+		unsigned int tileSampleCount;
+		float sampleSpacing;
+		float heightMin, heightMax;
+
+		sTerrainDescription()
+			: isNoiseUsed( false ), sampleCountX( 0 ), sampleCountZ( 0 ), tileSampleCount( 65 ),
+			sampleSpacing( 1.0f ), heightMin( 0.0f ), heightMax( 100.0f )
+		{
+
+		}
+	};
+
+	bool LoadTerrainDescription( const char* const i_path, sTerrainDescription& o_description );
+	bool LoadHeightMap( const char* const i_path_source, const sTerrainDescription& i_description, std::vector<uint16_t>& o_samples );
+	void GenerateNoise( const sTerrainDescription& i_description, std::vector<uint16_t>& o_samples );
+
+	// This returns the largest vertical distance between a tile's samples and the triangles of each LOD
+	// (which is in sample units; a LOD's error is never less than the previous LOD's)
+	void CalculateGeometricErrors( const uint16_t* const i_samples, const unsigned int i_sampleCount, const unsigned int i_lodCount,
+		float* const o_geometricErrors );
+	// Interleaving the bits of the coordinates gives the tile's position along a Z-order curve
+	uint32_t CalculateMortonCode( const uint16_t i_x, const uint16_t i_z );
+	uint32_t HashLatticePoint( const int i_x, const int i_z, const uint32_t i_seed );
+	bool IsPowerOfTwo( const unsigned int i_value );
+}
+
+// Interface
+//==========
+
+bool eae6320::TerrainBuilder::Build( const char* const i_path_source, const char* const i_path_target )
+{
+	bool wereThereErrors = false;
+
+	sTerrainDescription description;
+	std::vector<uint16_t> samples;
+	unsigned int tileCountX = 0, tileCountZ = 0;
+	unsigned int lodCount = 0;
+
+	if ( !LoadTerrainDescription( i_path_source, description ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	if ( description.isNoiseUsed )
+	{
+		GenerateNoise( description, samples );
+	}
+	else if ( !LoadHeightMap( i_path_source, description, samples ) )
+	{
+		wereThereErrors = true;
+		goto OnExit;
+	}
+	{
+		const unsigned int tileQuadCount = description.tileSampleCount - 1;
+		tileCountX = ( description.sampleCountX - 1 + tileQuadCount - 1 ) / tileQuadCount;
+		tileCountZ = ( description.sampleCountZ - 1 + tileQuadCount - 1 ) / tileQuadCount;
+		for ( lodCount = 1; ( 1u << ( lodCount - 1 ) ) < tileQuadCount; ++lodCount );
+		const uint64_t fileSize = sizeof( Graphics::TerrainFormats::sHeader )
+			+ ( static_cast<uint64_t>( tileCountX ) * tileCountZ
+				* ( sizeof( Graphics::TerrainFormats::sTile ) + ( description.tileSampleCount * description.tileSampleCount * sizeof( uint16_t ) ) ) );
+		if ( ( tileCountX > 0xffff ) || ( tileCountZ > 0xffff ) || ( fileSize > 0xffffffff ) )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( "The terrain is too big to be stored in a single file", i_path_source );
+			goto OnExit;
+		}
+	}
+	// Cut the samples into tiles
+	{
+		const unsigned int sampleCount = description.tileSampleCount;
+		const unsigned int tileCount = tileCountX * tileCountZ;
+		const size_t tileSampleSize = sampleCount * sampleCount * sizeof( uint16_t );
+		const float heightScale = ( description.heightMax - description.heightMin ) / 65535.0f;
+
+		Graphics::TerrainFormats::sHeader header;
+		{
+			memset( &header, 0, sizeof( header ) );
+			header.fourCc = Graphics::TerrainFormats::s_fourCc;
+			header.version = Graphics::TerrainFormats::s_version;
+			header.tileSampleCount = static_cast<uint16_t>( sampleCount );
+			header.tileCountX = static_cast<uint16_t>( tileCountX );
+			header.tileCountZ = static_cast<uint16_t>( tileCountZ );
+			header.lodCount = static_cast<uint16_t>( lodCount );
+			header.sampleSpacing = description.sampleSpacing;
+			header.heightMin = description.heightMin;
+			header.heightScale = heightScale;
+		}
+		// The tiles' samples are written along a Z-order curve
+		std::vector<uint32_t> tileOrder( tileCount );
+		{
+			for ( unsigned int i = 0; i < tileCount; ++i )
+			{
+				tileOrder[i] = i;
+			}
+			std::sort( tileOrder.begin(), tileOrder.end(),
+				[tileCountX]( const uint32_t i_lhs, const uint32_t i_rhs )
+				{
+					return CalculateMortonCode( static_cast<uint16_t>( i_lhs % tileCountX ), static_cast<uint16_t>( i_lhs / tileCountX ) )
+						< CalculateMortonCode( static_cast<uint16_t>( i_rhs % tileCountX ), static_cast<uint16_t>( i_rhs / tileCountX ) );
+				} );
+		}
+		const size_t offset_tiles = sizeof( header );
+		const size_t offset_samples = offset_tiles + ( tileCount * sizeof( Graphics::TerrainFormats::sTile ) );
+		std::vector<uint8_t> targetData( offset_samples + ( tileCount * tileSampleSize ) );
+		Graphics::TerrainFormats::sTile* const tiles = reinterpret_cast<Graphics::TerrainFormats::sTile*>( &targetData[offset_tiles] );
+		float maxGeometricErrors[Graphics::TerrainFormats::s_maxLodCount] = { 0.0f };
+		for ( unsigned int i = 0; i < tileCount; ++i )
+		{
+			const unsigned int tileIndex = tileOrder[i];
+			const unsigned int tileX = tileIndex % tileCountX;
+			const unsigned int tileZ = tileIndex / tileCountX;
+			Graphics::TerrainFormats::sTile& tile = tiles[tileIndex];
+			memset( &tile, 0, sizeof( tile ) );
+			tile.sampleOffset = static_cast<uint32_t>( offset_samples + ( i * tileSampleSize ) );
+			uint16_t* const tileSamples = reinterpret_cast<uint16_t*>( &targetData[tile.sampleOffset] );
+			uint16_t sampleMin = 0xffff, sampleMax = 0;
+			for ( unsigned int z = 0; z < sampleCount; ++z )
+			{
+				// Samples past the edge of the heightfield repeat the last one
+				const unsigned int sourceZ = std::min( ( tileZ * ( sampleCount - 1 ) ) + z, description.sampleCountZ - 1 );
+				for ( unsigned int x = 0; x < sampleCount; ++x )
+				{
+					const unsigned int sourceX = std::min( ( tileX * ( sampleCount - 1 ) ) + x, description.sampleCountX - 1 );
+					const uint16_t sample = samples[( sourceZ * description.sampleCountX ) + sourceX];
+					tileSamples[( z * sampleCount ) + x] = sample;
+					sampleMin = std::min( sampleMin, sample );
+					sampleMax = std::max( sampleMax, sample );
+				}
+			}
+			tile.heightMin = description.heightMin + ( heightScale * sampleMin );
+			tile.heightMax = description.heightMin + ( heightScale * sampleMax );
+			CalculateGeometricErrors( tileSamples, sampleCount, lodCount, tile.geometricErrors );
+			for ( unsigned int j = 0; j < lodCount; ++j )
+			{
+				tile.geometricErrors[j] *= heightScale;
+				maxGeometricErrors[j] = std::max( maxGeometricErrors[j], tile.geometricErrors[j] );
+			}
+		}
+		memcpy( &targetData[0], &header, sizeof( header ) );
+
+		std::string errorMessage;
+		if ( !Platform::WriteBinaryFile( i_path_target, &targetData[0], targetData.size(), &errorMessage ) )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path_target );
+			goto OnExit;
+		}
+
+		std::cout << "TerrainBuilder: " << description.sampleCountX << "x" << description.sampleCountZ << " samples in "
+			<< tileCountX << "x" << tileCountZ << " tiles of " << sampleCount << "x" << sampleCount << " samples ("
+			<< lodCount << " LODs): " << targetData.size() << " bytes; max geometric error per LOD:";
+		for ( unsigned int j = 0; j < lodCount; ++j )
+		{
+			std::cout << " " << maxGeometricErrors[j];
+		}
+		std::cout << "\n";
+	}
+
+OnExit:
+
+	return !wereThereErrors;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool LoadTerrainDescription( const char* const i_path, sTerrainDescription& o_description )
+	{
+		bool wereThereErrors = false;
+
+		lua_State* const luaState = eae6320::AssetBuild::LoadLuaAsset( i_path );
+		if ( !luaState )
+		{
+			return false;
+		}
+
+		if ( !eae6320::AssetBuild::GetOptionalString( *luaState, "heightMap", i_path, o_description.heightMap )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "sampleCountX", i_path, o_description.sampleCountX )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "sampleCountZ", i_path, o_description.sampleCountZ )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "tileSampleCount", i_path, o_description.tileSampleCount )
+			|| !eae6320::AssetBuild::GetOptionalNumber( *luaState, "sampleSpacing", i_path, o_description.sampleSpacing )
+			|| !eae6320::AssetBuild::GetOptionalNumber( *luaState, "heightMin", i_path, o_description.heightMin )
+			|| !eae6320::AssetBuild::GetOptionalNumber( *luaState, "heightMax", i_path, o_description.heightMax ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+		lua_getfield( luaState, -1, "noise" );
+		if ( lua_istable( luaState, -1 ) )
+		{
+			o_description.isNoiseUsed = true;
+			sNoiseDescription& noise = o_description.noise;
+			if ( !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "seed", i_path, noise.seed )
+				|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "octaveCount", i_path, noise.octaveCount )
+				|| !eae6320::AssetBuild::GetOptionalNumber( *luaState, "wavelength", i_path, noise.wavelength )
+				|| !eae6320::AssetBuild::GetOptionalNumber( *luaState, "persistence", i_path, noise.persistence ) )
+			{
+				wereThereErrors = true;
+			}
+			else if ( ( noise.octaveCount == 0 ) || !( noise.wavelength >= 1.0f ) || !( noise.persistence > 0.0f ) )
+			{
+				wereThereErrors = true;
+				eae6320::AssetBuild::OutputErrorMessage(
+					"A terrain's noise must have at least 1 octave, a wavelength of at least 1, and a positive persistence", i_path );
+			}
+		}
+		else if ( !lua_isnil( luaState, -1 ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "A terrain's \"noise\" must be a table", i_path );
+		}
+		lua_pop( luaState, 1 );
+		if ( wereThereErrors )
+		{
+			goto OnExit;
+		}
+		if ( o_description.isNoiseUsed != o_description.heightMap.empty() )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "A terrain must have either a \"heightMap\" or \"noise\" (but not both)", i_path );
+			goto OnExit;
+		}
+		if ( ( o_description.sampleCountX < 2 ) || ( o_description.sampleCountZ < 2 ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage( "A terrain's \"sampleCountX\" and \"sampleCountZ\" must be at least 2", i_path );
+			goto OnExit;
+		}
+		if ( ( o_description.tileSampleCount < eae6320::Graphics::TerrainFormats::s_minTileSampleCount )
+			|| ( o_description.tileSampleCount > eae6320::Graphics::TerrainFormats::s_maxTileSampleCount )
+			|| !IsPowerOfTwo( o_description.tileSampleCount - 1 ) )
+		{
+			wereThereErrors = true;
+			std::ostringstream errorMessage;
+			errorMessage << "A terrain's \"tileSampleCount\" must be a power of 2 plus 1 between "
+				<< eae6320::Graphics::TerrainFormats::s_minTileSampleCount << " and " << eae6320::Graphics::TerrainFormats::s_maxTileSampleCount;
+			eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path );
+			goto OnExit;
+		}
+		if ( !( o_description.sampleSpacing > 0.0f ) || !( o_description.heightMax >= o_description.heightMin ) )
+		{
+			wereThereErrors = true;
+			eae6320::AssetBuild::OutputErrorMessage(
+				"A terrain's \"sampleSpacing\" must be positive and its \"heightMax\" can't be less than its \"heightMin\"", i_path );
+			goto OnExit;
+		}
+
+	OnExit:
+
+		lua_close( luaState );
+		return !wereThereErrors;
+	}
+
+	bool LoadHeightMap( const char* const i_path_source, const sTerrainDescription& i_description, std::vector<uint16_t>& o_samples )
+	{
+		// The height map is relative to the authored terrain
+		std::string path_heightMap = i_path_source;
+		{
+			const size_t slash = path_heightMap.find_last_of( "/\\" );
+			path_heightMap = ( slash != std::string::npos ) ? path_heightMap.substr( 0, slash + 1 ) : std::string();
+		}
+		path_heightMap += i_description.heightMap;
+
+		eae6320::Platform::sDataFromFile heightMap;
+		std::string errorMessage;
+		if ( !eae6320::Platform::LoadBinaryFile( path_heightMap.c_str(), heightMap, &errorMessage ) )
+		{
+			eae6320::AssetBuild::OutputErrorMessage( errorMessage.c_str(), path_heightMap.c_str() );
+			return false;
+		}
+		const size_t sampleCount = static_cast<size_t>( i_description.sampleCountX ) * i_description.sampleCountZ;
+		if ( heightMap.size != ( sampleCount * sizeof( uint16_t ) ) )
+		{
+			heightMap.Free();
+			std::ostringstream errorMessage;
+			errorMessage << "The height map must be exactly " << i_description.sampleCountX << "x" << i_description.sampleCountZ
+				<< " 16-bit samples (" << ( sampleCount * sizeof( uint16_t ) ) << " bytes)";
+			eae6320::AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), path_heightMap.c_str() );
+			return false;
+		}
+		o_samples.resize( sampleCount );
+		// The file is little-endian
+		const uint8_t* const bytes = reinterpret_cast<const uint8_t*>( heightMap.data );
+		for ( size_t i = 0; i < sampleCount; ++i )
+		{
+			o_samples[i] = static_cast<uint16_t>( bytes[i * 2] | ( bytes[( i * 2 ) + 1] << 8 ) );
+		}
+		heightMap.Free();
+		return true;
+	}
+
+	void GenerateNoise( const sTerrainDescription& i_description, std::vector<uint16_t>& o_samples )
+	{
+		const sNoiseDescription& noise = i_description.noise;
+		const size_t sampleCount = static_cast<size_t>( i_description.sampleCountX ) * i_description.sampleCountZ;
+		std::vector<float> heights( sampleCount, 0.0f );
+		float frequency = 1.0f / noise.wavelength;
+		float amplitude = 1.0f;
+		for ( unsigned int octave = 0; octave < noise.octaveCount; ++octave )
+		{
+			const uint32_t seed = noise.seed + ( octave * 0x9e3779b9 );
+			for ( unsigned int z = 0; z < i_description.sampleCountZ; ++z )
+			{
+				const float noiseZ = z * frequency;
+				const int latticeZ = static_cast<int>( std::floor( noiseZ ) );
+				float tz = noiseZ - latticeZ;
+				tz = tz * tz * ( 3.0f - ( 2.0f * tz ) );
+				for ( unsigned int x = 0; x < i_description.sampleCountX; ++x )
+				{
+					const float noiseX = x * frequency;
+					const int latticeX = static_cast<int>( std::floor( noiseX ) );
+					float tx = noiseX - latticeX;
+					tx = tx * tx * ( 3.0f - ( 2.0f * tx ) );
+					// Each lattice point has a random value between 0 and 1
+					// that is smoothly interpolated between
+					const float scale = 1.0f / 4294967295.0f;
+					const float v00 = HashLatticePoint( latticeX, latticeZ, seed ) * scale;
+					const float v10 = HashLatticePoint( latticeX + 1, latticeZ, seed ) * scale;
+					const float v01 = HashLatticePoint( latticeX, latticeZ + 1, seed ) * scale;
+					const float v11 = HashLatticePoint( latticeX + 1, latticeZ + 1, seed ) * scale;
+					const float v0 = v00 + ( ( v10 - v00 ) * tx );
+					const float v1 = v01 + ( ( v11 - v01 ) * tx );
+					heights[( z * i_description.sampleCountX ) + x] += ( v0 + ( ( v1 - v0 ) * tz ) ) * amplitude;
+				}
+			}
+			frequency *= 2.0f;
+			amplitude *= noise.persistence;
+		}
+		// The heights are scaled to cover every possible sample
+		const std::pair<std::vector<float>::const_iterator, std::vector<float>::const_iterator> range =
+			std::minmax_element( heights.begin(), heights.end() );
+		const float heightMin = *range.first;
+		const float heightRange = std::max( *range.second - heightMin, 1.0e-6f );
+		o_samples.resize( sampleCount );
+		for ( size_t i = 0; i < sampleCount; ++i )
+		{
+			o_samples[i] = static_cast<uint16_t>( ( ( heights[i] - heightMin ) / heightRange * 65535.0f ) + 0.5f );
+		}
+	}
+
+	void CalculateGeometricErrors( const uint16_t* const i_samples, const unsigned int i_sampleCount, const unsigned int i_lodCount,
+		float* const o_geometricErrors )
+	{
+		o_geometricErrors[0] = 0.0f;
+		for ( unsigned int lod = 1; lod < i_lodCount; ++lod )
+		{
+			const unsigned int step = 1u << lod;
+			const unsigned int cellCount = ( i_sampleCount - 1 ) / step;
+			float maxError = 0.0f;
+			for ( unsigned int z = 0; z < i_sampleCount; ++z )
+			{
+				const unsigned int cellZ = std::min( z / step, cellCount - 1 );
+				const float v = static_cast<float>( z - ( cellZ * step ) ) / step;
+				for ( unsigned int x = 0; x < i_sampleCount; ++x )
+				{
+					const unsigned int cellX = std::min( x / step, cellCount - 1 );
+					const float u = static_cast<float>( x - ( cellX * step ) ) / step;
+					const unsigned int x0 = cellX * step, z0 = cellZ * step;
+					const float h00 = i_samples[( z0 * i_sampleCount ) + x0];
+					const float h10 = i_samples[( z0 * i_sampleCount ) + x0 + step];
+					const float h01 = i_samples[( ( z0 + step ) * i_sampleCount ) + x0];
+					const float h11 = i_samples[( ( z0 + step ) * i_sampleCount ) + x0 + step];
+					// Every quad is split along the diagonal from (x0, z0) to (x0 + step, z0 + step)
+					const float height = ( v >= u )
+						? ( h00 + ( v * ( h01 - h00 ) ) + ( u * ( h11 - h01 ) ) )
+						: ( h00 + ( u * ( h10 - h00 ) ) + ( v * ( h11 - h10 ) ) );
+					maxError = std::max( maxError, std::abs( height - i_samples[( z * i_sampleCount ) + x] ) );
+				}
+			}
+			// The runtime chooses the coarsest acceptable LOD by searching from the coarsest one,
+			// which only works if the errors never decrease
+			o_geometricErrors[lod] = std::max( maxError, o_geometricErrors[lod - 1] );
+		}
+	}
+
+	uint32_t CalculateMortonCode( const uint16_t i_x, const uint16_t i_z )
+	{
+		uint32_t code = 0;
+		for ( unsigned int i = 0; i < 16; ++i )
+		{
+			code |= ( ( ( i_x >> i ) & 1u ) << ( 2 * i ) ) | ( ( ( i_z >> i ) & 1u ) << ( ( 2 * i ) + 1 ) );
+		}
+		return code;
+	}
+
+	uint32_t HashLatticePoint( const int i_x, const int i_z, const uint32_t i_seed )
+	{
+		uint32_t hash = i_seed ^ ( static_cast<uint32_t>( i_x ) * 0x8da6b343 ) ^ ( static_cast<uint32_t>( i_z ) * 0xd8163841 );
+		hash ^= hash >> 16;
+		hash *= 0x7feb352d;
+		hash ^= hash >> 15;
+		hash *= 0x846ca68b;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	bool IsPowerOfTwo( const unsigned int i_value )
+	{
+		return ( i_value != 0 ) && ( ( i_value & ( i_value - 1 ) ) == 0 );
+	}
+}
@@ -0,0 +1,54 @@
+/*
+	The TerrainBuilder cuts a heightfield into the tiles that are described in Graphics/TerrainFormats.h
+
+	An authored terrain is a Lua file that returns a table like this:
+		return
+		{
+			-- The heights are either a raw file of little-endian 16-bit samples (a row along x for each z)
+			-- that is relative to the authored terrain...
+			heightMap = "hills.r16",
+			-- ...or are generated from fractal value noise
+			-- (the noise is scaled so that its lowest point is heightMin and its highest is heightMax)
+			noise =
+			{
+				seed = 1,
+				-- Each octave has twice the frequency of the previous one
+				octaveCount = 6,
+				-- The distance between the first octave's random values (in samples)
+				wavelength = 256,
+				-- Each octave's amplitude is this much of the previous one's
+				persistence = 0.5,
+			},
+			-- How many samples the heightfield has
+			sampleCountX = 1025,
+			sampleCountZ = 1025,
+			-- These are optional:
+			-- How many samples are on each side of a tile (a power of 2 plus 1 that isn't more than 129)
+			tileSampleCount = 65,
+			-- The distance between neighboring samples
+			sampleSpacing = 1,
+			-- The heights of the lowest and highest samples
+			heightMin = 0,
+			heightMax = 100,
+		}
+
+	If the samples don't divide evenly into tiles the last samples are repeated to fill the last tiles.
+	The geometric error of every LOD of every tile is calculated here
+	so that the runtime can choose a tile's LOD without reading its samples.
+*/
+
+#ifndef EAE6320_TERRAINBUILDER_H
+#define EAE6320_TERRAINBUILDER_H
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace TerrainBuilder
+	{
+		bool Build( const char* const i_path_source, const char* const i_path_target );
+	}
+}
+
+#endif	// EAE6320_TERRAINBUILDER_H
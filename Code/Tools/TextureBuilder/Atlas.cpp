@@ -0,0 +1,321 @@
+/*
+	This file builds atlases
+
+	An authored atlas is a Lua file that returns a table like this:
+		return
+		{
+			images =
+			{
+				-- The name that the game looks the image up with = the path of the TGA (relative to the atlas file)
+				button = "Atlas/button.tga",
+			},
+			-- These are optional:
+			-- How many of the atlas texture's mips can be sampled without images bleeding into each other
+			safeMipCount = 3,
+			-- How many pixels of each image's edge are repeated around it
+			-- (the default is enough for bilinear filtering of every safe mip)
+			padding = 4,
+			-- The largest width or height that the atlas texture can grow to
+			maxDimension = 2048,
+		}
+*/
+
+// Header Files
+//=============
+
+#include "TextureBuilder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include "AtlasPacker.h"
+#include "../AssetBuildLibrary/LuaAssets.h"
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+#include "../../Engine/Graphics/AtlasFormats.h"
+#include "../../Engine/Platform/Platform.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	struct sAtlasImage
+	{
+		std::string name;
+		std::string path;
+		eae6320::TextureBuilder::sImage image;
+		// Where the image's cell (the image and its padding) is in the atlas
+		eae6320::TextureBuilder::sRectangle cell;
+	};
+	struct sAtlasDescription
+	{
+		std::vector<sAtlasImage> images;
+		unsigned int safeMipCount;
+		unsigned int padding;
+		unsigned int maxDimension;
+
+		sAtlasDescription() : safeMipCount( 3 ), padding( 0 ), maxDimension( 2048 ) {}
+	};
+
+	bool LoadAtlasDescription( const char* const i_path, sAtlasDescription& o_description );
+	void CopyImageIntoCell( const sAtlasImage& i_image, const unsigned int i_padding, eae6320::TextureBuilder::sImage& io_atlas );
+	bool SortByArea( const sAtlasImage* const i_lhs, const sAtlasImage* const i_rhs );
+	bool SortByNameHash( const eae6320::Graphics::AtlasFormats::sEntry& i_lhs, const eae6320::Graphics::AtlasFormats::sEntry& i_rhs );
+}
+
+// Interface
+//==========
+
+bool eae6320::TextureBuilder::BuildAtlas( const char* const i_path_source, const char* const i_path_target, const sOptions& i_options )
+{
+	namespace AtlasFormats = Graphics::AtlasFormats;
+
+	sAtlasDescription description;
+	if ( !LoadAtlasDescription( i_path_source, description ) )
+	{
+		return false;
+	}
+	if ( description.images.empty() )
+	{
+		AssetBuild::OutputErrorMessage( "An atlas must have at least one image", i_path_source );
+		return false;
+	}
+	if ( ( description.safeMipCount == 0 ) || ( description.safeMipCount > 8 ) )
+	{
+		AssetBuild::OutputErrorMessage( "An atlas's safeMipCount must be between 1 and 8", i_path_source );
+		return false;
+	}
+	// Every cell is aligned so that, in every safe mip,
+	// no compressed block or box-filtered texel is shared between two cells
+	const unsigned int cellAlignment = 4u << ( description.safeMipCount - 1 );
+	if ( description.padding == 0 )
+	{
+		// Bilinear filtering in mip N reads one texel outside of an image, which is 2^N texels in mip 0
+		description.padding = 1u << ( description.safeMipCount - 1 );
+	}
+
+	// Load every image
+	{
+		std::string directory( i_path_source );
+		{
+			const size_t slash = directory.find_last_of( "/\\" );
+			directory = ( slash != std::string::npos ) ? directory.substr( 0, slash + 1 ) : std::string();
+		}
+		for ( std::vector<sAtlasImage>::iterator i = description.images.begin(); i != description.images.end(); ++i )
+		{
+			if ( !LoadImage( ( directory + i->path ).c_str(), i->image ) )
+			{
+				return false;
+			}
+		}
+	}
+	// Pack the cells, largest first
+	unsigned int atlasWidth, atlasHeight;
+	{
+		std::vector<sAtlasImage*> packingOrder;
+		for ( std::vector<sAtlasImage>::iterator i = description.images.begin(); i != description.images.end(); ++i )
+		{
+			packingOrder.push_back( &*i );
+		}
+		std::stable_sort( packingOrder.begin(), packingOrder.end(), SortByArea );
+		std::vector<sRectangle> cellSizes( packingOrder.size() );
+		for ( size_t i = 0; i < packingOrder.size(); ++i )
+		{
+			const sImage& image = packingOrder[i]->image;
+			cellSizes[i].x = cellSizes[i].y = 0;
+			cellSizes[i].width = ( image.width + ( 2 * description.padding ) + ( cellAlignment - 1 ) ) & ~( cellAlignment - 1 );
+			cellSizes[i].height = ( image.height + ( 2 * description.padding ) + ( cellAlignment - 1 ) ) & ~( cellAlignment - 1 );
+		}
+		std::vector<sRectangle> cells;
+		if ( !AtlasPacker::Pack( cellSizes, description.maxDimension, atlasWidth, atlasHeight, cells ) )
+		{
+			std::ostringstream errorMessage;
+			errorMessage << "The images don't fit in a " << description.maxDimension << "x" << description.maxDimension << " atlas";
+			AssetBuild::OutputErrorMessage( errorMessage.str().c_str(), i_path_source );
+			return false;
+		}
+		for ( size_t i = 0; i < packingOrder.size(); ++i )
+		{
+			packingOrder[i]->cell = cells[i];
+		}
+	}
+	// Copy every image into the atlas and write it as a texture
+	{
+		sImage atlas;
+		atlas.width = atlasWidth;
+		atlas.height = atlasHeight;
+		atlas.pixels.resize( atlasWidth * atlasHeight * 4, 0 );
+		for ( std::vector<sAtlasImage>::const_iterator i = description.images.begin(); i != description.images.end(); ++i )
+		{
+			CopyImageIntoCell( *i, description.padding, atlas );
+		}
+		std::string path_texture( i_path_target );
+		{
+			const size_t extension = path_texture.find_last_of( '.' );
+			const size_t slash = path_texture.find_last_of( "/\\" );
+			if ( ( extension != std::string::npos ) && ( ( slash == std::string::npos ) || ( extension > slash ) ) )
+			{
+				path_texture.resize( extension );
+			}
+			path_texture += ".texture";
+		}
+		sOptions options = i_options;
+		options.maxMipCount = description.safeMipCount;
+		if ( !WriteTexture( atlas, path_texture.c_str(), options ) )
+		{
+			return false;
+		}
+	}
+	// Write the lookup table
+	{
+		std::vector<AtlasFormats::sEntry> entries( description.images.size() );
+		for ( size_t i = 0; i < description.images.size(); ++i )
+		{
+			const sAtlasImage& image = description.images[i];
+			AtlasFormats::sEntry& entry = entries[i];
+			entry.nameHash = AtlasFormats::CalculateNameHash( image.name.c_str() );
+			entry.u0 = static_cast<float>( image.cell.x + description.padding ) / static_cast<float>( atlasWidth );
+			entry.v0 = static_cast<float>( image.cell.y + description.padding ) / static_cast<float>( atlasHeight );
+			entry.u1 = static_cast<float>( image.cell.x + description.padding + image.image.width ) / static_cast<float>( atlasWidth );
+			entry.v1 = static_cast<float>( image.cell.y + description.padding + image.image.height ) / static_cast<float>( atlasHeight );
+			entry.width = static_cast<uint16_t>( image.image.width );
+			entry.height = static_cast<uint16_t>( image.image.height );
+		}
+		std::sort( entries.begin(), entries.end(), SortByNameHash );
+		for ( size_t i = 1; i < entries.size(); ++i )
+		{
+			if ( entries[i].nameHash == entries[i - 1].nameHash )
+			{
+				AssetBuild::OutputErrorMessage( "Two image names in the atlas have the same hash; one of them must be renamed", i_path_source );
+				return false;
+			}
+		}
+
+		AtlasFormats::sHeader header;
+		memset( &header, 0, sizeof( header ) );
+		header.fourCc = AtlasFormats::s_fourCc;
+		header.version = AtlasFormats::s_version;
+		header.entryCount = static_cast<uint32_t>( entries.size() );
+		header.width = static_cast<uint16_t>( atlasWidth );
+		header.height = static_cast<uint16_t>( atlasHeight );
+		std::vector<uint8_t> targetData( sizeof( header ) + ( entries.size() * sizeof( AtlasFormats::sEntry ) ) );
+		memcpy( &targetData[0], &header, sizeof( header ) );
+		memcpy( &targetData[sizeof( header )], &entries[0], entries.size() * sizeof( AtlasFormats::sEntry ) );
+		std::string errorMessage;
+		if ( !Platform::WriteBinaryFile( i_path_target, &targetData[0], targetData.size(), &errorMessage ) )
+		{
+			AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path_target );
+			return false;
+		}
+	}
+	// Report how well the atlas was packed
+	{
+		unsigned int imageArea = 0, cellArea = 0;
+		for ( std::vector<sAtlasImage>::const_iterator i = description.images.begin(); i != description.images.end(); ++i )
+		{
+			imageArea += i->image.width * i->image.height;
+			cellArea += i->cell.width * i->cell.height;
+		}
+		const double atlasArea = static_cast<double>( atlasWidth * atlasHeight );
+		std::cout << "TextureBuilder: Packed " << description.images.size() << " images into a " << atlasWidth << "x" << atlasHeight
+			<< " atlas (" << ( 100.0 * imageArea / atlasArea ) << "% occupied by images, "
+			<< ( 100.0 * cellArea / atlasArea ) << "% including padding; " << description.safeMipCount << " safe mips)\n";
+	}
+
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool LoadAtlasDescription( const char* const i_path, sAtlasDescription& o_description )
+	{
+		bool wereThereErrors = false;
+
+		lua_State* const luaState = eae6320::AssetBuild::LoadLuaAsset( i_path );
+		if ( !luaState )
+		{
+			return false;
+		}
+
+		// Images
+		{
+			lua_getfield( luaState, -1, "images" );
+			if ( !lua_istable( luaState, -1 ) )
+			{
+				wereThereErrors = true;
+				eae6320::AssetBuild::OutputErrorMessage( "An atlas's \"images\" must be a table of names and paths", i_path );
+				goto OnExit;
+			}
+			lua_pushnil( luaState );
+			while ( lua_next( luaState, -2 ) != 0 )
+			{
+				if ( ( lua_type( luaState, -2 ) != LUA_TSTRING ) || ( lua_type( luaState, -1 ) != LUA_TSTRING ) )
+				{
+					wereThereErrors = true;
+					eae6320::AssetBuild::OutputErrorMessage( "Every image in an atlas must be a name = \"path\" pair", i_path );
+					goto OnExit;
+				}
+				sAtlasImage image;
+				image.name = lua_tostring( luaState, -2 );
+				image.path = lua_tostring( luaState, -1 );
+				image.cell.x = image.cell.y = image.cell.width = image.cell.height = 0;
+				o_description.images.push_back( image );
+				lua_pop( luaState, 1 );
+			}
+			lua_pop( luaState, 1 );
+			// Lua tables aren't ordered, and so the images are sorted to make every build of the atlas identical
+			struct
+			{
+				bool operator()( const sAtlasImage& i_lhs, const sAtlasImage& i_rhs ) const { return i_lhs.name < i_rhs.name; }
+			} sortByName;
+			std::sort( o_description.images.begin(), o_description.images.end(), sortByName );
+		}
+		// Options
+		if ( !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "safeMipCount", i_path, o_description.safeMipCount )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "padding", i_path, o_description.padding )
+			|| !eae6320::AssetBuild::GetOptionalUnsignedInteger( *luaState, "maxDimension", i_path, o_description.maxDimension ) )
+		{
+			wereThereErrors = true;
+			goto OnExit;
+		}
+
+	OnExit:
+
+		lua_close( luaState );
+		return !wereThereErrors;
+	}
+
+	void CopyImageIntoCell( const sAtlasImage& i_image, const unsigned int i_padding, eae6320::TextureBuilder::sImage& io_atlas )
+	{
+		// The image's edge pixels are repeated to fill the entire cell
+		// so that filtering and mip generation near the edge only ever see the image's own colors
+		const eae6320::TextureBuilder::sImage& image = i_image.image;
+		for ( unsigned int y = 0; y < i_image.cell.height; ++y )
+		{
+			int sourceY = static_cast<int>( y ) - static_cast<int>( i_padding );
+			sourceY = ( sourceY < 0 ) ? 0 : ( ( sourceY >= static_cast<int>( image.height ) ) ? ( image.height - 1 ) : sourceY );
+			uint8_t* const row_target = &io_atlas.pixels[( ( ( i_image.cell.y + y ) * io_atlas.width ) + i_image.cell.x ) * 4];
+			const uint8_t* const row_source = &image.pixels[sourceY * image.width * 4];
+			for ( unsigned int x = 0; x < i_image.cell.width; ++x )
+			{
+				int sourceX = static_cast<int>( x ) - static_cast<int>( i_padding );
+				sourceX = ( sourceX < 0 ) ? 0 : ( ( sourceX >= static_cast<int>( image.width ) ) ? ( image.width - 1 ) : sourceX );
+				memcpy( row_target + ( x * 4 ), row_source + ( sourceX * 4 ), 4 );
+			}
+		}
+	}
+
+	bool SortByArea( const sAtlasImage* const i_lhs, const sAtlasImage* const i_rhs )
+	{
+		return ( i_lhs->image.width * i_lhs->image.height ) > ( i_rhs->image.width * i_rhs->image.height );
+	}
+
+	bool SortByNameHash( const eae6320::Graphics::AtlasFormats::sEntry& i_lhs, const eae6320::Graphics::AtlasFormats::sEntry& i_rhs )
+	{
+		return i_lhs.nameHash < i_rhs.nameHash;
+	}
+}
@@ -0,0 +1,240 @@
+// Header Files
+//=============
+
+#include "AtlasPacker.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	bool DoRectanglesOverlap( const eae6320::TextureBuilder::sRectangle& i_a, const eae6320::TextureBuilder::sRectangle& i_b );
+	bool IsRectangleContained( const eae6320::TextureBuilder::sRectangle& i_inner, const eae6320::TextureBuilder::sRectangle& i_outer );
+	unsigned int RoundUpToPowerOfTwo( const unsigned int i_value );
+}
+
+// Interface
+//==========
+
+// Packing
+//--------
+
+bool eae6320::TextureBuilder::AtlasPacker::Insert( const unsigned int i_width, const unsigned int i_height, sRectangle& o_placement )
+{
+	// Find the free rectangle that the new one fits best in
+	// (ties are broken by the longer side so that long thin spaces are kept for long thin images)
+	const sRectangle* bestFreeRectangle = NULL;
+	{
+		unsigned int bestShortSideFit = ~0u;
+		unsigned int bestLongSideFit = ~0u;
+		for ( std::vector<sRectangle>::const_iterator i = m_freeRectangles.begin(); i != m_freeRectangles.end(); ++i )
+		{
+			if ( ( i->width >= i_width ) && ( i->height >= i_height ) )
+			{
+				const unsigned int leftoverX = i->width - i_width;
+				const unsigned int leftoverY = i->height - i_height;
+				const unsigned int shortSideFit = ( leftoverX < leftoverY ) ? leftoverX : leftoverY;
+				const unsigned int longSideFit = ( leftoverX < leftoverY ) ? leftoverY : leftoverX;
+				if ( ( shortSideFit < bestShortSideFit ) || ( ( shortSideFit == bestShortSideFit ) && ( longSideFit < bestLongSideFit ) ) )
+				{
+					bestFreeRectangle = &*i;
+					bestShortSideFit = shortSideFit;
+					bestLongSideFit = longSideFit;
+				}
+			}
+		}
+	}
+	if ( bestFreeRectangle )
+	{
+		o_placement.x = bestFreeRectangle->x;
+		o_placement.y = bestFreeRectangle->y;
+		o_placement.width = i_width;
+		o_placement.height = i_height;
+		SplitFreeRectangles( o_placement );
+		RemoveContainedFreeRectangles();
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+bool eae6320::TextureBuilder::AtlasPacker::Pack( const std::vector<sRectangle>& i_sizes, const unsigned int i_maxDimension,
+	unsigned int& o_width, unsigned int& o_height, std::vector<sRectangle>& o_placements )
+{
+	// Start with the smallest atlas that could possibly fit everything
+	unsigned int width = 1, height = 1;
+	{
+		unsigned int totalArea = 0;
+		for ( std::vector<sRectangle>::const_iterator i = i_sizes.begin(); i != i_sizes.end(); ++i )
+		{
+			width = ( i->width > width ) ? i->width : width;
+			height = ( i->height > height ) ? i->height : height;
+			totalArea += i->width * i->height;
+		}
+		width = RoundUpToPowerOfTwo( width );
+		height = RoundUpToPowerOfTwo( height );
+		while ( ( width * height ) < totalArea )
+		{
+			if ( width <= height )
+			{
+				width *= 2;
+			}
+			else
+			{
+				height *= 2;
+			}
+		}
+	}
+	// Keep doubling the shorter side until everything fits
+	while ( ( width <= i_maxDimension ) && ( height <= i_maxDimension ) )
+	{
+		AtlasPacker packer( width, height );
+		o_placements.resize( i_sizes.size() );
+		bool didEverythingFit = true;
+		for ( size_t i = 0; i < i_sizes.size(); ++i )
+		{
+			if ( !packer.Insert( i_sizes[i].width, i_sizes[i].height, o_placements[i] ) )
+			{
+				didEverythingFit = false;
+				break;
+			}
+		}
+		if ( didEverythingFit )
+		{
+			o_width = width;
+			o_height = height;
+			return true;
+		}
+		if ( ( width <= height ) && ( ( width * 2 ) <= i_maxDimension ) )
+		{
+			width *= 2;
+		}
+		else
+		{
+			height *= 2;
+		}
+	}
+	return false;
+}
+
+// Initialization / Clean Up
+//--------------------------
+
+eae6320::TextureBuilder::AtlasPacker::AtlasPacker( const unsigned int i_width, const unsigned int i_height )
+{
+	const sRectangle everything = { 0, 0, i_width, i_height };
+	m_freeRectangles.push_back( everything );
+}
+
+// Implementation
+//===============
+
+void eae6320::TextureBuilder::AtlasPacker::SplitFreeRectangles( const sRectangle& i_placement )
+{
+	// Every free rectangle that the placed one overlaps is replaced by the (up to four) maximal rectangles around it
+	const size_t freeRectangleCount = m_freeRectangles.size();
+	for ( size_t i = 0; i < freeRectangleCount; ++i )
+	{
+		const sRectangle freeRectangle = m_freeRectangles[i];
+		if ( !DoRectanglesOverlap( freeRectangle, i_placement ) )
+		{
+			continue;
+		}
+		// Mark the old rectangle for removal
+		m_freeRectangles[i].width = 0;
+
+		const unsigned int freeRight = freeRectangle.x + freeRectangle.width;
+		const unsigned int freeBottom = freeRectangle.y + freeRectangle.height;
+		const unsigned int placementRight = i_placement.x + i_placement.width;
+		const unsigned int placementBottom = i_placement.y + i_placement.height;
+		if ( i_placement.x > freeRectangle.x )
+		{
+			const sRectangle left = { freeRectangle.x, freeRectangle.y, i_placement.x - freeRectangle.x, freeRectangle.height };
+			m_freeRectangles.push_back( left );
+		}
+		if ( placementRight < freeRight )
+		{
+			const sRectangle right = { placementRight, freeRectangle.y, freeRight - placementRight, freeRectangle.height };
+			m_freeRectangles.push_back( right );
+		}
+		if ( i_placement.y > freeRectangle.y )
+		{
+			const sRectangle top = { freeRectangle.x, freeRectangle.y, freeRectangle.width, i_placement.y - freeRectangle.y };
+			m_freeRectangles.push_back( top );
+		}
+		if ( placementBottom < freeBottom )
+		{
+			const sRectangle bottom = { freeRectangle.x, placementBottom, freeRectangle.width, freeBottom - placementBottom };
+			m_freeRectangles.push_back( bottom );
+		}
+	}
+}
+
+void eae6320::TextureBuilder::AtlasPacker::RemoveContainedFreeRectangles()
+{
+	// Remove the rectangles that were split as well as any that are entirely inside of another one
+	// (they can never be a better fit than the one that contains them)
+	for ( size_t i = 0; i < m_freeRectangles.size(); ++i )
+	{
+		if ( m_freeRectangles[i].width == 0 )
+		{
+			continue;
+		}
+		for ( size_t j = i + 1; j < m_freeRectangles.size(); ++j )
+		{
+			if ( m_freeRectangles[j].width == 0 )
+			{
+				continue;
+			}
+			if ( IsRectangleContained( m_freeRectangles[i], m_freeRectangles[j] ) )
+			{
+				m_freeRectangles[i].width = 0;
+				break;
+			}
+			if ( IsRectangleContained( m_freeRectangles[j], m_freeRectangles[i] ) )
+			{
+				m_freeRectangles[j].width = 0;
+			}
+		}
+	}
+	size_t keptCount = 0;
+	for ( size_t i = 0; i < m_freeRectangles.size(); ++i )
+	{
+		if ( m_freeRectangles[i].width != 0 )
+		{
+			m_freeRectangles[keptCount++] = m_freeRectangles[i];
+		}
+	}
+	m_freeRectangles.resize( keptCount );
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	bool DoRectanglesOverlap( const eae6320::TextureBuilder::sRectangle& i_a, const eae6320::TextureBuilder::sRectangle& i_b )
+	{
+		return ( i_a.x < ( i_b.x + i_b.width ) ) && ( i_b.x < ( i_a.x + i_a.width ) )
+			&& ( i_a.y < ( i_b.y + i_b.height ) ) && ( i_b.y < ( i_a.y + i_a.height ) );
+	}
+
+	bool IsRectangleContained( const eae6320::TextureBuilder::sRectangle& i_inner, const eae6320::TextureBuilder::sRectangle& i_outer )
+	{
+		return ( i_inner.x >= i_outer.x ) && ( i_inner.y >= i_outer.y )
+			&& ( ( i_inner.x + i_inner.width ) <= ( i_outer.x + i_outer.width ) )
+			&& ( ( i_inner.y + i_inner.height ) <= ( i_outer.y + i_outer.height ) );
+	}
+
+	unsigned int RoundUpToPowerOfTwo( const unsigned int i_value )
+	{
+		unsigned int powerOfTwo = 1;
+		while ( powerOfTwo < i_value )
+		{
+			powerOfTwo *= 2;
+		}
+		return powerOfTwo;
+	}
+}
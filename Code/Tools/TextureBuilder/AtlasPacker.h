@@ -0,0 +1,71 @@
+/*
+	The atlas packer decides where each image of an atlas goes
+
+	It uses the MaxRects algorithm:
+	Every free area of the atlas is tracked as a (possibly overlapping) rectangle,
+	and each new rectangle is placed in the free rectangle that it fits most snugly
+	(the one with the smallest leftover along its shorter side).
+	Rectangles are never rotated, so that texture coordinates can be used unchanged.
+*/
+
+#ifndef EAE6320_TEXTUREBUILDER_ATLASPACKER_H
+#define EAE6320_TEXTUREBUILDER_ATLASPACKER_H
+
+// Header Files
+//=============
+
+#include <cstddef>
+#include <vector>
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace TextureBuilder
+	{
+		struct sRectangle
+		{
+			unsigned int x, y;
+			unsigned int width, height;
+		};
+
+		class AtlasPacker
+		{
+		public:
+
+			// Packing
+			//--------
+
+			// Returns false if there isn't room for the rectangle
+			bool Insert( const unsigned int i_width, const unsigned int i_height, sRectangle& o_placement );
+
+			// Packs every size (in the order given) into the smallest power-of-two atlas that they fit in.
+			// Returns false if they don't fit in an atlas with the maximum dimension.
+			static bool Pack( const std::vector<sRectangle>& i_sizes, const unsigned int i_maxDimension,
+				unsigned int& o_width, unsigned int& o_height, std::vector<sRectangle>& o_placements );
+
+			// Initialization / Clean Up
+			//--------------------------
+
+			AtlasPacker( const unsigned int i_width, const unsigned int i_height );
+
+			// Implementation
+			//===============
+
+		private:
+
+			void SplitFreeRectangles( const sRectangle& i_placement );
+			void RemoveContainedFreeRectangles();
+
+			// Data
+			//=====
+
+		private:
+
+			std::vector<sRectangle> m_freeRectangles;
+		};
+	}
+}
+
+#endif	// EAE6320_TEXTUREBUILDER_ATLASPACKER_H
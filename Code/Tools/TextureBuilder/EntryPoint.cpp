@@ -0,0 +1,104 @@
+/*
+	The main() function is where the program starts execution
+*/
+
+// Header Files
+//=============
+
+#include <cstdlib>
+#include <cstring>
+#include "TextureBuilder.h"
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+
+// Entry Point
+//============
+
+int main( int i_argumentCount, char** i_arguments )
+{
+	// The command line should have the source path, the target path,
+	// and then optionally any of the following:
+	//	linear: The texture doesn't store color
+	//	uncompressed: The texture shouldn't be block-compressed
+	//	bc1, bc3, bc4, bc5, bc7: The texture should use this block-compressed format
+	//		(by default BC1 is used for opaque images and BC3 for images with alpha)
+	//	fast, normal, high: How much time should be spent looking for the best compressed blocks
+	// Alternatively, if the first argument is "benchmark"
+	// then every remaining argument is a source image that will be compressed with every format and quality
+	// (Assets/TextureBenchmark has a small corpus of representative images for this).
+	// If the source is an ".atlas" file then the images it lists are packed into an atlas
+	// (the same options are used for the atlas texture).
+	if ( ( i_argumentCount >= 2 ) && ( strcmp( i_arguments[1], "benchmark" ) == 0 ) )
+	{
+		return eae6320::TextureBuilder::Benchmark( i_arguments + 2, static_cast<unsigned int>( i_argumentCount - 2 ) ) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if ( i_argumentCount < 3 )
+	{
+		eae6320::AssetBuild::OutputErrorMessage( "The TextureBuilder must be called with a source path and a target path" );
+		return EXIT_FAILURE;
+	}
+	const char* const path_source = i_arguments[1];
+	const char* const path_target = i_arguments[2];
+	eae6320::TextureBuilder::sOptions options;
+	for ( int i = 3; i < i_argumentCount; ++i )
+	{
+		if ( strcmp( i_arguments[i], "linear" ) == 0 )
+		{
+			options.isSrgb = false;
+		}
+		else if ( strcmp( i_arguments[i], "uncompressed" ) == 0 )
+		{
+			options.format = eae6320::Graphics::TextureFormats::eFormat::R8G8B8A8;
+		}
+		else if ( strcmp( i_arguments[i], "bc1" ) == 0 )
+		{
+			options.format = eae6320::Graphics::TextureFormats::eFormat::BC1;
+		}
+		else if ( strcmp( i_arguments[i], "bc3" ) == 0 )
+		{
+			options.format = eae6320::Graphics::TextureFormats::eFormat::BC3;
+		}
+		else if ( strcmp( i_arguments[i], "bc4" ) == 0 )
+		{
+			options.format = eae6320::Graphics::TextureFormats::eFormat::BC4;
+		}
+		else if ( strcmp( i_arguments[i], "bc5" ) == 0 )
+		{
+			options.format = eae6320::Graphics::TextureFormats::eFormat::BC5;
+		}
+		else if ( strcmp( i_arguments[i], "bc7" ) == 0 )
+		{
+			options.format = eae6320::Graphics::TextureFormats::eFormat::BC7;
+		}
+		else if ( strcmp( i_arguments[i], "fast" ) == 0 )
+		{
+			options.quality = eae6320::AssetBuild::BlockCompression::eQuality::Fast;
+		}
+		else if ( strcmp( i_arguments[i], "normal" ) == 0 )
+		{
+			options.quality = eae6320::AssetBuild::BlockCompression::eQuality::Normal;
+		}
+		else if ( strcmp( i_arguments[i], "high" ) == 0 )
+		{
+			options.quality = eae6320::AssetBuild::BlockCompression::eQuality::High;
+		}
+		else
+		{
+			eae6320::AssetBuild::OutputErrorMessage( "Unknown TextureBuilder option", i_arguments[i] );
+			return EXIT_FAILURE;
+		}
+	}
+
+	bool isSourceAnAtlas;
+	{
+		const char* const extension = strrchr( path_source, '.' );
+		isSourceAnAtlas = extension && ( _stricmp( extension, ".atlas" ) == 0 );
+	}
+	if ( isSourceAnAtlas )
+	{
+		return eae6320::TextureBuilder::BuildAtlas( path_source, path_target, options ) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	else
+	{
+		return eae6320::TextureBuilder::Build( path_source, path_target, options ) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+}
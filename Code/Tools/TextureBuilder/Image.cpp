@@ -0,0 +1,260 @@
+// Header Files
+//=============
+
+#include "Image.h"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <emmintrin.h>
+
+// Static Data Initialization
+//===========================
+
+namespace
+{
+	// Linear values are quantized to this many steps before being converted back to sRGB
+	// (this needs to be finer than 8 bits because sRGB has more precision in the darks)
+	const unsigned int s_linearStepCount = 8192;
+
+	float s_srgbToLinear[256];
+	float s_unormToFloat[256];
+	uint8_t s_linearToSrgb[s_linearStepCount];
+	bool s_areTablesInitialized = false;
+}
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void InitializeTablesIfNecessary();
+	__m128 LoadPixel( const uint8_t* const i_pixel, const float* const i_colorTable );
+}
+
+// Interface
+//==========
+
+bool eae6320::TextureBuilder::sImage::HasTransparency() const
+{
+	const size_t pixelCount = static_cast<size_t>( width ) * height;
+	for ( size_t i = 0; i < pixelCount; ++i )
+	{
+		if ( pixels[( i * 4 ) + 3] != 0xff )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+// Decoding
+//---------
+
+bool eae6320::TextureBuilder::DecodeTga( const void* const i_data, const size_t i_size, sImage& o_image, std::string* const o_errorMessage )
+{
+	const uint8_t* const data = reinterpret_cast<const uint8_t*>( i_data );
+	const size_t headerSize = 18;
+	if ( i_size < headerSize )
+	{
+		if ( o_errorMessage )
+		{
+			*o_errorMessage = "The file is too small to be a TGA";
+		}
+		return false;
+	}
+
+	// Parse the header
+	const unsigned int idLength = data[0];
+	const unsigned int colorMapType = data[1];
+	const unsigned int imageType = data[2];
+	const unsigned int width = data[12] | ( data[13] << 8 );
+	const unsigned int height = data[14] | ( data[15] << 8 );
+	const unsigned int bitsPerPixel = data[16];
+	const unsigned int descriptor = data[17];
+	const bool isRunLengthEncoded = imageType >= 9;
+	const bool isGrayscale = ( imageType == 3 ) || ( imageType == 11 );
+	{
+		std::ostringstream errorMessage;
+		if ( colorMapType != 0 )
+		{
+			errorMessage << "Color-mapped TGAs aren't supported";
+		}
+		else if ( ( imageType != 2 ) && ( imageType != 3 ) && ( imageType != 10 ) && ( imageType != 11 ) )
+		{
+			errorMessage << "TGA image type " << imageType << " isn't supported";
+		}
+		else if ( isGrayscale ? ( bitsPerPixel != 8 ) : ( ( bitsPerPixel != 24 ) && ( bitsPerPixel != 32 ) ) )
+		{
+			errorMessage << "TGAs with " << bitsPerPixel << " bits per pixel aren't supported";
+		}
+		else if ( ( width == 0 ) || ( height == 0 ) )
+		{
+			errorMessage << "The TGA has no pixels";
+		}
+		const std::string errorString = errorMessage.str();
+		if ( !errorString.empty() )
+		{
+			if ( o_errorMessage )
+			{
+				*o_errorMessage = errorString;
+			}
+			return false;
+		}
+	}
+
+	o_image.width = width;
+	o_image.height = height;
+	o_image.pixels.resize( static_cast<size_t>( width ) * height * 4 );
+
+	// TGAs store BGR(A) and, unless the descriptor says otherwise, start at the bottom row
+	const unsigned int bytesPerPixel = bitsPerPixel / 8;
+	const bool isTopToBottom = ( descriptor & ( 1 << 5 ) ) != 0;
+	const uint8_t* source = data + headerSize + idLength;
+	const uint8_t* const sourceEnd = data + i_size;
+	const size_t pixelCount = static_cast<size_t>( width ) * height;
+	size_t pixelIndex = 0;
+	while ( pixelIndex < pixelCount )
+	{
+		// Every run-length packet starts with a header byte
+		size_t runLength = 1;
+		bool isRepeated = false;
+		if ( isRunLengthEncoded )
+		{
+			if ( source >= sourceEnd )
+			{
+				break;
+			}
+			const uint8_t packetHeader = *source++;
+			runLength = ( packetHeader & 0x7f ) + 1;
+			isRepeated = ( packetHeader & 0x80 ) != 0;
+		}
+		else
+		{
+			runLength = pixelCount;
+		}
+		if ( ( pixelIndex + runLength ) > pixelCount )
+		{
+			runLength = pixelCount - pixelIndex;
+		}
+		const size_t sourceByteCount = isRepeated ? bytesPerPixel : ( runLength * bytesPerPixel );
+		if ( static_cast<size_t>( sourceEnd - source ) < sourceByteCount )
+		{
+			break;
+		}
+		for ( size_t i = 0; i < runLength; ++i, ++pixelIndex )
+		{
+			const uint8_t* const sourcePixel = source + ( isRepeated ? 0 : ( i * bytesPerPixel ) );
+			const size_t x = pixelIndex % width;
+			const size_t y = isTopToBottom ? ( pixelIndex / width ) : ( height - 1 - ( pixelIndex / width ) );
+			uint8_t* const targetPixel = &o_image.pixels[( ( y * width ) + x ) * 4];
+			if ( isGrayscale )
+			{
+				targetPixel[0] = targetPixel[1] = targetPixel[2] = sourcePixel[0];
+				targetPixel[3] = 0xff;
+			}
+			else
+			{
+				targetPixel[0] = sourcePixel[2];
+				targetPixel[1] = sourcePixel[1];
+				targetPixel[2] = sourcePixel[0];
+				targetPixel[3] = ( bytesPerPixel == 4 ) ? sourcePixel[3] : 0xff;
+			}
+		}
+		source += sourceByteCount;
+	}
+	if ( pixelIndex != pixelCount )
+	{
+		if ( o_errorMessage )
+		{
+			std::ostringstream errorMessage;
+			errorMessage << "The TGA ended after " << pixelIndex << " of its " << pixelCount << " pixels";
+			*o_errorMessage = errorMessage.str();
+		}
+		return false;
+	}
+
+	return true;
+}
+
+// Mip Maps
+//---------
+
+void eae6320::TextureBuilder::GenerateNextMip( const sImage& i_source, const bool i_isSrgb, sImage& o_mip )
+{
+	InitializeTablesIfNecessary();
+
+	o_mip.width = ( i_source.width > 1 ) ? ( i_source.width / 2 ) : 1;
+	o_mip.height = ( i_source.height > 1 ) ? ( i_source.height / 2 ) : 1;
+	o_mip.pixels.resize( static_cast<size_t>( o_mip.width ) * o_mip.height * 4 );
+
+	const float* const colorTable = i_isSrgb ? s_srgbToLinear : s_unormToFloat;
+	// The 4 source pixels are averaged, and then the color channels are scaled to an index into the sRGB table
+	// while the alpha channel (which is always linear) is scaled straight to [0,255]
+	const float colorScale = i_isSrgb ? static_cast<float>( s_linearStepCount - 1 ) : 255.0f;
+	const __m128 scale = _mm_mul_ps( _mm_set1_ps( 0.25f ), _mm_setr_ps( colorScale, colorScale, colorScale, 255.0f ) );
+	const __m128 half = _mm_set1_ps( 0.5f );
+
+	const uint8_t* const sourcePixels = &i_source.pixels[0];
+	uint8_t* const mipPixels = &o_mip.pixels[0];
+	for ( unsigned int y = 0; y < o_mip.height; ++y )
+	{
+		// Odd dimensions are handled by clamping to the last row/column
+		const unsigned int sourceY0 = y * 2;
+		const unsigned int sourceY1 = ( ( sourceY0 + 1 ) < i_source.height ) ? ( sourceY0 + 1 ) : sourceY0;
+		const uint8_t* const row0 = sourcePixels + ( static_cast<size_t>( sourceY0 ) * i_source.width * 4 );
+		const uint8_t* const row1 = sourcePixels + ( static_cast<size_t>( sourceY1 ) * i_source.width * 4 );
+		for ( unsigned int x = 0; x < o_mip.width; ++x )
+		{
+			const unsigned int sourceX0 = x * 2;
+			const unsigned int sourceX1 = ( ( sourceX0 + 1 ) < i_source.width ) ? ( sourceX0 + 1 ) : sourceX0;
+			__m128 sum = LoadPixel( row0 + ( sourceX0 * 4 ), colorTable );
+			sum = _mm_add_ps( sum, LoadPixel( row0 + ( sourceX1 * 4 ), colorTable ) );
+			sum = _mm_add_ps( sum, LoadPixel( row1 + ( sourceX0 * 4 ), colorTable ) );
+			sum = _mm_add_ps( sum, LoadPixel( row1 + ( sourceX1 * 4 ), colorTable ) );
+			const __m128i rounded = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( sum, scale ), half ) );
+			int32_t values[4];
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( values ), rounded );
+
+			uint8_t* const mipPixel = mipPixels + ( ( ( static_cast<size_t>( y ) * o_mip.width ) + x ) * 4 );
+			for ( unsigned int c = 0; c < 3; ++c )
+			{
+				mipPixel[c] = i_isSrgb ? s_linearToSrgb[values[c]] : static_cast<uint8_t>( values[c] );
+			}
+			mipPixel[3] = static_cast<uint8_t>( values[3] );
+		}
+	}
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void InitializeTablesIfNecessary()
+	{
+		if ( s_areTablesInitialized )
+		{
+			return;
+		}
+
+		for ( unsigned int i = 0; i < 256; ++i )
+		{
+			const float value = static_cast<float>( i ) / 255.0f;
+			s_unormToFloat[i] = value;
+			s_srgbToLinear[i] = ( value <= 0.04045f ) ? ( value / 12.92f ) : std::pow( ( value + 0.055f ) / 1.055f, 2.4f );
+		}
+		for ( unsigned int i = 0; i < s_linearStepCount; ++i )
+		{
+			const float value = static_cast<float>( i ) / static_cast<float>( s_linearStepCount - 1 );
+			const float srgb = ( value <= 0.0031308f ) ? ( value * 12.92f ) : ( ( 1.055f * std::pow( value, 1.0f / 2.4f ) ) - 0.055f );
+			s_linearToSrgb[i] = static_cast<uint8_t>( ( srgb * 255.0f ) + 0.5f );
+		}
+		s_areTablesInitialized = true;
+	}
+
+	__m128 LoadPixel( const uint8_t* const i_pixel, const float* const i_colorTable )
+	{
+		return _mm_setr_ps( i_colorTable[i_pixel[0]], i_colorTable[i_pixel[1]], i_colorTable[i_pixel[2]], s_unormToFloat[i_pixel[3]] );
+	}
+}
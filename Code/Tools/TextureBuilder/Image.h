@@ -0,0 +1,55 @@
+/*
+	An image is an uncompressed array of RGBA8 pixels
+	that the TextureBuilder works with before it is compressed
+*/
+
+#ifndef EAE6320_TEXTUREBUILDER_IMAGE_H
+#define EAE6320_TEXTUREBUILDER_IMAGE_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#ifndef NULL
+	#define NULL 0
+#endif
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace TextureBuilder
+	{
+		struct sImage
+		{
+			// 4 bytes per pixel (red first), stored in rows from the top left
+			std::vector<uint8_t> pixels;
+			unsigned int width, height;
+
+			bool HasTransparency() const;
+
+			sImage() : width( 0 ), height( 0 ) {}
+		};
+
+		// Decoding
+		//---------
+
+		// Uncompressed and run-length encoded true color (24/32 bit) and grayscale (8 bit) TGAs are supported
+		bool DecodeTga( const void* const i_data, const size_t i_size, sImage& o_image, std::string* const o_errorMessage = NULL );
+
+		// Mip Maps
+		//---------
+
+		// Creates the next smaller mip level by averaging every 2x2 block of pixels.
+		// If the image is sRGB then the colors are averaged in linear space
+		// so that the smaller mips don't get darker.
+		void GenerateNextMip( const sImage& i_source, const bool i_isSrgb, sImage& o_mip );
+	}
+}
+
+#endif	// EAE6320_TEXTUREBUILDER_IMAGE_H
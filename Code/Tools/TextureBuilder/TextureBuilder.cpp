@@ -0,0 +1,247 @@
+// Header Files
+//=============
+
+#include "TextureBuilder.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "../AssetBuildLibrary/UtilityFunctions.h"
+#include "../../Engine/Platform/Platform.h"
+
+// Helper Function Declarations
+//=============================
+
+namespace
+{
+	void EncodeMip( const eae6320::TextureBuilder::sImage& i_image, const uint8_t i_format,
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality,
+		uint8_t* const o_data, eae6320::AssetBuild::BlockCompression::sStats* const o_stats );
+	eae6320::AssetBuild::BlockCompression::eFormat::eFormat GetBlockCompressionFormat( const uint8_t i_format );
+}
+
+// Interface
+//==========
+
+bool eae6320::TextureBuilder::Build( const char* const i_path_source, const char* const i_path_target, const sOptions& i_options )
+{
+	sImage image;
+	return LoadImage( i_path_source, image ) && WriteTexture( image, i_path_target, i_options );
+}
+
+bool eae6320::TextureBuilder::WriteTexture( const sImage& i_image, const char* const i_path_target, const sOptions& i_options )
+{
+	namespace TextureFormats = Graphics::TextureFormats;
+
+	bool wereThereErrors = false;
+	const std::chrono::high_resolution_clock::time_point time_start = std::chrono::high_resolution_clock::now();
+
+	std::vector<sImage> mips( 1, i_image );
+	std::vector<uint8_t> targetData;
+	TextureFormats::sHeader header;
+	AssetBuild::BlockCompression::sStats compressionStats = { 0 };
+	double compressionSecondCount = 0.0;
+	const size_t maxMipCount = ( ( i_options.maxMipCount > 0 ) && ( i_options.maxMipCount < TextureFormats::s_maxMipCount ) ) ?
+		i_options.maxMipCount : TextureFormats::s_maxMipCount;
+
+	// Generate the mip chain down to 1x1 (or until there are as many mips as requested)
+	while ( ( ( mips.back().width > 1 ) || ( mips.back().height > 1 ) ) && ( mips.size() < maxMipCount ) )
+	{
+		mips.push_back( sImage() );
+		GenerateNextMip( mips[mips.size() - 2], i_options.isSrgb, mips.back() );
+	}
+	// Write the texture file
+	{
+		memset( &header, 0, sizeof( header ) );
+		{
+			header.fourCc = TextureFormats::s_fourCc;
+			header.version = TextureFormats::s_version;
+			if ( i_options.format < TextureFormats::eFormat::Count )
+			{
+				header.format = i_options.format;
+			}
+			else
+			{
+				// BC1 can't store smooth alpha, and so only opaque images use it
+				header.format = static_cast<uint8_t>( mips[0].HasTransparency() ? TextureFormats::eFormat::BC3 : TextureFormats::eFormat::BC1 );
+			}
+			header.flags = static_cast<uint8_t>( i_options.isSrgb ? TextureFormats::eFlag::IsSrgb : 0 );
+			header.width = static_cast<uint16_t>( mips[0].width );
+			header.height = static_cast<uint16_t>( mips[0].height );
+			header.mipCount = static_cast<uint8_t>( mips.size() );
+		}
+		// Lay out the mips so that each one is aligned
+		std::vector<TextureFormats::sMip> mipInfos( mips.size() );
+		size_t fileSize = sizeof( header ) + ( mipInfos.size() * sizeof( TextureFormats::sMip ) );
+		for ( size_t i = 0; i < mips.size(); ++i )
+		{
+			fileSize = ( fileSize + ( TextureFormats::s_dataAlignment - 1 ) ) & ~static_cast<size_t>( TextureFormats::s_dataAlignment - 1 );
+			TextureFormats::sMip& mipInfo = mipInfos[i];
+			mipInfo.offset = static_cast<uint32_t>( fileSize );
+			mipInfo.size = TextureFormats::CalculateMipSize( header.format, mips[i].width, mips[i].height );
+			mipInfo.rowPitch = TextureFormats::CalculateRowPitch( header.format, mips[i].width );
+			mipInfo.width = static_cast<uint16_t>( mips[i].width );
+			mipInfo.height = static_cast<uint16_t>( mips[i].height );
+			fileSize += mipInfo.size;
+		}
+		targetData.resize( fileSize, 0 );
+		memcpy( &targetData[0], &header, sizeof( header ) );
+		memcpy( &targetData[sizeof( header )], &mipInfos[0], mipInfos.size() * sizeof( TextureFormats::sMip ) );
+		for ( size_t i = 0; i < mips.size(); ++i )
+		{
+			AssetBuild::BlockCompression::sStats mipStats = { 0 };
+			EncodeMip( mips[i], header.format, i_options.quality, &targetData[mipInfos[i].offset], &mipStats );
+			compressionSecondCount += mipStats.secondCount;
+			// The largest mip is the one whose quality matters the most
+			if ( i == 0 )
+			{
+				compressionStats = mipStats;
+			}
+		}
+
+		std::string errorMessage;
+		if ( !Platform::WriteBinaryFile( i_path_target, &targetData[0], targetData.size(), &errorMessage ) )
+		{
+			wereThereErrors = true;
+			AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path_target );
+			goto OnExit;
+		}
+	}
+	// Report how quickly the texture was built
+	{
+		const double secondCount = std::chrono::duration<double>( std::chrono::high_resolution_clock::now() - time_start ).count();
+		const double megabyteCount = static_cast<double>( mips[0].pixels.size() ) / ( 1024.0 * 1024.0 );
+		std::cout << "TextureBuilder: " << mips[0].width << "x" << mips[0].height << " with " << mips.size() << " mips in "
+			<< ( secondCount * 1000.0 ) << " ms (" << ( megabyteCount / ( secondCount > 0.0 ? secondCount : 1.0 ) ) << " MB/s)";
+		if ( TextureFormats::IsBlockCompressed( header.format ) )
+		{
+			std::cout << "; " << AssetBuild::BlockCompression::GetFormatName( GetBlockCompressionFormat( header.format ) )
+				<< " (" << AssetBuild::BlockCompression::GetQualityName( i_options.quality ) << ") compression took "
+				<< ( compressionSecondCount * 1000.0 ) << " ms, mip 0 at " << compressionStats.megapixelsPerSecond << " MP/s and "
+				<< compressionStats.peakSignalToNoiseRatio << " dB PSNR";
+		}
+		std::cout << "\n";
+	}
+
+OnExit:
+
+	return !wereThereErrors;
+}
+
+bool eae6320::TextureBuilder::Benchmark( const char* const* const i_paths_source, const unsigned int i_pathCount )
+{
+	namespace BlockCompression = AssetBuild::BlockCompression;
+
+	// The results of every image are totaled for each combination of format and quality
+	double megapixelCounts[BlockCompression::eFormat::Count][BlockCompression::eQuality::Count] = { { 0.0 } };
+	double secondCounts[BlockCompression::eFormat::Count][BlockCompression::eQuality::Count] = { { 0.0 } };
+	double psnrTotals[BlockCompression::eFormat::Count][BlockCompression::eQuality::Count] = { { 0.0 } };
+
+	std::cout << std::fixed << std::setprecision( 2 );
+	for ( unsigned int i = 0; i < i_pathCount; ++i )
+	{
+		sImage image;
+		if ( !LoadImage( i_paths_source[i], image ) )
+		{
+			return false;
+		}
+		const double megapixelCount = static_cast<double>( image.width ) * static_cast<double>( image.height ) / 1000000.0;
+		std::vector<uint8_t> blocks;
+		for ( int format = 0; format < BlockCompression::eFormat::Count; ++format )
+		{
+			const BlockCompression::eFormat::eFormat blockFormat = static_cast<BlockCompression::eFormat::eFormat>( format );
+			blocks.resize( BlockCompression::CalculateCompressedSize( blockFormat, image.width, image.height ) );
+			for ( int quality = 0; quality < BlockCompression::eQuality::Count; ++quality )
+			{
+				const BlockCompression::eQuality::eQuality blockQuality = static_cast<BlockCompression::eQuality::eQuality>( quality );
+				BlockCompression::sStats stats;
+				BlockCompression::Compress( blockFormat, blockQuality, &image.pixels[0], image.width, image.height, &blocks[0], &stats );
+				std::cout << i_paths_source[i] << ": " << BlockCompression::GetFormatName( blockFormat )
+					<< " (" << BlockCompression::GetQualityName( blockQuality ) << "): "
+					<< stats.megapixelsPerSecond << " MP/s, " << stats.peakSignalToNoiseRatio << " dB PSNR\n";
+				megapixelCounts[format][quality] += megapixelCount;
+				secondCounts[format][quality] += stats.secondCount;
+				psnrTotals[format][quality] += stats.peakSignalToNoiseRatio;
+			}
+		}
+	}
+	if ( i_pathCount > 0 )
+	{
+		std::cout << "Totals for " << i_pathCount << " images:\n";
+		for ( int format = 0; format < BlockCompression::eFormat::Count; ++format )
+		{
+			for ( int quality = 0; quality < BlockCompression::eQuality::Count; ++quality )
+			{
+				const double secondCount = secondCounts[format][quality];
+				std::cout << "\t" << BlockCompression::GetFormatName( static_cast<BlockCompression::eFormat::eFormat>( format ) )
+					<< " (" << BlockCompression::GetQualityName( static_cast<BlockCompression::eQuality::eQuality>( quality ) ) << "): "
+					<< ( megapixelCounts[format][quality] / ( ( secondCount > 0.0 ) ? secondCount : 1.0 ) ) << " MP/s, "
+					<< ( psnrTotals[format][quality] / i_pathCount ) << " dB average PSNR\n";
+			}
+		}
+	}
+
+	return true;
+}
+
+bool eae6320::TextureBuilder::LoadImage( const char* const i_path, sImage& o_image )
+{
+	Platform::sDataFromFile sourceFile;
+	std::string errorMessage;
+	if ( !Platform::LoadBinaryFile( i_path, sourceFile, &errorMessage ) )
+	{
+		AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path );
+		return false;
+	}
+	const bool wasDecoded = DecodeTga( sourceFile.data, sourceFile.size, o_image, &errorMessage );
+	sourceFile.Free();
+	if ( !wasDecoded )
+	{
+		AssetBuild::OutputErrorMessage( errorMessage.c_str(), i_path );
+		return false;
+	}
+	if ( ( o_image.width > 0xffff ) || ( o_image.height > 0xffff ) )
+	{
+		AssetBuild::OutputErrorMessage( "The image is too large to be a texture", i_path );
+		return false;
+	}
+	return true;
+}
+
+// Helper Function Definitions
+//============================
+
+namespace
+{
+	void EncodeMip( const eae6320::TextureBuilder::sImage& i_image, const uint8_t i_format,
+		const eae6320::AssetBuild::BlockCompression::eQuality::eQuality i_quality,
+		uint8_t* const o_data, eae6320::AssetBuild::BlockCompression::sStats* const o_stats )
+	{
+		if ( eae6320::Graphics::TextureFormats::IsBlockCompressed( i_format ) )
+		{
+			eae6320::AssetBuild::BlockCompression::Compress( GetBlockCompressionFormat( i_format ), i_quality,
+				&i_image.pixels[0], i_image.width, i_image.height, o_data, o_stats );
+		}
+		else
+		{
+			memcpy( o_data, &i_image.pixels[0], i_image.pixels.size() );
+		}
+	}
+
+	eae6320::AssetBuild::BlockCompression::eFormat::eFormat GetBlockCompressionFormat( const uint8_t i_format )
+	{
+		namespace eFormat = eae6320::Graphics::TextureFormats::eFormat;
+		namespace eBlockFormat = eae6320::AssetBuild::BlockCompression::eFormat;
+		switch ( i_format )
+		{
+		case eFormat::BC1: return eBlockFormat::BC1;
+		case eFormat::BC3: return eBlockFormat::BC3;
+		case eFormat::BC4: return eBlockFormat::BC4;
+		case eFormat::BC5: return eBlockFormat::BC5;
+		case eFormat::BC7: return eBlockFormat::BC7;
+		}
+		return eBlockFormat::Count;
+	}
+}
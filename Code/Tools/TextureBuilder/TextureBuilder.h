@@ -0,0 +1,56 @@
+/*
+	The TextureBuilder converts an authored image
+	into a GPU-ready texture file with a full mip chain of block-compressed data
+*/
+
+#ifndef EAE6320_TEXTUREBUILDER_H
+#define EAE6320_TEXTUREBUILDER_H
+
+// Header Files
+//=============
+
+#include <cstdint>
+#include "Image.h"
+#include "../AssetBuildLibrary/BlockCompression.h"
+#include "../../Engine/Graphics/TextureFormats.h"
+
+// Interface
+//==========
+
+namespace eae6320
+{
+	namespace TextureBuilder
+	{
+		struct sOptions
+		{
+			// If this is eFormat::Count then BC1 is used for opaque images and BC3 for images with alpha
+			uint8_t format;
+			AssetBuild::BlockCompression::eQuality::eQuality quality;
+			// Color textures should be sRGB,
+			// but textures that store other data (e.g. normals or masks) should not be
+			bool isSrgb;
+			// If this is zero then mips are generated all the way down to 1x1
+			unsigned int maxMipCount;
+
+			sOptions() : format( Graphics::TextureFormats::eFormat::Count ), quality( AssetBuild::BlockCompression::eQuality::Normal ),
+				isSrgb( true ), maxMipCount( 0 ) {}
+		};
+
+		// Builds a texture from a TGA
+		bool Build( const char* const i_path_source, const char* const i_path_target, const sOptions& i_options );
+		// Builds an atlas from a Lua file that lists the images to pack
+		// (the packed texture is written next to the target with a ".texture" extension)
+		bool BuildAtlas( const char* const i_path_source, const char* const i_path_target, const sOptions& i_options );
+
+		// Compresses every source image with every block-compressed format and quality preset
+		// and outputs the speed and quality of each combination
+		bool Benchmark( const char* const* const i_paths_source, const unsigned int i_pathCount );
+
+		// These are shared by the different kinds of builds
+
+		bool LoadImage( const char* const i_path, sImage& o_image );
+		bool WriteTexture( const sImage& i_image, const char* const i_path_target, const sOptions& i_options );
+	}
+}
+
+#endif	// EAE6320_TEXTUREBUILDER_H
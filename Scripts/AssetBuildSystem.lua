@@ -5,7 +5,7 @@
 -- Static Data Initialization
 --===========================
 
-local s_AuthoredAssetDir, s_BuiltAssetDir
+local s_AuthoredAssetDir, s_BuiltAssetDir, s_BinDir
 do
 	-- AuthoredAssetDir
 	do
@@ -25,8 +25,126 @@ do
 			error( errorMessage )
 		end
 	end
+	-- BinDir
+	do
+		local key = "BinDir"
+		local errorMessage
+		s_BinDir, errorMessage = GetEnvironmentVariable( key )
+		if not s_BinDir then
+			error( errorMessage )
+		end
+	end
+end
+
+-- An atlas is built from the images that it lists,
+-- and so it must be rebuilt whenever any of them change
+local function GetAtlasDependencies( i_path_source )
+	local atlasFunction, errorMessage = loadfile( i_path_source, "t", {} )
+	if not atlasFunction then
+		return nil, errorMessage
+	end
+	local wasSuccessful, atlas = pcall( atlasFunction )
+	if not wasSuccessful then
+		return nil, atlas
+	end
+	local dependencies = {}
+	if type( atlas ) == "table" and type( atlas.images ) == "table" then
+		-- Image paths are relative to the atlas
+		local directory = i_path_source:match( "^(.*[\\/])" ) or ""
+		for name, path in pairs( atlas.images ) do
+			dependencies[#dependencies + 1] = directory .. tostring( path )
+		end
+	end
+	return dependencies
+end
+
+-- A shader library is compiled from the source code next to the authored shader
+-- (which one is used depends on the platform that the ShaderBuilder was built for)
+local function GetShaderDependencies( i_path_source )
+	local path_withoutExtension = i_path_source:gsub( "%.[^%.\\/]*$", "" )
+	return { path_withoutExtension .. ".hlsl", path_withoutExtension .. ".glsl" }
+end
+
+-- A material stores the keys of its shaders' permutations,
+-- and so it must be rebuilt whenever the axes of its shaders change
+local function GetMaterialDependencies( i_path_source )
+	local materialFunction, errorMessage = loadfile( i_path_source, "t", {} )
+	if not materialFunction then
+		return nil, errorMessage
+	end
+	local wasSuccessful, material = pcall( materialFunction )
+	if not wasSuccessful then
+		return nil, material
+	end
+	local dependencies = {}
+	if type( material ) == "table" then
+		-- Shader paths are relative to the material
+		local directory = i_path_source:match( "^(.*[\\/])" ) or ""
+		for i, key in ipairs( { "vertexShader", "fragmentShader" } ) do
+			if type( material[key] ) == "string" then
+				dependencies[#dependencies + 1] = directory .. material[key] .. ".shader"
+			end
+		end
+	end
+	return dependencies
+end
+
+-- A font can be built from a TrueType file next to it instead of an installed font
+local function GetFontDependencies( i_path_source )
+	local fontFunction, errorMessage = loadfile( i_path_source, "t", {} )
+	if not fontFunction then
+		return nil, errorMessage
+	end
+	local wasSuccessful, font = pcall( fontFunction )
+	if not wasSuccessful then
+		return nil, font
+	end
+	local dependencies = {}
+	if type( font ) == "table" and type( font.file ) == "string" then
+		-- The file is relative to the font
+		local directory = i_path_source:match( "^(.*[\\/])" ) or ""
+		dependencies[#dependencies + 1] = directory .. font.file
+	end
+	return dependencies
+end
+
+-- A terrain can be built from a raw height map next to it instead of from noise
+local function GetTerrainDependencies( i_path_source )
+	local terrainFunction, errorMessage = loadfile( i_path_source, "t", {} )
+	if not terrainFunction then
+		return nil, errorMessage
+	end
+	local wasSuccessful, terrain = pcall( terrainFunction )
+	if not wasSuccessful then
+		return nil, terrain
+	end
+	local dependencies = {}
+	if type( terrain ) == "table" and type( terrain.heightMap ) == "string" then
+		-- The height map is relative to the terrain
+		local directory = i_path_source:match( "^(.*[\\/])" ) or ""
+		dependencies[#dependencies + 1] = directory .. terrain.heightMap
+	end
+	return dependencies
 end
 
+-- Assets with these extensions are converted by a builder program instead of being copied.
+-- The target gets the builder's extension so that the game can tell which format it is.
+-- If a builder has a GetDependencies() function then the target is also rebuilt
+-- when any of the files that it returns have been modified more recently than the target.
+local s_builders =
+{
+	[".tga"] = { program = "TextureBuilder.exe", targetExtension = ".texture" },
+	[".animation"] = { program = "AnimationBuilder.exe", targetExtension = ".animation" },
+	-- The TextureBuilder also writes the atlas's texture next to the target
+	[".atlas"] = { program = "TextureBuilder.exe", targetExtension = ".atlas", GetDependencies = GetAtlasDependencies },
+	-- The FontBuilder also writes the font's texture next to the target
+	[".font"] = { program = "FontBuilder.exe", targetExtension = ".font", GetDependencies = GetFontDependencies },
+	[".material"] = { program = "MaterialBuilder.exe", targetExtension = ".material", GetDependencies = GetMaterialDependencies },
+	-- Every permutation of the shader is compiled into a single library
+	[".shader"] = { program = "ShaderBuilder.exe", targetExtension = ".shaderlibrary", GetDependencies = GetShaderDependencies },
+	[".terrain"] = { program = "TerrainBuilder.exe", targetExtension = ".terrain", GetDependencies = GetTerrainDependencies },
+}
+
 -- Function Definitions
 --=====================
 
@@ -43,6 +161,16 @@ function BuildAsset( i_relativePath )
 	local path_source = s_AuthoredAssetDir .. i_relativePath
 	local path_target = s_BuiltAssetDir .. i_relativePath
 
+	-- Some assets are converted by a builder program
+	local builder
+	do
+		local extension = i_relativePath:match( "%.[^%.\\/]+$" )
+		builder = extension and s_builders[extension:lower()]
+		if builder then
+			path_target = s_BuiltAssetDir .. i_relativePath:sub( 1, -( #extension + 1 ) ) .. builder.targetExtension
+		end
+	end
+
 	-- If the source file doesn't exist then it can't be built
 	do
 		local doesSourceExist = DoesFileExist( path_source )
@@ -64,6 +192,20 @@ function BuildAsset( i_relativePath )
 			local lastWriteTime_source = GetLastWriteTime( path_source )
 			local lastWriteTime_target = GetLastWriteTime( path_target )
 			shouldTargetBeBuilt = lastWriteTime_source > lastWriteTime_target
+			if not shouldTargetBeBuilt and builder and builder.GetDependencies then
+				local dependencies = builder.GetDependencies( path_source )
+				if dependencies then
+					for i, path_dependency in ipairs( dependencies ) do
+						if DoesFileExist( path_dependency ) and ( GetLastWriteTime( path_dependency ) > lastWriteTime_target ) then
+							shouldTargetBeBuilt = true
+							break
+						end
+					end
+				else
+					-- If the dependencies can't be determined then the builder will report why
+					shouldTargetBeBuilt = true
+				end
+			end
 		else
 			shouldTargetBeBuilt = true;
 		end
@@ -74,8 +216,31 @@ function BuildAsset( i_relativePath )
 		-- Create the target directory if necessary
 		CreateDirectoryIfNecessary( path_target )
 
-		-- Copy the source to the target
-		local result, errorMessage = CopyFile( path_source, path_target )
+		local result, errorMessage
+		if builder then
+			-- Run the builder
+			local command = "\"" .. s_BinDir .. builder.program .. "\" \"" .. path_source .. "\" \"" .. path_target .. "\""
+			local exitCode
+			result, exitCode = ExecuteCommand( command )
+			if result then
+				if exitCode == 0 then
+					result = true
+				else
+					result = false
+					-- The builder will have already output the reason that it failed,
+					-- and so the target is just invalidated so that it will be built again next time
+					errorMessage = builder.program .. " failed with exit code " .. tostring( exitCode )
+					if DoesFileExist( path_target ) then
+						InvalidateLastWriteTime( path_target )
+					end
+				end
+			else
+				errorMessage = exitCode
+			end
+		else
+			-- Copy the source to the target
+			result, errorMessage = CopyFile( path_source, path_target )
+		end
 		if result then
 			-- Display a message when an asset builds successfully
 			print( "Built " .. path_source )